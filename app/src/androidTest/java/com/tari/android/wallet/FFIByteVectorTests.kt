@@ -34,10 +34,13 @@ package com.tari.android.wallet
 
 import com.tari.android.wallet.ffi.FFIByteVector
 import com.tari.android.wallet.ffi.FFIException
+import com.tari.android.wallet.ffi.FFIUtil
+import com.tari.android.wallet.ffi.FFIUtil.HandleType
 import com.tari.android.wallet.ffi.HexString
 import com.tari.android.wallet.ffi.nullptr
 import org.junit.Assert.*
 import org.junit.Test
+import java.nio.ByteBuffer
 
 /**
  * FFI byte vector tests.
@@ -64,10 +67,55 @@ class FFIByteVectorTests {
         byteVector.destroy()
     }
 
+    @Test
+    fun constructorFromDirectBuffer_assertThatRemainingBytesWereCopied() {
+        val buffer = ByteBuffer.allocateDirect(8)
+        buffer.put(byteArrayOf(1, 2, 3, 4, 5, 6, 7, 8))
+        buffer.position(2).limit(6)
+        val byteVector = FFIByteVector(buffer)
+        assertArrayEquals(byteArrayOf(3, 4, 5, 6), byteVector.getBytes())
+        assertEquals(2, buffer.position())
+        byteVector.destroy()
+    }
+
+    @Test(expected = FFIException::class)
+    fun constructorFromHeapBuffer_expectFFIExceptionThrow() {
+        FFIByteVector(ByteBuffer.allocate(8))
+    }
+
+    @Test
+    fun getBytes_assertThatShortDestinationIsLeftUntouched() {
+        val byteVector = FFIByteVector(ByteArray(4096) { it.toByte() })
+        val short = ByteArray(16)
+        assertEquals(4096, byteVector.getBytes(short))
+        assertArrayEquals(ByteArray(16), short)
+        val long = ByteArray(5000)
+        assertEquals(4096, byteVector.getBytes(long))
+        assertArrayEquals(ByteArray(4096) { it.toByte() }, long.copyOf(4096))
+        byteVector.destroy()
+    }
+
     @Test(expected = FFIException::class)
     fun constructor_expectFFIExceptionThrow_ifHexLengthIs59() {
         val givenHex = FFITestUtil.PUBLIC_KEY_HEX_STRING
         FFIByteVector(HexString(givenHex.slice(0..givenHex.length - 5)))
     }
 
+    @Test
+    fun handleStats_assertThatCreatedAndDestroyedVectorsAreCounted() {
+        val before = FFIUtil.getHandleStats().getValue(HandleType.BYTE_VECTOR)
+        FFIUtil.setHandleSiteRecording(true)
+        val byteVectors = List(3) { FFIByteVector(ByteArray(32) { it.toByte() }) }
+        val during = FFIUtil.getHandleStats().getValue(HandleType.BYTE_VECTOR)
+        assertEquals(before.created + 3, during.created)
+        assertEquals(before.live + 3, during.live)
+        assertTrue(during.highWater >= during.live)
+        assertTrue(FFIUtil.dumpHandleStats().contains("3 ByteVector from"))
+        byteVectors.forEach { it.destroy() }
+        FFIUtil.setHandleSiteRecording(false)
+        val after = FFIUtil.getHandleStats().getValue(HandleType.BYTE_VECTOR)
+        assertEquals(before.destroyed + 3, after.destroyed)
+        assertEquals(before.live, after.live)
+    }
+
 }
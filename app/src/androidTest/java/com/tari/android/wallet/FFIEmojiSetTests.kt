@@ -0,0 +1,74 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+package com.tari.android.wallet
+
+import com.tari.android.wallet.ffi.FFIEmojiSet
+import com.tari.android.wallet.ffi.FFIPublicKey
+import com.tari.android.wallet.ffi.FFIUtil
+import com.tari.android.wallet.ffi.HexString
+import org.junit.Assert.assertEquals
+import org.junit.Test
+
+/**
+ * Checks the emoji alphabet compiled into the native library against libwallet.
+ *
+ * @author The Tari Development Team
+ */
+class FFIEmojiSetTests {
+
+    @Test
+    fun emojiAlphabet_assertThatItMatchesTheWalletEmojiSet() {
+        val alphabet = FFIUtil.getEmojiAlphabet()
+        val emojiSet = FFIEmojiSet()
+        assertEquals(emojiSet.getLength(), alphabet.size)
+        for (i in alphabet.indices) {
+            val emojiFFI = emojiSet.getAt(i)
+            assertEquals("emoji $i", String(emojiFFI.getBytes()), alphabet[i])
+            emojiFFI.destroy()
+        }
+        emojiSet.destroy()
+    }
+
+    @Test
+    fun emojiAlphabet_assertThatEmojiIdsEncodeKeyBytes() {
+        val alphabet = FFIUtil.getEmojiAlphabet()
+        val publicKey = FFIPublicKey(HexString(FFITestUtil.PUBLIC_KEY_HEX_STRING))
+        val bytes = publicKey.getBytes()
+        val expected = (0 until bytes.getLength()).joinToString("") { alphabet[bytes.getAt(it)] }
+        // the emoji ID is the key bytes followed by a checksum emoji
+        assertEquals(expected, publicKey.getEmojiId().dropLast(2))
+        bytes.destroy()
+        publicKey.destroy()
+    }
+
+}
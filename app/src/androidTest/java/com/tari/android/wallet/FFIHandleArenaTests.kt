@@ -0,0 +1,95 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+package com.tari.android.wallet
+
+import com.tari.android.wallet.ffi.*
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertNotEquals
+import org.junit.Test
+
+/**
+ * FFI handle arena tests.
+ *
+ * @author The Tari Development Team
+ */
+class FFIHandleArenaTests {
+
+    @Test
+    fun release_assertThatAllHandlesCreatedInScopeWereFreed() {
+        val arena = FFIHandleArena()
+        arena.activate()
+        // attached natively
+        val privateKey = FFIPrivateKey.generate()
+        val byteVector = FFIByteVector(HexString(FFITestUtil.PUBLIC_KEY_HEX_STRING))
+        val publicKey = FFIPublicKey(byteVector)
+        // attached on the Kotlin side
+        val bytes = publicKey.getBytes()
+        assertEquals(4, arena.size)
+        assertEquals(4, arena.release())
+        for (subject in listOf(privateKey, byteVector, publicKey, bytes)) {
+            assertEquals(nullptr, subject.pointer)
+        }
+        arena.destroy()
+    }
+
+    @Test
+    fun release_assertThatDestroyedAndOuterHandlesWereSkipped() {
+        val outside = FFIByteVector(HexString(FFITestUtil.PUBLIC_KEY_HEX_STRING))
+        val destroyed = FFIHandleArena.scoped {
+            val first = FFIByteVector(HexString(FFITestUtil.PUBLIC_KEY_HEX_STRING))
+            first.destroy()
+            first
+        }
+        assertEquals(nullptr, destroyed.pointer)
+        assertNotEquals(nullptr, outside.pointer)
+        outside.destroy()
+    }
+
+    @Test
+    fun scoped_assertThatNestedArenasFreeTheirOwnHandles() {
+        val outer = FFIHandleArena()
+        outer.activate()
+        val outerKey = FFIPrivateKey.generate()
+        val innerKey = FFIHandleArena.scoped {
+            FFIPrivateKey.generate().also { assertEquals(1, outer.size) }
+        }
+        assertEquals(nullptr, innerKey.pointer)
+        assertNotEquals(nullptr, outerKey.pointer)
+        val afterInner = FFIPrivateKey.generate()
+        assertEquals(2, outer.release())
+        assertEquals(nullptr, outerKey.pointer)
+        assertEquals(nullptr, afterInner.pointer)
+        outer.destroy()
+    }
+
+}
@@ -0,0 +1,185 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+package com.tari.android.wallet
+
+import com.orhanobut.logger.Logger
+import com.tari.android.wallet.ffi.FFIByteVector
+import com.tari.android.wallet.ffi.FFISeedWords
+import com.tari.android.wallet.ffi.FFIUtil
+import com.tari.android.wallet.ffi.HexString
+import org.junit.After
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+import java.nio.ByteBuffer
+
+/**
+ * Per-call JNI overhead microbenchmarks. Results are logged, assertions only guard against
+ * regressions of an order of magnitude.
+ *
+ * @author The Tari Development Team
+ */
+class FFIJniOverheadBenchmarks {
+
+    private lateinit var byteVector: FFIByteVector
+
+    @Before
+    fun setup() {
+        byteVector = FFIByteVector(HexString(FFITestUtil.PUBLIC_KEY_HEX_STRING))
+        // warm up both paths so that the JIT and the class linker are out of the picture
+        FFIUtil.measurePointerAccess(byteVector, WARM_UP_ITERATIONS, true)
+        FFIUtil.measurePointerAccess(byteVector, WARM_UP_ITERATIONS, false)
+    }
+
+    @After
+    fun tearDown() {
+        byteVector.destroy()
+    }
+
+    @Test
+    fun pointerAccess_cachedFieldIdIsFasterThanPerCallLookup() {
+        val cachedNanos = FFIUtil.measurePointerAccess(byteVector, ITERATIONS, true)
+        val lookupNanos = FFIUtil.measurePointerAccess(byteVector, ITERATIONS, false)
+        Logger.i(
+            "Pointer access per call: cached %.1f ns, per-call lookup %.1f ns",
+            cachedNanos.toDouble() / ITERATIONS,
+            lookupNanos.toDouble() / ITERATIONS
+        )
+        assertTrue(cachedNanos < lookupNanos)
+    }
+
+    @Test
+    fun getter_measureRoundTripOverhead() {
+        repeat(WARM_UP_ITERATIONS) { byteVector.getLength() }
+        val start = System.nanoTime()
+        repeat(ITERATIONS) { byteVector.getLength() }
+        val nanos = System.nanoTime() - start
+        Logger.i("FFIByteVector.getLength per call: %.1f ns", nanos.toDouble() / ITERATIONS)
+        assertTrue(nanos > 0)
+    }
+
+    @Test
+    fun firstCall_measureNativeMethodBindingOverhead() {
+        val loadStats = FFIUtil.getLoadStats()
+        // seed words are not touched by the other tests in this class, so the first call
+        // includes the binding cost when the VM resolves natives by symbol name
+        var start = System.nanoTime()
+        val first = FFISeedWords()
+        val firstCallNanos = System.nanoTime() - start
+        start = System.nanoTime()
+        val second = FFISeedWords()
+        val secondCallNanos = System.nanoTime() - start
+        Logger.i(
+            "%s: first call %d ns, second call %d ns",
+            loadStats,
+            firstCallNanos,
+            secondCallNanos
+        )
+        first.destroy()
+        second.destroy()
+        assertTrue(loadStats.onLoadNanos > 0)
+    }
+
+    @Test
+    fun byteVector_measureBulkCopyThroughput() {
+        for (size in intArrayOf(KEY_SIZE, COOKIE_SIZE)) {
+            val bytes = ByteArray(size) { it.toByte() }
+            val buffer = ByteBuffer.allocateDirect(size).put(bytes)
+            buffer.flip()
+            val iterations = ITERATIONS / size * KEY_SIZE / 10
+            val createNanos = measure(iterations) { FFIByteVector(bytes).destroy() }
+            val createFromBufferNanos = measure(iterations) { FFIByteVector(buffer).destroy() }
+            val vector = FFIByteVector(bytes)
+            val destination = ByteArray(size)
+            val bulkReadNanos = measure(iterations) { vector.getBytes(destination) }
+            val perByteReadNanos = measure(iterations / 10) {
+                for (i in 0 until size) {
+                    destination[i] = vector.getAt(i).toByte()
+                }
+            }
+            vector.destroy()
+            Logger.i(
+                "FFIByteVector %d bytes, MB/s: create %.1f, create from buffer %.1f, " +
+                        "bulk read %.1f, per-byte read %.1f",
+                size,
+                megabytesPerSecond(size, iterations, createNanos),
+                megabytesPerSecond(size, iterations, createFromBufferNanos),
+                megabytesPerSecond(size, iterations, bulkReadNanos),
+                megabytesPerSecond(size, iterations / 10, perByteReadNanos)
+            )
+            assertTrue(bulkReadNanos / iterations < perByteReadNanos / (iterations / 10))
+        }
+    }
+
+    @Test
+    fun stringCreation_measureTranscoderAgainstNewStringUtf() {
+        val inputs = mapOf(
+            "emoji ID" to FFITestUtil.PUBLIC_KEY_EMOJI_ID,
+            "emoji message" to "⛵️🚿😻 paid for dinner 🍕🍷 " + FFITestUtil.PUBLIC_KEY_EMOJI_ID,
+            "ascii message" to "Thanks for the coffee, see you next week at the office"
+        )
+        for ((name, text) in inputs) {
+            val utf8 = text.toByteArray(Charsets.UTF_8)
+            FFIUtil.measureStringCreation(utf8, WARM_UP_ITERATIONS, true)
+            FFIUtil.measureStringCreation(utf8, WARM_UP_ITERATIONS, false)
+            val transcodedNanos = FFIUtil.measureStringCreation(utf8, ITERATIONS, true)
+            val newStringUtfNanos = FFIUtil.measureStringCreation(utf8, ITERATIONS, false)
+            Logger.i(
+                "String creation, %s (%d bytes) per call: transcoder %.1f ns, NewStringUTF %.1f ns",
+                name,
+                utf8.size,
+                transcodedNanos.toDouble() / ITERATIONS,
+                newStringUtfNanos.toDouble() / ITERATIONS
+            )
+            assertTrue(transcodedNanos < newStringUtfNanos * 10)
+        }
+    }
+
+    private fun measure(iterations: Int, block: () -> Unit): Long {
+        repeat(iterations / 10) { block() }
+        val start = System.nanoTime()
+        repeat(iterations) { block() }
+        return System.nanoTime() - start
+    }
+
+    private fun megabytesPerSecond(size: Int, iterations: Int, nanos: Long): Double =
+        size.toDouble() * iterations * 1000 / nanos
+
+    private companion object {
+        const val WARM_UP_ITERATIONS = 10_000
+        const val ITERATIONS = 100_000
+        const val KEY_SIZE = 32
+        const val COOKIE_SIZE = 4096
+    }
+
+}
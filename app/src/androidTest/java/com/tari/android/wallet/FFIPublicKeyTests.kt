@@ -35,6 +35,7 @@ package com.tari.android.wallet
 import com.tari.android.wallet.ffi.*
 import org.junit.Assert.assertEquals
 import org.junit.Assert.assertNotEquals
+import org.junit.Assert.assertTrue
 import org.junit.Test
 
 /**
@@ -78,6 +79,52 @@ class FFIPublicKeyTests {
         origin.destroy()
     }
 
+    @Test
+    fun emojiIdCache_assertThatRepeatedConversionsAreServedFromTheCache() {
+        val origin = FFIPublicKey(HexString(FFITestUtil.PUBLIC_KEY_HEX_STRING))
+        val emojiId = origin.getEmojiId()
+        val before = FFIPublicKey.getEmojiIdCacheStats()
+        assertEquals(emojiId, origin.getEmojiId())
+        val first = FFIPublicKey(emojiId)
+        val second = FFIPublicKey(emojiId)
+        val after = FFIPublicKey.getEmojiIdCacheStats()
+        assertTrue(after.emojiIdHits > before.emojiIdHits)
+        assertTrue(after.keyHits > before.keyHits)
+        // both keys share the cached handle, destroying one leaves the other usable
+        assertEquals(first.pointer, second.pointer)
+        first.destroy()
+        assertEquals(FFITestUtil.PUBLIC_KEY_HEX_STRING, second.toString())
+        assertEquals(emojiId, second.getEmojiId())
+        second.destroy()
+        origin.destroy()
+    }
+
+    @Test
+    fun validateEmojiId_assertThatValidEmojiIdIsAccepted() {
+        val result = FFIPublicKey.validateEmojiId(FFITestUtil.PUBLIC_KEY_EMOJI_ID)
+        assertTrue(result.isValid)
+        assertEquals(-1, result.position)
+    }
+
+    @Test
+    fun validateEmojiId_assertThatFirstErrorIsReported() {
+        val emojiId = FFITestUtil.PUBLIC_KEY_EMOJI_ID
+        val short = FFIPublicKey.validateEmojiId(emojiId.substring(0, 10))
+        assertEquals(FFIPublicKey.EmojiIdValidation.TOO_SHORT, short.error)
+        assertEquals(10, short.position)
+        val long = FFIPublicKey.validateEmojiId(emojiId + emojiId.substring(0, 2))
+        assertEquals(FFIPublicKey.EmojiIdValidation.TOO_LONG, long.error)
+        assertEquals(emojiId.length, long.position)
+        val notEmoji = FFIPublicKey.validateEmojiId(emojiId.substring(0, 4) + "x" + emojiId.substring(6))
+        assertEquals(FFIPublicKey.EmojiIdValidation.NOT_AN_EMOJI, notEmoji.error)
+        assertEquals(4, notEmoji.position)
+        // swap the first two emoji, the checksum no longer matches
+        val swapped = emojiId.substring(2, 4) + emojiId.substring(0, 2) + emojiId.substring(4)
+        val checksum = FFIPublicKey.validateEmojiId(swapped)
+        assertEquals(FFIPublicKey.EmojiIdValidation.CHECKSUM, checksum.error)
+        assertEquals(emojiId.length - 2, checksum.position)
+    }
+
     @Test(expected = FFIException::class)
     fun constructor_assertThatFFIExceptionWasThrown_if6CharsLengthStringWasGiven() {
         FFIPublicKey(FFIByteVector(HexString("A03DB4")))
@@ -45,11 +45,15 @@ import org.junit.runners.Suite
     FFIByteVectorTests::class,
     FFICommsConfigTests::class,
     FFIContactTests::class,
+    FFIEmojiSetTests::class,
+    FFIHandleArenaTests::class,
     FFIPrivateKeyTests::class,
     FFIPublicKeyTests::class,
     FFITransportTypeTest::class,
     HexStringTests::class,
     NetAddressStringTests::class,
+    FFIUtf8Tests::class,
+    TxSnapshotTests::class,
     FFIWalletTests::class
 )
 class FFITestSuite
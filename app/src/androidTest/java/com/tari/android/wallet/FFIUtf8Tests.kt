@@ -0,0 +1,77 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+package com.tari.android.wallet
+
+import com.tari.android.wallet.ffi.FFIUtil
+import org.junit.Assert.assertEquals
+import org.junit.Test
+
+/**
+ * Checks the native UTF-8 transcoder used for strings returned by libwallet against the Java
+ * UTF-8 decoder.
+ *
+ * @author The Tari Development Team
+ */
+class FFIUtf8Tests {
+
+    @Test
+    fun decodeUtf8_assertThatValidTextIsDecodedLikeJava() {
+        val inputs = listOf(
+            "",
+            "plain ascii message that is longer than one vector block",
+            FFITestUtil.PUBLIC_KEY_EMOJI_ID,
+            "⛵️🚿😻♐️♊️⌛️",
+            "Grüße, 你好 " + FFITestUtil.PUBLIC_KEY_EMOJI_ID + " done"
+        )
+        for (input in inputs) {
+            assertEquals(input, FFIUtil.decodeUtf8(input.toByteArray(Charsets.UTF_8)))
+        }
+    }
+
+    @Test
+    fun decodeUtf8_assertThatMalformedInputIsReplacedLikeJava() {
+        val emoji = FFITestUtil.PUBLIC_KEY_EMOJI_ID.toByteArray(Charsets.UTF_8)
+        val inputs = listOf(
+            byteArrayOf(0xC0.toByte(), 0xAF.toByte()),
+            byteArrayOf(0xED.toByte(), 0xA0.toByte(), 0x80.toByte()),
+            byteArrayOf(0xF4.toByte(), 0x90.toByte(), 0x80.toByte(), 0x80.toByte()),
+            // truncated emoji inside and at the end of an emoji run
+            emoji.copyOfRange(0, 18) + emoji.copyOfRange(19, emoji.size),
+            emoji.copyOfRange(0, emoji.size - 1)
+        )
+        for (input in inputs) {
+            assertEquals(String(input, Charsets.UTF_8), FFIUtil.decodeUtf8(input))
+        }
+    }
+
+}
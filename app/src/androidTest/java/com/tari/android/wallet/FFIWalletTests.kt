@@ -38,6 +38,7 @@
 package com.tari.android.wallet
 
 import android.content.Context
+import android.os.Debug
 import androidx.test.core.app.ApplicationProvider.getApplicationContext
 import androidx.test.ext.junit.runners.AndroidJUnit4
 import com.orhanobut.logger.Logger
@@ -212,6 +213,115 @@ class FFIWalletTests {
         assertEquals(nullptr, emojiSet.pointer)
     }
 
+    /**
+     * Reads four u64 values per iteration, roughly what loading one history row costs, and
+     * counts the objects allocated on this thread. Each getter allocates its FFIError and
+     * nothing else; the former byte array encoding added an array, a BigInteger and its
+     * magnitude array per value.
+     */
+    @Suppress("DEPRECATION")
+    @Test
+    fun testU64GetterAllocations() {
+        val loadCount = 10_000
+        val valuesPerLoad = 4
+        // iterator and logging noise
+        val slack = 64
+        repeat(loadCount / 10) { readU64Values() }
+        Debug.startAllocCounting()
+        Debug.resetThreadAllocCount()
+        repeat(loadCount) { readU64Values() }
+        val rawAllocations = Debug.getThreadAllocCount()
+        Debug.resetThreadAllocCount()
+        repeat(loadCount) { readU64Values().toBigInteger() }
+        val bigIntegerAllocations = Debug.getThreadAllocCount()
+        Debug.stopAllocCounting()
+        Logger.i(
+            "Allocations per %d loads: raw %d, with BigInteger conversion %d",
+            loadCount,
+            rawAllocations,
+            bigIntegerAllocations
+        )
+        assertTrue(rawAllocations <= loadCount * valuesPerLoad + slack)
+    }
+
+    /**
+     * Builds a 10k tx history the way the service converts snapshot records and counts the
+     * objects allocated on this thread, once as loaded and once with every unsigned field read.
+     * A loaded tx allocates seven objects: itself, its user and that user's public key, two
+     * default amounts and the amount and fee. The u64 fields stay raw until read, reading them
+     * adds a BigInteger and its magnitude array per value above the small value cache.
+     */
+    @Suppress("DEPRECATION")
+    @Test
+    fun testTxHistoryLoadAllocations() {
+        val loadCount = 10_000
+        val objectsPerTx = 7
+        // iterator and logging noise
+        val slack = 64
+        val user = User()
+        fun loadTx(index: Int) = CompletedTx(
+            UnsignedLong(1_000_000_000_000L + index),
+            Tx.Direction.INBOUND,
+            user,
+            MicroTari(UnsignedLong(5_000_000_000L + index)),
+            MicroTari(UnsignedLong(100_000L + index)),
+            UnsignedLong(1_600_000_000L + index),
+            "",
+            TxStatus.MINED_CONFIRMED,
+            UnsignedLong(3)
+        )
+        repeat(loadCount / 10) { loadTx(it) }
+        Debug.startAllocCounting()
+        Debug.resetThreadAllocCount()
+        for (index in 0 until loadCount) {
+            loadTx(index)
+        }
+        val loadAllocations = Debug.getThreadAllocCount()
+        Debug.resetThreadAllocCount()
+        for (index in 0 until loadCount) {
+            val tx = loadTx(index)
+            tx.id
+            tx.amount.value
+            tx.fee.value
+            tx.timestamp
+            tx.confirmationCount
+        }
+        val convertedAllocations = Debug.getThreadAllocCount()
+        Debug.stopAllocCounting()
+        Logger.i(
+            "Allocations per %d tx history load: %d, with every u64 field read %d",
+            loadCount,
+            loadAllocations,
+            convertedAllocations
+        )
+        assertTrue(loadAllocations <= loadCount * objectsPerTx + slack)
+        assertTrue(loadAllocations < convertedAllocations)
+    }
+
+    private fun readU64Values(): UnsignedLong {
+        wallet.getAvailableBalance()
+        wallet.getPendingInboundBalance()
+        wallet.getPendingOutboundBalance()
+        return wallet.getRequiredConfirmationCount()
+    }
+
+    @Test
+    fun testEventBatchDispatch() {
+        val mockListener = mockk<FFIWalletListener>(relaxed = true, relaxUnitFun = true)
+        wallet.listener = mockListener
+        // direct send result for tx id 2^64 - 1, then a successful TXO validation
+        wallet.onEvents(longArrayOf(7, -1L, 1, 0, 10, 5, 0, 0), 2)
+        verify(timeout = 1000) {
+            mockListener.onDirectSendResult(BigInteger.ONE.shiftLeft(64).dec(), true)
+        }
+        verify(timeout = 1000) {
+            mockListener.onTXOValidationComplete(BigInteger.valueOf(5), BaseNodeValidationResult.SUCCESS)
+        }
+        val stats = wallet.getEventQueueStats()
+        Logger.i(stats.toString())
+        assertEquals(0L, stats.droppedCount)
+    }
+
     //    @Test
     //todo implement transactions testing
     fun testReceiveTxFlow() {
@@ -229,18 +339,29 @@ class FFIWalletTests {
         val pendingInboundTxFFI = pendingInboundTxsFFI.getAt(0)
         assertEquals(
             pendingInboundTx.id,
-            pendingInboundTxFFI.getId()
+            pendingInboundTxFFI.getId().toBigInteger()
         )
         assertEquals(
             TxStatus.PENDING,
             pendingInboundTx.status
         )
+        // the bulk snapshot carries the same fields as the per-tx getters
+        val snapshot = pendingInboundTxsFFI.getSnapshot()
+        assertEquals(pendingInboundTxsFFI.getLength(), snapshot.size)
+        assertEquals(pendingInboundTxFFI.getId(), snapshot[0].id)
+        assertEquals(pendingInboundTxFFI.getAmount(), snapshot[0].amount)
+        assertEquals(pendingInboundTxFFI.getTimestamp(), snapshot[0].timestamp)
+        assertEquals(pendingInboundTxFFI.getMessage(), snapshot[0].message)
+        assertFalse(snapshot[0].isOutbound)
+        val sourcePublicKeyFFI = pendingInboundTxFFI.getSourcePublicKey()
+        assertEquals(sourcePublicKeyFFI.toString(), snapshot[0].counterpartyPublicKeyHex)
+        sourcePublicKeyFFI.destroy()
         pendingInboundTxsFFI.destroy()
         // test get pending inbound tx by id
         val pendingInboundTxByIdFFI = wallet.getPendingInboundTxById(pendingInboundTx.id)
         assertEquals(
             pendingInboundTx.id,
-            pendingInboundTxByIdFFI.getId()
+            pendingInboundTxByIdFFI.getId().toBigInteger()
         )
         pendingInboundTxByIdFFI.destroy()
 
@@ -275,7 +396,7 @@ class FFIWalletTests {
         // test wallet pending inbound balance
         assertEquals(
             pendingInboundTx.amount.value,
-            wallet.getPendingInboundBalance()
+            wallet.getPendingInboundBalance().toBigInteger()
         )
 
         // test mine tx
@@ -299,7 +420,7 @@ class FFIWalletTests {
         val completedTxFFI = completedTxsFFI.getAt(0)
         assertEquals(
             pendingInboundTx.id,
-            completedTxFFI.getId()
+            completedTxFFI.getId().toBigInteger()
         )
         completedTxFFI.destroy()
         completedTxsFFI.destroy()
@@ -307,14 +428,130 @@ class FFIWalletTests {
         val minedTxByIdFFI = wallet.getCompletedTxById(pendingInboundTx.id)
         assertEquals(
             pendingInboundTx.id,
-            minedTxByIdFFI.getId()
+            minedTxByIdFFI.getId().toBigInteger()
         )
         minedTxByIdFFI.destroy()
         // available balance
         assertEquals(
             pendingInboundTx.amount.value,
-            wallet.getAvailableBalance()
+            wallet.getAvailableBalance().toBigInteger()
         )
+        // columnar table
+        val table = wallet.getTxTable()
+        val completedRows = table.rows { table.kinds[it] == TxTable.KIND_COMPLETED }
+        assertEquals(1, completedRows.size)
+        assertEquals(pendingInboundTx.id, table.id(completedRows[0]).toBigInteger())
+        assertEquals(pendingInboundTx.amount.value, table.sumAmounts(completedRows))
+        assertEquals(pendingInboundTx.message, table.message(completedRows[0]))
+        assertFalse(table.isOutbound(completedRows[0]))
+        // the tx cache returns everything once, then nothing until the next change
+        val changes = wallet.getTxChangesSince(0)
+        assertEquals(table.size, changes.size)
+        assertTrue(changes.changes.all { it == TxTable.CHANGE_INSERTED })
+        assertEquals(0, wallet.getTxChangesSince(changes.generation).size)
+        // the first page covers the merged history without materializing it
+        val page = wallet.getTxPage(limit = 1)
+        assertEquals(table.size, page.totalCount)
+        assertEquals(1, page.size)
+        assertEquals(table.timestamps.maxOrNull(), page.timestamps[0])
+        val completedPage = wallet.getTxPage(
+            sortKey = TxTable.SORT_BY_AMOUNT,
+            kindMask = 1 shl TxTable.KIND_COMPLETED,
+            limit = 10
+        )
+        assertEquals(completedRows.size, completedPage.totalCount)
+        // message search ignores ASCII case
+        if (pendingInboundTx.message.isNotEmpty()) {
+            val hits = wallet.searchTxs(pendingInboundTx.message.uppercase(), limit = 10)
+            assertTrue(hits.any { it.toBigInteger() == pendingInboundTx.id })
+        }
+        assertTrue(wallet.searchTxs("\u0000no such message\u0000", limit = 10).isEmpty())
+    }
+
+    @Test
+    fun testTxTableMatchesCollections() {
+        // a new wallet has no txs, jni_host_tests checks the table row by row on a seeded stub
+        val table = wallet.getTxTable()
+        assertEquals(table.size, table.totalCount)
+        val completedTxsFFI = wallet.getCompletedTxs()
+        val cancelledTxsFFI = wallet.getCancelledTxs()
+        val pendingInboundTxsFFI = wallet.getPendingInboundTxs()
+        val pendingOutboundTxsFFI = wallet.getPendingOutboundTxs()
+        assertEquals(
+            completedTxsFFI.getLength(),
+            table.rows { table.kinds[it] == TxTable.KIND_COMPLETED }.size
+        )
+        assertEquals(
+            cancelledTxsFFI.getLength(),
+            table.rows { table.kinds[it] == TxTable.KIND_CANCELLED }.size
+        )
+        assertEquals(
+            pendingInboundTxsFFI.getLength(),
+            table.rows { table.kinds[it] == TxTable.KIND_PENDING_INBOUND }.size
+        )
+        assertEquals(
+            pendingOutboundTxsFFI.getLength(),
+            table.rows { table.kinds[it] == TxTable.KIND_PENDING_OUTBOUND }.size
+        )
+        completedTxsFFI.destroy()
+        cancelledTxsFFI.destroy()
+        pendingInboundTxsFFI.destroy()
+        pendingOutboundTxsFFI.destroy()
+        compareTxTableWithObjectModel()
+    }
+
+    @Test
+    fun testTxChangesSinceOfNewWallet() {
+        // jni_host_tests covers updates, removals and the resync against a seeded stub
+        val changes = wallet.getTxChangesSince(0)
+        assertEquals(wallet.getTxTable().size, changes.size)
+        assertTrue(changes.changes.all { it == TxTable.CHANGE_INSERTED })
+        assertTrue(changes.isComplete)
+        val unchanged = wallet.getTxChangesSince(changes.generation)
+        assertEquals(0, unchanged.size)
+        assertEquals(changes.generation, unchanged.generation)
+        assertFalse(unchanged.isComplete)
+    }
+
+    /**
+     * Logs heap allocation and amount-sum scan time of the columnar table against the
+     * per-object FFICompletedTx model.
+     */
+    private fun compareTxTableWithObjectModel() {
+        val iterations = 100
+        Debug.startAllocCounting()
+        Debug.resetThreadAllocSize()
+        val table = wallet.getTxTable()
+        val tableBytes = Debug.getThreadAllocSize()
+        Debug.resetThreadAllocSize()
+        val completedTxsFFI = wallet.getCompletedTxs()
+        val txs = (0 until completedTxsFFI.getLength()).map { completedTxsFFI.getAt(it) }
+        val objectBytes = Debug.getThreadAllocSize()
+        Debug.stopAllocCounting()
+
+        var start = System.nanoTime()
+        repeat(iterations) {
+            table.sumAmounts(table.rows { table.kinds[it] == TxTable.KIND_COMPLETED })
+        }
+        val tableNanos = System.nanoTime() - start
+        start = System.nanoTime()
+        repeat(iterations) {
+            txs.fold(BigInteger.ZERO) { sum, tx -> sum + tx.getAmount().toBigInteger() }
+        }
+        val objectNanos = System.nanoTime() - start
+        Logger.i(
+            "Tx table (%d rows, ~%d bytes): %d bytes allocated, %d ns per sum. " +
+                    "Object model (%d txs): %d bytes allocated, %d ns per sum.",
+            table.size,
+            table.estimateFootprintBytes(),
+            tableBytes,
+            tableNanos / iterations,
+            txs.size,
+            objectBytes,
+            objectNanos / iterations
+        )
+        txs.forEach { it.destroy() }
+        completedTxsFFI.destroy()
     }
 
     //@Test
@@ -343,7 +580,7 @@ class FFIWalletTests {
         // cancel tx
         val cancelledTxSlot = slot<CancelledTx>()
         every { mockListener.onTxCancelled(capture(cancelledTxSlot)) } answers { }
-        assertTrue(wallet.cancelPendingTx(pendingInboundTxFFI!!.getId()))
+        assertTrue(wallet.cancelPendingTx(pendingInboundTxFFI!!.getId().toBigInteger()))
         pendingInboundTxFFI.destroy()
         Thread.sleep(1000)
         verify { mockListener.onTxCancelled(any()) }
@@ -354,14 +591,14 @@ class FFIWalletTests {
         cancelledTxsFFI.destroy()
         assertEquals(
             cancelledTx.id,
-            cancelledTxFFI.getId()
+            cancelledTxFFI.getId().toBigInteger()
         )
         cancelledTxFFI.destroy()
         // get by id
         val cancelledTxByIdFFI = wallet.getCancelledTxById(cancelledTx.id)
         assertEquals(
             cancelledTx.id,
-            cancelledTxByIdFFI.getId()
+            cancelledTxByIdFFI.getId().toBigInteger()
         )
         cancelledTxByIdFFI.destroy()
 
@@ -379,7 +616,7 @@ class FFIWalletTests {
         // broadcast tx
         val broadcastTxSlot = slot<PendingOutboundTx>()
         every { mockListener.onOutboundTxBroadcast(capture(broadcastTxSlot)) } answers { }
-        assertTrue(wallet.testBroadcastTx(pendingOutboundTxFFI!!.getId()))
+        assertTrue(wallet.testBroadcastTx(pendingOutboundTxFFI!!.getId().toBigInteger()))
         Thread.sleep(1000)
         verify { mockListener.onOutboundTxBroadcast(any()) }
         val broadcastTx = broadcastTxSlot.captured
@@ -401,7 +638,7 @@ class FFIWalletTests {
         assertNotNull(pendingOutboundTxFFI)
         val minedTxSlot = slot<CompletedTx>()
         every { mockListener.onTxMined(capture(minedTxSlot)) } answers { }
-        assertTrue(wallet.testMineTx(pendingOutboundTxFFI!!.getId()))
+        assertTrue(wallet.testMineTx(pendingOutboundTxFFI!!.getId().toBigInteger()))
         Thread.sleep(1000)
         pendingOutboundTxFFI.destroy()
         verify { mockListener.onTxMined(any()) }
@@ -414,8 +651,25 @@ class FFIWalletTests {
         val minedTxFFI = wallet.getCompletedTxById(minedTx.id)
         assertEquals(
             minedTx.id,
-            minedTxFFI.getId()
+            minedTxFFI.getId().toBigInteger()
+        )
+        // the binary kernel export matches the per-field hex getters
+        val kernel = minedTxFFI.getTransactionKernel()
+        val kernelBytes = kernel.getBytes()
+        val fieldSize = FFICompletedTxKernel.FIELD_SIZE
+        assertEquals(
+            kernel.getExcess().uppercase(),
+            kernelBytes.copyOfRange(0, fieldSize).joinToString("") { "%02X".format(it) }
+        )
+        assertEquals(
+            kernel.getExcessPublicNonce().uppercase(),
+            kernelBytes.copyOfRange(fieldSize, 2 * fieldSize).joinToString("") { "%02X".format(it) }
         )
+        assertEquals(
+            kernel.getExcessSignature().uppercase(),
+            kernelBytes.copyOfRange(2 * fieldSize, 3 * fieldSize).joinToString("") { "%02X".format(it) }
+        )
+        kernel.destroy()
         minedTxFFI.destroy()
     }
 
@@ -448,6 +702,35 @@ class FFIWalletTests {
         wallet.getKeyValue(key)
     }
 
+    @Test(expected = FFIException::class)
+    fun testTxIdOutOfUnsignedRange() {
+        wallet.getCompletedTxById(BigInteger.ONE.shiftLeft(64))
+    }
+
+    @Test(expected = FFIException::class)
+    fun testNegativeFeeEstimateArgument() {
+        wallet.estimateTxFee(
+            BigInteger.valueOf(-1L),
+            BigInteger.valueOf(100L),
+            BigInteger.ONE,
+            BigInteger.ONE
+        )
+    }
+
+    @Test
+    fun testFeeEstimateArgumentAbove2To63IsRejectedNatively() {
+        // a valid unsigned 64-bit value, passed to jniEstimateTxFeeU64 with the sign bit set
+        val exception = assertThrows(FFIException::class.java) {
+            wallet.estimateTxFee(
+                BigInteger.ONE.shiftLeft(63),
+                BigInteger.valueOf(100L),
+                BigInteger.ONE,
+                BigInteger.ONE
+            )
+        }
+        assertEquals(WalletErrorCode.INVALID_ARGUMENT.code, exception.error?.code)
+    }
+
     private class TestAddRecipientListener : FFIWalletListener {
 
         val receivedTxs = mutableListOf<PendingInboundTx>()
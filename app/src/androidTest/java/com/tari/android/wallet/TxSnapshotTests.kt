@@ -0,0 +1,122 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+package com.tari.android.wallet
+
+import com.tari.android.wallet.ffi.FFIException
+import com.tari.android.wallet.ffi.TxSnapshot
+import org.junit.Assert.*
+import org.junit.Test
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * Tx snapshot layout tests. The buffers are written the way jniCollections.cpp writes them.
+ *
+ * @author The Tari Development Team
+ */
+class TxSnapshotTests {
+
+    private fun buffer(vararg messages: String): ByteBuffer {
+        val buffer = ByteBuffer.allocateDirect(1024).order(ByteOrder.nativeOrder())
+        buffer.position(16)
+        messages.forEachIndexed { index, message ->
+            buffer.putLong(index + 1L) // id
+            buffer.putLong(1000L * (index + 1)) // amount
+            buffer.putLong(100L) // fee
+            buffer.putLong(-1L) // timestamp, u64 max
+            buffer.putLong(3L) // confirmation count
+            buffer.putInt(6) // status
+            buffer.putInt(index % 2) // flags
+            buffer.put(ByteArray(32) { it.toByte() })
+            val bytes = message.toByteArray(Charsets.UTF_8)
+            buffer.putInt(bytes.size)
+            buffer.put(bytes)
+            buffer.position((buffer.position() + 7) and 7.inv())
+        }
+        val size = buffer.position()
+        buffer.putInt(0, 1)
+        buffer.putInt(4, messages.size)
+        buffer.putInt(8, size)
+        buffer.putInt(12, 0)
+        return buffer
+    }
+
+    @Test
+    fun read_assertThatAllFieldsAreDecoded() {
+        val records = TxSnapshot.read(buffer("", "Hello ⛵️", "1234567"))
+        assertEquals(3, records.size)
+        assertEquals("", records[0].message)
+        assertEquals("Hello ⛵️", records[1].message)
+        assertEquals("1234567", records[2].message)
+        assertEquals(2L, records[1].id.toLong())
+        assertEquals(2000L, records[1].amount.toLong())
+        assertEquals(100L, records[1].fee.toLong())
+        assertEquals("18446744073709551615", records[1].timestamp.toString())
+        assertEquals(3L, records[1].confirmationCount.toLong())
+        assertEquals(6, records[1].status)
+        assertFalse(records[0].isOutbound)
+        assertTrue(records[1].isOutbound)
+        assertEquals(
+            "000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F",
+            records[2].counterpartyPublicKeyHex
+        )
+    }
+
+    @Test
+    fun take_assertThatTheBufferGrowsUntilTheSnapshotFits() {
+        val snapshot = buffer("a", "b")
+        var calls = 0
+        val records = TxSnapshot.take { target, error ->
+            calls++
+            error.code = 0
+            if (calls == 1) {
+                return@take target.capacity() + 1
+            }
+            val source = snapshot.duplicate()
+            source.position(0)
+            source.limit(snapshot.getInt(8))
+            target.put(source)
+            snapshot.getInt(8)
+        }
+        assertEquals(2, calls)
+        assertEquals(2, records.size)
+    }
+
+    @Test(expected = FFIException::class)
+    fun read_expectFFIExceptionThrow_ifVersionIsUnknown() {
+        val buffer = buffer("a")
+        buffer.putInt(0, 2)
+        TxSnapshot.read(buffer)
+    }
+
+}
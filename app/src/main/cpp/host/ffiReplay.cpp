@@ -0,0 +1,1147 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ftw.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "../jniFfiTrace.cpp"
+
+#if TARI_REPLAY_STUB
+#include "stubWallet.h"
+#endif
+
+/**
+ * Replays an FFI trace recorded by native-lib (FFIUtil.startFfiTrace, see jniFfiTrace.cpp) against
+ * the wallet library on a Linux host: the stub of stubWallet.cpp, or a host build of
+ * libtari_wallet_ffi when configured with TARI_WALLET_LIBRARY.
+ *
+ * Every recorded thread is replayed by a thread of its own, issuing its calls in recorded order
+ * and, unless --speed is 0, at their recorded times divided by the speed. A call that uses a wallet
+ * created earlier in the trace waits for that wallet_create to be replayed. The replay sets up its
+ * own comms config, keys and contact for the handles that were created outside the traced calls,
+ * and a wallet for calls on a wallet that already existed when recording started. Returned
+ * handles other than wallets are released right away. Strings recorded by length only are
+ * replayed as filler of that length, paths are replaced by the replay's datastore.
+ *
+ * Against the stub, the recorded callbacks are raised again at their recorded times; the real
+ * library raises whatever callbacks the replayed calls cause.
+ *
+ * Usage: ffi_replay TRACE [--speed FACTOR] [--datastore DIR] [--dump] [--no-callbacks]
+ *                         [--completed N] [--latency-ns N] [--out FILE]
+ */
+
+static const char *const kJsonSchema = "tari-ffi-replay/1";
+
+static const int64_t kProducerTimeoutNanos = 10000000000LL;
+
+struct Options {
+    std::string trace;
+    std::string datastore;
+    std::string out;
+    // recorded time per replayed time, 0 replays as fast as possible
+    double speed = 1;
+    bool dump = false;
+    bool callbacks = true;
+#if TARI_REPLAY_STUB
+    StubWalletConfig stub = stubWalletDefaultConfig();
+#endif
+};
+
+struct FfiValue {
+    uint8_t tag = kFfiValueVoid;
+    // kFfiValueInt, kFfiValueError, kFfiValueFlag and handle addresses
+    int64_t value = 0;
+    // string length or collection element count
+    uint64_t length = 0;
+    std::string text;
+};
+
+struct FfiRecord {
+    uint8_t kind = 0;
+    uint32_t id = 0;
+    uint64_t thread = 0;
+    int64_t start = 0;
+    int64_t duration = 0;
+    std::vector<FfiValue> values;
+    FfiValue result;
+};
+
+class FfiTraceReader {
+public:
+    /**
+     * Reads every record of the trace at path. Returns false with a message in error if the file
+     * cannot be read or is not a trace; a record cut off at the end of the file, as left by a
+     * process that died while recording, is ignored.
+     */
+    bool read(const char *path, std::vector<FfiRecord> &records, std::string &error) {
+        FILE *pFile = fopen(path, "rb");
+        if (pFile == nullptr) {
+            error = std::string("cannot open ") + path;
+            return false;
+        }
+        char chunk[64 * 1024];
+        size_t count;
+        while ((count = fread(chunk, 1, sizeof(chunk), pFile)) > 0) {
+            bytes.insert(bytes.end(), chunk, chunk + count);
+        }
+        fclose(pFile);
+        if (bytes.size() < sizeof(kFfiTraceMagic) + 1 ||
+            memcmp(bytes.data(), kFfiTraceMagic, sizeof(kFfiTraceMagic)) != 0) {
+            error = "not an FFI trace";
+            return false;
+        }
+        if (bytes[sizeof(kFfiTraceMagic)] != kFfiTraceVersion) {
+            error = "unsupported trace version " + std::to_string(bytes[sizeof(kFfiTraceMagic)]);
+            return false;
+        }
+        position = sizeof(kFfiTraceMagic) + 1;
+        while (position < bytes.size()) {
+            FfiRecord record;
+            if (!readRecord(record)) {
+                if (truncated) {
+                    break;
+                }
+                error = "malformed record at byte " + std::to_string(position);
+                return false;
+            }
+            records.push_back(std::move(record));
+        }
+        return true;
+    }
+
+private:
+    bool readByte(uint8_t &value) {
+        if (position >= bytes.size()) {
+            truncated = true;
+            return false;
+        }
+        value = bytes[position++];
+        return true;
+    }
+
+    bool readVarint(uint64_t &value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte;
+            if (!readByte(byte)) {
+                return false;
+            }
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool readSigned(int64_t &value) {
+        uint64_t encoded;
+        if (!readVarint(encoded)) {
+            return false;
+        }
+        value = static_cast<int64_t>(encoded >> 1) ^ -static_cast<int64_t>(encoded & 1);
+        return true;
+    }
+
+    bool readValue(FfiValue &value) {
+        if (!readByte(value.tag)) {
+            return false;
+        }
+        uint64_t raw;
+        switch (value.tag) {
+            case kFfiValueVoid:
+            case kFfiValueNull:
+            case kFfiValueFunction:
+                return true;
+            case kFfiValueInt:
+            case kFfiValueError:
+                return readSigned(value.value);
+            case kFfiValueHandle:
+                if (!readVarint(raw)) {
+                    return false;
+                }
+                value.value = static_cast<int64_t>(raw);
+                return true;
+            case kFfiValueFlag: {
+                uint8_t flag;
+                if (!readByte(flag)) {
+                    return false;
+                }
+                value.value = flag;
+                return true;
+            }
+            case kFfiValueStringLength:
+                return readVarint(value.length);
+            case kFfiValueString:
+                if (!readVarint(value.length)) {
+                    return false;
+                }
+                if (bytes.size() - position < value.length) {
+                    truncated = true;
+                    return false;
+                }
+                value.text.assign(reinterpret_cast<const char *>(bytes.data() + position),
+                                  value.length);
+                position += value.length;
+                return true;
+            case kFfiValueCollection:
+                if (!readVarint(raw)) {
+                    return false;
+                }
+                value.value = static_cast<int64_t>(raw);
+                return readVarint(value.length);
+            default:
+                return false;
+        }
+    }
+
+    bool readRecord(FfiRecord &record) {
+        uint64_t id, start, duration = 0, count;
+        if (!readByte(record.kind) || !readVarint(id) || !readVarint(record.thread)) {
+            return false;
+        }
+        record.id = static_cast<uint32_t>(id);
+        if (record.kind == kFfiRecordCall) {
+            if (id >= kFfiCallCount || !readVarint(start) || !readVarint(duration) ||
+                !readVarint(count) || count > 64) {
+                return false;
+            }
+            record.values.resize(count);
+            for (FfiValue &value : record.values) {
+                if (!readValue(value)) {
+                    return false;
+                }
+            }
+            if (!readValue(record.result)) {
+                return false;
+            }
+        } else if (record.kind == kFfiRecordCallback) {
+            if (id >= kFfiCallbackCount || !readVarint(start) || !readVarint(count) || count > 8) {
+                return false;
+            }
+            record.values.resize(count);
+            for (FfiValue &value : record.values) {
+                value.tag = kFfiValueInt;
+                if (!readSigned(value.value)) {
+                    return false;
+                }
+            }
+        } else {
+            return false;
+        }
+        record.start = static_cast<int64_t>(start);
+        record.duration = static_cast<int64_t>(duration);
+        return true;
+    }
+
+    std::vector<uint8_t> bytes;
+    size_t position = 0;
+    bool truncated = false;
+};
+
+static std::string describeValue(const FfiValue &value) {
+    char text[64];
+    switch (value.tag) {
+        case kFfiValueVoid:
+            return "void";
+        case kFfiValueNull:
+            return "null";
+        case kFfiValueFunction:
+            return "callback";
+        case kFfiValueInt:
+            return std::to_string(value.value);
+        case kFfiValueError:
+            return "error=" + std::to_string(value.value);
+        case kFfiValueFlag:
+            return value.value != 0 ? "flag=true" : "flag=false";
+        case kFfiValueHandle:
+            snprintf(text, sizeof(text), "0x%llx", static_cast<unsigned long long>(value.value));
+            return text;
+        case kFfiValueCollection:
+            snprintf(text, sizeof(text), "0x%llx[%llu]", static_cast<unsigned long long>(value.value),
+                     static_cast<unsigned long long>(value.length));
+            return text;
+        case kFfiValueString:
+            return "\"" + value.text + "\"";
+        case kFfiValueStringLength:
+            return "string[" + std::to_string(value.length) + "]";
+        default:
+            return "?";
+    }
+}
+
+static void dumpRecords(const std::vector<FfiRecord> &records, FILE *out) {
+    for (const FfiRecord &record : records) {
+        std::string values;
+        for (const FfiValue &value : record.values) {
+            values += (values.empty() ? "" : ", ") + describeValue(value);
+        }
+        if (record.kind == kFfiRecordCall) {
+            fprintf(out, "%14.6f ms  thread %-3llu %s(%s) -> %s in %lld ns\n", record.start / 1e6,
+                    static_cast<unsigned long long>(record.thread), kFfiCallNames[record.id],
+                    values.c_str(), describeValue(record.result).c_str(),
+                    static_cast<long long>(record.duration));
+        } else {
+            fprintf(out, "%14.6f ms  thread %-3llu callback %s(%s)\n", record.start / 1e6,
+                    static_cast<unsigned long long>(record.thread), kFfiCallbackNames[record.id],
+                    values.c_str());
+        }
+    }
+}
+
+static std::atomic<uint64_t> g_callbacksDelivered[kFfiCallbackCount];
+
+struct CallStats {
+    uint64_t count = 0;
+    // calls on a wallet that was destroyed or never created in the replay
+    uint64_t skipped = 0;
+    uint64_t recordedErrors = 0;
+    uint64_t replayedErrors = 0;
+    int64_t recordedNanos = 0;
+    int64_t recordedMaxNanos = 0;
+    int64_t replayedNanos = 0;
+    int64_t replayedMaxNanos = 0;
+};
+
+/**
+ * Handles and wallets shared by the replaying threads.
+ */
+class ReplayContext {
+public:
+    explicit ReplayContext(const std::vector<FfiRecord> &records) : records(records),
+                                                                     replayed(records.size()) {
+        for (std::atomic<bool> &flag : replayed) {
+            flag.store(false);
+        }
+        findPrerequisites();
+    }
+
+    bool setUp(const Options &options);
+
+    void tearDown();
+
+    /**
+     * Waits until the records the one at index depends on were replayed: the wallet_create that
+     * returned its wallet argument and, for wallet_destroy, every earlier call on that wallet and
+     * every earlier callback.
+     */
+    void waitForPrerequisites(size_t index) {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (size_t prerequisite : prerequisites[index]) {
+            replayedCondition.wait_for(lock, std::chrono::nanoseconds(kProducerTimeoutNanos), [&]() {
+                return replayed[prerequisite].load();
+            });
+        }
+    }
+
+    /**
+     * Replay wallet for the recorded wallet argument of the call at index. The wallet of the
+     * replay context stands in for wallets created before recording started, null if there is
+     * none.
+     */
+    TariWallet *wallet(size_t index, int64_t recorded) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = wallets.find(recorded);
+        if (found != wallets.end()) {
+            return found->second;
+        }
+        return hasProducer[index] ? nullptr : defaultWallet;
+    }
+
+    void onWalletCreated(int64_t recorded, TariWallet *pWallet) {
+        std::lock_guard<std::mutex> lock(mutex);
+        wallets[recorded] = pWallet;
+        createdWallets.push_back(pWallet);
+    }
+
+    void onWalletDestroyed(int64_t recorded, TariWallet *pWallet) {
+        std::lock_guard<std::mutex> lock(mutex);
+        wallets.erase(recorded);
+        if (pWallet == defaultWallet) {
+            defaultWallet = nullptr;
+        }
+        createdWallets.erase(std::remove(createdWallets.begin(), createdWallets.end(), pWallet),
+                             createdWallets.end());
+    }
+
+    void onReplayed(size_t index) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            replayed[index].store(true);
+        }
+        replayedCondition.notify_all();
+    }
+
+    /**
+     * Any live wallet of the replay, the target of re-raised callbacks.
+     */
+    TariWallet *anyWallet() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (defaultWallet != nullptr) {
+            return defaultWallet;
+        }
+        return createdWallets.empty() ? nullptr : createdWallets.back();
+    }
+
+    void addStats(uint32_t call, const CallStats &delta) {
+        std::lock_guard<std::mutex> lock(mutex);
+        CallStats &total = stats[call];
+        total.count += delta.count;
+        total.skipped += delta.skipped;
+        total.recordedErrors += delta.recordedErrors;
+        total.replayedErrors += delta.replayedErrors;
+        total.recordedNanos += delta.recordedNanos;
+        total.recordedMaxNanos = std::max(total.recordedMaxNanos, delta.recordedMaxNanos);
+        total.replayedNanos += delta.replayedNanos;
+        total.replayedMaxNanos = std::max(total.replayedMaxNanos, delta.replayedMaxNanos);
+    }
+
+    const std::vector<FfiRecord> &records;
+    std::string datastore;
+    std::string logPath;
+    TariTransportType *pTransport = nullptr;
+    TariCommsConfig *pCommsConfig = nullptr;
+    TariPrivateKey *pPrivateKey = nullptr;
+    TariPublicKey *pPublicKey = nullptr;
+    TariContact *pContact = nullptr;
+    CallStats stats[kFfiCallCount];
+    bool removeDatastore = false;
+    // held while a callback is raised on a replay wallet and while one is destroyed
+    std::mutex walletLifetime;
+
+private:
+    void findPrerequisites() {
+        prerequisites.assign(records.size(), std::vector<size_t>());
+        hasProducer.assign(records.size(), false);
+        std::vector<size_t> order(records.size());
+        for (size_t n = 0; n < order.size(); n++) {
+            order[n] = n;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](size_t left, size_t right) {
+            return records[left].start < records[right].start;
+        });
+        // per recorded wallet, the wallet_create that returned it and the calls on it since
+        std::map<int64_t, std::vector<size_t>> walletRecords;
+        std::vector<size_t> callbacks;
+        for (size_t index : order) {
+            const FfiRecord &record = records[index];
+            if (record.kind == kFfiRecordCallback) {
+                callbacks.push_back(index);
+                continue;
+            }
+            if (record.id == kFfiCall_wallet_create) {
+                if (record.result.tag == kFfiValueHandle) {
+                    walletRecords[record.result.value] = std::vector<size_t>(1, index);
+                }
+                continue;
+            }
+            if (record.values.empty() || record.values[0].tag != kFfiValueHandle) {
+                continue;
+            }
+            std::vector<size_t> &uses = walletRecords[record.values[0].value];
+            if (!uses.empty() && records[uses[0]].kind == kFfiRecordCall &&
+                records[uses[0]].id == kFfiCall_wallet_create) {
+                prerequisites[index].push_back(uses[0]);
+                hasProducer[index] = true;
+            }
+            if (record.id == kFfiCall_wallet_destroy) {
+                prerequisites[index] = uses;
+                prerequisites[index].insert(prerequisites[index].end(), callbacks.begin(),
+                                            callbacks.end());
+                walletRecords.erase(record.values[0].value);
+            } else {
+                uses.push_back(index);
+            }
+        }
+    }
+
+    std::vector<std::vector<size_t>> prerequisites;
+    std::vector<bool> hasProducer;
+    std::vector<std::atomic<bool>> replayed;
+    std::mutex mutex;
+    std::condition_variable replayedCondition;
+    std::map<int64_t, TariWallet *> wallets;
+    std::vector<TariWallet *> createdWallets;
+    TariWallet *defaultWallet = nullptr;
+};
+
+/**
+ * Arguments of one replayed call that need storage.
+ */
+struct ReplayArgs {
+    uint32_t call;
+    const FfiRecord *record;
+    ReplayContext *context;
+    TariWallet *pWallet;
+    std::vector<std::string> strings;
+    int error = 0;
+    bool flag = false;
+};
+
+/**
+ * Callback installed in the replayed wallets, at parameter position index of wallet_create or of
+ * wallet_start_recovery (2). Counts the delivery and releases the handle.
+ */
+template<size_t Index, typename Function>
+struct ReplayCallback;
+
+inline void releaseCallbackValue(TariCompletedTransaction *pTx) {
+    completed_transaction_destroy(pTx);
+}
+
+inline void releaseCallbackValue(TariPendingInboundTransaction *pTx) {
+    pending_inbound_transaction_destroy(pTx);
+}
+
+template<typename T>
+inline void releaseCallbackValue(T) {
+}
+
+inline void releaseCallbackValues() {
+}
+
+template<typename First, typename... Rest>
+inline void releaseCallbackValues(First first, Rest... rest) {
+    releaseCallbackValue(first);
+    releaseCallbackValues(rest...);
+}
+
+template<size_t Index, typename... Params>
+struct ReplayCallback<Index, void (*)(Params...)> {
+    static const FfiCallback kCallback = Index == 2
+                                         ? kFfiCallbackRecovery
+                                         : static_cast<FfiCallback>(Index - 6);
+
+    static void invoke(Params... values) {
+        g_callbacksDelivered[kCallback]++;
+        releaseCallbackValues(values...);
+    }
+};
+
+template<typename T>
+struct ArgDecoder;
+
+template<typename T>
+struct IntegralArgDecoder {
+    template<size_t Index>
+    static T decode(ReplayArgs &args) {
+        return static_cast<T>(args.record->values[Index].value);
+    }
+};
+
+template<>
+struct ArgDecoder<bool> : IntegralArgDecoder<bool> {
+};
+
+template<>
+struct ArgDecoder<unsigned char> : IntegralArgDecoder<unsigned char> {
+};
+
+template<>
+struct ArgDecoder<unsigned int> : IntegralArgDecoder<unsigned int> {
+};
+
+template<>
+struct ArgDecoder<unsigned long long> : IntegralArgDecoder<unsigned long long> {
+};
+
+template<>
+struct ArgDecoder<const char *> {
+    template<size_t Index>
+    static const char *decode(ReplayArgs &args) {
+        const FfiValue &value = args.record->values[Index];
+        if (value.tag == kFfiValueNull) {
+            return nullptr;
+        }
+        std::string &text = args.strings[Index];
+        if (args.call == kFfiCall_wallet_create && Index == 1) {
+            text = value.length == 0 ? std::string() : args.context->logPath;
+        } else if (args.call == kFfiCall_wallet_test_generate_data && Index == 1) {
+            text = args.context->datastore;
+        } else if (value.tag == kFfiValueString) {
+            text = value.text;
+        } else {
+            text.assign(value.length, 'x');
+        }
+        return text.c_str();
+    }
+};
+
+template<>
+struct ArgDecoder<int *> {
+    template<size_t Index>
+    static int *decode(ReplayArgs &args) {
+        return &args.error;
+    }
+};
+
+template<>
+struct ArgDecoder<bool *> {
+    template<size_t Index>
+    static bool *decode(ReplayArgs &args) {
+        return args.record->values[Index].tag == kFfiValueNull ? nullptr : &args.flag;
+    }
+};
+
+template<>
+struct ArgDecoder<TariWallet *> {
+    template<size_t Index>
+    static TariWallet *decode(ReplayArgs &args) {
+        return args.pWallet;
+    }
+};
+
+/**
+ * Handles created outside the traced calls are replaced by those of the replay context.
+ */
+template<typename T, T *ReplayContext::*handle>
+struct ContextArgDecoder {
+    template<size_t Index>
+    static T *decode(ReplayArgs &args) {
+        return args.record->values[Index].tag == kFfiValueNull ? nullptr : args.context->*handle;
+    }
+};
+
+template<>
+struct ArgDecoder<TariCommsConfig *>
+        : ContextArgDecoder<TariCommsConfig, &ReplayContext::pCommsConfig> {
+};
+
+template<>
+struct ArgDecoder<TariPrivateKey *> : ContextArgDecoder<TariPrivateKey, &ReplayContext::pPrivateKey> {
+};
+
+template<>
+struct ArgDecoder<TariPublicKey *> : ContextArgDecoder<TariPublicKey, &ReplayContext::pPublicKey> {
+};
+
+template<>
+struct ArgDecoder<TariContact *> : ContextArgDecoder<TariContact, &ReplayContext::pContact> {
+};
+
+/**
+ * Seed words cannot be recreated from a trace, wallets are replayed as new wallets instead.
+ */
+template<>
+struct ArgDecoder<TariSeedWords *> {
+    template<size_t Index>
+    static TariSeedWords *decode(ReplayArgs &) {
+        return nullptr;
+    }
+};
+
+template<typename... Params>
+struct ArgDecoder<void (*)(Params...)> {
+    template<size_t Index>
+    static void (*decode(ReplayArgs &args))(Params...) {
+        if (args.record->values[Index].tag == kFfiValueNull) {
+            return nullptr;
+        }
+        return &ReplayCallback<Index, void (*)(Params...)>::invoke;
+    }
+};
+
+inline void releaseResult(ReplayArgs &, TariContacts *pContacts) {
+    contacts_destroy(pContacts);
+}
+
+inline void releaseResult(ReplayArgs &, TariCompletedTransactions *pTxs) {
+    completed_transactions_destroy(pTxs);
+}
+
+inline void releaseResult(ReplayArgs &, TariPendingInboundTransactions *pTxs) {
+    pending_inbound_transactions_destroy(pTxs);
+}
+
+inline void releaseResult(ReplayArgs &, TariPendingOutboundTransactions *pTxs) {
+    pending_outbound_transactions_destroy(pTxs);
+}
+
+inline void releaseResult(ReplayArgs &, TariCompletedTransaction *pTx) {
+    completed_transaction_destroy(pTx);
+}
+
+inline void releaseResult(ReplayArgs &, TariPendingInboundTransaction *pTx) {
+    pending_inbound_transaction_destroy(pTx);
+}
+
+inline void releaseResult(ReplayArgs &, TariPendingOutboundTransaction *pTx) {
+    pending_outbound_transaction_destroy(pTx);
+}
+
+inline void releaseResult(ReplayArgs &, TariPublicKey *pKey) {
+    public_key_destroy(pKey);
+}
+
+inline void releaseResult(ReplayArgs &, TariSeedWords *pSeedWords) {
+    seed_words_destroy(pSeedWords);
+}
+
+inline void releaseResult(ReplayArgs &, const char *pString) {
+    string_destroy(const_cast<char *>(pString));
+}
+
+inline void releaseResult(ReplayArgs &, char *pString) {
+    string_destroy(pString);
+}
+
+/**
+ * Wallets stay alive for the calls that follow, under the address recorded for them.
+ */
+inline void releaseResult(ReplayArgs &args, TariWallet *pWallet) {
+    if (pWallet != nullptr && args.record->result.tag == kFfiValueHandle) {
+        args.context->onWalletCreated(args.record->result.value, pWallet);
+    } else if (pWallet != nullptr) {
+        wallet_destroy(pWallet);
+    }
+}
+
+inline void releaseResult(ReplayArgs &, bool) {
+}
+
+inline void releaseResult(ReplayArgs &, unsigned long long) {
+}
+
+template<size_t... I>
+struct Indices {
+};
+
+template<size_t N, size_t... I>
+struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {
+};
+
+template<size_t... I>
+struct MakeIndices<0, I...> {
+    typedef Indices<I...> type;
+};
+
+/**
+ * Calls function with the arguments of a record and returns the time it took.
+ */
+template<typename Result, typename... Params>
+struct Replayer {
+    template<size_t... I>
+    static int64_t replay(Result (*function)(Params...), ReplayArgs &args, Indices<I...>) {
+        int64_t start = ffiTraceClockNanos();
+        Result result = function(ArgDecoder<Params>::template decode<I>(args)...);
+        int64_t nanos = ffiTraceClockNanos() - start;
+        releaseResult(args, result);
+        return nanos;
+    }
+};
+
+template<typename... Params>
+struct Replayer<void, Params...> {
+    template<size_t... I>
+    static int64_t replay(void (*function)(Params...), ReplayArgs &args, Indices<I...>) {
+        int64_t start = ffiTraceClockNanos();
+        function(ArgDecoder<Params>::template decode<I>(args)...);
+        return ffiTraceClockNanos() - start;
+    }
+};
+
+template<typename Result, typename... Params>
+inline int64_t replayCall(Result (*function)(Params...), ReplayArgs &args) {
+    if (args.record->values.size() != sizeof...(Params)) {
+        return -1;
+    }
+    args.strings.resize(sizeof...(Params));
+    return Replayer<Result, Params...>::replay(function, args,
+                                               typename MakeIndices<sizeof...(Params)>::type());
+}
+
+typedef int64_t (*ReplayFunction)(ReplayArgs &args);
+
+template<typename Function, Function function>
+int64_t replayFunction(ReplayArgs &args) {
+    return replayCall(function, args);
+}
+
+static const ReplayFunction kReplayFunctions[kFfiCallCount] = {
+#define FFI_REPLAY_FUNCTION(function) &replayFunction<decltype(&function), &function>,
+        FFI_TRACED_CALLS(FFI_REPLAY_FUNCTION)
+#undef FFI_REPLAY_FUNCTION
+};
+
+static void createDefaultWallet(ReplayContext &context, TariWallet *&pWallet) {
+    int error = 0;
+    bool recoveryInProgress = false;
+    pWallet = wallet_create(
+            context.pCommsConfig, context.logPath.c_str(), 2, 1024 * 1024, nullptr, nullptr,
+            &ReplayCallback<6, void (*)(TariPendingInboundTransaction *)>::invoke,
+            &ReplayCallback<7, void (*)(TariCompletedTransaction *)>::invoke,
+            &ReplayCallback<8, void (*)(TariCompletedTransaction *)>::invoke,
+            &ReplayCallback<9, void (*)(TariCompletedTransaction *)>::invoke,
+            &ReplayCallback<10, void (*)(TariCompletedTransaction *)>::invoke,
+            &ReplayCallback<11, void (*)(TariCompletedTransaction *, unsigned long long)>::invoke,
+            &ReplayCallback<12, void (*)(unsigned long long, bool)>::invoke,
+            &ReplayCallback<13, void (*)(unsigned long long, bool)>::invoke,
+            &ReplayCallback<14, void (*)(TariCompletedTransaction *)>::invoke,
+            &ReplayCallback<15, void (*)(unsigned long long, unsigned char)>::invoke,
+            &ReplayCallback<16, void (*)(unsigned long long, unsigned char)>::invoke,
+            &ReplayCallback<17, void (*)()>::invoke,
+            &recoveryInProgress, &error);
+    if (pWallet == nullptr) {
+        fprintf(stderr, "Cannot create the replay wallet, error %d.\n", error);
+    }
+}
+
+bool ReplayContext::setUp(const Options &options) {
+    datastore = options.datastore;
+    if (datastore.empty()) {
+        char pattern[] = "/tmp/ffi_replay_XXXXXX";
+        if (mkdtemp(pattern) == nullptr) {
+            fprintf(stderr, "Cannot create a datastore directory.\n");
+            return false;
+        }
+        datastore = pattern;
+        removeDatastore = true;
+    }
+    logPath = datastore + "/wallet.log";
+    int error = 0;
+    pTransport = transport_memory_create();
+    pCommsConfig = comms_config_create("/memory/0", pTransport, "replay_db", datastore.c_str(),
+                                       30, 600, "weatherwax", &error);
+    pPrivateKey = private_key_generate();
+    pPublicKey = public_key_from_private_key(pPrivateKey, &error);
+    pContact = contact_create("replay", pPublicKey, &error);
+    if (pCommsConfig == nullptr || pPublicKey == nullptr || pContact == nullptr) {
+        fprintf(stderr, "Cannot set up the replay handles, error %d.\n", error);
+        return false;
+    }
+    createDefaultWallet(*this, defaultWallet);
+    return defaultWallet != nullptr;
+}
+
+void ReplayContext::tearDown() {
+    for (TariWallet *pWallet : createdWallets) {
+        wallet_destroy(pWallet);
+    }
+    createdWallets.clear();
+    if (defaultWallet != nullptr) {
+        wallet_destroy(defaultWallet);
+        defaultWallet = nullptr;
+    }
+    contact_destroy(pContact);
+    public_key_destroy(pPublicKey);
+    private_key_destroy(pPrivateKey);
+    comms_config_destroy(pCommsConfig);
+    transport_type_destroy(pTransport);
+    if (removeDatastore) {
+        nftw(datastore.c_str(), [](const char *path, const struct stat *, int, struct FTW *) {
+            return remove(path);
+        }, 16, FTW_DEPTH | FTW_PHYS);
+    }
+}
+
+static void waitUntil(int64_t replayStart, int64_t recordedTime, double speed) {
+    if (speed <= 0) {
+        return;
+    }
+    auto target = replayStart + static_cast<int64_t>(recordedTime / speed);
+    int64_t now = ffiTraceClockNanos();
+    if (target > now) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(target - now));
+    }
+}
+
+static void replayThread(ReplayContext &context, const std::vector<size_t> &indices,
+                         int64_t replayStart, double speed) {
+    for (size_t index : indices) {
+        const FfiRecord &record = context.records[index];
+        waitUntil(replayStart, record.start, speed);
+        ReplayArgs args;
+        args.call = record.id;
+        args.record = &record;
+        args.context = &context;
+        args.pWallet = nullptr;
+        CallStats delta;
+        delta.count = 1;
+        delta.recordedNanos = record.duration;
+        delta.recordedMaxNanos = record.duration;
+        for (const FfiValue &value : record.values) {
+            if (value.tag == kFfiValueError && value.value != 0) {
+                delta.recordedErrors++;
+            }
+        }
+        int64_t recordedWallet = record.values.empty() ? 0 : record.values[0].value;
+        context.waitForPrerequisites(index);
+        if (record.id != kFfiCall_wallet_create) {
+            args.pWallet = context.wallet(index, recordedWallet);
+        }
+        int64_t nanos = -1;
+        if (record.id == kFfiCall_wallet_destroy && args.pWallet != nullptr) {
+            std::lock_guard<std::mutex> lock(context.walletLifetime);
+            nanos = kReplayFunctions[record.id](args);
+            context.onWalletDestroyed(recordedWallet, args.pWallet);
+        } else if (record.id == kFfiCall_wallet_create || args.pWallet != nullptr) {
+            nanos = kReplayFunctions[record.id](args);
+        }
+        if (nanos < 0) {
+            delta.skipped = 1;
+        } else {
+            delta.replayedNanos = nanos;
+            delta.replayedMaxNanos = nanos;
+            delta.replayedErrors = args.error != 0 ? 1 : 0;
+        }
+        context.addStats(record.id, delta);
+        context.onReplayed(index);
+    }
+}
+
+#if TARI_REPLAY_STUB
+
+/**
+ * Raises the recorded callbacks again through the stub, each with the next transaction of its
+ * kind.
+ */
+static void callbackThread(ReplayContext &context, const std::vector<size_t> &indices,
+                           int64_t replayStart, double speed, uint64_t &raised) {
+    unsigned int next[kFfiCallbackCount] = {};
+    for (size_t index : indices) {
+        const FfiRecord &record = context.records[index];
+        waitUntil(replayStart, record.start, speed);
+        {
+            std::lock_guard<std::mutex> lock(context.walletLifetime);
+            TariWallet *pWallet = context.anyWallet();
+            if (pWallet != nullptr &&
+                stubWalletEmitCallback(pWallet, static_cast<StubWalletCallback>(record.id),
+                                       next[record.id]++)) {
+                raised++;
+            }
+        }
+        context.onReplayed(index);
+    }
+}
+
+static_assert(static_cast<int>(kFfiCallbackCount) == static_cast<int>(kStubWalletCallbackCount),
+              "FfiCallback and StubWalletCallback must list the same callbacks");
+
+#endif
+
+static bool parseOptions(int argc, char **argv, Options &options) {
+    for (int n = 1; n < argc; n++) {
+        std::string arg = argv[n];
+        if (arg == "--dump") {
+            options.dump = true;
+            continue;
+        }
+        if (arg == "--no-callbacks") {
+            options.callbacks = false;
+            continue;
+        }
+        if (arg.compare(0, 2, "--") != 0) {
+            options.trace = arg;
+            continue;
+        }
+        if (n + 1 >= argc) {
+            fprintf(stderr, "Missing value of %s.\n", arg.c_str());
+            return false;
+        }
+        const char *value = argv[++n];
+        if (arg == "--speed") {
+            options.speed = std::max(0.0, atof(value));
+        } else if (arg == "--datastore") {
+            options.datastore = value;
+        } else if (arg == "--out") {
+            options.out = value;
+#if TARI_REPLAY_STUB
+        } else if (arg == "--completed") {
+            options.stub.completedTxCount = static_cast<unsigned int>(atol(value));
+        } else if (arg == "--latency-ns") {
+            options.stub.callLatencyNanos = atoll(value);
+#endif
+        } else {
+            fprintf(stderr, "Unknown option %s.\n", arg.c_str());
+            return false;
+        }
+    }
+    if (options.trace.empty()) {
+        fprintf(stderr, "Usage: ffi_replay TRACE [--speed FACTOR] [--datastore DIR] [--dump] "
+                        "[--no-callbacks] [--completed N] [--latency-ns N] [--out FILE]\n");
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 2;
+    }
+    std::vector<FfiRecord> records;
+    std::string error;
+    if (!FfiTraceReader().read(options.trace.c_str(), records, error)) {
+        fprintf(stderr, "Cannot read %s: %s.\n", options.trace.c_str(), error.c_str());
+        return 1;
+    }
+    if (options.dump) {
+        dumpRecords(records, stdout);
+        return 0;
+    }
+#if TARI_REPLAY_STUB
+    stubWalletConfigure(options.stub);
+#endif
+
+    // calls per recorded thread and callbacks, each in recorded order
+    std::map<uint64_t, std::vector<size_t>> callsByThread;
+    std::vector<size_t> callbacks;
+    uint64_t recordedCallbacks[kFfiCallbackCount] = {};
+    int64_t recordedEnd = 0;
+    for (size_t n = 0; n < records.size(); n++) {
+        if (records[n].kind == kFfiRecordCall) {
+            callsByThread[records[n].thread].push_back(n);
+        } else {
+            callbacks.push_back(n);
+            recordedCallbacks[records[n].id]++;
+        }
+        recordedEnd = std::max(recordedEnd, records[n].start + records[n].duration);
+    }
+    auto byStart = [&](size_t left, size_t right) {
+        return records[left].start < records[right].start;
+    };
+    for (auto &thread : callsByThread) {
+        std::stable_sort(thread.second.begin(), thread.second.end(), byStart);
+    }
+    std::stable_sort(callbacks.begin(), callbacks.end(), byStart);
+
+    ReplayContext context(records);
+    if (!context.setUp(options)) {
+        context.tearDown();
+        return 1;
+    }
+    int64_t replayStart = ffiTraceClockNanos();
+    std::vector<std::thread> threads;
+    for (const auto &thread : callsByThread) {
+        threads.emplace_back(replayThread, std::ref(context), std::cref(thread.second), replayStart,
+                             options.speed);
+    }
+    uint64_t callbacksRaised = 0;
+    bool raiseCallbacks = false;
+#if TARI_REPLAY_STUB
+    raiseCallbacks = options.callbacks;
+    if (raiseCallbacks) {
+        threads.emplace_back(callbackThread, std::ref(context), std::cref(callbacks), replayStart,
+                             options.speed, std::ref(callbacksRaised));
+    }
+#endif
+    if (!raiseCallbacks) {
+        // nothing raises them, wallet_destroy must not wait for them
+        for (size_t index : callbacks) {
+            context.onReplayed(index);
+        }
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    int64_t replayNanos = ffiTraceClockNanos() - replayStart;
+    uint64_t delivered[kFfiCallbackCount];
+    for (int callback = 0; callback < kFfiCallbackCount; callback++) {
+        delivered[callback] = g_callbacksDelivered[callback].load();
+    }
+    context.tearDown();
+
+    FILE *out = stdout;
+    if (!options.out.empty()) {
+        out = fopen(options.out.c_str(), "w");
+        if (out == nullptr) {
+            fprintf(stderr, "Cannot write %s.\n", options.out.c_str());
+            return 1;
+        }
+    }
+    uint64_t calls = 0, skipped = 0;
+    for (const CallStats &stats : context.stats) {
+        calls += stats.count;
+        skipped += stats.skipped;
+    }
+    fprintf(out, "{\n  \"schema\": \"%s\",\n", kJsonSchema);
+#if TARI_REPLAY_STUB
+    fprintf(out, "  \"library\": \"stub\",\n");
+#else
+    fprintf(out, "  \"library\": \"libtari_wallet_ffi\",\n");
+#endif
+    fprintf(out, "  \"trace\": {\"records\": %zu, \"calls\": %llu, \"callbacks\": %zu, "
+                 "\"threads\": %zu, \"durationNanos\": %lld},\n",
+            records.size(), static_cast<unsigned long long>(calls), callbacks.size(),
+            callsByThread.size(), static_cast<long long>(recordedEnd));
+    fprintf(out, "  \"replay\": {\"speed\": %g, \"elapsedNanos\": %lld, \"skippedCalls\": %llu, "
+                 "\"callbacksRaised\": %llu},\n",
+            options.speed, static_cast<long long>(replayNanos),
+            static_cast<unsigned long long>(skipped),
+            static_cast<unsigned long long>(callbacksRaised));
+    fprintf(out, "  \"calls\": {");
+    bool first = true;
+    for (int call = 0; call < kFfiCallCount; call++) {
+        const CallStats &stats = context.stats[call];
+        if (stats.count == 0) {
+            continue;
+        }
+        fprintf(out, "%s\n    \"%s\": {\"count\": %llu, \"skipped\": %llu, "
+                     "\"recordedErrors\": %llu, \"replayedErrors\": %llu, "
+                     "\"recordedNanos\": %lld, \"recordedMaxNanos\": %lld, "
+                     "\"replayedNanos\": %lld, \"replayedMaxNanos\": %lld}",
+                first ? "" : ",", kFfiCallNames[call], static_cast<unsigned long long>(stats.count),
+                static_cast<unsigned long long>(stats.skipped),
+                static_cast<unsigned long long>(stats.recordedErrors),
+                static_cast<unsigned long long>(stats.replayedErrors),
+                static_cast<long long>(stats.recordedNanos),
+                static_cast<long long>(stats.recordedMaxNanos),
+                static_cast<long long>(stats.replayedNanos),
+                static_cast<long long>(stats.replayedMaxNanos));
+        first = false;
+    }
+    fprintf(out, "\n  },\n  \"callbacks\": {");
+    for (int callback = 0; callback < kFfiCallbackCount; callback++) {
+        fprintf(out, "%s\n    \"%s\": {\"recorded\": %llu, \"delivered\": %llu}",
+                callback == 0 ? "" : ",", kFfiCallbackNames[callback],
+                static_cast<unsigned long long>(recordedCallbacks[callback]),
+                static_cast<unsigned long long>(delivered[callback]));
+    }
+    fprintf(out, "\n  }\n}\n");
+    if (out != stdout) {
+        fclose(out);
+    }
+    return 0;
+}
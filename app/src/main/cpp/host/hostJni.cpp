@@ -0,0 +1,801 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "hostJni.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+// region Threads and references
+
+/**
+ * Per-thread JNIEnv. Only one HostJvm exists at a time, the function tables reach it through
+ * g_hostJvm.
+ */
+struct HostJniEnv {
+    JNIEnv env;
+    std::vector<HostObject *> locals;
+    bool exceptionPending;
+};
+
+static HostJvm *g_hostJvm = nullptr;
+static thread_local HostJniEnv *t_env = nullptr;
+
+typedef std::remove_const<std::remove_pointer<decltype(JNIEnv::functions)>::type>::type JniFunctionTable;
+typedef std::remove_const<std::remove_pointer<decltype(JavaVM::functions)>::type>::type JniInvokeTable;
+
+static JniFunctionTable g_functions;
+static JniInvokeTable g_invokeFunctions;
+
+static HostJniEnv *envOf(JNIEnv *jEnv) {
+    if (t_env == nullptr || &t_env->env != jEnv) {
+        fprintf(stderr, "JNIEnv used on a thread it does not belong to.\n");
+        abort();
+    }
+    return t_env;
+}
+
+static HostJniEnv *attachThread() {
+    if (t_env == nullptr) {
+        t_env = new HostJniEnv();
+        t_env->env.functions = &g_functions;
+        t_env->exceptionPending = false;
+    }
+    return t_env;
+}
+
+static void freeLocals(HostJniEnv *env) {
+    for (HostObject *object : env->locals) {
+        delete object;
+    }
+    env->locals.clear();
+}
+
+HostObject *HostJvm::allocate(HostObjectKind kind, HostClass *cls, bool isLocal) {
+    auto *object = new HostObject();
+    object->kind = kind;
+    object->cls = cls;
+    object->isLocal = isLocal;
+    object->pointer = 0;
+    object->code = 0;
+    object->elementSize = 0;
+    object->length = 0;
+    if (isLocal) {
+        attachThread()->locals.push_back(object);
+    } else {
+        std::lock_guard<std::mutex> lock(mutex);
+        heap.push_back(object);
+    }
+    return object;
+}
+
+/**
+ * Moves a local reference to the heap, for NewGlobalRef.
+ */
+void HostJvm::pin(HostObject *object) {
+    if (object == nullptr || !object->isLocal) {
+        return;
+    }
+    std::vector<HostObject *> &locals = attachThread()->locals;
+    for (auto it = locals.rbegin(); it != locals.rend(); ++it) {
+        if (*it == object) {
+            locals.erase(std::next(it).base());
+            break;
+        }
+    }
+    object->isLocal = false;
+    std::lock_guard<std::mutex> lock(mutex);
+    heap.push_back(object);
+}
+
+void HostJvm::deleteLocal(HostObject *object) {
+    if (object == nullptr || !object->isLocal) {
+        return;
+    }
+    std::vector<HostObject *> &locals = attachThread()->locals;
+    // references are mostly deleted in reverse order of creation
+    for (auto it = locals.rbegin(); it != locals.rend(); ++it) {
+        if (*it == object) {
+            locals.erase(std::next(it).base());
+            delete object;
+            return;
+        }
+    }
+}
+
+void HostJvm::releaseLocalRefs() {
+    freeLocals(attachThread());
+}
+
+size_t HostJvm::localRefCount() {
+    return attachThread()->locals.size();
+}
+
+// endregion
+
+// region Strings
+
+/**
+ * Encodes UTF-16 the way ART's GetStringUTFChars does: modified UTF-8 (NUL as two bytes) except
+ * that a surrogate pair becomes one 4-byte sequence.
+ */
+static std::string encodeModifiedUtf8(const jchar *chars, size_t length) {
+    std::string out;
+    out.reserve(length);
+    for (size_t i = 0; i < length; i++) {
+        uint32_t c = chars[i];
+        if (c >= 0xD800 && c < 0xDC00 && i + 1 < length && chars[i + 1] >= 0xDC00 && chars[i + 1] < 0xE000) {
+            c = 0x10000 + ((c - 0xD800) << 10) + (chars[i + 1] - 0xDC00);
+            i++;
+            out += static_cast<char>(0xF0 | (c >> 18));
+            out += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        } else if (c != 0 && c < 0x80) {
+            out += static_cast<char>(c);
+        } else if (c < 0x800) {
+            out += static_cast<char>(0xC0 | (c >> 6));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        } else {
+            out += static_cast<char>(0xE0 | (c >> 12));
+            out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        }
+    }
+    return out;
+}
+
+static std::vector<jchar> decodeUtf8(const char *utf8) {
+    std::vector<jchar> chars;
+    auto *p = reinterpret_cast<const unsigned char *>(utf8);
+    while (*p != 0) {
+        uint32_t c = *p;
+        int extra = c < 0x80 ? 0 : c < 0xE0 ? 1 : c < 0xF0 ? 2 : 3;
+        c &= extra == 0 ? 0x7F : extra == 1 ? 0x1F : extra == 2 ? 0x0F : 0x07;
+        p++;
+        for (int n = 0; n < extra && (*p & 0xC0) == 0x80; n++, p++) {
+            c = (c << 6) | (*p & 0x3F);
+        }
+        if (c >= 0x10000) {
+            c -= 0x10000;
+            chars.push_back(static_cast<jchar>(0xD800 + (c >> 10)));
+            chars.push_back(static_cast<jchar>(0xDC00 + (c & 0x3FF)));
+        } else {
+            chars.push_back(static_cast<jchar>(c));
+        }
+    }
+    return chars;
+}
+
+std::string HostJvm::toUtf8(jobject string) {
+    HostObject *object = unwrap(string);
+    return object == nullptr ? std::string() : encodeModifiedUtf8(object->chars.data(), object->chars.size());
+}
+
+// endregion
+
+// region Function table
+
+static HostObject *newLocal(HostObjectKind kind, const char *className) {
+    return g_hostJvm->allocate(kind, className == nullptr ? nullptr : g_hostJvm->findClass(className), true);
+}
+
+static void throwPending(JNIEnv *jEnv, const char *what) {
+    fprintf(stderr, "Host JNI: %s\n", what);
+    envOf(jEnv)->exceptionPending = true;
+}
+
+static jint getVersion(JNIEnv *) {
+    return JNI_VERSION_1_6;
+}
+
+static jclass findClass(JNIEnv *, const char *name) {
+    return reinterpret_cast<jclass>(HostJvm::wrap(g_hostJvm->findClass(name)));
+}
+
+static jint throwNew(JNIEnv *jEnv, jclass, const char *message) {
+    throwPending(jEnv, message);
+    return JNI_OK;
+}
+
+static jthrowable exceptionOccurred(JNIEnv *jEnv) {
+    return envOf(jEnv)->exceptionPending ? reinterpret_cast<jthrowable>(findClass(jEnv, "java/lang/Throwable"))
+                                         : nullptr;
+}
+
+static void exceptionDescribe(JNIEnv *jEnv) {
+    if (envOf(jEnv)->exceptionPending) {
+        fprintf(stderr, "Host JNI: exception pending\n");
+    }
+}
+
+static void exceptionClear(JNIEnv *jEnv) {
+    envOf(jEnv)->exceptionPending = false;
+}
+
+static jboolean exceptionCheck(JNIEnv *jEnv) {
+    return static_cast<jboolean>(envOf(jEnv)->exceptionPending);
+}
+
+static void fatalError(JNIEnv *, const char *message) {
+    fprintf(stderr, "Host JNI fatal error: %s\n", message);
+    abort();
+}
+
+static jint pushLocalFrame(JNIEnv *, jint) {
+    return JNI_OK;
+}
+
+static jobject popLocalFrame(JNIEnv *, jobject result) {
+    return result;
+}
+
+static jint ensureLocalCapacity(JNIEnv *, jint) {
+    return JNI_OK;
+}
+
+static jobject newGlobalRef(JNIEnv *, jobject object) {
+    g_hostJvm->pin(HostJvm::unwrap(object));
+    return object;
+}
+
+static void deleteGlobalRef(JNIEnv *, jobject) {
+    // global references stay on the heap until the HostJvm is destroyed
+}
+
+static void deleteLocalRef(JNIEnv *, jobject object) {
+    g_hostJvm->deleteLocal(HostJvm::unwrap(object));
+}
+
+static jboolean isSameObject(JNIEnv *, jobject first, jobject second) {
+    return static_cast<jboolean>(first == second);
+}
+
+static jobject newLocalRef(JNIEnv *, jobject object) {
+    // references are the objects themselves, a new local reference is the same object
+    return object;
+}
+
+static jclass getObjectClass(JNIEnv *, jobject object) {
+    return reinterpret_cast<jclass>(HostJvm::wrap(HostJvm::unwrap(object)->cls));
+}
+
+static jboolean isInstanceOf(JNIEnv *, jobject object, jclass clazz) {
+    if (object == nullptr) {
+        return JNI_TRUE;
+    }
+    auto *target = static_cast<HostClass *>(HostJvm::unwrap(clazz));
+    for (HostClass *cls = HostJvm::unwrap(object)->cls; cls != nullptr; cls = cls->superclass) {
+        if (cls == target) {
+            return JNI_TRUE;
+        }
+    }
+    return JNI_FALSE;
+}
+
+static jmethodID getMethodId(JNIEnv *, jclass clazz, const char *name, const char *signature) {
+    for (auto *cls = static_cast<HostClass *>(HostJvm::unwrap(clazz)); cls != nullptr; cls = cls->superclass) {
+        auto it = cls->methods.find(name);
+        if (it != cls->methods.end() && it->second.signature == signature) {
+            return reinterpret_cast<jmethodID>(&it->second);
+        }
+    }
+    return nullptr;
+}
+
+static void callVoidMethodV(JNIEnv *jEnv, jobject object, jmethodID methodId, va_list args) {
+    auto *method = reinterpret_cast<HostMethod *>(methodId);
+    method->method(jEnv, object, args, method->data);
+}
+
+static void callVoidMethod(JNIEnv *jEnv, jobject object, jmethodID methodId, ...) {
+    va_list args;
+    va_start(args, methodId);
+    callVoidMethodV(jEnv, object, methodId, args);
+    va_end(args);
+}
+
+/**
+ * Field IDs name the two fields HostObject holds.
+ */
+static char g_pointerField;
+static char g_codeField;
+
+static jfieldID getFieldId(JNIEnv *, jclass, const char *name, const char *signature) {
+    if (strcmp(name, "pointer") == 0 && strcmp(signature, "J") == 0) {
+        return reinterpret_cast<jfieldID>(&g_pointerField);
+    }
+    if (strcmp(name, "code") == 0 && strcmp(signature, "I") == 0) {
+        return reinterpret_cast<jfieldID>(&g_codeField);
+    }
+    return nullptr;
+}
+
+static jlong getLongField(JNIEnv *, jobject object, jfieldID) {
+    return HostJvm::unwrap(object)->pointer;
+}
+
+static void setLongField(JNIEnv *, jobject object, jfieldID, jlong value) {
+    HostJvm::unwrap(object)->pointer = value;
+}
+
+static jint getIntField(JNIEnv *, jobject object, jfieldID) {
+    return HostJvm::unwrap(object)->code;
+}
+
+static void setIntField(JNIEnv *, jobject object, jfieldID, jint value) {
+    HostJvm::unwrap(object)->code = value;
+}
+
+static jstring newString(JNIEnv *, const jchar *chars, jsize length) {
+    HostObject *string = newLocal(kHostString, "java/lang/String");
+    string->chars.assign(chars, chars + length);
+    return reinterpret_cast<jstring>(HostJvm::wrap(string));
+}
+
+static jsize getStringLength(JNIEnv *, jstring string) {
+    return static_cast<jsize>(HostJvm::unwrap(string)->chars.size());
+}
+
+static bool checkRegion(JNIEnv *jEnv, size_t size, jsize start, jsize length) {
+    if (start < 0 || length < 0 || static_cast<size_t>(start) + static_cast<size_t>(length) > size) {
+        throwPending(jEnv, "StringIndexOutOfBoundsException / ArrayIndexOutOfBoundsException");
+        return false;
+    }
+    return true;
+}
+
+static void getStringRegion(JNIEnv *jEnv, jstring string, jsize start, jsize length, jchar *buf) {
+    HostObject *object = HostJvm::unwrap(string);
+    if (checkRegion(jEnv, object->chars.size(), start, length) && length > 0) {
+        memcpy(buf, object->chars.data() + start, length * sizeof(jchar));
+    }
+}
+
+static jstring newStringUtf(JNIEnv *jEnv, const char *utf8) {
+    if (utf8 == nullptr) {
+        return nullptr;
+    }
+    std::vector<jchar> chars = decodeUtf8(utf8);
+    return newString(jEnv, chars.data(), static_cast<jsize>(chars.size()));
+}
+
+static jsize getStringUtfLength(JNIEnv *, jstring string) {
+    return static_cast<jsize>(HostJvm::toUtf8(string).size());
+}
+
+static const char *getStringUtfChars(JNIEnv *, jstring string, jboolean *isCopy) {
+    std::string utf8 = HostJvm::toUtf8(string);
+    auto *result = static_cast<char *>(malloc(utf8.size() + 1));
+    memcpy(result, utf8.c_str(), utf8.size() + 1);
+    if (isCopy != nullptr) {
+        *isCopy = JNI_TRUE;
+    }
+    return result;
+}
+
+static void releaseStringUtfChars(JNIEnv *, jstring, const char *chars) {
+    free(const_cast<char *>(chars));
+}
+
+/**
+ * Like ART, does not write a terminating NUL.
+ */
+static void getStringUtfRegion(JNIEnv *jEnv, jstring string, jsize start, jsize length, char *buf) {
+    HostObject *object = HostJvm::unwrap(string);
+    if (checkRegion(jEnv, object->chars.size(), start, length)) {
+        std::string utf8 = encodeModifiedUtf8(object->chars.data() + start, static_cast<size_t>(length));
+        memcpy(buf, utf8.data(), utf8.size());
+    }
+}
+
+static jsize getArrayLength(JNIEnv *, jarray array) {
+    return HostJvm::unwrap(array)->length;
+}
+
+static jobjectArray newObjectArray(JNIEnv *, jsize length, jclass, jobject initialElement) {
+    HostObject *array = newLocal(kHostObjectArray, "[Ljava/lang/Object;");
+    array->length = length;
+    array->elements.assign(static_cast<size_t>(length), HostJvm::unwrap(initialElement));
+    return reinterpret_cast<jobjectArray>(HostJvm::wrap(array));
+}
+
+static jobject getObjectArrayElement(JNIEnv *jEnv, jobjectArray array, jsize index) {
+    HostObject *object = HostJvm::unwrap(array);
+    return checkRegion(jEnv, object->elements.size(), index, 1) ? HostJvm::wrap(object->elements[index]) : nullptr;
+}
+
+static void setObjectArrayElement(JNIEnv *jEnv, jobjectArray array, jsize index, jobject value) {
+    HostObject *object = HostJvm::unwrap(array);
+    if (checkRegion(jEnv, object->elements.size(), index, 1)) {
+        // the array keeps the element alive, as the Java heap would
+        g_hostJvm->pin(HostJvm::unwrap(value));
+        object->elements[index] = HostJvm::unwrap(value);
+    }
+}
+
+static HostObject *newPrimitiveArray(const char *className, size_t elementSize, jsize length, bool isLocal) {
+    HostObject *array = g_hostJvm->allocate(kHostPrimitiveArray, g_hostJvm->findClass(className), isLocal);
+    array->elementSize = elementSize;
+    array->length = length;
+    array->data.assign(static_cast<size_t>(length) * elementSize, 0);
+    return array;
+}
+
+template<typename Array, typename Element>
+static Array newArray(JNIEnv *, jsize length) {
+    const char *className = sizeof(Element) == 1 ? "[B" : sizeof(Element) == 4 ? "[I" : "[J";
+    return reinterpret_cast<Array>(HostJvm::wrap(newPrimitiveArray(className, sizeof(Element), length, true)));
+}
+
+template<typename Array, typename Element>
+static void getArrayRegion(JNIEnv *jEnv, Array array, jsize start, jsize length, Element *buf) {
+    HostObject *object = HostJvm::unwrap(array);
+    if (checkRegion(jEnv, static_cast<size_t>(object->length), start, length) && length > 0) {
+        memcpy(buf, object->data.data() + start * sizeof(Element), length * sizeof(Element));
+    }
+}
+
+template<typename Array, typename Element>
+static void setArrayRegion(JNIEnv *jEnv, Array array, jsize start, jsize length, const Element *buf) {
+    HostObject *object = HostJvm::unwrap(array);
+    if (checkRegion(jEnv, static_cast<size_t>(object->length), start, length) && length > 0) {
+        memcpy(object->data.data() + start * sizeof(Element), buf, length * sizeof(Element));
+    }
+}
+
+static void *getPrimitiveArrayCritical(JNIEnv *, jarray array, jboolean *isCopy) {
+    if (isCopy != nullptr) {
+        *isCopy = JNI_FALSE;
+    }
+    return HostJvm::unwrap(array)->data.data();
+}
+
+static void releasePrimitiveArrayCritical(JNIEnv *, jarray, void *, jint) {
+}
+
+static jint registerNatives(JNIEnv *, jclass clazz, const JNINativeMethod *methods, jint count) {
+    auto *cls = static_cast<HostClass *>(HostJvm::unwrap(clazz));
+    for (jint i = 0; i < count; i++) {
+        cls->natives[methods[i].name] = HostNativeMethod{methods[i].signature, methods[i].fnPtr, false};
+    }
+    return JNI_OK;
+}
+
+static jint unregisterNatives(JNIEnv *, jclass clazz) {
+    static_cast<HostClass *>(HostJvm::unwrap(clazz))->natives.clear();
+    return JNI_OK;
+}
+
+static jint getJavaVm(JNIEnv *, JavaVM **vm) {
+    *vm = g_hostJvm->getJavaVm();
+    return JNI_OK;
+}
+
+static jobject newDirectByteBuffer(JNIEnv *, void *address, jlong capacity) {
+    // the host VM only hands out buffers it allocated itself, see HostJvm::newDirectByteBuffer
+    fprintf(stderr, "Host JNI: NewDirectByteBuffer(%p, %lld) is not supported\n", address,
+            static_cast<long long>(capacity));
+    abort();
+}
+
+static void *getDirectBufferAddress(JNIEnv *, jobject buffer) {
+    HostObject *object = HostJvm::unwrap(buffer);
+    return object == nullptr || object->kind != kHostDirectBuffer ? nullptr : object->data.data();
+}
+
+static jlong getDirectBufferCapacity(JNIEnv *, jobject buffer) {
+    HostObject *object = HostJvm::unwrap(buffer);
+    return object == nullptr || object->kind != kHostDirectBuffer ? -1 : static_cast<jlong>(object->data.size());
+}
+
+static jobjectRefType getObjectRefType(JNIEnv *, jobject object) {
+    return HostJvm::unwrap(object)->isLocal ? JNILocalRefType : JNIGlobalRefType;
+}
+
+template<int Index>
+static void unimplementedJniFunction() {
+    fprintf(stderr, "JNI function %d is not implemented by the host VM.\n", Index);
+    abort();
+}
+
+/**
+ * Points every slot of a function table at an abort reporting the slot index, which is the
+ * function's index in the JNI specification.
+ */
+template<int Index>
+struct UnimplementedSlots {
+    static void fill(void **slots) {
+        slots[Index] = reinterpret_cast<void *>(&unimplementedJniFunction<Index>);
+        UnimplementedSlots<Index - 1>::fill(slots);
+    }
+};
+
+template<>
+struct UnimplementedSlots<-1> {
+    static void fill(void **) {}
+};
+
+static void initFunctionTable() {
+    JniFunctionTable &t = g_functions;
+    const int kSlotCount = sizeof(JniFunctionTable) / sizeof(void *);
+    UnimplementedSlots<kSlotCount - 1>::fill(reinterpret_cast<void **>(&t));
+    t.reserved0 = nullptr;
+    t.reserved1 = nullptr;
+    t.reserved2 = nullptr;
+    t.reserved3 = nullptr;
+    t.GetVersion = getVersion;
+    t.FindClass = findClass;
+    t.ThrowNew = throwNew;
+    t.ExceptionOccurred = exceptionOccurred;
+    t.ExceptionDescribe = exceptionDescribe;
+    t.ExceptionClear = exceptionClear;
+    t.ExceptionCheck = exceptionCheck;
+    t.FatalError = fatalError;
+    t.PushLocalFrame = pushLocalFrame;
+    t.PopLocalFrame = popLocalFrame;
+    t.EnsureLocalCapacity = ensureLocalCapacity;
+    t.NewGlobalRef = newGlobalRef;
+    t.DeleteGlobalRef = deleteGlobalRef;
+    t.DeleteLocalRef = deleteLocalRef;
+    t.IsSameObject = isSameObject;
+    t.NewLocalRef = newLocalRef;
+    t.GetObjectClass = getObjectClass;
+    t.IsInstanceOf = isInstanceOf;
+    t.GetMethodID = getMethodId;
+    t.CallVoidMethod = callVoidMethod;
+    t.CallVoidMethodV = callVoidMethodV;
+    t.GetFieldID = getFieldId;
+    t.GetLongField = getLongField;
+    t.SetLongField = setLongField;
+    t.GetIntField = getIntField;
+    t.SetIntField = setIntField;
+    t.NewString = newString;
+    t.GetStringLength = getStringLength;
+    t.GetStringRegion = getStringRegion;
+    t.NewStringUTF = newStringUtf;
+    t.GetStringUTFLength = getStringUtfLength;
+    t.GetStringUTFChars = getStringUtfChars;
+    t.ReleaseStringUTFChars = releaseStringUtfChars;
+    t.GetStringUTFRegion = getStringUtfRegion;
+    t.GetArrayLength = getArrayLength;
+    t.NewObjectArray = newObjectArray;
+    t.GetObjectArrayElement = getObjectArrayElement;
+    t.SetObjectArrayElement = setObjectArrayElement;
+    t.NewByteArray = newArray<jbyteArray, jbyte>;
+    t.NewIntArray = newArray<jintArray, jint>;
+    t.NewLongArray = newArray<jlongArray, jlong>;
+    t.GetByteArrayRegion = getArrayRegion<jbyteArray, jbyte>;
+    t.GetIntArrayRegion = getArrayRegion<jintArray, jint>;
+    t.GetLongArrayRegion = getArrayRegion<jlongArray, jlong>;
+    t.SetByteArrayRegion = setArrayRegion<jbyteArray, jbyte>;
+    t.SetIntArrayRegion = setArrayRegion<jintArray, jint>;
+    t.SetLongArrayRegion = setArrayRegion<jlongArray, jlong>;
+    t.GetPrimitiveArrayCritical = getPrimitiveArrayCritical;
+    t.ReleasePrimitiveArrayCritical = releasePrimitiveArrayCritical;
+    t.RegisterNatives = registerNatives;
+    t.UnregisterNatives = unregisterNatives;
+    t.GetJavaVM = getJavaVm;
+    t.NewDirectByteBuffer = newDirectByteBuffer;
+    t.GetDirectBufferAddress = getDirectBufferAddress;
+    t.GetDirectBufferCapacity = getDirectBufferCapacity;
+    t.GetObjectRefType = getObjectRefType;
+}
+
+// endregion
+
+// region Invocation interface
+
+static jint destroyJavaVm(JavaVM *) {
+    return JNI_ERR;
+}
+
+/**
+ * The out parameter is JNIEnv ** in the NDK's jni.h and void ** in the JDK's, the template
+ * takes whichever the function table declares.
+ */
+template<typename Env>
+static jint attachCurrentThread(JavaVM *, Env **penv, void *) {
+    *penv = reinterpret_cast<Env *>(&attachThread()->env);
+    return JNI_OK;
+}
+
+static jint detachCurrentThread(JavaVM *) {
+    if (t_env != nullptr) {
+        freeLocals(t_env);
+        delete t_env;
+        t_env = nullptr;
+    }
+    return JNI_OK;
+}
+
+static jint getEnv(JavaVM *, void **penv, jint version) {
+    if (version > JNI_VERSION_1_6) {
+        return JNI_EVERSION;
+    }
+    if (t_env == nullptr) {
+        *penv = nullptr;
+        return JNI_EDETACHED;
+    }
+    *penv = &t_env->env;
+    return JNI_OK;
+}
+
+static void initInvokeTable() {
+    JniInvokeTable &t = g_invokeFunctions;
+    const int kSlotCount = sizeof(JniInvokeTable) / sizeof(void *);
+    UnimplementedSlots<kSlotCount - 1>::fill(reinterpret_cast<void **>(&t));
+    t.reserved0 = nullptr;
+    t.reserved1 = nullptr;
+    t.reserved2 = nullptr;
+    t.DestroyJavaVM = destroyJavaVm;
+    t.AttachCurrentThread = attachCurrentThread;
+    t.DetachCurrentThread = detachCurrentThread;
+    t.GetEnv = getEnv;
+    t.AttachCurrentThreadAsDaemon = attachCurrentThread;
+}
+
+// endregion
+
+// region HostJvm
+
+HostJvm::HostJvm() {
+    if (g_hostJvm != nullptr) {
+        fprintf(stderr, "Only one HostJvm may exist at a time.\n");
+        abort();
+    }
+    g_hostJvm = this;
+    initFunctionTable();
+    initInvokeTable();
+    vm.functions = &g_invokeFunctions;
+}
+
+HostJvm::~HostJvm() {
+    detachCurrentThread(&vm);
+    for (HostObject *object : heap) {
+        delete object;
+    }
+    for (auto &entry : classes) {
+        delete entry.second;
+    }
+    g_hostJvm = nullptr;
+}
+
+JNIEnv *HostJvm::attachCurrentThread() {
+    return &attachThread()->env;
+}
+
+static HostClass *newClass(const std::string &name, HostClass *superclass) {
+    auto *cls = new HostClass();
+    cls->kind = kHostClassObject;
+    cls->cls = nullptr;
+    cls->isLocal = false;
+    cls->pointer = 0;
+    cls->code = 0;
+    cls->elementSize = 0;
+    cls->length = 0;
+    cls->name = name;
+    cls->superclass = superclass;
+    return cls;
+}
+
+HostClass *HostJvm::findClass(const char *name) {
+    static const std::string kFfiPackage = "com/tari/android/wallet/ffi/";
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = classes.find(name);
+    if (it != classes.end()) {
+        return it->second;
+    }
+    std::string className(name);
+    HostClass *superclass = nullptr;
+    if (className.compare(0, kFfiPackage.size(), kFfiPackage) == 0
+        && className != kFfiPackage + "FFIBase" && className != kFfiPackage + "FFIError") {
+        std::string baseName = kFfiPackage + "FFIBase";
+        auto base = classes.find(baseName);
+        if (base == classes.end()) {
+            base = classes.emplace(baseName, newClass(baseName, nullptr)).first;
+        }
+        superclass = base->second;
+    }
+    HostClass *cls = newClass(className, superclass);
+    classes[className] = cls;
+    return cls;
+}
+
+void HostJvm::defineVoidMethod(const char *className, const char *name, const char *signature,
+                               HostVoidMethod method, void *data) {
+    HostClass *cls = findClass(className);
+    cls->methods[name] = HostMethod{name, signature, method, data};
+}
+
+void *HostJvm::findNative(const char *className, const char *name) {
+    HostClass *cls = findClass((std::string("com/tari/android/wallet/ffi/") + className).c_str());
+    auto it = cls->natives.find(name);
+    if (it == cls->natives.end()) {
+        fprintf(stderr, "%s.%s is not a registered native method.\n", className, name);
+        abort();
+    }
+    it->second.used = true;
+    return it->second.fnPtr;
+}
+
+std::map<std::string, std::pair<int, int>> HostJvm::nativeCoverage() {
+    std::map<std::string, std::pair<int, int>> coverage;
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto &entry : classes) {
+        HostClass *cls = entry.second;
+        if (cls->natives.empty()) {
+            continue;
+        }
+        std::pair<int, int> &counts = coverage[cls->name.substr(cls->name.rfind('/') + 1)];
+        for (auto &native : cls->natives) {
+            counts.first++;
+            counts.second += native.second.used ? 1 : 0;
+        }
+    }
+    return coverage;
+}
+
+jobject HostJvm::newObject(const char *className) {
+    std::string name = strchr(className, '/') == nullptr
+                       ? std::string("com/tari/android/wallet/ffi/") + className
+                       : std::string(className);
+    return wrap(allocate(kHostInstance, findClass(name.c_str()), false));
+}
+
+jstring HostJvm::newString(const std::string &utf8) {
+    HostObject *string = allocate(kHostString, findClass("java/lang/String"), false);
+    string->chars = decodeUtf8(utf8.c_str());
+    return reinterpret_cast<jstring>(wrap(string));
+}
+
+jbyteArray HostJvm::newByteArray(jsize length) {
+    return reinterpret_cast<jbyteArray>(wrap(newPrimitiveArray("[B", sizeof(jbyte), length, false)));
+}
+
+jintArray HostJvm::newIntArray(jsize length) {
+    return reinterpret_cast<jintArray>(wrap(newPrimitiveArray("[I", sizeof(jint), length, false)));
+}
+
+jlongArray HostJvm::newLongArray(jsize length) {
+    return reinterpret_cast<jlongArray>(wrap(newPrimitiveArray("[J", sizeof(jlong), length, false)));
+}
+
+jobject HostJvm::newDirectByteBuffer(jlong capacity) {
+    HostObject *buffer = allocate(kHostDirectBuffer, findClass("java/nio/DirectByteBuffer"), false);
+    buffer->data.assign(static_cast<size_t>(capacity), 0);
+    return wrap(buffer);
+}
+
+// endregion
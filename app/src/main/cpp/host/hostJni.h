@@ -0,0 +1,192 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HOST_JNI_H
+#define HOST_JNI_H
+
+#include <jni.h>
+#include <cstdarg>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * A minimal in-process Java VM for the host build: JavaVM and JNIEnv function tables backed by
+ * plain C++ objects, enough to load native-lib (JNI_OnLoad, RegisterNatives) and to call its
+ * entry points without a JVM. Only the JNI functions the native sources use are implemented,
+ * the others abort with their function table index.
+ *
+ * Objects created by the harness (newObject, newString, ...) live as long as the HostJvm.
+ * Objects returned by JNI functions are local references of the calling thread, released by
+ * DeleteLocalRef or in bulk by releaseLocalRefs(), the equivalent of returning to Java.
+ */
+
+class HostClass;
+
+enum HostObjectKind {
+    kHostInstance = 0,
+    kHostClassObject,
+    kHostString,
+    kHostPrimitiveArray,
+    kHostObjectArray,
+    kHostDirectBuffer
+};
+
+struct HostObject {
+    HostObjectKind kind;
+    HostClass *cls;
+    // local reference of the thread that created it, freed with the thread's local references
+    bool isLocal;
+    // FFIBase.pointer and FFIError.code, the only fields the native sources access
+    jlong pointer;
+    jint code;
+    // kHostString
+    std::vector<jchar> chars;
+    // kHostPrimitiveArray elements and kHostDirectBuffer storage
+    std::vector<unsigned char> data;
+    size_t elementSize;
+    jsize length;
+    // kHostObjectArray
+    std::vector<HostObject *> elements;
+};
+
+/**
+ * Java method implemented by the harness, receiving the arguments of the Call*Method call.
+ */
+typedef void (*HostVoidMethod)(JNIEnv *jEnv, jobject jThis, va_list args, void *data);
+
+struct HostMethod {
+    std::string name;
+    std::string signature;
+    HostVoidMethod method;
+    void *data;
+};
+
+struct HostNativeMethod {
+    std::string signature;
+    void *fnPtr;
+    bool used;
+};
+
+class HostClass : public HostObject {
+public:
+    std::string name;
+    HostClass *superclass;
+    std::map<std::string, HostMethod> methods;
+    // natives bound by RegisterNatives, keyed by method name
+    std::map<std::string, HostNativeMethod> natives;
+};
+
+class HostJvm {
+public:
+    HostJvm();
+
+    ~HostJvm();
+
+    JavaVM *getJavaVm() { return &vm; }
+
+    /**
+     * Attaches the calling thread if needed and returns its JNIEnv.
+     */
+    JNIEnv *attachCurrentThread();
+
+    /**
+     * Class of the given binary name, created on first use. Classes of the ffi package other
+     * than FFIBase and FFIError extend FFIBase, like their Kotlin counterparts.
+     */
+    HostClass *findClass(const char *name);
+
+    void defineVoidMethod(const char *className, const char *name, const char *signature,
+                          HostVoidMethod method, void *data);
+
+    /**
+     * Registered native of a class, cast to its C prototype. Aborts if the class did not
+     * register the method.
+     */
+    template<typename Function>
+    Function nativeMethod(const char *className, const char *name) {
+        return reinterpret_cast<Function>(findNative(className, name));
+    }
+
+    /**
+     * Number of registered natives and the number of those looked up through nativeMethod, per
+     * class name.
+     */
+    std::map<std::string, std::pair<int, int>> nativeCoverage();
+
+    jobject newObject(const char *className);
+
+    jstring newString(const std::string &utf8);
+
+    jbyteArray newByteArray(jsize length);
+
+    jintArray newIntArray(jsize length);
+
+    jlongArray newLongArray(jsize length);
+
+    jobject newDirectByteBuffer(jlong capacity);
+
+    static HostObject *unwrap(jobject object) { return reinterpret_cast<HostObject *>(object); }
+
+    static jobject wrap(HostObject *object) { return reinterpret_cast<jobject>(object); }
+
+    static std::string toUtf8(jobject string);
+
+    /**
+     * Frees the local references of the calling thread.
+     */
+    void releaseLocalRefs();
+
+    /**
+     * Local references currently held by the calling thread.
+     */
+    size_t localRefCount();
+
+    // implementation details shared with the function tables in hostJni.cpp
+    HostObject *allocate(HostObjectKind kind, HostClass *cls, bool isLocal);
+
+    void pin(HostObject *object);
+
+    void deleteLocal(HostObject *object);
+
+private:
+    void *findNative(const char *className, const char *name);
+
+    JavaVM vm;
+    std::mutex mutex;
+    std::map<std::string, HostClass *> classes;
+    std::vector<HostObject *> heap;
+};
+
+#endif // HOST_JNI_H
@@ -0,0 +1,467 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Host build stand-in for the wallet.h of libtari_wallet_ffi 0.19.0, declaring the subset of
+ * the library API the JNI sources call. The definitions live in ../stubWallet.cpp.
+ *
+ * Keep the declarations in step with the wallet.h downloaded by download-libwallet.gradle when
+ * the library version changes: a prototype that drifts only shows up as a compile error here.
+ */
+
+#ifndef wallet_ffi_h
+#define wallet_ffi_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdbool.h>
+
+struct ByteVector;
+struct TariCommsConfig;
+struct TariPrivateKey;
+struct TariWallet;
+struct TariPublicKey;
+struct TariContacts;
+struct TariContact;
+struct TariCompletedTransactions;
+struct TariCompletedTransaction;
+struct TariPendingOutboundTransactions;
+struct TariPendingOutboundTransaction;
+struct TariPendingInboundTransactions;
+struct TariPendingInboundTransaction;
+struct TariTransportType;
+struct TariSeedWords;
+struct EmojiSet;
+struct TariTransactionKernel;
+
+typedef struct ByteVector ByteVector;
+typedef struct TariCommsConfig TariCommsConfig;
+typedef struct TariPrivateKey TariPrivateKey;
+typedef struct TariWallet TariWallet;
+typedef struct TariPublicKey TariPublicKey;
+typedef struct TariContacts TariContacts;
+typedef struct TariContact TariContact;
+typedef struct TariCompletedTransactions TariCompletedTransactions;
+typedef struct TariCompletedTransaction TariCompletedTransaction;
+typedef struct TariPendingOutboundTransactions TariPendingOutboundTransactions;
+typedef struct TariPendingOutboundTransaction TariPendingOutboundTransaction;
+typedef struct TariPendingInboundTransactions TariPendingInboundTransactions;
+typedef struct TariPendingInboundTransaction TariPendingInboundTransaction;
+typedef struct TariTransportType TariTransportType;
+typedef struct TariSeedWords TariSeedWords;
+typedef struct EmojiSet EmojiSet;
+typedef struct TariTransactionKernel TariTransactionKernel;
+
+// region Transport, strings, kernels
+
+void file_partial_backup(const char *original_file_path, const char *backup_file_path, int *error_out);
+
+struct TariTransportType *transport_memory_create();
+
+struct TariTransportType *transport_tcp_create(const char *listener_address, int *error_out);
+
+struct TariTransportType *transport_tor_create(const char *control_server_address,
+                                               struct ByteVector *tor_cookie,
+                                               unsigned short tor_port,
+                                               const char *socks_username,
+                                               const char *socks_password,
+                                               int *error_out);
+
+char *transport_memory_get_address(struct TariTransportType *transport, int *error_out);
+
+void transport_type_destroy(struct TariTransportType *transport);
+
+void string_destroy(char *s);
+
+char *transaction_kernel_get_excess_hex(struct TariTransactionKernel *kernel, int *error_out);
+
+char *transaction_kernel_get_excess_public_nonce_hex(struct TariTransactionKernel *kernel, int *error_out);
+
+char *transaction_kernel_get_excess_signature_hex(struct TariTransactionKernel *kernel, int *error_out);
+
+void transaction_kernel_destroy(struct TariTransactionKernel *x);
+
+// endregion
+
+// region Byte vectors, keys, emoji, seed words
+
+struct ByteVector *byte_vector_create(const unsigned char *byte_array, unsigned int element_count, int *error_out);
+
+unsigned char byte_vector_get_at(struct ByteVector *ptr, unsigned int i, int *error_out);
+
+unsigned int byte_vector_get_length(const struct ByteVector *vec, int *error_out);
+
+void byte_vector_destroy(struct ByteVector *bytes);
+
+struct TariPublicKey *public_key_create(struct ByteVector *bytes, int *error_out);
+
+struct ByteVector *public_key_get_bytes(struct TariPublicKey *pk, int *error_out);
+
+struct TariPublicKey *public_key_from_private_key(struct TariPrivateKey *secret_key, int *error_out);
+
+struct TariPublicKey *public_key_from_hex(const char *hex, int *error_out);
+
+void public_key_destroy(struct TariPublicKey *pk);
+
+char *public_key_to_emoji_id(struct TariPublicKey *pk, int *error_out);
+
+struct TariPublicKey *emoji_id_to_public_key(const char *emoji, int *error_out);
+
+struct EmojiSet *get_emoji_set();
+
+unsigned int emoji_set_get_length(struct EmojiSet *emoji_set, int *error_out);
+
+struct ByteVector *emoji_set_get_at(struct EmojiSet *emoji_set, unsigned int position, int *error_out);
+
+void emoji_set_destroy(struct EmojiSet *emoji_set);
+
+struct TariPrivateKey *private_key_create(struct ByteVector *bytes, int *error_out);
+
+struct TariPrivateKey *private_key_generate();
+
+struct ByteVector *private_key_get_bytes(struct TariPrivateKey *sk, int *error_out);
+
+struct TariPrivateKey *private_key_from_hex(const char *hex, int *error_out);
+
+void private_key_destroy(struct TariPrivateKey *sk);
+
+struct TariSeedWords *seed_words_create();
+
+unsigned int seed_words_get_length(struct TariSeedWords *seed_words, int *error_out);
+
+char *seed_words_get_at(struct TariSeedWords *seed_words, unsigned int position, int *error_out);
+
+unsigned char seed_words_push_word(struct TariSeedWords *seed_words, const char *word, int *error_out);
+
+void seed_words_destroy(struct TariSeedWords *seed_words);
+
+// endregion
+
+// region Contacts
+
+struct TariContact *contact_create(const char *alias, struct TariPublicKey *public_key, int *error_out);
+
+char *contact_get_alias(struct TariContact *contact, int *error_out);
+
+struct TariPublicKey *contact_get_public_key(struct TariContact *contact, int *error_out);
+
+void contact_destroy(struct TariContact *contact);
+
+unsigned int contacts_get_length(struct TariContacts *contacts, int *error_out);
+
+struct TariContact *contacts_get_at(struct TariContacts *contacts, unsigned int position, int *error_out);
+
+void contacts_destroy(struct TariContacts *contacts);
+
+// endregion
+
+// region Transaction collections
+
+unsigned int completed_transactions_get_length(struct TariCompletedTransactions *transactions, int *error_out);
+
+struct TariCompletedTransaction *completed_transactions_get_at(struct TariCompletedTransactions *transactions,
+                                                               unsigned int position,
+                                                               int *error_out);
+
+void completed_transactions_destroy(struct TariCompletedTransactions *transactions);
+
+unsigned int pending_outbound_transactions_get_length(struct TariPendingOutboundTransactions *transactions,
+                                                      int *error_out);
+
+struct TariPendingOutboundTransaction *pending_outbound_transactions_get_at(
+        struct TariPendingOutboundTransactions *transactions,
+        unsigned int position,
+        int *error_out);
+
+void pending_outbound_transactions_destroy(struct TariPendingOutboundTransactions *transactions);
+
+unsigned int pending_inbound_transactions_get_length(struct TariPendingInboundTransactions *transactions,
+                                                     int *error_out);
+
+struct TariPendingInboundTransaction *pending_inbound_transactions_get_at(
+        struct TariPendingInboundTransactions *transactions,
+        unsigned int position,
+        int *error_out);
+
+void pending_inbound_transactions_destroy(struct TariPendingInboundTransactions *transactions);
+
+// endregion
+
+// region Transactions
+
+unsigned long long completed_transaction_get_transaction_id(struct TariCompletedTransaction *transaction,
+                                                            int *error_out);
+
+struct TariPublicKey *completed_transaction_get_destination_public_key(struct TariCompletedTransaction *transaction,
+                                                                       int *error_out);
+
+struct TariTransactionKernel *completed_transaction_get_transaction_kernel(
+        struct TariCompletedTransaction *transaction,
+        int *error_out);
+
+struct TariPublicKey *completed_transaction_get_source_public_key(struct TariCompletedTransaction *transaction,
+                                                                  int *error_out);
+
+int completed_transaction_get_status(struct TariCompletedTransaction *transaction, int *error_out);
+
+unsigned long long completed_transaction_get_amount(struct TariCompletedTransaction *transaction, int *error_out);
+
+unsigned long long completed_transaction_get_fee(struct TariCompletedTransaction *transaction, int *error_out);
+
+unsigned long long completed_transaction_get_timestamp(struct TariCompletedTransaction *transaction, int *error_out);
+
+const char *completed_transaction_get_message(struct TariCompletedTransaction *transaction, int *error_out);
+
+bool completed_transaction_is_outbound(struct TariCompletedTransaction *tx, int *error_out);
+
+unsigned long long completed_transaction_get_confirmations(struct TariCompletedTransaction *tx, int *error_out);
+
+void completed_transaction_destroy(struct TariCompletedTransaction *transaction);
+
+unsigned long long pending_outbound_transaction_get_transaction_id(struct TariPendingOutboundTransaction *transaction,
+                                                                   int *error_out);
+
+struct TariPublicKey *pending_outbound_transaction_get_destination_public_key(
+        struct TariPendingOutboundTransaction *transaction,
+        int *error_out);
+
+unsigned long long pending_outbound_transaction_get_amount(struct TariPendingOutboundTransaction *transaction,
+                                                           int *error_out);
+
+unsigned long long pending_outbound_transaction_get_fee(struct TariPendingOutboundTransaction *transaction,
+                                                        int *error_out);
+
+unsigned long long pending_outbound_transaction_get_timestamp(struct TariPendingOutboundTransaction *transaction,
+                                                              int *error_out);
+
+const char *pending_outbound_transaction_get_message(struct TariPendingOutboundTransaction *transaction,
+                                                     int *error_out);
+
+int pending_outbound_transaction_get_status(struct TariPendingOutboundTransaction *transaction, int *error_out);
+
+void pending_outbound_transaction_destroy(struct TariPendingOutboundTransaction *transaction);
+
+unsigned long long pending_inbound_transaction_get_transaction_id(struct TariPendingInboundTransaction *transaction,
+                                                                  int *error_out);
+
+struct TariPublicKey *pending_inbound_transaction_get_source_public_key(
+        struct TariPendingInboundTransaction *transaction,
+        int *error_out);
+
+unsigned long long pending_inbound_transaction_get_amount(struct TariPendingInboundTransaction *transaction,
+                                                          int *error_out);
+
+unsigned long long pending_inbound_transaction_get_timestamp(struct TariPendingInboundTransaction *transaction,
+                                                             int *error_out);
+
+const char *pending_inbound_transaction_get_message(struct TariPendingInboundTransaction *transaction,
+                                                    int *error_out);
+
+int pending_inbound_transaction_get_status(struct TariPendingInboundTransaction *transaction, int *error_out);
+
+void pending_inbound_transaction_destroy(struct TariPendingInboundTransaction *transaction);
+
+// endregion
+
+// region Wallet
+
+struct TariCommsConfig *comms_config_create(const char *public_address,
+                                            struct TariTransportType *transport,
+                                            const char *database_name,
+                                            const char *datastore_path,
+                                            unsigned long long discovery_timeout_in_secs,
+                                            unsigned long long saf_message_duration_in_secs,
+                                            const char *network,
+                                            int *error_out);
+
+void comms_config_destroy(struct TariCommsConfig *wc);
+
+struct TariWallet *wallet_create(struct TariCommsConfig *config,
+                                 const char *log_path,
+                                 unsigned int num_rolling_log_files,
+                                 unsigned int size_per_log_file_bytes,
+                                 const char *passphrase,
+                                 struct TariSeedWords *seed_words,
+                                 void (*callback_received_transaction)(struct TariPendingInboundTransaction *),
+                                 void (*callback_received_transaction_reply)(struct TariCompletedTransaction *),
+                                 void (*callback_received_finalized_transaction)(struct TariCompletedTransaction *),
+                                 void (*callback_transaction_broadcast)(struct TariCompletedTransaction *),
+                                 void (*callback_transaction_mined)(struct TariCompletedTransaction *),
+                                 void (*callback_transaction_mined_unconfirmed)(struct TariCompletedTransaction *,
+                                                                                unsigned long long),
+                                 void (*callback_direct_send_result)(unsigned long long, bool),
+                                 void (*callback_store_and_forward_send_result)(unsigned long long, bool),
+                                 void (*callback_transaction_cancellation)(struct TariCompletedTransaction *),
+                                 void (*callback_txo_validation_complete)(unsigned long long, unsigned char),
+                                 void (*callback_transaction_validation_complete)(unsigned long long, unsigned char),
+                                 void (*callback_saf_message_received)(),
+                                 bool *recovery_in_progress,
+                                 int *error_out);
+
+char *wallet_sign_message(struct TariWallet *wallet, const char *msg, int *error_out);
+
+bool wallet_verify_message_signature(struct TariWallet *wallet,
+                                     struct TariPublicKey *public_key,
+                                     const char *hex_sig_nonce,
+                                     const char *msg,
+                                     int *error_out);
+
+bool wallet_test_generate_data(struct TariWallet *wallet, const char *datastore_path, int *error_out);
+
+bool wallet_add_base_node_peer(struct TariWallet *wallet,
+                               struct TariPublicKey *public_key,
+                               const char *address,
+                               int *error_out);
+
+bool wallet_upsert_contact(struct TariWallet *wallet, struct TariContact *contact, int *error_out);
+
+bool wallet_remove_contact(struct TariWallet *wallet, struct TariContact *contact, int *error_out);
+
+unsigned long long wallet_get_available_balance(struct TariWallet *wallet, int *error_out);
+
+unsigned long long wallet_get_pending_incoming_balance(struct TariWallet *wallet, int *error_out);
+
+unsigned long long wallet_get_pending_outgoing_balance(struct TariWallet *wallet, int *error_out);
+
+unsigned long long wallet_send_transaction(struct TariWallet *wallet,
+                                           struct TariPublicKey *destination,
+                                           unsigned long long amount,
+                                           unsigned long long fee_per_gram,
+                                           const char *message,
+                                           int *error_out);
+
+unsigned long long wallet_get_fee_estimate(struct TariWallet *wallet,
+                                           unsigned long long amount,
+                                           unsigned long long fee_per_gram,
+                                           unsigned long long num_kernels,
+                                           unsigned long long num_outputs,
+                                           int *error_out);
+
+unsigned long long wallet_get_num_confirmations_required(struct TariWallet *wallet, int *error_out);
+
+void wallet_set_num_confirmations_required(struct TariWallet *wallet, unsigned long long num, int *error_out);
+
+struct TariContacts *wallet_get_contacts(struct TariWallet *wallet, int *error_out);
+
+struct TariCompletedTransactions *wallet_get_completed_transactions(struct TariWallet *wallet, int *error_out);
+
+struct TariPendingOutboundTransactions *wallet_get_pending_outbound_transactions(struct TariWallet *wallet,
+                                                                                 int *error_out);
+
+struct TariPendingInboundTransactions *wallet_get_pending_inbound_transactions(struct TariWallet *wallet,
+                                                                               int *error_out);
+
+struct TariCompletedTransactions *wallet_get_cancelled_transactions(struct TariWallet *wallet, int *error_out);
+
+struct TariCompletedTransaction *wallet_get_completed_transaction_by_id(struct TariWallet *wallet,
+                                                                        unsigned long long transaction_id,
+                                                                        int *error_out);
+
+struct TariPendingOutboundTransaction *wallet_get_pending_outbound_transaction_by_id(
+        struct TariWallet *wallet,
+        unsigned long long transaction_id,
+        int *error_out);
+
+struct TariPendingInboundTransaction *wallet_get_pending_inbound_transaction_by_id(
+        struct TariWallet *wallet,
+        unsigned long long transaction_id,
+        int *error_out);
+
+struct TariCompletedTransaction *wallet_get_cancelled_transaction_by_id(struct TariWallet *wallet,
+                                                                        unsigned long long transaction_id,
+                                                                        int *error_out);
+
+struct TariPublicKey *wallet_get_public_key(struct TariWallet *wallet, int *error_out);
+
+unsigned long long wallet_import_utxo(struct TariWallet *wallet,
+                                      unsigned long long amount,
+                                      struct TariPrivateKey *spending_key,
+                                      struct TariPublicKey *source_public_key,
+                                      const char *message,
+                                      int *error_out);
+
+unsigned long long wallet_start_txo_validation(struct TariWallet *wallet, int *error_out);
+
+unsigned long long wallet_start_transaction_validation(struct TariWallet *wallet, int *error_out);
+
+unsigned long long wallet_restart_transaction_broadcast(struct TariWallet *wallet, int *error_out);
+
+void wallet_set_low_power_mode(struct TariWallet *wallet, int *error_out);
+
+void wallet_set_normal_power_mode(struct TariWallet *wallet, int *error_out);
+
+bool wallet_cancel_pending_transaction(struct TariWallet *wallet,
+                                       unsigned long long transaction_id,
+                                       int *error_out);
+
+unsigned long long wallet_coin_split(struct TariWallet *wallet,
+                                     unsigned long long amount,
+                                     unsigned long long count,
+                                     unsigned long long fee,
+                                     const char *msg,
+                                     unsigned long long lock_height,
+                                     int *error_out);
+
+struct TariSeedWords *wallet_get_seed_words(struct TariWallet *wallet, int *error_out);
+
+void wallet_apply_encryption(struct TariWallet *wallet, const char *passphrase, int *error_out);
+
+void wallet_remove_encryption(struct TariWallet *wallet, int *error_out);
+
+bool wallet_set_key_value(struct TariWallet *wallet, const char *key, const char *value, int *error_out);
+
+const char *wallet_get_value(struct TariWallet *wallet, const char *key, int *error_out);
+
+bool wallet_clear_value(struct TariWallet *wallet, const char *key, int *error_out);
+
+bool wallet_is_recovery_in_progress(struct TariWallet *wallet, int *error_out);
+
+bool wallet_start_recovery(struct TariWallet *wallet,
+                           struct TariPublicKey *base_node_public_key,
+                           void (*recovery_progress_callback)(unsigned char, unsigned long long, unsigned long long),
+                           int *error_out);
+
+void wallet_destroy(struct TariWallet *wallet);
+
+void log_debug_message(const char *msg);
+
+// endregion
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* wallet_ffi_h */
@@ -0,0 +1,1022 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "hostJni.h"
+#include "stubWallet.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../jniEmojiTable.cpp"
+#include "../jniWalletEvents.cpp"
+
+/**
+ * Microbenchmarks of the JNI layer, run on a Linux host.
+ *
+ * The jni*.cpp sources are linked against the stub wallet library (stubWallet.cpp) and driven
+ * through the fake JNIEnv of hostJni.cpp, registered by the library's own JNI_OnLoad. Every
+ * case calls the registered natives the way the Kotlin wrappers do, so the numbers cover the
+ * JNI glue plus the configured stub latency and nothing of a real VM or wallet.
+ *
+ * Results are written as JSON: per case the minimum, median, mean and 90th percentile of the
+ * per-operation time over all samples, plus the native method coverage per class.
+ *
+ * Usage: jni_benchmarks [--samples N] [--iterations N] [--latency-ns N]
+ *                       [--element-latency-ns N] [--completed N] [--contacts N]
+ *                       [--message-length N] [--emoji] [--filter TEXT] [--out FILE]
+ */
+
+typedef void (*VoidMethod)(JNIEnv *, jobject);
+typedef void (*ErrorMethod)(JNIEnv *, jobject, jobject);
+typedef jint (*IntMethod)(JNIEnv *, jobject);
+typedef jlong (*LongGetter)(JNIEnv *, jobject, jobject);
+typedef jint (*IntGetter)(JNIEnv *, jobject, jobject);
+typedef jboolean (*BooleanGetter)(JNIEnv *, jobject, jobject);
+typedef jstring (*StringGetter)(JNIEnv *, jobject, jobject);
+typedef jlong (*LongAtGetter)(JNIEnv *, jobject, jint, jobject);
+typedef jint (*IntAtGetter)(JNIEnv *, jobject, jint, jobject);
+typedef jstring (*StringAtGetter)(JNIEnv *, jobject, jint, jobject);
+typedef jint (*SnapshotWriter)(JNIEnv *, jobject, jobject, jobject);
+typedef void (*StringCreator)(JNIEnv *, jobject, jstring, jobject);
+typedef jlongArray (*LongArrayMethod)(JNIEnv *, jobject);
+
+static const char *const kJsonSchema = "tari-jni-benchmarks/1";
+static const int kCallbackBurst = 256;
+static const long long kCallbackTimeoutNanos = 10000000000LL;
+
+struct Options {
+    int samples = 10;
+    long iterations = 1000;
+    std::string filter;
+    std::string out;
+    StubWalletConfig stub = stubWalletDefaultConfig();
+};
+
+struct BenchmarkResult {
+    std::string category;
+    std::string name;
+    // operations per sample and elements touched per operation
+    long iterations;
+    unsigned int elements;
+    // per-operation time of each sample, sorted
+    std::vector<double> nanosPerOp;
+};
+
+/**
+ * Receives FFIWallet.onEvents batches on the dispatcher thread and consumes them like
+ * FFIWallet does: transaction handles are read and destroyed through their wrappers.
+ */
+struct EventSink {
+    std::atomic<long long> delivered{0};
+    jobject completedTx = nullptr;
+    jobject pendingInboundTx = nullptr;
+    jobject error = nullptr;
+    LongGetter completedTxGetId = nullptr;
+    VoidMethod completedTxDestroy = nullptr;
+    LongGetter pendingInboundTxGetId = nullptr;
+    VoidMethod pendingInboundTxDestroy = nullptr;
+};
+
+static void onEvents(JNIEnv *jEnv, jobject, va_list args, void *data) {
+    auto *sink = static_cast<EventSink *>(data);
+    auto jBatch = va_arg(args, jlongArray);
+    jint count = va_arg(args, jint);
+    jlong batch[kWalletEventBatchSize * kWalletEventStride];
+    jEnv->GetLongArrayRegion(jBatch, 0, count * kWalletEventStride, batch);
+    for (jint n = 0; n < count; n++) {
+        const jlong *record = batch + n * kWalletEventStride;
+        switch (record[0]) {
+            case kEventTxReceived:
+                HostJvm::unwrap(sink->pendingInboundTx)->pointer = record[1];
+                sink->pendingInboundTxGetId(jEnv, sink->pendingInboundTx, sink->error);
+                sink->pendingInboundTxDestroy(jEnv, sink->pendingInboundTx);
+                break;
+            case kEventTxReplyReceived:
+            case kEventTxFinalized:
+            case kEventTxBroadcast:
+            case kEventTxMined:
+            case kEventTxMinedUnconfirmed:
+            case kEventTxCancelled:
+                HostJvm::unwrap(sink->completedTx)->pointer = record[1];
+                sink->completedTxGetId(jEnv, sink->completedTx, sink->error);
+                sink->completedTxDestroy(jEnv, sink->completedTx);
+                break;
+            default:
+                break;
+        }
+    }
+    sink->delivered.fetch_add(count);
+}
+
+class BenchmarkRunner {
+public:
+    BenchmarkRunner(HostJvm &jvm, const Options &options, jobject error)
+            : jvm(jvm), options(options), error(error) {}
+
+    /**
+     * Times options.iterations / elements calls of body (at least ten) per sample. Local
+     * references are freed between samples, outside the timed region.
+     */
+    template<typename Body>
+    void run(const char *category, const std::string &name, unsigned int elements, Body body) {
+        if (!selected(name)) {
+            return;
+        }
+        long iterations = std::max(10L, options.iterations / std::max(1U, elements));
+        for (long n = 0; n < std::min(iterations, 100L); n++) {
+            body(n);
+        }
+        jvm.releaseLocalRefs();
+        BenchmarkResult result{category, name, iterations, elements, {}};
+        for (int sample = 0; sample < options.samples; sample++) {
+            long long start = nowNanos();
+            for (long n = 0; n < iterations; n++) {
+                body(n);
+            }
+            long long elapsed = nowNanos() - start;
+            result.nanosPerOp.push_back(static_cast<double>(elapsed) / iterations);
+            jvm.releaseLocalRefs();
+            checkError(name);
+        }
+        add(result);
+    }
+
+    void add(BenchmarkResult &result) {
+        std::sort(result.nanosPerOp.begin(), result.nanosPerOp.end());
+        fprintf(stderr, "%-12s %-48s %12.1f ns/op\n", result.category.c_str(),
+                result.name.c_str(), median(result.nanosPerOp));
+        results.push_back(result);
+    }
+
+    bool selected(const std::string &name) const {
+        return options.filter.empty() || name.find(options.filter) != std::string::npos;
+    }
+
+    void checkError(const std::string &name) {
+        jint code = HostJvm::unwrap(error)->code;
+        if (code != 0) {
+            fprintf(stderr, "%s failed with error %d\n", name.c_str(), code);
+            failed = true;
+            HostJvm::unwrap(error)->code = 0;
+        }
+    }
+
+    static double median(const std::vector<double> &sorted) {
+        size_t size = sorted.size();
+        if (size == 0) {
+            return 0;
+        }
+        return size % 2 == 1 ? sorted[size / 2] : (sorted[size / 2 - 1] + sorted[size / 2]) / 2;
+    }
+
+    HostJvm &jvm;
+    const Options &options;
+    jobject error;
+    std::vector<BenchmarkResult> results;
+    bool failed = false;
+};
+
+static bool parseOptions(int argc, char **argv, Options &options) {
+    for (int n = 1; n < argc; n++) {
+        std::string arg = argv[n];
+        if (arg == "--emoji") {
+            options.stub.emojiMessages = true;
+            continue;
+        }
+        if (n + 1 >= argc) {
+            fprintf(stderr, "Missing value of %s.\n", arg.c_str());
+            return false;
+        }
+        const char *value = argv[++n];
+        if (arg == "--samples") {
+            options.samples = std::max(1, atoi(value));
+        } else if (arg == "--iterations") {
+            options.iterations = std::max(1L, atol(value));
+        } else if (arg == "--latency-ns") {
+            options.stub.callLatencyNanos = atoll(value);
+        } else if (arg == "--element-latency-ns") {
+            options.stub.elementLatencyNanos = atoll(value);
+        } else if (arg == "--completed") {
+            options.stub.completedTxCount = static_cast<unsigned int>(atol(value));
+        } else if (arg == "--contacts") {
+            options.stub.contactCount = static_cast<unsigned int>(atol(value));
+        } else if (arg == "--message-length") {
+            options.stub.messageLength = static_cast<unsigned int>(atol(value));
+        } else if (arg == "--filter") {
+            options.filter = value;
+        } else if (arg == "--out") {
+            options.out = value;
+        } else {
+            fprintf(stderr, "Unknown option %s.\n", arg.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * New wrapper object of an ffi class holding the given handle.
+ */
+static jobject wrapHandle(HostJvm &jvm, const char *className, jlong pointer) {
+    jobject object = jvm.newObject(className);
+    HostJvm::unwrap(object)->pointer = pointer;
+    return object;
+}
+
+// region Cases
+
+static void runGetters(HostJvm &jvm, BenchmarkRunner &runner, JNIEnv *jEnv, jobject wallet,
+                       jobject error) {
+    const char *category = "getter";
+    auto walletLong = [&](const char *name) {
+        auto method = jvm.nativeMethod<LongGetter>("FFIWallet", name);
+        runner.run(category, std::string("FFIWallet.") + name, 1, [&](long) {
+            method(jEnv, wallet, error);
+        });
+    };
+    walletLong("jniGetAvailableBalance");
+    walletLong("jniGetPendingIncomingBalance");
+    walletLong("jniGetPendingOutgoingBalance");
+    walletLong("jniGetConfirmations");
+
+    // handle-returning getters, each result destroyed through its wrapper
+    auto walletHandle = [&](const char *name, const char *className) {
+        auto method = jvm.nativeMethod<LongGetter>("FFIWallet", name);
+        auto destroy = jvm.nativeMethod<VoidMethod>(className, "jniDestroy");
+        jobject target = jvm.newObject(className);
+        runner.run(category, std::string("FFIWallet.") + name, 1, [&](long) {
+            HostJvm::unwrap(target)->pointer = method(jEnv, wallet, error);
+            destroy(jEnv, target);
+        });
+    };
+    walletHandle("jniGetPublicKey", "FFIPublicKey");
+    walletHandle("jniGetSeedWords", "FFISeedWords");
+
+    auto getCompletedTxs = jvm.nativeMethod<LongGetter>("FFIWallet", "jniGetCompletedTxs");
+    auto completedTxsGetAt = jvm.nativeMethod<LongAtGetter>("FFICompletedTxs", "jniGetAt");
+    jobject completedTxs = wrapHandle(jvm, "FFICompletedTxs", getCompletedTxs(jEnv, wallet, error));
+    jobject completedTx = wrapHandle(jvm, "FFICompletedTx",
+                                     completedTxsGetAt(jEnv, completedTxs, 0, error));
+    auto txLong = [&](const char *className, jobject tx, const char *name) {
+        auto method = jvm.nativeMethod<LongGetter>(className, name);
+        runner.run(category, std::string(className) + "." + name, 1, [&](long) {
+            method(jEnv, tx, error);
+        });
+    };
+    auto txInt = [&](const char *className, jobject tx, const char *name) {
+        auto method = jvm.nativeMethod<IntGetter>(className, name);
+        runner.run(category, std::string(className) + "." + name, 1, [&](long) {
+            method(jEnv, tx, error);
+        });
+    };
+    auto txHandle = [&](const char *className, jobject tx, const char *name,
+                        const char *resultClassName) {
+        auto method = jvm.nativeMethod<LongGetter>(className, name);
+        auto destroy = jvm.nativeMethod<VoidMethod>(resultClassName, "jniDestroy");
+        jobject target = jvm.newObject(resultClassName);
+        runner.run(category, std::string(className) + "." + name, 1, [&](long) {
+            HostJvm::unwrap(target)->pointer = method(jEnv, tx, error);
+            destroy(jEnv, target);
+        });
+    };
+    txLong("FFICompletedTx", completedTx, "jniGetId");
+    txLong("FFICompletedTx", completedTx, "jniGetAmount");
+    txLong("FFICompletedTx", completedTx, "jniGetFee");
+    txLong("FFICompletedTx", completedTx, "jniGetTimestamp");
+    txLong("FFICompletedTx", completedTx, "jniGetConfirmationCount");
+    txInt("FFICompletedTx", completedTx, "jniGetStatus");
+    auto isOutbound = jvm.nativeMethod<BooleanGetter>("FFICompletedTx", "jniIsOutbound");
+    runner.run(category, "FFICompletedTx.jniIsOutbound", 1, [&](long) {
+        isOutbound(jEnv, completedTx, error);
+    });
+    txHandle("FFICompletedTx", completedTx, "jniGetSourcePublicKey", "FFIPublicKey");
+    txHandle("FFICompletedTx", completedTx, "jniGetDestinationPublicKey", "FFIPublicKey");
+    txHandle("FFICompletedTx", completedTx, "jniGetTransactionKernel", "FFICompletedTxKernel");
+
+    auto getInboundTxs = jvm.nativeMethod<LongGetter>("FFIWallet", "jniGetPendingInboundTxs");
+    auto inboundTxsGetAt = jvm.nativeMethod<LongAtGetter>("FFIPendingInboundTxs", "jniGetAt");
+    jobject inboundTxs = wrapHandle(jvm, "FFIPendingInboundTxs",
+                                    getInboundTxs(jEnv, wallet, error));
+    jobject inboundTx = wrapHandle(jvm, "FFIPendingInboundTx",
+                                   inboundTxsGetAt(jEnv, inboundTxs, 0, error));
+    txLong("FFIPendingInboundTx", inboundTx, "jniGetId");
+    txLong("FFIPendingInboundTx", inboundTx, "jniGetAmount");
+    txLong("FFIPendingInboundTx", inboundTx, "jniGetTimestamp");
+    txInt("FFIPendingInboundTx", inboundTx, "jniGetStatus");
+    txHandle("FFIPendingInboundTx", inboundTx, "jniGetSourcePublicKey", "FFIPublicKey");
+
+    auto getOutboundTxs = jvm.nativeMethod<LongGetter>("FFIWallet", "jniGetPendingOutboundTxs");
+    auto outboundTxsGetAt = jvm.nativeMethod<LongAtGetter>("FFIPendingOutboundTxs", "jniGetAt");
+    jobject outboundTxs = wrapHandle(jvm, "FFIPendingOutboundTxs",
+                                     getOutboundTxs(jEnv, wallet, error));
+    jobject outboundTx = wrapHandle(jvm, "FFIPendingOutboundTx",
+                                    outboundTxsGetAt(jEnv, outboundTxs, 0, error));
+    txLong("FFIPendingOutboundTx", outboundTx, "jniGetId");
+    txLong("FFIPendingOutboundTx", outboundTx, "jniGetAmount");
+    txLong("FFIPendingOutboundTx", outboundTx, "jniGetFee");
+    txLong("FFIPendingOutboundTx", outboundTx, "jniGetTimestamp");
+    txInt("FFIPendingOutboundTx", outboundTx, "jniGetStatus");
+    txHandle("FFIPendingOutboundTx", outboundTx, "jniGetDestinationPublicKey", "FFIPublicKey");
+
+    auto completedTxId = jvm.nativeMethod<LongGetter>("FFICompletedTx", "jniGetId")(
+            jEnv, completedTx, error);
+    auto getCompletedTxById = jvm.nativeMethod<jlong (*)(JNIEnv *, jobject, jlong, jobject)>(
+            "FFIWallet", "jniGetCompletedTxByIdU64");
+    auto completedTxDestroy = jvm.nativeMethod<VoidMethod>("FFICompletedTx", "jniDestroy");
+    jobject byIdTarget = jvm.newObject("FFICompletedTx");
+    runner.run(category, "FFIWallet.jniGetCompletedTxByIdU64", 1, [&](long) {
+        HostJvm::unwrap(byIdTarget)->pointer = getCompletedTxById(jEnv, wallet, completedTxId, error);
+        completedTxDestroy(jEnv, byIdTarget);
+    });
+
+    auto getSeedWords = jvm.nativeMethod<LongGetter>("FFIWallet", "jniGetSeedWords");
+    jobject seedWords = wrapHandle(jvm, "FFISeedWords", getSeedWords(jEnv, wallet, error));
+    txInt("FFISeedWords", seedWords, "jniGetLength");
+
+    auto getContacts = jvm.nativeMethod<LongGetter>("FFIWallet", "jniGetContacts");
+    jobject contacts = wrapHandle(jvm, "FFIContacts", getContacts(jEnv, wallet, error));
+    txInt("FFIContacts", contacts, "jniGetLength");
+
+    auto getPublicKey = jvm.nativeMethod<LongGetter>("FFIWallet", "jniGetPublicKey");
+    jobject publicKey = wrapHandle(jvm, "FFIPublicKey", getPublicKey(jEnv, wallet, error));
+    auto publicKeyGetBytes = jvm.nativeMethod<LongGetter>("FFIPublicKey", "jniGetBytes");
+    jobject bytes = wrapHandle(jvm, "FFIByteVector", publicKeyGetBytes(jEnv, publicKey, error));
+    txHandle("FFIPublicKey", publicKey, "jniGetBytes", "FFIByteVector");
+    txInt("FFIByteVector", bytes, "jniGetLength");
+    auto byteVectorGetAt = jvm.nativeMethod<IntAtGetter>("FFIByteVector", "jniGetAt");
+    runner.run(category, "FFIByteVector.jniGetAt", 1, [&](long n) {
+        byteVectorGetAt(jEnv, bytes, static_cast<jint>(n & 31), error);
+    });
+
+    auto getTxTable = jvm.nativeMethod<LongGetter>("FFIWallet", "jniGetTxTable");
+    jobject table = wrapHandle(jvm, "FFITxTable", getTxTable(jEnv, wallet, error));
+    auto rowCount = jvm.nativeMethod<IntMethod>("FFITxTable", "jniGetRowCount");
+    runner.run(category, "FFITxTable.jniGetRowCount", 1, [&](long) {
+        rowCount(jEnv, table);
+    });
+
+    auto loadStats = jvm.nativeMethod<LongArrayMethod>("FFIUtil", "jniGetLoadStats");
+    jobject util = jvm.newObject("FFIUtil");
+    runner.run(category, "FFIUtil.jniGetLoadStats", 1, [&](long) {
+        loadStats(jEnv, util);
+    });
+
+    jvm.nativeMethod<VoidMethod>("FFITxTable", "jniDestroy")(jEnv, table);
+    jvm.nativeMethod<VoidMethod>("FFIByteVector", "jniDestroy")(jEnv, bytes);
+    jvm.nativeMethod<VoidMethod>("FFIPublicKey", "jniDestroy")(jEnv, publicKey);
+    jvm.nativeMethod<VoidMethod>("FFIContacts", "jniDestroy")(jEnv, contacts);
+    jvm.nativeMethod<VoidMethod>("FFISeedWords", "jniDestroy")(jEnv, seedWords);
+    jvm.nativeMethod<VoidMethod>("FFIPendingOutboundTx", "jniDestroy")(jEnv, outboundTx);
+    jvm.nativeMethod<VoidMethod>("FFIPendingOutboundTxs", "jniDestroy")(jEnv, outboundTxs);
+    jvm.nativeMethod<VoidMethod>("FFIPendingInboundTx", "jniDestroy")(jEnv, inboundTx);
+    jvm.nativeMethod<VoidMethod>("FFIPendingInboundTxs", "jniDestroy")(jEnv, inboundTxs);
+    completedTxDestroy(jEnv, completedTx);
+    jvm.nativeMethod<VoidMethod>("FFICompletedTxs", "jniDestroy")(jEnv, completedTxs);
+}
+
+static void runStrings(HostJvm &jvm, BenchmarkRunner &runner, JNIEnv *jEnv, jobject wallet,
+                       jobject error) {
+    const char *category = "string";
+    auto stringGetter = [&](const char *className, jobject target, const char *name) {
+        auto method = jvm.nativeMethod<StringGetter>(className, name);
+        runner.run(category, std::string(className) + "." + name, 1, [&](long) {
+            method(jEnv, target, error);
+        });
+    };
+
+    auto getCompletedTxs = jvm.nativeMethod<LongGetter>("FFIWallet", "jniGetCompletedTxs");
+    auto completedTxsGetAt = jvm.nativeMethod<LongAtGetter>("FFICompletedTxs", "jniGetAt");
+    jobject completedTxs = wrapHandle(jvm, "FFICompletedTxs", getCompletedTxs(jEnv, wallet, error));
+    jobject completedTx = wrapHandle(jvm, "FFICompletedTx",
+                                     completedTxsGetAt(jEnv, completedTxs, 0, error));
+    stringGetter("FFICompletedTx", completedTx, "jniGetMessage");
+
+    auto getInboundTxs = jvm.nativeMethod<LongGetter>("FFIWallet", "jniGetPendingInboundTxs");
+    auto inboundTxsGetAt = jvm.nativeMethod<LongAtGetter>("FFIPendingInboundTxs", "jniGetAt");
+    jobject inboundTxs = wrapHandle(jvm, "FFIPendingInboundTxs",
+                                    getInboundTxs(jEnv, wallet, error));
+    jobject inboundTx = wrapHandle(jvm, "FFIPendingInboundTx",
+                                   inboundTxsGetAt(jEnv, inboundTxs, 0, error));
+    stringGetter("FFIPendingInboundTx", inboundTx, "jniGetMessage");
+
+    auto getOutboundTxs = jvm.nativeMethod<LongGetter>("FFIWallet", "jniGetPendingOutboundTxs");
+    auto outboundTxsGetAt = jvm.nativeMethod<LongAtGetter>("FFIPendingOutboundTxs", "jniGetAt");
+    jobject outboundTxs = wrapHandle(jvm, "FFIPendingOutboundTxs",
+                                     getOutboundTxs(jEnv, wallet, error));
+    jobject outboundTx = wrapHandle(jvm, "FFIPendingOutboundTx",
+                                    outboundTxsGetAt(jEnv, outboundTxs, 0, error));
+    stringGetter("FFIPendingOutboundTx", outboundTx, "jniGetMessage");
+
+    auto getKernel = jvm.nativeMethod<LongGetter>("FFICompletedTx", "jniGetTransactionKernel");
+    jobject kernel = wrapHandle(jvm, "FFICompletedTxKernel", getKernel(jEnv, completedTx, error));
+    stringGetter("FFICompletedTxKernel", kernel, "jniGetExcess");
+    stringGetter("FFICompletedTxKernel", kernel, "jniGetExcessPublicNonce");
+    stringGetter("FFICompletedTxKernel", kernel, "jniGetExcessSignature");
+    auto kernelGetBytes = jvm.nativeMethod<void (*)(JNIEnv *, jobject, jbyteArray, jobject)>(
+            "FFICompletedTxKernel", "jniGetBytes");
+    jbyteArray kernelBytes = jvm.newByteArray(96);
+    runner.run(category, "FFICompletedTxKernel.jniGetBytes", 1, [&](long) {
+        kernelGetBytes(jEnv, kernel, kernelBytes, error);
+    });
+
+    auto getContacts = jvm.nativeMethod<LongGetter>("FFIWallet", "jniGetContacts");
+    auto contactsGetAt = jvm.nativeMethod<LongAtGetter>("FFIContacts", "jniGetAt");
+    jobject contacts = wrapHandle(jvm, "FFIContacts", getContacts(jEnv, wallet, error));
+    jobject contact = wrapHandle(jvm, "FFIContact", contactsGetAt(jEnv, contacts, 0, error));
+    stringGetter("FFIContact", contact, "jniGetAlias");
+
+    auto getPublicKey = jvm.nativeMethod<LongGetter>("FFIWallet", "jniGetPublicKey");
+    jobject publicKey = wrapHandle(jvm, "FFIPublicKey", getPublicKey(jEnv, wallet, error));
+    stringGetter("FFIPublicKey", publicKey, "jniGetHex");
+    stringGetter("FFIPublicKey", publicKey, "jniGetEmojiId");
+
+    jobject privateKey = jvm.newObject("FFIPrivateKey");
+    jvm.nativeMethod<VoidMethod>("FFIPrivateKey", "jniGenerate")(jEnv, privateKey);
+    stringGetter("FFIPrivateKey", privateKey, "jniGetHex");
+
+    auto getSeedWords = jvm.nativeMethod<LongGetter>("FFIWallet", "jniGetSeedWords");
+    auto seedWordsGetAt = jvm.nativeMethod<StringAtGetter>("FFISeedWords", "jniGetAt");
+    jobject seedWords = wrapHandle(jvm, "FFISeedWords", getSeedWords(jEnv, wallet, error));
+    runner.run(category, "FFISeedWords.jniGetAt", 1, [&](long n) {
+        seedWordsGetAt(jEnv, seedWords, static_cast<jint>(n % 24), error);
+    });
+
+    auto setKeyValue = jvm.nativeMethod<jboolean (*)(JNIEnv *, jobject, jstring, jstring, jobject)>(
+            "FFIWallet", "jniSetKeyValue");
+    auto getKeyValue = jvm.nativeMethod<jstring (*)(JNIEnv *, jobject, jstring, jobject)>(
+            "FFIWallet", "jniGetKeyValue");
+    jstring key = jvm.newString("benchmark_key");
+    jstring value = jvm.newString(std::string(64, 'v'));
+    jvm.pin(HostJvm::unwrap(key));
+    jvm.pin(HostJvm::unwrap(value));
+    runner.run(category, "FFIWallet.jniSetKeyValue", 1, [&](long) {
+        setKeyValue(jEnv, wallet, key, value, error);
+    });
+    runner.run(category, "FFIWallet.jniGetKeyValue", 1, [&](long) {
+        getKeyValue(jEnv, wallet, key, error);
+    });
+
+    auto signMessage = jvm.nativeMethod<jstring (*)(JNIEnv *, jobject, jstring, jobject)>(
+            "FFIWallet", "jniSignMessage");
+    jstring message = jvm.newString("benchmark message to sign");
+    jvm.pin(HostJvm::unwrap(message));
+    runner.run(category, "FFIWallet.jniSignMessage", 1, [&](long) {
+        signMessage(jEnv, wallet, message, error);
+    });
+
+    jobject transport = jvm.newObject("FFITransportType");
+    jvm.nativeMethod<VoidMethod>("FFITransportType", "jniMemoryTransport")(jEnv, transport);
+    stringGetter("FFITransportType", transport, "jniGetMemoryAddress");
+
+    auto getTxTable = jvm.nativeMethod<LongGetter>("FFIWallet", "jniGetTxTable");
+    jobject table = wrapHandle(jvm, "FFITxTable", getTxTable(jEnv, wallet, error));
+    auto tableStrings = jvm.nativeMethod<jobjectArray (*)(JNIEnv *, jobject, jobject)>(
+            "FFITxTable", "jniGetStrings");
+    jint rows = jvm.nativeMethod<IntMethod>("FFITxTable", "jniGetRowCount")(jEnv, table);
+    runner.run(category, "FFITxTable.jniGetStrings", static_cast<unsigned int>(rows), [&](long) {
+        tableStrings(jEnv, table, error);
+    });
+
+    auto emojiAlphabet = jvm.nativeMethod<jobjectArray (*)(JNIEnv *, jobject)>(
+            "FFIUtil", "jniGetEmojiAlphabet");
+    jobject util = jvm.newObject("FFIUtil");
+    runner.run(category, "FFIUtil.jniGetEmojiAlphabet", kEmojiAlphabetSize, [&](long) {
+        emojiAlphabet(jEnv, util);
+    });
+
+    jvm.nativeMethod<VoidMethod>("FFITxTable", "jniDestroy")(jEnv, table);
+    jvm.nativeMethod<VoidMethod>("FFITransportType", "jniDestroy")(jEnv, transport);
+    jvm.nativeMethod<VoidMethod>("FFISeedWords", "jniDestroy")(jEnv, seedWords);
+    jvm.nativeMethod<VoidMethod>("FFIPrivateKey", "jniDestroy")(jEnv, privateKey);
+    jvm.nativeMethod<VoidMethod>("FFIPublicKey", "jniDestroy")(jEnv, publicKey);
+    jvm.nativeMethod<VoidMethod>("FFIContact", "jniDestroy")(jEnv, contact);
+    jvm.nativeMethod<VoidMethod>("FFIContacts", "jniDestroy")(jEnv, contacts);
+    jvm.nativeMethod<VoidMethod>("FFICompletedTxKernel", "jniDestroy")(jEnv, kernel);
+    jvm.nativeMethod<VoidMethod>("FFIPendingOutboundTx", "jniDestroy")(jEnv, outboundTx);
+    jvm.nativeMethod<VoidMethod>("FFIPendingOutboundTxs", "jniDestroy")(jEnv, outboundTxs);
+    jvm.nativeMethod<VoidMethod>("FFIPendingInboundTx", "jniDestroy")(jEnv, inboundTx);
+    jvm.nativeMethod<VoidMethod>("FFIPendingInboundTxs", "jniDestroy")(jEnv, inboundTxs);
+    jvm.nativeMethod<VoidMethod>("FFICompletedTx", "jniDestroy")(jEnv, completedTx);
+    jvm.nativeMethod<VoidMethod>("FFICompletedTxs", "jniDestroy")(jEnv, completedTxs);
+}
+
+/**
+ * Walks a transaction or contact collection the way the Kotlin wrappers do: one getAt per
+ * element, the element wrapped, read once (unless elementGetter is null) and destroyed.
+ */
+static void runCollectionWalk(HostJvm &jvm, BenchmarkRunner &runner, JNIEnv *jEnv,
+                              jobject wallet, jobject error, const char *getter,
+                              const char *collectionClass, const char *elementClass,
+                              const char *elementGetter) {
+    auto getCollection = jvm.nativeMethod<LongGetter>("FFIWallet", getter);
+    auto getLength = jvm.nativeMethod<IntGetter>(collectionClass, "jniGetLength");
+    auto getAt = jvm.nativeMethod<LongAtGetter>(collectionClass, "jniGetAt");
+    auto collectionDestroy = jvm.nativeMethod<VoidMethod>(collectionClass, "jniDestroy");
+    auto read = elementGetter == nullptr
+                ? nullptr : jvm.nativeMethod<LongGetter>(elementClass, elementGetter);
+    auto elementDestroy = jvm.nativeMethod<VoidMethod>(elementClass, "jniDestroy");
+    jobject collection = jvm.newObject(collectionClass);
+    jobject element = jvm.newObject(elementClass);
+
+    HostJvm::unwrap(collection)->pointer = getCollection(jEnv, wallet, error);
+    auto length = static_cast<unsigned int>(getLength(jEnv, collection, error));
+    collectionDestroy(jEnv, collection);
+
+    runner.run("collection", std::string("FFIWallet.") + getter + " walk", length, [&](long) {
+        HostJvm::unwrap(collection)->pointer = getCollection(jEnv, wallet, error);
+        jint size = getLength(jEnv, collection, error);
+        for (jint index = 0; index < size; index++) {
+            HostJvm::unwrap(element)->pointer = getAt(jEnv, collection, index, error);
+            if (read != nullptr) {
+                read(jEnv, element, error);
+            }
+            elementDestroy(jEnv, element);
+        }
+        collectionDestroy(jEnv, collection);
+    });
+}
+
+static void runSnapshot(HostJvm &jvm, BenchmarkRunner &runner, JNIEnv *jEnv, jobject wallet,
+                        jobject error, const char *getter, const char *collectionClass) {
+    auto getCollection = jvm.nativeMethod<LongGetter>("FFIWallet", getter);
+    auto getLength = jvm.nativeMethod<IntGetter>(collectionClass, "jniGetLength");
+    auto writeSnapshot = jvm.nativeMethod<SnapshotWriter>(collectionClass, "jniWriteSnapshot");
+    auto collectionDestroy = jvm.nativeMethod<VoidMethod>(collectionClass, "jniDestroy");
+    jobject collection = wrapHandle(jvm, collectionClass, getCollection(jEnv, wallet, error));
+    auto length = static_cast<unsigned int>(getLength(jEnv, collection, error));
+    // grow the buffer the way TxSnapshot.take does until the snapshot fits
+    jlong capacity = 16;
+    jobject buffer = jvm.newDirectByteBuffer(capacity);
+    for (jint required; (required = writeSnapshot(jEnv, collection, buffer, error)) > capacity;) {
+        capacity = required;
+        buffer = jvm.newDirectByteBuffer(capacity);
+    }
+    runner.run("collection", std::string(collectionClass) + ".jniWriteSnapshot", length, [&](long) {
+        writeSnapshot(jEnv, collection, buffer, error);
+    });
+    collectionDestroy(jEnv, collection);
+}
+
+static void runCollections(HostJvm &jvm, BenchmarkRunner &runner, JNIEnv *jEnv, jobject wallet,
+                           jobject error) {
+    const char *category = "collection";
+    runCollectionWalk(jvm, runner, jEnv, wallet, error, "jniGetCompletedTxs", "FFICompletedTxs",
+                      "FFICompletedTx", "jniGetAmount");
+    runCollectionWalk(jvm, runner, jEnv, wallet, error, "jniGetCancelledTxs", "FFICompletedTxs",
+                      "FFICompletedTx", "jniGetAmount");
+    runCollectionWalk(jvm, runner, jEnv, wallet, error, "jniGetPendingInboundTxs",
+                      "FFIPendingInboundTxs", "FFIPendingInboundTx", "jniGetAmount");
+    runCollectionWalk(jvm, runner, jEnv, wallet, error, "jniGetPendingOutboundTxs",
+                      "FFIPendingOutboundTxs", "FFIPendingOutboundTx", "jniGetAmount");
+    runCollectionWalk(jvm, runner, jEnv, wallet, error, "jniGetContacts", "FFIContacts",
+                      "FFIContact", nullptr);
+
+    runSnapshot(jvm, runner, jEnv, wallet, error, "jniGetCompletedTxs", "FFICompletedTxs");
+    runSnapshot(jvm, runner, jEnv, wallet, error, "jniGetPendingInboundTxs",
+                "FFIPendingInboundTxs");
+    runSnapshot(jvm, runner, jEnv, wallet, error, "jniGetPendingOutboundTxs",
+                "FFIPendingOutboundTxs");
+
+    jobject emojiSet = jvm.newObject("FFIEmojiSet");
+    jvm.nativeMethod<VoidMethod>("FFIEmojiSet", "jniCreate")(jEnv, emojiSet);
+    auto emojiSetLength = jvm.nativeMethod<IntGetter>("FFIEmojiSet", "jniGetLength");
+    auto emojiSetGetAt = jvm.nativeMethod<LongAtGetter>("FFIEmojiSet", "jniGetAt");
+    auto byteVectorDestroy = jvm.nativeMethod<VoidMethod>("FFIByteVector", "jniDestroy");
+    jobject emoji = jvm.newObject("FFIByteVector");
+    auto emojiCount = static_cast<unsigned int>(emojiSetLength(jEnv, emojiSet, error));
+    runner.run(category, "FFIEmojiSet walk", emojiCount, [&](long) {
+        jint size = emojiSetLength(jEnv, emojiSet, error);
+        for (jint index = 0; index < size; index++) {
+            HostJvm::unwrap(emoji)->pointer = emojiSetGetAt(jEnv, emojiSet, index, error);
+            byteVectorDestroy(jEnv, emoji);
+        }
+    });
+    jvm.nativeMethod<VoidMethod>("FFIEmojiSet", "jniDestroy")(jEnv, emojiSet);
+
+    auto getTxTable = jvm.nativeMethod<LongGetter>("FFIWallet", "jniGetTxTable");
+    auto tableDestroy = jvm.nativeMethod<VoidMethod>("FFITxTable", "jniDestroy");
+    auto rowCount = jvm.nativeMethod<IntMethod>("FFITxTable", "jniGetRowCount");
+    jobject table = jvm.newObject("FFITxTable");
+    HostJvm::unwrap(table)->pointer = getTxTable(jEnv, wallet, error);
+    auto rows = static_cast<unsigned int>(rowCount(jEnv, table));
+    runner.run(category, "FFIWallet.jniGetTxTable", rows, [&](long) {
+        jobject fresh = jvm.newObject("FFITxTable");
+        HostJvm::unwrap(fresh)->pointer = getTxTable(jEnv, wallet, error);
+        tableDestroy(jEnv, fresh);
+    });
+    auto copyLongColumn = jvm.nativeMethod<void (*)(JNIEnv *, jobject, jint, jlongArray, jobject)>(
+            "FFITxTable", "jniCopyLongColumn");
+    auto copyIntColumn = jvm.nativeMethod<void (*)(JNIEnv *, jobject, jint, jintArray, jobject)>(
+            "FFITxTable", "jniCopyIntColumn");
+    jlongArray longColumn = jvm.newLongArray(static_cast<jsize>(rows));
+    jintArray intColumn = jvm.newIntArray(static_cast<jsize>(rows));
+    jvm.pin(HostJvm::unwrap(longColumn));
+    jvm.pin(HostJvm::unwrap(intColumn));
+    runner.run(category, "FFITxTable.jniCopyLongColumn", rows, [&](long n) {
+        copyLongColumn(jEnv, table, static_cast<jint>(n % 4), longColumn, error);
+    });
+    runner.run(category, "FFITxTable.jniCopyIntColumn", rows, [&](long n) {
+        copyIntColumn(jEnv, table, static_cast<jint>(n % 6), intColumn, error);
+    });
+    tableDestroy(jEnv, table);
+
+    auto getTxPage = jvm.nativeMethod<jlong (*)(JNIEnv *, jobject, jint, jboolean, jint, jint, jint,
+                                                jobject)>("FFIWallet", "jniGetTxPage");
+    runner.run(category, "FFIWallet.jniGetTxPage", 50, [&](long) {
+        HostJvm::unwrap(table)->pointer = getTxPage(jEnv, wallet, 0, JNI_TRUE, 0xF, 0, 50, error);
+        tableDestroy(jEnv, table);
+    });
+
+    auto getTxChangesSince = jvm.nativeMethod<jlong (*)(JNIEnv *, jobject, jlong, jobject)>(
+            "FFIWallet", "jniGetTxChangesSince");
+    runner.run(category, "FFIWallet.jniGetTxChangesSince", rows, [&](long) {
+        HostJvm::unwrap(table)->pointer = getTxChangesSince(jEnv, wallet, 0, error);
+        tableDestroy(jEnv, table);
+    });
+
+    auto searchTxs = jvm.nativeMethod<jlongArray (*)(JNIEnv *, jobject, jstring, jint, jobject)>(
+            "FFIWallet", "jniSearchTxs");
+    // a single byte, a word every message starts with, a common word tail and a rare number
+    for (const char *text : {"a", "payment", "ment", "1234 "}) {
+        jstring query = jvm.newString(text);
+        jvm.pin(HostJvm::unwrap(query));
+        runner.run(category, std::string("FFIWallet.jniSearchTxs \"") + text + "\"", rows,
+                   [&](long) {
+                       searchTxs(jEnv, wallet, query, 50, error);
+                   });
+    }
+
+    // an arena scope adopting a batch of wrappers created natively, released in bulk
+    auto arenaCreate = jvm.nativeMethod<VoidMethod>("FFIHandleArena", "jniCreate");
+    auto arenaActivate = jvm.nativeMethod<VoidMethod>("FFIHandleArena", "jniActivate");
+    auto arenaSize = jvm.nativeMethod<IntMethod>("FFIHandleArena", "jniGetSize");
+    auto arenaRelease = jvm.nativeMethod<IntMethod>("FFIHandleArena", "jniRelease");
+    auto arenaDestroy = jvm.nativeMethod<VoidMethod>("FFIHandleArena", "jniDestroy");
+    auto arenaAdopt = jvm.nativeMethod<void (*)(JNIEnv *, jobject, jobject)>(
+            "FFIHandleArena", "jniAdopt");
+    auto byteVectorCreate = jvm.nativeMethod<void (*)(JNIEnv *, jobject, jbyteArray, jobject)>(
+            "FFIByteVector", "jniCreate");
+    jbyteArray data = jvm.newByteArray(32);
+    jvm.pin(HostJvm::unwrap(data));
+    const unsigned int scopeSize = 16;
+    runner.run(category, "FFIHandleArena scope", scopeSize, [&](long) {
+        // one handle created before the scope and adopted from the Kotlin side
+        jobject adopted = jvm.newObject("FFIByteVector");
+        byteVectorCreate(jEnv, adopted, data, error);
+        jobject arena = jvm.newObject("FFIHandleArena");
+        arenaCreate(jEnv, arena);
+        arenaActivate(jEnv, arena);
+        arenaAdopt(jEnv, arena, adopted);
+        for (unsigned int n = 1; n < scopeSize; n++) {
+            byteVectorCreate(jEnv, jvm.newObject("FFIByteVector"), data, error);
+        }
+        arenaSize(jEnv, arena);
+        arenaRelease(jEnv, arena);
+        arenaDestroy(jEnv, arena);
+    });
+}
+
+/**
+ * Bursts of one callback raised on a separate thread standing in for the wallet library.
+ * Reports the time the raising thread spends per callback and the time until the whole burst
+ * was handed to FFIWallet.onEvents, per event.
+ */
+static void runCallback(BenchmarkRunner &runner, EventSink &sink, TariWallet *pWallet,
+                        StubWalletCallback callback, const char *name) {
+    std::string postName = std::string(name) + " post";
+    std::string deliveryName = std::string(name) + " delivery";
+    if (!runner.selected(postName) && !runner.selected(deliveryName)) {
+        return;
+    }
+    BenchmarkResult post{"callback", postName, kCallbackBurst, 1, {}};
+    BenchmarkResult delivery{"callback", deliveryName, kCallbackBurst, 1, {}};
+    for (int sample = 0; sample < runner.options.samples; sample++) {
+        long long target = sink.delivered.load() + kCallbackBurst;
+        long long postNanos = 0;
+        long long start = nowNanos();
+        std::thread walletThread([&]() {
+            long long threadStart = nowNanos();
+            for (int n = 0; n < kCallbackBurst; n++) {
+                stubWalletEmitCallback(pWallet, callback, static_cast<unsigned int>(n));
+            }
+            postNanos = nowNanos() - threadStart;
+        });
+        walletThread.join();
+        while (sink.delivered.load() < target) {
+            if (nowNanos() - start > kCallbackTimeoutNanos) {
+                fprintf(stderr, "%s: %lld of %d events delivered before the timeout\n", name,
+                        sink.delivered.load() - target + kCallbackBurst, kCallbackBurst);
+                runner.failed = true;
+                return;
+            }
+            std::this_thread::yield();
+        }
+        long long deliveryNanos = nowNanos() - start;
+        post.nanosPerOp.push_back(static_cast<double>(postNanos) / kCallbackBurst);
+        delivery.nanosPerOp.push_back(static_cast<double>(deliveryNanos) / kCallbackBurst);
+    }
+    if (runner.selected(postName)) {
+        runner.add(post);
+    }
+    if (runner.selected(deliveryName)) {
+        runner.add(delivery);
+    }
+}
+
+static void runCallbacks(BenchmarkRunner &runner, EventSink &sink, TariWallet *pWallet) {
+    runCallback(runner, sink, pWallet, kStubTxReceived, "txReceivedCallback");
+    runCallback(runner, sink, pWallet, kStubTxMined, "txMinedCallback");
+    runCallback(runner, sink, pWallet, kStubTxMinedUnconfirmed, "txMinedUnconfirmedCallback");
+    runCallback(runner, sink, pWallet, kStubDirectSendResult, "txDirectSendResultCallback");
+    runCallback(runner, sink, pWallet, kStubTxValidationComplete,
+                "transactionValidationCompleteCallback");
+}
+
+static void runCreateDestroy(HostJvm &jvm, BenchmarkRunner &runner, JNIEnv *jEnv,
+                             jobject wallet, jobject error) {
+    const char *category = "create";
+    jobject target;
+
+    auto byteVectorCreate = jvm.nativeMethod<void (*)(JNIEnv *, jobject, jbyteArray, jobject)>(
+            "FFIByteVector", "jniCreate");
+    auto byteVectorDestroy = jvm.nativeMethod<VoidMethod>("FFIByteVector", "jniDestroy");
+    jbyteArray data = jvm.newByteArray(32);
+    jvm.pin(HostJvm::unwrap(data));
+    target = jvm.newObject("FFIByteVector");
+    runner.run(category, "FFIByteVector.jniCreate", 1, [&](long) {
+        byteVectorCreate(jEnv, target, data, error);
+        byteVectorDestroy(jEnv, target);
+    });
+    auto createFromBuffer = jvm.nativeMethod<void (*)(JNIEnv *, jobject, jobject, jint, jint,
+                                                      jobject)>("FFIByteVector", "jniCreateFromBuffer");
+    jobject buffer = jvm.newDirectByteBuffer(32);
+    jvm.pin(HostJvm::unwrap(buffer));
+    runner.run(category, "FFIByteVector.jniCreateFromBuffer", 1, [&](long) {
+        createFromBuffer(jEnv, target, buffer, 0, 32, error);
+        byteVectorDestroy(jEnv, target);
+    });
+
+    auto getPublicKey = jvm.nativeMethod<LongGetter>("FFIWallet", "jniGetPublicKey");
+    jobject walletKey = wrapHandle(jvm, "FFIPublicKey", getPublicKey(jEnv, wallet, error));
+    std::string hex = HostJvm::toUtf8(jvm.nativeMethod<StringGetter>("FFIPublicKey", "jniGetHex")(
+            jEnv, walletKey, error));
+    std::string emojiId = HostJvm::toUtf8(jvm.nativeMethod<StringGetter>(
+            "FFIPublicKey", "jniGetEmojiId")(jEnv, walletKey, error));
+    auto publicKeyDestroy = jvm.nativeMethod<VoidMethod>("FFIPublicKey", "jniDestroy");
+    auto publicKeyCreator = [&](const char *name, const std::string &text) {
+        auto method = jvm.nativeMethod<StringCreator>("FFIPublicKey", name);
+        jstring jText = jvm.newString(text);
+        jvm.pin(HostJvm::unwrap(jText));
+        jobject key = jvm.newObject("FFIPublicKey");
+        runner.run(category, std::string("FFIPublicKey.") + name, 1, [&](long) {
+            method(jEnv, key, jText, error);
+            publicKeyDestroy(jEnv, key);
+        });
+    };
+    publicKeyCreator("jniFromHex", hex);
+    publicKeyCreator("jniFromEmojiId", emojiId);
+
+    auto privateKeyGenerate = jvm.nativeMethod<VoidMethod>("FFIPrivateKey", "jniGenerate");
+    auto privateKeyDestroy = jvm.nativeMethod<VoidMethod>("FFIPrivateKey", "jniDestroy");
+    target = jvm.newObject("FFIPrivateKey");
+    runner.run(category, "FFIPrivateKey.jniGenerate", 1, [&](long) {
+        privateKeyGenerate(jEnv, target);
+        privateKeyDestroy(jEnv, target);
+    });
+    auto fromPrivateKey = jvm.nativeMethod<void (*)(JNIEnv *, jobject, jobject, jobject)>(
+            "FFIPublicKey", "jniFromPrivateKey");
+    jobject privateKey = jvm.newObject("FFIPrivateKey");
+    privateKeyGenerate(jEnv, privateKey);
+    jobject derived = jvm.newObject("FFIPublicKey");
+    runner.run(category, "FFIPublicKey.jniFromPrivateKey", 1, [&](long) {
+        fromPrivateKey(jEnv, derived, privateKey, error);
+        publicKeyDestroy(jEnv, derived);
+    });
+    privateKeyDestroy(jEnv, privateKey);
+
+    auto contactCreate = jvm.nativeMethod<void (*)(JNIEnv *, jobject, jstring, jobject, jobject)>(
+            "FFIContact", "jniCreate");
+    auto contactDestroy = jvm.nativeMethod<VoidMethod>("FFIContact", "jniDestroy");
+    jstring alias = jvm.newString("benchmark contact");
+    jvm.pin(HostJvm::unwrap(alias));
+    target = jvm.newObject("FFIContact");
+    runner.run(category, "FFIContact.jniCreate", 1, [&](long) {
+        contactCreate(jEnv, target, alias, walletKey, error);
+        contactDestroy(jEnv, target);
+    });
+    publicKeyDestroy(jEnv, walletKey);
+
+    auto memoryTransport = jvm.nativeMethod<VoidMethod>("FFITransportType", "jniMemoryTransport");
+    auto transportDestroy = jvm.nativeMethod<VoidMethod>("FFITransportType", "jniDestroy");
+    jobject transport = jvm.newObject("FFITransportType");
+    runner.run(category, "FFITransportType.jniMemoryTransport", 1, [&](long) {
+        memoryTransport(jEnv, transport);
+        transportDestroy(jEnv, transport);
+    });
+
+    auto commsConfigCreate = jvm.nativeMethod<void (*)(JNIEnv *, jobject, jstring, jobject, jstring,
+                                                       jstring, jlong, jlong, jstring, jobject)>(
+            "FFICommsConfig", "jniCreate");
+    auto commsConfigDestroy = jvm.nativeMethod<VoidMethod>("FFICommsConfig", "jniDestroy");
+    memoryTransport(jEnv, transport);
+    jstring address = jvm.newString("/ip4/127.0.0.1/tcp/18101");
+    jstring database = jvm.newString("benchmark_db");
+    jstring datastore = jvm.newString("/tmp");
+    jstring network = jvm.newString("weatherwax");
+    for (jstring string : {address, database, datastore, network}) {
+        jvm.pin(HostJvm::unwrap(string));
+    }
+    target = jvm.newObject("FFICommsConfig");
+    runner.run(category, "FFICommsConfig.jniCreate", 1, [&](long) {
+        commsConfigCreate(jEnv, target, address, transport, database, datastore, 30, 600, network,
+                          error);
+        commsConfigDestroy(jEnv, target);
+    });
+    transportDestroy(jEnv, transport);
+}
+
+// endregion
+
+// region Report
+
+static void writeJson(FILE *out, HostJvm &jvm, JNIEnv *jEnv, const Options &options,
+                      const BenchmarkRunner &runner, const EventSink &sink) {
+    const StubWalletConfig &stub = options.stub;
+    fprintf(out, "{\n  \"schema\": \"%s\",\n", kJsonSchema);
+    fprintf(out, "  \"samples\": %d,\n  \"iterations\": %ld,\n", options.samples,
+            options.iterations);
+    fprintf(out, "  \"stub\": {\"callLatencyNanos\": %lld, \"elementLatencyNanos\": %lld, "
+                 "\"completedTxCount\": %u, \"cancelledTxCount\": %u, "
+                 "\"pendingInboundTxCount\": %u, \"pendingOutboundTxCount\": %u, "
+                 "\"contactCount\": %u, \"messageLength\": %u, \"emojiMessages\": %s},\n",
+            static_cast<long long>(stub.callLatencyNanos),
+            static_cast<long long>(stub.elementLatencyNanos), stub.completedTxCount,
+            stub.cancelledTxCount, stub.pendingInboundTxCount, stub.pendingOutboundTxCount,
+            stub.contactCount, stub.messageLength, stub.emojiMessages ? "true" : "false");
+
+    jobject util = jvm.newObject("FFIUtil");
+    jlong load[3];
+    jEnv->GetLongArrayRegion(
+            jvm.nativeMethod<LongArrayMethod>("FFIUtil", "jniGetLoadStats")(jEnv, util), 0, 3, load);
+    fprintf(out, "  \"load\": {\"staticRegistration\": %s, \"onLoadNanos\": %lld, "
+                 "\"registeredMethods\": %lld},\n", load[0] != 0 ? "true" : "false",
+            static_cast<long long>(load[1]), static_cast<long long>(load[2]));
+
+    fprintf(out, "  \"benchmarks\": [");
+    for (size_t n = 0; n < runner.results.size(); n++) {
+        const BenchmarkResult &result = runner.results[n];
+        const std::vector<double> &sorted = result.nanosPerOp;
+        double mean = 0;
+        for (double value : sorted) {
+            mean += value;
+        }
+        mean /= sorted.size();
+        size_t p90 = std::min(sorted.size() - 1, (sorted.size() * 9) / 10);
+        double perElement = BenchmarkRunner::median(sorted) / std::max(1U, result.elements);
+        fprintf(out, "%s\n    {\"category\": \"%s\", \"name\": \"%s\", \"iterations\": %ld, "
+                     "\"elements\": %u, \"minNanos\": %.1f, \"medianNanos\": %.1f, "
+                     "\"meanNanos\": %.1f, \"p90Nanos\": %.1f, \"medianNanosPerElement\": %.1f}",
+                n == 0 ? "" : ",", result.category.c_str(), result.name.c_str(),
+                result.iterations, result.elements, sorted.front(),
+                BenchmarkRunner::median(sorted), mean, sorted[p90], perElement);
+    }
+    fprintf(out, "\n  ],\n");
+
+    fprintf(out, "  \"coverage\": {");
+    bool first = true;
+    for (const auto &entry : jvm.nativeCoverage()) {
+        fprintf(out, "%s\n    \"%s\": {\"registered\": %d, \"exercised\": %d}", first ? "" : ",",
+                entry.first.c_str(), entry.second.first, entry.second.second);
+        first = false;
+    }
+    fprintf(out, "\n  },\n");
+
+    jlong handles[kHandleTypeCount * kHandleCounterCount];
+    jEnv->GetLongArrayRegion(
+            jvm.nativeMethod<LongArrayMethod>("FFIUtil", "jniGetHandleStats")(jEnv, util), 0,
+            kHandleTypeCount * kHandleCounterCount, handles);
+    fprintf(out, "  \"liveHandles\": {");
+    for (int type = 0; type < kHandleTypeCount; type++) {
+        fprintf(out, "%s\"%s\": %lld", type == 0 ? "" : ", ", kHandleTypeNames[type],
+                static_cast<long long>(handles[type * kHandleCounterCount + kHandleLive]));
+    }
+    fprintf(out, "},\n");
+    fprintf(out, "  \"eventsDelivered\": %lld,\n", sink.delivered.load());
+    fprintf(out, "  \"stubCalls\": %llu,\n",
+            static_cast<unsigned long long>(stubWalletCallCount()));
+    fprintf(out, "  \"failed\": %s\n}\n", runner.failed ? "true" : "false");
+}
+
+// endregion
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 2;
+    }
+    stubWalletConfigure(options.stub);
+
+    HostJvm jvm;
+    JNIEnv *jEnv = jvm.attachCurrentThread();
+    EventSink sink;
+    jvm.defineVoidMethod("com/tari/android/wallet/ffi/FFIWallet", "onEvents", "([JI)V", onEvents,
+                         &sink);
+    if (JNI_OnLoad(jvm.getJavaVm(), nullptr) == JNI_ERR) {
+        fprintf(stderr, "JNI_OnLoad failed.\n");
+        return 1;
+    }
+
+    jobject error = jvm.newObject("FFIError");
+    jvm.pin(HostJvm::unwrap(error));
+    sink.error = jvm.newObject("FFIError");
+    sink.completedTx = jvm.newObject("FFICompletedTx");
+    sink.pendingInboundTx = jvm.newObject("FFIPendingInboundTx");
+    for (jobject object : {sink.error, sink.completedTx, sink.pendingInboundTx}) {
+        jvm.pin(HostJvm::unwrap(object));
+    }
+    sink.completedTxGetId = jvm.nativeMethod<LongGetter>("FFICompletedTx", "jniGetId");
+    sink.completedTxDestroy = jvm.nativeMethod<VoidMethod>("FFICompletedTx", "jniDestroy");
+    sink.pendingInboundTxGetId = jvm.nativeMethod<LongGetter>("FFIPendingInboundTx", "jniGetId");
+    sink.pendingInboundTxDestroy = jvm.nativeMethod<VoidMethod>("FFIPendingInboundTx",
+                                                                "jniDestroy");
+
+    jobject transport = jvm.newObject("FFITransportType");
+    jvm.nativeMethod<VoidMethod>("FFITransportType", "jniMemoryTransport")(jEnv, transport);
+    jobject commsConfig = jvm.newObject("FFICommsConfig");
+    jvm.nativeMethod<void (*)(JNIEnv *, jobject, jstring, jobject, jstring, jstring, jlong, jlong,
+                              jstring, jobject)>("FFICommsConfig", "jniCreate")(
+            jEnv, commsConfig, jvm.newString("/ip4/127.0.0.1/tcp/18101"), transport,
+            jvm.newString("benchmark_db"), jvm.newString("/tmp"), 30, 600,
+            jvm.newString("weatherwax"), error);
+    jobject wallet = jvm.newObject("FFIWallet");
+    jvm.pin(HostJvm::unwrap(wallet));
+    jvm.nativeMethod<void (*)(JNIEnv *, jobject, jobject, jstring, jint, jint, jstring, jobject,
+                              jstring, jstring, jobject)>("FFIWallet", "jniCreate")(
+            jEnv, wallet, commsConfig, jvm.newString(""), 2, 1024, nullptr, nullptr,
+            jvm.newString("onEvents"), jvm.newString("([JI)V"), error);
+    if (HostJvm::unwrap(error)->code != 0 || HostJvm::unwrap(wallet)->pointer == 0) {
+        fprintf(stderr, "Wallet creation failed with error %d.\n", HostJvm::unwrap(error)->code);
+        return 1;
+    }
+    jvm.releaseLocalRefs();
+
+    BenchmarkRunner runner(jvm, options, error);
+    runGetters(jvm, runner, jEnv, wallet, error);
+    runStrings(jvm, runner, jEnv, wallet, error);
+    runCollections(jvm, runner, jEnv, wallet, error);
+    runCallbacks(runner, sink, reinterpret_cast<TariWallet *>(HostJvm::unwrap(wallet)->pointer));
+    runCreateDestroy(jvm, runner, jEnv, wallet, error);
+
+    FILE *out = stdout;
+    if (!options.out.empty()) {
+        out = fopen(options.out.c_str(), "w");
+        if (out == nullptr) {
+            fprintf(stderr, "Cannot write %s.\n", options.out.c_str());
+            return 1;
+        }
+    }
+    writeJson(out, jvm, jEnv, options, runner, sink);
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    jvm.nativeMethod<VoidMethod>("FFIWallet", "jniDestroy")(jEnv, wallet);
+    jvm.nativeMethod<VoidMethod>("FFICommsConfig", "jniDestroy")(jEnv, commsConfig);
+    jvm.nativeMethod<VoidMethod>("FFITransportType", "jniDestroy")(jEnv, transport);
+    jvm.releaseLocalRefs();
+    return runner.failed ? 1 : 0;
+}
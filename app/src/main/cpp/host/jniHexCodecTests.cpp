@@ -0,0 +1,147 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include "../jniHexCodec.cpp"
+
+/**
+ * Round-trip tests of hexEncode and hexDecode, run on a Linux host by ctest.
+ *
+ * The codec picks its vector path from the target flags, so CMakeLists.txt builds this file once
+ * with the default flags and once each with -mssse3 and -mavx2, the paths of the Android x86_64
+ * ABI and of AVX2 builds. A build for an instruction set the host CPU lacks skips itself.
+ *
+ * Usage: jni_hex_codec_tests
+ */
+
+static const int kRandomInputCount = 20000;
+// two 32 byte AVX2 steps and a tail, so every path sees bulk, remainder and empty inputs
+static const size_t kMaxInputLength = 80;
+
+static int g_failures = 0;
+
+static void fail(const char *what, const std::vector<uint8_t> &bytes, const std::string &hex) {
+    fprintf(stderr, "%s, %zu bytes: %s\n", what, bytes.size(), hex.c_str());
+    g_failures++;
+}
+
+static std::string referenceHex(const std::vector<uint8_t> &bytes, bool upperCase) {
+    std::string hex;
+    char digits[3];
+    for (uint8_t byte : bytes) {
+        snprintf(digits, sizeof(digits), upperCase ? "%02X" : "%02x", byte);
+        hex += digits;
+    }
+    return hex;
+}
+
+static bool isHexDigit(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+int main() {
+#if defined(__AVX2__)
+    if (!__builtin_cpu_supports("avx2")) {
+        fprintf(stderr, "SKIP the host CPU has no AVX2\n");
+        return 0;
+    }
+#elif defined(__SSSE3__)
+    if (!__builtin_cpu_supports("ssse3")) {
+        fprintf(stderr, "SKIP the host CPU has no SSSE3\n");
+        return 0;
+    }
+#endif
+    std::mt19937 random(20200801);
+    std::uniform_int_distribution<size_t> lengths(0, kMaxInputLength);
+    std::uniform_int_distribution<int> bytesOf(0, 255);
+    for (int n = 0; n < kRandomInputCount; n++) {
+        std::vector<uint8_t> bytes(lengths(random));
+        for (uint8_t &byte : bytes) {
+            byte = static_cast<uint8_t>(bytesOf(random));
+        }
+        bool upperCase = n % 2 == 0;
+        std::string expected = referenceHex(bytes, upperCase);
+        // exactly sized, so that the sanitizer builds catch a write past the end
+        std::vector<char> hex(2 * bytes.size());
+        hexEncode(bytes.data(), bytes.size(), hex.data(), upperCase);
+        std::string encoded(hex.begin(), hex.end());
+        if (encoded != expected) {
+            fail("encoded differently", bytes, encoded);
+            continue;
+        }
+
+        // either case decodes, also mixed within one string
+        for (char &c : hex) {
+            if (c >= 'A' && bytesOf(random) % 2 == 0) {
+                c = static_cast<char>(c ^ 0x20);
+            }
+        }
+        std::vector<uint8_t> decoded(bytes.size());
+        if (!hexDecode(hex.data(), bytes.size(), decoded.data()) || decoded != bytes) {
+            fail("did not decode back", bytes, std::string(hex.begin(), hex.end()));
+            continue;
+        }
+
+        // a single character that is not a hex digit, anywhere, fails the whole string
+        if (!hex.empty()) {
+            size_t at = static_cast<size_t>(bytesOf(random)) * hex.size() / 256;
+            char c;
+            do {
+                c = static_cast<char>(bytesOf(random));
+            } while (isHexDigit(c));
+            hex[at] = c;
+            if (hexDecode(hex.data(), bytes.size(), decoded.data())) {
+                fail("accepted a non-digit", bytes, std::string(hex.begin(), hex.end()));
+            }
+        }
+    }
+    // the neighbours of the digit ranges
+    for (char c : {'/', ':', '@', 'G', '`', 'g', '\0', ' ', '\x7f', '\x80', '\xc1', '\xff'}) {
+        for (size_t length : {static_cast<size_t>(1), static_cast<size_t>(16),
+                              static_cast<size_t>(32), static_cast<size_t>(40)}) {
+            std::vector<char> hex(2 * length, 'a');
+            hex[hex.size() - 1 - length % 7] = c;
+            std::vector<uint8_t> decoded(length);
+            if (hexDecode(hex.data(), length, decoded.data())) {
+                fail("accepted a non-digit", decoded, std::string(hex.begin(), hex.end()));
+            }
+        }
+    }
+    fprintf(stderr, "%s hex codec, %d random inputs\n", g_failures == 0 ? "PASS" : "FAIL",
+            kRandomInputCount);
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,1288 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "hostJni.h"
+#include "stubWallet.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../jniTxCache.cpp"
+#include "../jniWalletEvents.cpp"
+
+/**
+ * Functional tests of the JNI layer against the stub wallet, run on a Linux host by ctest.
+ *
+ * They cover the native paths the instrumented FFIWalletTests cannot reach on a device without
+ * a funded wallet and a base node: the stub seeds a wallet with known transactions and raises
+ * any callback on demand. Every test drives the registered natives the way the Kotlin wrappers
+ * do, through the fake JNIEnv of hostJni.cpp.
+ *
+ * Usage: jni_host_tests [NAME]...
+ *
+ * Runs the named tests, all of them if none is given, and exits with 1 if any check failed.
+ */
+
+typedef void (*VoidMethod)(JNIEnv *, jobject);
+typedef jlong (*LongGetter)(JNIEnv *, jobject, jobject);
+typedef jlongArray (*LongArrayMethod)(JNIEnv *, jobject);
+typedef jint (*IntGetter)(JNIEnv *, jobject, jobject);
+typedef jstring (*StringGetter)(JNIEnv *, jobject, jobject);
+typedef jlong (*PointerGetter)(JNIEnv *, jobject, jobject);
+
+static const long long kDrainTimeoutNanos = 10000000000LL;
+
+static int g_failures = 0;
+
+static void expectTrue(bool condition, const char *text, const char *file, int line) {
+    if (!condition) {
+        fprintf(stderr, "%s:%d: expected %s\n", file, line, text);
+        g_failures++;
+    }
+}
+
+static void expectEqual(long long expected, long long actual, const char *text, const char *file,
+                        int line) {
+    if (expected != actual) {
+        fprintf(stderr, "%s:%d: expected %s to be %lld, was %lld\n", file, line, text, expected,
+                actual);
+        g_failures++;
+    }
+}
+
+#define EXPECT_TRUE(condition) expectTrue((condition), #condition, __FILE__, __LINE__)
+#define EXPECT_EQ(expected, actual) \
+    expectEqual(static_cast<long long>(expected), static_cast<long long>(actual), #actual, \
+                __FILE__, __LINE__)
+
+/**
+ * An event as FFIWallet.onEvents sees it, with the transaction id read from the handle of
+ * transaction events.
+ */
+struct DeliveredEvent {
+    jlong type;
+    jlong txId;
+    jlong arg1;
+};
+
+/**
+ * Records the FFIWallet.onEvents batches on the dispatcher thread. Transaction handles are read
+ * and destroyed through their wrappers, like FFIWallet does.
+ */
+struct EventLog {
+    std::mutex mutex;
+    std::vector<DeliveredEvent> events;
+    jobject completedTx = nullptr;
+    jobject pendingInboundTx = nullptr;
+    jobject error = nullptr;
+    LongGetter completedTxGetId = nullptr;
+    VoidMethod completedTxDestroy = nullptr;
+    LongGetter pendingInboundTxGetId = nullptr;
+    VoidMethod pendingInboundTxDestroy = nullptr;
+
+    std::vector<DeliveredEvent> take() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<DeliveredEvent> taken;
+        taken.swap(events);
+        return taken;
+    }
+};
+
+static void onEvents(JNIEnv *jEnv, jobject, va_list args, void *data) {
+    auto *log = static_cast<EventLog *>(data);
+    auto jBatch = va_arg(args, jlongArray);
+    jint count = va_arg(args, jint);
+    jlong batch[kWalletEventBatchSize * kWalletEventStride];
+    jEnv->GetLongArrayRegion(jBatch, 0, count * kWalletEventStride, batch);
+    for (jint n = 0; n < count; n++) {
+        const jlong *record = batch + n * kWalletEventStride;
+        DeliveredEvent event{record[0], 0, record[2]};
+        switch (event.type) {
+            case kEventTxReceived:
+                HostJvm::unwrap(log->pendingInboundTx)->pointer = record[1];
+                event.txId = log->pendingInboundTxGetId(jEnv, log->pendingInboundTx, log->error);
+                log->pendingInboundTxDestroy(jEnv, log->pendingInboundTx);
+                break;
+            case kEventTxReplyReceived:
+            case kEventTxFinalized:
+            case kEventTxBroadcast:
+            case kEventTxMined:
+            case kEventTxMinedUnconfirmed:
+            case kEventTxCancelled:
+                HostJvm::unwrap(log->completedTx)->pointer = record[1];
+                event.txId = log->completedTxGetId(jEnv, log->completedTx, log->error);
+                log->completedTxDestroy(jEnv, log->completedTx);
+                break;
+            default:
+                event.txId = record[1];
+                break;
+        }
+        std::lock_guard<std::mutex> lock(log->mutex);
+        log->events.push_back(event);
+    }
+}
+
+/**
+ * The VM shared by all tests, with FFIWallet.onEvents feeding the event log.
+ */
+struct TestEnv {
+    HostJvm &jvm;
+    JNIEnv *jEnv;
+    EventLog &log;
+    jobject error;
+    jobject ffiUtil;
+};
+
+/**
+ * A stub wallet created through FFIWallet.jniCreate with the given configuration, destroyed
+ * with the fixture.
+ */
+class WalletFixture {
+public:
+    WalletFixture(TestEnv &env, const StubWalletConfig &config) : env(env) {
+        stubWalletConfigure(config);
+        HostJvm &jvm = env.jvm;
+        transport = jvm.newObject("FFITransportType");
+        jvm.nativeMethod<VoidMethod>("FFITransportType", "jniMemoryTransport")(env.jEnv, transport);
+        commsConfig = jvm.newObject("FFICommsConfig");
+        jvm.nativeMethod<void (*)(JNIEnv *, jobject, jstring, jobject, jstring, jstring, jlong,
+                                  jlong, jstring, jobject)>("FFICommsConfig", "jniCreate")(
+                env.jEnv, commsConfig, jvm.newString("/ip4/127.0.0.1/tcp/18101"), transport,
+                jvm.newString("host_test_db"), jvm.newString("/tmp"), 30, 600,
+                jvm.newString("weatherwax"), env.error);
+        wallet = jvm.newObject("FFIWallet");
+        for (jobject object : {transport, commsConfig, wallet}) {
+            jvm.pin(HostJvm::unwrap(object));
+        }
+        jvm.nativeMethod<void (*)(JNIEnv *, jobject, jobject, jstring, jint, jint, jstring,
+                                  jobject, jstring, jstring, jobject)>("FFIWallet", "jniCreate")(
+                env.jEnv, wallet, commsConfig, jvm.newString(""), 2, 1024, nullptr, nullptr,
+                jvm.newString("onEvents"), jvm.newString("([JI)V"), env.error);
+        EXPECT_EQ(0, HostJvm::unwrap(env.error)->code);
+        pWallet = reinterpret_cast<TariWallet *>(HostJvm::unwrap(wallet)->pointer);
+        EXPECT_TRUE(pWallet != nullptr);
+        jvm.releaseLocalRefs();
+    }
+
+    ~WalletFixture() {
+        HostJvm &jvm = env.jvm;
+        jvm.nativeMethod<VoidMethod>("FFIWallet", "jniDestroy")(env.jEnv, wallet);
+        jvm.nativeMethod<VoidMethod>("FFICommsConfig", "jniDestroy")(env.jEnv, commsConfig);
+        jvm.nativeMethod<VoidMethod>("FFITransportType", "jniDestroy")(env.jEnv, transport);
+        jvm.releaseLocalRefs();
+        env.log.take();
+    }
+
+    /**
+     * Waits until every event posted to the dispatcher was delivered or coalesced away.
+     */
+    bool waitForDrain() {
+        auto getQueueStats = env.jvm.nativeMethod<LongArrayMethod>("FFIWallet",
+                                                                   "jniGetEventQueueStats");
+        int64_t start = stubWalletNowNanos();
+        jlong stats[kWalletEventStatCount];
+        while (stubWalletNowNanos() - start < kDrainTimeoutNanos) {
+            env.jEnv->GetLongArrayRegion(getQueueStats(env.jEnv, wallet), 0,
+                                         kWalletEventStatCount, stats);
+            env.jvm.releaseLocalRefs();
+            if (stats[kStatDispatched] + stats[kStatCoalesced] >= stats[kStatPosted]) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return false;
+    }
+
+    TestEnv &env;
+    jobject transport;
+    jobject commsConfig;
+    jobject wallet;
+    TariWallet *pWallet;
+};
+
+static jlong liveHandles(TestEnv &env, HandleType type) {
+    jlongArray jStats = env.jvm.nativeMethod<LongArrayMethod>("FFIUtil", "jniGetHandleStats")(
+            env.jEnv, env.ffiUtil);
+    jlong live;
+    env.jEnv->GetLongArrayRegion(jStats, type * kHandleCounterCount + kHandleLive, 1, &live);
+    env.jvm.releaseLocalRefs();
+    return live;
+}
+
+static StubWalletConfig smallWalletConfig() {
+    StubWalletConfig config = stubWalletDefaultConfig();
+    config.completedTxCount = 4;
+    config.cancelledTxCount = 2;
+    config.pendingInboundTxCount = 2;
+    config.pendingOutboundTxCount = 2;
+    config.contactCount = 2;
+    return config;
+}
+
+/**
+ * The columns of an FFITxTable as TxTable.kt copies them.
+ */
+struct HostTxTable {
+    std::vector<jlong> longColumns[kTxTableLongColumnCount];
+    std::vector<jint> intColumns[kTxTableIntColumnCount];
+    std::vector<std::string> strings;
+    jlong generation = 0;
+    jint totalRowCount = 0;
+
+    size_t size() const { return longColumns[kTxTableId].size(); }
+
+    jlong id(size_t row) const { return longColumns[kTxTableId][row]; }
+
+    const std::string &message(size_t row) const {
+        return strings[intColumns[kTxTableMessageRef][row]];
+    }
+
+    const std::string &counterparty(size_t row) const {
+        return strings[intColumns[kTxTableCounterpartyRef][row]];
+    }
+};
+
+/**
+ * Copies and destroys the FFITxTable returned by one of the FFIWallet table natives.
+ */
+static HostTxTable takeTxTable(TestEnv &env, jlong pointer) {
+    HostJvm &jvm = env.jvm;
+    HostTxTable table;
+    EXPECT_TRUE(pointer != 0);
+    if (pointer == 0) {
+        return table;
+    }
+    jobject tableFFI = jvm.newObject("FFITxTable");
+    HostJvm::unwrap(tableFFI)->pointer = pointer;
+    jint rowCount = jvm.nativeMethod<jint (*)(JNIEnv *, jobject)>("FFITxTable", "jniGetRowCount")(
+            env.jEnv, tableFFI);
+    auto copyLongColumn = jvm.nativeMethod<void (*)(JNIEnv *, jobject, jint, jlongArray, jobject)>(
+            "FFITxTable", "jniCopyLongColumn");
+    for (jint column = 0; column < kTxTableLongColumnCount; column++) {
+        jlongArray jColumn = jvm.newLongArray(rowCount);
+        copyLongColumn(env.jEnv, tableFFI, column, jColumn, env.error);
+        table.longColumns[column].resize(rowCount);
+        env.jEnv->GetLongArrayRegion(jColumn, 0, rowCount, table.longColumns[column].data());
+    }
+    auto copyIntColumn = jvm.nativeMethod<void (*)(JNIEnv *, jobject, jint, jintArray, jobject)>(
+            "FFITxTable", "jniCopyIntColumn");
+    for (jint column = 0; column < kTxTableIntColumnCount; column++) {
+        jintArray jColumn = jvm.newIntArray(rowCount);
+        copyIntColumn(env.jEnv, tableFFI, column, jColumn, env.error);
+        table.intColumns[column].resize(rowCount);
+        env.jEnv->GetIntArrayRegion(jColumn, 0, rowCount, table.intColumns[column].data());
+    }
+    auto jStrings = jvm.nativeMethod<jobjectArray (*)(JNIEnv *, jobject, jobject)>(
+            "FFITxTable", "jniGetStrings")(env.jEnv, tableFFI, env.error);
+    for (HostObject *string : HostJvm::unwrap(jStrings)->elements) {
+        table.strings.push_back(HostJvm::toUtf8(HostJvm::wrap(string)));
+    }
+    table.generation = jvm.nativeMethod<jlong (*)(JNIEnv *, jobject)>(
+            "FFITxTable", "jniGetGeneration")(env.jEnv, tableFFI);
+    table.totalRowCount = jvm.nativeMethod<jint (*)(JNIEnv *, jobject)>(
+            "FFITxTable", "jniGetTotalRowCount")(env.jEnv, tableFFI);
+    jvm.nativeMethod<VoidMethod>("FFITxTable", "jniDestroy")(env.jEnv, tableFFI);
+    jvm.releaseLocalRefs();
+    return table;
+}
+
+/**
+ * A tx as the per-object model reads it, one getter call per field.
+ */
+struct TxObject {
+    jint kind;
+    jlong amount;
+    jlong fee;
+    jlong timestamp;
+    jint status;
+    bool outbound;
+    std::string message;
+    std::string counterparty;
+};
+
+static std::string takePublicKeyHex(TestEnv &env, jlong pointer) {
+    jobject publicKey = env.jvm.newObject("FFIPublicKey");
+    HostJvm::unwrap(publicKey)->pointer = pointer;
+    std::string hex = HostJvm::toUtf8(env.jvm.nativeMethod<StringGetter>(
+            "FFIPublicKey", "jniGetHex")(env.jEnv, publicKey, env.error));
+    env.jvm.nativeMethod<VoidMethod>("FFIPublicKey", "jniDestroy")(env.jEnv, publicKey);
+    for (char &c : hex) {
+        c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+    }
+    return hex;
+}
+
+/**
+ * Every tx of the wallet read through the collection natives and the per-tx getters, keyed by
+ * kind and id.
+ */
+static std::map<std::pair<jint, jlong>, TxObject> readTxObjects(TestEnv &env, jobject wallet) {
+    static const struct {
+        const char *getter;
+        const char *collection;
+        const char *element;
+        TxTableKind kind;
+    } kSources[] = {
+            {"jniGetCompletedTxs", "FFICompletedTxs", "FFICompletedTx", kTxTableCompleted},
+            {"jniGetCancelledTxs", "FFICompletedTxs", "FFICompletedTx", kTxTableCancelled},
+            {"jniGetPendingInboundTxs", "FFIPendingInboundTxs", "FFIPendingInboundTx",
+             kTxTablePendingInbound},
+            {"jniGetPendingOutboundTxs", "FFIPendingOutboundTxs", "FFIPendingOutboundTx",
+             kTxTablePendingOutbound},
+    };
+    HostJvm &jvm = env.jvm;
+    JNIEnv *jEnv = env.jEnv;
+    std::map<std::pair<jint, jlong>, TxObject> txs;
+    for (const auto &source : kSources) {
+        jobject collection = jvm.newObject(source.collection);
+        HostJvm::unwrap(collection)->pointer = jvm.nativeMethod<PointerGetter>(
+                "FFIWallet", source.getter)(jEnv, wallet, env.error);
+        jint length = jvm.nativeMethod<IntGetter>(source.collection, "jniGetLength")(
+                jEnv, collection, env.error);
+        auto getAt = jvm.nativeMethod<jlong (*)(JNIEnv *, jobject, jint, jobject)>(
+                source.collection, "jniGetAt");
+        bool isCompleted = source.kind == kTxTableCompleted || source.kind == kTxTableCancelled;
+        for (jint index = 0; index < length; index++) {
+            jobject tx = jvm.newObject(source.element);
+            HostJvm::unwrap(tx)->pointer = getAt(jEnv, collection, index, env.error);
+            TxObject object{source.kind, 0, 0, 0, 0, false, "", ""};
+            jlong id = jvm.nativeMethod<LongGetter>(source.element, "jniGetId")(jEnv, tx, env.error);
+            object.amount = jvm.nativeMethod<LongGetter>(source.element, "jniGetAmount")(
+                    jEnv, tx, env.error);
+            object.timestamp = jvm.nativeMethod<LongGetter>(source.element, "jniGetTimestamp")(
+                    jEnv, tx, env.error);
+            object.status = jvm.nativeMethod<IntGetter>(source.element, "jniGetStatus")(
+                    jEnv, tx, env.error);
+            object.message = HostJvm::toUtf8(jvm.nativeMethod<StringGetter>(
+                    source.element, "jniGetMessage")(jEnv, tx, env.error));
+            if (isCompleted) {
+                object.outbound = jvm.nativeMethod<jboolean (*)(JNIEnv *, jobject, jobject)>(
+                        source.element, "jniIsOutbound")(jEnv, tx, env.error) != JNI_FALSE;
+            } else {
+                object.outbound = source.kind == kTxTablePendingOutbound;
+            }
+            if (isCompleted || object.outbound) {
+                object.fee = jvm.nativeMethod<LongGetter>(source.element, "jniGetFee")(
+                        jEnv, tx, env.error);
+            }
+            const char *counterpartyGetter = object.outbound ? "jniGetDestinationPublicKey"
+                                                             : "jniGetSourcePublicKey";
+            object.counterparty = takePublicKeyHex(env, jvm.nativeMethod<PointerGetter>(
+                    source.element, counterpartyGetter)(jEnv, tx, env.error));
+            jvm.nativeMethod<VoidMethod>(source.element, "jniDestroy")(jEnv, tx);
+            txs[std::make_pair(static_cast<jint>(source.kind), id)] = object;
+        }
+        jvm.nativeMethod<VoidMethod>(source.collection, "jniDestroy")(jEnv, collection);
+        jvm.releaseLocalRefs();
+    }
+    return txs;
+}
+
+/**
+ * Every row of the columnar table holds the same values as the per-object getters of the tx,
+ * and the table holds every tx of the four collections.
+ */
+static void testTxTableMatchesObjectModel(TestEnv &env) {
+    StubWalletConfig config = smallWalletConfig();
+    config.completedTxCount = 40;
+    config.cancelledTxCount = 5;
+    config.pendingInboundTxCount = 7;
+    config.pendingOutboundTxCount = 6;
+    WalletFixture fixture(env, config);
+    jint &code = HostJvm::unwrap(env.error)->code;
+    code = 0;
+    HostTxTable table = takeTxTable(env, env.jvm.nativeMethod<PointerGetter>(
+            "FFIWallet", "jniGetTxTable")(env.jEnv, fixture.wallet, env.error));
+    EXPECT_EQ(0, code);
+    std::map<std::pair<jint, jlong>, TxObject> txs = readTxObjects(env, fixture.wallet);
+    EXPECT_EQ(40 + 5 + 7 + 6, txs.size());
+    EXPECT_EQ(txs.size(), table.size());
+    EXPECT_EQ(static_cast<jint>(table.size()), table.totalRowCount);
+    for (size_t row = 0; row < table.size(); row++) {
+        jint kind = table.intColumns[kTxTableKindColumn][row];
+        auto found = txs.find(std::make_pair(kind, table.id(row)));
+        EXPECT_TRUE(found != txs.end());
+        if (found == txs.end()) {
+            continue;
+        }
+        const TxObject &tx = found->second;
+        EXPECT_EQ(tx.amount, table.longColumns[kTxTableAmount][row]);
+        EXPECT_EQ(tx.fee, table.longColumns[kTxTableFee][row]);
+        EXPECT_EQ(tx.timestamp, table.longColumns[kTxTableTimestamp][row]);
+        EXPECT_EQ(tx.status, table.intColumns[kTxTableStatus][row]);
+        EXPECT_EQ(tx.outbound ? 1 : 0, table.intColumns[kTxTableOutbound][row]);
+        EXPECT_TRUE(tx.message == table.message(row));
+        EXPECT_TRUE(tx.counterparty == table.counterparty(row));
+        EXPECT_EQ(kTxTableInserted, table.intColumns[kTxTableChangeColumn][row]);
+        txs.erase(found);
+    }
+    EXPECT_EQ(0, txs.size());
+}
+
+typedef jlong (*ChangesSinceMethod)(JNIEnv *, jobject, jlong, jobject);
+
+static int findRow(const HostTxTable &table, jlong id) {
+    for (size_t row = 0; row < table.size(); row++) {
+        if (table.id(row) == id) {
+            return static_cast<int>(row);
+        }
+    }
+    return -1;
+}
+
+/**
+ * First row of the given kind and status, -1 if there is none.
+ */
+static int findRow(const HostTxTable &table, jint kind, jint status) {
+    for (size_t row = 0; row < table.size(); row++) {
+        if (table.intColumns[kTxTableKindColumn][row] == kind
+            && table.intColumns[kTxTableStatus][row] == status) {
+            return static_cast<int>(row);
+        }
+    }
+    return -1;
+}
+
+/**
+ * The tx cache reports rows inserted, updated and removed after a generation, whether they were
+ * recorded from callbacks and entry points or found by the resync after the cache went stale.
+ */
+static void testTxChangesSince(TestEnv &env) {
+    WalletFixture fixture(env, smallWalletConfig());
+    HostJvm &jvm = env.jvm;
+    auto getChanges = jvm.nativeMethod<ChangesSinceMethod>("FFIWallet", "jniGetTxChangesSince");
+    auto changesSince = [&](jlong since) {
+        return takeTxTable(env, getChanges(env.jEnv, fixture.wallet, since, env.error));
+    };
+    const jint kStatusCompleted = 0;
+    const jint kStatusMined = 2;
+    const jint kStatusPending = 4;
+
+    HostTxTable full = changesSince(0);
+    EXPECT_EQ(10, full.size());
+    for (size_t row = 0; row < full.size(); row++) {
+        EXPECT_EQ(kTxTableInserted, full.intColumns[kTxTableChangeColumn][row]);
+    }
+    EXPECT_TRUE(full.generation > 0);
+    HostTxTable unchanged = changesSince(full.generation);
+    EXPECT_EQ(0, unchanged.size());
+    EXPECT_EQ(full.generation, unchanged.generation);
+
+    // changes made behind the cache's back are found by the resync after a validation
+    int error = 0;
+    auto splitId = static_cast<jlong>(wallet_coin_split(fixture.pWallet, 1000, 2, 10, "split", 0,
+                                                        &error));
+    int inboundRow = findRow(full, kTxTablePendingInbound, kStatusPending);
+    jlong removedId = full.id(inboundRow);
+    EXPECT_TRUE(stubWalletRemoveTx(fixture.pWallet, static_cast<unsigned long long>(removedId)));
+    jlong movedId = -1;
+    for (size_t row = 0; row < full.size(); row++) {
+        if (full.intColumns[kTxTableKindColumn][row] == kTxTablePendingInbound
+            && full.id(row) != removedId) {
+            movedId = full.id(row);
+        }
+    }
+    EXPECT_TRUE(wallet_cancel_pending_transaction(fixture.pWallet, movedId, &error));
+    EXPECT_EQ(0, error);
+    EXPECT_TRUE(stubWalletEmitCallback(fixture.pWallet, kStubTxoValidationComplete, 1));
+    HostTxTable resynced = changesSince(unchanged.generation);
+    EXPECT_EQ(3, resynced.size());
+    int splitRow = findRow(resynced, splitId);
+    int removedRow = findRow(resynced, removedId);
+    int movedRow = findRow(resynced, movedId);
+    EXPECT_TRUE(splitRow >= 0 && removedRow >= 0 && movedRow >= 0);
+    if (splitRow >= 0 && removedRow >= 0 && movedRow >= 0) {
+        EXPECT_EQ(kTxTableInserted, resynced.intColumns[kTxTableChangeColumn][splitRow]);
+        EXPECT_EQ(kTxTableCompleted, resynced.intColumns[kTxTableKindColumn][splitRow]);
+        EXPECT_EQ(kTxTableRemoved, resynced.intColumns[kTxTableChangeColumn][removedRow]);
+        EXPECT_EQ(kTxTableUpdated, resynced.intColumns[kTxTableChangeColumn][movedRow]);
+        EXPECT_EQ(kTxTableCancelled, resynced.intColumns[kTxTableKindColumn][movedRow]);
+    }
+
+    // a tx inserted and removed between two calls was never seen by the caller
+    jlong transientId = jvm.nativeMethod<jlong (*)(JNIEnv *, jobject, jlong, jlong, jlong, jstring,
+                                                   jlong, jobject)>(
+            "FFIWallet", "jniCoinSplitU64")(env.jEnv, fixture.wallet, 500, 2, 10,
+                                            jvm.newString("transient"), 0, env.error);
+    EXPECT_TRUE(stubWalletRemoveTx(fixture.pWallet, static_cast<unsigned long long>(transientId)));
+    EXPECT_TRUE(stubWalletEmitCallback(fixture.pWallet, kStubTxValidationComplete, 2));
+    HostTxTable transient = changesSince(resynced.generation);
+    EXPECT_EQ(0, transient.size());
+    EXPECT_TRUE(transient.generation > resynced.generation);
+
+    // a callback updates the row of its tx: the first completed tx gets mined. The stub does not
+    // keep the status a callback announces, so this comes after the resyncs that would revert it.
+    int completedRow = findRow(full, kTxTableCompleted, kStatusCompleted);
+    EXPECT_TRUE(completedRow >= 0);
+    jlong minedId = full.id(completedRow);
+    EXPECT_TRUE(stubWalletEmitCallback(fixture.pWallet, kStubTxMined, 0));
+    // recorded by the dispatcher before it delivers the event
+    EXPECT_TRUE(fixture.waitForDrain());
+    HostTxTable mined = changesSince(transient.generation);
+    EXPECT_EQ(1, mined.size());
+    if (mined.size() == 1) {
+        EXPECT_EQ(minedId, mined.id(0));
+        EXPECT_EQ(kTxTableUpdated, mined.intColumns[kTxTableChangeColumn][0]);
+        EXPECT_EQ(kStatusMined, mined.intColumns[kTxTableStatus][0]);
+    }
+
+    // an entry point refreshes the tx it changed
+    int outboundRow = findRow(full, kTxTablePendingOutbound, kStatusPending);
+    jlong cancelledId = full.id(outboundRow);
+    EXPECT_TRUE(jvm.nativeMethod<jboolean (*)(JNIEnv *, jobject, jlong, jobject)>(
+            "FFIWallet", "jniCancelPendingTxU64")(env.jEnv, fixture.wallet, cancelledId,
+                                                  env.error));
+    HostTxTable cancelled = changesSince(mined.generation);
+    EXPECT_EQ(1, cancelled.size());
+    if (cancelled.size() == 1) {
+        EXPECT_EQ(cancelledId, cancelled.id(0));
+        EXPECT_EQ(kTxTableUpdated, cancelled.intColumns[kTxTableChangeColumn][0]);
+        EXPECT_EQ(kTxTableCancelled, cancelled.intColumns[kTxTableKindColumn][0]);
+    }
+
+    // a generation the cache has not reached, from an earlier wallet, reloads everything
+    HostTxTable reloaded = changesSince(cancelled.generation + 100);
+    EXPECT_EQ(10, reloaded.size());
+    EXPECT_TRUE(findRow(reloaded, removedId) < 0);
+    EXPECT_TRUE(findRow(reloaded, splitId) >= 0);
+    jvm.releaseLocalRefs();
+}
+
+/**
+ * Removals past the tombstone limit drop the oldest tombstones: a caller behind them gets a
+ * complete table, a caller past them still gets the remaining removals as changes.
+ */
+static void testTxTombstoneCompaction(TestEnv &env) {
+    StubWalletConfig config = smallWalletConfig();
+    config.completedTxCount = 0;
+    config.cancelledTxCount = 0;
+    config.pendingInboundTxCount = 0;
+    config.pendingOutboundTxCount = 0;
+    WalletFixture fixture(env, config);
+    TxChangeCache cache;
+    int error = 0;
+    delete cache.changesSince(fixture.pWallet, 0, &error);
+    const unsigned long long kTxCount = 3 * kTxCacheMaxTombstones;
+    for (unsigned long long id = 1; id <= kTxCount; id++) {
+        cache.record(TxRecord{id, 10 * id, 1, id, 2, kTxTableCompleted, false, "m", "aa"});
+    }
+    TxTable *pLoaded = cache.changesSince(fixture.pWallet, 0, &error);
+    EXPECT_EQ(static_cast<jint>(kTxCount), pLoaded->rowCount());
+    EXPECT_TRUE(pLoaded->complete);
+    jlong loaded = pLoaded->generation;
+    delete pLoaded;
+
+    // none of them is in the wallet, the resync removes all of them
+    cache.markStale();
+    TxTable *pBehind = cache.changesSince(fixture.pWallet, loaded, &error);
+    EXPECT_EQ(0, error);
+    EXPECT_TRUE(pBehind->complete);
+    EXPECT_EQ(0, pBehind->rowCount());
+    jlong removed = pBehind->generation;
+    EXPECT_EQ(loaded + static_cast<jlong>(kTxCount), removed);
+    delete pBehind;
+
+    // the newest tombstones survive, up to half the limit
+    const jint kRecent = kTxCacheMaxTombstones / 4;
+    TxTable *pRecent = cache.changesSince(fixture.pWallet, removed - kRecent, &error);
+    EXPECT_TRUE(!pRecent->complete);
+    EXPECT_EQ(kRecent, pRecent->rowCount());
+    for (jint row = 0; row < pRecent->rowCount(); row++) {
+        EXPECT_EQ(kTxTableRemoved, pRecent->intColumns[kTxTableChangeColumn][row]);
+    }
+    delete pRecent;
+    TxTable *pOldest = cache.changesSince(
+            fixture.pWallet, removed - static_cast<jlong>(kTxCacheMaxTombstones) / 2, &error);
+    EXPECT_TRUE(!pOldest->complete);
+    EXPECT_EQ(static_cast<jint>(kTxCacheMaxTombstones / 2), pOldest->rowCount());
+    delete pOldest;
+    TxTable *pCompacted = cache.changesSince(
+            fixture.pWallet, removed - static_cast<jlong>(kTxCacheMaxTombstones) / 2 - 1, &error);
+    EXPECT_TRUE(pCompacted->complete);
+    delete pCompacted;
+}
+
+/**
+ * Readers arriving while the first one resyncs the stale cache wait for it instead of reading
+ * the cache half seeded.
+ */
+static void testTxResyncConcurrentReaders(TestEnv &env) {
+    StubWalletConfig config = smallWalletConfig();
+    config.completedTxCount = 500;
+    // makes the resync take long enough for the readers to overlap it
+    config.callLatencyNanos = 20000;
+    WalletFixture fixture(env, config);
+    HostJvm &jvm = env.jvm;
+    jobject wallet = fixture.wallet;
+    const int kReaderCount = 4;
+    // looked up here, nativeMethod marks the native used without holding the VM lock
+    auto changesSince = jvm.nativeMethod<ChangesSinceMethod>("FFIWallet", "jniGetTxChangesSince");
+    auto getRowCount = jvm.nativeMethod<jint (*)(JNIEnv *, jobject)>("FFITxTable",
+                                                                    "jniGetRowCount");
+    auto tableDestroy = jvm.nativeMethod<VoidMethod>("FFITxTable", "jniDestroy");
+    for (int round = 0; round < 2; round++) {
+        std::vector<jint> rowCounts(kReaderCount, -1);
+        std::vector<std::thread> readers;
+        for (int n = 0; n < kReaderCount; n++) {
+            readers.emplace_back([&, n]() {
+                JNIEnv *jEnv = jvm.attachCurrentThread();
+                jobject error = jvm.newObject("FFIError");
+                jobject table = jvm.newObject("FFITxTable");
+                HostJvm::unwrap(table)->pointer = changesSince(jEnv, wallet, 0, error);
+                rowCounts[n] = getRowCount(jEnv, table);
+                tableDestroy(jEnv, table);
+                jvm.releaseLocalRefs();
+                jvm.getJavaVm()->DetachCurrentThread();
+            });
+        }
+        for (std::thread &reader : readers) {
+            reader.join();
+        }
+        for (jint rowCount : rowCounts) {
+            EXPECT_EQ(500 + 2 + 2 + 2, rowCount);
+        }
+        // the second round starts from a cache marked stale by a validation
+        stubWalletEmitCallback(fixture.pWallet, kStubTxValidationComplete, 1);
+    }
+    stubWalletConfigure(smallWalletConfig());
+}
+
+/**
+ * Pages of the merged history follow the sort key with ties broken by id, reversed as a whole
+ * when descending, hold only the selected kinds and cut the same ordering at any offset.
+ */
+static void testTxPage(TestEnv &env) {
+    StubWalletConfig config = smallWalletConfig();
+    config.completedTxCount = 12;
+    config.cancelledTxCount = 4;
+    config.pendingInboundTxCount = 5;
+    config.pendingOutboundTxCount = 3;
+    WalletFixture fixture(env, config);
+    HostJvm &jvm = env.jvm;
+    auto getTxPage = jvm.nativeMethod<jlong (*)(JNIEnv *, jobject, jint, jboolean, jint, jint,
+                                                jint, jobject)>("FFIWallet", "jniGetTxPage");
+    HostTxTable table = takeTxTable(env, jvm.nativeMethod<PointerGetter>(
+            "FFIWallet", "jniGetTxTable")(env.jEnv, fixture.wallet, env.error));
+    EXPECT_EQ(24, table.size());
+    const jint kAllKinds = (1 << kTxTableCompleted) | (1 << kTxTableCancelled)
+                           | (1 << kTxTablePendingInbound) | (1 << kTxTablePendingOutbound);
+    const jint kKindMasks[] = {
+            kAllKinds,
+            1 << kTxTableCompleted,
+            (1 << kTxTablePendingInbound) | (1 << kTxTablePendingOutbound),
+            0
+    };
+    const jint kLimit = 5;
+    bool sawTie = false;
+    for (jint key = 0; key < kTxSortKeyCount; key++) {
+        const std::vector<jlong> &column =
+                key == kTxSortByAmount ? table.longColumns[kTxTableAmount]
+                                       : table.longColumns[kTxTableTimestamp];
+        auto sortValue = [&](size_t row) {
+            return key == kTxSortByStatus ? static_cast<jlong>(table.intColumns[kTxTableStatus][row])
+                                          : column[row];
+        };
+        for (jint kindMask : kKindMasks) {
+            std::vector<size_t> rows;
+            for (size_t row = 0; row < table.size(); row++) {
+                if ((kindMask & (1 << table.intColumns[kTxTableKindColumn][row])) != 0) {
+                    rows.push_back(row);
+                }
+            }
+            std::sort(rows.begin(), rows.end(), [&](size_t a, size_t b) {
+                if (sortValue(a) != sortValue(b)) {
+                    return sortValue(a) < sortValue(b);
+                }
+                return static_cast<unsigned long long>(table.id(a))
+                       < static_cast<unsigned long long>(table.id(b));
+            });
+            for (size_t n = 1; n < rows.size(); n++) {
+                sawTie = sawTie || sortValue(rows[n - 1]) == sortValue(rows[n]);
+            }
+            for (jboolean descending : {JNI_FALSE, JNI_TRUE}) {
+                std::vector<jlong> expected;
+                for (size_t row : rows) {
+                    expected.push_back(table.id(row));
+                }
+                if (descending) {
+                    std::reverse(expected.begin(), expected.end());
+                }
+                std::vector<jlong> paged;
+                for (jint offset = 0; offset <= static_cast<jint>(expected.size()) + kLimit;
+                     offset += kLimit) {
+                    HostTxTable page = takeTxTable(env, getTxPage(env.jEnv, fixture.wallet, key,
+                                                                  descending, kindMask, offset,
+                                                                  kLimit, env.error));
+                    EXPECT_EQ(expected.size(), page.totalRowCount);
+                    size_t remaining = expected.size() > static_cast<size_t>(offset)
+                                       ? expected.size() - offset : 0;
+                    EXPECT_EQ(std::min(remaining, static_cast<size_t>(kLimit)), page.size());
+                    for (size_t row = 0; row < page.size(); row++) {
+                        paged.push_back(page.id(row));
+                    }
+                }
+                EXPECT_TRUE(paged == expected);
+            }
+        }
+    }
+    // equal timestamps, amounts and statuses across kinds exercise the tie-break
+    EXPECT_TRUE(sawTie);
+
+    // a window across the end is cut short, one past it is empty
+    HostTxTable tail = takeTxTable(env, getTxPage(env.jEnv, fixture.wallet, kTxSortByTimestamp,
+                                                  JNI_TRUE, kAllKinds, 22, 10, env.error));
+    EXPECT_EQ(2, tail.size());
+    EXPECT_EQ(24, tail.totalRowCount);
+    HostTxTable past = takeTxTable(env, getTxPage(env.jEnv, fixture.wallet, kTxSortByTimestamp,
+                                                  JNI_TRUE, kAllKinds, 24, 10, env.error));
+    EXPECT_EQ(0, past.size());
+    EXPECT_EQ(24, past.totalRowCount);
+}
+
+/**
+ * The per-kind sorted indexes follow txs that change kind, sort value or come back after a
+ * removal as record() moves them, and a resync that removes them all empties every page.
+ */
+static void testTxPageIncremental(TestEnv &env) {
+    StubWalletConfig config = smallWalletConfig();
+    config.completedTxCount = 0;
+    config.cancelledTxCount = 0;
+    config.pendingInboundTxCount = 0;
+    config.pendingOutboundTxCount = 0;
+    WalletFixture fixture(env, config);
+    TxChangeCache cache;
+    int error = 0;
+    // seeds the cache from the empty wallet, so that it is no longer stale
+    delete cache.page(fixture.pWallet, kTxSortByTimestamp, false, 0, 0, 0, &error);
+    EXPECT_EQ(0, error);
+    std::mt19937 random(20201018);
+    std::map<unsigned long long, TxRecord> shadow;
+    for (int step = 1; step <= 3000; step++) {
+        TxRecord record;
+        record.id = random() % 400;
+        record.kind = static_cast<TxTableKind>(random() % kTxTableKindCount);
+        // narrow ranges, so that ties fall back to the id
+        record.amount = random() % 50;
+        record.fee = 0;
+        record.timestamp = random() % 50;
+        record.status = static_cast<jint>(random() % 7);
+        record.isOutbound = (random() & 1) != 0;
+        cache.record(record);
+        shadow[record.id] = record;
+        if (step % 250 != 0) {
+            continue;
+        }
+        for (jint key = 0; key < kTxSortKeyCount; key++) {
+            for (jint kindMask : {15, 1, 6, 9}) {
+                std::vector<const TxRecord *> expected;
+                for (const auto &item : shadow) {
+                    if ((kindMask & (1 << item.second.kind)) != 0) {
+                        expected.push_back(&item.second);
+                    }
+                }
+                std::sort(expected.begin(), expected.end(),
+                          [key](const TxRecord *a, const TxRecord *b) {
+                              auto value = [key](const TxRecord *record) {
+                                  return key == kTxSortByAmount ? record->amount
+                                         : key == kTxSortByStatus
+                                           ? static_cast<unsigned long long>(record->status)
+                                           : record->timestamp;
+                              };
+                              return value(a) != value(b) ? value(a) < value(b) : a->id < b->id;
+                          });
+                for (bool descending : {false, true}) {
+                    if (descending) {
+                        std::reverse(expected.begin(), expected.end());
+                    }
+                    for (jint offset : {0, 7, 100, static_cast<jint>(expected.size()) - 3}) {
+                        if (offset < 0) {
+                            continue;
+                        }
+                        TxTable *pPage = cache.page(fixture.pWallet, static_cast<TxSortKey>(key),
+                                                    descending, kindMask, offset, 20, &error);
+                        EXPECT_EQ(static_cast<jint>(expected.size()), pPage->totalRowCount);
+                        auto first = static_cast<size_t>(offset);
+                        size_t rows = first < expected.size()
+                                      ? std::min(static_cast<size_t>(20), expected.size() - first)
+                                      : 0;
+                        EXPECT_EQ(static_cast<jint>(rows), pPage->rowCount());
+                        rows = std::min(rows, static_cast<size_t>(pPage->rowCount()));
+                        for (size_t row = 0; row < rows; row++) {
+                            EXPECT_EQ(static_cast<jlong>(expected[offset + row]->id),
+                                      pPage->longColumns[kTxTableId][row]);
+                        }
+                        delete pPage;
+                    }
+                }
+            }
+        }
+    }
+    // none of the recorded txs is in the wallet, the resync removes them from every index
+    cache.markStale();
+    TxTable *pPage = cache.page(fixture.pWallet, kTxSortByAmount, true, 15, 0, 20, &error);
+    EXPECT_EQ(0, error);
+    EXPECT_EQ(0, pPage->totalRowCount);
+    EXPECT_EQ(0, pPage->rowCount());
+    delete pPage;
+}
+
+/**
+ * Ranking of the search index over known documents: word starts over inner matches, message and
+ * alias hits over either alone, recency on ties, for trigram, bigram and single byte queries.
+ */
+static void testTxSearchIndex(TestEnv &) {
+    typedef std::vector<unsigned long long> Ids;
+    TxSearchIndex index;
+    index.put(1, 100, "Coffee beans", "aa");
+    index.put(2, 200, "Lunch at the cafe", "bb");
+    index.put(3, 300, "decaf COFFEE", "cc");
+    index.put(4, 400, "Rent", "dd");
+    index.put(5, 50, "Toffee", "bb");
+    index.put(6, 10, "coffee refund", "bb");
+    index.setAlias("bb", "Coffee Shop");
+    index.setAlias("dd", "Landlord");
+
+    // 6 matches by message and alias, the rest by one of them, newest first
+    EXPECT_TRUE(index.query("coffee", 10) == Ids({6, 3, 2, 1, 5}));
+    EXPECT_TRUE(index.query("coffee", 2) == Ids({6, 3}));
+    // "cafe" starts a word, "decaf" only contains it
+    EXPECT_TRUE(index.query("CAF", 10) == Ids({2, 3}));
+    EXPECT_TRUE(index.query("land", 10) == Ids({4}));
+    EXPECT_TRUE(index.query("coffee bean", 10) == Ids({1}));
+    // every trigram of the query is indexed, the text is not
+    EXPECT_TRUE(index.query("fee cof", 10).empty());
+    EXPECT_TRUE(index.query("", 10).empty());
+    EXPECT_TRUE(index.query("coffee", 0).empty());
+
+    // bigrams: "re" starts a word twice, "ee" is inside words and the alias of bb
+    EXPECT_TRUE(index.query("re", 10) == Ids({4, 6}));
+    EXPECT_TRUE(index.query("ee", 10) == Ids({5, 6, 3, 2, 1}));
+    // single bytes: "r" of 4 also hits inside its alias
+    EXPECT_TRUE(index.query("r", 10) == Ids({4, 6}));
+    EXPECT_TRUE(index.query("t", 10) == Ids({2, 5, 4}));
+
+    index.remove(3);
+    EXPECT_TRUE(index.query("caf", 10) == Ids({2}));
+    index.put(2, 200, "Lunch", "bb");
+    EXPECT_TRUE(index.query("caf", 10).empty());
+    index.setAlias("bb", "");
+    EXPECT_TRUE(index.query("coffee", 10) == Ids({1, 6}));
+    index.replaceAliases({{"aa", "Barista"}});
+    EXPECT_TRUE(index.query("bar", 10) == Ids({1}));
+    EXPECT_TRUE(index.query("land", 10).empty());
+    index.clear();
+    EXPECT_TRUE(index.query("coffee", 10).empty());
+
+    // the pruned walk ranks like scoring every doc, with docs indexed out of time order, updates,
+    // removals and aliases matching some of the contacts
+    std::mt19937 random(20261018);
+    const char *words[] = {"ab", "abc", "bca", "cab", "b", "a c", "cc"};
+    std::map<unsigned long long, std::pair<unsigned long long, std::string>> messages;
+    std::map<unsigned long long, std::string> contacts;
+    std::map<std::string, std::string> aliases = {{"k1", "bab"}, {"k3", "c a"}};
+    index.replaceAliases({aliases.begin(), aliases.end()});
+    for (int step = 0; step < 2000; step++) {
+        unsigned long long id = random() % 300;
+        if (random() % 8 == 0) {
+            index.remove(id);
+            messages.erase(id);
+            contacts.erase(id);
+            continue;
+        }
+        std::string message;
+        for (unsigned int count = random() % 4; count > 0; count--) {
+            message += std::string(message.empty() ? "" : " ") + words[random() % 7];
+        }
+        unsigned long long timestamp = random() % 100;
+        std::string contact = "k" + std::to_string(random() % 5);
+        index.put(id, timestamp, message, contact);
+        messages[id] = std::make_pair(timestamp, message);
+        contacts[id] = contact;
+    }
+    auto score = [](const std::string &text, const std::string &needle) {
+        int best = 0;
+        for (size_t at = text.find(needle); at != std::string::npos;
+             at = text.find(needle, at + 1)) {
+            best = std::max(best, at == 0 || text[at - 1] == ' ' ? 2 : 1);
+        }
+        return best;
+    };
+    for (const char *needle : {"a", "b", "c", " ", "ab", "ca", "bc", "abc", "b c", "a c a", "x"}) {
+        std::vector<std::pair<int, std::pair<unsigned long long, unsigned long long>>> ranked;
+        for (const auto &message : messages) {
+            auto alias = aliases.find(contacts[message.first]);
+            int total = score(message.second.second, needle)
+                        + (alias == aliases.end() ? 0 : score(alias->second, needle));
+            if (total > 0) {
+                ranked.push_back({total, {message.second.first, message.first}});
+            }
+        }
+        std::sort(ranked.rbegin(), ranked.rend());
+        for (size_t limit : {1, 5, 20, 1000}) {
+            Ids expected;
+            for (size_t k = 0; k < std::min(limit, ranked.size()); k++) {
+                expected.push_back(ranked[k].second.second);
+            }
+            EXPECT_TRUE(index.query(needle, limit) == expected);
+        }
+    }
+}
+
+/**
+ * Updates of one transaction within the coalescing window are delivered once, with the newest
+ * confirmation count, and the handles of the replaced updates are destroyed.
+ */
+static void testConfirmationCoalescing(TestEnv &env) {
+    StubWalletConfig config = smallWalletConfig();
+    WalletFixture fixture(env, config);
+    env.jvm.nativeMethod<void (*)(JNIEnv *, jobject, jlong)>(
+            "FFIWallet", "jniSetConfirmationCoalescingWindow")(env.jEnv, fixture.wallet, 200);
+    // indexes 0, 4 and 8 raise the first transaction with 0, 1 and 2 confirmations
+    for (unsigned int index = 0; index <= 2 * config.completedTxCount;
+         index += config.completedTxCount) {
+        EXPECT_TRUE(stubWalletEmitCallback(fixture.pWallet, kStubTxMinedUnconfirmed, index));
+    }
+    EXPECT_TRUE(fixture.waitForDrain());
+    std::vector<DeliveredEvent> events = env.log.take();
+    EXPECT_EQ(1, events.size());
+    if (!events.empty()) {
+        EXPECT_EQ(kEventTxMinedUnconfirmed, events[0].type);
+        EXPECT_EQ(2, events[0].arg1);
+    }
+    EXPECT_EQ(0, liveHandles(env, kHandleCompletedTx));
+}
+
+/**
+ * Events posted through the native queue from several wallet threads at once are all delivered,
+ * and the queue latency stats never go negative although events arrive while the dispatcher
+ * assembles a batch.
+ */
+static void testEventQueueLatency(TestEnv &env) {
+    WalletFixture fixture(env, smallWalletConfig());
+    auto getQueueStats = env.jvm.nativeMethod<LongArrayMethod>("FFIWallet",
+                                                               "jniGetEventQueueStats");
+    auto readStats = [&](jlong *stats) {
+        env.jEnv->GetLongArrayRegion(getQueueStats(env.jEnv, fixture.wallet), 0,
+                                     kWalletEventStatCount, stats);
+        env.jvm.releaseLocalRefs();
+    };
+    jlong before[kWalletEventStatCount];
+    readStats(before);
+    const int kThreadCount = 4;
+    const unsigned int kEventsPerThread = 500;
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < kThreadCount; thread++) {
+        threads.emplace_back([&fixture]() {
+            for (unsigned int n = 0; n < kEventsPerThread; n++) {
+                stubWalletEmitCallback(fixture.pWallet, kStubDirectSendResult, n);
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    EXPECT_TRUE(fixture.waitForDrain());
+    jlong after[kWalletEventStatCount];
+    readStats(after);
+    std::vector<DeliveredEvent> events = env.log.take();
+    EXPECT_EQ(kThreadCount * kEventsPerThread, events.size());
+    jlong dispatched = after[kStatDispatched] - before[kStatDispatched];
+    EXPECT_EQ(static_cast<jlong>(kThreadCount * kEventsPerThread), dispatched);
+    EXPECT_TRUE(after[kStatBatches] > before[kStatBatches]);
+    jlong totalLatency = after[kStatTotalLatencyNanos] - before[kStatTotalLatencyNanos];
+    EXPECT_TRUE(totalLatency >= 0);
+    EXPECT_TRUE(after[kStatMaxLatencyNanos] >= 0);
+    EXPECT_TRUE(after[kStatMaxLatencyNanos] * dispatched >= totalLatency);
+}
+
+/**
+ * A mined event drops the pending mined-unconfirmed update of the same transaction and destroys
+ * its handle, so the update cannot be delivered after the newer state.
+ */
+static void testConfirmationSupersededByMined(TestEnv &env) {
+    WalletFixture fixture(env, smallWalletConfig());
+    env.jvm.nativeMethod<void (*)(JNIEnv *, jobject, jlong)>(
+            "FFIWallet", "jniSetConfirmationCoalescingWindow")(env.jEnv, fixture.wallet, 200);
+    EXPECT_TRUE(stubWalletEmitCallback(fixture.pWallet, kStubTxMinedUnconfirmed, 1));
+    EXPECT_TRUE(stubWalletEmitCallback(fixture.pWallet, kStubTxMined, 1));
+    EXPECT_TRUE(fixture.waitForDrain());
+    std::vector<DeliveredEvent> events = env.log.take();
+    EXPECT_EQ(1, events.size());
+    if (!events.empty()) {
+        EXPECT_EQ(kEventTxMined, events[0].type);
+    }
+    // the handle of the dropped update was destroyed natively
+    EXPECT_EQ(0, liveHandles(env, kHandleCompletedTx));
+}
+
+/**
+ * Amounts, fees and counts of 2^63 and above are rejected by the *U64 entry points, which see
+ * them as negative bits, and by their decimal shims alike. Ids keep the full 64-bit range.
+ */
+static void testUnsignedArgumentContract(TestEnv &env) {
+    WalletFixture fixture(env, smallWalletConfig());
+    HostJvm &jvm = env.jvm;
+    jint &code = HostJvm::unwrap(env.error)->code;
+    auto estimateU64 = jvm.nativeMethod<jlong (*)(JNIEnv *, jobject, jlong, jlong, jlong, jlong,
+                                                  jobject)>("FFIWallet", "jniEstimateTxFeeU64");
+    auto estimate = jvm.nativeMethod<jlong (*)(JNIEnv *, jobject, jstring, jstring, jstring,
+                                               jstring, jobject)>("FFIWallet", "jniEstimateTxFee");
+
+    code = 0;
+    EXPECT_EQ(100 * (10 + 20), estimateU64(env.jEnv, fixture.wallet, 1000, 100, 1, 1, env.error));
+    EXPECT_EQ(0, code);
+    for (jlong bits : {-1LL, static_cast<long long>(INT64_MIN)}) {
+        code = 0;
+        estimateU64(env.jEnv, fixture.wallet, bits, 100, 1, 1, env.error);
+        EXPECT_EQ(kErrorInvalidArgument, code);
+        code = 0;
+        estimateU64(env.jEnv, fixture.wallet, 1000, 100, 1, bits, env.error);
+        EXPECT_EQ(kErrorInvalidArgument, code);
+    }
+
+    code = 0;
+    EXPECT_EQ(100 * (10 + 20),
+              estimate(env.jEnv, fixture.wallet, jvm.newString("1000"), jvm.newString("100"),
+                       jvm.newString("1"), jvm.newString("1"), env.error));
+    EXPECT_EQ(0, code);
+    for (const char *amount : {"9223372036854775808", "18446744073709551615",
+                               "18446744073709551616", "-1", ""}) {
+        code = 0;
+        estimate(env.jEnv, fixture.wallet, jvm.newString(amount), jvm.newString("100"),
+                 jvm.newString("1"), jvm.newString("1"), env.error);
+        EXPECT_EQ(kErrorInvalidArgument, code);
+    }
+    code = 0;
+    estimate(env.jEnv, fixture.wallet, jvm.newString("9223372036854775807"), jvm.newString("1"),
+             jvm.newString("1"), jvm.newString("1"), env.error);
+    EXPECT_EQ(0, code);
+
+    // an id with the top bit set is looked up, not rejected
+    auto getByIdU64 = jvm.nativeMethod<jlong (*)(JNIEnv *, jobject, jlong, jobject)>(
+            "FFIWallet", "jniGetCompletedTxByIdU64");
+    auto getById = jvm.nativeMethod<jlong (*)(JNIEnv *, jobject, jstring, jobject)>(
+            "FFIWallet", "jniGetCompletedTxById");
+    code = 0;
+    EXPECT_EQ(0, getByIdU64(env.jEnv, fixture.wallet, -1, env.error));
+    EXPECT_TRUE(code != 0 && code != kErrorInvalidArgument);
+    code = 0;
+    EXPECT_EQ(0, getById(env.jEnv, fixture.wallet, jvm.newString("18446744073709551615"),
+                         env.error));
+    EXPECT_TRUE(code != 0 && code != kErrorInvalidArgument);
+    jvm.releaseLocalRefs();
+}
+
+/**
+ * The binary kernel export of every completed tx holds the fields the per-field hex getters
+ * return, and a destination shorter than the three fields is rejected untouched.
+ */
+static void testKernelBytes(TestEnv &env) {
+    WalletFixture fixture(env, smallWalletConfig());
+    HostJvm &jvm = env.jvm;
+    jint &code = HostJvm::unwrap(env.error)->code;
+    // excess, public nonce and signature, 32 bytes each
+    const jsize kKernelBytes = 3 * 32;
+    auto getById = jvm.nativeMethod<jlong (*)(JNIEnv *, jobject, jlong, jobject)>(
+            "FFIWallet", "jniGetCompletedTxByIdU64");
+    auto getBytes = jvm.nativeMethod<void (*)(JNIEnv *, jobject, jbyteArray, jobject)>(
+            "FFICompletedTxKernel", "jniGetBytes");
+    const char *kFieldGetters[] = {
+            "jniGetExcess", "jniGetExcessPublicNonce", "jniGetExcessSignature"
+    };
+    HostTxTable table = takeTxTable(env, jvm.nativeMethod<PointerGetter>(
+            "FFIWallet", "jniGetTxTable")(env.jEnv, fixture.wallet, env.error));
+    int checked = 0;
+    for (size_t row = 0; row < table.size(); row++) {
+        if (table.intColumns[kTxTableKindColumn][row] != kTxTableCompleted) {
+            continue;
+        }
+        jobject tx = jvm.newObject("FFICompletedTx");
+        HostJvm::unwrap(tx)->pointer = getById(env.jEnv, fixture.wallet, table.id(row), env.error);
+        jobject kernel = jvm.newObject("FFICompletedTxKernel");
+        HostJvm::unwrap(kernel)->pointer = jvm.nativeMethod<PointerGetter>(
+                "FFICompletedTx", "jniGetTransactionKernel")(env.jEnv, tx, env.error);
+        code = 0;
+        jbyteArray bytes = jvm.newByteArray(kKernelBytes + 4);
+        getBytes(env.jEnv, kernel, bytes, env.error);
+        EXPECT_EQ(0, code);
+        const std::vector<unsigned char> &data = HostJvm::unwrap(bytes)->data;
+        std::string hex;
+        char digits[3];
+        for (jsize k = 0; k < kKernelBytes; k++) {
+            snprintf(digits, sizeof(digits), "%02X", data[k]);
+            hex += digits;
+        }
+        std::string fields;
+        for (const char *getter : kFieldGetters) {
+            fields += HostJvm::toUtf8(jvm.nativeMethod<StringGetter>(
+                    "FFICompletedTxKernel", getter)(env.jEnv, kernel, env.error));
+        }
+        for (char &c : fields) {
+            c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+        }
+        EXPECT_TRUE(hex == fields);
+        for (jsize k = kKernelBytes; k < kKernelBytes + 4; k++) {
+            EXPECT_EQ(0, data[k]);
+        }
+
+        jbyteArray shortBytes = jvm.newByteArray(kKernelBytes - 1);
+        getBytes(env.jEnv, kernel, shortBytes, env.error);
+        EXPECT_EQ(kErrorInvalidArgument, code);
+        for (unsigned char value : HostJvm::unwrap(shortBytes)->data) {
+            EXPECT_EQ(0, value);
+        }
+        jvm.nativeMethod<VoidMethod>("FFICompletedTxKernel", "jniDestroy")(env.jEnv, kernel);
+        jvm.nativeMethod<VoidMethod>("FFICompletedTx", "jniDestroy")(env.jEnv, tx);
+        jvm.releaseLocalRefs();
+        checked++;
+    }
+    EXPECT_EQ(smallWalletConfig().completedTxCount, checked);
+}
+
+/**
+ * A snapshot that overflows the buffer returns at least twice the capacity, so growing the buffer
+ * to the returned size fits the whole collection in a few calls, and the size returned once it
+ * fits is the exact size written.
+ */
+static void testTxSnapshotOverflow(TestEnv &env) {
+    StubWalletConfig config = smallWalletConfig();
+    config.completedTxCount = 500;
+    WalletFixture fixture(env, config);
+    HostJvm &jvm = env.jvm;
+    jint &code = HostJvm::unwrap(env.error)->code;
+    auto writeSnapshot = jvm.nativeMethod<jint (*)(JNIEnv *, jobject, jobject, jobject)>(
+            "FFICompletedTxs", "jniWriteSnapshot");
+    jobject collection = jvm.newObject("FFICompletedTxs");
+    HostJvm::unwrap(collection)->pointer = jvm.nativeMethod<PointerGetter>(
+            "FFIWallet", "jniGetCompletedTxs")(env.jEnv, fixture.wallet, env.error);
+    jlong capacity = 16;
+    jint required = 0;
+    int calls = 0;
+    jint header[4];
+    while (true) {
+        jobject buffer = jvm.newDirectByteBuffer(capacity);
+        code = 0;
+        required = writeSnapshot(env.jEnv, collection, buffer, env.error);
+        EXPECT_EQ(0, code);
+        memcpy(header, HostJvm::unwrap(buffer)->data.data(), sizeof(header));
+        calls++;
+        if (required <= capacity) {
+            break;
+        }
+        EXPECT_TRUE(required >= 2 * capacity);
+        EXPECT_EQ(0, header[1]);
+        EXPECT_EQ(16, header[2]);
+        capacity = required;
+    }
+    EXPECT_TRUE(calls <= 16);
+    EXPECT_EQ(1, header[0]);
+    EXPECT_EQ(static_cast<jint>(config.completedTxCount), header[1]);
+    EXPECT_EQ(required, header[2]);
+    jvm.nativeMethod<VoidMethod>("FFICompletedTxs", "jniDestroy")(env.jEnv, collection);
+    jvm.releaseLocalRefs();
+}
+
+struct HostTest {
+    const char *name;
+    void (*run)(TestEnv &env);
+};
+
+static const HostTest kTests[] = {
+        {"confirmation_coalescing", testConfirmationCoalescing},
+        {"confirmation_superseded_by_mined", testConfirmationSupersededByMined},
+        {"event_queue_latency", testEventQueueLatency},
+        {"unsigned_argument_contract", testUnsignedArgumentContract},
+        {"tx_table_matches_object_model", testTxTableMatchesObjectModel},
+        {"tx_changes_since", testTxChangesSince},
+        {"tx_tombstone_compaction", testTxTombstoneCompaction},
+        {"tx_resync_concurrent_readers", testTxResyncConcurrentReaders},
+        {"tx_page", testTxPage},
+        {"tx_page_incremental", testTxPageIncremental},
+        {"tx_search_index", testTxSearchIndex},
+        {"kernel_bytes", testKernelBytes},
+        {"tx_snapshot_overflow", testTxSnapshotOverflow},
+};
+
+int main(int argc, char **argv) {
+    HostJvm jvm;
+    JNIEnv *jEnv = jvm.attachCurrentThread();
+    EventLog log;
+    jvm.defineVoidMethod("com/tari/android/wallet/ffi/FFIWallet", "onEvents", "([JI)V", onEvents,
+                         &log);
+    if (JNI_OnLoad(jvm.getJavaVm(), nullptr) == JNI_ERR) {
+        fprintf(stderr, "JNI_OnLoad failed.\n");
+        return 1;
+    }
+    jobject error = jvm.newObject("FFIError");
+    log.error = jvm.newObject("FFIError");
+    log.completedTx = jvm.newObject("FFICompletedTx");
+    log.pendingInboundTx = jvm.newObject("FFIPendingInboundTx");
+    jobject ffiUtil = jvm.newObject("FFIUtil");
+    for (jobject object : {error, log.error, log.completedTx, log.pendingInboundTx, ffiUtil}) {
+        jvm.pin(HostJvm::unwrap(object));
+    }
+    log.completedTxGetId = jvm.nativeMethod<LongGetter>("FFICompletedTx", "jniGetId");
+    log.completedTxDestroy = jvm.nativeMethod<VoidMethod>("FFICompletedTx", "jniDestroy");
+    log.pendingInboundTxGetId = jvm.nativeMethod<LongGetter>("FFIPendingInboundTx", "jniGetId");
+    log.pendingInboundTxDestroy = jvm.nativeMethod<VoidMethod>("FFIPendingInboundTx",
+                                                               "jniDestroy");
+    TestEnv env{jvm, jEnv, log, error, ffiUtil};
+
+    int run = 0;
+    for (const HostTest &test : kTests) {
+        bool selected = argc == 1;
+        for (int n = 1; n < argc && !selected; n++) {
+            selected = strcmp(argv[n], test.name) == 0;
+        }
+        if (!selected) {
+            continue;
+        }
+        int failures = g_failures;
+        test.run(env);
+        fprintf(stderr, "%s %s\n", g_failures == failures ? "PASS" : "FAIL", test.name);
+        run++;
+    }
+    if (run == 0) {
+        fprintf(stderr, "No test matches the arguments.\n");
+        return 2;
+    }
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,709 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "hostJni.h"
+#include "stubWallet.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../jniWalletEvents.cpp"
+
+/**
+ * End-to-end load test of the JNI callback and collection paths against the in-memory stub
+ * wallet, run on a Linux host.
+ *
+ * A wallet of --completed transactions (a million by default) is created through
+ * FFIWallet.jniCreate. stubWalletRunLoad then raises the 12 callbacks registered there, plus
+ * recovery progress if given a rate, from --threads library threads at the configured rates,
+ * while --readers threads page through the transaction history. FFIWallet.onEvents consumes the
+ * batches like the Kotlin side does, spending --listener-ns per event.
+ *
+ * Delivery latency runs from the scheduled emission of an event to its handling in onEvents, so
+ * time lost while the raising threads were stalled counts against the JNI layer.
+ *
+ * Usage: jni_load_test [--completed N] [--pending N] [--cancelled N] [--threads N]
+ *                      [--rate NAME=EVENTS_PER_SECOND]... [--rate-all EVENTS_PER_SECOND]
+ *                      [--duration-ms N] [--coalescing-window-ms N] [--listener-ns N]
+ *                      [--readers N] [--latency-ns N] [--ffi-trace FILE] [--call-stats FILE]
+ *                      [--timeline FILE] [--out FILE]
+ *
+ * With --ffi-trace the run is recorded through FFIUtil.startFfiTrace, from wallet creation to
+ * wallet destruction, for ffi_replay. With --call-stats the FFIUtil.dumpCallStats report is
+ * written to FILE at the end, which needs a build with TARI_JNI_CALL_STATS to list anything.
+ * With --timeline the run is recorded through FFIUtil.setTimelineRecording and written to FILE
+ * as a Chrome trace.
+ */
+
+typedef void (*VoidMethod)(JNIEnv *, jobject);
+typedef jlong (*LongGetter)(JNIEnv *, jobject, jobject);
+typedef jint (*IntGetter)(JNIEnv *, jobject, jobject);
+typedef jlongArray (*LongArrayMethod)(JNIEnv *, jobject);
+
+static const char *const kJsonSchema = "tari-jni-load-test/1";
+
+static const char *const kCallbackNames[kStubWalletCallbackCount] = {
+        "received",
+        "replyReceived",
+        "finalized",
+        "broadcast",
+        "mined",
+        "minedUnconfirmed",
+        "directSendResult",
+        "safSendResult",
+        "cancelled",
+        "txoValidation",
+        "txValidation",
+        "safMessage",
+        "recovery"
+};
+
+static const char *const kEventNames[] = {
+        "unknown",
+        "txReceived",
+        "txReplyReceived",
+        "txFinalized",
+        "txBroadcast",
+        "txMined",
+        "txMinedUnconfirmed",
+        "directSendResult",
+        "safSendResult",
+        "txCancelled",
+        "txoValidationComplete",
+        "txValidationComplete",
+        "recovery"
+};
+
+static const int kEventTypeCount = kEventRecovery + 1;
+
+static const long long kDrainTimeoutNanos = 30000000000LL;
+
+/**
+ * Log-linear histogram in the manner of HdrHistogram: values below 64 are counted exactly, larger
+ * ones in 32 sub-buckets per power of two, so every value is recorded within about 3% of its
+ * magnitude. Not thread safe, histograms are merged after the recording threads stopped.
+ */
+class LatencyHistogram {
+public:
+    static const int kSubBucketBits = 5;
+    static const int kSubBucketCount = 1 << kSubBucketBits;
+    static const int kLinearCount = 2 * kSubBucketCount;
+    static const int kBucketCount = kLinearCount + (63 - kSubBucketBits) * kSubBucketCount;
+
+    LatencyHistogram() : counts(kBucketCount, 0) {}
+
+    void record(int64_t value) {
+        value = std::max<int64_t>(value, 0);
+        counts[indexOf(static_cast<uint64_t>(value))]++;
+        count++;
+        total += static_cast<double>(value);
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    void merge(const LatencyHistogram &other) {
+        for (size_t n = 0; n < counts.size(); n++) {
+            counts[n] += other.counts[n];
+        }
+        count += other.count;
+        total += other.total;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+
+    /**
+     * Highest value of the bucket holding the given quantile, never above the recorded maximum.
+     */
+    int64_t percentile(double quantile) const {
+        if (count == 0) {
+            return 0;
+        }
+        auto target = std::max<uint64_t>(
+                static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(count))), 1);
+        uint64_t seen = 0;
+        for (size_t n = 0; n < counts.size(); n++) {
+            seen += counts[n];
+            if (seen >= target) {
+                return std::min(upperBoundOf(n), max);
+            }
+        }
+        return max;
+    }
+
+    /**
+     * Summary object with the unit appended to every value name, minNanos, p99Nanos and so on.
+     */
+    void writeJson(FILE *out, const char *unit) const {
+        fprintf(out, "{\"count\": %llu, \"min%s\": %lld, \"mean%s\": %.0f, \"p50%s\": %lld, "
+                     "\"p90%s\": %lld, \"p99%s\": %lld, \"p999%s\": %lld, \"max%s\": %lld}",
+                static_cast<unsigned long long>(count),
+                unit, static_cast<long long>(count == 0 ? 0 : min),
+                unit, count == 0 ? 0.0 : total / static_cast<double>(count),
+                unit, static_cast<long long>(percentile(0.5)),
+                unit, static_cast<long long>(percentile(0.9)),
+                unit, static_cast<long long>(percentile(0.99)),
+                unit, static_cast<long long>(percentile(0.999)),
+                unit, static_cast<long long>(max));
+    }
+
+    uint64_t count = 0;
+
+private:
+    static size_t indexOf(uint64_t value) {
+        if (value < kLinearCount) {
+            return static_cast<size_t>(value);
+        }
+        int shift = 63 - __builtin_clzll(value) - kSubBucketBits;
+        auto subBucket = static_cast<size_t>(value >> shift) - kSubBucketCount;
+        return kLinearCount + static_cast<size_t>(shift - 1) * kSubBucketCount + subBucket;
+    }
+
+    static int64_t upperBoundOf(size_t index) {
+        if (index < kLinearCount) {
+            return static_cast<int64_t>(index);
+        }
+        size_t shift = (index - kLinearCount) / kSubBucketCount + 1;
+        uint64_t top = (index - kLinearCount) % kSubBucketCount + kSubBucketCount;
+        return static_cast<int64_t>(((top + 1) << shift) - 1);
+    }
+
+    std::vector<uint64_t> counts;
+    double total = 0;
+    int64_t min = INT64_MAX;
+    int64_t max = 0;
+};
+
+struct Options {
+    StubWalletConfig stub = stubWalletDefaultConfig();
+    StubLoadConfig load = StubLoadConfig{};
+    int64_t coalescingWindowMillis = 0;
+    int64_t listenerNanos = 0;
+    unsigned int readers = 1;
+    std::string ffiTrace;
+    std::string callStats;
+    std::string timeline;
+    std::string out;
+};
+
+/**
+ * Consumes FFIWallet.onEvents batches on the dispatcher thread: transaction handles are read and
+ * destroyed through their wrappers, like FFIWallet does, and every event's delivery latency is
+ * recorded from its scheduled emission.
+ */
+struct EventSink {
+    std::atomic<long long> delivered{0};
+    int64_t listenerNanos = 0;
+    jobject completedTx = nullptr;
+    jobject pendingInboundTx = nullptr;
+    jobject error = nullptr;
+    LongGetter completedTxGetId = nullptr;
+    VoidMethod completedTxDestroy = nullptr;
+    LongGetter pendingInboundTxGetId = nullptr;
+    VoidMethod pendingInboundTxDestroy = nullptr;
+    LatencyHistogram latency[kEventTypeCount];
+    LatencyHistogram batchSize;
+};
+
+static void onEvents(JNIEnv *jEnv, jobject, va_list args, void *data) {
+    auto *sink = static_cast<EventSink *>(data);
+    auto jBatch = va_arg(args, jlongArray);
+    jint count = va_arg(args, jint);
+    jlong batch[kWalletEventBatchSize * kWalletEventStride];
+    jEnv->GetLongArrayRegion(jBatch, 0, count * kWalletEventStride, batch);
+    sink->batchSize.record(count);
+    for (jint n = 0; n < count; n++) {
+        const jlong *record = batch + n * kWalletEventStride;
+        jlong type = record[0];
+        int64_t emitNanos = 0;
+        switch (type) {
+            case kEventTxReceived:
+                emitNanos = stubWalletEmitNanos(
+                        reinterpret_cast<TariPendingInboundTransaction *>(record[1]));
+                HostJvm::unwrap(sink->pendingInboundTx)->pointer = record[1];
+                sink->pendingInboundTxGetId(jEnv, sink->pendingInboundTx, sink->error);
+                sink->pendingInboundTxDestroy(jEnv, sink->pendingInboundTx);
+                break;
+            case kEventTxReplyReceived:
+            case kEventTxFinalized:
+            case kEventTxBroadcast:
+            case kEventTxMined:
+            case kEventTxMinedUnconfirmed:
+            case kEventTxCancelled:
+                emitNanos = stubWalletEmitNanos(reinterpret_cast<TariCompletedTransaction *>(record[1]));
+                HostJvm::unwrap(sink->completedTx)->pointer = record[1];
+                sink->completedTxGetId(jEnv, sink->completedTx, sink->error);
+                sink->completedTxDestroy(jEnv, sink->completedTx);
+                break;
+            case kEventDirectSendResult:
+            case kEventStoreAndForwardSendResult:
+            case kEventTxoValidationComplete:
+            case kEventTxValidationComplete:
+                emitNanos = record[1];
+                break;
+            case kEventRecovery:
+                emitNanos = record[2];
+                break;
+            default:
+                break;
+        }
+        if (sink->listenerNanos > 0) {
+            int64_t end = stubWalletNowNanos() + sink->listenerNanos;
+            while (stubWalletNowNanos() < end) {
+            }
+        }
+        if (emitNanos > 0 && type > 0 && type < kEventTypeCount) {
+            sink->latency[type].record(stubWalletNowNanos() - emitNanos);
+        }
+    }
+    sink->delivered.fetch_add(count);
+}
+
+static bool parseRate(const char *value, StubLoadConfig &load) {
+    const char *separator = strchr(value, '=');
+    if (separator == nullptr) {
+        return false;
+    }
+    std::string name(value, separator);
+    for (int callback = 0; callback < kStubWalletCallbackCount; callback++) {
+        if (name == kCallbackNames[callback]) {
+            load.eventsPerSecond[callback] = atof(separator + 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parseOptions(int argc, char **argv, Options &options) {
+    options.stub.completedTxCount = 1000000;
+    options.stub.cancelledTxCount = 10000;
+    options.stub.pendingInboundTxCount = 10000;
+    options.stub.pendingOutboundTxCount = 10000;
+    options.load.threadCount = 4;
+    options.load.durationNanos = 5000000000LL;
+    // the callbacks registered by FFIWallet.jniCreate, recovery progress only on request
+    for (int callback = 0; callback < kStubRecoveryProgress; callback++) {
+        options.load.eventsPerSecond[callback] = 1000;
+    }
+    for (int n = 1; n < argc; n++) {
+        std::string arg = argv[n];
+        if (n + 1 >= argc) {
+            fprintf(stderr, "Missing value of %s.\n", arg.c_str());
+            return false;
+        }
+        const char *value = argv[++n];
+        if (arg == "--completed") {
+            options.stub.completedTxCount = static_cast<unsigned int>(atol(value));
+        } else if (arg == "--pending") {
+            options.stub.pendingInboundTxCount = static_cast<unsigned int>(atol(value));
+            options.stub.pendingOutboundTxCount = options.stub.pendingInboundTxCount;
+        } else if (arg == "--cancelled") {
+            options.stub.cancelledTxCount = static_cast<unsigned int>(atol(value));
+        } else if (arg == "--threads") {
+            options.load.threadCount = static_cast<unsigned int>(std::max(1L, atol(value)));
+        } else if (arg == "--rate") {
+            if (!parseRate(value, options.load)) {
+                fprintf(stderr, "Invalid rate %s, expected NAME=EVENTS_PER_SECOND.\n", value);
+                return false;
+            }
+        } else if (arg == "--rate-all") {
+            for (int callback = 0; callback < kStubRecoveryProgress; callback++) {
+                options.load.eventsPerSecond[callback] = atof(value);
+            }
+        } else if (arg == "--duration-ms") {
+            options.load.durationNanos = atoll(value) * 1000000LL;
+        } else if (arg == "--coalescing-window-ms") {
+            options.coalescingWindowMillis = atoll(value);
+        } else if (arg == "--listener-ns") {
+            options.listenerNanos = atoll(value);
+        } else if (arg == "--readers") {
+            options.readers = static_cast<unsigned int>(std::max(0L, atol(value)));
+        } else if (arg == "--latency-ns") {
+            options.stub.callLatencyNanos = atoll(value);
+        } else if (arg == "--ffi-trace") {
+            options.ffiTrace = value;
+        } else if (arg == "--call-stats") {
+            options.callStats = value;
+        } else if (arg == "--timeline") {
+            options.timeline = value;
+        } else if (arg == "--out") {
+            options.out = value;
+        } else {
+            fprintf(stderr, "Unknown option %s.\n", arg.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+struct CollectionTiming {
+    const char *name;
+    unsigned int elements;
+    int64_t nanos;
+};
+
+template<typename Body>
+static void timeOnce(std::vector<CollectionTiming> &timings, const char *name,
+                     unsigned int elements, Body body) {
+    int64_t start = stubWalletNowNanos();
+    body();
+    timings.push_back(CollectionTiming{name, elements, stubWalletNowNanos() - start});
+    fprintf(stderr, "%-36s %10u elements %12.3f ms\n", name, elements,
+            (timings.back().nanos) / 1e6);
+}
+
+/**
+ * Single passes over the large collections before the storm: collection handle, snapshot, table
+ * and first page.
+ */
+static std::vector<CollectionTiming> runCollectionPhase(HostJvm &jvm, JNIEnv *jEnv,
+                                                        jobject wallet, jobject error) {
+    std::vector<CollectionTiming> timings;
+    auto getCompletedTxs = jvm.nativeMethod<LongGetter>("FFIWallet", "jniGetCompletedTxs");
+    auto getLength = jvm.nativeMethod<IntGetter>("FFICompletedTxs", "jniGetLength");
+    auto writeSnapshot = jvm.nativeMethod<jint (*)(JNIEnv *, jobject, jobject, jobject)>(
+            "FFICompletedTxs", "jniWriteSnapshot");
+    auto completedTxsDestroy = jvm.nativeMethod<VoidMethod>("FFICompletedTxs", "jniDestroy");
+    jobject completedTxs = jvm.newObject("FFICompletedTxs");
+    unsigned int length = 0;
+    timeOnce(timings, "FFIWallet.jniGetCompletedTxs", 0, [&]() {
+        HostJvm::unwrap(completedTxs)->pointer = getCompletedTxs(jEnv, wallet, error);
+        length = static_cast<unsigned int>(getLength(jEnv, completedTxs, error));
+    });
+    timings.back().elements = length;
+    jint capacity = writeSnapshot(jEnv, completedTxs, jvm.newDirectByteBuffer(16), error);
+    jobject buffer = jvm.newDirectByteBuffer(capacity);
+    timeOnce(timings, "FFICompletedTxs.jniWriteSnapshot", length, [&]() {
+        writeSnapshot(jEnv, completedTxs, buffer, error);
+    });
+    // the snapshot buffer is only freed with the HostJvm, release its storage now
+    std::vector<unsigned char>().swap(HostJvm::unwrap(buffer)->data);
+    completedTxsDestroy(jEnv, completedTxs);
+
+    auto getTxTable = jvm.nativeMethod<LongGetter>("FFIWallet", "jniGetTxTable");
+    auto rowCount = jvm.nativeMethod<jint (*)(JNIEnv *, jobject)>("FFITxTable", "jniGetRowCount");
+    auto tableDestroy = jvm.nativeMethod<VoidMethod>("FFITxTable", "jniDestroy");
+    jobject table = jvm.newObject("FFITxTable");
+    timeOnce(timings, "FFIWallet.jniGetTxTable", 0, [&]() {
+        HostJvm::unwrap(table)->pointer = getTxTable(jEnv, wallet, error);
+    });
+    timings.back().elements = static_cast<unsigned int>(rowCount(jEnv, table));
+    tableDestroy(jEnv, table);
+
+    auto getTxPage = jvm.nativeMethod<jlong (*)(JNIEnv *, jobject, jint, jboolean, jint, jint, jint,
+                                                jobject)>("FFIWallet", "jniGetTxPage");
+    timeOnce(timings, "FFIWallet.jniGetTxPage", 50, [&]() {
+        HostJvm::unwrap(table)->pointer = getTxPage(jEnv, wallet, 0, JNI_TRUE, 0xF, 0, 50, error);
+    });
+    tableDestroy(jEnv, table);
+    jvm.releaseLocalRefs();
+    if (HostJvm::unwrap(error)->code != 0) {
+        fprintf(stderr, "Collection phase failed with error %d.\n", HostJvm::unwrap(error)->code);
+    }
+    return timings;
+}
+
+/**
+ * Pages through the newest transactions until stopped, as a history screen would while events
+ * arrive, recording the latency of every page.
+ */
+static void runReader(HostJvm &jvm, jobject wallet, std::atomic<bool> &stop,
+                      LatencyHistogram &histogram, std::atomic<int> &failures) {
+    JNIEnv *jEnv = jvm.attachCurrentThread();
+    auto getTxPage = jvm.nativeMethod<jlong (*)(JNIEnv *, jobject, jint, jboolean, jint, jint, jint,
+                                                jobject)>("FFIWallet", "jniGetTxPage");
+    auto tableDestroy = jvm.nativeMethod<VoidMethod>("FFITxTable", "jniDestroy");
+    jobject error = jvm.newObject("FFIError");
+    jobject table = jvm.newObject("FFITxTable");
+    jint offset = 0;
+    while (!stop.load()) {
+        int64_t start = stubWalletNowNanos();
+        HostJvm::unwrap(table)->pointer = getTxPage(jEnv, wallet, 0, JNI_TRUE, 0xF, offset, 50, error);
+        tableDestroy(jEnv, table);
+        histogram.record(stubWalletNowNanos() - start);
+        if (HostJvm::unwrap(error)->code != 0) {
+            failures++;
+            HostJvm::unwrap(error)->code = 0;
+        }
+        offset = (offset + 50) % 1000;
+    }
+    jvm.releaseLocalRefs();
+    jvm.getJavaVm()->DetachCurrentThread();
+}
+
+/**
+ * Waits until every event posted to the dispatcher was delivered or coalesced away.
+ */
+static bool waitForDrain(JNIEnv *jEnv, LongArrayMethod getQueueStats, jobject wallet) {
+    int64_t start = stubWalletNowNanos();
+    jlong stats[kWalletEventStatCount];
+    while (stubWalletNowNanos() - start < kDrainTimeoutNanos) {
+        jEnv->GetLongArrayRegion(getQueueStats(jEnv, wallet), 0, kWalletEventStatCount, stats);
+        if (stats[kStatDispatched] + stats[kStatCoalesced] >= stats[kStatPosted]) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return false;
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 2;
+    }
+    stubWalletConfigure(options.stub);
+
+    HostJvm jvm;
+    JNIEnv *jEnv = jvm.attachCurrentThread();
+    EventSink sink;
+    sink.listenerNanos = options.listenerNanos;
+    jvm.defineVoidMethod("com/tari/android/wallet/ffi/FFIWallet", "onEvents", "([JI)V", onEvents,
+                         &sink);
+    if (JNI_OnLoad(jvm.getJavaVm(), nullptr) == JNI_ERR) {
+        fprintf(stderr, "JNI_OnLoad failed.\n");
+        return 1;
+    }
+    jobject error = jvm.newObject("FFIError");
+    sink.error = jvm.newObject("FFIError");
+    sink.completedTx = jvm.newObject("FFICompletedTx");
+    sink.pendingInboundTx = jvm.newObject("FFIPendingInboundTx");
+    for (jobject object : {error, sink.error, sink.completedTx, sink.pendingInboundTx}) {
+        jvm.pin(HostJvm::unwrap(object));
+    }
+    sink.completedTxGetId = jvm.nativeMethod<LongGetter>("FFICompletedTx", "jniGetId");
+    sink.completedTxDestroy = jvm.nativeMethod<VoidMethod>("FFICompletedTx", "jniDestroy");
+    sink.pendingInboundTxGetId = jvm.nativeMethod<LongGetter>("FFIPendingInboundTx", "jniGetId");
+    sink.pendingInboundTxDestroy = jvm.nativeMethod<VoidMethod>("FFIPendingInboundTx",
+                                                                "jniDestroy");
+
+    jobject transport = jvm.newObject("FFITransportType");
+    jvm.nativeMethod<VoidMethod>("FFITransportType", "jniMemoryTransport")(jEnv, transport);
+    jobject commsConfig = jvm.newObject("FFICommsConfig");
+    jvm.nativeMethod<void (*)(JNIEnv *, jobject, jstring, jobject, jstring, jstring, jlong, jlong,
+                              jstring, jobject)>("FFICommsConfig", "jniCreate")(
+            jEnv, commsConfig, jvm.newString("/ip4/127.0.0.1/tcp/18101"), transport,
+            jvm.newString("load_test_db"), jvm.newString("/tmp"), 30, 600,
+            jvm.newString("weatherwax"), error);
+    jobject ffiUtil = jvm.newObject("FFIUtil");
+    jvm.pin(HostJvm::unwrap(ffiUtil));
+    if (!options.ffiTrace.empty() &&
+        !jvm.nativeMethod<jboolean (*)(JNIEnv *, jobject, jstring, jboolean)>(
+                "FFIUtil", "jniStartFfiTrace")(jEnv, ffiUtil, jvm.newString(options.ffiTrace),
+                                               JNI_FALSE)) {
+        fprintf(stderr, "Cannot record the FFI trace %s.\n", options.ffiTrace.c_str());
+        return 1;
+    }
+    auto setTimelineRecording = jvm.nativeMethod<jboolean (*)(JNIEnv *, jobject, jboolean)>(
+            "FFIUtil", "jniSetTimelineRecording");
+    if (!options.timeline.empty() && !setTimelineRecording(jEnv, ffiUtil, JNI_TRUE)) {
+        fprintf(stderr, "Cannot record the timeline.\n");
+        return 1;
+    }
+    jobject wallet = jvm.newObject("FFIWallet");
+    jvm.pin(HostJvm::unwrap(wallet));
+    int64_t createStart = stubWalletNowNanos();
+    jvm.nativeMethod<void (*)(JNIEnv *, jobject, jobject, jstring, jint, jint, jstring, jobject,
+                              jstring, jstring, jobject)>("FFIWallet", "jniCreate")(
+            jEnv, wallet, commsConfig, jvm.newString(""), 2, 1024, nullptr, nullptr,
+            jvm.newString("onEvents"), jvm.newString("([JI)V"), error);
+    int64_t createNanos = stubWalletNowNanos() - createStart;
+    if (HostJvm::unwrap(error)->code != 0 || HostJvm::unwrap(wallet)->pointer == 0) {
+        fprintf(stderr, "Wallet creation failed with error %d.\n", HostJvm::unwrap(error)->code);
+        return 1;
+    }
+    fprintf(stderr, "wallet of %u transactions created in %.1f ms\n",
+            options.stub.completedTxCount, createNanos / 1e6);
+    jvm.nativeMethod<void (*)(JNIEnv *, jobject, jlong)>(
+            "FFIWallet", "jniSetConfirmationCoalescingWindow")(jEnv, wallet,
+                                                               options.coalescingWindowMillis);
+    jobject publicKey = nullptr;
+    if (options.load.eventsPerSecond[kStubRecoveryProgress] > 0) {
+        publicKey = jvm.newObject("FFIPublicKey");
+        HostJvm::unwrap(publicKey)->pointer = jvm.nativeMethod<LongGetter>(
+                "FFIWallet", "jniGetPublicKey")(jEnv, wallet, error);
+        jvm.nativeMethod<jboolean (*)(JNIEnv *, jobject, jobject, jobject)>(
+                "FFIWallet", "jniStartRecovery")(jEnv, wallet, publicKey, error);
+    }
+
+    std::vector<CollectionTiming> timings = runCollectionPhase(jvm, jEnv, wallet, error);
+
+    std::atomic<bool> stopReaders(false);
+    std::atomic<int> readerFailures(0);
+    std::vector<LatencyHistogram> readerLatency(options.readers);
+    std::vector<std::thread> readers;
+    for (unsigned int n = 0; n < options.readers; n++) {
+        readers.emplace_back(runReader, std::ref(jvm), wallet, std::ref(stopReaders),
+                             std::ref(readerLatency[n]), std::ref(readerFailures));
+    }
+    auto *pWallet = reinterpret_cast<TariWallet *>(HostJvm::unwrap(wallet)->pointer);
+    int64_t loadStart = stubWalletNowNanos();
+    StubLoadStats load = stubWalletRunLoad(pWallet, options.load);
+    stopReaders.store(true);
+    for (std::thread &reader : readers) {
+        reader.join();
+    }
+    auto getQueueStats = jvm.nativeMethod<LongArrayMethod>("FFIWallet", "jniGetEventQueueStats");
+    bool drained = waitForDrain(jEnv, getQueueStats, wallet);
+    int64_t drainedNanos = stubWalletNowNanos();
+    jlong queue[kWalletEventStatCount];
+    jEnv->GetLongArrayRegion(getQueueStats(jEnv, wallet), 0, kWalletEventStatCount, queue);
+    // destroying the wallet joins the dispatcher thread, the only writer of the sink histograms
+    if (publicKey != nullptr) {
+        jvm.nativeMethod<VoidMethod>("FFIPublicKey", "jniDestroy")(jEnv, publicKey);
+    }
+    jvm.nativeMethod<VoidMethod>("FFIWallet", "jniDestroy")(jEnv, wallet);
+
+    LatencyHistogram allEvents;
+    for (const LatencyHistogram &histogram : sink.latency) {
+        allEvents.merge(histogram);
+    }
+    LatencyHistogram allReaders;
+    for (const LatencyHistogram &histogram : readerLatency) {
+        allReaders.merge(histogram);
+    }
+    uint64_t emitted = 0;
+    for (uint64_t count : load.emitted) {
+        emitted += count;
+    }
+    double seconds = load.elapsedNanos / 1e9;
+    fprintf(stderr, "%llu callbacks in %.2f s, %lld events delivered, p99 latency %.3f ms\n",
+            static_cast<unsigned long long>(emitted), seconds, sink.delivered.load(),
+            allEvents.percentile(0.99) / 1e6);
+
+    FILE *out = stdout;
+    if (!options.out.empty()) {
+        out = fopen(options.out.c_str(), "w");
+        if (out == nullptr) {
+            fprintf(stderr, "Cannot write %s.\n", options.out.c_str());
+            return 1;
+        }
+    }
+    fprintf(out, "{\n  \"schema\": \"%s\",\n", kJsonSchema);
+    fprintf(out, "  \"wallet\": {\"completedTxCount\": %u, \"cancelledTxCount\": %u, "
+                 "\"pendingInboundTxCount\": %u, \"pendingOutboundTxCount\": %u, "
+                 "\"callLatencyNanos\": %lld, \"createNanos\": %lld},\n",
+            options.stub.completedTxCount, options.stub.cancelledTxCount,
+            options.stub.pendingInboundTxCount, options.stub.pendingOutboundTxCount,
+            static_cast<long long>(options.stub.callLatencyNanos),
+            static_cast<long long>(createNanos));
+    fprintf(out, "  \"collections\": [");
+    for (size_t n = 0; n < timings.size(); n++) {
+        fprintf(out, "%s\n    {\"name\": \"%s\", \"elements\": %u, \"nanos\": %lld}",
+                n == 0 ? "" : ",", timings[n].name, timings[n].elements,
+                static_cast<long long>(timings[n].nanos));
+    }
+    fprintf(out, "\n  ],\n");
+    fprintf(out, "  \"load\": {\"threads\": %u, \"durationNanos\": %lld, \"elapsedNanos\": %lld, "
+                 "\"coalescingWindowMillis\": %lld, \"listenerNanos\": %lld,\n    \"emitted\": {",
+            options.load.threadCount, static_cast<long long>(options.load.durationNanos),
+            static_cast<long long>(load.elapsedNanos),
+            static_cast<long long>(options.coalescingWindowMillis),
+            static_cast<long long>(options.listenerNanos));
+    for (int callback = 0; callback < kStubWalletCallbackCount; callback++) {
+        fprintf(out, "%s\"%s\": %llu", callback == 0 ? "" : ", ", kCallbackNames[callback],
+                static_cast<unsigned long long>(load.emitted[callback]));
+    }
+    fprintf(out, "},\n    \"skipped\": %llu, \"callbacksPerSecond\": %.0f, "
+                 "\"meanCallbackNanos\": %.0f, \"maxCallbackNanos\": %lld, \"maxLagNanos\": %lld},\n",
+            static_cast<unsigned long long>(load.skipped), emitted / seconds,
+            emitted == 0 ? 0.0 : static_cast<double>(load.callNanosTotal) / emitted,
+            static_cast<long long>(load.callNanosMax), static_cast<long long>(load.maxLagNanos));
+    fprintf(out, "  \"queue\": {\"drained\": %s, \"posted\": %lld, \"dropped\": %lld, "
+                 "\"dispatched\": %lld, \"coalesced\": %lld, \"batches\": %lld, "
+                 "\"maxQueueDepth\": %lld, \"deliveredPerSecond\": %.0f},\n",
+            drained ? "true" : "false", static_cast<long long>(queue[kStatPosted]),
+            static_cast<long long>(queue[kStatDropped]),
+            static_cast<long long>(queue[kStatDispatched]),
+            static_cast<long long>(queue[kStatCoalesced]),
+            static_cast<long long>(queue[kStatBatches]),
+            static_cast<long long>(queue[kStatMaxQueueDepth]),
+            sink.delivered.load() / ((drainedNanos - loadStart) / 1e9));
+    fprintf(out, "  \"deliveryLatency\": ");
+    allEvents.writeJson(out, "Nanos");
+    fprintf(out, ",\n  \"deliveryLatencyByEvent\": {");
+    bool first = true;
+    for (int type = 1; type < kEventTypeCount; type++) {
+        if (sink.latency[type].count == 0) {
+            continue;
+        }
+        fprintf(out, "%s\n    \"%s\": ", first ? "" : ",", kEventNames[type]);
+        sink.latency[type].writeJson(out, "Nanos");
+        first = false;
+    }
+    fprintf(out, "\n  },\n  \"batchSize\": ");
+    sink.batchSize.writeJson(out, "Events");
+    fprintf(out, ",\n  \"readerPageLatency\": ");
+    allReaders.writeJson(out, "Nanos");
+    fprintf(out, ",\n  \"readerFailures\": %d\n}\n", readerFailures.load());
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    if (!options.ffiTrace.empty()) {
+        jlong traceBytes = jvm.nativeMethod<jlong (*)(JNIEnv *, jobject)>(
+                "FFIUtil", "jniStopFfiTrace")(jEnv, ffiUtil);
+        fprintf(stderr, "FFI trace of %lld bytes written to %s\n",
+                static_cast<long long>(traceBytes), options.ffiTrace.c_str());
+    }
+    if (!options.timeline.empty()) {
+        setTimelineRecording(jEnv, ffiUtil, JNI_FALSE);
+        jlong spans = jvm.nativeMethod<jlong (*)(JNIEnv *, jobject, jstring)>(
+                "FFIUtil", "jniWriteTimeline")(jEnv, ffiUtil, jvm.newString(options.timeline));
+        if (spans < 0) {
+            fprintf(stderr, "Cannot write the timeline %s.\n", options.timeline.c_str());
+            return 1;
+        }
+        fprintf(stderr, "Timeline of %lld spans written to %s\n", static_cast<long long>(spans),
+                options.timeline.c_str());
+    }
+    jvm.nativeMethod<VoidMethod>("FFICommsConfig", "jniDestroy")(jEnv, commsConfig);
+    jvm.nativeMethod<VoidMethod>("FFITransportType", "jniDestroy")(jEnv, transport);
+    if (!options.callStats.empty()) {
+        std::string report = HostJvm::toUtf8(jvm.nativeMethod<jstring (*)(JNIEnv *, jobject)>(
+                "FFIUtil", "jniDumpCallStats")(jEnv, ffiUtil));
+        FILE *pFile = fopen(options.callStats.c_str(), "w");
+        if (pFile == nullptr) {
+            fprintf(stderr, "Cannot write %s.\n", options.callStats.c_str());
+            return 1;
+        }
+        fputs(report.c_str(), pFile);
+        fclose(pFile);
+    }
+    jvm.releaseLocalRefs();
+    return drained && readerFailures.load() == 0 ? 0 : 1;
+}
@@ -0,0 +1,1989 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "stubWallet.h"
+#include <android/log.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../jniEmojiTable.cpp"
+
+// region Stub state
+
+static const size_t kKeySize = 32;
+static const unsigned int kSeedWordCount = 24;
+
+static std::mutex g_configMutex;
+static StubWalletConfig g_config = stubWalletDefaultConfig();
+static std::atomic<int64_t> g_callLatencyNanos(0);
+static std::atomic<uint64_t> g_callCount(0);
+
+static int64_t stubNowNanos() {
+    timespec time{};
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<int64_t>(time.tv_sec) * 1000000000LL + time.tv_nsec;
+}
+
+static void spinFor(int64_t nanos) {
+    if (nanos <= 0) {
+        return;
+    }
+    int64_t end = stubNowNanos() + nanos;
+    while (stubNowNanos() < end) {
+    }
+}
+
+/**
+ * Entered by every wallet.h function.
+ */
+static void stubCall() {
+    g_callCount.fetch_add(1, std::memory_order_relaxed);
+    spinFor(g_callLatencyNanos.load(std::memory_order_relaxed));
+}
+
+static void setError(int *error_out, int value) {
+    if (error_out != nullptr) {
+        *error_out = value;
+    }
+}
+
+static char *copyString(const std::string &value) {
+    auto *result = static_cast<char *>(malloc(value.size() + 1));
+    memcpy(result, value.c_str(), value.size() + 1);
+    return result;
+}
+
+static void appendUtf8(std::string &out, char32_t codePoint) {
+    if (codePoint < 0x80) {
+        out += static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codePoint >> 6));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        out += static_cast<char>(0xE0 | (codePoint >> 12));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (codePoint >> 18));
+        out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+static std::string toHex(const unsigned char *bytes, size_t length) {
+    static const char kDigits[] = "0123456789abcdef";
+    std::string result(length * 2, '0');
+    for (size_t i = 0; i < length; i++) {
+        result[2 * i] = kDigits[bytes[i] >> 4];
+        result[2 * i + 1] = kDigits[bytes[i] & 0x0F];
+    }
+    return result;
+}
+
+static bool fromHex(const char *hex, unsigned char *bytes, size_t length) {
+    if (hex == nullptr || strlen(hex) != length * 2) {
+        return false;
+    }
+    for (size_t i = 0; i < length * 2; i++) {
+        char c = hex[i];
+        int value;
+        if (c >= '0' && c <= '9') {
+            value = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            value = c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            value = c - 'A' + 10;
+        } else {
+            return false;
+        }
+        bytes[i / 2] = static_cast<unsigned char>(i % 2 == 0 ? value << 4 : bytes[i / 2] | value);
+    }
+    return true;
+}
+
+/**
+ * Deterministic key bytes derived from a seed, spread so that keys of neighbouring seeds differ
+ * in every byte.
+ */
+static void fillKey(uint64_t seed, unsigned char *bytes) {
+    uint64_t state = seed * 0x9E3779B97F4A7C15ULL + 0x632BE59BD9B4E019ULL;
+    for (size_t i = 0; i < kKeySize; i++) {
+        state ^= state >> 29;
+        state *= 0xBF58476D1CE4E5B9ULL;
+        state ^= state >> 32;
+        bytes[i] = static_cast<unsigned char>(state);
+    }
+}
+
+static std::string makeText(const char *prefix, unsigned int index, unsigned int length, bool emoji) {
+    std::string text;
+    if (emoji) {
+        for (unsigned int n = 0; n < length; n++) {
+            appendUtf8(text, kEmojiAlphabet[(index + n) % kEmojiAlphabetSize]);
+        }
+        return text;
+    }
+    text = prefix + std::to_string(index) + " ";
+    while (text.size() < length) {
+        text += static_cast<char>('a' + text.size() % 26);
+    }
+    text.resize(length);
+    return text;
+}
+
+// endregion
+
+// region Handle types
+
+struct ByteVector {
+    std::vector<unsigned char> bytes;
+};
+
+struct TariPrivateKey {
+    unsigned char bytes[kKeySize];
+};
+
+struct TariPublicKey {
+    unsigned char bytes[kKeySize];
+};
+
+struct TariTransportType {
+    std::string address;
+};
+
+struct TariCommsConfig {
+    std::string publicAddress;
+    std::string datastorePath;
+};
+
+struct TariSeedWords {
+    std::vector<std::string> words;
+};
+
+struct EmojiSet {
+    std::vector<std::string> emoji;
+};
+
+struct TariContact {
+    std::string alias;
+    TariPublicKey publicKey;
+};
+
+struct TariContacts {
+    std::vector<TariContact> contacts;
+};
+
+/**
+ * A transaction as handed out in a handle, every field resolved.
+ */
+struct StubTx {
+    unsigned long long id;
+    unsigned long long amount;
+    unsigned long long fee;
+    unsigned long long timestamp;
+    unsigned long long confirmations;
+    int status;
+    bool isOutbound;
+    TariPublicKey source;
+    TariPublicKey destination;
+    std::string message;
+};
+
+/**
+ * Counterparty and message of a transaction made through the wallet API, shared between the
+ * rows that hold it.
+ */
+struct StubTxDetails {
+    TariPublicKey counterparty;
+    std::string message;
+};
+
+/**
+ * A stored transaction. Generated rows derive their counterparty key and message from id and
+ * index when a handle is made, so a wallet of millions of transactions costs 72 bytes per row.
+ */
+struct StubTxRow {
+    unsigned long long id;
+    unsigned long long amount;
+    unsigned long long fee;
+    unsigned long long timestamp;
+    unsigned long long confirmations;
+    unsigned int index;
+    int status;
+    bool isOutbound;
+    std::shared_ptr<const StubTxDetails> details;
+};
+
+/**
+ * Rows of one transaction kind in ascending id order, shared by the wallet and the collections
+ * copied from it. The wallet copies the rows before changing them while a collection holds them.
+ */
+typedef std::vector<StubTxRow> StubTxRows;
+
+/**
+ * What a row needs besides itself to be resolved into a StubTx.
+ */
+struct StubTxStyle {
+    TariPublicKey own;
+    unsigned int messageLength;
+    bool emojiMessages;
+};
+
+struct TariTransactionKernel {
+    unsigned char excess[kKeySize];
+    unsigned char excessPublicNonce[kKeySize];
+    unsigned char excessSignature[kKeySize];
+};
+
+// handles raised by stubWalletRunLoad carry the scheduled time of their event, 0 otherwise
+struct TariCompletedTransaction {
+    StubTx tx;
+    int64_t emitNanos;
+};
+
+struct TariPendingInboundTransaction {
+    StubTx tx;
+    int64_t emitNanos;
+};
+
+struct TariPendingOutboundTransaction {
+    StubTx tx;
+};
+
+struct TariCompletedTransactions {
+    std::shared_ptr<const StubTxRows> rows;
+    StubTxStyle style;
+};
+
+struct TariPendingInboundTransactions {
+    std::shared_ptr<const StubTxRows> rows;
+    StubTxStyle style;
+};
+
+struct TariPendingOutboundTransactions {
+    std::shared_ptr<const StubTxRows> rows;
+    StubTxStyle style;
+};
+
+struct StubCallbacks {
+    void (*received)(TariPendingInboundTransaction *);
+    void (*replyReceived)(TariCompletedTransaction *);
+    void (*finalized)(TariCompletedTransaction *);
+    void (*broadcast)(TariCompletedTransaction *);
+    void (*mined)(TariCompletedTransaction *);
+    void (*minedUnconfirmed)(TariCompletedTransaction *, unsigned long long);
+    void (*directSendResult)(unsigned long long, bool);
+    void (*storeAndForwardSendResult)(unsigned long long, bool);
+    void (*cancellation)(TariCompletedTransaction *);
+    void (*txoValidationComplete)(unsigned long long, unsigned char);
+    void (*transactionValidationComplete)(unsigned long long, unsigned char);
+    void (*safMessageReceived)();
+    void (*recoveryProgress)(unsigned char, unsigned long long, unsigned long long);
+};
+
+struct StubTxKind {
+    std::shared_ptr<StubTxRows> rows;
+    // sum of the amounts, the balance of the kind
+    unsigned long long balance;
+};
+
+struct TariWallet {
+    std::mutex mutex;
+    StubCallbacks callbacks;
+    StubTxStyle style;
+    std::vector<std::string> seedWords;
+    StubTxKind completed;
+    StubTxKind cancelled;
+    StubTxKind pendingInbound;
+    StubTxKind pendingOutbound;
+    std::vector<TariContact> contacts;
+    std::map<std::string, std::string> values;
+    unsigned long long nextTxId;
+    unsigned long long nextRequestId;
+    unsigned long long confirmationsRequired;
+};
+
+// tx status values of the library
+static const int kTxStatusCompleted = 0;
+static const int kTxStatusBroadcast = 1;
+static const int kTxStatusMined = 2;
+static const int kTxStatusPending = 4;
+static const int kTxStatusMinedUnconfirmed = 6;
+
+static const unsigned long long kStubBaseTimestamp = 1600000000ULL;
+
+static StubTxRow makeRow(unsigned long long id, unsigned int index, int status, bool isOutbound) {
+    StubTxRow row;
+    row.id = id;
+    row.amount = 1000000ULL + index * 7919ULL;
+    row.fee = isOutbound ? 100ULL + index % 50 : 0;
+    row.timestamp = kStubBaseTimestamp + index * 60ULL;
+    row.confirmations = status == kTxStatusMined ? 3 : index % 3;
+    row.index = index;
+    row.status = status;
+    row.isOutbound = isOutbound;
+    return row;
+}
+
+static StubTxRow makeRow(unsigned long long id, int status, bool isOutbound, unsigned long long amount,
+                         const TariPublicKey &counterparty, const char *message) {
+    StubTxRow row = makeRow(id, 0, status, isOutbound);
+    row.amount = amount;
+    row.details = std::make_shared<StubTxDetails>(
+            StubTxDetails{counterparty, message == nullptr ? "" : message});
+    return row;
+}
+
+static StubTx resolveRow(const StubTxRow &row, const StubTxStyle &style) {
+    StubTx tx;
+    tx.id = row.id;
+    tx.amount = row.amount;
+    tx.fee = row.fee;
+    tx.timestamp = row.timestamp;
+    tx.confirmations = row.confirmations;
+    tx.status = row.status;
+    tx.isOutbound = row.isOutbound;
+    TariPublicKey other;
+    if (row.details != nullptr) {
+        other = row.details->counterparty;
+        tx.message = row.details->message;
+    } else {
+        fillKey(row.id, other.bytes);
+        tx.message = makeText("Payment ", row.index, style.messageLength, style.emojiMessages);
+    }
+    tx.source = row.isOutbound ? style.own : other;
+    tx.destination = row.isOutbound ? other : style.own;
+    return tx;
+}
+
+static bool rowIdLess(const StubTxRow &row, unsigned long long id) {
+    return row.id < id;
+}
+
+static StubTxRows::const_iterator findRow(const StubTxRows &rows, unsigned long long id) {
+    auto it = std::lower_bound(rows.begin(), rows.end(), id, rowIdLess);
+    return it != rows.end() && it->id == id ? it : rows.end();
+}
+
+/**
+ * Rows of a kind for changing, copied first if a collection still shares them. Called with the
+ * wallet mutex held.
+ */
+static StubTxRows &mutableRows(StubTxKind &kind) {
+    if (kind.rows.use_count() > 1) {
+        kind.rows = std::make_shared<StubTxRows>(*kind.rows);
+    }
+    return *kind.rows;
+}
+
+static void insertRow(StubTxKind &kind, const StubTxRow &row) {
+    StubTxRows &rows = mutableRows(kind);
+    rows.insert(std::lower_bound(rows.begin(), rows.end(), row.id, rowIdLess), row);
+    kind.balance += row.amount;
+}
+
+// endregion
+
+// region Stub control
+
+StubWalletConfig stubWalletDefaultConfig() {
+    StubWalletConfig config{};
+    config.callLatencyNanos = 0;
+    config.elementLatencyNanos = 0;
+    config.completedTxCount = 200;
+    config.cancelledTxCount = 20;
+    config.pendingInboundTxCount = 20;
+    config.pendingOutboundTxCount = 20;
+    config.contactCount = 50;
+    config.messageLength = 32;
+    config.emojiMessages = false;
+    return config;
+}
+
+void stubWalletConfigure(const StubWalletConfig &config) {
+    std::lock_guard<std::mutex> lock(g_configMutex);
+    g_config = config;
+    g_callLatencyNanos.store(config.callLatencyNanos);
+}
+
+StubWalletConfig stubWalletGetConfig() {
+    std::lock_guard<std::mutex> lock(g_configMutex);
+    return g_config;
+}
+
+uint64_t stubWalletCallCount() {
+    return g_callCount.load(std::memory_order_relaxed);
+}
+
+static void spinForElements(size_t count) {
+    spinFor(stubWalletGetConfig().elementLatencyNanos * static_cast<int64_t>(count));
+}
+
+/**
+ * Raises one callback. Transaction events carry a new handle of the index-th row (modulo the
+ * collection size) of the matching kind, with tag as its emitNanos. Other events carry tag in
+ * place of their id (or current recovery value) if it is non-zero and index otherwise.
+ */
+static bool emitCallback(TariWallet *pWallet, StubWalletCallback callback, unsigned int index,
+                         int64_t tag) {
+    if (pWallet == nullptr) {
+        return false;
+    }
+    StubCallbacks &callbacks = pWallet->callbacks;
+    StubTxKind TariWallet::*kind = nullptr;
+    switch (callback) {
+        case kStubTxReceived:
+            kind = &TariWallet::pendingInbound;
+            break;
+        case kStubTxCancelled:
+            kind = &TariWallet::cancelled;
+            break;
+        case kStubTxReplyReceived:
+        case kStubTxFinalized:
+        case kStubTxBroadcast:
+        case kStubTxMined:
+        case kStubTxMinedUnconfirmed:
+            kind = &TariWallet::completed;
+            break;
+        default:
+            break;
+    }
+    StubTx tx;
+    if (kind != nullptr) {
+        StubTxRow row;
+        StubTxStyle style;
+        {
+            std::lock_guard<std::mutex> lock(pWallet->mutex);
+            const StubTxRows &rows = *(pWallet->*kind).rows;
+            if (rows.empty()) {
+                return false;
+            }
+            row = rows[index % rows.size()];
+            style = pWallet->style;
+        }
+        tx = resolveRow(row, style);
+    } else {
+        tx.id = tag != 0 ? static_cast<unsigned long long>(tag) : index;
+    }
+    switch (callback) {
+        case kStubTxReceived:
+            if (callbacks.received == nullptr) return false;
+            callbacks.received(new TariPendingInboundTransaction{tx, tag});
+            return true;
+        case kStubTxReplyReceived:
+            if (callbacks.replyReceived == nullptr) return false;
+            callbacks.replyReceived(new TariCompletedTransaction{tx, tag});
+            return true;
+        case kStubTxFinalized:
+            if (callbacks.finalized == nullptr) return false;
+            callbacks.finalized(new TariCompletedTransaction{tx, tag});
+            return true;
+        case kStubTxBroadcast:
+            if (callbacks.broadcast == nullptr) return false;
+            tx.status = kTxStatusBroadcast;
+            callbacks.broadcast(new TariCompletedTransaction{tx, tag});
+            return true;
+        case kStubTxMined:
+            if (callbacks.mined == nullptr) return false;
+            tx.status = kTxStatusMined;
+            callbacks.mined(new TariCompletedTransaction{tx, tag});
+            return true;
+        case kStubTxMinedUnconfirmed:
+            if (callbacks.minedUnconfirmed == nullptr) return false;
+            tx.status = kTxStatusMinedUnconfirmed;
+            tx.confirmations = index % 3;
+            callbacks.minedUnconfirmed(new TariCompletedTransaction{tx, tag}, tx.confirmations);
+            return true;
+        case kStubDirectSendResult:
+            if (callbacks.directSendResult == nullptr) return false;
+            callbacks.directSendResult(tx.id, true);
+            return true;
+        case kStubStoreAndForwardSendResult:
+            if (callbacks.storeAndForwardSendResult == nullptr) return false;
+            callbacks.storeAndForwardSendResult(tx.id, true);
+            return true;
+        case kStubTxCancelled:
+            if (callbacks.cancellation == nullptr) return false;
+            callbacks.cancellation(new TariCompletedTransaction{tx, tag});
+            return true;
+        case kStubTxoValidationComplete:
+            if (callbacks.txoValidationComplete == nullptr) return false;
+            callbacks.txoValidationComplete(tx.id, 0);
+            return true;
+        case kStubTxValidationComplete:
+            if (callbacks.transactionValidationComplete == nullptr) return false;
+            callbacks.transactionValidationComplete(tx.id, 0);
+            return true;
+        case kStubSafMessageReceived:
+            if (callbacks.safMessageReceived == nullptr) return false;
+            callbacks.safMessageReceived();
+            return true;
+        case kStubRecoveryProgress:
+            if (callbacks.recoveryProgress == nullptr) return false;
+            callbacks.recoveryProgress(1, tx.id, index + 1);
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool stubWalletEmitCallback(TariWallet *pWallet, StubWalletCallback callback, unsigned int index) {
+    return emitCallback(pWallet, callback, index, 0);
+}
+
+bool stubWalletRemoveTx(TariWallet *pWallet, unsigned long long id) {
+    if (pWallet == nullptr) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(pWallet->mutex);
+    for (StubTxKind *kind : {&pWallet->completed, &pWallet->cancelled, &pWallet->pendingInbound,
+                             &pWallet->pendingOutbound}) {
+        auto found = findRow(*kind->rows, id);
+        if (found != kind->rows->end()) {
+            auto position = found - kind->rows->begin();
+            StubTxRows &rows = mutableRows(*kind);
+            kind->balance -= rows[position].amount;
+            rows.erase(rows.begin() + position);
+            return true;
+        }
+    }
+    return false;
+}
+
+int64_t stubWalletNowNanos() {
+    return stubNowNanos();
+}
+
+int64_t stubWalletEmitNanos(const TariCompletedTransaction *transaction) {
+    return transaction == nullptr ? 0 : transaction->emitNanos;
+}
+
+int64_t stubWalletEmitNanos(const TariPendingInboundTransaction *transaction) {
+    return transaction == nullptr ? 0 : transaction->emitNanos;
+}
+
+/**
+ * One thread of a load run: every enabled callback on its own fixed schedule, starting at a
+ * per-thread offset so that the threads interleave.
+ */
+static void runLoadThread(TariWallet *pWallet, const StubLoadConfig &config, unsigned int thread,
+                          int64_t start, StubLoadStats &stats) {
+    double intervals[kStubWalletCallbackCount];
+    double due[kStubWalletCallbackCount];
+    unsigned int counts[kStubWalletCallbackCount] = {};
+    int64_t end = start + config.durationNanos;
+    for (int callback = 0; callback < kStubWalletCallbackCount; callback++) {
+        double rate = config.eventsPerSecond[callback];
+        intervals[callback] = rate > 0 ? 1e9 * config.threadCount / rate : 0;
+        due[callback] = start + intervals[callback] * thread / config.threadCount;
+    }
+    while (true) {
+        int next = -1;
+        for (int callback = 0; callback < kStubWalletCallbackCount; callback++) {
+            if (intervals[callback] > 0 && (next < 0 || due[callback] < due[next])) {
+                next = callback;
+            }
+        }
+        if (next < 0 || due[next] >= end) {
+            break;
+        }
+        auto scheduled = static_cast<int64_t>(due[next]);
+        int64_t now = stubNowNanos();
+        if (scheduled - now > 200000) {
+            // sleep most of the way, the last stretch is spun for precision
+            std::this_thread::sleep_for(std::chrono::nanoseconds(scheduled - now - 100000));
+        }
+        while ((now = stubNowNanos()) < scheduled) {
+        }
+        stats.maxLagNanos = std::max(stats.maxLagNanos, now - scheduled);
+        // spread the indexes of the threads so that they raise distinct transactions
+        unsigned int index = counts[next]++ * config.threadCount + thread;
+        if (emitCallback(pWallet, static_cast<StubWalletCallback>(next), index, scheduled)) {
+            int64_t callNanos = stubNowNanos() - now;
+            stats.emitted[next]++;
+            stats.callNanosTotal += callNanos;
+            stats.callNanosMax = std::max(stats.callNanosMax, callNanos);
+        } else {
+            stats.skipped++;
+        }
+        due[next] += intervals[next];
+    }
+}
+
+StubLoadStats stubWalletRunLoad(TariWallet *pWallet, const StubLoadConfig &config) {
+    unsigned int threadCount = std::max(1U, config.threadCount);
+    StubLoadConfig threadConfig = config;
+    threadConfig.threadCount = threadCount;
+    std::vector<StubLoadStats> threadStats(threadCount, StubLoadStats{});
+    std::vector<std::thread> threads;
+    int64_t start = stubNowNanos();
+    for (unsigned int thread = 0; thread < threadCount; thread++) {
+        threads.emplace_back(runLoadThread, pWallet, std::cref(threadConfig), thread, start,
+                             std::ref(threadStats[thread]));
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    StubLoadStats stats{};
+    stats.elapsedNanos = stubNowNanos() - start;
+    for (const StubLoadStats &entry : threadStats) {
+        for (int callback = 0; callback < kStubWalletCallbackCount; callback++) {
+            stats.emitted[callback] += entry.emitted[callback];
+        }
+        stats.skipped += entry.skipped;
+        stats.callNanosTotal += entry.callNanosTotal;
+        stats.callNanosMax = std::max(stats.callNanosMax, entry.callNanosMax);
+        stats.maxLagNanos = std::max(stats.maxLagNanos, entry.maxLagNanos);
+    }
+    return stats;
+}
+
+// endregion
+
+// Definitions of the functions declared extern "C" by android/log.h and wallet.h.
+
+int __android_log_print(int prio, const char *tag, const char *fmt, ...) {
+    if (prio < ANDROID_LOG_WARN && getenv("TARI_HOST_VERBOSE") == nullptr) {
+        return 0;
+    }
+    static const char kPriorities[] = "??VDIWEFS";
+    fprintf(stderr, "%c/%s: ", kPriorities[prio < 0 || prio > ANDROID_LOG_SILENT ? 0 : prio], tag);
+    va_list args;
+    va_start(args, fmt);
+    int written = vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+    return written;
+}
+
+// region Transport, strings, kernels
+
+void file_partial_backup(const char *original_file_path, const char *backup_file_path, int *error_out) {
+    stubCall();
+    setError(error_out, original_file_path == nullptr || backup_file_path == nullptr ? kStubErrorNullPointer : 0);
+}
+
+TariTransportType *transport_memory_create() {
+    stubCall();
+    static std::atomic<int> port(10000);
+    return new TariTransportType{"/memory/" + std::to_string(port++)};
+}
+
+TariTransportType *transport_tcp_create(const char *listener_address, int *error_out) {
+    stubCall();
+    if (listener_address == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    return new TariTransportType{listener_address};
+}
+
+TariTransportType *transport_tor_create(const char *control_server_address,
+                                        ByteVector *tor_cookie,
+                                        unsigned short tor_port,
+                                        const char *socks_username,
+                                        const char *socks_password,
+                                        int *error_out) {
+    stubCall();
+    if (control_server_address == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    return new TariTransportType{std::string(control_server_address) + ":" + std::to_string(tor_port)};
+}
+
+char *transport_memory_get_address(TariTransportType *transport, int *error_out) {
+    stubCall();
+    if (transport == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    return copyString(transport->address);
+}
+
+void transport_type_destroy(TariTransportType *transport) {
+    stubCall();
+    delete transport;
+}
+
+void string_destroy(char *s) {
+    stubCall();
+    free(s);
+}
+
+static char *kernelHex(const unsigned char *field, TariTransactionKernel *kernel, int *error_out) {
+    stubCall();
+    if (kernel == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    return copyString(toHex(field, kKeySize));
+}
+
+char *transaction_kernel_get_excess_hex(TariTransactionKernel *kernel, int *error_out) {
+    return kernelHex(kernel == nullptr ? nullptr : kernel->excess, kernel, error_out);
+}
+
+char *transaction_kernel_get_excess_public_nonce_hex(TariTransactionKernel *kernel, int *error_out) {
+    return kernelHex(kernel == nullptr ? nullptr : kernel->excessPublicNonce, kernel, error_out);
+}
+
+char *transaction_kernel_get_excess_signature_hex(TariTransactionKernel *kernel, int *error_out) {
+    return kernelHex(kernel == nullptr ? nullptr : kernel->excessSignature, kernel, error_out);
+}
+
+void transaction_kernel_destroy(TariTransactionKernel *x) {
+    stubCall();
+    delete x;
+}
+
+// endregion
+
+// region Byte vectors, keys, emoji, seed words
+
+ByteVector *byte_vector_create(const unsigned char *byte_array, unsigned int element_count, int *error_out) {
+    stubCall();
+    setError(error_out, 0);
+    auto *result = new ByteVector();
+    if (byte_array != nullptr) {
+        result->bytes.assign(byte_array, byte_array + element_count);
+    }
+    return result;
+}
+
+unsigned char byte_vector_get_at(ByteVector *ptr, unsigned int i, int *error_out) {
+    stubCall();
+    if (ptr == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return 0;
+    }
+    if (i >= ptr->bytes.size()) {
+        setError(error_out, kStubErrorPosition);
+        return 0;
+    }
+    setError(error_out, 0);
+    return ptr->bytes[i];
+}
+
+unsigned int byte_vector_get_length(const ByteVector *vec, int *error_out) {
+    stubCall();
+    if (vec == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return 0;
+    }
+    setError(error_out, 0);
+    return static_cast<unsigned int>(vec->bytes.size());
+}
+
+void byte_vector_destroy(ByteVector *bytes) {
+    stubCall();
+    delete bytes;
+}
+
+static ByteVector *keyBytes(const unsigned char *bytes, int *error_out) {
+    setError(error_out, 0);
+    return new ByteVector{std::vector<unsigned char>(bytes, bytes + kKeySize)};
+}
+
+TariPublicKey *public_key_create(ByteVector *bytes, int *error_out) {
+    stubCall();
+    if (bytes == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    if (bytes->bytes.size() != kKeySize) {
+        setError(error_out, kStubErrorInvalidArgument);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    auto *result = new TariPublicKey();
+    memcpy(result->bytes, bytes->bytes.data(), kKeySize);
+    return result;
+}
+
+ByteVector *public_key_get_bytes(TariPublicKey *pk, int *error_out) {
+    stubCall();
+    if (pk == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    return keyBytes(pk->bytes, error_out);
+}
+
+TariPublicKey *public_key_from_private_key(TariPrivateKey *secret_key, int *error_out) {
+    stubCall();
+    if (secret_key == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    uint64_t seed = 0;
+    memcpy(&seed, secret_key->bytes, sizeof(seed));
+    auto *result = new TariPublicKey();
+    fillKey(seed, result->bytes);
+    return result;
+}
+
+TariPublicKey *public_key_from_hex(const char *hex, int *error_out) {
+    stubCall();
+    auto *result = new TariPublicKey();
+    if (!fromHex(hex, result->bytes, kKeySize)) {
+        delete result;
+        setError(error_out, hex == nullptr ? kStubErrorNullPointer : kStubErrorInvalidArgument);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    return result;
+}
+
+void public_key_destroy(TariPublicKey *pk) {
+    stubCall();
+    delete pk;
+}
+
+/**
+ * Luhn mod 256 over the key bytes, the checksum emoji of the library.
+ */
+static int emojiChecksum(const unsigned char *bytes) {
+    int sum = 0;
+    int factor = 2;
+    for (int k = static_cast<int>(kKeySize) - 1; k >= 0; k--) {
+        int addend = factor * bytes[k];
+        sum += addend / kEmojiAlphabetSize + addend % kEmojiAlphabetSize;
+        factor ^= 3;
+    }
+    return (kEmojiAlphabetSize - sum % kEmojiAlphabetSize) % kEmojiAlphabetSize;
+}
+
+char *public_key_to_emoji_id(TariPublicKey *pk, int *error_out) {
+    stubCall();
+    if (pk == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    std::string emojiId;
+    for (size_t i = 0; i < kKeySize; i++) {
+        appendUtf8(emojiId, kEmojiAlphabet[pk->bytes[i]]);
+    }
+    appendUtf8(emojiId, kEmojiAlphabet[emojiChecksum(pk->bytes)]);
+    return copyString(emojiId);
+}
+
+TariPublicKey *emoji_id_to_public_key(const char *emoji, int *error_out) {
+    stubCall();
+    if (emoji == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    auto *result = new TariPublicKey();
+    auto *p = reinterpret_cast<const unsigned char *>(emoji);
+    size_t count = 0;
+    int checksum = -1;
+    while (*p != 0) {
+        // the alphabet only holds 4-byte sequences
+        if ((p[0] & 0xF8) != 0xF0 || (p[1] & 0xC0) != 0x80 || (p[2] & 0xC0) != 0x80 || (p[3] & 0xC0) != 0x80) {
+            break;
+        }
+        char32_t codePoint = (static_cast<char32_t>(p[0] & 0x07) << 18) | ((p[1] & 0x3F) << 12)
+                             | ((p[2] & 0x3F) << 6) | (p[3] & 0x3F);
+        int index = emojiIndexOf(codePoint);
+        if (index < 0 || count > kKeySize) {
+            break;
+        }
+        if (count < kKeySize) {
+            result->bytes[count] = static_cast<unsigned char>(index);
+        } else {
+            checksum = index;
+        }
+        count++;
+        p += 4;
+    }
+    if (*p != 0 || count != kKeySize + 1 || checksum != emojiChecksum(result->bytes)) {
+        delete result;
+        setError(error_out, kStubErrorInvalidArgument);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    return result;
+}
+
+EmojiSet *get_emoji_set() {
+    stubCall();
+    auto *result = new EmojiSet();
+    result->emoji.resize(kEmojiAlphabetSize);
+    for (int i = 0; i < kEmojiAlphabetSize; i++) {
+        appendUtf8(result->emoji[i], kEmojiAlphabet[i]);
+    }
+    return result;
+}
+
+unsigned int emoji_set_get_length(EmojiSet *emoji_set, int *error_out) {
+    stubCall();
+    if (emoji_set == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return 0;
+    }
+    setError(error_out, 0);
+    return static_cast<unsigned int>(emoji_set->emoji.size());
+}
+
+ByteVector *emoji_set_get_at(EmojiSet *emoji_set, unsigned int position, int *error_out) {
+    stubCall();
+    if (emoji_set == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    if (position >= emoji_set->emoji.size()) {
+        setError(error_out, kStubErrorPosition);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    const std::string &emoji = emoji_set->emoji[position];
+    return new ByteVector{std::vector<unsigned char>(emoji.begin(), emoji.end())};
+}
+
+void emoji_set_destroy(EmojiSet *emoji_set) {
+    stubCall();
+    delete emoji_set;
+}
+
+TariPrivateKey *private_key_create(ByteVector *bytes, int *error_out) {
+    stubCall();
+    if (bytes == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    if (bytes->bytes.size() != kKeySize) {
+        setError(error_out, kStubErrorInvalidArgument);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    auto *result = new TariPrivateKey();
+    memcpy(result->bytes, bytes->bytes.data(), kKeySize);
+    return result;
+}
+
+TariPrivateKey *private_key_generate() {
+    stubCall();
+    static std::atomic<uint64_t> seed(1);
+    auto *result = new TariPrivateKey();
+    fillKey(seed++ ^ static_cast<uint64_t>(stubNowNanos()), result->bytes);
+    return result;
+}
+
+ByteVector *private_key_get_bytes(TariPrivateKey *sk, int *error_out) {
+    stubCall();
+    if (sk == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    return keyBytes(sk->bytes, error_out);
+}
+
+TariPrivateKey *private_key_from_hex(const char *hex, int *error_out) {
+    stubCall();
+    auto *result = new TariPrivateKey();
+    if (!fromHex(hex, result->bytes, kKeySize)) {
+        delete result;
+        setError(error_out, hex == nullptr ? kStubErrorNullPointer : kStubErrorInvalidArgument);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    return result;
+}
+
+void private_key_destroy(TariPrivateKey *sk) {
+    stubCall();
+    delete sk;
+}
+
+TariSeedWords *seed_words_create() {
+    stubCall();
+    return new TariSeedWords();
+}
+
+unsigned int seed_words_get_length(TariSeedWords *seed_words, int *error_out) {
+    stubCall();
+    if (seed_words == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return 0;
+    }
+    setError(error_out, 0);
+    return static_cast<unsigned int>(seed_words->words.size());
+}
+
+char *seed_words_get_at(TariSeedWords *seed_words, unsigned int position, int *error_out) {
+    stubCall();
+    if (seed_words == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    if (position >= seed_words->words.size()) {
+        setError(error_out, kStubErrorPosition);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    return copyString(seed_words->words[position]);
+}
+
+unsigned char seed_words_push_word(TariSeedWords *seed_words, const char *word, int *error_out) {
+    stubCall();
+    if (seed_words == nullptr || word == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return 0;
+    }
+    setError(error_out, 0);
+    // SeedWordsWordPushResult: 0 invalid word, 1 pushed, 2 phrase complete, 3 invalid phrase
+    if (word[0] == 0 || seed_words->words.size() >= kSeedWordCount) {
+        return 0;
+    }
+    seed_words->words.push_back(word);
+    return static_cast<unsigned char>(seed_words->words.size() == kSeedWordCount ? 2 : 1);
+}
+
+void seed_words_destroy(TariSeedWords *seed_words) {
+    stubCall();
+    delete seed_words;
+}
+
+// endregion
+
+// region Contacts
+
+TariContact *contact_create(const char *alias, TariPublicKey *public_key, int *error_out) {
+    stubCall();
+    if (alias == nullptr || public_key == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    return new TariContact{alias, *public_key};
+}
+
+char *contact_get_alias(TariContact *contact, int *error_out) {
+    stubCall();
+    if (contact == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    return copyString(contact->alias);
+}
+
+TariPublicKey *contact_get_public_key(TariContact *contact, int *error_out) {
+    stubCall();
+    if (contact == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    return new TariPublicKey(contact->publicKey);
+}
+
+void contact_destroy(TariContact *contact) {
+    stubCall();
+    delete contact;
+}
+
+unsigned int contacts_get_length(TariContacts *contacts, int *error_out) {
+    stubCall();
+    if (contacts == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return 0;
+    }
+    setError(error_out, 0);
+    return static_cast<unsigned int>(contacts->contacts.size());
+}
+
+TariContact *contacts_get_at(TariContacts *contacts, unsigned int position, int *error_out) {
+    stubCall();
+    if (contacts == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    if (position >= contacts->contacts.size()) {
+        setError(error_out, kStubErrorPosition);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    return new TariContact(contacts->contacts[position]);
+}
+
+void contacts_destroy(TariContacts *contacts) {
+    stubCall();
+    delete contacts;
+}
+
+// endregion
+
+// region Transaction collections
+
+template<typename Collection>
+static unsigned int collectionLength(Collection *collection, int *error_out) {
+    stubCall();
+    if (collection == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return 0;
+    }
+    setError(error_out, 0);
+    return static_cast<unsigned int>(collection->rows->size());
+}
+
+template<typename Tx, typename Collection>
+static Tx *collectionAt(Collection *collection, unsigned int position, int *error_out) {
+    stubCall();
+    if (collection == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    if (position >= collection->rows->size()) {
+        setError(error_out, kStubErrorPosition);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    return new Tx{resolveRow((*collection->rows)[position], collection->style)};
+}
+
+unsigned int completed_transactions_get_length(TariCompletedTransactions *transactions, int *error_out) {
+    return collectionLength(transactions, error_out);
+}
+
+TariCompletedTransaction *completed_transactions_get_at(TariCompletedTransactions *transactions,
+                                                        unsigned int position,
+                                                        int *error_out) {
+    return collectionAt<TariCompletedTransaction>(transactions, position, error_out);
+}
+
+void completed_transactions_destroy(TariCompletedTransactions *transactions) {
+    stubCall();
+    delete transactions;
+}
+
+unsigned int pending_outbound_transactions_get_length(TariPendingOutboundTransactions *transactions,
+                                                      int *error_out) {
+    return collectionLength(transactions, error_out);
+}
+
+TariPendingOutboundTransaction *pending_outbound_transactions_get_at(TariPendingOutboundTransactions *transactions,
+                                                                     unsigned int position,
+                                                                     int *error_out) {
+    return collectionAt<TariPendingOutboundTransaction>(transactions, position, error_out);
+}
+
+void pending_outbound_transactions_destroy(TariPendingOutboundTransactions *transactions) {
+    stubCall();
+    delete transactions;
+}
+
+unsigned int pending_inbound_transactions_get_length(TariPendingInboundTransactions *transactions,
+                                                     int *error_out) {
+    return collectionLength(transactions, error_out);
+}
+
+TariPendingInboundTransaction *pending_inbound_transactions_get_at(TariPendingInboundTransactions *transactions,
+                                                                   unsigned int position,
+                                                                   int *error_out) {
+    return collectionAt<TariPendingInboundTransaction>(transactions, position, error_out);
+}
+
+void pending_inbound_transactions_destroy(TariPendingInboundTransactions *transactions) {
+    stubCall();
+    delete transactions;
+}
+
+// endregion
+
+// region Transactions
+
+/**
+ * Reads one field of a transaction handle, 0 with kStubErrorNullPointer for a null handle.
+ */
+template<typename Tx, typename Field>
+static Field txField(Tx *transaction, Field StubTx::*field, int *error_out) {
+    stubCall();
+    if (transaction == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return Field();
+    }
+    setError(error_out, 0);
+    return transaction->tx.*field;
+}
+
+template<typename Tx>
+static TariPublicKey *txKey(Tx *transaction, TariPublicKey StubTx::*field, int *error_out) {
+    stubCall();
+    if (transaction == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    return new TariPublicKey(transaction->tx.*field);
+}
+
+template<typename Tx>
+static const char *txMessage(Tx *transaction, int *error_out) {
+    stubCall();
+    if (transaction == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    return copyString(transaction->tx.message);
+}
+
+unsigned long long completed_transaction_get_transaction_id(TariCompletedTransaction *transaction,
+                                                            int *error_out) {
+    return txField(transaction, &StubTx::id, error_out);
+}
+
+TariPublicKey *completed_transaction_get_destination_public_key(TariCompletedTransaction *transaction,
+                                                                int *error_out) {
+    return txKey(transaction, &StubTx::destination, error_out);
+}
+
+TariTransactionKernel *completed_transaction_get_transaction_kernel(TariCompletedTransaction *transaction,
+                                                                    int *error_out) {
+    stubCall();
+    if (transaction == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    auto *kernel = new TariTransactionKernel();
+    fillKey(transaction->tx.id * 3, kernel->excess);
+    fillKey(transaction->tx.id * 3 + 1, kernel->excessPublicNonce);
+    fillKey(transaction->tx.id * 3 + 2, kernel->excessSignature);
+    return kernel;
+}
+
+TariPublicKey *completed_transaction_get_source_public_key(TariCompletedTransaction *transaction,
+                                                           int *error_out) {
+    return txKey(transaction, &StubTx::source, error_out);
+}
+
+int completed_transaction_get_status(TariCompletedTransaction *transaction, int *error_out) {
+    return txField(transaction, &StubTx::status, error_out);
+}
+
+unsigned long long completed_transaction_get_amount(TariCompletedTransaction *transaction, int *error_out) {
+    return txField(transaction, &StubTx::amount, error_out);
+}
+
+unsigned long long completed_transaction_get_fee(TariCompletedTransaction *transaction, int *error_out) {
+    return txField(transaction, &StubTx::fee, error_out);
+}
+
+unsigned long long completed_transaction_get_timestamp(TariCompletedTransaction *transaction, int *error_out) {
+    return txField(transaction, &StubTx::timestamp, error_out);
+}
+
+const char *completed_transaction_get_message(TariCompletedTransaction *transaction, int *error_out) {
+    return txMessage(transaction, error_out);
+}
+
+bool completed_transaction_is_outbound(TariCompletedTransaction *tx, int *error_out) {
+    return txField(tx, &StubTx::isOutbound, error_out);
+}
+
+unsigned long long completed_transaction_get_confirmations(TariCompletedTransaction *tx, int *error_out) {
+    return txField(tx, &StubTx::confirmations, error_out);
+}
+
+void completed_transaction_destroy(TariCompletedTransaction *transaction) {
+    stubCall();
+    delete transaction;
+}
+
+unsigned long long pending_outbound_transaction_get_transaction_id(TariPendingOutboundTransaction *transaction,
+                                                                   int *error_out) {
+    return txField(transaction, &StubTx::id, error_out);
+}
+
+TariPublicKey *pending_outbound_transaction_get_destination_public_key(TariPendingOutboundTransaction *transaction,
+                                                                       int *error_out) {
+    return txKey(transaction, &StubTx::destination, error_out);
+}
+
+unsigned long long pending_outbound_transaction_get_amount(TariPendingOutboundTransaction *transaction,
+                                                           int *error_out) {
+    return txField(transaction, &StubTx::amount, error_out);
+}
+
+unsigned long long pending_outbound_transaction_get_fee(TariPendingOutboundTransaction *transaction,
+                                                        int *error_out) {
+    return txField(transaction, &StubTx::fee, error_out);
+}
+
+unsigned long long pending_outbound_transaction_get_timestamp(TariPendingOutboundTransaction *transaction,
+                                                              int *error_out) {
+    return txField(transaction, &StubTx::timestamp, error_out);
+}
+
+const char *pending_outbound_transaction_get_message(TariPendingOutboundTransaction *transaction,
+                                                     int *error_out) {
+    return txMessage(transaction, error_out);
+}
+
+int pending_outbound_transaction_get_status(TariPendingOutboundTransaction *transaction, int *error_out) {
+    return txField(transaction, &StubTx::status, error_out);
+}
+
+void pending_outbound_transaction_destroy(TariPendingOutboundTransaction *transaction) {
+    stubCall();
+    delete transaction;
+}
+
+unsigned long long pending_inbound_transaction_get_transaction_id(TariPendingInboundTransaction *transaction,
+                                                                  int *error_out) {
+    return txField(transaction, &StubTx::id, error_out);
+}
+
+TariPublicKey *pending_inbound_transaction_get_source_public_key(TariPendingInboundTransaction *transaction,
+                                                                 int *error_out) {
+    return txKey(transaction, &StubTx::source, error_out);
+}
+
+unsigned long long pending_inbound_transaction_get_amount(TariPendingInboundTransaction *transaction,
+                                                          int *error_out) {
+    return txField(transaction, &StubTx::amount, error_out);
+}
+
+unsigned long long pending_inbound_transaction_get_timestamp(TariPendingInboundTransaction *transaction,
+                                                             int *error_out) {
+    return txField(transaction, &StubTx::timestamp, error_out);
+}
+
+const char *pending_inbound_transaction_get_message(TariPendingInboundTransaction *transaction,
+                                                    int *error_out) {
+    return txMessage(transaction, error_out);
+}
+
+int pending_inbound_transaction_get_status(TariPendingInboundTransaction *transaction, int *error_out) {
+    return txField(transaction, &StubTx::status, error_out);
+}
+
+void pending_inbound_transaction_destroy(TariPendingInboundTransaction *transaction) {
+    stubCall();
+    delete transaction;
+}
+
+// endregion
+
+// region Wallet
+
+TariCommsConfig *comms_config_create(const char *public_address,
+                                     TariTransportType *transport,
+                                     const char *database_name,
+                                     const char *datastore_path,
+                                     unsigned long long discovery_timeout_in_secs,
+                                     unsigned long long saf_message_duration_in_secs,
+                                     const char *network,
+                                     int *error_out) {
+    stubCall();
+    if (public_address == nullptr || transport == nullptr || datastore_path == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    return new TariCommsConfig{public_address, datastore_path};
+}
+
+void comms_config_destroy(TariCommsConfig *wc) {
+    stubCall();
+    delete wc;
+}
+
+TariWallet *wallet_create(TariCommsConfig *config,
+                          const char *log_path,
+                          unsigned int num_rolling_log_files,
+                          unsigned int size_per_log_file_bytes,
+                          const char *passphrase,
+                          TariSeedWords *seed_words,
+                          void (*callback_received_transaction)(TariPendingInboundTransaction *),
+                          void (*callback_received_transaction_reply)(TariCompletedTransaction *),
+                          void (*callback_received_finalized_transaction)(TariCompletedTransaction *),
+                          void (*callback_transaction_broadcast)(TariCompletedTransaction *),
+                          void (*callback_transaction_mined)(TariCompletedTransaction *),
+                          void (*callback_transaction_mined_unconfirmed)(TariCompletedTransaction *,
+                                                                         unsigned long long),
+                          void (*callback_direct_send_result)(unsigned long long, bool),
+                          void (*callback_store_and_forward_send_result)(unsigned long long, bool),
+                          void (*callback_transaction_cancellation)(TariCompletedTransaction *),
+                          void (*callback_txo_validation_complete)(unsigned long long, unsigned char),
+                          void (*callback_transaction_validation_complete)(unsigned long long, unsigned char),
+                          void (*callback_saf_message_received)(),
+                          bool *recovery_in_progress,
+                          int *error_out) {
+    stubCall();
+    if (config == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    if (recovery_in_progress != nullptr) {
+        *recovery_in_progress = false;
+    }
+    StubWalletConfig stubConfig = stubWalletGetConfig();
+    auto *pWallet = new TariWallet();
+    pWallet->callbacks = StubCallbacks{
+            callback_received_transaction,
+            callback_received_transaction_reply,
+            callback_received_finalized_transaction,
+            callback_transaction_broadcast,
+            callback_transaction_mined,
+            callback_transaction_mined_unconfirmed,
+            callback_direct_send_result,
+            callback_store_and_forward_send_result,
+            callback_transaction_cancellation,
+            callback_txo_validation_complete,
+            callback_transaction_validation_complete,
+            callback_saf_message_received,
+            nullptr
+    };
+    fillKey(0, pWallet->style.own.bytes);
+    pWallet->style.messageLength = stubConfig.messageLength;
+    pWallet->style.emojiMessages = stubConfig.emojiMessages;
+    if (seed_words != nullptr && !seed_words->words.empty()) {
+        pWallet->seedWords = seed_words->words;
+    } else {
+        for (unsigned int n = 0; n < kSeedWordCount; n++) {
+            pWallet->seedWords.push_back(makeText("word", n, 8, false));
+        }
+    }
+    unsigned long long id = 1;
+    auto generate = [&id](StubTxKind &kind, unsigned int count,
+                          const std::function<StubTxRow(unsigned long long, unsigned int)> &makeNth) {
+        kind.rows = std::make_shared<StubTxRows>();
+        kind.rows->reserve(count);
+        kind.balance = 0;
+        for (unsigned int n = 0; n < count; n++) {
+            kind.rows->push_back(makeNth(id++, n));
+            kind.balance += kind.rows->back().amount;
+        }
+    };
+    generate(pWallet->completed, stubConfig.completedTxCount, [](unsigned long long txId, unsigned int n) {
+        int status = n % 4 == 0 ? kTxStatusCompleted : n % 4 == 1 ? kTxStatusBroadcast : kTxStatusMined;
+        return makeRow(txId, n, status, n % 2 == 0);
+    });
+    generate(pWallet->cancelled, stubConfig.cancelledTxCount, [](unsigned long long txId, unsigned int n) {
+        return makeRow(txId, n, kTxStatusPending, n % 2 == 0);
+    });
+    generate(pWallet->pendingInbound, stubConfig.pendingInboundTxCount, [](unsigned long long txId, unsigned int n) {
+        return makeRow(txId, n, kTxStatusPending, false);
+    });
+    generate(pWallet->pendingOutbound, stubConfig.pendingOutboundTxCount, [](unsigned long long txId, unsigned int n) {
+        return makeRow(txId, n, kTxStatusPending, true);
+    });
+    for (unsigned int n = 0; n < stubConfig.contactCount; n++) {
+        TariContact contact;
+        contact.alias = makeText("Contact ", n, stubConfig.messageLength, stubConfig.emojiMessages);
+        // contacts are the counterparties of the first transactions
+        fillKey(n + 1, contact.publicKey.bytes);
+        pWallet->contacts.push_back(contact);
+    }
+    pWallet->nextTxId = id;
+    pWallet->nextRequestId = 1;
+    pWallet->confirmationsRequired = 3;
+    return pWallet;
+}
+
+char *wallet_sign_message(TariWallet *wallet, const char *msg, int *error_out) {
+    stubCall();
+    if (wallet == nullptr || msg == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    unsigned char signature[kKeySize];
+    unsigned char nonce[kKeySize];
+    fillKey(std::hash<std::string>()(msg), signature);
+    fillKey(strlen(msg), nonce);
+    return copyString(toHex(signature, kKeySize) + "|" + toHex(nonce, kKeySize));
+}
+
+bool wallet_verify_message_signature(TariWallet *wallet,
+                                     TariPublicKey *public_key,
+                                     const char *hex_sig_nonce,
+                                     const char *msg,
+                                     int *error_out) {
+    if (public_key == nullptr || hex_sig_nonce == nullptr) {
+        stubCall();
+        setError(error_out, kStubErrorNullPointer);
+        return false;
+    }
+    char *expected = wallet_sign_message(wallet, msg, error_out);
+    bool result = expected != nullptr && strcmp(expected, hex_sig_nonce) == 0;
+    free(expected);
+    return result;
+}
+
+bool wallet_test_generate_data(TariWallet *wallet, const char *datastore_path, int *error_out) {
+    stubCall();
+    setError(error_out, wallet == nullptr ? kStubErrorNullPointer : 0);
+    return wallet != nullptr;
+}
+
+bool wallet_add_base_node_peer(TariWallet *wallet,
+                               TariPublicKey *public_key,
+                               const char *address,
+                               int *error_out) {
+    stubCall();
+    bool valid = wallet != nullptr && public_key != nullptr && address != nullptr;
+    setError(error_out, valid ? 0 : kStubErrorNullPointer);
+    return valid;
+}
+
+static std::vector<TariContact>::iterator findContact(TariWallet *wallet, const TariPublicKey &publicKey) {
+    auto it = wallet->contacts.begin();
+    while (it != wallet->contacts.end() && memcmp(it->publicKey.bytes, publicKey.bytes, kKeySize) != 0) {
+        ++it;
+    }
+    return it;
+}
+
+bool wallet_upsert_contact(TariWallet *wallet, TariContact *contact, int *error_out) {
+    stubCall();
+    if (wallet == nullptr || contact == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return false;
+    }
+    setError(error_out, 0);
+    std::lock_guard<std::mutex> lock(wallet->mutex);
+    auto it = findContact(wallet, contact->publicKey);
+    if (it == wallet->contacts.end()) {
+        wallet->contacts.push_back(*contact);
+    } else {
+        it->alias = contact->alias;
+    }
+    return true;
+}
+
+bool wallet_remove_contact(TariWallet *wallet, TariContact *contact, int *error_out) {
+    stubCall();
+    if (wallet == nullptr || contact == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(wallet->mutex);
+    auto it = findContact(wallet, contact->publicKey);
+    if (it == wallet->contacts.end()) {
+        setError(error_out, kStubErrorNotFound);
+        return false;
+    }
+    setError(error_out, 0);
+    wallet->contacts.erase(it);
+    return true;
+}
+
+static unsigned long long balanceOf(TariWallet *wallet, StubTxKind TariWallet::*kind, int *error_out) {
+    stubCall();
+    if (wallet == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return 0;
+    }
+    setError(error_out, 0);
+    std::lock_guard<std::mutex> lock(wallet->mutex);
+    return (wallet->*kind).balance;
+}
+
+unsigned long long wallet_get_available_balance(TariWallet *wallet, int *error_out) {
+    return balanceOf(wallet, &TariWallet::completed, error_out);
+}
+
+unsigned long long wallet_get_pending_incoming_balance(TariWallet *wallet, int *error_out) {
+    return balanceOf(wallet, &TariWallet::pendingInbound, error_out);
+}
+
+unsigned long long wallet_get_pending_outgoing_balance(TariWallet *wallet, int *error_out) {
+    return balanceOf(wallet, &TariWallet::pendingOutbound, error_out);
+}
+
+unsigned long long wallet_send_transaction(TariWallet *wallet,
+                                           TariPublicKey *destination,
+                                           unsigned long long amount,
+                                           unsigned long long fee_per_gram,
+                                           const char *message,
+                                           int *error_out) {
+    stubCall();
+    if (wallet == nullptr || destination == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return 0;
+    }
+    setError(error_out, 0);
+    std::lock_guard<std::mutex> lock(wallet->mutex);
+    StubTxRow row = makeRow(wallet->nextTxId++, kTxStatusPending, true, amount, *destination, message);
+    row.fee = fee_per_gram * 10;
+    insertRow(wallet->pendingOutbound, row);
+    return row.id;
+}
+
+unsigned long long wallet_get_fee_estimate(TariWallet *wallet,
+                                           unsigned long long amount,
+                                           unsigned long long fee_per_gram,
+                                           unsigned long long num_kernels,
+                                           unsigned long long num_outputs,
+                                           int *error_out) {
+    stubCall();
+    setError(error_out, wallet == nullptr ? kStubErrorNullPointer : 0);
+    return fee_per_gram * (num_kernels * 10 + num_outputs * 20);
+}
+
+unsigned long long wallet_get_num_confirmations_required(TariWallet *wallet, int *error_out) {
+    stubCall();
+    if (wallet == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return 0;
+    }
+    setError(error_out, 0);
+    return wallet->confirmationsRequired;
+}
+
+void wallet_set_num_confirmations_required(TariWallet *wallet, unsigned long long num, int *error_out) {
+    stubCall();
+    if (wallet == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return;
+    }
+    setError(error_out, 0);
+    wallet->confirmationsRequired = num;
+}
+
+TariContacts *wallet_get_contacts(TariWallet *wallet, int *error_out) {
+    stubCall();
+    if (wallet == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    std::lock_guard<std::mutex> lock(wallet->mutex);
+    spinForElements(wallet->contacts.size());
+    return new TariContacts{wallet->contacts};
+}
+
+/**
+ * Collection of a transaction kind. The rows are shared with the wallet rather than copied, the
+ * copying cost of the library is modelled by elementLatencyNanos.
+ */
+template<typename Collection>
+static Collection *copyTxs(TariWallet *wallet, StubTxKind TariWallet::*kind, int *error_out) {
+    stubCall();
+    if (wallet == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    std::shared_ptr<const StubTxRows> rows;
+    StubTxStyle style;
+    {
+        std::lock_guard<std::mutex> lock(wallet->mutex);
+        rows = (wallet->*kind).rows;
+        style = wallet->style;
+    }
+    spinForElements(rows->size());
+    return new Collection{rows, style};
+}
+
+TariCompletedTransactions *wallet_get_completed_transactions(TariWallet *wallet, int *error_out) {
+    return copyTxs<TariCompletedTransactions>(wallet, &TariWallet::completed, error_out);
+}
+
+TariPendingOutboundTransactions *wallet_get_pending_outbound_transactions(TariWallet *wallet, int *error_out) {
+    return copyTxs<TariPendingOutboundTransactions>(wallet, &TariWallet::pendingOutbound, error_out);
+}
+
+TariPendingInboundTransactions *wallet_get_pending_inbound_transactions(TariWallet *wallet, int *error_out) {
+    return copyTxs<TariPendingInboundTransactions>(wallet, &TariWallet::pendingInbound, error_out);
+}
+
+TariCompletedTransactions *wallet_get_cancelled_transactions(TariWallet *wallet, int *error_out) {
+    return copyTxs<TariCompletedTransactions>(wallet, &TariWallet::cancelled, error_out);
+}
+
+template<typename Tx>
+static Tx *findTx(TariWallet *wallet, StubTxKind TariWallet::*kind,
+                  unsigned long long transaction_id, int *error_out) {
+    stubCall();
+    if (wallet == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(wallet->mutex);
+    const StubTxRows &rows = *(wallet->*kind).rows;
+    auto it = findRow(rows, transaction_id);
+    if (it == rows.end()) {
+        setError(error_out, kStubErrorNotFound);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    return new Tx{resolveRow(*it, wallet->style)};
+}
+
+TariCompletedTransaction *wallet_get_completed_transaction_by_id(TariWallet *wallet,
+                                                                 unsigned long long transaction_id,
+                                                                 int *error_out) {
+    return findTx<TariCompletedTransaction>(wallet, &TariWallet::completed, transaction_id, error_out);
+}
+
+TariPendingOutboundTransaction *wallet_get_pending_outbound_transaction_by_id(TariWallet *wallet,
+                                                                              unsigned long long transaction_id,
+                                                                              int *error_out) {
+    return findTx<TariPendingOutboundTransaction>(wallet, &TariWallet::pendingOutbound, transaction_id, error_out);
+}
+
+TariPendingInboundTransaction *wallet_get_pending_inbound_transaction_by_id(TariWallet *wallet,
+                                                                            unsigned long long transaction_id,
+                                                                            int *error_out) {
+    return findTx<TariPendingInboundTransaction>(wallet, &TariWallet::pendingInbound, transaction_id, error_out);
+}
+
+TariCompletedTransaction *wallet_get_cancelled_transaction_by_id(TariWallet *wallet,
+                                                                 unsigned long long transaction_id,
+                                                                 int *error_out) {
+    return findTx<TariCompletedTransaction>(wallet, &TariWallet::cancelled, transaction_id, error_out);
+}
+
+TariPublicKey *wallet_get_public_key(TariWallet *wallet, int *error_out) {
+    stubCall();
+    if (wallet == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    return new TariPublicKey(wallet->style.own);
+}
+
+unsigned long long wallet_import_utxo(TariWallet *wallet,
+                                      unsigned long long amount,
+                                      TariPrivateKey *spending_key,
+                                      TariPublicKey *source_public_key,
+                                      const char *message,
+                                      int *error_out) {
+    stubCall();
+    if (wallet == nullptr || spending_key == nullptr || source_public_key == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return 0;
+    }
+    setError(error_out, 0);
+    std::lock_guard<std::mutex> lock(wallet->mutex);
+    StubTxRow row = makeRow(wallet->nextTxId++, kTxStatusMined, false, amount, *source_public_key, message);
+    insertRow(wallet->completed, row);
+    return row.id;
+}
+
+static unsigned long long nextRequestId(TariWallet *wallet, int *error_out) {
+    stubCall();
+    if (wallet == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return 0;
+    }
+    setError(error_out, 0);
+    std::lock_guard<std::mutex> lock(wallet->mutex);
+    return wallet->nextRequestId++;
+}
+
+unsigned long long wallet_start_txo_validation(TariWallet *wallet, int *error_out) {
+    return nextRequestId(wallet, error_out);
+}
+
+unsigned long long wallet_start_transaction_validation(TariWallet *wallet, int *error_out) {
+    return nextRequestId(wallet, error_out);
+}
+
+unsigned long long wallet_restart_transaction_broadcast(TariWallet *wallet, int *error_out) {
+    return nextRequestId(wallet, error_out);
+}
+
+void wallet_set_low_power_mode(TariWallet *wallet, int *error_out) {
+    stubCall();
+    setError(error_out, wallet == nullptr ? kStubErrorNullPointer : 0);
+}
+
+void wallet_set_normal_power_mode(TariWallet *wallet, int *error_out) {
+    stubCall();
+    setError(error_out, wallet == nullptr ? kStubErrorNullPointer : 0);
+}
+
+bool wallet_cancel_pending_transaction(TariWallet *wallet,
+                                       unsigned long long transaction_id,
+                                       int *error_out) {
+    stubCall();
+    if (wallet == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(wallet->mutex);
+    for (StubTxKind *pending : {&wallet->pendingInbound, &wallet->pendingOutbound}) {
+        auto found = findRow(*pending->rows, transaction_id);
+        if (found != pending->rows->end()) {
+            StubTxRow row = *found;
+            auto position = found - pending->rows->begin();
+            StubTxRows &rows = mutableRows(*pending);
+            rows.erase(rows.begin() + position);
+            pending->balance -= row.amount;
+            insertRow(wallet->cancelled, row);
+            setError(error_out, 0);
+            return true;
+        }
+    }
+    setError(error_out, kStubErrorNotFound);
+    return false;
+}
+
+unsigned long long wallet_coin_split(TariWallet *wallet,
+                                     unsigned long long amount,
+                                     unsigned long long count,
+                                     unsigned long long fee,
+                                     const char *msg,
+                                     unsigned long long lock_height,
+                                     int *error_out) {
+    stubCall();
+    if (wallet == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return 0;
+    }
+    setError(error_out, 0);
+    std::lock_guard<std::mutex> lock(wallet->mutex);
+    StubTxRow row = makeRow(wallet->nextTxId++, kTxStatusCompleted, true, amount * count, wallet->style.own, msg);
+    row.fee = fee;
+    insertRow(wallet->completed, row);
+    return row.id;
+}
+
+TariSeedWords *wallet_get_seed_words(TariWallet *wallet, int *error_out) {
+    stubCall();
+    if (wallet == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    return new TariSeedWords{wallet->seedWords};
+}
+
+void wallet_apply_encryption(TariWallet *wallet, const char *passphrase, int *error_out) {
+    stubCall();
+    setError(error_out, wallet == nullptr || passphrase == nullptr ? kStubErrorNullPointer : 0);
+}
+
+void wallet_remove_encryption(TariWallet *wallet, int *error_out) {
+    stubCall();
+    setError(error_out, wallet == nullptr ? kStubErrorNullPointer : 0);
+}
+
+bool wallet_set_key_value(TariWallet *wallet, const char *key, const char *value, int *error_out) {
+    stubCall();
+    if (wallet == nullptr || key == nullptr || value == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return false;
+    }
+    setError(error_out, 0);
+    std::lock_guard<std::mutex> lock(wallet->mutex);
+    wallet->values[key] = value;
+    return true;
+}
+
+const char *wallet_get_value(TariWallet *wallet, const char *key, int *error_out) {
+    stubCall();
+    if (wallet == nullptr || key == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(wallet->mutex);
+    auto it = wallet->values.find(key);
+    if (it == wallet->values.end()) {
+        setError(error_out, kStubErrorNotFound);
+        return nullptr;
+    }
+    setError(error_out, 0);
+    return copyString(it->second);
+}
+
+bool wallet_clear_value(TariWallet *wallet, const char *key, int *error_out) {
+    stubCall();
+    if (wallet == nullptr || key == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return false;
+    }
+    setError(error_out, 0);
+    std::lock_guard<std::mutex> lock(wallet->mutex);
+    return wallet->values.erase(key) > 0;
+}
+
+bool wallet_is_recovery_in_progress(TariWallet *wallet, int *error_out) {
+    stubCall();
+    setError(error_out, wallet == nullptr ? kStubErrorNullPointer : 0);
+    return false;
+}
+
+bool wallet_start_recovery(TariWallet *wallet,
+                           TariPublicKey *base_node_public_key,
+                           void (*recovery_progress_callback)(unsigned char, unsigned long long, unsigned long long),
+                           int *error_out) {
+    stubCall();
+    if (wallet == nullptr || base_node_public_key == nullptr) {
+        setError(error_out, kStubErrorNullPointer);
+        return false;
+    }
+    setError(error_out, 0);
+    wallet->callbacks.recoveryProgress = recovery_progress_callback;
+    return true;
+}
+
+void wallet_destroy(TariWallet *wallet) {
+    stubCall();
+    delete wallet;
+}
+
+void log_debug_message(const char *msg) {
+    stubCall();
+    __android_log_print(ANDROID_LOG_DEBUG, "libwallet", "%s", msg);
+}
+
+// endregion
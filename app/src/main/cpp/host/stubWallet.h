@@ -0,0 +1,169 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef HOST_STUB_WALLET_H
+#define HOST_STUB_WALLET_H
+
+#include <wallet.h>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * In-process stand-in for libtari_wallet_ffi used by the host build. Every wallet.h function
+ * is answered from memory after an optional busy wait, so benchmarks of the JNI layer can be
+ * run against a library of known cost and collection sizes.
+ *
+ * Collection contents are generated when a wallet is created, from the configuration active at
+ * that point. Transactions are stored as compact rows, so wallets of millions of transactions
+ * fit in memory, and collections share the rows of the wallet instead of copying them. All
+ * handles returned by the stub are owned and must be released with the matching *_destroy
+ * function, like those of the real library.
+ */
+struct StubWalletConfig {
+    // busy wait added to every stub call, models the cost of crossing into the library
+    int64_t callLatencyNanos;
+    // additional busy wait of the wallet_get_* collection calls, per element copied
+    int64_t elementLatencyNanos;
+    unsigned int completedTxCount;
+    unsigned int cancelledTxCount;
+    unsigned int pendingInboundTxCount;
+    unsigned int pendingOutboundTxCount;
+    unsigned int contactCount;
+    // length of transaction messages and contact aliases in characters
+    unsigned int messageLength;
+    // messages made of emoji (4-byte UTF-8 sequences) instead of ASCII
+    bool emojiMessages;
+};
+
+/**
+ * Events the stub can raise through the callbacks registered by wallet_create.
+ */
+enum StubWalletCallback {
+    kStubTxReceived = 0,
+    kStubTxReplyReceived,
+    kStubTxFinalized,
+    kStubTxBroadcast,
+    kStubTxMined,
+    kStubTxMinedUnconfirmed,
+    kStubDirectSendResult,
+    kStubStoreAndForwardSendResult,
+    kStubTxCancelled,
+    kStubTxoValidationComplete,
+    kStubTxValidationComplete,
+    kStubSafMessageReceived,
+    kStubRecoveryProgress,
+    kStubWalletCallbackCount
+};
+
+/**
+ * Error codes set by the stub, not the values of the library.
+ */
+const int kStubErrorNullPointer = 1;
+const int kStubErrorPosition = 3;
+const int kStubErrorInvalidArgument = 4;
+const int kStubErrorNotFound = 5;
+
+StubWalletConfig stubWalletDefaultConfig();
+
+/**
+ * Applies to stub calls made from now on and to the collections of wallets created afterwards.
+ */
+void stubWalletConfigure(const StubWalletConfig &config);
+
+StubWalletConfig stubWalletGetConfig();
+
+/**
+ * Invokes a registered callback on the calling thread, standing in for a wallet library thread.
+ * Transaction events carry a fresh handle of the index-th transaction (modulo the collection
+ * size) of the matching kind. Returns false if the wallet did not register the callback or has
+ * no transaction of that kind.
+ */
+bool stubWalletEmitCallback(TariWallet *pWallet, StubWalletCallback callback, unsigned int index);
+
+/**
+ * Drops a transaction of any kind without raising a callback, as a reorg or a restored backup
+ * would. Returns false if the wallet has no transaction of that id.
+ */
+bool stubWalletRemoveTx(TariWallet *pWallet, unsigned long long id);
+
+/**
+ * Number of wallet.h functions called since start up.
+ */
+uint64_t stubWalletCallCount();
+
+/**
+ * Callback storm raised by stubWalletRunLoad.
+ */
+struct StubLoadConfig {
+    // threads standing in for the library's runtime, each raises an equal share of every rate
+    unsigned int threadCount;
+    // callbacks per second summed over all threads, 0 leaves a callback out
+    double eventsPerSecond[kStubWalletCallbackCount];
+    int64_t durationNanos;
+};
+
+struct StubLoadStats {
+    uint64_t emitted[kStubWalletCallbackCount];
+    // emissions of callbacks the wallet did not register or without transactions of their kind
+    uint64_t skipped;
+    int64_t elapsedNanos;
+    // time the callbacks held the raising threads, summed and longest
+    int64_t callNanosTotal;
+    int64_t callNanosMax;
+    // longest delay of an emission behind its schedule
+    int64_t maxLagNanos;
+};
+
+/**
+ * Raises callbacks from config.threadCount threads at the configured rates for
+ * config.durationNanos and returns once every thread stopped.
+ *
+ * Each callback follows a fixed schedule: a thread that falls behind catches up without waiting,
+ * so a slow callback shows up as latency of the events after it rather than as a lower rate.
+ * Every event is tagged with its scheduled time on the stubWalletNowNanos clock. Transaction
+ * handles carry it (see stubWalletEmitNanos), the other callbacks pass it in place of their tx
+ * or request id, or of the current value of recovery progress.
+ */
+StubLoadStats stubWalletRunLoad(TariWallet *pWallet, const StubLoadConfig &config);
+
+int64_t stubWalletNowNanos();
+
+/**
+ * Scheduled time of the load run event that delivered a transaction handle, 0 for handles not
+ * raised by stubWalletRunLoad.
+ */
+int64_t stubWalletEmitNanos(const TariCompletedTransaction *transaction);
+
+int64_t stubWalletEmitNanos(const TariPendingInboundTransaction *transaction);
+
+#endif // HOST_STUB_WALLET_H
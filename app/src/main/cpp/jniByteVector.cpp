@@ -35,10 +35,15 @@
 #include <android/log.h>
 #include <wallet.h>
 #include <string>
+#include <vector>
 #include <cmath>
 #include <android/log.h>
 #include "jniCommon.cpp"
 
+/**
+ * byte_vector_create copies the bytes, so the Java array is only pinned for the duration of that
+ * copy instead of being copied out first.
+ */
 extern "C"
 JNIEXPORT void JNICALL
 Java_com_tari_android_wallet_ffi_FFIByteVector_jniCreate(
@@ -46,19 +51,80 @@ Java_com_tari_android_wallet_ffi_FFIByteVector_jniCreate(
         jobject jThis,
         jbyteArray array,
         jobject error) {
-    auto *buffer = reinterpret_cast<unsigned char *>(jEnv->GetByteArrayElements(array, JNI_FALSE));
+    int i = 0;
+    int *r = &i;
     jsize size = jEnv->GetArrayLength(array);
-    for (int i = 0; i < size; i++) {
-        printf("%hhx", buffer[i]);
+    auto *buffer = static_cast<unsigned char *>(jEnv->GetPrimitiveArrayCritical(array, nullptr));
+    ByteVector *pByteVector = byte_vector_create(buffer, static_cast<unsigned int>(size), r);
+    jEnv->ReleasePrimitiveArrayCritical(array, buffer, JNI_ABORT);
+    setErrorCode(jEnv, error, i);
+    SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(pByteVector));
+}
+
+/**
+ * Creates the vector from length bytes at offset of a direct buffer, read in place.
+ */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_tari_android_wallet_ffi_FFIByteVector_jniCreateFromBuffer(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jobject jBuffer,
+        jint offset,
+        jint length,
+        jobject error) {
+    auto *buffer = static_cast<unsigned char *>(jEnv->GetDirectBufferAddress(jBuffer));
+    jlong capacity = jEnv->GetDirectBufferCapacity(jBuffer);
+    if (buffer == nullptr || offset < 0 || length < 0
+        || static_cast<jlong>(offset) + length > capacity) {
+        setErrorCode(jEnv, error, kErrorInvalidArgument);
+        return;
     }
     int i = 0;
     int *r = &i;
-    ByteVector *pByteVector = byte_vector_create(buffer, static_cast<unsigned int>(size), r);
+    ByteVector *pByteVector = byte_vector_create(buffer + offset, static_cast<unsigned int>(length), r);
     setErrorCode(jEnv, error, i);
-    jEnv->ReleaseByteArrayElements(array, reinterpret_cast<jbyte *>(buffer), JNI_ABORT);
     SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(pByteVector));
 }
 
+/**
+ * Copies the whole vector into the start of the array in one call and returns the vector
+ * length. Leaves the array untouched and returns the length if the array is too small.
+ */
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_tari_android_wallet_ffi_FFIByteVector_jniGetBytes(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jbyteArray array,
+        jobject error) {
+    int i = 0;
+    int *r = &i;
+    jlong lByteVector = GetPointerField(jEnv, jThis);
+    auto *pByteVector = reinterpret_cast<ByteVector *>(lByteVector);
+    unsigned int length = byte_vector_get_length(pByteVector, r);
+    if (i != 0 || length > static_cast<unsigned int>(jEnv->GetArrayLength(array))) {
+        setErrorCode(jEnv, error, i);
+        return static_cast<jint>(length);
+    }
+    // keys fit on the stack, Tor cookies and other larger vectors go to the heap
+    jbyte stackBytes[256];
+    std::vector<jbyte> heapBytes;
+    jbyte *bytes = stackBytes;
+    if (length > sizeof(stackBytes)) {
+        heapBytes.resize(length);
+        bytes = heapBytes.data();
+    }
+    for (unsigned int k = 0; k < length && i == 0; k++) {
+        bytes[k] = static_cast<jbyte>(byte_vector_get_at(pByteVector, k, r));
+    }
+    if (i == 0) {
+        jEnv->SetByteArrayRegion(array, 0, static_cast<jsize>(length), bytes);
+    }
+    setErrorCode(jEnv, error, i);
+    return static_cast<jint>(length);
+}
+
 extern "C"
 JNIEXPORT jint JNICALL
 Java_com_tari_android_wallet_ffi_FFIByteVector_jniGetLength(
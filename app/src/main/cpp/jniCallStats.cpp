@@ -0,0 +1,340 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef JNI_CALL_STATS_CPP
+#define JNI_CALL_STATS_CPP
+
+#include <jni.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+#include "jniFfiTrace.cpp"
+
+/**
+ * Call counters and latency histograms of the JNI entry points and the wallet callbacks.
+ *
+ * Built with TARI_JNI_CALL_STATS, the RegisterNatives table in jniRegistration.cpp binds every
+ * Java_com_tari_android_wallet_ffi_* function through CALL_STATS_ENTRY, a wrapper that times the
+ * call, and every wallet callback in jniWallet.cpp opens with CALL_STATS_CALLBACK. Without it
+ * both expand to the plain function and to nothing, and the table binds the functions directly.
+ *
+ * Each thread records into a block of its own, so recording takes no lock and no atomic
+ * read-modify-write: the owning thread is the only writer of its counters, and dump() merges
+ * the blocks of all threads with relaxed loads. A block outlives its thread and is taken over by
+ * the next new thread, so the counters of exited threads are kept without growing the list.
+ *
+ * Latencies go into log-linear histograms in the manner of HdrHistogram: exact below 16 ns, then
+ * 16 buckets per power of two, which bounds the error of a reported percentile to 1/16.
+ */
+
+/**
+ * Room for the entry points of the generated registration table, checked there.
+ */
+static const int kCallStatsEntryCapacity = 256;
+
+/**
+ * Sites are the entry points in registration table order followed by the wallet callbacks in
+ * FfiCallback order.
+ */
+static const int kCallStatsCallbackBase = kCallStatsEntryCapacity;
+static const int kCallStatsSiteCount = kCallStatsCallbackBase + kFfiCallbackCount;
+
+static const int kCallStatsSubBucketBits = 4;
+static const int kCallStatsSubBucketCount = 1 << kCallStatsSubBucketBits;
+// 2^40 ns is over 18 minutes, longer latencies are counted there
+static const int kCallStatsMaxExponent = 40;
+static const int kCallStatsBucketCount =
+        kCallStatsSubBucketCount * (kCallStatsMaxExponent - kCallStatsSubBucketBits + 2);
+
+inline int callStatsBucket(uint64_t nanos) {
+    if (nanos < static_cast<uint64_t>(kCallStatsSubBucketCount)) {
+        return static_cast<int>(nanos);
+    }
+    nanos = std::min<uint64_t>(nanos, (1ULL << (kCallStatsMaxExponent + 1)) - 1);
+    int exponent = 63 - __builtin_clzll(nanos);
+    int shift = exponent - kCallStatsSubBucketBits;
+    int subBucket = static_cast<int>(nanos >> shift) - kCallStatsSubBucketCount;
+    return kCallStatsSubBucketCount * (shift + 1) + subBucket;
+}
+
+/**
+ * Highest latency counted in the bucket.
+ */
+inline uint64_t callStatsBucketLimit(int bucket) {
+    if (bucket < kCallStatsSubBucketCount) {
+        return static_cast<uint64_t>(bucket);
+    }
+    int shift = bucket / kCallStatsSubBucketCount - 1;
+    uint64_t subBucket = static_cast<uint64_t>(bucket % kCallStatsSubBucketCount);
+    return ((kCallStatsSubBucketCount + subBucket + 1) << shift) - 1;
+}
+
+inline int64_t callStatsClockNanos() {
+    timespec time{};
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<int64_t>(time.tv_sec) * 1000000000LL + time.tv_nsec;
+}
+
+/**
+ * Counters of one site on one thread, written by that thread only.
+ */
+struct CallSiteStats {
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> totalNanos;
+    std::atomic<uint64_t> maxNanos;
+    std::atomic<uint32_t> buckets[kCallStatsBucketCount];
+
+    void add(uint64_t nanos) {
+        bump(count, 1);
+        bump(totalNanos, nanos);
+        if (nanos > maxNanos.load(std::memory_order_relaxed)) {
+            maxNanos.store(nanos, std::memory_order_relaxed);
+        }
+        bump(buckets[callStatsBucket(nanos)], 1);
+    }
+
+private:
+    template<typename T>
+    static void bump(std::atomic<T> &counter, uint64_t amount) {
+        counter.store(static_cast<T>(counter.load(std::memory_order_relaxed) + amount),
+                      std::memory_order_relaxed);
+    }
+};
+
+/**
+ * Counters of one thread, the site counters allocated on the first call of the site.
+ */
+struct CallStatsThread {
+    std::atomic<CallSiteStats *> sites[kCallStatsSiteCount];
+    std::atomic<bool> owned;
+    CallStatsThread *next;
+};
+
+class CallStats {
+public:
+    void record(int site, int64_t nanos) {
+        CallStatsThread *pThread = currentThread();
+        CallSiteStats *pSite = pThread->sites[site].load(std::memory_order_relaxed);
+        if (pSite == nullptr) {
+            pSite = new CallSiteStats();
+            pThread->sites[site].store(pSite, std::memory_order_release);
+        }
+        pSite->add(static_cast<uint64_t>(std::max<int64_t>(nanos, 0)));
+    }
+
+    /**
+     * Report of the sites called so far, the entry points named by entryNames, each list ordered
+     * by total time.
+     */
+    std::string dump(const char *const *entryNames, int entryCount) {
+        std::string report = "JNI entry points (calls, total ms, mean/p50/p90/p99/max ns):\n";
+        appendSites(report, 0, entryCount, entryNames);
+        report += "Wallet callbacks (calls, total ms, mean/p50/p90/p99/max ns):\n";
+        appendSites(report, kCallStatsCallbackBase, kFfiCallbackCount, kFfiCallbackNames);
+        return report;
+    }
+
+private:
+    struct Merged {
+        uint64_t count = 0;
+        uint64_t totalNanos = 0;
+        uint64_t maxNanos = 0;
+        std::vector<uint64_t> buckets;
+    };
+
+    /**
+     * Hands the calling thread a block, a free one of an exited thread if there is one.
+     */
+    CallStatsThread *currentThread() {
+        struct Lease {
+            CallStatsThread *pThread = nullptr;
+
+            ~Lease() {
+                if (pThread != nullptr) {
+                    pThread->owned.store(false, std::memory_order_release);
+                }
+            }
+        };
+        static thread_local Lease t_lease;
+        if (t_lease.pThread != nullptr) {
+            return t_lease.pThread;
+        }
+        for (CallStatsThread *pThread = threads.load(std::memory_order_acquire);
+             pThread != nullptr; pThread = pThread->next) {
+            bool expected = false;
+            if (!pThread->owned.load(std::memory_order_relaxed) &&
+                pThread->owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                t_lease.pThread = pThread;
+                return pThread;
+            }
+        }
+        auto *pThread = new CallStatsThread();
+        pThread->owned.store(true, std::memory_order_relaxed);
+        pThread->next = threads.load(std::memory_order_relaxed);
+        while (!threads.compare_exchange_weak(pThread->next, pThread, std::memory_order_release,
+                                              std::memory_order_relaxed)) {
+        }
+        t_lease.pThread = pThread;
+        return pThread;
+    }
+
+    bool merge(int site, Merged &merged) {
+        merged.count = 0;
+        merged.totalNanos = 0;
+        merged.maxNanos = 0;
+        merged.buckets.assign(kCallStatsBucketCount, 0);
+        for (CallStatsThread *pThread = threads.load(std::memory_order_acquire);
+             pThread != nullptr; pThread = pThread->next) {
+            CallSiteStats *pSite = pThread->sites[site].load(std::memory_order_acquire);
+            if (pSite == nullptr) {
+                continue;
+            }
+            merged.count += pSite->count.load(std::memory_order_relaxed);
+            merged.totalNanos += pSite->totalNanos.load(std::memory_order_relaxed);
+            merged.maxNanos = std::max(merged.maxNanos, pSite->maxNanos.load(std::memory_order_relaxed));
+            for (int bucket = 0; bucket < kCallStatsBucketCount; bucket++) {
+                merged.buckets[bucket] += pSite->buckets[bucket].load(std::memory_order_relaxed);
+            }
+        }
+        return merged.count != 0;
+    }
+
+    static uint64_t percentile(const Merged &merged, double fraction) {
+        uint64_t histogramCount = 0;
+        for (uint64_t count : merged.buckets) {
+            histogramCount += count;
+        }
+        auto rank = static_cast<uint64_t>(fraction * static_cast<double>(histogramCount) + 0.5);
+        rank = std::max<uint64_t>(rank, 1);
+        uint64_t seen = 0;
+        for (int bucket = 0; bucket < kCallStatsBucketCount; bucket++) {
+            seen += merged.buckets[bucket];
+            if (seen >= rank) {
+                return std::min(callStatsBucketLimit(bucket), merged.maxNanos);
+            }
+        }
+        return merged.maxNanos;
+    }
+
+    void appendSites(std::string &report, int firstSite, int siteCount, const char *const *names) {
+        std::multimap<uint64_t, std::string, std::greater<uint64_t>> ranked;
+        char line[256];
+        Merged merged;
+        for (int n = 0; n < siteCount; n++) {
+            if (!merge(firstSite + n, merged)) {
+                continue;
+            }
+            snprintf(line, sizeof(line), "  %s: %llu, %.3f ms, %llu/%llu/%llu/%llu/%llu\n", names[n],
+                     static_cast<unsigned long long>(merged.count),
+                     static_cast<double>(merged.totalNanos) / 1e6,
+                     static_cast<unsigned long long>(merged.totalNanos / merged.count),
+                     static_cast<unsigned long long>(percentile(merged, 0.5)),
+                     static_cast<unsigned long long>(percentile(merged, 0.9)),
+                     static_cast<unsigned long long>(percentile(merged, 0.99)),
+                     static_cast<unsigned long long>(merged.maxNanos));
+            ranked.insert(std::make_pair(merged.totalNanos, std::string(line)));
+        }
+        for (const auto &site : ranked) {
+            report += site.second;
+        }
+    }
+
+    std::atomic<CallStatsThread *> threads{nullptr};
+};
+
+extern CallStats g_callStats;
+
+/**
+ * Times its scope as a call of the site.
+ */
+class CallStatsTimer {
+public:
+    explicit CallStatsTimer(int site) : site(site), start(callStatsClockNanos()) {}
+
+    ~CallStatsTimer() {
+        g_callStats.record(site, callStatsClockNanos() - start);
+    }
+
+    CallStatsTimer(const CallStatsTimer &) = delete;
+
+    CallStatsTimer &operator=(const CallStatsTimer &) = delete;
+
+private:
+    const int site;
+    const int64_t start;
+};
+
+template<typename Function, Function function, int entry>
+struct CallStatsEntry;
+
+/**
+ * Entry point bound in place of function, timing each call of it.
+ */
+template<typename Result, typename... Params, Result (*function)(JNIEnv *, Params...), int entry>
+struct CallStatsEntry<Result (*)(JNIEnv *, Params...), function, entry> {
+    static Result JNICALL call(JNIEnv *jEnv, Params... params) {
+        CallStatsTimer timer(entry);
+        return function(jEnv, params...);
+    }
+};
+
+#if TARI_JNI_CALL_STATS
+
+#if !TARI_JNI_STATIC_REGISTRATION
+#error "TARI_JNI_CALL_STATS needs TARI_JNI_STATIC_REGISTRATION to wrap the entry points"
+#endif
+
+/**
+ * Names of the entry points in registration table order, from jniRegistration.cpp.
+ */
+extern const char *const kJniEntryNames[];
+extern const int kJniEntryCount;
+
+#define CALL_STATS_ENTRY(entry, function) \
+    reinterpret_cast<void *>(CallStatsEntry<decltype(&function), &function, entry>::call)
+#define CALL_STATS_CALLBACK(callback) \
+    CallStatsTimer callStatsTimer(kCallStatsCallbackBase + (callback))
+
+#else
+
+#define CALL_STATS_ENTRY(entry, function) reinterpret_cast<void *>(function)
+#define CALL_STATS_CALLBACK(callback)
+
+#endif
+
+#endif // JNI_CALL_STATS_CPP
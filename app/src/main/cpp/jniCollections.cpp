@@ -35,10 +35,154 @@
 #include <android/log.h>
 #include <wallet.h>
 #include <string>
+#include <cstring>
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <android/log.h>
 #include "jniCommon.cpp"
 
+/**
+ * Packed layout written by the jniWriteSnapshot entry points below into a direct ByteBuffer,
+ * in native byte order (TxSnapshot.kt reads it back):
+ *
+ * header, 16 bytes:
+ *   int32  layout version, kTxSnapshotVersion
+ *   int32  record count
+ *   int32  bytes used, header included
+ *   int32  reserved, 0
+ *
+ * record, starts 8-byte aligned:
+ *   int64  id, amount, fee, timestamp, confirmation count - raw unsigned bits, 0 when the tx
+ *          kind has no such field (pending inbound fee, pending confirmation count)
+ *   int32  status
+ *   int32  flags, kTxSnapshotOutbound
+ *   32     counterparty public key bytes
+ *   int32  message length in bytes, followed by the UTF-8 message, zero-padded to 8 bytes
+ *
+ * The entry points return the capacity the whole snapshot needs. If the buffer is too small they
+ * stop at the first record that does not fit, write only the header (with a record count of 0)
+ * and return an estimate instead: the records seen so far extrapolated to the whole collection,
+ * and at least twice the buffer capacity, so the caller's retries grow geometrically and the
+ * records past the overflow are never read.
+ */
+static const jint kTxSnapshotVersion = 1;
+static const jint kTxSnapshotOutbound = 1;
+static const size_t kTxSnapshotHeaderSize = 16;
+static const size_t kTxSnapshotKeySize = 32;
+static const size_t kTxSnapshotFixedRecordSize = 5 * 8 + 2 * 4 + kTxSnapshotKeySize + 4;
+
+class TxSnapshotWriter {
+public:
+    TxSnapshotWriter(JNIEnv *jEnv, jobject jBuffer) :
+            pBase(static_cast<unsigned char *>(jEnv->GetDirectBufferAddress(jBuffer))),
+            capacity(pBase == nullptr ? 0 : static_cast<size_t>(jEnv->GetDirectBufferCapacity(jBuffer))),
+            size(kTxSnapshotHeaderSize),
+            count(0),
+            pRecord(nullptr),
+            overflowed(false) {}
+
+    bool isValid() const {
+        return pBase != nullptr && capacity >= kTxSnapshotHeaderSize;
+    }
+
+    /**
+     * Reserves a record sized for the message, which is the only variable-length field, and
+     * copies the message into it. Returns false if the record does not fit, the caller then
+     * stops without reading the other fields. Takes ownership of pMessage.
+     */
+    bool begin(const char *pMessage) {
+        size_t messageLength = pMessage == nullptr ? 0 : strlen(pMessage);
+        size_t recordSize = (kTxSnapshotFixedRecordSize + messageLength + 7) & ~static_cast<size_t>(7);
+        bool fits = size + recordSize <= capacity;
+        if (fits) {
+            pRecord = pBase + size;
+            memset(pRecord, 0, recordSize);
+            unsigned char *p = pRecord + kTxSnapshotFixedRecordSize - 4;
+            p = put(p, static_cast<jint>(messageLength));
+            if (messageLength > 0) {
+                memcpy(p, pMessage, messageLength);
+            }
+            count++;
+        } else {
+            overflowed = true;
+        }
+        size += recordSize;
+        if (pMessage != nullptr) {
+            string_destroy(const_cast<char *>(pMessage));
+        }
+        return fits;
+    }
+
+    /**
+     * Fills the fixed fields of the record begun last. Takes ownership of pPublicKey.
+     */
+    void add(unsigned long long id,
+             unsigned long long amount,
+             unsigned long long fee,
+             unsigned long long timestamp,
+             unsigned long long confirmationCount,
+             int status,
+             jint flags,
+             TariPublicKey *pPublicKey,
+             int *r) {
+        unsigned char *p = pRecord;
+        p = put(p, id);
+        p = put(p, amount);
+        p = put(p, fee);
+        p = put(p, timestamp);
+        p = put(p, confirmationCount);
+        p = put(p, static_cast<jint>(status));
+        p = put(p, flags);
+        ByteVector *pBytes = pPublicKey == nullptr ? nullptr : public_key_get_bytes(pPublicKey, r);
+        if (pBytes != nullptr) {
+            // libwallet has no bulk ByteVector accessor
+            unsigned int length = byte_vector_get_length(pBytes, r);
+            for (unsigned int k = 0; k < length && k < kTxSnapshotKeySize; k++) {
+                p[k] = byte_vector_get_at(pBytes, k, r);
+            }
+            byte_vector_destroy(pBytes);
+        }
+        if (pPublicKey != nullptr) {
+            public_key_destroy(pPublicKey);
+        }
+    }
+
+    /**
+     * Writes the header and returns the capacity the snapshot needs, estimated from the records
+     * seen so far if remaining records were not reached.
+     */
+    jint finish(unsigned int remaining) {
+        unsigned char *p = pBase;
+        p = put(p, kTxSnapshotVersion);
+        p = put(p, overflowed ? 0 : count);
+        p = put(p, static_cast<jint>(overflowed ? kTxSnapshotHeaderSize : size));
+        put(p, static_cast<jint>(0));
+        if (!overflowed) {
+            return static_cast<jint>(size);
+        }
+        // count excludes the record that overflowed, size includes it
+        size_t seen = static_cast<size_t>(count) + 1;
+        double required = size + static_cast<double>(size - kTxSnapshotHeaderSize) / seen * remaining;
+        required = std::max(required, 2.0 * static_cast<double>(capacity));
+        return static_cast<jint>(std::min(required, static_cast<double>(INT32_MAX)));
+    }
+
+private:
+    template<typename T>
+    static unsigned char *put(unsigned char *p, T value) {
+        memcpy(p, &value, sizeof(value));
+        return p + sizeof(value);
+    }
+
+    unsigned char *pBase;
+    size_t capacity;
+    size_t size;
+    jint count;
+    unsigned char *pRecord;
+    bool overflowed;
+};
+
 extern "C"
 JNIEXPORT jint JNICALL
 Java_com_tari_android_wallet_ffi_FFIContacts_jniGetLength(
@@ -114,6 +258,54 @@ Java_com_tari_android_wallet_ffi_FFICompletedTxs_jniGetAt(
     return result;
 }
 
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_tari_android_wallet_ffi_FFICompletedTxs_jniWriteSnapshot(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jobject jBuffer,
+        jobject error) {
+    int i = 0;
+    int *r = &i;
+    TxSnapshotWriter writer(jEnv, jBuffer);
+    if (!writer.isValid()) {
+        setErrorCode(jEnv, error, kErrorInvalidArgument);
+        return 0;
+    }
+    jlong lCompletedTransactions = GetPointerField(jEnv, jThis);
+    auto *pCompletedTransactions = reinterpret_cast<TariCompletedTransactions *>(lCompletedTransactions);
+    unsigned int length = completed_transactions_get_length(pCompletedTransactions, r);
+    unsigned int index = 0;
+    for (; index < length && i == 0; index++) {
+        TariCompletedTransaction *pTx = completed_transactions_get_at(pCompletedTransactions, index, r);
+        if (pTx == nullptr) {
+            break;
+        }
+        if (!writer.begin(completed_transaction_get_message(pTx, r))) {
+            completed_transaction_destroy(pTx);
+            index++;
+            break;
+        }
+        bool isOutbound = completed_transaction_is_outbound(pTx, r);
+        writer.add(
+                completed_transaction_get_transaction_id(pTx, r),
+                completed_transaction_get_amount(pTx, r),
+                completed_transaction_get_fee(pTx, r),
+                completed_transaction_get_timestamp(pTx, r),
+                completed_transaction_get_confirmations(pTx, r),
+                completed_transaction_get_status(pTx, r),
+                isOutbound ? kTxSnapshotOutbound : 0,
+                isOutbound
+                ? completed_transaction_get_destination_public_key(pTx, r)
+                : completed_transaction_get_source_public_key(pTx, r),
+                r
+        );
+        completed_transaction_destroy(pTx);
+    }
+    setErrorCode(jEnv, error, i);
+    return writer.finish(length - std::min(index, length));
+}
+
 extern "C"
 JNIEXPORT void JNICALL
 Java_com_tari_android_wallet_ffi_FFICompletedTxs_jniDestroy(
@@ -162,6 +354,51 @@ Java_com_tari_android_wallet_ffi_FFIPendingInboundTxs_jniGetAt(
     return result;
 }
 
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_tari_android_wallet_ffi_FFIPendingInboundTxs_jniWriteSnapshot(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jobject jBuffer,
+        jobject error) {
+    int i = 0;
+    int *r = &i;
+    TxSnapshotWriter writer(jEnv, jBuffer);
+    if (!writer.isValid()) {
+        setErrorCode(jEnv, error, kErrorInvalidArgument);
+        return 0;
+    }
+    jlong lInboundTransactions = GetPointerField(jEnv, jThis);
+    auto *pInboundTxs = reinterpret_cast<TariPendingInboundTransactions *>(lInboundTransactions);
+    unsigned int length = pending_inbound_transactions_get_length(pInboundTxs, r);
+    unsigned int index = 0;
+    for (; index < length && i == 0; index++) {
+        TariPendingInboundTransaction *pTx = pending_inbound_transactions_get_at(pInboundTxs, index, r);
+        if (pTx == nullptr) {
+            break;
+        }
+        if (!writer.begin(pending_inbound_transaction_get_message(pTx, r))) {
+            pending_inbound_transaction_destroy(pTx);
+            index++;
+            break;
+        }
+        writer.add(
+                pending_inbound_transaction_get_transaction_id(pTx, r),
+                pending_inbound_transaction_get_amount(pTx, r),
+                0,
+                pending_inbound_transaction_get_timestamp(pTx, r),
+                0,
+                pending_inbound_transaction_get_status(pTx, r),
+                0,
+                pending_inbound_transaction_get_source_public_key(pTx, r),
+                r
+        );
+        pending_inbound_transaction_destroy(pTx);
+    }
+    setErrorCode(jEnv, error, i);
+    return writer.finish(length - std::min(index, length));
+}
+
 extern "C"
 JNIEXPORT void JNICALL
 Java_com_tari_android_wallet_ffi_FFIPendingInboundTxs_jniDestroy(
@@ -211,6 +448,51 @@ Java_com_tari_android_wallet_ffi_FFIPendingOutboundTxs_jniGetAt(
     return result;
 }
 
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_tari_android_wallet_ffi_FFIPendingOutboundTxs_jniWriteSnapshot(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jobject jBuffer,
+        jobject error) {
+    int i = 0;
+    int *r = &i;
+    TxSnapshotWriter writer(jEnv, jBuffer);
+    if (!writer.isValid()) {
+        setErrorCode(jEnv, error, kErrorInvalidArgument);
+        return 0;
+    }
+    jlong lOutboundTransactions = GetPointerField(jEnv, jThis);
+    auto *pOutboundTxs = reinterpret_cast<TariPendingOutboundTransactions *>(lOutboundTransactions);
+    unsigned int length = pending_outbound_transactions_get_length(pOutboundTxs, r);
+    unsigned int index = 0;
+    for (; index < length && i == 0; index++) {
+        TariPendingOutboundTransaction *pTx = pending_outbound_transactions_get_at(pOutboundTxs, index, r);
+        if (pTx == nullptr) {
+            break;
+        }
+        if (!writer.begin(pending_outbound_transaction_get_message(pTx, r))) {
+            pending_outbound_transaction_destroy(pTx);
+            index++;
+            break;
+        }
+        writer.add(
+                pending_outbound_transaction_get_transaction_id(pTx, r),
+                pending_outbound_transaction_get_amount(pTx, r),
+                pending_outbound_transaction_get_fee(pTx, r),
+                pending_outbound_transaction_get_timestamp(pTx, r),
+                0,
+                pending_outbound_transaction_get_status(pTx, r),
+                kTxSnapshotOutbound,
+                pending_outbound_transaction_get_destination_public_key(pTx, r),
+                r
+        );
+        pending_outbound_transaction_destroy(pTx);
+    }
+    setErrorCode(jEnv, error, i);
+    return writer.finish(length - std::min(index, length));
+}
+
 extern "C"
 JNIEXPORT void JNICALL
 Java_com_tari_android_wallet_ffi_FFIPendingOutboundTxs_jniDestroy(
@@ -30,14 +30,36 @@
  * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
+#ifndef JNI_COMMON_CPP
+#define JNI_COMMON_CPP
+
 #include <jni.h>
 #include <android/log.h>
 #include <string>
 #include <cmath>
+#include <ctime>
+#include <cerrno>
+#include <cstdlib>
 #include <android/log.h>
+#include "jniHandleStats.cpp"
+#include "jniFfiTrace.cpp"
+#include "jniCallStats.cpp"
 
 #define LOG_TAG "Tari Wallet"
 
+/**
+ * Error code reported by the native layer itself when an argument is rejected before it reaches
+ * the wallet library. Mirrors WalletErrorCode.INVALID_ARGUMENT on the Kotlin side.
+ */
+static const jint kErrorInvalidArgument = 1000001;
+
+/**
+ * Set by CMake when native methods are bound through the RegisterNatives table.
+ */
+#ifndef TARI_JNI_STATIC_REGISTRATION
+#define TARI_JNI_STATIC_REGISTRATION 0
+#endif
+
 /**
  * Log functions. Log example:
  *
@@ -51,44 +73,213 @@
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO,     LOG_TAG, __VA_ARGS__)
 #define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG,    LOG_TAG, __VA_ARGS__)
 
-inline jlong GetPointerField(JNIEnv *jEnv, jobject jThis) {
-    jclass cls = jEnv->GetObjectClass(jThis);
-    jfieldID fid = jEnv->GetFieldID(cls, "pointer", "J");
-    jlong lByteVector = jEnv->GetLongField(jThis, fid);
-    return lByteVector;
+/**
+ * FFI classes whose global references are held by the ID registry.
+ * Keep in sync with kFFIClassNames below.
+ */
+enum FFIClass {
+    kFFIBase = 0,
+    kFFIByteVector,
+    kFFICommsConfig,
+    kFFICompletedTx,
+    kFFICompletedTxKernel,
+    kFFICompletedTxs,
+    kFFIContact,
+    kFFIContacts,
+    kFFIEmojiSet,
+    kFFIError,
+    kFFIHandleArena,
+    kFFIPendingInboundTx,
+    kFFIPendingInboundTxs,
+    kFFIPendingOutboundTx,
+    kFFIPendingOutboundTxs,
+    kFFIPrivateKey,
+    kFFIPublicKey,
+    kFFISeedWords,
+    kFFITransportType,
+    kFFITxTable,
+    kFFIUtil,
+    kFFIWallet,
+    kFFIClassCount
+};
+
+static const char *const kFFIClassNames[kFFIClassCount] = {
+        "com/tari/android/wallet/ffi/FFIBase",
+        "com/tari/android/wallet/ffi/FFIByteVector",
+        "com/tari/android/wallet/ffi/FFICommsConfig",
+        "com/tari/android/wallet/ffi/FFICompletedTx",
+        "com/tari/android/wallet/ffi/FFICompletedTxKernel",
+        "com/tari/android/wallet/ffi/FFICompletedTxs",
+        "com/tari/android/wallet/ffi/FFIContact",
+        "com/tari/android/wallet/ffi/FFIContacts",
+        "com/tari/android/wallet/ffi/FFIEmojiSet",
+        "com/tari/android/wallet/ffi/FFIError",
+        "com/tari/android/wallet/ffi/FFIHandleArena",
+        "com/tari/android/wallet/ffi/FFIPendingInboundTx",
+        "com/tari/android/wallet/ffi/FFIPendingInboundTxs",
+        "com/tari/android/wallet/ffi/FFIPendingOutboundTx",
+        "com/tari/android/wallet/ffi/FFIPendingOutboundTxs",
+        "com/tari/android/wallet/ffi/FFIPrivateKey",
+        "com/tari/android/wallet/ffi/FFIPublicKey",
+        "com/tari/android/wallet/ffi/FFISeedWords",
+        "com/tari/android/wallet/ffi/FFITransportType",
+        "com/tari/android/wallet/ffi/FFITxTable",
+        "com/tari/android/wallet/ffi/FFIUtil",
+        "com/tari/android/wallet/ffi/FFIWallet"
+};
+
+/**
+ * Class and field IDs resolved once in JNI_OnLoad (jniWallet.cpp) and shared by all entry
+ * points. Field IDs remain valid for as long as their class is loaded, which the global class
+ * references guarantee.
+ *
+ * The pointer field is declared in FFIBase, so its ID is valid for every FFI* subclass.
+ */
+struct JniIdRegistry {
+    jclass classes[kFFIClassCount];
+    // element class of the String[] results
+    jclass stringClass;
+    jfieldID pointerField;
+    jfieldID errorCodeField;
+};
+
+extern JniIdRegistry g_ids;
+
+/**
+ * Populates the ID registry. Returns false (with a pending Java exception) if any class or
+ * field could not be resolved.
+ */
+inline bool initIdRegistry(JNIEnv *jEnv) {
+    for (int i = 0; i < kFFIClassCount; i++) {
+        jclass localClass = jEnv->FindClass(kFFIClassNames[i]);
+        if (localClass == nullptr) {
+            LOGE("Class not found: %s", kFFIClassNames[i]);
+            return false;
+        }
+        g_ids.classes[i] = static_cast<jclass>(jEnv->NewGlobalRef(localClass));
+        jEnv->DeleteLocalRef(localClass);
+    }
+    jclass localStringClass = jEnv->FindClass("java/lang/String");
+    if (localStringClass == nullptr) {
+        LOGE("Class not found: java/lang/String");
+        return false;
+    }
+    g_ids.stringClass = static_cast<jclass>(jEnv->NewGlobalRef(localStringClass));
+    jEnv->DeleteLocalRef(localStringClass);
+    g_ids.pointerField = jEnv->GetFieldID(g_ids.classes[kFFIBase], "pointer", "J");
+    if (g_ids.pointerField == nullptr) {
+        LOGE("Field not found: FFIBase.pointer");
+        return false;
+    }
+    g_ids.errorCodeField = jEnv->GetFieldID(g_ids.classes[kFFIError], "code", "I");
+    if (g_ids.errorCodeField == nullptr) {
+        LOGE("Field not found: FFIError.code");
+        return false;
+    }
+    return true;
 }
 
-inline void SetPointerField(JNIEnv *jEnv, jobject jThis, jlong jPointer) {
-    jclass cls = jEnv->GetObjectClass(jThis);
-    jfieldID fid = jEnv->GetFieldID(cls, "pointer", "J");
-    jEnv->SetLongField(jThis, fid, jPointer);
+/**
+ * Time spent in JNI_OnLoad and the number of native methods it registered (zero when the
+ * library relies on the VM's symbol lookup instead).
+ */
+struct LoadStats {
+    jlong onLoadNanos;
+    jint registeredMethodCount;
+};
+
+extern LoadStats g_loadStats;
+
+/**
+ * Monotonic clock reading in nanoseconds.
+ */
+inline jlong nowNanos() {
+    timespec time{};
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<jlong>(time.tv_sec) * 1000000000LL + time.tv_nsec;
 }
 
-// function included in multiple source files must be inline
-inline jbyteArray getBytesFromUnsignedLongLong(JNIEnv *jEnv, unsigned long long value) {
-    const size_t size = sizeof(unsigned long long int);
-    jbyteArray result = jEnv->NewByteArray((jsize) size);
-    if (result != nullptr) {
-        jbyte *cbytes = jEnv->GetByteArrayElements(result, nullptr);
-        if (cbytes != nullptr) {
-            int i;
-            for (i = (int) (size - 1); i >= 0; i--) {
-                cbytes[i] = (jbyte) (value & 0xFF);
-                value >>= 8;
-            }
-            jEnv->ReleaseByteArrayElements(result, cbytes, 0);
-        }
+inline jlong GetPointerField(JNIEnv *jEnv, jobject jThis) {
+    return jEnv->GetLongField(jThis, g_ids.pointerField);
+}
+
+/**
+ * Innermost handle arena activated on the calling thread, or null. Defined with the arena in
+ * jniHandleArena.cpp.
+ */
+struct HandleArena;
+extern thread_local HandleArena *t_activeArena;
+
+/**
+ * Records a handle that was just attached to jOwner in the active arena of the calling thread.
+ */
+void adoptHandle(JNIEnv *jEnv, jobject jOwner, jlong jPointer);
+
+inline void SetPointerField(JNIEnv *jEnv, jobject jThis, jlong jPointer) {
+    jEnv->SetLongField(jThis, g_ids.pointerField, jPointer);
+    if (jPointer != 0 && t_activeArena != nullptr) {
+        adoptHandle(jEnv, jThis, jPointer);
     }
-    return result;
 }
 
+// function included in multiple source files must be inline
 inline jboolean setErrorCode(JNIEnv *jEnv, jobject error, jint value) {
-    jclass errorClass = jEnv->GetObjectClass(error);
-    if (errorClass == nullptr)
+    if (error == nullptr)
         return static_cast<jboolean>(false);
-    jfieldID errorField = jEnv->GetFieldID(errorClass, "code", "I");
-    if (errorField == nullptr)
-        return static_cast<jboolean>(false);
-    jEnv->SetIntField(error, errorField, value);
+    jEnv->SetIntField(error, g_ids.errorCodeField, value);
     return static_cast<jboolean>(true);
-}
\ No newline at end of file
+}
+
+/**
+ * Reads a MicroTari amount, fee or count passed as a primitive jlong. These are unsigned on the
+ * wallet side, but no valid value comes anywhere near 2^63, so a negative jlong is a sign error in
+ * the caller rather than a large unsigned value. Sets kErrorInvalidArgument and returns false in
+ * that case. Transaction ids, which do use the full 64 bits, are cast from their raw bits instead.
+ */
+inline bool getUnsignedAmount(JNIEnv *jEnv, jlong jValue, unsigned long long *value, jobject error) {
+    if (jValue < 0) {
+        setErrorCode(jEnv, error, kErrorInvalidArgument);
+        return false;
+    }
+    *value = static_cast<unsigned long long>(jValue);
+    return true;
+}
+
+/**
+ * Strict decimal parser for the string-based compatibility entry points. Accepts only a
+ * non-empty run of ASCII digits that fits into 64 bits (no sign, whitespace or trailing
+ * characters, which strtoull would otherwise silently accept or wrap). Sets
+ * kErrorInvalidArgument and returns false on any other input.
+ */
+inline bool parseUnsignedLongLong(JNIEnv *jEnv, jstring jValue, unsigned long long *value, jobject error) {
+    if (jValue == nullptr) {
+        setErrorCode(jEnv, error, kErrorInvalidArgument);
+        return false;
+    }
+    const char *pValue = jEnv->GetStringUTFChars(jValue, JNI_FALSE);
+    bool valid = pValue[0] >= '0' && pValue[0] <= '9';
+    if (valid) {
+        char *end = nullptr;
+        errno = 0;
+        *value = strtoull(pValue, &end, 10);
+        valid = errno != ERANGE && *end == '\0';
+    }
+    jEnv->ReleaseStringUTFChars(jValue, pValue);
+    if (!valid) {
+        setErrorCode(jEnv, error, kErrorInvalidArgument);
+    }
+    return valid;
+}
+
+/**
+ * Decimal counterpart of getUnsignedAmount for the string-based compatibility entry points:
+ * amounts, fees and counts of 2^63 and above are rejected like their negative jlong bits are.
+ */
+inline bool parseUnsignedAmount(JNIEnv *jEnv, jstring jValue, unsigned long long *value, jobject error) {
+    if (!parseUnsignedLongLong(jEnv, jValue, value, error)) {
+        return false;
+    }
+    return getUnsignedAmount(jEnv, static_cast<jlong>(*value), value, error);
+}
+
+#endif // JNI_COMMON_CPP
@@ -38,9 +38,10 @@
 #include <cmath>
 #include <android/log.h>
 #include "jniCommon.cpp"
+#include "jniUtf8.cpp"
 
 extern "C"
-JNIEXPORT jbyteArray JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetId(
         JNIEnv *jEnv,
         jobject jThis,
@@ -49,8 +50,8 @@ Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetId(
     int *r = &i;
     jlong lCompletedTx = GetPointerField(jEnv, jThis);
     auto *pCompletedTx = reinterpret_cast<TariCompletedTransaction *>(lCompletedTx);
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv, completed_transaction_get_transaction_id(pCompletedTx, r));
+    auto result = static_cast<jlong>(
+            completed_transaction_get_transaction_id(pCompletedTx, r));
     setErrorCode(jEnv, error, i);
     return result;
 }
@@ -113,7 +114,7 @@ Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetTransactionKernel(
 }
 
 extern "C"
-JNIEXPORT jbyteArray JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetAmount(
         JNIEnv *jEnv,
         jobject jThis,
@@ -122,16 +123,14 @@ Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetAmount(
     int *r = &i;
     jlong lCompletedTx = GetPointerField(jEnv, jThis);
     auto *pCompletedTx = reinterpret_cast<TariCompletedTransaction *>(lCompletedTx);
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv,
-            completed_transaction_get_amount(pCompletedTx, r)
-    );
+    auto result = static_cast<jlong>(
+            completed_transaction_get_amount(pCompletedTx, r));
     setErrorCode(jEnv, error, i);
     return result;
 }
 
 extern "C"
-JNIEXPORT jbyteArray JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetFee(
         JNIEnv *jEnv,
         jobject jThis,
@@ -140,16 +139,14 @@ Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetFee(
     int *r = &i;
     jlong lCompletedTx = GetPointerField(jEnv, jThis);
     auto *pCompletedTx = reinterpret_cast<TariCompletedTransaction *>(lCompletedTx);
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv,
-            completed_transaction_get_fee(pCompletedTx, r)
-    );
+    auto result = static_cast<jlong>(
+            completed_transaction_get_fee(pCompletedTx, r));
     setErrorCode(jEnv, error, i);
     return result;
 }
 
 extern "C"
-JNIEXPORT jbyteArray JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetTimestamp(
         JNIEnv *jEnv,
         jobject jThis,
@@ -158,10 +155,8 @@ Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetTimestamp(
     int *r = &i;
     jlong lCompletedTx = GetPointerField(jEnv, jThis);
     auto *pCompletedTx = reinterpret_cast<TariCompletedTransaction *>(lCompletedTx);
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv,
-            completed_transaction_get_timestamp(pCompletedTx, r)
-    );
+    auto result = static_cast<jlong>(
+            completed_transaction_get_timestamp(pCompletedTx, r));
     setErrorCode(jEnv, error, i);
     return result;
 }
@@ -178,7 +173,7 @@ Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetMessage(
     auto *pCompletedTx = reinterpret_cast<TariCompletedTransaction *>(lCompletedTx);
     const char *pMessage = completed_transaction_get_message(pCompletedTx, r);
     setErrorCode(jEnv, error, i);
-    jstring result = jEnv->NewStringUTF(pMessage);
+    jstring result = newStringFromUtf8(jEnv, pMessage);
     string_destroy(const_cast<char *>(pMessage));
     return result;
 }
@@ -199,7 +194,7 @@ Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetStatus(
 }
 
 extern "C"
-JNIEXPORT jbyteArray JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetConfirmationCount(
         JNIEnv *jEnv,
         jobject jThis,
@@ -208,10 +203,8 @@ Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetConfirmationCount(
     int *r = &i;
     jlong lCompletedTx = GetPointerField(jEnv, jThis);
     auto *pCompletedTx = reinterpret_cast<TariCompletedTransaction *>(lCompletedTx);
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv,
-            completed_transaction_get_confirmations(pCompletedTx, r)
-    );
+    auto result = static_cast<jlong>(
+            completed_transaction_get_confirmations(pCompletedTx, r));
     setErrorCode(jEnv, error, i);
     return result;
 }
@@ -38,6 +38,8 @@
 #include <cmath>
 #include <android/log.h>
 #include "jniCommon.cpp"
+#include "jniHexCodec.cpp"
+#include "jniUtf8.cpp"
 
 extern "C"
 JNIEXPORT jstring JNICALL
@@ -51,7 +53,7 @@ Java_com_tari_android_wallet_ffi_FFICompletedTxKernel_jniGetExcess(
     auto *pKernel = reinterpret_cast<TariTransactionKernel *>(lKernel);
     const char *pStr = transaction_kernel_get_excess_hex(pKernel, r);
     setErrorCode(jEnv, error, i);
-    jstring result = jEnv->NewStringUTF(pStr);
+    jstring result = newStringFromUtf8(jEnv, pStr);
     string_destroy(const_cast<char *>(pStr));
     return result;
 }
@@ -68,7 +70,7 @@ Java_com_tari_android_wallet_ffi_FFICompletedTxKernel_jniGetExcessPublicNonce(
     auto *pKernel = reinterpret_cast<TariTransactionKernel *>(lKernel);
     const char *pStr = transaction_kernel_get_excess_public_nonce_hex(pKernel, r);
     setErrorCode(jEnv, error, i);
-    jstring result = jEnv->NewStringUTF(pStr);
+    jstring result = newStringFromUtf8(jEnv, pStr);
     string_destroy(const_cast<char *>(pStr));
     return result;
 }
@@ -85,11 +87,63 @@ Java_com_tari_android_wallet_ffi_FFICompletedTxKernel_jniGetExcessSignature(
     auto *pKernel = reinterpret_cast<TariTransactionKernel *>(lKernel);
     const char *pStr = transaction_kernel_get_excess_signature_hex(pKernel, r);
     setErrorCode(jEnv, error, i);
-    jstring result = jEnv->NewStringUTF(pStr);
+    jstring result = newStringFromUtf8(jEnv, pStr);
     string_destroy(const_cast<char *>(pStr));
     return result;
 }
 
+/**
+ * Each kernel field is 32 bytes: excess commitment, excess public nonce, excess signature.
+ */
+static const int kKernelFieldSize = 32;
+static const int kKernelFieldCount = 3;
+
+/**
+ * Decodes one hex field of the wallet library into bytes and releases the string.
+ */
+static bool takeKernelField(const char *pHex, uint8_t *bytes, int *r) {
+    if (pHex == nullptr) {
+        return false;
+    }
+    bool decoded = strlen(pHex) == 2 * kKernelFieldSize && hexDecode(pHex, kKernelFieldSize, bytes);
+    string_destroy(const_cast<char *>(pHex));
+    if (!decoded && *r == 0) {
+        *r = kErrorInvalidArgument;
+    }
+    return decoded;
+}
+
+/**
+ * Writes excess, public nonce and signature as 96 bytes into the start of the array in one
+ * call, instead of one hex string per field.
+ */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_tari_android_wallet_ffi_FFICompletedTxKernel_jniGetBytes(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jbyteArray array,
+        jobject error) {
+    if (jEnv->GetArrayLength(array) < kKernelFieldCount * kKernelFieldSize) {
+        setErrorCode(jEnv, error, kErrorInvalidArgument);
+        return;
+    }
+    int i = 0;
+    int *r = &i;
+    jlong lKernel = GetPointerField(jEnv, jThis);
+    auto *pKernel = reinterpret_cast<TariTransactionKernel *>(lKernel);
+    uint8_t bytes[kKernelFieldCount * kKernelFieldSize];
+    bool decoded = takeKernelField(transaction_kernel_get_excess_hex(pKernel, r), bytes, r)
+                   && takeKernelField(transaction_kernel_get_excess_public_nonce_hex(pKernel, r),
+                                      bytes + kKernelFieldSize, r)
+                   && takeKernelField(transaction_kernel_get_excess_signature_hex(pKernel, r),
+                                      bytes + 2 * kKernelFieldSize, r);
+    if (decoded) {
+        jEnv->SetByteArrayRegion(array, 0, sizeof(bytes), reinterpret_cast<const jbyte *>(bytes));
+    }
+    setErrorCode(jEnv, error, i);
+}
+
 extern "C"
 JNIEXPORT void JNICALL
 Java_com_tari_android_wallet_ffi_FFICompletedTxKernel_jniDestroy(
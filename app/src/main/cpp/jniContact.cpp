@@ -38,6 +38,7 @@
 #include <cmath>
 #include <android/log.h>
 #include "jniCommon.cpp"
+#include "jniUtf8.cpp"
 
 extern "C"
 JNIEXPORT void JNICALL
@@ -70,7 +71,7 @@ Java_com_tari_android_wallet_ffi_FFIContact_jniGetAlias(
     auto *pContact = reinterpret_cast<TariContact *>(lContact);
     const char *pAlias = contact_get_alias(pContact, r);
     setErrorCode(jEnv, error, i);
-    jstring result = jEnv->NewStringUTF(pAlias);
+    jstring result = newStringFromUtf8(jEnv, pAlias);
     string_destroy(const_cast<char *>(pAlias));
     return result;
 }
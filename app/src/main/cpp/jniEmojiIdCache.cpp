@@ -0,0 +1,249 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef JNI_EMOJI_ID_CACHE_CPP
+#define JNI_EMOJI_ID_CACHE_CPP
+
+#include <jni.h>
+#include <wallet.h>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "jniCommon.cpp"
+
+/**
+ * Counters of EmojiIdCache, in the order of FFIPublicKey.EmojiIdCacheStats.
+ */
+enum EmojiIdCacheStat {
+    kEmojiIdCacheEmojiIdHits = 0,
+    kEmojiIdCacheEmojiIdMisses,
+    kEmojiIdCacheKeyHits,
+    kEmojiIdCacheKeyMisses,
+    kEmojiIdCacheEvictions,
+    kEmojiIdCacheSize,
+    kEmojiIdCacheStatCount
+};
+
+/**
+ * Copies the key bytes, the cache key of a public key.
+ */
+inline bool getPublicKeyBytes(TariPublicKey *pPublicKey, std::string &bytes, int *r) {
+    ByteVector *pBytes = public_key_get_bytes(pPublicKey, r);
+    if (pBytes == nullptr) {
+        return false;
+    }
+    unsigned int length = byte_vector_get_length(pBytes, r);
+    bytes.resize(length);
+    for (unsigned int k = 0; k < length && *r == 0; k++) {
+        bytes[k] = static_cast<char>(byte_vector_get_at(pBytes, k, r));
+    }
+    byte_vector_destroy(pBytes);
+    return *r == 0;
+}
+
+/**
+ * Bounded LRU cache of public key <-> emoji ID conversions, keyed both by the key bytes and by
+ * the emoji ID. An entry holds the emoji ID as a global string reference, handed out as new local
+ * references since Java strings are immutable, and optionally a TariPublicKey handle.
+ *
+ * Cached key handles are shared: every FFIPublicKey built from the same emoji ID points to the
+ * same handle, and FFIPublicKey.jniDestroy hands shared handles back through release() instead
+ * of destroying them. A handle is destroyed once it is both evicted and released by all holders.
+ *
+ * All members are safe to call from any thread.
+ */
+class EmojiIdCache {
+public:
+    explicit EmojiIdCache(size_t capacity) : capacity(capacity) {}
+
+    /**
+     * Destroys the cached handles no FFIPublicKey holds any more. Global string references are
+     * left to the VM, which is gone or going by the time the library unloads.
+     *
+     * This runs during static destruction, when g_handleStats may already be destroyed, so the
+     * library function is called directly rather than through the tracking macro.
+     */
+    ~EmojiIdCache() {
+        for (auto &shared : sharedKeys) {
+            if (shared.second.holders == 0) {
+                (public_key_destroy)(shared.first);
+            }
+        }
+    }
+
+    /**
+     * New local reference to the emoji ID of the key with the given bytes, nullptr on a miss.
+     */
+    jstring findEmojiId(JNIEnv *jEnv, const std::string &keyBytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = byKey.find(keyBytes);
+        if (found == byKey.end() || found->second->emojiIdString == nullptr) {
+            counters[kEmojiIdCacheEmojiIdMisses]++;
+            return nullptr;
+        }
+        counters[kEmojiIdCacheEmojiIdHits]++;
+        lru.splice(lru.begin(), lru, found->second);
+        return static_cast<jstring>(jEnv->NewLocalRef(found->second->emojiIdString));
+    }
+
+    void putEmojiId(JNIEnv *jEnv, const std::string &keyBytes, const std::string &emojiId, jstring jEmojiId) {
+        std::lock_guard<std::mutex> lock(mutex);
+        Entry &entry = upsertLocked(jEnv, keyBytes, emojiId);
+        if (entry.emojiIdString == nullptr) {
+            entry.emojiIdString = static_cast<jstring>(jEnv->NewGlobalRef(jEmojiId));
+        }
+    }
+
+    /**
+     * Shared key handle for the emoji ID, which the caller must give back through release().
+     * On a miss returns nullptr and, if the emoji ID is known without a handle, its key bytes
+     * in keyBytes so that the caller can build the key without parsing the emoji ID.
+     */
+    TariPublicKey *acquireKey(const std::string &emojiId, std::string &keyBytes) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = byEmojiId.find(emojiId);
+        if (found == byEmojiId.end()) {
+            counters[kEmojiIdCacheKeyMisses]++;
+            return nullptr;
+        }
+        counters[kEmojiIdCacheKeyHits]++;
+        lru.splice(lru.begin(), lru, found->second);
+        TariPublicKey *pKey = found->second->pKey;
+        if (pKey == nullptr) {
+            keyBytes = found->second->keyBytes;
+            return nullptr;
+        }
+        sharedKeys[pKey].holders++;
+        return pKey;
+    }
+
+    /**
+     * Caches a key the caller just built, which then becomes a shared handle held once by the
+     * caller. Returns false, leaving the key to the caller alone, if another thread cached a
+     * handle for the same key first.
+     */
+    bool adoptKey(JNIEnv *jEnv, const std::string &keyBytes, const std::string &emojiId, TariPublicKey *pKey) {
+        std::lock_guard<std::mutex> lock(mutex);
+        Entry &entry = upsertLocked(jEnv, keyBytes, emojiId);
+        if (entry.pKey != nullptr) {
+            return false;
+        }
+        entry.pKey = pKey;
+        sharedKeys[pKey] = SharedKey{1, true};
+        return true;
+    }
+
+    /**
+     * Gives back a handle returned by acquireKey or adopted by adoptKey. Returns false if pKey
+     * is not a shared handle, in which case the caller still owns it.
+     */
+    bool release(TariPublicKey *pKey) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto found = sharedKeys.find(pKey);
+        if (found == sharedKeys.end()) {
+            return false;
+        }
+        if (--found->second.holders == 0 && !found->second.cached) {
+            sharedKeys.erase(found);
+            public_key_destroy(pKey);
+        }
+        return true;
+    }
+
+    void getStats(jlong *stats) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int k = 0; k < kEmojiIdCacheStatCount; k++) {
+            stats[k] = counters[k];
+        }
+        stats[kEmojiIdCacheSize] = static_cast<jlong>(lru.size());
+    }
+
+private:
+    struct Entry {
+        std::string keyBytes;
+        std::string emojiId;
+        jstring emojiIdString;
+        TariPublicKey *pKey;
+    };
+
+    struct SharedKey {
+        int holders;
+        bool cached;
+    };
+
+    Entry &upsertLocked(JNIEnv *jEnv, const std::string &keyBytes, const std::string &emojiId) {
+        auto found = byKey.find(keyBytes);
+        if (found != byKey.end()) {
+            lru.splice(lru.begin(), lru, found->second);
+            return *found->second;
+        }
+        while (lru.size() >= capacity && !lru.empty()) {
+            evictLocked(jEnv);
+        }
+        lru.push_front(Entry{keyBytes, emojiId, nullptr, nullptr});
+        byKey[keyBytes] = lru.begin();
+        byEmojiId[emojiId] = lru.begin();
+        return lru.front();
+    }
+
+    void evictLocked(JNIEnv *jEnv) {
+        Entry &entry = lru.back();
+        byKey.erase(entry.keyBytes);
+        byEmojiId.erase(entry.emojiId);
+        if (entry.emojiIdString != nullptr) {
+            jEnv->DeleteGlobalRef(entry.emojiIdString);
+        }
+        if (entry.pKey != nullptr) {
+            auto shared = sharedKeys.find(entry.pKey);
+            if (shared->second.holders == 0) {
+                sharedKeys.erase(shared);
+                public_key_destroy(entry.pKey);
+            } else {
+                shared->second.cached = false;
+            }
+        }
+        lru.pop_back();
+        counters[kEmojiIdCacheEvictions]++;
+    }
+
+    const size_t capacity;
+    std::mutex mutex;
+    std::list<Entry> lru;
+    std::unordered_map<std::string, std::list<Entry>::iterator> byKey;
+    std::unordered_map<std::string, std::list<Entry>::iterator> byEmojiId;
+    std::unordered_map<TariPublicKey *, SharedKey> sharedKeys;
+    jlong counters[kEmojiIdCacheStatCount] = {};
+};
+
+#endif // JNI_EMOJI_ID_CACHE_CPP
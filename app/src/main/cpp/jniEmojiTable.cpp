@@ -0,0 +1,139 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Generated by scripts/generate_emoji_table.py, do not edit.
+
+#ifndef JNI_EMOJI_TABLE_CPP
+#define JNI_EMOJI_TABLE_CPP
+
+#include <cstdint>
+
+static constexpr int kEmojiAlphabetSize = 256;
+
+/**
+ * Code points of the emoji alphabet, an emoji ID encodes byte b as kEmojiAlphabet[b].
+ */
+static constexpr char32_t kEmojiAlphabet[kEmojiAlphabetSize] = {
+        0x1F300, 0x1F302, 0x1F308, 0x1F30A, 0x1F30B, 0x1F30D, 0x1F319, 0x1F31D,
+        0x1F31E, 0x1F31F, 0x1F320, 0x1F330, 0x1F334, 0x1F335, 0x1F337, 0x1F338,
+        0x1F339, 0x1F33B, 0x1F33D, 0x1F340, 0x1F341, 0x1F344, 0x1F345, 0x1F346,
+        0x1F347, 0x1F348, 0x1F349, 0x1F34A, 0x1F34B, 0x1F34C, 0x1F34D, 0x1F34E,
+        0x1F350, 0x1F351, 0x1F352, 0x1F353, 0x1F354, 0x1F355, 0x1F357, 0x1F35A,
+        0x1F35E, 0x1F35F, 0x1F360, 0x1F363, 0x1F366, 0x1F369, 0x1F36A, 0x1F36B,
+        0x1F36C, 0x1F36D, 0x1F36F, 0x1F370, 0x1F373, 0x1F374, 0x1F375, 0x1F376,
+        0x1F377, 0x1F378, 0x1F379, 0x1F37A, 0x1F37C, 0x1F380, 0x1F381, 0x1F382,
+        0x1F383, 0x1F384, 0x1F388, 0x1F389, 0x1F392, 0x1F393, 0x1F3A0, 0x1F3A1,
+        0x1F3A2, 0x1F3A3, 0x1F3A4, 0x1F3A5, 0x1F3A7, 0x1F3A8, 0x1F3A9, 0x1F3AA,
+        0x1F3AC, 0x1F3AD, 0x1F3AE, 0x1F3B0, 0x1F3B1, 0x1F3B2, 0x1F3B3, 0x1F3B5,
+        0x1F3B7, 0x1F3B8, 0x1F3B9, 0x1F3BA, 0x1F3BB, 0x1F3BC, 0x1F3BD, 0x1F3BE,
+        0x1F3BF, 0x1F3C0, 0x1F3C1, 0x1F3C6, 0x1F3C8, 0x1F3C9, 0x1F3E0, 0x1F3E5,
+        0x1F3E6, 0x1F3ED, 0x1F3F0, 0x1F400, 0x1F409, 0x1F40A, 0x1F40C, 0x1F40D,
+        0x1F40E, 0x1F410, 0x1F411, 0x1F413, 0x1F416, 0x1F417, 0x1F418, 0x1F419,
+        0x1F41A, 0x1F41B, 0x1F41C, 0x1F41D, 0x1F41E, 0x1F422, 0x1F423, 0x1F428,
+        0x1F429, 0x1F42A, 0x1F42C, 0x1F42D, 0x1F42E, 0x1F42F, 0x1F430, 0x1F432,
+        0x1F433, 0x1F434, 0x1F435, 0x1F436, 0x1F437, 0x1F438, 0x1F43A, 0x1F43B,
+        0x1F43C, 0x1F43D, 0x1F43E, 0x1F440, 0x1F445, 0x1F451, 0x1F452, 0x1F453,
+        0x1F454, 0x1F455, 0x1F456, 0x1F457, 0x1F458, 0x1F459, 0x1F45A, 0x1F45B,
+        0x1F45E, 0x1F45F, 0x1F460, 0x1F461, 0x1F462, 0x1F463, 0x1F479, 0x1F47B,
+        0x1F47D, 0x1F47E, 0x1F47F, 0x1F480, 0x1F484, 0x1F488, 0x1F489, 0x1F48A,
+        0x1F48B, 0x1F48C, 0x1F48D, 0x1F48E, 0x1F490, 0x1F494, 0x1F495, 0x1F498,
+        0x1F4A1, 0x1F4A3, 0x1F4A4, 0x1F4A6, 0x1F4A8, 0x1F4A9, 0x1F4AD, 0x1F4AF,
+        0x1F4B0, 0x1F4B3, 0x1F4B8, 0x1F4BA, 0x1F4BB, 0x1F4BC, 0x1F4C8, 0x1F4C9,
+        0x1F4CC, 0x1F4CE, 0x1F4DA, 0x1F4DD, 0x1F4E1, 0x1F4E3, 0x1F4F1, 0x1F4F7,
+        0x1F50B, 0x1F50C, 0x1F50E, 0x1F511, 0x1F514, 0x1F525, 0x1F526, 0x1F527,
+        0x1F528, 0x1F529, 0x1F52A, 0x1F52B, 0x1F52C, 0x1F52D, 0x1F52E, 0x1F531,
+        0x1F5FD, 0x1F602, 0x1F607, 0x1F608, 0x1F609, 0x1F60D, 0x1F60E, 0x1F631,
+        0x1F637, 0x1F639, 0x1F63B, 0x1F63F, 0x1F680, 0x1F681, 0x1F682, 0x1F68C,
+        0x1F691, 0x1F692, 0x1F693, 0x1F695, 0x1F697, 0x1F69C, 0x1F6A2, 0x1F6A6,
+        0x1F6A7, 0x1F6A8, 0x1F6AA, 0x1F6AB, 0x1F6B2, 0x1F6BD, 0x1F6BF, 0x1F6C1
+};
+
+static constexpr uint32_t kEmojiHashMultiplier = 0x9E3779B1;
+
+static constexpr uint8_t kEmojiHashDisplacements[128] = {
+          0,  17,   7,   1,   9,   0,   1,  10,   3,   1,   2,   6,   0,   7,   6,   2,
+          2,  11,   6,   0,  33,  31,   2,   3,  29,  18,   7,   0,   6,   9,   1,   0,
+          8,   6,   9,   0,   9,   1,   2,  14,  15,  33,   0,  51,  16,   1,   1,   6,
+         72,   5,  38,  50,  14,  12,   0,   3,  69,  39,  27,   1,  49,   5,  17,  18,
+          2,  71,   0,   8,   1,  59,   0,  50,  97,   9,  72,   5,   1,  10,  97,   0,
+        132,  27,   3, 105,   1,   8,   2,   9,  65,   0,  54,   1,  11,  48,   1, 194,
+        128,  77,  31,  30,   0,  85,   3, 137,  25, 129,   3,  13,  13,  28,  93,   2,
+         50,  14,  51,  47,   3, 142,   7,   6,  93, 123,  32,  88, 157,  58,  76,  10
+};
+
+static constexpr uint8_t kEmojiHashSlots[256] = {
+        112, 207, 249, 199, 132, 193,  46, 152, 188, 118,  66, 103, 139, 213, 182, 204,
+        149, 195, 142, 224, 106,  42,  71, 110,  64,  62,  33, 243, 174,  86,  50, 232,
+        239, 160, 102,  32, 229, 171,  59, 237, 184, 124,  93,   4, 148,  87, 141,  90,
+         78,   6, 135,  72, 164, 161,  25, 137,  97,   3,  48,  76, 228, 107, 162, 234,
+        138,  75,   5, 154,  99, 191,  92, 117,  24, 144,  80, 111,  38, 173,  26, 212,
+        176,  60,  91, 185, 115,  65, 158, 134,  70,   7, 156, 100, 192, 143, 166,  22,
+        219,  85, 114,  31, 227,  30, 226, 179,  45, 236, 189, 119,  67, 200, 145,  81,
+          8,  56, 159,  18, 211, 180,  77,  23,  84, 121, 187,  34,  29,  89, 181,  47,
+        253, 233, 210, 169, 220, 240, 217, 108,  57, 163, 196, 245, 252,  53,  21,  88,
+        130,  63,  94,  35, 218, 186, 109, 153,  13, 129, 167,   1,  37, 215, 178,  49,
+        128,  27, 136,  73,  15, 150, 223,  11,  95, 122,  36, 214,   9, 206, 255, 231,
+        127, 172,   2, 203, 248, 190, 123, 116, 201, 146,  82, 198, 157, 101,  16, 208,
+         19,  28,  83,  10, 131,  55, 177, 244, 197,  58, 205, 151,  54, 126, 170,  41,
+        222, 230, 140,  52,  98,  12, 242, 104, 202, 251,  79, 113,  61,  39, 241, 225,
+        247,  43, 155,  14, 238, 168, 105,  40, 183, 133, 165, 235, 194, 246,   0,  44,
+        209,  96, 120, 147,  69,  20, 216, 175,  51, 254,  17, 125,  68, 221, 250,  74
+};
+
+constexpr uint32_t emojiHashBucket(char32_t codePoint) {
+    return static_cast<uint32_t>(static_cast<uint32_t>(codePoint) * kEmojiHashMultiplier) >> 25;
+}
+
+constexpr uint32_t emojiHashSlot(char32_t codePoint) {
+    return static_cast<uint32_t>(
+            (static_cast<uint32_t>(codePoint) ^ kEmojiHashDisplacements[emojiHashBucket(codePoint)])
+            * kEmojiHashMultiplier) >> 24;
+}
+
+/**
+ * Alphabet index of the emoji, or -1 if the code point is not part of the alphabet.
+ */
+constexpr int emojiIndexOf(char32_t codePoint) {
+    return kEmojiAlphabet[kEmojiHashSlots[emojiHashSlot(codePoint)]] == codePoint
+           ? kEmojiHashSlots[emojiHashSlot(codePoint)]
+           : -1;
+}
+
+constexpr bool emojiHashIsPerfect(int index) {
+    return index == kEmojiAlphabetSize
+           || (emojiIndexOf(kEmojiAlphabet[index]) == index && emojiHashIsPerfect(index + 1));
+}
+
+static_assert(emojiHashIsPerfect(0), "Emoji hash collides, re-run generate_emoji_table.py");
+
+#endif // JNI_EMOJI_TABLE_CPP
@@ -0,0 +1,600 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef JNI_FFI_TRACE_CPP
+#define JNI_FFI_TRACE_CPP
+
+#include <jni.h>
+#include <wallet.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "jniTimeline.cpp"
+
+/**
+ * Recording of the wallet_* calls and wallet callbacks into a compact binary trace, replayed on a
+ * Linux host by host/ffiReplay.cpp.
+ *
+ * Built with TARI_JNI_FFI_TRACE, every wallet_* function is wrapped by a macro of the same name at
+ * the end of this file (those that also count handles in jniHandleStats.cpp), so the calls in the
+ * jni*.cpp sources are interposed without being rewritten. Recording is then switched on and off
+ * at run time by FFIUtil.startFfiTrace and FFIUtil.stopFfiTrace; while it is off an interposed
+ * call costs one relaxed load. TARI_JNI_TIMELINE builds use the same interposition to time the
+ * calls for jniTimeline.cpp. Without either flag the macros call the library directly.
+ *
+ * Trace layout, all integers as LEB128 varints and signed ones zigzag encoded:
+ *
+ *   header:   "TFFT", version byte
+ *   call:     kFfiRecordCall, call, thread, start, duration, argument count, arguments, result
+ *   callback: kFfiRecordCallback, callback, thread, time, value count, signed values
+ *
+ * Times are nanoseconds since the trace was started, threads are numbered in order of their first
+ * record. Arguments are written after the call returns, so error and flag out parameters carry the
+ * values the library stored. Strings are written as their length only, unless the trace was
+ * started with string capture; the arguments of wallet_create and wallet_apply_encryption, which
+ * include the passphrase, are never captured, nor are returned strings.
+ */
+
+#define FFI_TRACED_CALLS(X) \
+    X(wallet_create) \
+    X(wallet_sign_message) \
+    X(wallet_verify_message_signature) \
+    X(wallet_test_generate_data) \
+    X(wallet_add_base_node_peer) \
+    X(wallet_upsert_contact) \
+    X(wallet_remove_contact) \
+    X(wallet_get_available_balance) \
+    X(wallet_get_pending_incoming_balance) \
+    X(wallet_get_pending_outgoing_balance) \
+    X(wallet_send_transaction) \
+    X(wallet_get_fee_estimate) \
+    X(wallet_get_num_confirmations_required) \
+    X(wallet_set_num_confirmations_required) \
+    X(wallet_get_contacts) \
+    X(wallet_get_completed_transactions) \
+    X(wallet_get_pending_outbound_transactions) \
+    X(wallet_get_pending_inbound_transactions) \
+    X(wallet_get_cancelled_transactions) \
+    X(wallet_get_completed_transaction_by_id) \
+    X(wallet_get_pending_outbound_transaction_by_id) \
+    X(wallet_get_pending_inbound_transaction_by_id) \
+    X(wallet_get_cancelled_transaction_by_id) \
+    X(wallet_get_public_key) \
+    X(wallet_import_utxo) \
+    X(wallet_start_txo_validation) \
+    X(wallet_start_transaction_validation) \
+    X(wallet_restart_transaction_broadcast) \
+    X(wallet_set_low_power_mode) \
+    X(wallet_set_normal_power_mode) \
+    X(wallet_cancel_pending_transaction) \
+    X(wallet_coin_split) \
+    X(wallet_get_seed_words) \
+    X(wallet_apply_encryption) \
+    X(wallet_remove_encryption) \
+    X(wallet_set_key_value) \
+    X(wallet_get_value) \
+    X(wallet_clear_value) \
+    X(wallet_is_recovery_in_progress) \
+    X(wallet_start_recovery) \
+    X(wallet_destroy)
+
+enum FfiCall {
+#define FFI_CALL_ID(function) kFfiCall_##function,
+    FFI_TRACED_CALLS(FFI_CALL_ID)
+#undef FFI_CALL_ID
+    kFfiCallCount
+};
+
+static const char *const kFfiCallNames[kFfiCallCount] = {
+#define FFI_CALL_NAME(function) #function,
+        FFI_TRACED_CALLS(FFI_CALL_NAME)
+#undef FFI_CALL_NAME
+};
+
+/**
+ * The wallet callbacks in wallet_create order, followed by the recovery progress callback of
+ * wallet_start_recovery.
+ */
+enum FfiCallback {
+    kFfiCallbackTxReceived = 0,
+    kFfiCallbackTxReplyReceived,
+    kFfiCallbackTxFinalized,
+    kFfiCallbackTxBroadcast,
+    kFfiCallbackTxMined,
+    kFfiCallbackTxMinedUnconfirmed,
+    kFfiCallbackDirectSendResult,
+    kFfiCallbackStoreAndForwardSendResult,
+    kFfiCallbackTxCancelled,
+    kFfiCallbackTxoValidationComplete,
+    kFfiCallbackTxValidationComplete,
+    kFfiCallbackStoreAndForwardMessagesReceived,
+    kFfiCallbackRecovery,
+    kFfiCallbackCount
+};
+
+static const char *const kFfiCallbackNames[kFfiCallbackCount] = {
+        "txReceived",
+        "txReplyReceived",
+        "txFinalized",
+        "txBroadcast",
+        "txMined",
+        "txMinedUnconfirmed",
+        "directSendResult",
+        "storeAndForwardSendResult",
+        "txCancelled",
+        "txoValidationComplete",
+        "txValidationComplete",
+        "storeAndForwardMessagesReceived",
+        "recovery"
+};
+
+static const char kFfiTraceMagic[4] = {'T', 'F', 'F', 'T'};
+static const uint8_t kFfiTraceVersion = 1;
+
+enum FfiRecordKind {
+    kFfiRecordCall = 1,
+    kFfiRecordCallback
+};
+
+/**
+ * Tag of every argument and result of a call record.
+ */
+enum FfiValueTag {
+    // result of a void function
+    kFfiValueVoid = 0,
+    // signed value
+    kFfiValueInt,
+    // null pointer of any kind
+    kFfiValueNull,
+    // handle address
+    kFfiValueHandle,
+    // length and bytes
+    kFfiValueString,
+    // length only
+    kFfiValueStringLength,
+    // non-null callback
+    kFfiValueFunction,
+    // signed value of an int * error out parameter
+    kFfiValueError,
+    // value of a bool * out parameter
+    kFfiValueFlag,
+    // handle address and element count of a returned collection
+    kFfiValueCollection
+};
+
+/**
+ * Appends the varint encoding of single records.
+ */
+class FfiTraceWriter {
+public:
+    void byte(uint8_t value) {
+        bytes.push_back(value);
+    }
+
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            bytes.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        bytes.push_back(static_cast<uint8_t>(value));
+    }
+
+    void signedVarint(int64_t value) {
+        varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+    void string(const char *value, bool capture) {
+        if (value == nullptr) {
+            byte(kFfiValueNull);
+            return;
+        }
+        size_t length = strlen(value);
+        byte(capture ? kFfiValueString : kFfiValueStringLength);
+        varint(length);
+        if (capture) {
+            bytes.insert(bytes.end(), value, value + length);
+        }
+    }
+
+    std::vector<uint8_t> bytes;
+    // set by the trace for the arguments of the current call
+    bool captureStrings = false;
+};
+
+inline void writeFfiValue(FfiTraceWriter &writer, const char *value) {
+    writer.string(value, writer.captureStrings);
+}
+
+inline void writeFfiValue(FfiTraceWriter &writer, char *value) {
+    writer.string(value, writer.captureStrings);
+}
+
+inline void writeFfiValue(FfiTraceWriter &writer, int *error) {
+    if (error == nullptr) {
+        writer.byte(kFfiValueNull);
+        return;
+    }
+    writer.byte(kFfiValueError);
+    writer.signedVarint(*error);
+}
+
+inline void writeFfiValue(FfiTraceWriter &writer, bool *flag) {
+    if (flag == nullptr) {
+        writer.byte(kFfiValueNull);
+        return;
+    }
+    writer.byte(kFfiValueFlag);
+    writer.byte(*flag ? 1 : 0);
+}
+
+template<typename Result, typename... Params>
+inline void writeFfiValue(FfiTraceWriter &writer, Result (*function)(Params...)) {
+    writer.byte(function == nullptr ? kFfiValueNull : kFfiValueFunction);
+}
+
+template<typename T>
+inline void writeFfiValue(FfiTraceWriter &writer, T *pHandle) {
+    if (pHandle == nullptr) {
+        writer.byte(kFfiValueNull);
+        return;
+    }
+    writer.byte(kFfiValueHandle);
+    writer.varint(reinterpret_cast<uintptr_t>(pHandle));
+}
+
+template<typename T>
+inline typename std::enable_if<std::is_integral<T>::value>::type
+writeFfiValue(FfiTraceWriter &writer, T value) {
+    writer.byte(kFfiValueInt);
+    writer.signedVarint(static_cast<int64_t>(value));
+}
+
+inline void writeFfiValues(FfiTraceWriter &) {
+}
+
+template<typename First, typename... Rest>
+inline void writeFfiValues(FfiTraceWriter &writer, First first, Rest... rest) {
+    writeFfiValue(writer, first);
+    writeFfiValues(writer, rest...);
+}
+
+/**
+ * Returned values, as arguments but with the element count of collections and without the
+ * content of strings.
+ */
+template<typename T>
+inline void writeFfiResult(FfiTraceWriter &writer, T value) {
+    writeFfiValue(writer, value);
+}
+
+inline void writeFfiResult(FfiTraceWriter &writer, const char *value) {
+    writer.string(value, false);
+}
+
+inline void writeFfiResult(FfiTraceWriter &writer, char *value) {
+    writer.string(value, false);
+}
+
+template<typename Collection>
+inline void writeFfiCollection(FfiTraceWriter &writer, Collection *pCollection,
+                               unsigned int (*getLength)(Collection *, int *)) {
+    if (pCollection == nullptr) {
+        writer.byte(kFfiValueNull);
+        return;
+    }
+    int i = 0;
+    unsigned int length = getLength(pCollection, &i);
+    writer.byte(kFfiValueCollection);
+    writer.varint(reinterpret_cast<uintptr_t>(pCollection));
+    writer.varint(i == 0 ? length : 0);
+}
+
+inline void writeFfiResult(FfiTraceWriter &writer, TariContacts *pContacts) {
+    writeFfiCollection(writer, pContacts, contacts_get_length);
+}
+
+inline void writeFfiResult(FfiTraceWriter &writer, TariCompletedTransactions *pTxs) {
+    writeFfiCollection(writer, pTxs, completed_transactions_get_length);
+}
+
+inline void writeFfiResult(FfiTraceWriter &writer, TariPendingInboundTransactions *pTxs) {
+    writeFfiCollection(writer, pTxs, pending_inbound_transactions_get_length);
+}
+
+inline void writeFfiResult(FfiTraceWriter &writer, TariPendingOutboundTransactions *pTxs) {
+    writeFfiCollection(writer, pTxs, pending_outbound_transactions_get_length);
+}
+
+/**
+ * Values of a callback record: the tx id in place of a tx handle, numbers as they are.
+ */
+inline int64_t ffiCallbackValue(TariCompletedTransaction *pTx) {
+    int i = 0;
+    return static_cast<int64_t>(completed_transaction_get_transaction_id(pTx, &i));
+}
+
+inline int64_t ffiCallbackValue(TariPendingInboundTransaction *pTx) {
+    int i = 0;
+    return static_cast<int64_t>(pending_inbound_transaction_get_transaction_id(pTx, &i));
+}
+
+template<typename T>
+inline int64_t ffiCallbackValue(T value) {
+    return static_cast<int64_t>(value);
+}
+
+inline int64_t ffiTraceClockNanos() {
+    timespec time{};
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<int64_t>(time.tv_sec) * 1000000000LL + time.tv_nsec;
+}
+
+class FfiTrace {
+public:
+    /**
+     * Starts a new trace at path, replacing the file. Returns false if a trace is already being
+     * written or the file cannot be created.
+     */
+    bool start(const char *path, bool captureStrings) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (pFile != nullptr) {
+            return false;
+        }
+        pFile = fopen(path, "wb");
+        if (pFile == nullptr) {
+            return false;
+        }
+        buffer.clear();
+        bytesWritten = static_cast<int64_t>(fwrite(kFfiTraceMagic, 1, sizeof(kFfiTraceMagic), pFile));
+        bytesWritten += static_cast<int64_t>(fwrite(&kFfiTraceVersion, 1, 1, pFile));
+        startNanos = ffiTraceClockNanos();
+        capture.store(captureStrings, std::memory_order_relaxed);
+        active.store(true, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Flushes and closes the trace. Returns its size in bytes, or -1 if no trace was being
+     * written or it could not be written completely.
+     */
+    int64_t stop() {
+        std::lock_guard<std::mutex> lock(mutex);
+        active.store(false, std::memory_order_relaxed);
+        if (pFile == nullptr) {
+            return -1;
+        }
+        flushLocked();
+        bool failed = ferror(pFile) != 0;
+        failed |= fclose(pFile) != 0;
+        pFile = nullptr;
+        return failed ? -1 : bytesWritten;
+    }
+
+    bool isActive() const {
+        return active.load(std::memory_order_relaxed);
+    }
+
+    template<typename Result, typename... Params>
+    void recordCall(FfiCall call, int64_t start, int64_t end, Result result, Params... args) {
+        FfiTraceWriter writer;
+        beginCall(writer, call, start, end, sizeof...(Params));
+        writeFfiValues(writer, args...);
+        writeFfiResult(writer, result);
+        append(writer);
+    }
+
+    template<typename... Params>
+    void recordVoidCall(FfiCall call, int64_t start, int64_t end, Params... args) {
+        FfiTraceWriter writer;
+        beginCall(writer, call, start, end, sizeof...(Params));
+        writeFfiValues(writer, args...);
+        writer.byte(kFfiValueVoid);
+        append(writer);
+    }
+
+    template<typename... Values>
+    void recordCallback(FfiCallback callback, Values... values) {
+        if (!isActive()) {
+            return;
+        }
+        int64_t values64[] = {ffiCallbackValue(values)..., 0};
+        FfiTraceWriter writer;
+        writer.byte(kFfiRecordCallback);
+        writer.varint(static_cast<uint64_t>(callback));
+        writer.varint(threadNumber());
+        writer.varint(static_cast<uint64_t>(ffiTraceClockNanos() - startNanos));
+        writer.varint(sizeof...(Values));
+        for (size_t n = 0; n < sizeof...(Values); n++) {
+            writer.signedVarint(values64[n]);
+        }
+        append(writer);
+    }
+
+private:
+    static const size_t kFlushThreshold = 64 * 1024;
+
+    void beginCall(FfiTraceWriter &writer, FfiCall call, int64_t start, int64_t end,
+                   size_t argumentCount) {
+        writer.captureStrings = capture.load(std::memory_order_relaxed) &&
+                                call != kFfiCall_wallet_create &&
+                                call != kFfiCall_wallet_apply_encryption;
+        writer.byte(kFfiRecordCall);
+        writer.varint(static_cast<uint64_t>(call));
+        writer.varint(threadNumber());
+        writer.varint(static_cast<uint64_t>(std::max<int64_t>(start - startNanos, 0)));
+        writer.varint(static_cast<uint64_t>(end - start));
+        writer.varint(argumentCount);
+    }
+
+    uint64_t threadNumber() {
+        static thread_local uint64_t t_number = 0;
+        if (t_number == 0) {
+            t_number = nextThreadNumber.fetch_add(1, std::memory_order_relaxed);
+        }
+        return t_number;
+    }
+
+    void append(const FfiTraceWriter &writer) {
+        std::lock_guard<std::mutex> lock(mutex);
+        // a call that began before stop() is dropped
+        if (pFile == nullptr) {
+            return;
+        }
+        buffer.insert(buffer.end(), writer.bytes.begin(), writer.bytes.end());
+        if (buffer.size() >= kFlushThreshold) {
+            flushLocked();
+        }
+    }
+
+    void flushLocked() {
+        bytesWritten += static_cast<int64_t>(fwrite(buffer.data(), 1, buffer.size(), pFile));
+        buffer.clear();
+    }
+
+    std::atomic<bool> active{false};
+    std::atomic<bool> capture{false};
+    std::atomic<uint64_t> nextThreadNumber{1};
+    std::mutex mutex;
+    FILE *pFile = nullptr;
+    std::vector<uint8_t> buffer;
+    int64_t bytesWritten = 0;
+    int64_t startNanos = 0;
+};
+
+/**
+ * Defined in jniUtil.cpp.
+ */
+extern FfiTrace g_ffiTrace;
+
+/**
+ * Calls function with args converted to its parameter types, recording the call while the trace
+ * is active.
+ */
+template<typename Result, typename... Params>
+struct FfiTracedCall {
+    static Result invoke(FfiCall call, Result (*function)(Params...), Params... args) {
+        TIMELINE_SCOPE(kTimelineFfiCall, kFfiCallNames[call]);
+        if (!g_ffiTrace.isActive()) {
+            return function(args...);
+        }
+        int64_t start = ffiTraceClockNanos();
+        Result result = function(args...);
+        g_ffiTrace.recordCall(call, start, ffiTraceClockNanos(), result, args...);
+        return result;
+    }
+};
+
+template<typename... Params>
+struct FfiTracedCall<void, Params...> {
+    static void invoke(FfiCall call, void (*function)(Params...), Params... args) {
+        TIMELINE_SCOPE(kTimelineFfiCall, kFfiCallNames[call]);
+        if (!g_ffiTrace.isActive()) {
+            function(args...);
+            return;
+        }
+        int64_t start = ffiTraceClockNanos();
+        function(args...);
+        g_ffiTrace.recordVoidCall(call, start, ffiTraceClockNanos(), args...);
+    }
+};
+
+template<typename Result, typename... Params, typename... Args>
+inline Result tracedFfiCall(FfiCall call, Result (*function)(Params...), Args... args) {
+    return FfiTracedCall<Result, Params...>::invoke(call, function, args...);
+}
+
+// the interposition also feeds the timeline of jniTimeline.cpp
+#if TARI_JNI_FFI_TRACE || TARI_JNI_TIMELINE
+
+#define FFI_TRACED(function, ...) tracedFfiCall(kFfiCall_##function, function, __VA_ARGS__)
+
+#else
+
+#define FFI_TRACED(function, ...) function(__VA_ARGS__)
+
+#endif
+
+#if TARI_JNI_FFI_TRACE
+
+#define FFI_TRACE_CALLBACK(...) g_ffiTrace.recordCallback(__VA_ARGS__)
+
+#else
+
+#define FFI_TRACE_CALLBACK(...)
+
+#endif
+
+// The wallet_* functions that return handles are wrapped together with the handle counting in
+// jniHandleStats.cpp, the others here. As there, the function is not expanded again inside its
+// own replacement.
+#define wallet_add_base_node_peer(...) FFI_TRACED(wallet_add_base_node_peer, __VA_ARGS__)
+#define wallet_apply_encryption(...) FFI_TRACED(wallet_apply_encryption, __VA_ARGS__)
+#define wallet_cancel_pending_transaction(...) FFI_TRACED(wallet_cancel_pending_transaction, __VA_ARGS__)
+#define wallet_clear_value(...) FFI_TRACED(wallet_clear_value, __VA_ARGS__)
+#define wallet_coin_split(...) FFI_TRACED(wallet_coin_split, __VA_ARGS__)
+#define wallet_get_available_balance(...) FFI_TRACED(wallet_get_available_balance, __VA_ARGS__)
+#define wallet_get_fee_estimate(...) FFI_TRACED(wallet_get_fee_estimate, __VA_ARGS__)
+#define wallet_get_num_confirmations_required(...) \
+    FFI_TRACED(wallet_get_num_confirmations_required, __VA_ARGS__)
+#define wallet_get_pending_incoming_balance(...) \
+    FFI_TRACED(wallet_get_pending_incoming_balance, __VA_ARGS__)
+#define wallet_get_pending_outgoing_balance(...) \
+    FFI_TRACED(wallet_get_pending_outgoing_balance, __VA_ARGS__)
+#define wallet_import_utxo(...) FFI_TRACED(wallet_import_utxo, __VA_ARGS__)
+#define wallet_is_recovery_in_progress(...) FFI_TRACED(wallet_is_recovery_in_progress, __VA_ARGS__)
+#define wallet_remove_contact(...) FFI_TRACED(wallet_remove_contact, __VA_ARGS__)
+#define wallet_remove_encryption(...) FFI_TRACED(wallet_remove_encryption, __VA_ARGS__)
+#define wallet_restart_transaction_broadcast(...) \
+    FFI_TRACED(wallet_restart_transaction_broadcast, __VA_ARGS__)
+#define wallet_send_transaction(...) FFI_TRACED(wallet_send_transaction, __VA_ARGS__)
+#define wallet_set_key_value(...) FFI_TRACED(wallet_set_key_value, __VA_ARGS__)
+#define wallet_set_low_power_mode(...) FFI_TRACED(wallet_set_low_power_mode, __VA_ARGS__)
+#define wallet_set_normal_power_mode(...) FFI_TRACED(wallet_set_normal_power_mode, __VA_ARGS__)
+#define wallet_set_num_confirmations_required(...) \
+    FFI_TRACED(wallet_set_num_confirmations_required, __VA_ARGS__)
+#define wallet_start_recovery(...) FFI_TRACED(wallet_start_recovery, __VA_ARGS__)
+#define wallet_start_transaction_validation(...) \
+    FFI_TRACED(wallet_start_transaction_validation, __VA_ARGS__)
+#define wallet_start_txo_validation(...) FFI_TRACED(wallet_start_txo_validation, __VA_ARGS__)
+#define wallet_test_generate_data(...) FFI_TRACED(wallet_test_generate_data, __VA_ARGS__)
+#define wallet_upsert_contact(...) FFI_TRACED(wallet_upsert_contact, __VA_ARGS__)
+#define wallet_verify_message_signature(...) FFI_TRACED(wallet_verify_message_signature, __VA_ARGS__)
+
+#endif // JNI_FFI_TRACE_CPP
@@ -0,0 +1,273 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <jni.h>
+#include <android/log.h>
+#include <vector>
+#include "jniCommon.cpp"
+
+/**
+ * Destroy entry points of the FFI classes whose handles an arena can free, called directly so
+ * that each handle is released by the same code as FFIBase.destroy(), including the emoji ID
+ * cache bookkeeping of shared public keys.
+ */
+#define ARENA_DESTROY_FUNCTION(ffiClass) \
+    extern "C" void Java_com_tari_android_wallet_ffi_##ffiClass##_jniDestroy(JNIEnv *jEnv, jobject jThis)
+
+ARENA_DESTROY_FUNCTION(FFIByteVector);
+ARENA_DESTROY_FUNCTION(FFICommsConfig);
+ARENA_DESTROY_FUNCTION(FFICompletedTx);
+ARENA_DESTROY_FUNCTION(FFICompletedTxKernel);
+ARENA_DESTROY_FUNCTION(FFICompletedTxs);
+ARENA_DESTROY_FUNCTION(FFIContact);
+ARENA_DESTROY_FUNCTION(FFIContacts);
+ARENA_DESTROY_FUNCTION(FFIEmojiSet);
+ARENA_DESTROY_FUNCTION(FFIPendingInboundTx);
+ARENA_DESTROY_FUNCTION(FFIPendingInboundTxs);
+ARENA_DESTROY_FUNCTION(FFIPendingOutboundTx);
+ARENA_DESTROY_FUNCTION(FFIPendingOutboundTxs);
+ARENA_DESTROY_FUNCTION(FFIPrivateKey);
+ARENA_DESTROY_FUNCTION(FFIPublicKey);
+ARENA_DESTROY_FUNCTION(FFISeedWords);
+ARENA_DESTROY_FUNCTION(FFITransportType);
+ARENA_DESTROY_FUNCTION(FFITxTable);
+
+#undef ARENA_DESTROY_FUNCTION
+
+typedef void (*HandleDestructor)(JNIEnv *jEnv, jobject jThis);
+
+/**
+ * Destructor per FFIClass, null for classes an arena never takes over: the wallet outlives any
+ * scope, and the remaining classes hold no native handle.
+ */
+static HandleDestructor handleDestructor(FFIClass ffiClass) {
+    switch (ffiClass) {
+        case kFFIByteVector:
+            return Java_com_tari_android_wallet_ffi_FFIByteVector_jniDestroy;
+        case kFFICommsConfig:
+            return Java_com_tari_android_wallet_ffi_FFICommsConfig_jniDestroy;
+        case kFFICompletedTx:
+            return Java_com_tari_android_wallet_ffi_FFICompletedTx_jniDestroy;
+        case kFFICompletedTxKernel:
+            return Java_com_tari_android_wallet_ffi_FFICompletedTxKernel_jniDestroy;
+        case kFFICompletedTxs:
+            return Java_com_tari_android_wallet_ffi_FFICompletedTxs_jniDestroy;
+        case kFFIContact:
+            return Java_com_tari_android_wallet_ffi_FFIContact_jniDestroy;
+        case kFFIContacts:
+            return Java_com_tari_android_wallet_ffi_FFIContacts_jniDestroy;
+        case kFFIEmojiSet:
+            return Java_com_tari_android_wallet_ffi_FFIEmojiSet_jniDestroy;
+        case kFFIPendingInboundTx:
+            return Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniDestroy;
+        case kFFIPendingInboundTxs:
+            return Java_com_tari_android_wallet_ffi_FFIPendingInboundTxs_jniDestroy;
+        case kFFIPendingOutboundTx:
+            return Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniDestroy;
+        case kFFIPendingOutboundTxs:
+            return Java_com_tari_android_wallet_ffi_FFIPendingOutboundTxs_jniDestroy;
+        case kFFIPrivateKey:
+            return Java_com_tari_android_wallet_ffi_FFIPrivateKey_jniDestroy;
+        case kFFIPublicKey:
+            return Java_com_tari_android_wallet_ffi_FFIPublicKey_jniDestroy;
+        case kFFISeedWords:
+            return Java_com_tari_android_wallet_ffi_FFISeedWords_jniDestroy;
+        case kFFITransportType:
+            return Java_com_tari_android_wallet_ffi_FFITransportType_jniDestroy;
+        case kFFITxTable:
+            return Java_com_tari_android_wallet_ffi_FFITxTable_jniDestroy;
+        default:
+            return nullptr;
+    }
+}
+
+/**
+ * Records the native handles attached to FFI objects on one thread while it is active and frees
+ * them together in release(), newest first.
+ *
+ * Arenas nest per thread: activating one makes it the target of every handle created on the
+ * calling thread until it is released, after which the arena that was active before takes over
+ * again. The owning objects are held through global references, so they cannot be finalized
+ * (and their handle freed a second time) while the arena holds them. A handle that has already
+ * been destroyed explicitly is skipped on release, since destroy() clears the pointer field.
+ */
+struct HandleArena {
+
+    struct Entry {
+        jobject owner;
+        jlong pointer;
+        HandleDestructor destructor;
+    };
+
+    std::vector<Entry> entries;
+    HandleArena *parent = nullptr;
+    bool active = false;
+    // class of the last adopted owner, handles tend to come in runs of the same class
+    FFIClass lastClass = kFFIBase;
+
+    void activate() {
+        if (active) {
+            return;
+        }
+        parent = t_activeArena;
+        t_activeArena = this;
+        active = true;
+    }
+
+    /**
+     * Unlinks the arena from the calling thread's chain, wherever it is in the chain.
+     */
+    void deactivate() {
+        if (!active) {
+            return;
+        }
+        for (HandleArena **pLink = &t_activeArena; *pLink != nullptr; pLink = &(*pLink)->parent) {
+            if (*pLink == this) {
+                *pLink = parent;
+                break;
+            }
+        }
+        parent = nullptr;
+        active = false;
+    }
+
+    FFIClass classify(JNIEnv *jEnv, jobject jOwner) {
+        if (lastClass != kFFIBase && jEnv->IsInstanceOf(jOwner, g_ids.classes[lastClass])) {
+            return lastClass;
+        }
+        for (int k = kFFIBase + 1; k < kFFIClassCount; k++) {
+            if (jEnv->IsInstanceOf(jOwner, g_ids.classes[k])) {
+                lastClass = static_cast<FFIClass>(k);
+                return lastClass;
+            }
+        }
+        return kFFIBase;
+    }
+
+    void adopt(JNIEnv *jEnv, jobject jOwner, jlong jPointer) {
+        HandleDestructor destructor = handleDestructor(classify(jEnv, jOwner));
+        if (destructor == nullptr) {
+            return;
+        }
+        jobject owner = jEnv->NewGlobalRef(jOwner);
+        if (owner == nullptr) {
+            return;
+        }
+        entries.push_back(Entry{owner, jPointer, destructor});
+    }
+
+    /**
+     * Deactivates the arena and frees every handle it holds that is still attached to its owner.
+     * Returns the number of handles freed.
+     */
+    jint release(JNIEnv *jEnv) {
+        deactivate();
+        jint freed = 0;
+        for (auto entry = entries.rbegin(); entry != entries.rend(); ++entry) {
+            if (GetPointerField(jEnv, entry->owner) == entry->pointer) {
+                entry->destructor(jEnv, entry->owner);
+                freed++;
+            }
+            jEnv->DeleteGlobalRef(entry->owner);
+        }
+        entries.clear();
+        return freed;
+    }
+};
+
+thread_local HandleArena *t_activeArena = nullptr;
+
+void adoptHandle(JNIEnv *jEnv, jobject jOwner, jlong jPointer) {
+    t_activeArena->adopt(jEnv, jOwner, jPointer);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_tari_android_wallet_ffi_FFIHandleArena_jniCreate(
+        JNIEnv *jEnv,
+        jobject jThis) {
+    SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(new HandleArena()));
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_tari_android_wallet_ffi_FFIHandleArena_jniActivate(
+        JNIEnv *jEnv,
+        jobject jThis) {
+    reinterpret_cast<HandleArena *>(GetPointerField(jEnv, jThis))->activate();
+}
+
+/**
+ * Entry point for handles that are attached to their owner on the Kotlin side, through the
+ * FFIBase.pointer setter.
+ */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_tari_android_wallet_ffi_FFIHandleArena_jniAdopt(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jobject jTarget) {
+    jlong lPointer = GetPointerField(jEnv, jTarget);
+    if (lPointer != 0) {
+        reinterpret_cast<HandleArena *>(GetPointerField(jEnv, jThis))->adopt(jEnv, jTarget, lPointer);
+    }
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_tari_android_wallet_ffi_FFIHandleArena_jniGetSize(
+        JNIEnv *jEnv,
+        jobject jThis) {
+    auto *pArena = reinterpret_cast<HandleArena *>(GetPointerField(jEnv, jThis));
+    return static_cast<jint>(pArena->entries.size());
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_tari_android_wallet_ffi_FFIHandleArena_jniRelease(
+        JNIEnv *jEnv,
+        jobject jThis) {
+    return reinterpret_cast<HandleArena *>(GetPointerField(jEnv, jThis))->release(jEnv);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_tari_android_wallet_ffi_FFIHandleArena_jniDestroy(
+        JNIEnv *jEnv,
+        jobject jThis) {
+    auto *pArena = reinterpret_cast<HandleArena *>(GetPointerField(jEnv, jThis));
+    if (pArena != nullptr) {
+        pArena->release(jEnv);
+        delete pArena;
+    }
+    SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(nullptr));
+}
@@ -0,0 +1,391 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef JNI_HANDLE_STATS_CPP
+#define JNI_HANDLE_STATS_CPP
+
+#include <jni.h>
+#include <wallet.h>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * Live accounting of the handles the wallet library hands out.
+ *
+ * Every library function that returns a new handle or string, and every matching *_destroy and
+ * string_destroy, is wrapped by a macro of the same name at the end of this file, so the calls
+ * in the jni*.cpp sources are counted without being rewritten. Handles that arrive through the
+ * wallet callbacks are counted where the callbacks receive them. Per handle type the counters
+ * hold the number created, destroyed, live and the live high-water mark.
+ *
+ * Call site recording can be switched on at run time. While it is on, every live handle is
+ * mapped to the entry point that created it, so a dump lists the surviving handles grouped by
+ * call site. Handles created before recording was switched on are counted but not attributed.
+ */
+
+/**
+ * Keep in sync with FFIUtil.HandleType.
+ */
+enum HandleType {
+    kHandleString = 0,
+    kHandleByteVector,
+    kHandlePrivateKey,
+    kHandlePublicKey,
+    kHandleContact,
+    kHandleContacts,
+    kHandleCompletedTx,
+    kHandleCompletedTxs,
+    kHandlePendingInboundTx,
+    kHandlePendingInboundTxs,
+    kHandlePendingOutboundTx,
+    kHandlePendingOutboundTxs,
+    kHandleTransactionKernel,
+    kHandleSeedWords,
+    kHandleEmojiSet,
+    kHandleTransportType,
+    kHandleCommsConfig,
+    kHandleWallet,
+    kHandleTypeCount
+};
+
+static const char *const kHandleTypeNames[kHandleTypeCount] = {
+        "string",
+        "ByteVector",
+        "TariPrivateKey",
+        "TariPublicKey",
+        "TariContact",
+        "TariContacts",
+        "TariCompletedTransaction",
+        "TariCompletedTransactions",
+        "TariPendingInboundTransaction",
+        "TariPendingInboundTransactions",
+        "TariPendingOutboundTransaction",
+        "TariPendingOutboundTransactions",
+        "TariTransactionKernel",
+        "TariSeedWords",
+        "EmojiSet",
+        "TariTransportType",
+        "TariCommsConfig",
+        "TariWallet"
+};
+
+/**
+ * Counters per handle type, in the order returned by HandleStats::getCounters.
+ */
+enum HandleCounter {
+    kHandleCreated = 0,
+    kHandleDestroyed,
+    kHandleLive,
+    kHandleHighWater,
+    kHandleCounterCount
+};
+
+template<typename T>
+struct HandleTypeOf;
+
+#define HANDLE_TYPE_OF(handle, handleType) \
+    template<> \
+    struct HandleTypeOf<handle> { \
+        static const HandleType value = handleType; \
+    }
+
+HANDLE_TYPE_OF(char, kHandleString);
+HANDLE_TYPE_OF(ByteVector, kHandleByteVector);
+HANDLE_TYPE_OF(TariPrivateKey, kHandlePrivateKey);
+HANDLE_TYPE_OF(TariPublicKey, kHandlePublicKey);
+HANDLE_TYPE_OF(TariContact, kHandleContact);
+HANDLE_TYPE_OF(TariContacts, kHandleContacts);
+HANDLE_TYPE_OF(TariCompletedTransaction, kHandleCompletedTx);
+HANDLE_TYPE_OF(TariCompletedTransactions, kHandleCompletedTxs);
+HANDLE_TYPE_OF(TariPendingInboundTransaction, kHandlePendingInboundTx);
+HANDLE_TYPE_OF(TariPendingInboundTransactions, kHandlePendingInboundTxs);
+HANDLE_TYPE_OF(TariPendingOutboundTransaction, kHandlePendingOutboundTx);
+HANDLE_TYPE_OF(TariPendingOutboundTransactions, kHandlePendingOutboundTxs);
+HANDLE_TYPE_OF(TariTransactionKernel, kHandleTransactionKernel);
+HANDLE_TYPE_OF(TariSeedWords, kHandleSeedWords);
+HANDLE_TYPE_OF(EmojiSet, kHandleEmojiSet);
+HANDLE_TYPE_OF(TariTransportType, kHandleTransportType);
+HANDLE_TYPE_OF(TariCommsConfig, kHandleCommsConfig);
+HANDLE_TYPE_OF(TariWallet, kHandleWallet);
+
+#undef HANDLE_TYPE_OF
+
+class HandleStats {
+public:
+    HandleStats() {
+        for (int type = 0; type < kHandleTypeCount; type++) {
+            for (int counter = 0; counter < kHandleCounterCount; counter++) {
+                counters[type][counter].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void onCreated(HandleType type, const void *pHandle, const char *function, int line) {
+        counters[type][kHandleCreated].fetch_add(1, std::memory_order_relaxed);
+        int64_t live = counters[type][kHandleLive].fetch_add(1, std::memory_order_relaxed) + 1;
+        int64_t highWater = counters[type][kHandleHighWater].load(std::memory_order_relaxed);
+        while (live > highWater &&
+               !counters[type][kHandleHighWater].compare_exchange_weak(
+                       highWater, live, std::memory_order_relaxed)) {
+        }
+        if (recordingSites.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(sitesMutex);
+            liveSites[pHandle] = Site{type, function, line};
+        }
+    }
+
+    void onDestroyed(HandleType type, const void *pHandle) {
+        counters[type][kHandleDestroyed].fetch_add(1, std::memory_order_relaxed);
+        counters[type][kHandleLive].fetch_sub(1, std::memory_order_relaxed);
+        if (recordingSites.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(sitesMutex);
+            liveSites.erase(pHandle);
+        }
+    }
+
+    /**
+     * Switching recording off forgets the recorded sites.
+     */
+    void setRecordingSites(bool enabled) {
+        std::lock_guard<std::mutex> lock(sitesMutex);
+        recordingSites.store(enabled, std::memory_order_relaxed);
+        if (!enabled) {
+            liveSites.clear();
+        }
+    }
+
+    bool isRecordingSites() const {
+        return recordingSites.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Writes kHandleCounterCount values per handle type, in HandleType order.
+     */
+    void getCounters(jlong *values) const {
+        for (int type = 0; type < kHandleTypeCount; type++) {
+            for (int counter = 0; counter < kHandleCounterCount; counter++) {
+                values[type * kHandleCounterCount + counter] =
+                        counters[type][counter].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Human readable report: one line per handle type that was ever created, followed by the
+     * live handles per call site, most first, while call site recording is on.
+     */
+    std::string dump() {
+        std::string report = "Native handles (created/destroyed/live/high-water):\n";
+        char line[256];
+        for (int type = 0; type < kHandleTypeCount; type++) {
+            if (counters[type][kHandleCreated].load(std::memory_order_relaxed) == 0) {
+                continue;
+            }
+            snprintf(line, sizeof(line), "  %s: %lld/%lld/%lld/%lld\n",
+                     kHandleTypeNames[type],
+                     static_cast<long long>(counters[type][kHandleCreated].load()),
+                     static_cast<long long>(counters[type][kHandleDestroyed].load()),
+                     static_cast<long long>(counters[type][kHandleLive].load()),
+                     static_cast<long long>(counters[type][kHandleHighWater].load()));
+            report += line;
+        }
+        std::lock_guard<std::mutex> lock(sitesMutex);
+        if (!recordingSites.load(std::memory_order_relaxed)) {
+            return report;
+        }
+        std::map<std::pair<std::string, int>, std::pair<HandleType, int>> bySite;
+        for (const auto &entry : liveSites) {
+            auto &count = bySite[std::make_pair(std::string(entry.second.function), entry.second.line)];
+            count.first = entry.second.type;
+            count.second++;
+        }
+        std::multimap<int, std::string, std::greater<int>> ranked;
+        for (const auto &site : bySite) {
+            snprintf(line, sizeof(line), "  %d %s from %s:%d\n", site.second.second,
+                     kHandleTypeNames[site.second.first], site.first.first.c_str(), site.first.second);
+            ranked.insert(std::make_pair(site.second.second, std::string(line)));
+        }
+        report += "Live handles by call site:\n";
+        for (const auto &site : ranked) {
+            report += site.second;
+        }
+        return report;
+    }
+
+private:
+    struct Site {
+        HandleType type;
+        const char *function;
+        int line;
+    };
+
+    std::atomic<int64_t> counters[kHandleTypeCount][kHandleCounterCount];
+    std::atomic<bool> recordingSites{false};
+    std::mutex sitesMutex;
+    std::unordered_map<const void *, Site> liveSites;
+};
+
+/**
+ * Defined in jniUtil.cpp.
+ */
+extern HandleStats g_handleStats;
+
+template<typename T>
+inline T *trackHandleCreated(T *pHandle, const char *function, int line) {
+    if (pHandle != nullptr) {
+        g_handleStats.onCreated(HandleTypeOf<typename std::remove_const<T>::type>::value,
+                                pHandle, function, line);
+    }
+    return pHandle;
+}
+
+template<typename T, typename Destroy>
+inline void trackHandleDestroyed(T *pHandle, Destroy destroy) {
+    if (pHandle != nullptr) {
+        g_handleStats.onDestroyed(HandleTypeOf<typename std::remove_const<T>::type>::value, pHandle);
+    }
+    destroy(pHandle);
+}
+
+/**
+ * For handles the library passes in rather than returns, i.e. the callback arguments.
+ */
+#define TRACK_HANDLE(pHandle) trackHandleCreated(pHandle, __func__, __LINE__)
+
+// A function-like macro is not expanded again inside its own replacement, so each of these calls
+// the library function of the same name. The wallet_* calls are also recorded by the FFI trace of
+// jniFfiTrace.cpp.
+#define TRACKED_CREATE(call) trackHandleCreated(call, __func__, __LINE__)
+
+#define byte_vector_create(...) TRACKED_CREATE(byte_vector_create(__VA_ARGS__))
+#define comms_config_create(...) TRACKED_CREATE(comms_config_create(__VA_ARGS__))
+#define completed_transaction_get_destination_public_key(...) \
+    TRACKED_CREATE(completed_transaction_get_destination_public_key(__VA_ARGS__))
+#define completed_transaction_get_message(...) TRACKED_CREATE(completed_transaction_get_message(__VA_ARGS__))
+#define completed_transaction_get_source_public_key(...) \
+    TRACKED_CREATE(completed_transaction_get_source_public_key(__VA_ARGS__))
+#define completed_transaction_get_transaction_kernel(...) \
+    TRACKED_CREATE(completed_transaction_get_transaction_kernel(__VA_ARGS__))
+#define completed_transactions_get_at(...) TRACKED_CREATE(completed_transactions_get_at(__VA_ARGS__))
+#define contact_create(...) TRACKED_CREATE(contact_create(__VA_ARGS__))
+#define contact_get_alias(...) TRACKED_CREATE(contact_get_alias(__VA_ARGS__))
+#define contact_get_public_key(...) TRACKED_CREATE(contact_get_public_key(__VA_ARGS__))
+#define contacts_get_at(...) TRACKED_CREATE(contacts_get_at(__VA_ARGS__))
+#define emoji_id_to_public_key(...) TRACKED_CREATE(emoji_id_to_public_key(__VA_ARGS__))
+#define emoji_set_get_at(...) TRACKED_CREATE(emoji_set_get_at(__VA_ARGS__))
+#define get_emoji_set(...) TRACKED_CREATE(get_emoji_set(__VA_ARGS__))
+#define pending_inbound_transaction_get_message(...) \
+    TRACKED_CREATE(pending_inbound_transaction_get_message(__VA_ARGS__))
+#define pending_inbound_transaction_get_source_public_key(...) \
+    TRACKED_CREATE(pending_inbound_transaction_get_source_public_key(__VA_ARGS__))
+#define pending_inbound_transactions_get_at(...) \
+    TRACKED_CREATE(pending_inbound_transactions_get_at(__VA_ARGS__))
+#define pending_outbound_transaction_get_destination_public_key(...) \
+    TRACKED_CREATE(pending_outbound_transaction_get_destination_public_key(__VA_ARGS__))
+#define pending_outbound_transaction_get_message(...) \
+    TRACKED_CREATE(pending_outbound_transaction_get_message(__VA_ARGS__))
+#define pending_outbound_transactions_get_at(...) \
+    TRACKED_CREATE(pending_outbound_transactions_get_at(__VA_ARGS__))
+#define private_key_create(...) TRACKED_CREATE(private_key_create(__VA_ARGS__))
+#define private_key_from_hex(...) TRACKED_CREATE(private_key_from_hex(__VA_ARGS__))
+#define private_key_generate(...) TRACKED_CREATE(private_key_generate(__VA_ARGS__))
+#define private_key_get_bytes(...) TRACKED_CREATE(private_key_get_bytes(__VA_ARGS__))
+#define public_key_create(...) TRACKED_CREATE(public_key_create(__VA_ARGS__))
+#define public_key_from_hex(...) TRACKED_CREATE(public_key_from_hex(__VA_ARGS__))
+#define public_key_from_private_key(...) TRACKED_CREATE(public_key_from_private_key(__VA_ARGS__))
+#define public_key_get_bytes(...) TRACKED_CREATE(public_key_get_bytes(__VA_ARGS__))
+#define public_key_to_emoji_id(...) TRACKED_CREATE(public_key_to_emoji_id(__VA_ARGS__))
+#define seed_words_create(...) TRACKED_CREATE(seed_words_create(__VA_ARGS__))
+#define seed_words_get_at(...) TRACKED_CREATE(seed_words_get_at(__VA_ARGS__))
+#define transaction_kernel_get_excess_hex(...) TRACKED_CREATE(transaction_kernel_get_excess_hex(__VA_ARGS__))
+#define transaction_kernel_get_excess_public_nonce_hex(...) \
+    TRACKED_CREATE(transaction_kernel_get_excess_public_nonce_hex(__VA_ARGS__))
+#define transaction_kernel_get_excess_signature_hex(...) \
+    TRACKED_CREATE(transaction_kernel_get_excess_signature_hex(__VA_ARGS__))
+#define transport_memory_create(...) TRACKED_CREATE(transport_memory_create(__VA_ARGS__))
+#define transport_memory_get_address(...) TRACKED_CREATE(transport_memory_get_address(__VA_ARGS__))
+#define transport_tcp_create(...) TRACKED_CREATE(transport_tcp_create(__VA_ARGS__))
+#define transport_tor_create(...) TRACKED_CREATE(transport_tor_create(__VA_ARGS__))
+#define wallet_create(...) TRACKED_CREATE(FFI_TRACED(wallet_create, __VA_ARGS__))
+#define wallet_get_cancelled_transaction_by_id(...) \
+    TRACKED_CREATE(FFI_TRACED(wallet_get_cancelled_transaction_by_id, __VA_ARGS__))
+#define wallet_get_cancelled_transactions(...) TRACKED_CREATE(FFI_TRACED(wallet_get_cancelled_transactions, __VA_ARGS__))
+#define wallet_get_completed_transaction_by_id(...) \
+    TRACKED_CREATE(FFI_TRACED(wallet_get_completed_transaction_by_id, __VA_ARGS__))
+#define wallet_get_completed_transactions(...) TRACKED_CREATE(FFI_TRACED(wallet_get_completed_transactions, __VA_ARGS__))
+#define wallet_get_contacts(...) TRACKED_CREATE(FFI_TRACED(wallet_get_contacts, __VA_ARGS__))
+#define wallet_get_pending_inbound_transaction_by_id(...) \
+    TRACKED_CREATE(FFI_TRACED(wallet_get_pending_inbound_transaction_by_id, __VA_ARGS__))
+#define wallet_get_pending_inbound_transactions(...) \
+    TRACKED_CREATE(FFI_TRACED(wallet_get_pending_inbound_transactions, __VA_ARGS__))
+#define wallet_get_pending_outbound_transaction_by_id(...) \
+    TRACKED_CREATE(FFI_TRACED(wallet_get_pending_outbound_transaction_by_id, __VA_ARGS__))
+#define wallet_get_pending_outbound_transactions(...) \
+    TRACKED_CREATE(FFI_TRACED(wallet_get_pending_outbound_transactions, __VA_ARGS__))
+#define wallet_get_public_key(...) TRACKED_CREATE(FFI_TRACED(wallet_get_public_key, __VA_ARGS__))
+#define wallet_get_seed_words(...) TRACKED_CREATE(FFI_TRACED(wallet_get_seed_words, __VA_ARGS__))
+#define wallet_get_value(...) TRACKED_CREATE(FFI_TRACED(wallet_get_value, __VA_ARGS__))
+#define wallet_sign_message(...) TRACKED_CREATE(FFI_TRACED(wallet_sign_message, __VA_ARGS__))
+
+#define byte_vector_destroy(pHandle) trackHandleDestroyed(pHandle, byte_vector_destroy)
+#define comms_config_destroy(pHandle) trackHandleDestroyed(pHandle, comms_config_destroy)
+#define completed_transaction_destroy(pHandle) trackHandleDestroyed(pHandle, completed_transaction_destroy)
+#define completed_transactions_destroy(pHandle) trackHandleDestroyed(pHandle, completed_transactions_destroy)
+#define contact_destroy(pHandle) trackHandleDestroyed(pHandle, contact_destroy)
+#define contacts_destroy(pHandle) trackHandleDestroyed(pHandle, contacts_destroy)
+#define emoji_set_destroy(pHandle) trackHandleDestroyed(pHandle, emoji_set_destroy)
+#define pending_inbound_transaction_destroy(pHandle) \
+    trackHandleDestroyed(pHandle, pending_inbound_transaction_destroy)
+#define pending_inbound_transactions_destroy(pHandle) \
+    trackHandleDestroyed(pHandle, pending_inbound_transactions_destroy)
+#define pending_outbound_transaction_destroy(pHandle) \
+    trackHandleDestroyed(pHandle, pending_outbound_transaction_destroy)
+#define pending_outbound_transactions_destroy(pHandle) \
+    trackHandleDestroyed(pHandle, pending_outbound_transactions_destroy)
+#define private_key_destroy(pHandle) trackHandleDestroyed(pHandle, private_key_destroy)
+#define public_key_destroy(pHandle) trackHandleDestroyed(pHandle, public_key_destroy)
+#define seed_words_destroy(pHandle) trackHandleDestroyed(pHandle, seed_words_destroy)
+#define string_destroy(pHandle) trackHandleDestroyed(pHandle, string_destroy)
+#define transaction_kernel_destroy(pHandle) trackHandleDestroyed(pHandle, transaction_kernel_destroy)
+#define transport_type_destroy(pHandle) trackHandleDestroyed(pHandle, transport_type_destroy)
+#define wallet_destroy(pHandle) \
+    trackHandleDestroyed(pHandle, [](TariWallet *pWallet) { FFI_TRACED(wallet_destroy, pWallet); })
+
+#endif // JNI_HANDLE_STATS_CPP
@@ -0,0 +1,297 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef JNI_HEX_CODEC_CPP
+#define JNI_HEX_CODEC_CPP
+
+#include <jni.h>
+#include <wallet.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "jniCommon.cpp"
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__AVX2__) || defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Hex codec for keys and kernel fields. The bulk of the input goes through 16 or 32 byte vector
+ * steps, NEON on arm64 and AVX2 or SSSE3 on x86_64 depending on the target flags (the Android
+ * x86_64 ABI guarantees SSSE3), the remainder and every other ABI through the scalar loop.
+ */
+
+static const char kHexDigitsUpper[17] = "0123456789ABCDEF";
+static const char kHexDigitsLower[17] = "0123456789abcdef";
+
+/**
+ * Value of one hex digit, or -1.
+ */
+inline int hexDigitValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    char lower = static_cast<char>(c | 0x20);
+    if (lower >= 'a' && lower <= 'f') {
+        return lower - 'a' + 10;
+    }
+    return -1;
+}
+
+/**
+ * Writes 2 * length digits to hex, which is not null-terminated.
+ */
+inline void hexEncode(const uint8_t *bytes, size_t length, char *hex, bool upperCase) {
+    const char *digits = upperCase ? kHexDigitsUpper : kHexDigitsLower;
+    size_t k = 0;
+#if defined(__aarch64__)
+    const uint8x16_t table = vld1q_u8(reinterpret_cast<const uint8_t *>(digits));
+    const uint8x16_t lowNibble = vdupq_n_u8(0x0F);
+    for (; k + 16 <= length; k += 16) {
+        uint8x16_t value = vld1q_u8(bytes + k);
+        uint8x16x2_t pairs;
+        pairs.val[0] = vqtbl1q_u8(table, vshrq_n_u8(value, 4));
+        pairs.val[1] = vqtbl1q_u8(table, vandq_u8(value, lowNibble));
+        vst2q_u8(reinterpret_cast<uint8_t *>(hex + 2 * k), pairs);
+    }
+#elif defined(__AVX2__)
+    const __m256i table = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(digits)));
+    const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+    for (; k + 32 <= length; k += 32) {
+        __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes + k));
+        __m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(value, 4), lowNibble));
+        __m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(value, lowNibble));
+        // the unpacks interleave within each 128-bit lane, the permutes restore byte order
+        __m256i first = _mm256_unpacklo_epi8(high, low);
+        __m256i second = _mm256_unpackhi_epi8(high, low);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(hex + 2 * k),
+                            _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(hex + 2 * k + 32),
+                            _mm256_permute2x128_si256(first, second, 0x31));
+    }
+#elif defined(__SSSE3__)
+    const __m128i table = _mm_loadu_si128(reinterpret_cast<const __m128i *>(digits));
+    const __m128i lowNibble = _mm_set1_epi8(0x0F);
+    for (; k + 16 <= length; k += 16) {
+        __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + k));
+        __m128i high = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(value, 4), lowNibble));
+        __m128i low = _mm_shuffle_epi8(table, _mm_and_si128(value, lowNibble));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(hex + 2 * k), _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(hex + 2 * k + 16), _mm_unpackhi_epi8(high, low));
+    }
+#endif
+    for (; k < length; k++) {
+        hex[2 * k] = digits[bytes[k] >> 4];
+        hex[2 * k + 1] = digits[bytes[k] & 0x0F];
+    }
+}
+
+#if defined(__SSSE3__) && !defined(__aarch64__)
+/**
+ * Digit values of 16 characters, and in invalid a mask of the characters that are not hex digits.
+ */
+inline __m128i hexDigitValues(__m128i c, __m128i &invalid) {
+    __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    __m128i letter = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    // unsigned x <= n is min(x, n) == x
+    __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    __m128i isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+    invalid = _mm_or_si128(invalid, _mm_andnot_si128(_mm_or_si128(isDigit, isLetter), _mm_set1_epi8(-1)));
+    __m128i letterValue = _mm_add_epi8(letter, _mm_set1_epi8(10));
+    return _mm_or_si128(_mm_and_si128(isDigit, digit), _mm_andnot_si128(isDigit, letterValue));
+}
+#endif
+
+#if defined(__AVX2__)
+inline __m256i hexDigitValues(__m256i c, __m256i &invalid) {
+    __m256i digit = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+    __m256i letter = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    __m256i isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+    __m256i isLetter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+    invalid = _mm256_or_si256(invalid, _mm256_andnot_si256(_mm256_or_si256(isDigit, isLetter), _mm256_set1_epi8(-1)));
+    __m256i letterValue = _mm256_add_epi8(letter, _mm256_set1_epi8(10));
+    return _mm256_or_si256(_mm256_and_si256(isDigit, digit), _mm256_andnot_si256(isDigit, letterValue));
+}
+#endif
+
+/**
+ * Decodes 2 * length digits of either case into length bytes. Returns false if any character is
+ * not a hex digit, bytes is then partially written.
+ */
+inline bool hexDecode(const char *hex, size_t length, uint8_t *bytes) {
+    size_t k = 0;
+#if defined(__aarch64__)
+    const uint8x16_t zero = vdupq_n_u8('0');
+    const uint8x16_t a = vdupq_n_u8('a');
+    const uint8x16_t caseBit = vdupq_n_u8(0x20);
+    const uint8x16_t ten = vdupq_n_u8(10);
+    const uint8x16_t six = vdupq_n_u8(6);
+    uint8x16_t valid = vdupq_n_u8(0xFF);
+    for (; k + 16 <= length; k += 16) {
+        // even characters are high nibbles, odd ones low nibbles
+        uint8x16x2_t c = vld2q_u8(reinterpret_cast<const uint8_t *>(hex + 2 * k));
+        uint8x16_t nibbles[2];
+        for (int half = 0; half < 2; half++) {
+            uint8x16_t digit = vsubq_u8(c.val[half], zero);
+            uint8x16_t letter = vsubq_u8(vorrq_u8(c.val[half], caseBit), a);
+            uint8x16_t isDigit = vcltq_u8(digit, ten);
+            uint8x16_t isLetter = vcltq_u8(letter, six);
+            valid = vandq_u8(valid, vorrq_u8(isDigit, isLetter));
+            nibbles[half] = vbslq_u8(isDigit, digit, vaddq_u8(letter, ten));
+        }
+        vst1q_u8(bytes + k, vorrq_u8(vshlq_n_u8(nibbles[0], 4), nibbles[1]));
+    }
+    if (vminvq_u8(valid) == 0) {
+        return false;
+    }
+#elif defined(__AVX2__)
+    // multiply-add of (high, low) pairs with (16, 1) gives one byte per 16-bit lane
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+    __m256i invalid = _mm256_setzero_si256();
+    for (; k + 32 <= length; k += 32) {
+        __m256i first = hexDigitValues(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(hex + 2 * k)), invalid);
+        __m256i second = hexDigitValues(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(hex + 2 * k + 32)), invalid);
+        __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(first, weights),
+                                             _mm256_maddubs_epi16(second, weights));
+        // packus works within 128-bit lanes, put the four quarters back in order
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(bytes + k),
+                            _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+    if (!_mm256_testz_si256(invalid, invalid)) {
+        return false;
+    }
+#elif defined(__SSSE3__)
+    const __m128i weights = _mm_set1_epi16(0x0110);
+    __m128i invalid = _mm_setzero_si128();
+    for (; k + 16 <= length; k += 16) {
+        __m128i first = hexDigitValues(
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(hex + 2 * k)), invalid);
+        __m128i second = hexDigitValues(
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(hex + 2 * k + 16)), invalid);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(bytes + k),
+                         _mm_packus_epi16(_mm_maddubs_epi16(first, weights),
+                                          _mm_maddubs_epi16(second, weights)));
+    }
+    if (_mm_movemask_epi8(invalid) != 0) {
+        return false;
+    }
+#endif
+    for (; k < length; k++) {
+        int high = hexDigitValue(hex[2 * k]);
+        int low = hexDigitValue(hex[2 * k + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        bytes[k] = static_cast<uint8_t>(high << 4 | low);
+    }
+    return true;
+}
+
+/**
+ * Decodes a Java string of hex digits into a new ByteVector, without the modified UTF-8 copy
+ * GetStringUTFChars makes. Returns nullptr with kErrorInvalidArgument in r for an odd length or
+ * any character that is not a hex digit.
+ */
+inline ByteVector *byteVectorFromHexString(JNIEnv *jEnv, jstring jHex, int *r) {
+    jsize digitCount = jHex == nullptr ? -1 : jEnv->GetStringLength(jHex);
+    // non-ASCII characters take more than one modified UTF-8 byte
+    if (digitCount < 0 || digitCount % 2 != 0 || jEnv->GetStringUTFLength(jHex) != digitCount) {
+        *r = kErrorInvalidArgument;
+        return nullptr;
+    }
+    // keys fit on the stack
+    char stackHex[128];
+    uint8_t stackBytes[64];
+    std::vector<char> heapHex;
+    std::vector<uint8_t> heapBytes;
+    char *hex = stackHex;
+    uint8_t *bytes = stackBytes;
+    // one spare byte: HotSpot's GetStringUTFRegion appends a NUL, ART's does not
+    if (static_cast<size_t>(digitCount) >= sizeof(stackHex)) {
+        heapHex.resize(digitCount + 1);
+        heapBytes.resize(digitCount / 2);
+        hex = heapHex.data();
+        bytes = heapBytes.data();
+    }
+    jEnv->GetStringUTFRegion(jHex, 0, digitCount, hex);
+    if (!hexDecode(hex, static_cast<size_t>(digitCount / 2), bytes)) {
+        *r = kErrorInvalidArgument;
+        return nullptr;
+    }
+    return byte_vector_create(bytes, static_cast<unsigned int>(digitCount / 2), r);
+}
+
+/**
+ * Copies up to capacity bytes of a ByteVector, returns the number copied, or -1 with the error
+ * in r if the vector could not be read or does not fit.
+ */
+inline int readByteVector(ByteVector *pBytes, uint8_t *bytes, size_t capacity, int *r) {
+    unsigned int length = byte_vector_get_length(pBytes, r);
+    if (*r != 0 || length > capacity) {
+        return -1;
+    }
+    for (unsigned int k = 0; k < length && *r == 0; k++) {
+        bytes[k] = byte_vector_get_at(pBytes, k, r);
+    }
+    return *r == 0 ? static_cast<int>(length) : -1;
+}
+
+/**
+ * Uppercase hex string of a key-sized ByteVector, the format HexString uses. Releases the
+ * vector. Returns nullptr with the error in r if it could not be read.
+ */
+inline jstring takeByteVectorHexString(JNIEnv *jEnv, ByteVector *pBytes, int *r) {
+    if (pBytes == nullptr) {
+        return nullptr;
+    }
+    uint8_t bytes[64];
+    int length = readByteVector(pBytes, bytes, sizeof(bytes), r);
+    byte_vector_destroy(pBytes);
+    if (length < 0) {
+        if (*r == 0) {
+            *r = kErrorInvalidArgument;
+        }
+        return nullptr;
+    }
+    char hex[2 * sizeof(bytes) + 1];
+    hexEncode(bytes, static_cast<size_t>(length), hex, true);
+    hex[2 * length] = '\0';
+    return jEnv->NewStringUTF(hex);
+}
+
+#endif // JNI_HEX_CODEC_CPP
@@ -38,9 +38,10 @@
 #include <cmath>
 #include <android/log.h>
 #include "jniCommon.cpp"
+#include "jniUtf8.cpp"
 
 extern "C"
-JNIEXPORT jbyteArray JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniGetId(
         JNIEnv *jEnv,
         jobject jThis,
@@ -49,10 +50,8 @@ Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniGetId(
     int *r = &i;
     jlong lInboundTx = GetPointerField(jEnv, jThis);
     auto *pInboundTx = reinterpret_cast<TariPendingInboundTransaction *>(lInboundTx);
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv,
-            pending_inbound_transaction_get_transaction_id(pInboundTx, r)
-    );
+    auto result = static_cast<jlong>(
+            pending_inbound_transaction_get_transaction_id(pInboundTx, r));
     setErrorCode(jEnv, error, i);
     return result;
 }
@@ -75,7 +74,7 @@ Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniGetSourcePublicKey(
 }
 
 extern "C"
-JNIEXPORT jbyteArray JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniGetAmount(
         JNIEnv *jEnv,
         jobject jThis,
@@ -84,10 +83,8 @@ Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniGetAmount(
     int *r = &i;
     jlong lInboundTx = GetPointerField(jEnv, jThis);
     auto *pInboundTx = reinterpret_cast<TariPendingInboundTransaction *>(lInboundTx);
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv,
-            pending_inbound_transaction_get_amount(pInboundTx, r)
-    );
+    auto result = static_cast<jlong>(
+            pending_inbound_transaction_get_amount(pInboundTx, r));
     setErrorCode(jEnv, error, i);
     return result;
 }
@@ -104,13 +101,13 @@ Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniGetMessage(
     auto *pInboundTx = reinterpret_cast<TariPendingInboundTransaction *>(lInboundTx);
     const char *pMessage = pending_inbound_transaction_get_message(pInboundTx, r);
     setErrorCode(jEnv, error, i);
-    jstring result = jEnv->NewStringUTF(pMessage);
+    jstring result = newStringFromUtf8(jEnv, pMessage);
     string_destroy(const_cast<char *>(pMessage));
     return result;
 }
 
 extern "C"
-JNIEXPORT jbyteArray JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniGetTimestamp(
         JNIEnv *jEnv,
         jobject jThis,
@@ -119,10 +116,8 @@ Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniGetTimestamp(
     int *r = &i;
     jlong lInboundTx = GetPointerField(jEnv, jThis);
     auto *pInboundTx = reinterpret_cast<TariPendingInboundTransaction *>(lInboundTx);
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv,
-            pending_inbound_transaction_get_timestamp(pInboundTx, r)
-    );
+    auto result = static_cast<jlong>(
+            pending_inbound_transaction_get_timestamp(pInboundTx, r));
     setErrorCode(jEnv, error, i);
     return result;
 }
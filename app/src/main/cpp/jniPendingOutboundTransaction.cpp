@@ -38,9 +38,10 @@
 #include <cmath>
 #include <android/log.h>
 #include "jniCommon.cpp"
+#include "jniUtf8.cpp"
 
 extern "C"
-JNIEXPORT jbyteArray JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetId(
         JNIEnv *jEnv,
         jobject jThis,
@@ -49,10 +50,8 @@ Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetId(
     int *r = &i;
     jlong lOutboundTx = GetPointerField(jEnv, jThis);
     auto *pOutboundTx = reinterpret_cast<TariPendingOutboundTransaction *>(lOutboundTx);
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv,
-            pending_outbound_transaction_get_transaction_id(pOutboundTx, r)
-    );
+    auto result = static_cast<jlong>(
+            pending_outbound_transaction_get_transaction_id(pOutboundTx, r));
     setErrorCode(jEnv, error, i);
     return result;
 }
@@ -75,7 +74,7 @@ Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetDestinationPublicKey
 }
 
 extern "C"
-JNIEXPORT jbyteArray JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetAmount(
         JNIEnv *jEnv,
         jobject jThis,
@@ -84,17 +83,15 @@ Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetAmount(
     int *r = &i;
     jlong lOutboundTx = GetPointerField(jEnv, jThis);
     auto *pOutboundTx = reinterpret_cast<TariPendingOutboundTransaction *>(lOutboundTx);
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv,
-            pending_outbound_transaction_get_amount(pOutboundTx, r)
-    );
+    auto result = static_cast<jlong>(
+            pending_outbound_transaction_get_amount(pOutboundTx, r));
     setErrorCode(jEnv, error, i);
     return result;
 }
 
 
 extern "C"
-JNIEXPORT jbyteArray JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetFee(
         JNIEnv *jEnv,
         jobject jThis,
@@ -103,10 +100,8 @@ Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetFee(
     int *r = &i;
     jlong lOutboundTx = GetPointerField(jEnv, jThis);
     auto *pOutboundTx = reinterpret_cast<TariPendingOutboundTransaction *>(lOutboundTx);
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv,
-            pending_outbound_transaction_get_fee(pOutboundTx, r)
-    );
+    auto result = static_cast<jlong>(
+            pending_outbound_transaction_get_fee(pOutboundTx, r));
     setErrorCode(jEnv, error, i);
     return result;
 }
@@ -123,13 +118,13 @@ Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetMessage(
     auto *pOutboundTx = reinterpret_cast<TariPendingOutboundTransaction *>(lOutboundTx);
     const char *pMessage = pending_outbound_transaction_get_message(pOutboundTx, r);
     setErrorCode(jEnv, error, i);
-    jstring result = jEnv->NewStringUTF(pMessage);
+    jstring result = newStringFromUtf8(jEnv, pMessage);
     string_destroy(const_cast<char *>(pMessage));
     return result;
 }
 
 extern "C"
-JNIEXPORT jbyteArray JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetTimestamp(
         JNIEnv *jEnv,
         jobject jThis,
@@ -138,10 +133,8 @@ Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetTimestamp(
     int *r = &i;
     jlong lOutboundTx = GetPointerField(jEnv, jThis);
     auto *pOutboundTx = reinterpret_cast<TariPendingOutboundTransaction *>(lOutboundTx);
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv,
-            pending_outbound_transaction_get_timestamp(pOutboundTx, r)
-    );
+    auto result = static_cast<jlong>(
+            pending_outbound_transaction_get_timestamp(pOutboundTx, r));
     setErrorCode(jEnv, error, i);
     return result;
 }
@@ -38,6 +38,7 @@
 #include <cmath>
 #include <android/log.h>
 #include "jniCommon.cpp"
+#include "jniHexCodec.cpp"
 
 extern "C"
 JNIEXPORT void JNICALL
@@ -72,10 +73,10 @@ Java_com_tari_android_wallet_ffi_FFIPrivateKey_jniFromHex(
         jobject error) {
     int i = 0;
     int *r = &i;
-    const char *pStr = jEnv->GetStringUTFChars(jHexStr, JNI_FALSE);
-    TariPrivateKey *pPrivateKey = private_key_from_hex(pStr, r);
+    ByteVector *pBytes = byteVectorFromHexString(jEnv, jHexStr, r);
+    TariPrivateKey *pPrivateKey = pBytes != nullptr ? private_key_create(pBytes, r) : nullptr;
+    byte_vector_destroy(pBytes);
     setErrorCode(jEnv, error, i);
-    jEnv->ReleaseStringUTFChars(jHexStr, pStr);
     SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(pPrivateKey));
 }
 
@@ -94,6 +95,21 @@ Java_com_tari_android_wallet_ffi_FFIPrivateKey_jniGetBytes(
     return result;
 }
 
+extern "C"
+JNIEXPORT jstring JNICALL
+Java_com_tari_android_wallet_ffi_FFIPrivateKey_jniGetHex(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jobject error) {
+    int i = 0;
+    int *r = &i;
+    jlong lPrivateKey = GetPointerField(jEnv, jThis);
+    auto *pPrivateKey = reinterpret_cast<TariPrivateKey *>(lPrivateKey);
+    jstring result = takeByteVectorHexString(jEnv, private_key_get_bytes(pPrivateKey, r), r);
+    setErrorCode(jEnv, error, i);
+    return result;
+}
+
 extern "C"
 JNIEXPORT void JNICALL
 Java_com_tari_android_wallet_ffi_FFIPrivateKey_jniDestroy(
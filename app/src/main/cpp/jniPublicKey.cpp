@@ -38,6 +38,17 @@
 #include <cmath>
 #include <android/log.h>
 #include "jniCommon.cpp"
+#include "jniEmojiIdCache.cpp"
+#include "jniEmojiTable.cpp"
+#include "jniHexCodec.cpp"
+#include "jniUtf8.cpp"
+
+/**
+ * Enough for the counterparties of a long tx history.
+ */
+static const size_t kEmojiIdCacheCapacity = 512;
+
+EmojiIdCache g_emojiIdCache(kEmojiIdCacheCapacity);
 
 extern "C"
 JNIEXPORT void JNICALL
@@ -64,10 +75,10 @@ Java_com_tari_android_wallet_ffi_FFIPublicKey_jniFromHex(
         jobject error) {
     int i = 0;
     int *r = &i;
-    const char *pStr = jEnv->GetStringUTFChars(jHexStr, JNI_FALSE);
-    TariPublicKey *pPublicKey = public_key_from_hex(pStr, r);
+    ByteVector *pBytes = byteVectorFromHexString(jEnv, jHexStr, r);
+    TariPublicKey *pPublicKey = pBytes != nullptr ? public_key_create(pBytes, r) : nullptr;
+    byte_vector_destroy(pBytes);
     setErrorCode(jEnv, error, i);
-    jEnv->ReleaseStringUTFChars(jHexStr, pStr);
     SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(pPublicKey));
 }
 
@@ -97,10 +108,126 @@ Java_com_tari_android_wallet_ffi_FFIPublicKey_jniFromEmojiId(
     int i = 0;
     int *r = &i;
     const char *pStr = jEnv->GetStringUTFChars(jpEmoji, JNI_FALSE);
-    auto result = reinterpret_cast<jlong>(emoji_id_to_public_key(pStr, r));
+    std::string emojiId(pStr);
     jEnv->ReleaseStringUTFChars(jpEmoji, pStr);
+    std::string keyBytes;
+    TariPublicKey *pPublicKey = g_emojiIdCache.acquireKey(emojiId, keyBytes);
+    if (pPublicKey == nullptr) {
+        if (keyBytes.empty()) {
+            pPublicKey = emoji_id_to_public_key(emojiId.c_str(), r);
+            if (pPublicKey != nullptr && !getPublicKeyBytes(pPublicKey, keyBytes, r)) {
+                public_key_destroy(pPublicKey);
+                pPublicKey = nullptr;
+            }
+        } else {
+            ByteVector *pBytes = byte_vector_create(
+                    reinterpret_cast<const unsigned char *>(keyBytes.data()),
+                    static_cast<unsigned int>(keyBytes.size()),
+                    r);
+            pPublicKey = public_key_create(pBytes, r);
+            byte_vector_destroy(pBytes);
+        }
+        if (pPublicKey != nullptr) {
+            g_emojiIdCache.adoptKey(jEnv, keyBytes, emojiId, pPublicKey);
+        }
+    }
     setErrorCode(jEnv, error, i);
-    SetPointerField(jEnv, jThis, result);
+    SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(pPublicKey));
+}
+
+/**
+ * Outcome of validateEmojiId. Keep in sync with FFIPublicKey.EmojiIdValidation.
+ */
+enum EmojiIdError {
+    kEmojiIdValid = 0,
+    kEmojiIdNotAnEmoji,
+    kEmojiIdTooShort,
+    kEmojiIdTooLong,
+    kEmojiIdChecksum
+};
+
+/**
+ * Key bytes followed by one checksum emoji.
+ */
+static const int kEmojiIdKeyLength = 32;
+static const int kEmojiIdLength = kEmojiIdKeyLength + 1;
+
+/**
+ * Luhn mod 256 check value of the key bytes, the way the wallet library computes the checksum
+ * emoji: from the right, every second byte starting with the last one is doubled and folded.
+ */
+static int emojiIdChecksum(const int *indices, int length) {
+    int sum = 0;
+    int factor = 2;
+    for (int k = length - 1; k >= 0; k--) {
+        int addend = factor * indices[k];
+        sum += addend / kEmojiAlphabetSize + addend % kEmojiAlphabetSize;
+        factor ^= 3;
+    }
+    return (kEmojiAlphabetSize - sum % kEmojiAlphabetSize) % kEmojiAlphabetSize;
+}
+
+/**
+ * Decodes UTF-16 units against the emoji alphabet and checks length and checksum. Sets position
+ * to the UTF-16 index of the first offending emoji, or to length for a string that is too short.
+ * unitCount may be less than length: no more than kEmojiIdLength emoji plus one unit are needed
+ * to decide.
+ */
+static EmojiIdError validateEmojiId(const jchar *units, jsize unitCount, jsize length, jint *position) {
+    int indices[kEmojiIdLength];
+    int count = 0;
+    jsize unit = 0;
+    while (unit < unitCount) {
+        if (count == kEmojiIdLength) {
+            *position = unit;
+            return kEmojiIdTooLong;
+        }
+        jchar high = units[unit];
+        bool isPair = high >= 0xD800 && high < 0xDC00 && unit + 1 < unitCount
+                      && units[unit + 1] >= 0xDC00 && units[unit + 1] < 0xE000;
+        int index = isPair
+                    ? emojiIndexOf(0x10000 + ((static_cast<char32_t>(high) - 0xD800) << 10)
+                                   + (units[unit + 1] - 0xDC00))
+                    : -1;
+        if (index < 0) {
+            *position = unit;
+            return kEmojiIdNotAnEmoji;
+        }
+        indices[count++] = index;
+        unit += 2;
+    }
+    if (count < kEmojiIdLength) {
+        *position = length;
+        return kEmojiIdTooShort;
+    }
+    if (emojiIdChecksum(indices, kEmojiIdKeyLength) != indices[kEmojiIdKeyLength]) {
+        *position = length - 2;
+        return kEmojiIdChecksum;
+    }
+    *position = -1;
+    return kEmojiIdValid;
+}
+
+/**
+ * Checks an emoji ID without building a key. Returns the EmojiIdError in the upper 32 bits and
+ * the position of the first error (-1 if valid) in the lower 32 bits.
+ */
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_tari_android_wallet_ffi_FFIPublicKey_jniValidateEmojiId(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jstring jEmojiId) {
+    jsize length = jEnv->GetStringLength(jEmojiId);
+    // every emoji of the alphabet is a surrogate pair
+    jchar units[2 * kEmojiIdLength + 1];
+    jsize unitCount = length < static_cast<jsize>(sizeof(units) / sizeof(jchar))
+                      ? length
+                      : static_cast<jsize>(sizeof(units) / sizeof(jchar));
+    jEnv->GetStringRegion(jEmojiId, 0, unitCount, units);
+    jint position = -1;
+    EmojiIdError result = validateEmojiId(units, unitCount, length, &position);
+    return static_cast<jlong>(result) << 32 | static_cast<jlong>(static_cast<uint32_t>(position));
 }
 
 extern "C"
@@ -113,13 +240,39 @@ Java_com_tari_android_wallet_ffi_FFIPublicKey_jniGetEmojiId(
     int *r = &i;
     jlong lPublicKey = GetPointerField(jEnv, jThis);
     auto *pPublicKey = reinterpret_cast<TariPublicKey *>(lPublicKey);
+    std::string keyBytes;
+    bool cacheable = getPublicKeyBytes(pPublicKey, keyBytes, r);
+    jstring result = cacheable ? g_emojiIdCache.findEmojiId(jEnv, keyBytes) : nullptr;
+    if (result != nullptr) {
+        setErrorCode(jEnv, error, i);
+        return result;
+    }
+    i = 0;
     const char *pEmoji = public_key_to_emoji_id(pPublicKey, r);
     setErrorCode(jEnv, error, i);
-    jstring result = jEnv->NewStringUTF(pEmoji);
+    result = newStringFromUtf8(jEnv, pEmoji);
+    if (cacheable && i == 0 && pEmoji != nullptr && result != nullptr) {
+        g_emojiIdCache.putEmojiId(jEnv, keyBytes, pEmoji, result);
+    }
     string_destroy(const_cast<char *>(pEmoji));
     return result;
 }
 
+/**
+ * Returns the emoji ID cache counters in EmojiIdCacheStat order.
+ */
+extern "C"
+JNIEXPORT jlongArray JNICALL
+Java_com_tari_android_wallet_ffi_FFIPublicKey_jniGetEmojiIdCacheStats(
+        JNIEnv *jEnv,
+        jobject jThis) {
+    jlong stats[kEmojiIdCacheStatCount];
+    g_emojiIdCache.getStats(stats);
+    jlongArray result = jEnv->NewLongArray(kEmojiIdCacheStatCount);
+    jEnv->SetLongArrayRegion(result, 0, kEmojiIdCacheStatCount, stats);
+    return result;
+}
+
 extern "C"
 JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFIPublicKey_jniGetBytes(
@@ -135,12 +288,31 @@ Java_com_tari_android_wallet_ffi_FFIPublicKey_jniGetBytes(
     return result;
 }
 
+extern "C"
+JNIEXPORT jstring JNICALL
+Java_com_tari_android_wallet_ffi_FFIPublicKey_jniGetHex(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jobject error) {
+    int i = 0;
+    int *r = &i;
+    jlong lPublicKey = GetPointerField(jEnv, jThis);
+    auto *pPublicKey = reinterpret_cast<TariPublicKey *>(lPublicKey);
+    jstring result = takeByteVectorHexString(jEnv, public_key_get_bytes(pPublicKey, r), r);
+    setErrorCode(jEnv, error, i);
+    return result;
+}
+
 extern "C"
 JNIEXPORT void JNICALL
 Java_com_tari_android_wallet_ffi_FFIPublicKey_jniDestroy(
         JNIEnv *jEnv,
         jobject jThis) {
     jlong lPublicKey = GetPointerField(jEnv, jThis);
-    public_key_destroy(reinterpret_cast<TariPublicKey *>(lPublicKey));
+    auto *pPublicKey = reinterpret_cast<TariPublicKey *>(lPublicKey);
+    // keys built from an emoji ID may be shared through the cache
+    if (!g_emojiIdCache.release(pPublicKey)) {
+        public_key_destroy(pPublicKey);
+    }
     SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(nullptr));
 }
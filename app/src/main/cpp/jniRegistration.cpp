@@ -0,0 +1,680 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Generated by scripts/generate_jni_registration.py, do not edit.
+
+#include <jni.h>
+#include "jniCommon.cpp"
+
+#if TARI_JNI_STATIC_REGISTRATION
+
+extern "C" void Java_com_tari_android_wallet_ffi_FFIByteVector_jniCreate(JNIEnv *jEnv, jobject jThis, jbyteArray array, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIByteVector_jniCreateFromBuffer(JNIEnv *jEnv, jobject jThis, jobject jBuffer, jint offset, jint length, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIByteVector_jniDestroy(JNIEnv *jEnv, jobject jThis);
+extern "C" jint Java_com_tari_android_wallet_ffi_FFIByteVector_jniGetAt(JNIEnv *jEnv, jobject jThis, jint index, jobject error);
+extern "C" jint Java_com_tari_android_wallet_ffi_FFIByteVector_jniGetBytes(JNIEnv *jEnv, jobject jThis, jbyteArray array, jobject error);
+extern "C" jint Java_com_tari_android_wallet_ffi_FFIByteVector_jniGetLength(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFICommsConfig_jniCreate(JNIEnv *jEnv, jobject jThis, jstring jPublicAddress, jobject jTransport, jstring jDatabaseName, jstring jDatastorePath, jlong jDiscoveryTimeoutSec, jlong jSafDurationSec, jstring jNetworkName, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFICommsConfig_jniDestroy(JNIEnv *jEnv, jobject jThis);
+extern "C" void Java_com_tari_android_wallet_ffi_FFICompletedTx_jniDestroy(JNIEnv *jEnv, jobject jThis);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetAmount(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetConfirmationCount(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetDestinationPublicKey(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetFee(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetId(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jstring Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetMessage(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetSourcePublicKey(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jint Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetStatus(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetTimestamp(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetTransactionKernel(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jboolean Java_com_tari_android_wallet_ffi_FFICompletedTx_jniIsOutbound(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFICompletedTxKernel_jniDestroy(JNIEnv *jEnv, jobject jThis);
+extern "C" void Java_com_tari_android_wallet_ffi_FFICompletedTxKernel_jniGetBytes(JNIEnv *jEnv, jobject jThis, jbyteArray array, jobject error);
+extern "C" jstring Java_com_tari_android_wallet_ffi_FFICompletedTxKernel_jniGetExcess(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jstring Java_com_tari_android_wallet_ffi_FFICompletedTxKernel_jniGetExcessPublicNonce(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jstring Java_com_tari_android_wallet_ffi_FFICompletedTxKernel_jniGetExcessSignature(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFICompletedTxs_jniDestroy(JNIEnv *jEnv, jobject jThis);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFICompletedTxs_jniGetAt(JNIEnv *jEnv, jobject jThis, jint index, jobject error);
+extern "C" jint Java_com_tari_android_wallet_ffi_FFICompletedTxs_jniGetLength(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jint Java_com_tari_android_wallet_ffi_FFICompletedTxs_jniWriteSnapshot(JNIEnv *jEnv, jobject jThis, jobject jBuffer, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIContact_jniCreate(JNIEnv *jEnv, jobject jThis, jstring jAlias, jobject jPublicKey, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIContact_jniDestroy(JNIEnv *jEnv, jobject jThis);
+extern "C" jstring Java_com_tari_android_wallet_ffi_FFIContact_jniGetAlias(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIContact_jniGetPublicKey(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIContacts_jniDestroy(JNIEnv *jEnv, jobject jThis);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIContacts_jniGetAt(JNIEnv *jEnv, jobject jThis, jint index, jobject error);
+extern "C" jint Java_com_tari_android_wallet_ffi_FFIContacts_jniGetLength(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIEmojiSet_jniCreate(JNIEnv *jEnv, jobject jThis);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIEmojiSet_jniDestroy(JNIEnv *jEnv, jobject jThis);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIEmojiSet_jniGetAt(JNIEnv *jEnv, jobject jThis, jint index, jobject error);
+extern "C" jint Java_com_tari_android_wallet_ffi_FFIEmojiSet_jniGetLength(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIHandleArena_jniActivate(JNIEnv *jEnv, jobject jThis);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIHandleArena_jniAdopt(JNIEnv *jEnv, jobject jThis, jobject jTarget);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIHandleArena_jniCreate(JNIEnv *jEnv, jobject jThis);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIHandleArena_jniDestroy(JNIEnv *jEnv, jobject jThis);
+extern "C" jint Java_com_tari_android_wallet_ffi_FFIHandleArena_jniGetSize(JNIEnv *jEnv, jobject jThis);
+extern "C" jint Java_com_tari_android_wallet_ffi_FFIHandleArena_jniRelease(JNIEnv *jEnv, jobject jThis);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniDestroy(JNIEnv *jEnv, jobject jThis);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniGetAmount(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniGetId(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jstring Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniGetMessage(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniGetSourcePublicKey(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jint Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniGetStatus(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniGetTimestamp(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIPendingInboundTxs_jniDestroy(JNIEnv *jEnv, jobject jThis);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIPendingInboundTxs_jniGetAt(JNIEnv *jEnv, jobject jThis, jint index, jobject error);
+extern "C" jint Java_com_tari_android_wallet_ffi_FFIPendingInboundTxs_jniGetLength(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jint Java_com_tari_android_wallet_ffi_FFIPendingInboundTxs_jniWriteSnapshot(JNIEnv *jEnv, jobject jThis, jobject jBuffer, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniDestroy(JNIEnv *jEnv, jobject jThis);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetAmount(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetDestinationPublicKey(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetFee(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetId(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jstring Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetMessage(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jint Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetStatus(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetTimestamp(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIPendingOutboundTxs_jniDestroy(JNIEnv *jEnv, jobject jThis);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIPendingOutboundTxs_jniGetAt(JNIEnv *jEnv, jobject jThis, jint index, jobject error);
+extern "C" jint Java_com_tari_android_wallet_ffi_FFIPendingOutboundTxs_jniGetLength(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jint Java_com_tari_android_wallet_ffi_FFIPendingOutboundTxs_jniWriteSnapshot(JNIEnv *jEnv, jobject jThis, jobject jBuffer, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIPrivateKey_jniCreate(JNIEnv *jEnv, jobject jThis, jobject jByteVector, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIPrivateKey_jniDestroy(JNIEnv *jEnv, jobject jThis);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIPrivateKey_jniFromHex(JNIEnv *jEnv, jobject jThis, jstring jHexStr, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIPrivateKey_jniGenerate(JNIEnv *jEnv, jobject jThis);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIPrivateKey_jniGetBytes(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jstring Java_com_tari_android_wallet_ffi_FFIPrivateKey_jniGetHex(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIPublicKey_jniCreate(JNIEnv *jEnv, jobject jThis, jobject jByteVector, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIPublicKey_jniDestroy(JNIEnv *jEnv, jobject jThis);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIPublicKey_jniFromEmojiId(JNIEnv *jEnv, jobject jThis, jstring jpEmoji, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIPublicKey_jniFromHex(JNIEnv *jEnv, jobject jThis, jstring jHexStr, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIPublicKey_jniFromPrivateKey(JNIEnv *jEnv, jobject jThis, jobject jPrivateKey, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIPublicKey_jniGetBytes(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jstring Java_com_tari_android_wallet_ffi_FFIPublicKey_jniGetEmojiId(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlongArray Java_com_tari_android_wallet_ffi_FFIPublicKey_jniGetEmojiIdCacheStats(JNIEnv *jEnv, jobject jThis);
+extern "C" jstring Java_com_tari_android_wallet_ffi_FFIPublicKey_jniGetHex(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIPublicKey_jniValidateEmojiId(JNIEnv *jEnv, jobject jThis, jstring jEmojiId);
+extern "C" void Java_com_tari_android_wallet_ffi_FFISeedWords_jniCreate(JNIEnv *jEnv, jobject jThis);
+extern "C" void Java_com_tari_android_wallet_ffi_FFISeedWords_jniDestroy(JNIEnv *jEnv, jobject jThis);
+extern "C" jstring Java_com_tari_android_wallet_ffi_FFISeedWords_jniGetAt(JNIEnv *jEnv, jobject jThis, jint index, jobject error);
+extern "C" jint Java_com_tari_android_wallet_ffi_FFISeedWords_jniGetLength(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jint Java_com_tari_android_wallet_ffi_FFISeedWords_jniPushWord(JNIEnv *jEnv, jobject jThis, jstring jWord, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFITransportType_jniDestroy(JNIEnv *jEnv, jobject jThis);
+extern "C" jstring Java_com_tari_android_wallet_ffi_FFITransportType_jniGetMemoryAddress(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFITransportType_jniMemoryTransport(JNIEnv *jEnv, jobject jThis);
+extern "C" void Java_com_tari_android_wallet_ffi_FFITransportType_jniTCPTransport(JNIEnv *jEnv, jobject jThis, jstring jpAddress, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFITransportType_jniTorTransport(JNIEnv *jEnv, jobject jThis, jstring jpControl, jobject jpTorCookie, jint jPort, jstring jpSocksUser, jstring jpSocksPass, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFITxTable_jniCopyIntColumn(JNIEnv *jEnv, jobject jThis, jint column, jintArray jOut, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFITxTable_jniCopyLongColumn(JNIEnv *jEnv, jobject jThis, jint column, jlongArray jOut, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFITxTable_jniDestroy(JNIEnv *jEnv, jobject jThis);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFITxTable_jniGetGeneration(JNIEnv *jEnv, jobject jThis);
+extern "C" jint Java_com_tari_android_wallet_ffi_FFITxTable_jniGetRowCount(JNIEnv *jEnv, jobject jThis);
+extern "C" jobjectArray Java_com_tari_android_wallet_ffi_FFITxTable_jniGetStrings(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jint Java_com_tari_android_wallet_ffi_FFITxTable_jniGetTotalRowCount(JNIEnv *jEnv, jobject jThis);
+extern "C" jboolean Java_com_tari_android_wallet_ffi_FFITxTable_jniIsComplete(JNIEnv *jEnv, jobject jThis);
+extern "C" jstring Java_com_tari_android_wallet_ffi_FFIUtil_jniDecodeUtf8(JNIEnv *jEnv, jobject jThis, jbyteArray jUtf8);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIUtil_jniDoPartialBackup(JNIEnv *jEnv, jobject jThis, jstring jBackupFileSourcePath, jstring jBackupFileTargetPath, jobject error);
+extern "C" jstring Java_com_tari_android_wallet_ffi_FFIUtil_jniDumpCallStats(JNIEnv *jEnv, jobject jThis);
+extern "C" jstring Java_com_tari_android_wallet_ffi_FFIUtil_jniDumpHandleStats(JNIEnv *jEnv, jobject jThis);
+extern "C" jobjectArray Java_com_tari_android_wallet_ffi_FFIUtil_jniGetEmojiAlphabet(JNIEnv *jEnv, jobject jThis);
+extern "C" jlongArray Java_com_tari_android_wallet_ffi_FFIUtil_jniGetHandleStats(JNIEnv *jEnv, jobject jThis);
+extern "C" jlongArray Java_com_tari_android_wallet_ffi_FFIUtil_jniGetLoadStats(JNIEnv *jEnv, jobject jThis);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIUtil_jniMeasurePointerAccess(JNIEnv *jEnv, jobject jThis, jobject jTarget, jint iterations, jboolean cached);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIUtil_jniMeasureStringCreation(JNIEnv *jEnv, jobject jThis, jbyteArray jUtf8, jint iterations, jboolean transcoded);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIUtil_jniSetHandleSiteRecording(JNIEnv *jEnv, jobject jThis, jboolean enabled);
+extern "C" jboolean Java_com_tari_android_wallet_ffi_FFIUtil_jniSetTimelineRecording(JNIEnv *jEnv, jobject jThis, jboolean enabled);
+extern "C" jboolean Java_com_tari_android_wallet_ffi_FFIUtil_jniStartFfiTrace(JNIEnv *jEnv, jobject jThis, jstring jPath, jboolean captureStrings);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIUtil_jniStopFfiTrace(JNIEnv *jEnv, jobject jThis);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIUtil_jniWriteTimeline(JNIEnv *jEnv, jobject jThis, jstring jPath);
+extern "C" jboolean Java_com_tari_android_wallet_ffi_FFIWallet_jniAddBaseNodePeer(JNIEnv *jEnv, jobject jThis, jobject jPublicKey, jstring jAddress, jobject error);
+extern "C" jboolean Java_com_tari_android_wallet_ffi_FFIWallet_jniAddUpdateContact(JNIEnv *jEnv, jobject jThis, jobject jpContact, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIWallet_jniApplyEncryption(JNIEnv *jEnv, jobject jThis, jstring jPassphrase, jobject error);
+extern "C" jboolean Java_com_tari_android_wallet_ffi_FFIWallet_jniCancelPendingTx(JNIEnv *jEnv, jobject jThis, jstring jTxId, jobject error);
+extern "C" jboolean Java_com_tari_android_wallet_ffi_FFIWallet_jniCancelPendingTxU64(JNIEnv *jEnv, jobject jThis, jlong jTxId, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniCoinSplit(JNIEnv *jEnv, jobject jThis, jstring jamount, jstring jsplitCount, jstring jfee, jstring jmessage, jstring jlockHeight, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniCoinSplitU64(JNIEnv *jEnv, jobject jThis, jlong jamount, jlong jsplitCount, jlong jfee, jstring jmessage, jlong jlockHeight, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIWallet_jniCreate(JNIEnv *jEnv, jobject jThis, jobject jpWalletConfig, jstring jLogPath, jint maxNumberOfRollingLogFiles, jint rollingLogFileMaxSizeBytes, jstring jPassphrase, jobject jSeed_words, jstring eventsCallbackMethodName, jstring eventsCallbackMethodSignature, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIWallet_jniDestroy(JNIEnv *jEnv, jobject jThis);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniEstimateTxFee(JNIEnv *jEnv, jobject jThis, jstring jamount, jstring jgramFee, jstring jkernelCount, jstring joutputCount, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniEstimateTxFeeU64(JNIEnv *jEnv, jobject jThis, jlong jamount, jlong jgramFee, jlong jkernelCount, jlong joutputCount, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniGetAvailableBalance(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlongArray Java_com_tari_android_wallet_ffi_FFIWallet_jniGetCallbackStats(JNIEnv *jEnv, jobject jThis);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniGetCancelledTxById(JNIEnv *jEnv, jobject jThis, jstring jTxId, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniGetCancelledTxByIdU64(JNIEnv *jEnv, jobject jThis, jlong jTxId, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniGetCancelledTxs(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniGetCompletedTxById(JNIEnv *jEnv, jobject jThis, jstring jTxId, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniGetCompletedTxByIdU64(JNIEnv *jEnv, jobject jThis, jlong jTxId, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniGetCompletedTxs(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniGetConfirmations(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniGetContacts(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlongArray Java_com_tari_android_wallet_ffi_FFIWallet_jniGetEventQueueStats(JNIEnv *jEnv, jobject jThis);
+extern "C" jstring Java_com_tari_android_wallet_ffi_FFIWallet_jniGetKeyValue(JNIEnv *jEnv, jobject jThis, jstring jKey, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingInboundTxById(JNIEnv *jEnv, jobject jThis, jstring jTxId, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingInboundTxByIdU64(JNIEnv *jEnv, jobject jThis, jlong jTxId, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingInboundTxs(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingIncomingBalance(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingOutboundTxById(JNIEnv *jEnv, jobject jThis, jstring jTxId, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingOutboundTxByIdU64(JNIEnv *jEnv, jobject jThis, jlong jTxId, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingOutboundTxs(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingOutgoingBalance(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPublicKey(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniGetSeedWords(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniGetTxChangesSince(JNIEnv *jEnv, jobject jThis, jlong jGeneration, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniGetTxPage(JNIEnv *jEnv, jobject jThis, jint jSortKey, jboolean jDescending, jint jKindMask, jint jOffset, jint jLimit, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniGetTxTable(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniImportUTXO(JNIEnv *jEnv, jobject jThis, jobject jpSpendingKey, jobject jpSourcePublicKey, jstring jAmount, jstring jMessage, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniImportUTXOU64(JNIEnv *jEnv, jobject jThis, jobject jpSpendingKey, jobject jpSourcePublicKey, jlong jAmount, jstring jMessage, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIWallet_jniLogMessage(JNIEnv *jEnv, jobject jThis, jstring jMessage);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIWallet_jniPowerModeLow(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIWallet_jniPowerModeNormal(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jboolean Java_com_tari_android_wallet_ffi_FFIWallet_jniRemoveContact(JNIEnv *jEnv, jobject jThis, jobject jpContact, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIWallet_jniRemoveEncryption(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jboolean Java_com_tari_android_wallet_ffi_FFIWallet_jniRemoveKeyValue(JNIEnv *jEnv, jobject jThis, jstring jKey, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniRestartTxBroadcast(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlongArray Java_com_tari_android_wallet_ffi_FFIWallet_jniSearchTxs(JNIEnv *jEnv, jobject jThis, jstring jQuery, jint jLimit, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniSendTx(JNIEnv *jEnv, jobject jThis, jobject jdestination, jstring jamount, jstring jfeePerGram, jstring jmessage, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniSendTxU64(JNIEnv *jEnv, jobject jThis, jobject jdestination, jlong jamount, jlong jfeePerGram, jstring jmessage, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIWallet_jniSetConfirmationCoalescingWindow(JNIEnv *jEnv, jobject jThis, jlong windowMillis);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIWallet_jniSetConfirmations(JNIEnv *jEnv, jobject jThis, jstring jNumber, jobject error);
+extern "C" void Java_com_tari_android_wallet_ffi_FFIWallet_jniSetConfirmationsU64(JNIEnv *jEnv, jobject jThis, jlong jNumber, jobject error);
+extern "C" jboolean Java_com_tari_android_wallet_ffi_FFIWallet_jniSetKeyValue(JNIEnv *jEnv, jobject jThis, jstring jKey, jstring jValue, jobject error);
+extern "C" jstring Java_com_tari_android_wallet_ffi_FFIWallet_jniSignMessage(JNIEnv *jEnv, jobject jThis, jstring jmessage, jobject error);
+extern "C" jboolean Java_com_tari_android_wallet_ffi_FFIWallet_jniStartRecovery(JNIEnv *jEnv, jobject jThis, jobject base_node_public_key, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniStartTXOValidation(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jlong Java_com_tari_android_wallet_ffi_FFIWallet_jniStartTxValidation(JNIEnv *jEnv, jobject jThis, jobject error);
+extern "C" jboolean Java_com_tari_android_wallet_ffi_FFIWallet_jniVerifyMessageSignature(JNIEnv *jEnv, jobject jThis, jobject jpPublicKey, jstring jmessage, jstring jhexSignatureNonce, jobject error);
+
+static const JNINativeMethod kFFIByteVectorMethods[] = {
+        {"jniCreate", "([BLcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(0, Java_com_tari_android_wallet_ffi_FFIByteVector_jniCreate)},
+        {"jniCreateFromBuffer", "(Ljava/nio/ByteBuffer;IILcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(1, Java_com_tari_android_wallet_ffi_FFIByteVector_jniCreateFromBuffer)},
+        {"jniDestroy", "()V", CALL_STATS_ENTRY(2, Java_com_tari_android_wallet_ffi_FFIByteVector_jniDestroy)},
+        {"jniGetAt", "(ILcom/tari/android/wallet/ffi/FFIError;)I", CALL_STATS_ENTRY(3, Java_com_tari_android_wallet_ffi_FFIByteVector_jniGetAt)},
+        {"jniGetBytes", "([BLcom/tari/android/wallet/ffi/FFIError;)I", CALL_STATS_ENTRY(4, Java_com_tari_android_wallet_ffi_FFIByteVector_jniGetBytes)},
+        {"jniGetLength", "(Lcom/tari/android/wallet/ffi/FFIError;)I", CALL_STATS_ENTRY(5, Java_com_tari_android_wallet_ffi_FFIByteVector_jniGetLength)},
+};
+
+static const JNINativeMethod kFFICommsConfigMethods[] = {
+        {"jniCreate", "(Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFITransportType;Ljava/lang/String;Ljava/lang/String;JJLjava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(6, Java_com_tari_android_wallet_ffi_FFICommsConfig_jniCreate)},
+        {"jniDestroy", "()V", CALL_STATS_ENTRY(7, Java_com_tari_android_wallet_ffi_FFICommsConfig_jniDestroy)},
+};
+
+static const JNINativeMethod kFFICompletedTxMethods[] = {
+        {"jniDestroy", "()V", CALL_STATS_ENTRY(8, Java_com_tari_android_wallet_ffi_FFICompletedTx_jniDestroy)},
+        {"jniGetAmount", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(9, Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetAmount)},
+        {"jniGetConfirmationCount", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(10, Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetConfirmationCount)},
+        {"jniGetDestinationPublicKey", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(11, Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetDestinationPublicKey)},
+        {"jniGetFee", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(12, Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetFee)},
+        {"jniGetId", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(13, Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetId)},
+        {"jniGetMessage", "(Lcom/tari/android/wallet/ffi/FFIError;)Ljava/lang/String;", CALL_STATS_ENTRY(14, Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetMessage)},
+        {"jniGetSourcePublicKey", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(15, Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetSourcePublicKey)},
+        {"jniGetStatus", "(Lcom/tari/android/wallet/ffi/FFIError;)I", CALL_STATS_ENTRY(16, Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetStatus)},
+        {"jniGetTimestamp", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(17, Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetTimestamp)},
+        {"jniGetTransactionKernel", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(18, Java_com_tari_android_wallet_ffi_FFICompletedTx_jniGetTransactionKernel)},
+        {"jniIsOutbound", "(Lcom/tari/android/wallet/ffi/FFIError;)Z", CALL_STATS_ENTRY(19, Java_com_tari_android_wallet_ffi_FFICompletedTx_jniIsOutbound)},
+};
+
+static const JNINativeMethod kFFICompletedTxKernelMethods[] = {
+        {"jniDestroy", "()V", CALL_STATS_ENTRY(20, Java_com_tari_android_wallet_ffi_FFICompletedTxKernel_jniDestroy)},
+        {"jniGetBytes", "([BLcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(21, Java_com_tari_android_wallet_ffi_FFICompletedTxKernel_jniGetBytes)},
+        {"jniGetExcess", "(Lcom/tari/android/wallet/ffi/FFIError;)Ljava/lang/String;", CALL_STATS_ENTRY(22, Java_com_tari_android_wallet_ffi_FFICompletedTxKernel_jniGetExcess)},
+        {"jniGetExcessPublicNonce", "(Lcom/tari/android/wallet/ffi/FFIError;)Ljava/lang/String;", CALL_STATS_ENTRY(23, Java_com_tari_android_wallet_ffi_FFICompletedTxKernel_jniGetExcessPublicNonce)},
+        {"jniGetExcessSignature", "(Lcom/tari/android/wallet/ffi/FFIError;)Ljava/lang/String;", CALL_STATS_ENTRY(24, Java_com_tari_android_wallet_ffi_FFICompletedTxKernel_jniGetExcessSignature)},
+};
+
+static const JNINativeMethod kFFICompletedTxsMethods[] = {
+        {"jniDestroy", "()V", CALL_STATS_ENTRY(25, Java_com_tari_android_wallet_ffi_FFICompletedTxs_jniDestroy)},
+        {"jniGetAt", "(ILcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(26, Java_com_tari_android_wallet_ffi_FFICompletedTxs_jniGetAt)},
+        {"jniGetLength", "(Lcom/tari/android/wallet/ffi/FFIError;)I", CALL_STATS_ENTRY(27, Java_com_tari_android_wallet_ffi_FFICompletedTxs_jniGetLength)},
+        {"jniWriteSnapshot", "(Ljava/nio/ByteBuffer;Lcom/tari/android/wallet/ffi/FFIError;)I", CALL_STATS_ENTRY(28, Java_com_tari_android_wallet_ffi_FFICompletedTxs_jniWriteSnapshot)},
+};
+
+static const JNINativeMethod kFFIContactMethods[] = {
+        {"jniCreate", "(Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIPublicKey;Lcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(29, Java_com_tari_android_wallet_ffi_FFIContact_jniCreate)},
+        {"jniDestroy", "()V", CALL_STATS_ENTRY(30, Java_com_tari_android_wallet_ffi_FFIContact_jniDestroy)},
+        {"jniGetAlias", "(Lcom/tari/android/wallet/ffi/FFIError;)Ljava/lang/String;", CALL_STATS_ENTRY(31, Java_com_tari_android_wallet_ffi_FFIContact_jniGetAlias)},
+        {"jniGetPublicKey", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(32, Java_com_tari_android_wallet_ffi_FFIContact_jniGetPublicKey)},
+};
+
+static const JNINativeMethod kFFIContactsMethods[] = {
+        {"jniDestroy", "()V", CALL_STATS_ENTRY(33, Java_com_tari_android_wallet_ffi_FFIContacts_jniDestroy)},
+        {"jniGetAt", "(ILcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(34, Java_com_tari_android_wallet_ffi_FFIContacts_jniGetAt)},
+        {"jniGetLength", "(Lcom/tari/android/wallet/ffi/FFIError;)I", CALL_STATS_ENTRY(35, Java_com_tari_android_wallet_ffi_FFIContacts_jniGetLength)},
+};
+
+static const JNINativeMethod kFFIEmojiSetMethods[] = {
+        {"jniCreate", "()V", CALL_STATS_ENTRY(36, Java_com_tari_android_wallet_ffi_FFIEmojiSet_jniCreate)},
+        {"jniDestroy", "()V", CALL_STATS_ENTRY(37, Java_com_tari_android_wallet_ffi_FFIEmojiSet_jniDestroy)},
+        {"jniGetAt", "(ILcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(38, Java_com_tari_android_wallet_ffi_FFIEmojiSet_jniGetAt)},
+        {"jniGetLength", "(Lcom/tari/android/wallet/ffi/FFIError;)I", CALL_STATS_ENTRY(39, Java_com_tari_android_wallet_ffi_FFIEmojiSet_jniGetLength)},
+};
+
+static const JNINativeMethod kFFIHandleArenaMethods[] = {
+        {"jniActivate", "()V", CALL_STATS_ENTRY(40, Java_com_tari_android_wallet_ffi_FFIHandleArena_jniActivate)},
+        {"jniAdopt", "(Lcom/tari/android/wallet/ffi/FFIBase;)V", CALL_STATS_ENTRY(41, Java_com_tari_android_wallet_ffi_FFIHandleArena_jniAdopt)},
+        {"jniCreate", "()V", CALL_STATS_ENTRY(42, Java_com_tari_android_wallet_ffi_FFIHandleArena_jniCreate)},
+        {"jniDestroy", "()V", CALL_STATS_ENTRY(43, Java_com_tari_android_wallet_ffi_FFIHandleArena_jniDestroy)},
+        {"jniGetSize", "()I", CALL_STATS_ENTRY(44, Java_com_tari_android_wallet_ffi_FFIHandleArena_jniGetSize)},
+        {"jniRelease", "()I", CALL_STATS_ENTRY(45, Java_com_tari_android_wallet_ffi_FFIHandleArena_jniRelease)},
+};
+
+static const JNINativeMethod kFFIPendingInboundTxMethods[] = {
+        {"jniDestroy", "()V", CALL_STATS_ENTRY(46, Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniDestroy)},
+        {"jniGetAmount", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(47, Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniGetAmount)},
+        {"jniGetId", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(48, Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniGetId)},
+        {"jniGetMessage", "(Lcom/tari/android/wallet/ffi/FFIError;)Ljava/lang/String;", CALL_STATS_ENTRY(49, Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniGetMessage)},
+        {"jniGetSourcePublicKey", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(50, Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniGetSourcePublicKey)},
+        {"jniGetStatus", "(Lcom/tari/android/wallet/ffi/FFIError;)I", CALL_STATS_ENTRY(51, Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniGetStatus)},
+        {"jniGetTimestamp", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(52, Java_com_tari_android_wallet_ffi_FFIPendingInboundTx_jniGetTimestamp)},
+};
+
+static const JNINativeMethod kFFIPendingInboundTxsMethods[] = {
+        {"jniDestroy", "()V", CALL_STATS_ENTRY(53, Java_com_tari_android_wallet_ffi_FFIPendingInboundTxs_jniDestroy)},
+        {"jniGetAt", "(ILcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(54, Java_com_tari_android_wallet_ffi_FFIPendingInboundTxs_jniGetAt)},
+        {"jniGetLength", "(Lcom/tari/android/wallet/ffi/FFIError;)I", CALL_STATS_ENTRY(55, Java_com_tari_android_wallet_ffi_FFIPendingInboundTxs_jniGetLength)},
+        {"jniWriteSnapshot", "(Ljava/nio/ByteBuffer;Lcom/tari/android/wallet/ffi/FFIError;)I", CALL_STATS_ENTRY(56, Java_com_tari_android_wallet_ffi_FFIPendingInboundTxs_jniWriteSnapshot)},
+};
+
+static const JNINativeMethod kFFIPendingOutboundTxMethods[] = {
+        {"jniDestroy", "()V", CALL_STATS_ENTRY(57, Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniDestroy)},
+        {"jniGetAmount", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(58, Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetAmount)},
+        {"jniGetDestinationPublicKey", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(59, Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetDestinationPublicKey)},
+        {"jniGetFee", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(60, Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetFee)},
+        {"jniGetId", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(61, Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetId)},
+        {"jniGetMessage", "(Lcom/tari/android/wallet/ffi/FFIError;)Ljava/lang/String;", CALL_STATS_ENTRY(62, Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetMessage)},
+        {"jniGetStatus", "(Lcom/tari/android/wallet/ffi/FFIError;)I", CALL_STATS_ENTRY(63, Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetStatus)},
+        {"jniGetTimestamp", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(64, Java_com_tari_android_wallet_ffi_FFIPendingOutboundTx_jniGetTimestamp)},
+};
+
+static const JNINativeMethod kFFIPendingOutboundTxsMethods[] = {
+        {"jniDestroy", "()V", CALL_STATS_ENTRY(65, Java_com_tari_android_wallet_ffi_FFIPendingOutboundTxs_jniDestroy)},
+        {"jniGetAt", "(ILcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(66, Java_com_tari_android_wallet_ffi_FFIPendingOutboundTxs_jniGetAt)},
+        {"jniGetLength", "(Lcom/tari/android/wallet/ffi/FFIError;)I", CALL_STATS_ENTRY(67, Java_com_tari_android_wallet_ffi_FFIPendingOutboundTxs_jniGetLength)},
+        {"jniWriteSnapshot", "(Ljava/nio/ByteBuffer;Lcom/tari/android/wallet/ffi/FFIError;)I", CALL_STATS_ENTRY(68, Java_com_tari_android_wallet_ffi_FFIPendingOutboundTxs_jniWriteSnapshot)},
+};
+
+static const JNINativeMethod kFFIPrivateKeyMethods[] = {
+        {"jniCreate", "(Lcom/tari/android/wallet/ffi/FFIByteVector;Lcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(69, Java_com_tari_android_wallet_ffi_FFIPrivateKey_jniCreate)},
+        {"jniDestroy", "()V", CALL_STATS_ENTRY(70, Java_com_tari_android_wallet_ffi_FFIPrivateKey_jniDestroy)},
+        {"jniFromHex", "(Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(71, Java_com_tari_android_wallet_ffi_FFIPrivateKey_jniFromHex)},
+        {"jniGenerate", "()V", CALL_STATS_ENTRY(72, Java_com_tari_android_wallet_ffi_FFIPrivateKey_jniGenerate)},
+        {"jniGetBytes", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(73, Java_com_tari_android_wallet_ffi_FFIPrivateKey_jniGetBytes)},
+        {"jniGetHex", "(Lcom/tari/android/wallet/ffi/FFIError;)Ljava/lang/String;", CALL_STATS_ENTRY(74, Java_com_tari_android_wallet_ffi_FFIPrivateKey_jniGetHex)},
+};
+
+static const JNINativeMethod kFFIPublicKeyMethods[] = {
+        {"jniCreate", "(Lcom/tari/android/wallet/ffi/FFIByteVector;Lcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(75, Java_com_tari_android_wallet_ffi_FFIPublicKey_jniCreate)},
+        {"jniDestroy", "()V", CALL_STATS_ENTRY(76, Java_com_tari_android_wallet_ffi_FFIPublicKey_jniDestroy)},
+        {"jniFromEmojiId", "(Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(77, Java_com_tari_android_wallet_ffi_FFIPublicKey_jniFromEmojiId)},
+        {"jniFromHex", "(Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(78, Java_com_tari_android_wallet_ffi_FFIPublicKey_jniFromHex)},
+        {"jniFromPrivateKey", "(Lcom/tari/android/wallet/ffi/FFIPrivateKey;Lcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(79, Java_com_tari_android_wallet_ffi_FFIPublicKey_jniFromPrivateKey)},
+        {"jniGetBytes", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(80, Java_com_tari_android_wallet_ffi_FFIPublicKey_jniGetBytes)},
+        {"jniGetEmojiId", "(Lcom/tari/android/wallet/ffi/FFIError;)Ljava/lang/String;", CALL_STATS_ENTRY(81, Java_com_tari_android_wallet_ffi_FFIPublicKey_jniGetEmojiId)},
+        {"jniGetEmojiIdCacheStats", "()[J", CALL_STATS_ENTRY(82, Java_com_tari_android_wallet_ffi_FFIPublicKey_jniGetEmojiIdCacheStats)},
+        {"jniGetHex", "(Lcom/tari/android/wallet/ffi/FFIError;)Ljava/lang/String;", CALL_STATS_ENTRY(83, Java_com_tari_android_wallet_ffi_FFIPublicKey_jniGetHex)},
+        {"jniValidateEmojiId", "(Ljava/lang/String;)J", CALL_STATS_ENTRY(84, Java_com_tari_android_wallet_ffi_FFIPublicKey_jniValidateEmojiId)},
+};
+
+static const JNINativeMethod kFFISeedWordsMethods[] = {
+        {"jniCreate", "()V", CALL_STATS_ENTRY(85, Java_com_tari_android_wallet_ffi_FFISeedWords_jniCreate)},
+        {"jniDestroy", "()V", CALL_STATS_ENTRY(86, Java_com_tari_android_wallet_ffi_FFISeedWords_jniDestroy)},
+        {"jniGetAt", "(ILcom/tari/android/wallet/ffi/FFIError;)Ljava/lang/String;", CALL_STATS_ENTRY(87, Java_com_tari_android_wallet_ffi_FFISeedWords_jniGetAt)},
+        {"jniGetLength", "(Lcom/tari/android/wallet/ffi/FFIError;)I", CALL_STATS_ENTRY(88, Java_com_tari_android_wallet_ffi_FFISeedWords_jniGetLength)},
+        {"jniPushWord", "(Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)I", CALL_STATS_ENTRY(89, Java_com_tari_android_wallet_ffi_FFISeedWords_jniPushWord)},
+};
+
+static const JNINativeMethod kFFITransportTypeMethods[] = {
+        {"jniDestroy", "()V", CALL_STATS_ENTRY(90, Java_com_tari_android_wallet_ffi_FFITransportType_jniDestroy)},
+        {"jniGetMemoryAddress", "(Lcom/tari/android/wallet/ffi/FFIError;)Ljava/lang/String;", CALL_STATS_ENTRY(91, Java_com_tari_android_wallet_ffi_FFITransportType_jniGetMemoryAddress)},
+        {"jniMemoryTransport", "()V", CALL_STATS_ENTRY(92, Java_com_tari_android_wallet_ffi_FFITransportType_jniMemoryTransport)},
+        {"jniTCPTransport", "(Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(93, Java_com_tari_android_wallet_ffi_FFITransportType_jniTCPTransport)},
+        {"jniTorTransport", "(Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIByteVector;ILjava/lang/String;Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(94, Java_com_tari_android_wallet_ffi_FFITransportType_jniTorTransport)},
+};
+
+static const JNINativeMethod kFFITxTableMethods[] = {
+        {"jniCopyIntColumn", "(I[ILcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(95, Java_com_tari_android_wallet_ffi_FFITxTable_jniCopyIntColumn)},
+        {"jniCopyLongColumn", "(I[JLcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(96, Java_com_tari_android_wallet_ffi_FFITxTable_jniCopyLongColumn)},
+        {"jniDestroy", "()V", CALL_STATS_ENTRY(97, Java_com_tari_android_wallet_ffi_FFITxTable_jniDestroy)},
+        {"jniGetGeneration", "()J", CALL_STATS_ENTRY(98, Java_com_tari_android_wallet_ffi_FFITxTable_jniGetGeneration)},
+        {"jniGetRowCount", "()I", CALL_STATS_ENTRY(99, Java_com_tari_android_wallet_ffi_FFITxTable_jniGetRowCount)},
+        {"jniGetStrings", "(Lcom/tari/android/wallet/ffi/FFIError;)[Ljava/lang/String;", CALL_STATS_ENTRY(100, Java_com_tari_android_wallet_ffi_FFITxTable_jniGetStrings)},
+        {"jniGetTotalRowCount", "()I", CALL_STATS_ENTRY(101, Java_com_tari_android_wallet_ffi_FFITxTable_jniGetTotalRowCount)},
+        {"jniIsComplete", "()Z", CALL_STATS_ENTRY(102, Java_com_tari_android_wallet_ffi_FFITxTable_jniIsComplete)},
+};
+
+static const JNINativeMethod kFFIUtilMethods[] = {
+        {"jniDecodeUtf8", "([B)Ljava/lang/String;", CALL_STATS_ENTRY(103, Java_com_tari_android_wallet_ffi_FFIUtil_jniDecodeUtf8)},
+        {"jniDoPartialBackup", "(Ljava/lang/String;Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(104, Java_com_tari_android_wallet_ffi_FFIUtil_jniDoPartialBackup)},
+        {"jniDumpCallStats", "()Ljava/lang/String;", CALL_STATS_ENTRY(105, Java_com_tari_android_wallet_ffi_FFIUtil_jniDumpCallStats)},
+        {"jniDumpHandleStats", "()Ljava/lang/String;", CALL_STATS_ENTRY(106, Java_com_tari_android_wallet_ffi_FFIUtil_jniDumpHandleStats)},
+        {"jniGetEmojiAlphabet", "()[Ljava/lang/String;", CALL_STATS_ENTRY(107, Java_com_tari_android_wallet_ffi_FFIUtil_jniGetEmojiAlphabet)},
+        {"jniGetHandleStats", "()[J", CALL_STATS_ENTRY(108, Java_com_tari_android_wallet_ffi_FFIUtil_jniGetHandleStats)},
+        {"jniGetLoadStats", "()[J", CALL_STATS_ENTRY(109, Java_com_tari_android_wallet_ffi_FFIUtil_jniGetLoadStats)},
+        {"jniMeasurePointerAccess", "(Lcom/tari/android/wallet/ffi/FFIBase;IZ)J", CALL_STATS_ENTRY(110, Java_com_tari_android_wallet_ffi_FFIUtil_jniMeasurePointerAccess)},
+        {"jniMeasureStringCreation", "([BIZ)J", CALL_STATS_ENTRY(111, Java_com_tari_android_wallet_ffi_FFIUtil_jniMeasureStringCreation)},
+        {"jniSetHandleSiteRecording", "(Z)V", CALL_STATS_ENTRY(112, Java_com_tari_android_wallet_ffi_FFIUtil_jniSetHandleSiteRecording)},
+        {"jniSetTimelineRecording", "(Z)Z", CALL_STATS_ENTRY(113, Java_com_tari_android_wallet_ffi_FFIUtil_jniSetTimelineRecording)},
+        {"jniStartFfiTrace", "(Ljava/lang/String;Z)Z", CALL_STATS_ENTRY(114, Java_com_tari_android_wallet_ffi_FFIUtil_jniStartFfiTrace)},
+        {"jniStopFfiTrace", "()J", CALL_STATS_ENTRY(115, Java_com_tari_android_wallet_ffi_FFIUtil_jniStopFfiTrace)},
+        {"jniWriteTimeline", "(Ljava/lang/String;)J", CALL_STATS_ENTRY(116, Java_com_tari_android_wallet_ffi_FFIUtil_jniWriteTimeline)},
+};
+
+static const JNINativeMethod kFFIWalletMethods[] = {
+        {"jniAddBaseNodePeer", "(Lcom/tari/android/wallet/ffi/FFIPublicKey;Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)Z", CALL_STATS_ENTRY(117, Java_com_tari_android_wallet_ffi_FFIWallet_jniAddBaseNodePeer)},
+        {"jniAddUpdateContact", "(Lcom/tari/android/wallet/ffi/FFIContact;Lcom/tari/android/wallet/ffi/FFIError;)Z", CALL_STATS_ENTRY(118, Java_com_tari_android_wallet_ffi_FFIWallet_jniAddUpdateContact)},
+        {"jniApplyEncryption", "(Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(119, Java_com_tari_android_wallet_ffi_FFIWallet_jniApplyEncryption)},
+        {"jniCancelPendingTx", "(Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)Z", CALL_STATS_ENTRY(120, Java_com_tari_android_wallet_ffi_FFIWallet_jniCancelPendingTx)},
+        {"jniCancelPendingTxU64", "(JLcom/tari/android/wallet/ffi/FFIError;)Z", CALL_STATS_ENTRY(121, Java_com_tari_android_wallet_ffi_FFIWallet_jniCancelPendingTxU64)},
+        {"jniCoinSplit", "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(122, Java_com_tari_android_wallet_ffi_FFIWallet_jniCoinSplit)},
+        {"jniCoinSplitU64", "(JJJLjava/lang/String;JLcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(123, Java_com_tari_android_wallet_ffi_FFIWallet_jniCoinSplitU64)},
+        {"jniCreate", "(Lcom/tari/android/wallet/ffi/FFICommsConfig;Ljava/lang/String;IILjava/lang/String;Lcom/tari/android/wallet/ffi/FFISeedWords;Ljava/lang/String;Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(124, Java_com_tari_android_wallet_ffi_FFIWallet_jniCreate)},
+        {"jniDestroy", "()V", CALL_STATS_ENTRY(125, Java_com_tari_android_wallet_ffi_FFIWallet_jniDestroy)},
+        {"jniEstimateTxFee", "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(126, Java_com_tari_android_wallet_ffi_FFIWallet_jniEstimateTxFee)},
+        {"jniEstimateTxFeeU64", "(JJJJLcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(127, Java_com_tari_android_wallet_ffi_FFIWallet_jniEstimateTxFeeU64)},
+        {"jniGetAvailableBalance", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(128, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetAvailableBalance)},
+        {"jniGetCallbackStats", "()[J", CALL_STATS_ENTRY(129, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetCallbackStats)},
+        {"jniGetCancelledTxById", "(Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(130, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetCancelledTxById)},
+        {"jniGetCancelledTxByIdU64", "(JLcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(131, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetCancelledTxByIdU64)},
+        {"jniGetCancelledTxs", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(132, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetCancelledTxs)},
+        {"jniGetCompletedTxById", "(Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(133, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetCompletedTxById)},
+        {"jniGetCompletedTxByIdU64", "(JLcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(134, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetCompletedTxByIdU64)},
+        {"jniGetCompletedTxs", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(135, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetCompletedTxs)},
+        {"jniGetConfirmations", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(136, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetConfirmations)},
+        {"jniGetContacts", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(137, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetContacts)},
+        {"jniGetEventQueueStats", "()[J", CALL_STATS_ENTRY(138, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetEventQueueStats)},
+        {"jniGetKeyValue", "(Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)Ljava/lang/String;", CALL_STATS_ENTRY(139, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetKeyValue)},
+        {"jniGetPendingInboundTxById", "(Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(140, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingInboundTxById)},
+        {"jniGetPendingInboundTxByIdU64", "(JLcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(141, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingInboundTxByIdU64)},
+        {"jniGetPendingInboundTxs", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(142, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingInboundTxs)},
+        {"jniGetPendingIncomingBalance", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(143, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingIncomingBalance)},
+        {"jniGetPendingOutboundTxById", "(Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(144, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingOutboundTxById)},
+        {"jniGetPendingOutboundTxByIdU64", "(JLcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(145, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingOutboundTxByIdU64)},
+        {"jniGetPendingOutboundTxs", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(146, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingOutboundTxs)},
+        {"jniGetPendingOutgoingBalance", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(147, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingOutgoingBalance)},
+        {"jniGetPublicKey", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(148, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPublicKey)},
+        {"jniGetSeedWords", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(149, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetSeedWords)},
+        {"jniGetTxChangesSince", "(JLcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(150, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetTxChangesSince)},
+        {"jniGetTxPage", "(IZIIILcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(151, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetTxPage)},
+        {"jniGetTxTable", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(152, Java_com_tari_android_wallet_ffi_FFIWallet_jniGetTxTable)},
+        {"jniImportUTXO", "(Lcom/tari/android/wallet/ffi/FFIPrivateKey;Lcom/tari/android/wallet/ffi/FFIPublicKey;Ljava/lang/String;Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(153, Java_com_tari_android_wallet_ffi_FFIWallet_jniImportUTXO)},
+        {"jniImportUTXOU64", "(Lcom/tari/android/wallet/ffi/FFIPrivateKey;Lcom/tari/android/wallet/ffi/FFIPublicKey;JLjava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(154, Java_com_tari_android_wallet_ffi_FFIWallet_jniImportUTXOU64)},
+        {"jniLogMessage", "(Ljava/lang/String;)V", CALL_STATS_ENTRY(155, Java_com_tari_android_wallet_ffi_FFIWallet_jniLogMessage)},
+        {"jniPowerModeLow", "(Lcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(156, Java_com_tari_android_wallet_ffi_FFIWallet_jniPowerModeLow)},
+        {"jniPowerModeNormal", "(Lcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(157, Java_com_tari_android_wallet_ffi_FFIWallet_jniPowerModeNormal)},
+        {"jniRemoveContact", "(Lcom/tari/android/wallet/ffi/FFIContact;Lcom/tari/android/wallet/ffi/FFIError;)Z", CALL_STATS_ENTRY(158, Java_com_tari_android_wallet_ffi_FFIWallet_jniRemoveContact)},
+        {"jniRemoveEncryption", "(Lcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(159, Java_com_tari_android_wallet_ffi_FFIWallet_jniRemoveEncryption)},
+        {"jniRemoveKeyValue", "(Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)Z", CALL_STATS_ENTRY(160, Java_com_tari_android_wallet_ffi_FFIWallet_jniRemoveKeyValue)},
+        {"jniRestartTxBroadcast", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(161, Java_com_tari_android_wallet_ffi_FFIWallet_jniRestartTxBroadcast)},
+        {"jniSearchTxs", "(Ljava/lang/String;ILcom/tari/android/wallet/ffi/FFIError;)[J", CALL_STATS_ENTRY(162, Java_com_tari_android_wallet_ffi_FFIWallet_jniSearchTxs)},
+        {"jniSendTx", "(Lcom/tari/android/wallet/ffi/FFIPublicKey;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(163, Java_com_tari_android_wallet_ffi_FFIWallet_jniSendTx)},
+        {"jniSendTxU64", "(Lcom/tari/android/wallet/ffi/FFIPublicKey;JJLjava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(164, Java_com_tari_android_wallet_ffi_FFIWallet_jniSendTxU64)},
+        {"jniSetConfirmationCoalescingWindow", "(J)V", CALL_STATS_ENTRY(165, Java_com_tari_android_wallet_ffi_FFIWallet_jniSetConfirmationCoalescingWindow)},
+        {"jniSetConfirmations", "(Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(166, Java_com_tari_android_wallet_ffi_FFIWallet_jniSetConfirmations)},
+        {"jniSetConfirmationsU64", "(JLcom/tari/android/wallet/ffi/FFIError;)V", CALL_STATS_ENTRY(167, Java_com_tari_android_wallet_ffi_FFIWallet_jniSetConfirmationsU64)},
+        {"jniSetKeyValue", "(Ljava/lang/String;Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)Z", CALL_STATS_ENTRY(168, Java_com_tari_android_wallet_ffi_FFIWallet_jniSetKeyValue)},
+        {"jniSignMessage", "(Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)Ljava/lang/String;", CALL_STATS_ENTRY(169, Java_com_tari_android_wallet_ffi_FFIWallet_jniSignMessage)},
+        {"jniStartRecovery", "(Lcom/tari/android/wallet/ffi/FFIPublicKey;Lcom/tari/android/wallet/ffi/FFIError;)Z", CALL_STATS_ENTRY(170, Java_com_tari_android_wallet_ffi_FFIWallet_jniStartRecovery)},
+        {"jniStartTXOValidation", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(171, Java_com_tari_android_wallet_ffi_FFIWallet_jniStartTXOValidation)},
+        {"jniStartTxValidation", "(Lcom/tari/android/wallet/ffi/FFIError;)J", CALL_STATS_ENTRY(172, Java_com_tari_android_wallet_ffi_FFIWallet_jniStartTxValidation)},
+        {"jniVerifyMessageSignature", "(Lcom/tari/android/wallet/ffi/FFIPublicKey;Ljava/lang/String;Ljava/lang/String;Lcom/tari/android/wallet/ffi/FFIError;)Z", CALL_STATS_ENTRY(173, Java_com_tari_android_wallet_ffi_FFIWallet_jniVerifyMessageSignature)},
+};
+
+#if TARI_JNI_CALL_STATS
+
+const char *const kJniEntryNames[] = {
+        "FFIByteVector.jniCreate",
+        "FFIByteVector.jniCreateFromBuffer",
+        "FFIByteVector.jniDestroy",
+        "FFIByteVector.jniGetAt",
+        "FFIByteVector.jniGetBytes",
+        "FFIByteVector.jniGetLength",
+        "FFICommsConfig.jniCreate",
+        "FFICommsConfig.jniDestroy",
+        "FFICompletedTx.jniDestroy",
+        "FFICompletedTx.jniGetAmount",
+        "FFICompletedTx.jniGetConfirmationCount",
+        "FFICompletedTx.jniGetDestinationPublicKey",
+        "FFICompletedTx.jniGetFee",
+        "FFICompletedTx.jniGetId",
+        "FFICompletedTx.jniGetMessage",
+        "FFICompletedTx.jniGetSourcePublicKey",
+        "FFICompletedTx.jniGetStatus",
+        "FFICompletedTx.jniGetTimestamp",
+        "FFICompletedTx.jniGetTransactionKernel",
+        "FFICompletedTx.jniIsOutbound",
+        "FFICompletedTxKernel.jniDestroy",
+        "FFICompletedTxKernel.jniGetBytes",
+        "FFICompletedTxKernel.jniGetExcess",
+        "FFICompletedTxKernel.jniGetExcessPublicNonce",
+        "FFICompletedTxKernel.jniGetExcessSignature",
+        "FFICompletedTxs.jniDestroy",
+        "FFICompletedTxs.jniGetAt",
+        "FFICompletedTxs.jniGetLength",
+        "FFICompletedTxs.jniWriteSnapshot",
+        "FFIContact.jniCreate",
+        "FFIContact.jniDestroy",
+        "FFIContact.jniGetAlias",
+        "FFIContact.jniGetPublicKey",
+        "FFIContacts.jniDestroy",
+        "FFIContacts.jniGetAt",
+        "FFIContacts.jniGetLength",
+        "FFIEmojiSet.jniCreate",
+        "FFIEmojiSet.jniDestroy",
+        "FFIEmojiSet.jniGetAt",
+        "FFIEmojiSet.jniGetLength",
+        "FFIHandleArena.jniActivate",
+        "FFIHandleArena.jniAdopt",
+        "FFIHandleArena.jniCreate",
+        "FFIHandleArena.jniDestroy",
+        "FFIHandleArena.jniGetSize",
+        "FFIHandleArena.jniRelease",
+        "FFIPendingInboundTx.jniDestroy",
+        "FFIPendingInboundTx.jniGetAmount",
+        "FFIPendingInboundTx.jniGetId",
+        "FFIPendingInboundTx.jniGetMessage",
+        "FFIPendingInboundTx.jniGetSourcePublicKey",
+        "FFIPendingInboundTx.jniGetStatus",
+        "FFIPendingInboundTx.jniGetTimestamp",
+        "FFIPendingInboundTxs.jniDestroy",
+        "FFIPendingInboundTxs.jniGetAt",
+        "FFIPendingInboundTxs.jniGetLength",
+        "FFIPendingInboundTxs.jniWriteSnapshot",
+        "FFIPendingOutboundTx.jniDestroy",
+        "FFIPendingOutboundTx.jniGetAmount",
+        "FFIPendingOutboundTx.jniGetDestinationPublicKey",
+        "FFIPendingOutboundTx.jniGetFee",
+        "FFIPendingOutboundTx.jniGetId",
+        "FFIPendingOutboundTx.jniGetMessage",
+        "FFIPendingOutboundTx.jniGetStatus",
+        "FFIPendingOutboundTx.jniGetTimestamp",
+        "FFIPendingOutboundTxs.jniDestroy",
+        "FFIPendingOutboundTxs.jniGetAt",
+        "FFIPendingOutboundTxs.jniGetLength",
+        "FFIPendingOutboundTxs.jniWriteSnapshot",
+        "FFIPrivateKey.jniCreate",
+        "FFIPrivateKey.jniDestroy",
+        "FFIPrivateKey.jniFromHex",
+        "FFIPrivateKey.jniGenerate",
+        "FFIPrivateKey.jniGetBytes",
+        "FFIPrivateKey.jniGetHex",
+        "FFIPublicKey.jniCreate",
+        "FFIPublicKey.jniDestroy",
+        "FFIPublicKey.jniFromEmojiId",
+        "FFIPublicKey.jniFromHex",
+        "FFIPublicKey.jniFromPrivateKey",
+        "FFIPublicKey.jniGetBytes",
+        "FFIPublicKey.jniGetEmojiId",
+        "FFIPublicKey.jniGetEmojiIdCacheStats",
+        "FFIPublicKey.jniGetHex",
+        "FFIPublicKey.jniValidateEmojiId",
+        "FFISeedWords.jniCreate",
+        "FFISeedWords.jniDestroy",
+        "FFISeedWords.jniGetAt",
+        "FFISeedWords.jniGetLength",
+        "FFISeedWords.jniPushWord",
+        "FFITransportType.jniDestroy",
+        "FFITransportType.jniGetMemoryAddress",
+        "FFITransportType.jniMemoryTransport",
+        "FFITransportType.jniTCPTransport",
+        "FFITransportType.jniTorTransport",
+        "FFITxTable.jniCopyIntColumn",
+        "FFITxTable.jniCopyLongColumn",
+        "FFITxTable.jniDestroy",
+        "FFITxTable.jniGetGeneration",
+        "FFITxTable.jniGetRowCount",
+        "FFITxTable.jniGetStrings",
+        "FFITxTable.jniGetTotalRowCount",
+        "FFITxTable.jniIsComplete",
+        "FFIUtil.jniDecodeUtf8",
+        "FFIUtil.jniDoPartialBackup",
+        "FFIUtil.jniDumpCallStats",
+        "FFIUtil.jniDumpHandleStats",
+        "FFIUtil.jniGetEmojiAlphabet",
+        "FFIUtil.jniGetHandleStats",
+        "FFIUtil.jniGetLoadStats",
+        "FFIUtil.jniMeasurePointerAccess",
+        "FFIUtil.jniMeasureStringCreation",
+        "FFIUtil.jniSetHandleSiteRecording",
+        "FFIUtil.jniSetTimelineRecording",
+        "FFIUtil.jniStartFfiTrace",
+        "FFIUtil.jniStopFfiTrace",
+        "FFIUtil.jniWriteTimeline",
+        "FFIWallet.jniAddBaseNodePeer",
+        "FFIWallet.jniAddUpdateContact",
+        "FFIWallet.jniApplyEncryption",
+        "FFIWallet.jniCancelPendingTx",
+        "FFIWallet.jniCancelPendingTxU64",
+        "FFIWallet.jniCoinSplit",
+        "FFIWallet.jniCoinSplitU64",
+        "FFIWallet.jniCreate",
+        "FFIWallet.jniDestroy",
+        "FFIWallet.jniEstimateTxFee",
+        "FFIWallet.jniEstimateTxFeeU64",
+        "FFIWallet.jniGetAvailableBalance",
+        "FFIWallet.jniGetCallbackStats",
+        "FFIWallet.jniGetCancelledTxById",
+        "FFIWallet.jniGetCancelledTxByIdU64",
+        "FFIWallet.jniGetCancelledTxs",
+        "FFIWallet.jniGetCompletedTxById",
+        "FFIWallet.jniGetCompletedTxByIdU64",
+        "FFIWallet.jniGetCompletedTxs",
+        "FFIWallet.jniGetConfirmations",
+        "FFIWallet.jniGetContacts",
+        "FFIWallet.jniGetEventQueueStats",
+        "FFIWallet.jniGetKeyValue",
+        "FFIWallet.jniGetPendingInboundTxById",
+        "FFIWallet.jniGetPendingInboundTxByIdU64",
+        "FFIWallet.jniGetPendingInboundTxs",
+        "FFIWallet.jniGetPendingIncomingBalance",
+        "FFIWallet.jniGetPendingOutboundTxById",
+        "FFIWallet.jniGetPendingOutboundTxByIdU64",
+        "FFIWallet.jniGetPendingOutboundTxs",
+        "FFIWallet.jniGetPendingOutgoingBalance",
+        "FFIWallet.jniGetPublicKey",
+        "FFIWallet.jniGetSeedWords",
+        "FFIWallet.jniGetTxChangesSince",
+        "FFIWallet.jniGetTxPage",
+        "FFIWallet.jniGetTxTable",
+        "FFIWallet.jniImportUTXO",
+        "FFIWallet.jniImportUTXOU64",
+        "FFIWallet.jniLogMessage",
+        "FFIWallet.jniPowerModeLow",
+        "FFIWallet.jniPowerModeNormal",
+        "FFIWallet.jniRemoveContact",
+        "FFIWallet.jniRemoveEncryption",
+        "FFIWallet.jniRemoveKeyValue",
+        "FFIWallet.jniRestartTxBroadcast",
+        "FFIWallet.jniSearchTxs",
+        "FFIWallet.jniSendTx",
+        "FFIWallet.jniSendTxU64",
+        "FFIWallet.jniSetConfirmationCoalescingWindow",
+        "FFIWallet.jniSetConfirmations",
+        "FFIWallet.jniSetConfirmationsU64",
+        "FFIWallet.jniSetKeyValue",
+        "FFIWallet.jniSignMessage",
+        "FFIWallet.jniStartRecovery",
+        "FFIWallet.jniStartTXOValidation",
+        "FFIWallet.jniStartTxValidation",
+        "FFIWallet.jniVerifyMessageSignature",
+};
+
+const int kJniEntryCount = sizeof(kJniEntryNames) / sizeof(kJniEntryNames[0]);
+
+static_assert(sizeof(kJniEntryNames) / sizeof(kJniEntryNames[0]) <= kCallStatsEntryCapacity,
+              "Raise kCallStatsEntryCapacity in jniCallStats.cpp");
+
+#endif
+
+/**
+ * Binds every native method of the FFI classes. Called from JNI_OnLoad once the ID
+ * registry holds the class references. Returns the number of registered methods, or
+ * -1 (with a pending Java exception) on failure.
+ */
+jint registerNativeMethods(JNIEnv *jEnv) {
+    struct {
+        FFIClass ffiClass;
+        const JNINativeMethod *methods;
+        jint count;
+    } const tables[] = {
+            {kFFIByteVector, kFFIByteVectorMethods, sizeof(kFFIByteVectorMethods) / sizeof(JNINativeMethod)},
+            {kFFICommsConfig, kFFICommsConfigMethods, sizeof(kFFICommsConfigMethods) / sizeof(JNINativeMethod)},
+            {kFFICompletedTx, kFFICompletedTxMethods, sizeof(kFFICompletedTxMethods) / sizeof(JNINativeMethod)},
+            {kFFICompletedTxKernel, kFFICompletedTxKernelMethods, sizeof(kFFICompletedTxKernelMethods) / sizeof(JNINativeMethod)},
+            {kFFICompletedTxs, kFFICompletedTxsMethods, sizeof(kFFICompletedTxsMethods) / sizeof(JNINativeMethod)},
+            {kFFIContact, kFFIContactMethods, sizeof(kFFIContactMethods) / sizeof(JNINativeMethod)},
+            {kFFIContacts, kFFIContactsMethods, sizeof(kFFIContactsMethods) / sizeof(JNINativeMethod)},
+            {kFFIEmojiSet, kFFIEmojiSetMethods, sizeof(kFFIEmojiSetMethods) / sizeof(JNINativeMethod)},
+            {kFFIHandleArena, kFFIHandleArenaMethods, sizeof(kFFIHandleArenaMethods) / sizeof(JNINativeMethod)},
+            {kFFIPendingInboundTx, kFFIPendingInboundTxMethods, sizeof(kFFIPendingInboundTxMethods) / sizeof(JNINativeMethod)},
+            {kFFIPendingInboundTxs, kFFIPendingInboundTxsMethods, sizeof(kFFIPendingInboundTxsMethods) / sizeof(JNINativeMethod)},
+            {kFFIPendingOutboundTx, kFFIPendingOutboundTxMethods, sizeof(kFFIPendingOutboundTxMethods) / sizeof(JNINativeMethod)},
+            {kFFIPendingOutboundTxs, kFFIPendingOutboundTxsMethods, sizeof(kFFIPendingOutboundTxsMethods) / sizeof(JNINativeMethod)},
+            {kFFIPrivateKey, kFFIPrivateKeyMethods, sizeof(kFFIPrivateKeyMethods) / sizeof(JNINativeMethod)},
+            {kFFIPublicKey, kFFIPublicKeyMethods, sizeof(kFFIPublicKeyMethods) / sizeof(JNINativeMethod)},
+            {kFFISeedWords, kFFISeedWordsMethods, sizeof(kFFISeedWordsMethods) / sizeof(JNINativeMethod)},
+            {kFFITransportType, kFFITransportTypeMethods, sizeof(kFFITransportTypeMethods) / sizeof(JNINativeMethod)},
+            {kFFITxTable, kFFITxTableMethods, sizeof(kFFITxTableMethods) / sizeof(JNINativeMethod)},
+            {kFFIUtil, kFFIUtilMethods, sizeof(kFFIUtilMethods) / sizeof(JNINativeMethod)},
+            {kFFIWallet, kFFIWalletMethods, sizeof(kFFIWalletMethods) / sizeof(JNINativeMethod)},
+    };
+    jint registered = 0;
+    for (const auto &table : tables) {
+        if (jEnv->RegisterNatives(g_ids.classes[table.ffiClass], table.methods,
+                                  table.count) != JNI_OK) {
+            LOGE("RegisterNatives failed for %s.", kFFIClassNames[table.ffiClass]);
+            return -1;
+        }
+        registered += table.count;
+    }
+    return registered;
+}
+
+#endif
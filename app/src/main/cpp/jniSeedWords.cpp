@@ -38,6 +38,7 @@
 #include <cmath>
 #include <android/log.h>
 #include "jniCommon.cpp"
+#include "jniUtf8.cpp"
 
 extern "C"
 JNIEXPORT void JNICALL
@@ -94,7 +95,7 @@ Java_com_tari_android_wallet_ffi_FFISeedWords_jniGetAt(
     auto *pSeedWords = reinterpret_cast<TariSeedWords *>(lSeedWords);
     const char *pWord = seed_words_get_at(pSeedWords, static_cast<unsigned int>(index), r);
     setErrorCode(jEnv, error, i);
-    jstring result = jEnv->NewStringUTF(pWord);
+    jstring result = newStringFromUtf8(jEnv, pWord);
     string_destroy(const_cast<char *>(pWord));
     return result;
 }
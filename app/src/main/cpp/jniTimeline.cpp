@@ -0,0 +1,351 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef JNI_TIMELINE_CPP
+#define JNI_TIMELINE_CPP
+
+#include <android/trace.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * Timeline of the wallet_* calls, the wallet callbacks and the deliveries of their events to
+ * FFIWallet.onEvents, written out as a Chrome trace for chrome://tracing or ui.perfetto.dev.
+ *
+ * Built with TARI_JNI_TIMELINE, the wallet_* functions are timed through the interposition of
+ * jniFfiTrace.cpp, every wallet callback in jniWallet.cpp opens with a TIMELINE_SCOPE, and the
+ * event dispatcher times its CallVoidMethod, which blocks for as long as the Kotlin listeners
+ * take. Each span also becomes an ATrace section while systrace or Perfetto is capturing.
+ *
+ * Recording is switched on at run time by FFIUtil.setTimelineRecording. Every thread then writes
+ * complete events (begin time and duration) into a ring of its own, overwriting the oldest, so
+ * the newest kTimelineRingCapacity spans per thread survive. FFIUtil.writeTimeline flushes all
+ * rings into one file. A ring outlives its thread and is taken over by the next new thread.
+ */
+
+static const uint64_t kTimelineRingCapacity = 2048;
+
+enum TimelineCategory {
+    kTimelineFfiCall = 0,
+    kTimelineCallback,
+    kTimelineDelivery,
+    kTimelineCategoryCount
+};
+
+static const char *const kTimelineCategoryNames[kTimelineCategoryCount] = {
+        "ffi",
+        "callback",
+        "delivery"
+};
+
+/**
+ * Name of the argument of the events of each category in the trace, nullptr for none.
+ */
+static const char *const kTimelineArgNames[kTimelineCategoryCount] = {
+        nullptr,
+        nullptr,
+        "events"
+};
+
+inline int64_t timelineClockNanos() {
+    timespec time{};
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<int64_t>(time.tv_sec) * 1000000000LL + time.tv_nsec;
+}
+
+/**
+ * One span. The fields are atomic only so that a flush may read a slot while its thread writes
+ * it; such reads are detected and dropped by TimelineRing::written.
+ */
+struct TimelineEvent {
+    std::atomic<const char *> name;
+    std::atomic<int64_t> start;
+    std::atomic<int64_t> duration;
+    std::atomic<int64_t> arg;
+    std::atomic<int32_t> tid;
+    std::atomic<int32_t> category;
+};
+
+struct TimelineRing {
+    TimelineEvent events[kTimelineRingCapacity];
+    // number of events ever written, stored after the event
+    std::atomic<uint64_t> written;
+    // events before this were flushed, touched under Timeline::flushMutex only
+    uint64_t flushed;
+    std::atomic<bool> owned;
+    int32_t tid;
+    TimelineRing *next;
+};
+
+struct TimelineSpan {
+    const char *name;
+    int64_t start;
+    int64_t duration;
+    int64_t arg;
+    int32_t tid;
+    int32_t category;
+};
+
+class Timeline {
+public:
+    void setRecording(bool enabled) {
+        recording.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool isRecording() const {
+        return recording.load(std::memory_order_relaxed);
+    }
+
+    void record(TimelineCategory category, const char *name, int64_t start, int64_t end,
+                int64_t arg) {
+        TimelineRing *pRing = currentRing();
+        uint64_t index = pRing->written.load(std::memory_order_relaxed);
+        TimelineEvent &event = pRing->events[index % kTimelineRingCapacity];
+        event.name.store(name, std::memory_order_relaxed);
+        event.start.store(start, std::memory_order_relaxed);
+        event.duration.store(end - start, std::memory_order_relaxed);
+        event.arg.store(arg, std::memory_order_relaxed);
+        event.tid.store(pRing->tid, std::memory_order_relaxed);
+        event.category.store(category, std::memory_order_relaxed);
+        pRing->written.store(index + 1, std::memory_order_release);
+    }
+
+    /**
+     * Writes the events recorded since the last flush to a Chrome trace JSON file at path and
+     * drops them from the rings. Returns the number of events written, -1 if the file cannot be
+     * written.
+     */
+    int64_t flush(const char *path) {
+        std::lock_guard<std::mutex> lock(flushMutex);
+        std::vector<TimelineSpan> spans;
+        for (TimelineRing *pRing = rings.load(std::memory_order_acquire); pRing != nullptr;
+             pRing = pRing->next) {
+            collect(*pRing, spans);
+        }
+        std::stable_sort(spans.begin(), spans.end(), [](const TimelineSpan &left,
+                                                        const TimelineSpan &right) {
+            return left.start < right.start;
+        });
+        FILE *pFile = fopen(path, "w");
+        if (pFile == nullptr) {
+            return -1;
+        }
+        int pid = static_cast<int>(getpid());
+        fprintf(pFile, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+        fprintf(pFile, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %d, "
+                       "\"args\": {\"name\": \"native-lib\"}}", pid);
+        {
+            std::set<int32_t> tids;
+            for (const TimelineSpan &span : spans) {
+                tids.insert(span.tid);
+            }
+            std::lock_guard<std::mutex> namesLock(threadNamesMutex);
+            for (int32_t tid : tids) {
+                auto name = threadNames.find(tid);
+                if (name != threadNames.end()) {
+                    fprintf(pFile, ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %d, "
+                                   "\"tid\": %d, \"args\": {\"name\": \"%s\"}}",
+                            pid, tid, name->second.c_str());
+                }
+            }
+        }
+        for (const TimelineSpan &span : spans) {
+            fprintf(pFile, ",\n{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, "
+                           "\"dur\": %.3f, \"pid\": %d, \"tid\": %d",
+                    span.name, kTimelineCategoryNames[span.category],
+                    static_cast<double>(span.start) / 1e3,
+                    static_cast<double>(span.duration) / 1e3, pid, span.tid);
+            const char *argName = kTimelineArgNames[span.category];
+            if (argName != nullptr) {
+                fprintf(pFile, ", \"args\": {\"%s\": %lld}", argName,
+                        static_cast<long long>(span.arg));
+            }
+            fputc('}', pFile);
+        }
+        fprintf(pFile, "\n]}\n");
+        bool failed = ferror(pFile) != 0;
+        failed = fclose(pFile) != 0 || failed;
+        return failed ? -1 : static_cast<int64_t>(spans.size());
+    }
+
+private:
+    /**
+     * Hands the calling thread a ring, a free one of an exited thread if there is one.
+     */
+    TimelineRing *currentRing() {
+        struct Lease {
+            TimelineRing *pRing = nullptr;
+
+            ~Lease() {
+                if (pRing != nullptr) {
+                    pRing->owned.store(false, std::memory_order_release);
+                }
+            }
+        };
+        static thread_local Lease t_lease;
+        if (t_lease.pRing != nullptr) {
+            return t_lease.pRing;
+        }
+        TimelineRing *pRing = nullptr;
+        for (TimelineRing *pFree = rings.load(std::memory_order_acquire); pFree != nullptr;
+             pFree = pFree->next) {
+            bool expected = false;
+            if (!pFree->owned.load(std::memory_order_relaxed) &&
+                pFree->owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                pRing = pFree;
+                break;
+            }
+        }
+        if (pRing == nullptr) {
+            pRing = new TimelineRing();
+            pRing->owned.store(true, std::memory_order_relaxed);
+            pRing->next = rings.load(std::memory_order_relaxed);
+            while (!rings.compare_exchange_weak(pRing->next, pRing, std::memory_order_release,
+                                                std::memory_order_relaxed)) {
+            }
+        }
+        pRing->tid = static_cast<int32_t>(syscall(SYS_gettid));
+        char name[17] = {};
+        prctl(PR_GET_NAME, name);
+        // written into the trace unescaped
+        std::replace_if(name, name + sizeof(name) - 1, [](char c) {
+            return c == '"' || c == '\\' || (c > 0 && c < ' ');
+        }, '_');
+        {
+            std::lock_guard<std::mutex> lock(threadNamesMutex);
+            threadNames[pRing->tid] = name;
+        }
+        t_lease.pRing = pRing;
+        return pRing;
+    }
+
+    /**
+     * Copies the unflushed events of the ring, skipping those its thread may have overwritten
+     * while they were being read.
+     */
+    static void collect(TimelineRing &ring, std::vector<TimelineSpan> &spans) {
+        uint64_t end = ring.written.load(std::memory_order_acquire);
+        uint64_t begin = std::max(ring.flushed, end > kTimelineRingCapacity
+                                                ? end - kTimelineRingCapacity : 0);
+        size_t first = spans.size();
+        for (uint64_t index = begin; index < end; index++) {
+            const TimelineEvent &event = ring.events[index % kTimelineRingCapacity];
+            spans.push_back(TimelineSpan{
+                    event.name.load(std::memory_order_relaxed),
+                    event.start.load(std::memory_order_relaxed),
+                    event.duration.load(std::memory_order_relaxed),
+                    event.arg.load(std::memory_order_relaxed),
+                    event.tid.load(std::memory_order_relaxed),
+                    event.category.load(std::memory_order_relaxed)
+            });
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = ring.written.load(std::memory_order_relaxed);
+        // the slot of event `after` may be half written, and with it the oldest ones read
+        uint64_t overwritten = after + 1 > kTimelineRingCapacity ? after + 1 - kTimelineRingCapacity : 0;
+        if (overwritten > begin) {
+            auto dropped = static_cast<size_t>(std::min(overwritten, end) - begin);
+            spans.erase(spans.begin() + first, spans.begin() + first + dropped);
+        }
+        ring.flushed = end;
+    }
+
+    std::atomic<bool> recording{false};
+    std::atomic<TimelineRing *> rings{nullptr};
+    std::mutex flushMutex;
+    std::mutex threadNamesMutex;
+    std::map<int32_t, std::string> threadNames;
+};
+
+/**
+ * Defined in jniUtil.cpp.
+ */
+extern Timeline g_timeline;
+
+/**
+ * Records its scope as a span while the timeline is recording, and as an ATrace section while
+ * the system is tracing.
+ */
+class TimelineScope {
+public:
+    TimelineScope(TimelineCategory category, const char *name, int64_t arg = 0)
+            : category(category), name(name), arg(arg),
+              start(g_timeline.isRecording() ? timelineClockNanos() : -1),
+              section(ATrace_isEnabled()) {
+        if (section) {
+            ATrace_beginSection(name);
+        }
+    }
+
+    ~TimelineScope() {
+        if (section) {
+            ATrace_endSection();
+        }
+        if (start >= 0) {
+            g_timeline.record(category, name, start, timelineClockNanos(), arg);
+        }
+    }
+
+    TimelineScope(const TimelineScope &) = delete;
+
+    TimelineScope &operator=(const TimelineScope &) = delete;
+
+private:
+    const TimelineCategory category;
+    const char *const name;
+    const int64_t arg;
+    const int64_t start;
+    const bool section;
+};
+
+#if TARI_JNI_TIMELINE
+
+#define TIMELINE_SCOPE(...) TimelineScope timelineScope(__VA_ARGS__)
+
+#else
+
+#define TIMELINE_SCOPE(...)
+
+#endif
+
+#endif // JNI_TIMELINE_CPP
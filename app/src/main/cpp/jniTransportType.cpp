@@ -37,6 +37,7 @@
 #include <cmath>
 #include <android/log.h>
 #include "jniCommon.cpp"
+#include "jniUtf8.cpp"
 
 extern "C"
 JNIEXPORT void JNICALL
@@ -104,7 +105,7 @@ Java_com_tari_android_wallet_ffi_FFITransportType_jniGetMemoryAddress(
     auto *pTransport = reinterpret_cast<TariTransportType *>(lTransport);
     const char *pAddress = transport_memory_get_address(pTransport, r);
     setErrorCode(jEnv, error, i);
-    jstring result = jEnv->NewStringUTF(pAddress);
+    jstring result = newStringFromUtf8(jEnv, pAddress);
     string_destroy(const_cast<char *>(pAddress));
     return result;
 }
@@ -0,0 +1,888 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef JNI_TX_CACHE_CPP
+#define JNI_TX_CACHE_CPP
+
+#include <jni.h>
+#include <wallet.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <algorithm>
+#include "jniCommon.cpp"
+#include "jniTxSearch.cpp"
+#include "jniHexCodec.cpp"
+
+/**
+ * Column-oriented copy of wallet transactions: completed, cancelled and pending in both
+ * directions. Each column holds one value per row so that filters and totals on the Kotlin side
+ * scan contiguous primitive arrays, see TxTable.kt. Messages and counterparty public keys are
+ * stored once in a deduplicated string pool and referenced by index.
+ *
+ * The same table carries the answer of TxChangeCache::changesSince, where the change column
+ * tells inserted, updated and removed rows apart.
+ */
+enum TxTableKind {
+    kTxTableCompleted = 0,
+    kTxTableCancelled,
+    kTxTablePendingInbound,
+    kTxTablePendingOutbound,
+    kTxTableKindCount
+};
+
+/**
+ * Orderings served by TxChangeCache::page. Ties are broken by tx id so that pages are stable.
+ */
+enum TxSortKey {
+    kTxSortByTimestamp = 0,
+    kTxSortByAmount,
+    kTxSortByStatus,
+    kTxSortKeyCount
+};
+
+enum TxTableChange {
+    kTxTableInserted = 0,
+    kTxTableUpdated,
+    kTxTableRemoved
+};
+
+/**
+ * Raw unsigned 64-bit columns. Keep in sync with TxTable.kt.
+ */
+enum TxTableLongColumn {
+    kTxTableId = 0,
+    kTxTableAmount,
+    kTxTableFee,
+    kTxTableTimestamp,
+    kTxTableLongColumnCount
+};
+
+/**
+ * 32-bit columns. Keep in sync with TxTable.kt.
+ */
+enum TxTableIntColumn {
+    kTxTableStatus = 0,
+    kTxTableKindColumn,
+    kTxTableOutbound,
+    kTxTableMessageRef,
+    kTxTableCounterpartyRef,
+    kTxTableChangeColumn,
+    kTxTableIntColumnCount
+};
+
+/**
+ * Interns strings, each distinct value is stored once in the index map and referenced by the
+ * order of its first appearance.
+ */
+class TxStringPool {
+public:
+    jint intern(const std::string &value) {
+        auto inserted = index.emplace(value, static_cast<jint>(values.size()));
+        if (inserted.second) {
+            values.push_back(&inserted.first->first);
+        }
+        return inserted.first->second;
+    }
+
+    size_t size() const {
+        return values.size();
+    }
+
+    const std::string &at(size_t position) const {
+        return *values[position];
+    }
+
+private:
+    std::unordered_map<std::string, jint> index;
+    std::vector<const std::string *> values;
+};
+
+/**
+ * Uppercase hex of the key bytes, the format FFIPublicKey.toString() produces. Releases the key.
+ */
+inline std::string takePublicKeyHex(TariPublicKey *pPublicKey, int *r) {
+    std::string hex;
+    if (pPublicKey == nullptr) {
+        return hex;
+    }
+    ByteVector *pBytes = public_key_get_bytes(pPublicKey, r);
+    if (pBytes != nullptr) {
+        uint8_t bytes[64];
+        int length = readByteVector(pBytes, bytes, sizeof(bytes), r);
+        if (length > 0) {
+            hex.resize(2 * length);
+            hexEncode(bytes, static_cast<size_t>(length), &hex[0], true);
+        }
+        byte_vector_destroy(pBytes);
+    }
+    public_key_destroy(pPublicKey);
+    return hex;
+}
+
+/**
+ * Copies a message returned by the wallet library and releases it.
+ */
+inline std::string takeMessage(const char *pMessage) {
+    if (pMessage == nullptr) {
+        return std::string();
+    }
+    std::string message(pMessage);
+    string_destroy(const_cast<char *>(pMessage));
+    return message;
+}
+
+/**
+ * Field values of one tx, detached from the wallet library handle it was read from.
+ */
+struct TxRecord {
+    unsigned long long id;
+    unsigned long long amount;
+    unsigned long long fee;
+    unsigned long long timestamp;
+    jint status;
+    TxTableKind kind;
+    bool isOutbound;
+    std::string message;
+    std::string counterparty;
+
+    bool operator==(const TxRecord &other) const {
+        return id == other.id && amount == other.amount && fee == other.fee
+               && timestamp == other.timestamp && status == other.status && kind == other.kind
+               && isOutbound == other.isOutbound && message == other.message
+               && counterparty == other.counterparty;
+    }
+
+    bool operator!=(const TxRecord &other) const {
+        return !(*this == other);
+    }
+};
+
+inline TxRecord txRecordFromCompleted(TariCompletedTransaction *pTx, TxTableKind kind, int *r) {
+    TxRecord record;
+    record.isOutbound = completed_transaction_is_outbound(pTx, r);
+    record.id = completed_transaction_get_transaction_id(pTx, r);
+    record.amount = completed_transaction_get_amount(pTx, r);
+    record.fee = completed_transaction_get_fee(pTx, r);
+    record.timestamp = completed_transaction_get_timestamp(pTx, r);
+    record.status = completed_transaction_get_status(pTx, r);
+    record.kind = kind;
+    record.message = takeMessage(completed_transaction_get_message(pTx, r));
+    record.counterparty = takePublicKeyHex(
+            record.isOutbound
+            ? completed_transaction_get_destination_public_key(pTx, r)
+            : completed_transaction_get_source_public_key(pTx, r),
+            r);
+    return record;
+}
+
+inline TxRecord txRecordFromPendingInbound(TariPendingInboundTransaction *pTx, int *r) {
+    TxRecord record;
+    record.isOutbound = false;
+    record.id = pending_inbound_transaction_get_transaction_id(pTx, r);
+    record.amount = pending_inbound_transaction_get_amount(pTx, r);
+    record.fee = 0;
+    record.timestamp = pending_inbound_transaction_get_timestamp(pTx, r);
+    record.status = pending_inbound_transaction_get_status(pTx, r);
+    record.kind = kTxTablePendingInbound;
+    record.message = takeMessage(pending_inbound_transaction_get_message(pTx, r));
+    record.counterparty = takePublicKeyHex(pending_inbound_transaction_get_source_public_key(pTx, r), r);
+    return record;
+}
+
+inline TxRecord txRecordFromPendingOutbound(TariPendingOutboundTransaction *pTx, int *r) {
+    TxRecord record;
+    record.isOutbound = true;
+    record.id = pending_outbound_transaction_get_transaction_id(pTx, r);
+    record.amount = pending_outbound_transaction_get_amount(pTx, r);
+    record.fee = pending_outbound_transaction_get_fee(pTx, r);
+    record.timestamp = pending_outbound_transaction_get_timestamp(pTx, r);
+    record.status = pending_outbound_transaction_get_status(pTx, r);
+    record.kind = kTxTablePendingOutbound;
+    record.message = takeMessage(pending_outbound_transaction_get_message(pTx, r));
+    record.counterparty = takePublicKeyHex(pending_outbound_transaction_get_destination_public_key(pTx, r), r);
+    return record;
+}
+
+template<typename Visitor>
+void forEachCompletedTx(TariCompletedTransactions *pTxs, TxTableKind kind, int *r, Visitor &visit) {
+    unsigned int length = completed_transactions_get_length(pTxs, r);
+    for (unsigned int index = 0; index < length && *r == 0; index++) {
+        TariCompletedTransaction *pTx = completed_transactions_get_at(pTxs, index, r);
+        if (pTx == nullptr) {
+            break;
+        }
+        visit(txRecordFromCompleted(pTx, kind, r));
+        completed_transaction_destroy(pTx);
+    }
+}
+
+/**
+ * Reads every completed, cancelled and pending tx of the wallet and passes its record to visit.
+ * Stops at the first error reported through r.
+ */
+template<typename Visitor>
+void forEachWalletTx(TariWallet *pWallet, int *r, Visitor visit) {
+    TariCompletedTransactions *pCompleted = wallet_get_completed_transactions(pWallet, r);
+    if (pCompleted != nullptr) {
+        forEachCompletedTx(pCompleted, kTxTableCompleted, r, visit);
+        completed_transactions_destroy(pCompleted);
+    }
+    TariCompletedTransactions *pCancelled =
+            *r == 0 ? wallet_get_cancelled_transactions(pWallet, r) : nullptr;
+    if (pCancelled != nullptr) {
+        forEachCompletedTx(pCancelled, kTxTableCancelled, r, visit);
+        completed_transactions_destroy(pCancelled);
+    }
+    TariPendingInboundTransactions *pInbound =
+            *r == 0 ? wallet_get_pending_inbound_transactions(pWallet, r) : nullptr;
+    if (pInbound != nullptr) {
+        unsigned int length = pending_inbound_transactions_get_length(pInbound, r);
+        for (unsigned int index = 0; index < length && *r == 0; index++) {
+            TariPendingInboundTransaction *pTx = pending_inbound_transactions_get_at(pInbound, index, r);
+            if (pTx == nullptr) {
+                break;
+            }
+            visit(txRecordFromPendingInbound(pTx, r));
+            pending_inbound_transaction_destroy(pTx);
+        }
+        pending_inbound_transactions_destroy(pInbound);
+    }
+    TariPendingOutboundTransactions *pOutbound =
+            *r == 0 ? wallet_get_pending_outbound_transactions(pWallet, r) : nullptr;
+    if (pOutbound != nullptr) {
+        unsigned int length = pending_outbound_transactions_get_length(pOutbound, r);
+        for (unsigned int index = 0; index < length && *r == 0; index++) {
+            TariPendingOutboundTransaction *pTx = pending_outbound_transactions_get_at(pOutbound, index, r);
+            if (pTx == nullptr) {
+                break;
+            }
+            visit(txRecordFromPendingOutbound(pTx, r));
+            pending_outbound_transaction_destroy(pTx);
+        }
+        pending_outbound_transactions_destroy(pOutbound);
+    }
+}
+
+/**
+ * (public key hex, alias) of every contact of the wallet. Returns false with the error in r if
+ * the contacts could not be read.
+ */
+inline bool readContactAliases(TariWallet *pWallet,
+                               std::vector<std::pair<std::string, std::string>> &aliases,
+                               int *r) {
+    TariContacts *pContacts = wallet_get_contacts(pWallet, r);
+    if (pContacts == nullptr) {
+        return false;
+    }
+    unsigned int length = contacts_get_length(pContacts, r);
+    for (unsigned int index = 0; index < length && *r == 0; index++) {
+        TariContact *pContact = contacts_get_at(pContacts, index, r);
+        if (pContact == nullptr) {
+            break;
+        }
+        std::string alias = takeMessage(contact_get_alias(pContact, r));
+        aliases.emplace_back(takePublicKeyHex(contact_get_public_key(pContact, r), r), alias);
+        contact_destroy(pContact);
+    }
+    contacts_destroy(pContacts);
+    return *r == 0;
+}
+
+struct TxTable {
+    std::vector<jlong> longColumns[kTxTableLongColumnCount];
+    std::vector<jint> intColumns[kTxTableIntColumnCount];
+    TxStringPool strings;
+    /**
+     * Cache generation the table is current up to, 0 for a table read straight from the wallet.
+     */
+    jlong generation = 0;
+    /**
+     * Number of rows matching the query when the table is a page of it, -1 otherwise.
+     */
+    jint totalRowCount = -1;
+    /**
+     * The table holds every tx rather than the changes after a generation, so the caller
+     * replaces what it holds instead of applying the rows to it.
+     */
+    bool complete = false;
+
+    jint rowCount() const {
+        return static_cast<jint>(longColumns[kTxTableId].size());
+    }
+
+    void add(const TxRecord &record, TxTableChange change) {
+        longColumns[kTxTableId].push_back(static_cast<jlong>(record.id));
+        longColumns[kTxTableAmount].push_back(static_cast<jlong>(record.amount));
+        longColumns[kTxTableFee].push_back(static_cast<jlong>(record.fee));
+        longColumns[kTxTableTimestamp].push_back(static_cast<jlong>(record.timestamp));
+        intColumns[kTxTableStatus].push_back(record.status);
+        intColumns[kTxTableKindColumn].push_back(record.kind);
+        intColumns[kTxTableOutbound].push_back(record.isOutbound ? 1 : 0);
+        intColumns[kTxTableMessageRef].push_back(strings.intern(record.message));
+        intColumns[kTxTableCounterpartyRef].push_back(strings.intern(record.counterparty));
+        intColumns[kTxTableChangeColumn].push_back(change);
+    }
+};
+
+const size_t kTxCacheMaxTombstones = 1024;
+
+/**
+ * Latest known record of every tx, each stamped with the generation at which it last changed.
+ * The wallet callbacks (jniWallet.cpp) feed it as their events are dispatched, so after the
+ * initial load a changesSince call only walks the changes newer than the caller's generation.
+ *
+ * Some wallet events change txs without a per-tx callback (validation, recovery). Those mark the
+ * cache stale and the next changesSince re-reads the wallet once and diffs it against the cache,
+ * which is also how the cache is first populated.
+ *
+ * The wallet library only hands out whole collections in its own order, so the first sorted page
+ * needs every tx read once. startWarming() does that read on a thread of its own as soon as the
+ * wallet is open and repeats it whenever the cache is marked stale. Once seeded, page() and
+ * search() answer from memory while such a re-read is in flight, and the txs it changes reach
+ * the caller through changesSince.
+ *
+ * Removed txs are kept as tombstones so that changesSince can report them. Beyond
+ * kTxCacheMaxTombstones the oldest are dropped and the generation of the newest dropped one
+ * becomes the low water mark: a caller behind it could miss a removal and gets a complete table
+ * instead of changes.
+ *
+ * The cache also maintains the TxSearchIndex behind search(), so messages are indexed as the
+ * callbacks deliver them rather than on the first query.
+ */
+class TxChangeCache {
+public:
+    ~TxChangeCache() {
+        stopWarming();
+    }
+
+    void record(const TxRecord &record) {
+        std::lock_guard<std::mutex> lock(mutex);
+        upsertLocked(record);
+    }
+
+    void record(const std::vector<TxRecord> &records) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const TxRecord &record : records) {
+            upsertLocked(record);
+        }
+    }
+
+    void markStale() {
+        {
+            std::lock_guard<std::mutex> lock(warmMutex);
+            stale.store(true);
+        }
+        warmWakeUp.notify_one();
+    }
+
+    /**
+     * Starts the thread that reads the wallet into the cache and re-reads it whenever the cache
+     * is marked stale. The wallet must outlive the thread, see stopWarming().
+     */
+    void startWarming(TariWallet *pWallet) {
+        std::lock_guard<std::mutex> lock(warmMutex);
+        if (warming.exchange(true)) {
+            return;
+        }
+        warmThread = std::thread(&TxChangeCache::warm, this, pWallet);
+    }
+
+    /**
+     * Joins the warm-up thread, waiting for a read in flight. Called before the wallet is
+     * destroyed.
+     */
+    void stopWarming() {
+        {
+            std::lock_guard<std::mutex> lock(warmMutex);
+            if (!warming.exchange(false)) {
+                return;
+            }
+        }
+        warmWakeUp.notify_one();
+        warmThread.join();
+    }
+
+    /**
+     * Called after a contact is added, renamed or removed (empty alias).
+     */
+    void setAlias(const std::string &counterparty, const std::string &alias) {
+        std::lock_guard<std::mutex> lock(mutex);
+        searchIndex.setAlias(counterparty, alias);
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+        log.clear();
+        searchIndex.clear();
+        for (auto &kinds : sortedIndexes) {
+            for (SortedIndex &index : kinds) {
+                index.clear();
+            }
+        }
+        indexesDirty = false;
+        generation = 0;
+        lowWater = 0;
+        tombstoneCount = 0;
+        stale.store(true);
+        seeded.store(false);
+    }
+
+    /**
+     * Returns a table of the txs inserted, updated or removed after generation since, stamped
+     * with the current generation. A since value the cache has not reached yet (left over from a
+     * previous wallet instance) or below the low water mark is treated as 0 and returns every tx
+     * in a complete table. Returns nullptr if the wallet could not be read, with the error in r.
+     */
+    TxTable *changesSince(TariWallet *pWallet, jlong since, int *r) {
+        if (!resyncIfStale(pWallet, r)) {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (since > generation || since < lowWater || since < 0) {
+            since = 0;
+        }
+        auto *pTable = new TxTable();
+        pTable->generation = generation;
+        pTable->complete = since == 0;
+        for (auto it = log.upper_bound(since); it != log.end(); ++it) {
+            const Entry &entry = entries.at(it->second);
+            bool isNew = entry.insertedAt > since;
+            if (entry.removed) {
+                // inserted and removed within the window, the caller never saw it
+                if (!isNew) {
+                    pTable->add(entry.record, kTxTableRemoved);
+                }
+            } else {
+                pTable->add(entry.record, isNew ? kTxTableInserted : kTxTableUpdated);
+            }
+        }
+        return pTable;
+    }
+
+    /**
+     * Rows [offset, offset + limit) of the txs whose kind bit is set in kindMask, in the given
+     * order, with totalRowCount set to the number of matching txs. Completed, cancelled and
+     * pending txs share one ordering. Each kind keeps its own index per sort key, so the window
+     * is found by binary search and merged from at most four indexes, in O(log N + limit).
+     * A seeded cache is not re-read here, see startWarming().
+     */
+    TxTable *page(TariWallet *pWallet,
+                  TxSortKey key,
+                  bool descending,
+                  jint kindMask,
+                  jint offset,
+                  jint limit,
+                  int *r) {
+        if (!awaitReadable(pWallet, r)) {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<const SortedIndex *> runs;
+        size_t total = 0;
+        for (int kind = 0; kind < kTxTableKindCount; kind++) {
+            if ((kindMask & (1 << kind)) != 0) {
+                runs.push_back(&sortedIndexes[key][kind]);
+                total += sortedIndexes[key][kind].size();
+            }
+        }
+        auto *pTable = new TxTable();
+        pTable->generation = generation;
+        pTable->totalRowCount = static_cast<jint>(total);
+        auto first = static_cast<size_t>(offset);
+        if (first >= total) {
+            return pTable;
+        }
+        size_t count = std::min(static_cast<size_t>(limit), total - first);
+        // a descending window is the mirrored ascending one, read backwards
+        size_t start = descending ? total - first - count : first;
+        std::vector<size_t> positions = selectLocked(key, runs, start);
+        std::vector<const Entry *> window;
+        window.reserve(count);
+        while (window.size() < count) {
+            size_t next = runs.size();
+            for (size_t run = 0; run < runs.size(); run++) {
+                if (positions[run] < runs[run]->size()
+                    && (next == runs.size()
+                        || precedes(key, (*runs[run])[positions[run]]->record,
+                                    (*runs[next])[positions[next]]->record))) {
+                    next = run;
+                }
+            }
+            window.push_back((*runs[next])[positions[next]++]);
+        }
+        if (descending) {
+            std::reverse(window.begin(), window.end());
+        }
+        for (const Entry *pEntry : window) {
+            pTable->add(pEntry->record, kTxTableInserted);
+        }
+        return pTable;
+    }
+
+    /**
+     * Ids of up to limit txs whose message or counterparty alias contains query, ignoring ASCII
+     * case, best match first. See TxSearchIndex::query for the ranking. Like page(), a seeded
+     * cache is not re-read here.
+     */
+    std::vector<unsigned long long> search(TariWallet *pWallet,
+                                           const std::string &query,
+                                           size_t limit,
+                                           int *r) {
+        if (!awaitReadable(pWallet, r)) {
+            return std::vector<unsigned long long>();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        return searchIndex.query(query, limit);
+    }
+
+private:
+    struct Entry {
+        TxRecord record;
+        jlong insertedAt;
+        jlong changedAt;
+        bool removed;
+    };
+
+    /**
+     * Live entries of one kind in ascending order of one sort key. Entries are never erased
+     * outside reset(), which clears the indexes too, so the pointers stay valid.
+     */
+    typedef std::vector<const Entry *> SortedIndex;
+
+    static bool precedes(TxSortKey key, const TxRecord &left, const TxRecord &right) {
+        switch (key) {
+            case kTxSortByAmount:
+                if (left.amount != right.amount) {
+                    return left.amount < right.amount;
+                }
+                break;
+            case kTxSortByStatus:
+                if (left.status != right.status) {
+                    return left.status < right.status;
+                }
+                break;
+            default:
+                if (left.timestamp != right.timestamp) {
+                    return left.timestamp < right.timestamp;
+                }
+                break;
+        }
+        return left.id < right.id;
+    }
+
+    static SortedIndex::const_iterator lowerBound(TxSortKey key, const SortedIndex &index,
+                                                  const TxRecord &record) {
+        return std::lower_bound(index.begin(), index.end(), &record,
+                                [key](const Entry *pEntry, const TxRecord *pRecord) {
+                                    return precedes(key, pEntry->record, *pRecord);
+                                });
+    }
+
+    /**
+     * Per run, the number of its entries among the first start entries of the runs merged.
+     * The ordering is total, so the rank of an entry is the sum of its lower bounds in every
+     * run, which grows with its position in its own run.
+     */
+    static std::vector<size_t> selectLocked(TxSortKey key,
+                                            const std::vector<const SortedIndex *> &runs,
+                                            size_t start) {
+        std::vector<size_t> positions(runs.size());
+        for (size_t run = 0; run < runs.size(); run++) {
+            const SortedIndex &index = *runs[run];
+            size_t low = 0;
+            size_t high = index.size();
+            while (low < high) {
+                size_t middle = low + (high - low) / 2;
+                size_t rank = 0;
+                for (const SortedIndex *pOther : runs) {
+                    rank += lowerBound(key, *pOther, index[middle]->record) - pOther->begin();
+                }
+                if (rank < start) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+            positions[run] = low;
+        }
+        return positions;
+    }
+
+    /**
+     * Adds a live entry to the index of its kind for every sort key. A resync that changes the
+     * cache defers this to one rebuildIndexesLocked() at its end.
+     */
+    void indexLocked(const Entry &entry) {
+        if (indexesDirty) {
+            return;
+        }
+        for (int key = 0; key < kTxSortKeyCount; key++) {
+            SortedIndex &index = sortedIndexes[key][entry.record.kind];
+            index.insert(lowerBound(static_cast<TxSortKey>(key), index, entry.record), &entry);
+        }
+    }
+
+    /**
+     * Removes a live entry from its indexes, called before its record changes.
+     */
+    void unindexLocked(const Entry &entry) {
+        if (indexesDirty) {
+            return;
+        }
+        for (int key = 0; key < kTxSortKeyCount; key++) {
+            SortedIndex &index = sortedIndexes[key][entry.record.kind];
+            index.erase(lowerBound(static_cast<TxSortKey>(key), index, entry.record));
+        }
+    }
+
+    void rebuildIndexesLocked() {
+        for (auto &kinds : sortedIndexes) {
+            for (SortedIndex &index : kinds) {
+                index.clear();
+            }
+        }
+        for (const auto &item : entries) {
+            if (!item.second.removed) {
+                for (auto &kinds : sortedIndexes) {
+                    kinds[item.second.record.kind].push_back(&item.second);
+                }
+            }
+        }
+        for (int key = 0; key < kTxSortKeyCount; key++) {
+            for (SortedIndex &index : sortedIndexes[key]) {
+                std::sort(index.begin(), index.end(), [key](const Entry *a, const Entry *b) {
+                    return precedes(static_cast<TxSortKey>(key), a->record, b->record);
+                });
+            }
+        }
+        indexesDirty = false;
+    }
+
+    /**
+     * Drops the oldest tombstones down to half the limit, so that compaction runs once per
+     * that many removals, and raises the low water mark past them.
+     */
+    void compactLocked() {
+        auto it = log.begin();
+        while (it != log.end() && tombstoneCount > kTxCacheMaxTombstones / 2) {
+            auto found = entries.find(it->second);
+            if (!found->second.removed) {
+                ++it;
+                continue;
+            }
+            lowWater = it->first;
+            entries.erase(found);
+            it = log.erase(it);
+            tombstoneCount--;
+        }
+    }
+
+    void touchLocked(unsigned long long id, Entry &entry) {
+        if (entry.changedAt != 0) {
+            log.erase(entry.changedAt);
+        }
+        entry.changedAt = ++generation;
+        log[entry.changedAt] = id;
+    }
+
+    void upsertLocked(const TxRecord &record) {
+        auto found = entries.find(record.id);
+        if (found == entries.end()) {
+            Entry entry = {record, generation + 1, 0, false};
+            auto inserted = entries.emplace(record.id, entry);
+            touchLocked(record.id, inserted.first->second);
+            indexLocked(inserted.first->second);
+            searchIndex.put(record.id, record.timestamp, record.message, record.counterparty);
+            return;
+        }
+        Entry &entry = found->second;
+        if (!entry.removed && entry.record == record) {
+            return;
+        }
+        if (entry.removed) {
+            entry.insertedAt = generation + 1;
+            entry.removed = false;
+            tombstoneCount--;
+        } else {
+            unindexLocked(entry);
+        }
+        entry.record = record;
+        touchLocked(record.id, entry);
+        indexLocked(entry);
+        searchIndex.put(record.id, record.timestamp, record.message, record.counterparty);
+    }
+
+    /**
+     * Reads that tolerate a stale cache only wait for the first read of the wallet, and only
+     * while the warm-up thread is there to fold in the re-read.
+     */
+    bool awaitReadable(TariWallet *pWallet, int *r) {
+        if (warming.load() && seeded.load()) {
+            return true;
+        }
+        return resyncIfStale(pWallet, r);
+    }
+
+    /**
+     * Warm-up thread body, re-reads the wallet whenever the cache is stale until stopWarming().
+     */
+    void warm(TariWallet *pWallet) {
+        std::unique_lock<std::mutex> lock(warmMutex);
+        while (warming.load()) {
+            if (!stale.load()) {
+                warmWakeUp.wait(lock);
+                continue;
+            }
+            lock.unlock();
+            int error = 0;
+            bool synced = resyncIfStale(pWallet, &error);
+            lock.lock();
+            if (!synced) {
+                // the cache stays stale, retried later rather than in a busy loop
+                warmWakeUp.wait_for(lock, std::chrono::seconds(1));
+            }
+        }
+    }
+
+    /**
+     * Re-reads the wallet if the cache is stale. Concurrent callers wait for a resync in flight
+     * rather than read the cache it is still seeding. Returns false, leaving the cache stale, if
+     * the wallet could not be read, with the error in r.
+     */
+    bool resyncIfStale(TariWallet *pWallet, int *r) {
+        std::lock_guard<std::mutex> lock(resyncMutex);
+        // cleared first so that a markStale() during the read is not lost
+        if (!stale.exchange(false)) {
+            return true;
+        }
+        resync(pWallet, r);
+        if (*r != 0) {
+            stale.store(true);
+            return false;
+        }
+        seeded.store(true);
+        return true;
+    }
+
+    /**
+     * Reads the wallet outside the lock (the wallet library may be firing callbacks into
+     * record() meanwhile), then merges. Entries changed by callbacks after the read started are
+     * newer than the read and are left alone.
+     */
+    void resync(TariWallet *pWallet, int *r) {
+        jlong startGeneration;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            startGeneration = generation;
+        }
+        std::vector<TxRecord> records;
+        forEachWalletTx(pWallet, r, [&records](const TxRecord &record) {
+            records.push_back(record);
+        });
+        if (*r != 0) {
+            return;
+        }
+        // contacts only feed search, a failure here keeps the aliases already known
+        int contactsError = 0;
+        std::vector<std::pair<std::string, std::string>> aliases;
+        bool aliasesRead = readContactAliases(pWallet, aliases, &contactsError);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (aliasesRead) {
+            searchIndex.replaceAliases(aliases);
+        }
+        // a full read may change most entries, one sort at the end beats moving them one by one
+        jlong mergeGeneration = generation;
+        indexesDirty = true;
+        std::unordered_set<unsigned long long> seen;
+        seen.reserve(records.size());
+        for (const TxRecord &record : records) {
+            seen.insert(record.id);
+            auto found = entries.find(record.id);
+            if (found != entries.end() && found->second.changedAt > startGeneration) {
+                continue;
+            }
+            upsertLocked(record);
+        }
+        for (auto &item : entries) {
+            Entry &entry = item.second;
+            if (!entry.removed && entry.changedAt <= startGeneration
+                && seen.find(item.first) == seen.end()) {
+                unindexLocked(entry);
+                entry.removed = true;
+                tombstoneCount++;
+                touchLocked(item.first, entry);
+                searchIndex.remove(item.first);
+            }
+        }
+        if (tombstoneCount > kTxCacheMaxTombstones) {
+            compactLocked();
+        }
+        if (generation != mergeGeneration) {
+            rebuildIndexesLocked();
+        } else {
+            indexesDirty = false;
+        }
+    }
+
+    std::mutex mutex;
+    // serializes resyncIfStale, never taken by record() on the callback threads
+    std::mutex resyncMutex;
+    jlong generation = 0;
+    // changes at or below it may have lost their tombstones, see compactLocked()
+    jlong lowWater = 0;
+    size_t tombstoneCount = 0;
+    std::unordered_map<unsigned long long, Entry> entries;
+    std::map<jlong, unsigned long long> log;
+    SortedIndex sortedIndexes[kTxSortKeyCount][kTxTableKindCount];
+    bool indexesDirty = false;
+    TxSearchIndex searchIndex;
+    std::atomic<bool> stale{true};
+    // set by the first successful read, until reset()
+    std::atomic<bool> seeded{false};
+    // guards the warm-up thread and pairs stale with warmWakeUp, never held over a read
+    std::mutex warmMutex;
+    std::condition_variable warmWakeUp;
+    std::atomic<bool> warming{false};
+    std::thread warmThread;
+};
+
+#endif // JNI_TX_CACHE_CPP
@@ -0,0 +1,413 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef JNI_TX_SEARCH_CPP
+#define JNI_TX_SEARCH_CPP
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Trigram index over tx messages and contact aliases, owned and kept current by TxChangeCache
+ * (jniTxCache.cpp). Text is folded to ASCII lower case byte-wise, so multi-byte UTF-8 sequences
+ * match exactly.
+ *
+ * A query of three or more bytes walks the posting list of its rarest trigram, two byte queries
+ * their bigram list, single bytes fall back to scanning the messages. Candidates are confirmed
+ * with a substring search only if they could still make the best limit hits: a second posting
+ * list holds the grams that start a word, so a candidate whose first gram starts no word is known
+ * to score at most an inside-word match, and among equal scores only a more recent candidate is
+ * checked. Once the best hits are all word starts, a common word costs one pass over integers
+ * plus about limit * log(hits) substring searches.
+ */
+class TxSearchIndex {
+public:
+    void put(unsigned long long id,
+             unsigned long long timestamp,
+             const std::string &message,
+             const std::string &counterparty) {
+        std::string text = fold(message);
+        uint32_t contact = internContact(counterparty);
+        auto found = docIndex.find(id);
+        uint32_t position;
+        if (found == docIndex.end()) {
+            position = static_cast<uint32_t>(docs.size());
+            docIndex.emplace(id, position);
+            docs.push_back(Doc{id, timestamp, std::string(), contact, false});
+        } else {
+            position = found->second;
+            Doc &doc = docs[position];
+            if (doc.live && doc.text == text && doc.contact == contact) {
+                doc.timestamp = timestamp;
+                return;
+            }
+            unlink(position);
+        }
+        Doc &doc = docs[position];
+        doc.timestamp = timestamp;
+        doc.text = std::move(text);
+        doc.contact = contact;
+        doc.live = true;
+        for (uint32_t gram : grams(doc.text, false)) {
+            insertSorted(postings[gram], position);
+        }
+        for (uint32_t gram : grams(doc.text, true)) {
+            insertSorted(wordStartPostings[gram], position);
+        }
+        insertSorted(docsByContact[contact], position);
+    }
+
+    void remove(unsigned long long id) {
+        auto found = docIndex.find(id);
+        if (found != docIndex.end() && docs[found->second].live) {
+            unlink(found->second);
+        }
+    }
+
+    /**
+     * Sets the alias of a counterparty, an empty alias removes it.
+     */
+    void setAlias(const std::string &counterparty, const std::string &alias) {
+        if (alias.empty()) {
+            aliases.erase(counterparty);
+        } else {
+            aliases[counterparty] = fold(alias);
+        }
+    }
+
+    void replaceAliases(const std::vector<std::pair<std::string, std::string>> &values) {
+        aliases.clear();
+        for (const auto &value : values) {
+            setAlias(value.first, value.second);
+        }
+    }
+
+    void clear() {
+        docs.clear();
+        docIndex.clear();
+        postings.clear();
+        wordStartPostings.clear();
+        contactIds.clear();
+        docsByContact.clear();
+        aliases.clear();
+    }
+
+    /**
+     * Ids of the txs whose message or counterparty alias contains text, best first: a match at
+     * the start of a word outranks one inside a word, a message and alias match outranks either
+     * alone, and ties go to the most recent tx.
+     */
+    std::vector<unsigned long long> query(const std::string &text, size_t limit) const {
+        std::string needle = fold(text);
+        if (needle.empty() || limit == 0) {
+            return std::vector<unsigned long long>();
+        }
+        TopHits top(docs, limit);
+        // the docs of a contact whose alias matches are ranked here, the walk below skips them
+        std::vector<int> aliasScores;
+        for (const auto &alias : aliases) {
+            int score = matchScore(alias.second, needle);
+            auto contact = contactIds.find(alias.first);
+            if (score == 0 || contact == contactIds.end()) {
+                continue;
+            }
+            aliasScores.resize(docsByContact.size());
+            aliasScores[contact->second] = score;
+            for (uint32_t position : docsByContact[contact->second]) {
+                top.offer(position, score + matchScore(docs[position].text, needle));
+            }
+        }
+        const std::vector<uint32_t> *pCandidates = rarestPostings(needle);
+        if (pCandidates == nullptr) {
+            return top.ids();
+        }
+        // both lists are sorted, so one pass tells which candidates start a word with needle;
+        // it runs from the last indexed doc, which is usually the newest, so that the hits fill
+        // up early and the older candidates are turned away without a substring search
+        static const std::vector<uint32_t> kNoStarts;
+        uint32_t firstGram = gramAt(needle, 0, std::min<size_t>(needle.size(), 3));
+        auto wordStarts = wordStartPostings.find(firstGram);
+        const std::vector<uint32_t> &starts =
+                wordStarts == wordStartPostings.end() ? kNoStarts : wordStarts->second;
+        auto start = starts.rbegin();
+        for (auto candidate = pCandidates->rbegin(); candidate != pCandidates->rend();
+             ++candidate) {
+            uint32_t position = *candidate;
+            while (start != starts.rend() && *start > position) {
+                ++start;
+            }
+            int bound = start != starts.rend() && *start == position ? 2 : 1;
+            if (!top.admits(position, bound)
+                || (!aliasScores.empty() && aliasScores[docs[position].contact] > 0)) {
+                continue;
+            }
+            int score = matchScore(docs[position].text, needle);
+            if (score > 0) {
+                top.offer(position, score);
+            }
+        }
+        return top.ids();
+    }
+
+private:
+    struct Doc {
+        unsigned long long id;
+        unsigned long long timestamp;
+        std::string text;
+        uint32_t contact;
+        bool live;
+    };
+
+    /**
+     * The best limit hits offered so far, in a heap with the weakest on top.
+     */
+    class TopHits {
+    public:
+        TopHits(const std::vector<Doc> &docs, size_t limit) : docs(docs), limit(limit) {}
+
+        /**
+         * Whether a doc scoring score would make the best hits.
+         */
+        bool admits(uint32_t position, int score) const {
+            if (hits.size() < limit || score > hits.front().second) {
+                return true;
+            }
+            return score == hits.front().second && better(Hit(position, score), hits.front());
+        }
+
+        void offer(uint32_t position, int score) {
+            if (!admits(position, score)) {
+                return;
+            }
+            auto comparator = [this](const Hit &a, const Hit &b) { return better(a, b); };
+            if (hits.size() == limit) {
+                std::pop_heap(hits.begin(), hits.end(), comparator);
+                hits.pop_back();
+            }
+            hits.emplace_back(position, score);
+            std::push_heap(hits.begin(), hits.end(), comparator);
+        }
+
+        /**
+         * Ids of the hits, best first.
+         */
+        std::vector<unsigned long long> ids() {
+            std::sort_heap(hits.begin(), hits.end(),
+                           [this](const Hit &a, const Hit &b) { return better(a, b); });
+            std::vector<unsigned long long> result;
+            result.reserve(hits.size());
+            for (const Hit &hit : hits) {
+                result.push_back(docs[hit.first].id);
+            }
+            return result;
+        }
+
+    private:
+        // (doc, score)
+        typedef std::pair<uint32_t, int> Hit;
+
+        bool better(const Hit &a, const Hit &b) const {
+            if (a.second != b.second) {
+                return a.second > b.second;
+            }
+            const Doc &left = docs[a.first];
+            const Doc &right = docs[b.first];
+            if (left.timestamp != right.timestamp) {
+                return left.timestamp > right.timestamp;
+            }
+            return left.id > right.id;
+        }
+
+        const std::vector<Doc> &docs;
+        size_t limit;
+        std::vector<Hit> hits;
+    };
+
+    static std::string fold(const std::string &value) {
+        std::string folded(value);
+        for (char &c : folded) {
+            if (c >= 'A' && c <= 'Z') {
+                c = static_cast<char>(c - 'A' + 'a');
+            }
+        }
+        return folded;
+    }
+
+    /**
+     * Distinct grams of text, ascending: every trigram, plus every byte and bigram so that one
+     * and two byte queries are served by the index too. Bytes and bigrams are tagged above the
+     * 24 trigram bits. A query is looked up by its trigrams only, or by its single byte or bigram.
+     * With wordStartsOnly, only the grams at the start of a word.
+     */
+    static std::vector<uint32_t> grams(const std::string &text, bool wordStartsOnly) {
+        std::vector<uint32_t> result;
+        result.reserve(3 * text.size());
+        for (size_t k = 0; k < text.size(); k++) {
+            if (wordStartsOnly && k > 0 && text[k - 1] != ' ') {
+                continue;
+            }
+            result.push_back(gramAt(text, k, 1));
+            if (k + 1 < text.size()) {
+                result.push_back(gramAt(text, k, 2));
+            }
+            if (k + 2 < text.size()) {
+                result.push_back(gramAt(text, k, 3));
+            }
+        }
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+
+    /**
+     * The gram of length one to three bytes at offset of text.
+     */
+    static uint32_t gramAt(const std::string &text, size_t offset, size_t length) {
+        uint32_t gram = 0;
+        for (size_t k = offset; k < offset + length; k++) {
+            gram = gram << 8 | static_cast<uint32_t>(static_cast<unsigned char>(text[k]));
+        }
+        return length == 3 ? gram : length == 2 ? kBigramTag | gram : kByteTag | gram;
+    }
+
+    /**
+     * 0 if text does not contain needle, 2 if it does at the start of a word, 1 otherwise.
+     */
+    static int matchScore(const std::string &text, const std::string &needle) {
+        size_t position = text.find(needle);
+        if (position == std::string::npos) {
+            return 0;
+        }
+        for (; position != std::string::npos; position = text.find(needle, position + 1)) {
+            if (position == 0 || text[position - 1] == ' ') {
+                return 2;
+            }
+        }
+        return 1;
+    }
+
+    /**
+     * The shortest posting list of the grams of needle, a superset of the docs containing it,
+     * or nullptr if a gram occurs nowhere.
+     */
+    const std::vector<uint32_t> *rarestPostings(const std::string &needle) const {
+        const std::vector<uint32_t> *pRarest = nullptr;
+        std::vector<uint32_t> needleGrams;
+        if (needle.size() < 3) {
+            needleGrams.push_back(gramAt(needle, 0, needle.size()));
+        } else {
+            for (size_t k = 0; k + 2 < needle.size(); k++) {
+                needleGrams.push_back(gramAt(needle, k, 3));
+            }
+        }
+        for (uint32_t gram : needleGrams) {
+            auto found = postings.find(gram);
+            if (found == postings.end() || found->second.empty()) {
+                return nullptr;
+            }
+            if (pRarest == nullptr || found->second.size() < pRarest->size()) {
+                pRarest = &found->second;
+            }
+        }
+        return pRarest;
+    }
+
+    uint32_t internContact(const std::string &counterparty) {
+        auto inserted = contactIds.emplace(counterparty,
+                                           static_cast<uint32_t>(docsByContact.size()));
+        if (inserted.second) {
+            docsByContact.emplace_back();
+        }
+        return inserted.first->second;
+    }
+
+    static void insertSorted(std::vector<uint32_t> &list, uint32_t position) {
+        if (list.empty() || list.back() < position) {
+            list.push_back(position);
+            return;
+        }
+        auto at = std::lower_bound(list.begin(), list.end(), position);
+        if (at == list.end() || *at != position) {
+            list.insert(at, position);
+        }
+    }
+
+    static void eraseSorted(std::vector<uint32_t> &list, uint32_t position) {
+        auto at = std::lower_bound(list.begin(), list.end(), position);
+        if (at != list.end() && *at == position) {
+            list.erase(at);
+        }
+    }
+
+    void unlink(uint32_t position) {
+        Doc &doc = docs[position];
+        if (!doc.live) {
+            return;
+        }
+        for (uint32_t gram : grams(doc.text, false)) {
+            auto found = postings.find(gram);
+            if (found != postings.end()) {
+                eraseSorted(found->second, position);
+            }
+        }
+        for (uint32_t gram : grams(doc.text, true)) {
+            auto found = wordStartPostings.find(gram);
+            if (found != wordStartPostings.end()) {
+                eraseSorted(found->second, position);
+            }
+        }
+        eraseSorted(docsByContact[doc.contact], position);
+        doc.live = false;
+    }
+
+    static const uint32_t kBigramTag = 1u << 24;
+    static const uint32_t kByteTag = 2u << 24;
+
+    std::vector<Doc> docs;
+    std::unordered_map<unsigned long long, uint32_t> docIndex;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> postings;
+    // the subset of postings where the gram starts a word
+    std::unordered_map<uint32_t, std::vector<uint32_t>> wordStartPostings;
+    // counterparty public key hex to the index of its docs in docsByContact
+    std::unordered_map<std::string, uint32_t> contactIds;
+    std::vector<std::vector<uint32_t>> docsByContact;
+    /**
+     * Folded alias per counterparty public key hex.
+     */
+    std::unordered_map<std::string, std::string> aliases;
+};
+
+#endif // JNI_TX_SEARCH_CPP
@@ -0,0 +1,169 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <jni.h>
+#include <android/log.h>
+#include <wallet.h>
+#include "jniCommon.cpp"
+#include "jniTxCache.cpp"
+#include "jniUtf8.cpp"
+
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniGetTxTable(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jobject error) {
+    int i = 0;
+    int *r = &i;
+    jlong lWallet = GetPointerField(jEnv, jThis);
+    auto *pWallet = reinterpret_cast<TariWallet *>(lWallet);
+    auto *pTable = new TxTable();
+    pTable->complete = true;
+    forEachWalletTx(pWallet, r, [pTable](const TxRecord &record) {
+        pTable->add(record, kTxTableInserted);
+    });
+    setErrorCode(jEnv, error, i);
+    if (i != 0) {
+        delete pTable;
+        return reinterpret_cast<jlong>(nullptr);
+    }
+    return reinterpret_cast<jlong>(pTable);
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_tari_android_wallet_ffi_FFITxTable_jniGetRowCount(
+        JNIEnv *jEnv,
+        jobject jThis) {
+    auto *pTable = reinterpret_cast<TxTable *>(GetPointerField(jEnv, jThis));
+    return pTable->rowCount();
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_tari_android_wallet_ffi_FFITxTable_jniGetTotalRowCount(
+        JNIEnv *jEnv,
+        jobject jThis) {
+    auto *pTable = reinterpret_cast<TxTable *>(GetPointerField(jEnv, jThis));
+    return pTable->totalRowCount < 0 ? pTable->rowCount() : pTable->totalRowCount;
+}
+
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_tari_android_wallet_ffi_FFITxTable_jniGetGeneration(
+        JNIEnv *jEnv,
+        jobject jThis) {
+    auto *pTable = reinterpret_cast<TxTable *>(GetPointerField(jEnv, jThis));
+    return pTable->generation;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_tari_android_wallet_ffi_FFITxTable_jniIsComplete(
+        JNIEnv *jEnv,
+        jobject jThis) {
+    auto *pTable = reinterpret_cast<TxTable *>(GetPointerField(jEnv, jThis));
+    return static_cast<jboolean>(pTable->complete);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_tari_android_wallet_ffi_FFITxTable_jniCopyLongColumn(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jint column,
+        jlongArray jOut,
+        jobject error) {
+    auto *pTable = reinterpret_cast<TxTable *>(GetPointerField(jEnv, jThis));
+    if (column < 0 || column >= kTxTableLongColumnCount
+        || jEnv->GetArrayLength(jOut) != pTable->rowCount()) {
+        setErrorCode(jEnv, error, kErrorInvalidArgument);
+        return;
+    }
+    jEnv->SetLongArrayRegion(jOut, 0, pTable->rowCount(), pTable->longColumns[column].data());
+    setErrorCode(jEnv, error, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_tari_android_wallet_ffi_FFITxTable_jniCopyIntColumn(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jint column,
+        jintArray jOut,
+        jobject error) {
+    auto *pTable = reinterpret_cast<TxTable *>(GetPointerField(jEnv, jThis));
+    if (column < 0 || column >= kTxTableIntColumnCount
+        || jEnv->GetArrayLength(jOut) != pTable->rowCount()) {
+        setErrorCode(jEnv, error, kErrorInvalidArgument);
+        return;
+    }
+    jEnv->SetIntArrayRegion(jOut, 0, pTable->rowCount(), pTable->intColumns[column].data());
+    setErrorCode(jEnv, error, 0);
+}
+
+extern "C"
+JNIEXPORT jobjectArray JNICALL
+Java_com_tari_android_wallet_ffi_FFITxTable_jniGetStrings(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jobject error) {
+    auto *pTable = reinterpret_cast<TxTable *>(GetPointerField(jEnv, jThis));
+    auto size = static_cast<jsize>(pTable->strings.size());
+    jobjectArray result = jEnv->NewObjectArray(size, g_ids.stringClass, nullptr);
+    // out of memory, the pending OutOfMemoryError is thrown on return
+    if (result == nullptr) {
+        return nullptr;
+    }
+    for (jsize index = 0; index < size; index++) {
+        const std::string &string = pTable->strings.at(static_cast<size_t>(index));
+        jstring value = newStringFromUtf8(jEnv, string.data(), string.size());
+        if (value == nullptr) {
+            return nullptr;
+        }
+        jEnv->SetObjectArrayElement(result, index, value);
+        jEnv->DeleteLocalRef(value);
+    }
+    setErrorCode(jEnv, error, 0);
+    return result;
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_tari_android_wallet_ffi_FFITxTable_jniDestroy(
+        JNIEnv *jEnv,
+        jobject jThis) {
+    delete reinterpret_cast<TxTable *>(GetPointerField(jEnv, jThis));
+    SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(nullptr));
+}
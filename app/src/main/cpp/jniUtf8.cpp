@@ -0,0 +1,249 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef JNI_UTF8_CPP
+#define JNI_UTF8_CPP
+
+#include <jni.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "jniCommon.cpp"
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * UTF-8 to UTF-16 transcoder for strings returned by the wallet library.
+ *
+ * The library returns standard UTF-8, while NewStringUTF expects modified UTF-8, in which
+ * supplementary characters (most emoji) are encoded as two 3-byte surrogates rather than one
+ * 4-byte sequence. Strings are therefore transcoded here and created with NewString.
+ *
+ * Input is consumed in 16 byte blocks where possible: an all-ASCII block is widened, a block of
+ * four 4-byte sequences (an emoji run) is turned into four surrogate pairs, NEON on arm64 and
+ * SSE2 on x86. Everything else goes through the validating scalar decoder, which replaces
+ * ill-formed sequences with U+FFFD the same way the Java UTF-8 decoder does.
+ */
+
+static const jchar kReplacementCharacter = 0xFFFD;
+
+/**
+ * Strings up to this many UTF-8 bytes are transcoded on the stack.
+ */
+static const size_t kUtf8StackBufferSize = 256;
+
+inline bool isUtf8Continuation(uint8_t byte) {
+    return (byte & 0xC0) == 0x80;
+}
+
+/**
+ * Decodes one character at utf8[0], length > 0. Writes one or two UTF-16 units to utf16 and
+ * returns the number of input bytes consumed. An ill-formed sequence consumes its maximal valid
+ * prefix (at least one byte) and produces U+FFFD.
+ */
+inline size_t decodeUtf8Character(const uint8_t *utf8, size_t length, jchar *utf16, size_t *unitCount) {
+    uint8_t lead = utf8[0];
+    *unitCount = 1;
+    if (lead < 0x80) {
+        utf16[0] = lead;
+        return 1;
+    }
+    size_t sequenceLength;
+    uint32_t codePoint;
+    uint8_t secondMin = 0x80;
+    uint8_t secondMax = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        sequenceLength = 2;
+        codePoint = lead & 0x1Fu;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        sequenceLength = 3;
+        codePoint = lead & 0x0Fu;
+        if (lead == 0xE0) {
+            secondMin = 0xA0; // overlong
+        } else if (lead == 0xED) {
+            secondMax = 0x9F; // surrogates
+        }
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        sequenceLength = 4;
+        codePoint = lead & 0x07u;
+        if (lead == 0xF0) {
+            secondMin = 0x90; // overlong
+        } else if (lead == 0xF4) {
+            secondMax = 0x8F; // above U+10FFFF
+        }
+    } else {
+        utf16[0] = kReplacementCharacter;
+        return 1;
+    }
+    size_t k = 1;
+    for (; k < sequenceLength; k++) {
+        if (k >= length) {
+            break;
+        }
+        uint8_t byte = utf8[k];
+        if (k == 1 ? (byte < secondMin || byte > secondMax) : !isUtf8Continuation(byte)) {
+            break;
+        }
+        codePoint = (codePoint << 6) | (byte & 0x3Fu);
+    }
+    if (k < sequenceLength) {
+        utf16[0] = kReplacementCharacter;
+        return k;
+    }
+    if (codePoint < 0x10000) {
+        utf16[0] = static_cast<jchar>(codePoint);
+    } else {
+        codePoint -= 0x10000;
+        utf16[0] = static_cast<jchar>(0xD800 | (codePoint >> 10));
+        utf16[1] = static_cast<jchar>(0xDC00 | (codePoint & 0x3FF));
+        *unitCount = 2;
+    }
+    return sequenceLength;
+}
+
+/**
+ * Transcodes length bytes of UTF-8 into utf16, which must have room for length units (no input
+ * byte produces more than one unit). Returns the number of units written.
+ */
+inline size_t utf8ToUtf16(const char *utf8, size_t length, jchar *utf16) {
+    const auto *input = reinterpret_cast<const uint8_t *>(utf8);
+    size_t in = 0;
+    size_t out = 0;
+    while (in < length) {
+#if defined(__aarch64__)
+        if (length - in >= 16) {
+            uint8x16_t block = vld1q_u8(input + in);
+            if (vmaxvq_u8(block) < 0x80) {
+                vst1q_u16(utf16 + out, vmovl_u8(vget_low_u8(block)));
+                vst1q_u16(utf16 + out + 8, vmovl_u8(vget_high_u8(block)));
+                in += 16;
+                out += 16;
+                continue;
+            }
+            // four 4-byte sequences: F0..F4 leads at every fourth byte, continuations elsewhere
+            uint32x4_t words = vreinterpretq_u32_u8(block);
+            uint32x4_t tagged = vandq_u32(words, vdupq_n_u32(0xC0C0C0F8u));
+            if (vminvq_u32(vceqq_u32(tagged, vdupq_n_u32(0x808080F0u))) != 0) {
+                uint32x4_t codePoints = vorrq_u32(
+                        vorrq_u32(vshlq_n_u32(vandq_u32(words, vdupq_n_u32(0x07u)), 18),
+                                  vshlq_n_u32(vandq_u32(words, vdupq_n_u32(0x3F00u)), 4)),
+                        vorrq_u32(vshrq_n_u32(vandq_u32(words, vdupq_n_u32(0x3F0000u)), 10),
+                                  vandq_u32(vshrq_n_u32(words, 24), vdupq_n_u32(0x3Fu))));
+                uint32x4_t inRange = vandq_u32(vcgeq_u32(codePoints, vdupq_n_u32(0x10000u)),
+                                               vcleq_u32(codePoints, vdupq_n_u32(0x10FFFFu)));
+                if (vminvq_u32(inRange) != 0) {
+                    uint32x4_t offset = vsubq_u32(codePoints, vdupq_n_u32(0x10000u));
+                    uint32x4_t high = vorrq_u32(vshrq_n_u32(offset, 10), vdupq_n_u32(0xD800u));
+                    uint32x4_t low = vorrq_u32(vandq_u32(offset, vdupq_n_u32(0x3FFu)), vdupq_n_u32(0xDC00u));
+                    vst1q_u16(utf16 + out, vreinterpretq_u16_u32(vorrq_u32(high, vshlq_n_u32(low, 16))));
+                    in += 16;
+                    out += 8;
+                    continue;
+                }
+            }
+        }
+#elif defined(__SSE2__)
+        if (length - in >= 16) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + in));
+            if (_mm_movemask_epi8(block) == 0) {
+                __m128i zero = _mm_setzero_si128();
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(utf16 + out), _mm_unpacklo_epi8(block, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(utf16 + out + 8), _mm_unpackhi_epi8(block, zero));
+                in += 16;
+                out += 16;
+                continue;
+            }
+            // four 4-byte sequences: F0..F4 leads at every fourth byte, continuations elsewhere
+            __m128i tagged = _mm_and_si128(block, _mm_set1_epi32(static_cast<int>(0xC0C0C0F8u)));
+            __m128i isEmojiRun = _mm_cmpeq_epi32(tagged, _mm_set1_epi32(static_cast<int>(0x808080F0u)));
+            if (_mm_movemask_epi8(isEmojiRun) == 0xFFFF) {
+                __m128i codePoints = _mm_or_si128(
+                        _mm_or_si128(_mm_slli_epi32(_mm_and_si128(block, _mm_set1_epi32(0x07)), 18),
+                                     _mm_slli_epi32(_mm_and_si128(block, _mm_set1_epi32(0x3F00)), 4)),
+                        _mm_or_si128(_mm_srli_epi32(_mm_and_si128(block, _mm_set1_epi32(0x3F0000)), 10),
+                                     _mm_and_si128(_mm_srli_epi32(block, 24), _mm_set1_epi32(0x3F))));
+                // code points are below 2^21, so the signed compares are exact
+                __m128i outOfRange = _mm_or_si128(
+                        _mm_cmplt_epi32(codePoints, _mm_set1_epi32(0x10000)),
+                        _mm_cmpgt_epi32(codePoints, _mm_set1_epi32(0x10FFFF)));
+                if (_mm_movemask_epi8(outOfRange) == 0) {
+                    __m128i offset = _mm_sub_epi32(codePoints, _mm_set1_epi32(0x10000));
+                    __m128i high = _mm_or_si128(_mm_srli_epi32(offset, 10), _mm_set1_epi32(0xD800));
+                    __m128i low = _mm_or_si128(_mm_and_si128(offset, _mm_set1_epi32(0x3FF)), _mm_set1_epi32(0xDC00));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(utf16 + out),
+                                     _mm_or_si128(high, _mm_slli_epi32(low, 16)));
+                    in += 16;
+                    out += 8;
+                    continue;
+                }
+            }
+        }
+#endif
+        if (input[in] < 0x80) {
+            utf16[out++] = input[in++];
+            continue;
+        }
+        size_t unitCount;
+        in += decodeUtf8Character(input + in, length - in, utf16 + out, &unitCount);
+        out += unitCount;
+    }
+    return out;
+}
+
+/**
+ * Replacement for NewStringUTF on standard UTF-8 from the wallet library. Returns nullptr for a
+ * null input, like NewStringUTF does.
+ */
+inline jstring newStringFromUtf8(JNIEnv *jEnv, const char *utf8, size_t length) {
+    if (utf8 == nullptr) {
+        return nullptr;
+    }
+    if (length <= kUtf8StackBufferSize) {
+        jchar utf16[kUtf8StackBufferSize];
+        size_t unitCount = utf8ToUtf16(utf8, length, utf16);
+        return jEnv->NewString(utf16, static_cast<jsize>(unitCount));
+    }
+    std::vector<jchar> utf16(length);
+    size_t unitCount = utf8ToUtf16(utf8, length, utf16.data());
+    return jEnv->NewString(utf16.data(), static_cast<jsize>(unitCount));
+}
+
+inline jstring newStringFromUtf8(JNIEnv *jEnv, const char *utf8) {
+    return newStringFromUtf8(jEnv, utf8, utf8 == nullptr ? 0 : strlen(utf8));
+}
+
+#endif // JNI_UTF8_CPP
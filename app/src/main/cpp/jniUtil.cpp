@@ -32,6 +32,14 @@
  */
 #include <wallet.h>
 #include "jniCommon.cpp"
+#include "jniEmojiTable.cpp"
+#include "jniUtf8.cpp"
+#include <vector>
+
+HandleStats g_handleStats;
+FfiTrace g_ffiTrace;
+CallStats g_callStats;
+Timeline g_timeline;
 
 extern "C"
 JNIEXPORT void JNICALL
@@ -51,3 +59,277 @@ Java_com_tari_android_wallet_ffi_FFIUtil_jniDoPartialBackup(
     jEnv->ReleaseStringUTFChars(jBackupFileTargetPath, pTargetPath);
 }
 
+
+/**
+ * Microbenchmark for the pointer field access done by every entry point. Reads the pointer
+ * field of the target `iterations` times, either through the cached registry field ID or by
+ * resolving the class and field ID on each read as the entry points used to, and returns the
+ * elapsed time in nanoseconds.
+ */
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_tari_android_wallet_ffi_FFIUtil_jniMeasurePointerAccess(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jobject jTarget,
+        jint iterations,
+        jboolean cached) {
+    volatile jlong sink = 0;
+    jlong start = nowNanos();
+    if (cached) {
+        for (jint n = 0; n < iterations; n++) {
+            sink = GetPointerField(jEnv, jTarget);
+        }
+    } else {
+        for (jint n = 0; n < iterations; n++) {
+            jclass cls = jEnv->GetObjectClass(jTarget);
+            jfieldID fid = jEnv->GetFieldID(cls, "pointer", "J");
+            sink = jEnv->GetLongField(jTarget, fid);
+            jEnv->DeleteLocalRef(cls);
+        }
+    }
+    (void) sink;
+    return nowNanos() - start;
+}
+
+/**
+ * Returns {static registration enabled (0 or 1), JNI_OnLoad duration in nanoseconds,
+ * number of registered native methods}.
+ */
+extern "C"
+JNIEXPORT jlongArray JNICALL
+Java_com_tari_android_wallet_ffi_FFIUtil_jniGetLoadStats(
+        JNIEnv *jEnv,
+        jobject jThis) {
+    jlong stats[] = {
+            TARI_JNI_STATIC_REGISTRATION,
+            g_loadStats.onLoadNanos,
+            g_loadStats.registeredMethodCount
+    };
+    jlongArray result = jEnv->NewLongArray(3);
+    jEnv->SetLongArrayRegion(result, 0, 3, stats);
+    return result;
+}
+
+/**
+ * The whole emoji alphabet in index order from the compiled-in table, in one call. Every emoji
+ * lies outside the BMP, so each string is one UTF-16 surrogate pair.
+ */
+extern "C"
+JNIEXPORT jobjectArray JNICALL
+Java_com_tari_android_wallet_ffi_FFIUtil_jniGetEmojiAlphabet(
+        JNIEnv *jEnv,
+        jobject jThis) {
+    jobjectArray result = jEnv->NewObjectArray(kEmojiAlphabetSize, g_ids.stringClass, nullptr);
+    if (result == nullptr) {
+        return nullptr;
+    }
+    for (int index = 0; index < kEmojiAlphabetSize; index++) {
+        char32_t offset = kEmojiAlphabet[index] - 0x10000;
+        const jchar units[] = {
+                static_cast<jchar>(0xD800 + (offset >> 10)),
+                static_cast<jchar>(0xDC00 + (offset & 0x3FF))
+        };
+        jstring emoji = jEnv->NewString(units, 2);
+        if (emoji == nullptr) {
+            return nullptr;
+        }
+        jEnv->SetObjectArrayElement(result, index, emoji);
+        jEnv->DeleteLocalRef(emoji);
+    }
+    return result;
+}
+
+/**
+ * Decodes standard UTF-8 bytes with the transcoder used for the strings returned by the wallet
+ * library.
+ */
+extern "C"
+JNIEXPORT jstring JNICALL
+Java_com_tari_android_wallet_ffi_FFIUtil_jniDecodeUtf8(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jbyteArray jUtf8) {
+    jsize length = jEnv->GetArrayLength(jUtf8);
+    std::vector<char> utf8(static_cast<size_t>(length));
+    jEnv->GetByteArrayRegion(jUtf8, 0, length, reinterpret_cast<jbyte *>(utf8.data()));
+    return newStringFromUtf8(jEnv, utf8.data(), utf8.size());
+}
+
+/**
+ * Microbenchmark for string creation from UTF-8 bytes. Creates the string `iterations` times,
+ * either through the transcoder and NewString, or through NewStringUTF on the same text
+ * re-encoded as modified UTF-8 beforehand (what NewStringUTF needs for supplementary
+ * characters to come out right), and returns the elapsed time in nanoseconds.
+ */
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_tari_android_wallet_ffi_FFIUtil_jniMeasureStringCreation(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jbyteArray jUtf8,
+        jint iterations,
+        jboolean transcoded) {
+    jsize length = jEnv->GetArrayLength(jUtf8);
+    std::vector<char> utf8(static_cast<size_t>(length));
+    jEnv->GetByteArrayRegion(jUtf8, 0, length, reinterpret_cast<jbyte *>(utf8.data()));
+    std::vector<char> modifiedUtf8;
+    if (!transcoded) {
+        std::vector<jchar> utf16(utf8.size());
+        size_t unitCount = utf8ToUtf16(utf8.data(), utf8.size(), utf16.data());
+        for (size_t k = 0; k < unitCount; k++) {
+            jchar unit = utf16[k];
+            if (unit != 0 && unit < 0x80) {
+                modifiedUtf8.push_back(static_cast<char>(unit));
+            } else if (unit < 0x800) {
+                modifiedUtf8.push_back(static_cast<char>(0xC0 | (unit >> 6)));
+                modifiedUtf8.push_back(static_cast<char>(0x80 | (unit & 0x3F)));
+            } else {
+                modifiedUtf8.push_back(static_cast<char>(0xE0 | (unit >> 12)));
+                modifiedUtf8.push_back(static_cast<char>(0x80 | ((unit >> 6) & 0x3F)));
+                modifiedUtf8.push_back(static_cast<char>(0x80 | (unit & 0x3F)));
+            }
+        }
+        modifiedUtf8.push_back('\0');
+    }
+    jlong start = nowNanos();
+    for (jint n = 0; n < iterations; n++) {
+        jstring string = transcoded
+                         ? newStringFromUtf8(jEnv, utf8.data(), utf8.size())
+                         : jEnv->NewStringUTF(modifiedUtf8.data());
+        jEnv->DeleteLocalRef(string);
+    }
+    return nowNanos() - start;
+}
+
+/**
+ * Returns kHandleCounterCount counters per handle type in HandleType order: created, destroyed,
+ * live, high-water mark.
+ */
+extern "C"
+JNIEXPORT jlongArray JNICALL
+Java_com_tari_android_wallet_ffi_FFIUtil_jniGetHandleStats(
+        JNIEnv *jEnv,
+        jobject jThis) {
+    jlong values[kHandleTypeCount * kHandleCounterCount];
+    g_handleStats.getCounters(values);
+    jlongArray result = jEnv->NewLongArray(kHandleTypeCount * kHandleCounterCount);
+    jEnv->SetLongArrayRegion(result, 0, kHandleTypeCount * kHandleCounterCount, values);
+    return result;
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_tari_android_wallet_ffi_FFIUtil_jniSetHandleSiteRecording(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jboolean enabled) {
+    g_handleStats.setRecordingSites(enabled != JNI_FALSE);
+}
+
+/**
+ * Logs the handle report and returns it.
+ */
+extern "C"
+JNIEXPORT jstring JNICALL
+Java_com_tari_android_wallet_ffi_FFIUtil_jniDumpHandleStats(
+        JNIEnv *jEnv,
+        jobject jThis) {
+    std::string report = g_handleStats.dump();
+    LOGI("%s", report.c_str());
+    return jEnv->NewStringUTF(report.c_str());
+}
+
+/**
+ * Starts recording the wallet_* calls and callbacks into a new trace file at jPath. Returns false
+ * if native-lib was built without TARI_JNI_FFI_TRACE, a trace is already being recorded or the
+ * file cannot be created.
+ */
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_tari_android_wallet_ffi_FFIUtil_jniStartFfiTrace(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jstring jPath,
+        jboolean captureStrings) {
+#if TARI_JNI_FFI_TRACE
+    const char *pPath = jEnv->GetStringUTFChars(jPath, JNI_FALSE);
+    bool started = g_ffiTrace.start(pPath, captureStrings != JNI_FALSE);
+    if (!started) {
+        LOGE("Cannot start FFI trace at %s.", pPath);
+    }
+    jEnv->ReleaseStringUTFChars(jPath, pPath);
+    return static_cast<jboolean>(started);
+#else
+    LOGE("native-lib was built without TARI_JNI_FFI_TRACE.");
+    return static_cast<jboolean>(false);
+#endif
+}
+
+/**
+ * Stops the trace and returns its size in bytes, or -1 if none was being recorded or it could not
+ * be written completely.
+ */
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_tari_android_wallet_ffi_FFIUtil_jniStopFfiTrace(
+        JNIEnv *jEnv,
+        jobject jThis) {
+    return static_cast<jlong>(g_ffiTrace.stop());
+}
+
+/**
+ * Logs the call counters and latency percentiles of the entry points and wallet callbacks, merged
+ * over all threads, and returns them.
+ */
+extern "C"
+JNIEXPORT jstring JNICALL
+Java_com_tari_android_wallet_ffi_FFIUtil_jniDumpCallStats(
+        JNIEnv *jEnv,
+        jobject jThis) {
+#if TARI_JNI_CALL_STATS
+    std::string report = g_callStats.dump(kJniEntryNames, kJniEntryCount);
+    LOGI("%s", report.c_str());
+#else
+    std::string report = "native-lib was built without TARI_JNI_CALL_STATS.\n";
+#endif
+    return jEnv->NewStringUTF(report.c_str());
+}
+
+/**
+ * Switches the recording of the timeline on or off. Returns false if native-lib was built without
+ * TARI_JNI_TIMELINE.
+ */
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_tari_android_wallet_ffi_FFIUtil_jniSetTimelineRecording(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jboolean enabled) {
+#if TARI_JNI_TIMELINE
+    g_timeline.setRecording(enabled != JNI_FALSE);
+    return static_cast<jboolean>(true);
+#else
+    LOGE("native-lib was built without TARI_JNI_TIMELINE.");
+    return static_cast<jboolean>(false);
+#endif
+}
+
+/**
+ * Flushes the timeline recorded so far into a Chrome trace JSON file at jPath. Returns the number
+ * of events written, or -1 if the file cannot be written.
+ */
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_tari_android_wallet_ffi_FFIUtil_jniWriteTimeline(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jstring jPath) {
+    const char *pPath = jEnv->GetStringUTFChars(jPath, JNI_FALSE);
+    int64_t written = g_timeline.flush(pPath);
+    if (written < 0) {
+        LOGE("Cannot write the timeline to %s.", pPath);
+    }
+    jEnv->ReleaseStringUTFChars(jPath, pPath);
+    return static_cast<jlong>(written);
+}
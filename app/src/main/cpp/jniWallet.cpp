@@ -37,24 +37,84 @@
 #include <string>
 #include <cmath>
 #include <android/log.h>
+#include <atomic>
+#include <pthread.h>
 #include "jniCommon.cpp"
+#include "jniWalletEvents.cpp"
+#include "jniTxCache.cpp"
+#include "jniUtf8.cpp"
 
 /**
  * Java virtual machine pointer for later use in callbacks.
  */
 JavaVM *g_vm;
 
+/**
+ * Class and field IDs shared by all entry points, see jniCommon.cpp.
+ */
+JniIdRegistry g_ids;
+
+LoadStats g_loadStats;
+
+/**
+ * Thread-local key marking threads attached by getJNIEnv. Its destructor detaches the thread
+ * from the VM when the thread exits.
+ */
+pthread_key_t g_attachedThreadKey;
+
+/**
+ * Callback thread attachment counters. Attached threads stay attached, so code running on them
+ * must delete the local references it creates.
+ */
+std::atomic<jlong> g_threadAttachCount(0);
+std::atomic<jlong> g_threadAttachAvoidedCount(0);
+std::atomic<jlong> g_threadDetachCount(0);
+
+void detachAttachedThread(void *) {
+    g_vm->DetachCurrentThread();
+    g_threadDetachCount++;
+}
+
+#if TARI_JNI_STATIC_REGISTRATION
+// defined in the generated jniRegistration.cpp
+jint registerNativeMethods(JNIEnv *jEnv);
+#endif
+
 /**
  * Called by the environment on JNI load.
  */
 JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *vm, void *) {
+    jlong start = nowNanos();
     g_vm = vm;
+    JNIEnv *jEnv;
+    if (vm->GetEnv(reinterpret_cast<void **>(&jEnv), JNI_VERSION_1_6) != JNI_OK) {
+        return JNI_ERR;
+    }
+    if (!initIdRegistry(jEnv)) {
+        return JNI_ERR;
+    }
+    if (pthread_key_create(&g_attachedThreadKey, detachAttachedThread) != 0) {
+        return JNI_ERR;
+    }
+#if TARI_JNI_STATIC_REGISTRATION
+    jint registered = registerNativeMethods(jEnv);
+    if (registered < 0) {
+        return JNI_ERR;
+    }
+    g_loadStats.registeredMethodCount = registered;
+#endif
+    g_loadStats.onLoadNanos = nowNanos() - start;
+    LOGI("JNI_OnLoad took %lld ns, registered %d native methods.",
+         static_cast<long long>(g_loadStats.onLoadNanos), g_loadStats.registeredMethodCount);
     return JNI_VERSION_1_6;
 }
 
 /**
  * Helper method to get JNI environment attached to the current thread.
- * Used in callback functions.
+ * Used by the wallet event dispatcher thread.
+ *
+ * Native threads are attached once as daemon threads and stay attached for their lifetime;
+ * the thread-local key destructor detaches them on exit.
  */
 JNIEnv *getJNIEnv() {
     JNIEnv *jniEnv;
@@ -62,9 +122,18 @@ JNIEnv *getJNIEnv() {
     int getEnvStat = g_vm->GetEnv((void **) &jniEnv, JNI_VERSION_1_6);
     switch (getEnvStat) {
         case JNI_EDETACHED: {
-            if (g_vm->AttachCurrentThread(&jniEnv, nullptr) != 0) {
+            JavaVMAttachArgs args{JNI_VERSION_1_6, "TariWalletCallback", nullptr};
+#ifdef __ANDROID__
+            JNIEnv **pEnv = &jniEnv;
+#else
+            // the JDK's jni.h, used by the host build, declares the out parameter as void **
+            void **pEnv = reinterpret_cast<void **>(&jniEnv);
+#endif
+            if (g_vm->AttachCurrentThreadAsDaemon(pEnv, &args) != 0) {
                 LOGE("VM failed to attach.");
             } else {
+                pthread_setspecific(g_attachedThreadKey, jniEnv);
+                g_threadAttachCount++;
                 result = jniEnv;
             }
             break;
@@ -74,6 +143,7 @@ JNIEnv *getJNIEnv() {
             break;
         }
         default:
+            g_threadAttachAvoidedCount++;
             result = jniEnv;
     }
     return result;
@@ -83,191 +153,223 @@ JNIEnv *getJNIEnv() {
 // Wallet is a singleton so only one of each is needed, should wallet be a class these would
 // have to be arrays with some means to track which wallet maps to which functions
 jobject callbackHandler = nullptr;
-jmethodID txReceivedCallbackMethodId;
-jmethodID txReplyReceivedCallbackMethodId;
-jmethodID txFinalizedCallbackMethodId;
-jmethodID txBroadcastCallbackMethodId;
-jmethodID txMinedCallbackMethodId;
-jmethodID txMinedUnconfirmedCallbackMethodId;
-jmethodID directSendResultCallbackMethodId;
-jmethodID storeAndForwardSendResultCallbackMethodId;
-jmethodID txCancellationCallbackMethodId;
-jmethodID txoValidationCompleteCallbackMethodId;
-jmethodID transactionValidationCompleteCallbackMethodId;
-jmethodID recoveringProcessCompleteCallbackMethodId;
+jmethodID eventsCallbackMethodId;
+WalletEventDispatcher g_eventDispatcher;
+TxChangeCache g_txCache;
 
-void txBroadcastCallback(struct TariCompletedTransaction *pCompletedTransaction) {
-    auto *jniEnv = getJNIEnv();
-    if (jniEnv == nullptr || callbackHandler == nullptr) {
-        return;
+/**
+ * Feeds the tx cache from the tx handles of a batch, on the dispatcher thread before the batch
+ * is delivered, so the wallet library's callback threads only post and the cache is current when
+ * the listeners see the event. A tx that cannot be read leaves the cache to re-read the wallet
+ * on its next use. Mined-unconfirmed updates dropped on a full ring are followed by a newer one.
+ */
+void recordEventTxs(const WalletEvent *events, size_t count) {
+    std::vector<TxRecord> records;
+    records.reserve(count);
+    bool unreadable = false;
+    for (size_t n = 0; n < count; n++) {
+        const WalletEvent &event = events[n];
+        int i = 0;
+        switch (event.type) {
+            case kEventTxReceived:
+                records.push_back(txRecordFromPendingInbound(
+                        reinterpret_cast<TariPendingInboundTransaction *>(event.arg0), &i));
+                break;
+            case kEventTxReplyReceived:
+            case kEventTxFinalized:
+            case kEventTxBroadcast:
+            case kEventTxMined:
+            case kEventTxMinedUnconfirmed:
+                records.push_back(txRecordFromCompleted(
+                        reinterpret_cast<TariCompletedTransaction *>(event.arg0),
+                        kTxTableCompleted, &i));
+                break;
+            case kEventTxCancelled:
+                records.push_back(txRecordFromCompleted(
+                        reinterpret_cast<TariCompletedTransaction *>(event.arg0),
+                        kTxTableCancelled, &i));
+                break;
+            default:
+                continue;
+        }
+        if (i != 0) {
+            records.pop_back();
+            unreadable = true;
+        }
+    }
+    g_txCache.record(records);
+    if (unreadable) {
+        g_txCache.markStale();
     }
-    auto jpCompletedTransaction = reinterpret_cast<jlong>(pCompletedTransaction);
-    jniEnv->CallVoidMethod(
-            callbackHandler,
-            txBroadcastCallbackMethodId,
-            jpCompletedTransaction);
-    g_vm->DetachCurrentThread();
 }
 
-void txMinedCallback(struct TariCompletedTransaction *pCompletedTransaction) {
-    auto *jniEnv = getJNIEnv();
-    if (jniEnv == nullptr || callbackHandler == nullptr) {
-        return;
+/**
+ * Records a tx created or changed by an entry point rather than announced by a callback.
+ */
+void refreshCachedTx(TariWallet *pWallet, unsigned long long id, TxTableKind kind) {
+    int i = 0;
+    if (kind == kTxTablePendingOutbound) {
+        TariPendingOutboundTransaction *pTx = wallet_get_pending_outbound_transaction_by_id(pWallet, id, &i);
+        if (pTx != nullptr) {
+            TxRecord record = txRecordFromPendingOutbound(pTx, &i);
+            pending_outbound_transaction_destroy(pTx);
+            if (i == 0) {
+                g_txCache.record(record);
+                return;
+            }
+        }
+    } else {
+        TariCompletedTransaction *pTx = kind == kTxTableCancelled
+                                        ? wallet_get_cancelled_transaction_by_id(pWallet, id, &i)
+                                        : wallet_get_completed_transaction_by_id(pWallet, id, &i);
+        if (pTx != nullptr) {
+            TxRecord record = txRecordFromCompleted(pTx, kind, &i);
+            completed_transaction_destroy(pTx);
+            if (i == 0) {
+                g_txCache.record(record);
+                return;
+            }
+        }
     }
-    auto jpCompletedTransaction = reinterpret_cast<jlong>(pCompletedTransaction);
-    jniEnv->CallVoidMethod(
-            callbackHandler,
-            txMinedCallbackMethodId,
-            jpCompletedTransaction);
-    g_vm->DetachCurrentThread();
+    g_txCache.markStale();
+}
+
+/**
+ * Keeps the search aliases in step with a contact that was just saved or removed. A contact that
+ * cannot be read leaves the aliases to be re-read with the wallet.
+ */
+void refreshCachedAlias(TariContact *pContact, bool removed) {
+    int i = 0;
+    std::string alias = removed ? std::string() : takeMessage(contact_get_alias(pContact, &i));
+    std::string publicKeyHex = takePublicKeyHex(contact_get_public_key(pContact, &i), &i);
+    if (i == 0) {
+        g_txCache.setAlias(publicKeyHex, alias);
+    } else {
+        g_txCache.markStale();
+    }
+}
+
+void txBroadcastCallback(struct TariCompletedTransaction *pCompletedTransaction) {
+    CALL_STATS_CALLBACK(kFfiCallbackTxBroadcast);
+    TIMELINE_SCOPE(kTimelineCallback, kFfiCallbackNames[kFfiCallbackTxBroadcast]);
+    TRACK_HANDLE(pCompletedTransaction);
+    FFI_TRACE_CALLBACK(kFfiCallbackTxBroadcast, pCompletedTransaction);
+    g_eventDispatcher.post(kEventTxBroadcast, reinterpret_cast<jlong>(pCompletedTransaction));
+}
+
+void txMinedCallback(struct TariCompletedTransaction *pCompletedTransaction) {
+    CALL_STATS_CALLBACK(kFfiCallbackTxMined);
+    TIMELINE_SCOPE(kTimelineCallback, kFfiCallbackNames[kFfiCallbackTxMined]);
+    TRACK_HANDLE(pCompletedTransaction);
+    FFI_TRACE_CALLBACK(kFfiCallbackTxMined, pCompletedTransaction);
+    g_eventDispatcher.supersedeConfirmation(pCompletedTransaction);
+    g_eventDispatcher.post(kEventTxMined, reinterpret_cast<jlong>(pCompletedTransaction));
 }
 
 void txMinedUnconfirmedCallback(struct TariCompletedTransaction *pCompletedTransaction,
                                 unsigned long long confirmationCount) {
-    auto *jniEnv = getJNIEnv();
-    if (jniEnv == nullptr || callbackHandler == nullptr) {
+    CALL_STATS_CALLBACK(kFfiCallbackTxMinedUnconfirmed);
+    TIMELINE_SCOPE(kTimelineCallback, kFfiCallbackNames[kFfiCallbackTxMinedUnconfirmed]);
+    TRACK_HANDLE(pCompletedTransaction);
+    FFI_TRACE_CALLBACK(kFfiCallbackTxMinedUnconfirmed, pCompletedTransaction, confirmationCount);
+    int i = 0;
+    unsigned long long txId = completed_transaction_get_transaction_id(pCompletedTransaction, &i);
+    if (i != 0) {
+        g_eventDispatcher.post(
+                kEventTxMinedUnconfirmed,
+                reinterpret_cast<jlong>(pCompletedTransaction),
+                static_cast<jlong>(confirmationCount));
         return;
     }
-    jbyteArray bytes = getBytesFromUnsignedLongLong(jniEnv, confirmationCount);
-    auto jpCompletedTransaction = reinterpret_cast<jlong>(pCompletedTransaction);
-    jniEnv->CallVoidMethod(
-            callbackHandler,
-            txMinedUnconfirmedCallbackMethodId,
-            jpCompletedTransaction,
-            bytes);
-    g_vm->DetachCurrentThread();
+    g_eventDispatcher.postConfirmation(
+            static_cast<jlong>(txId),
+            reinterpret_cast<jlong>(pCompletedTransaction),
+            static_cast<jlong>(confirmationCount));
 }
 
 void txReceivedCallback(struct TariPendingInboundTransaction *pPendingInboundTransaction) {
-    auto *jniEnv = getJNIEnv();
-    if (jniEnv == nullptr || callbackHandler == nullptr) {
-        return;
-    }
-    auto jpPendingInboundTransaction = reinterpret_cast<jlong>(pPendingInboundTransaction);
-    jniEnv->CallVoidMethod(
-            callbackHandler,
-            txReceivedCallbackMethodId,
-            jpPendingInboundTransaction);
-    g_vm->DetachCurrentThread();
+    CALL_STATS_CALLBACK(kFfiCallbackTxReceived);
+    TIMELINE_SCOPE(kTimelineCallback, kFfiCallbackNames[kFfiCallbackTxReceived]);
+    TRACK_HANDLE(pPendingInboundTransaction);
+    FFI_TRACE_CALLBACK(kFfiCallbackTxReceived, pPendingInboundTransaction);
+    g_eventDispatcher.post(kEventTxReceived, reinterpret_cast<jlong>(pPendingInboundTransaction));
 }
 
 void txReplyReceivedCallback(struct TariCompletedTransaction *pCompletedTransaction) {
-    auto *jniEnv = getJNIEnv();
-    if (jniEnv == nullptr || callbackHandler == nullptr) {
-        return;
-    }
-    auto jpCompletedTransaction = reinterpret_cast<jlong>(pCompletedTransaction);
-    jniEnv->CallVoidMethod(
-            callbackHandler,
-            txReplyReceivedCallbackMethodId,
-            jpCompletedTransaction);
-    g_vm->DetachCurrentThread();
+    CALL_STATS_CALLBACK(kFfiCallbackTxReplyReceived);
+    TIMELINE_SCOPE(kTimelineCallback, kFfiCallbackNames[kFfiCallbackTxReplyReceived]);
+    TRACK_HANDLE(pCompletedTransaction);
+    FFI_TRACE_CALLBACK(kFfiCallbackTxReplyReceived, pCompletedTransaction);
+    g_eventDispatcher.post(kEventTxReplyReceived, reinterpret_cast<jlong>(pCompletedTransaction));
 }
 
 void txFinalizedCallback(struct TariCompletedTransaction *pCompletedTransaction) {
-    auto *jniEnv = getJNIEnv();
-    if (jniEnv == nullptr || callbackHandler == nullptr) {
-        return;
-    }
-    auto jpCompletedTransaction = reinterpret_cast<jlong>(pCompletedTransaction);
-    jniEnv->CallVoidMethod(
-            callbackHandler,
-            txFinalizedCallbackMethodId,
-            jpCompletedTransaction);
-    g_vm->DetachCurrentThread();
+    CALL_STATS_CALLBACK(kFfiCallbackTxFinalized);
+    TIMELINE_SCOPE(kTimelineCallback, kFfiCallbackNames[kFfiCallbackTxFinalized]);
+    TRACK_HANDLE(pCompletedTransaction);
+    FFI_TRACE_CALLBACK(kFfiCallbackTxFinalized, pCompletedTransaction);
+    g_eventDispatcher.post(kEventTxFinalized, reinterpret_cast<jlong>(pCompletedTransaction));
 }
 
 void txDirectSendResultCallback(unsigned long long txId, bool success) {
-    auto *jniEnv = getJNIEnv();
-    if (jniEnv == nullptr || callbackHandler == nullptr) {
-        return;
-    }
-    jbyteArray bytes = getBytesFromUnsignedLongLong(jniEnv, txId);
-    jniEnv->CallVoidMethod(
-            callbackHandler,
-            directSendResultCallbackMethodId,
-            bytes,
-            success);
-    g_vm->DetachCurrentThread();
+    CALL_STATS_CALLBACK(kFfiCallbackDirectSendResult);
+    TIMELINE_SCOPE(kTimelineCallback, kFfiCallbackNames[kFfiCallbackDirectSendResult]);
+    FFI_TRACE_CALLBACK(kFfiCallbackDirectSendResult, txId, success);
+    g_eventDispatcher.post(kEventDirectSendResult, static_cast<jlong>(txId), success);
 }
 
 void txStoreAndForwardSendResultCallback(unsigned long long txId, bool success) {
-    auto *jniEnv = getJNIEnv();
-    if (jniEnv == nullptr || callbackHandler == nullptr) {
-        return;
-    }
-    jbyteArray bytes = getBytesFromUnsignedLongLong(jniEnv, txId);
-    jniEnv->CallVoidMethod(
-            callbackHandler,
-            storeAndForwardSendResultCallbackMethodId,
-            bytes,
-            success);
-    g_vm->DetachCurrentThread();
+    CALL_STATS_CALLBACK(kFfiCallbackStoreAndForwardSendResult);
+    TIMELINE_SCOPE(kTimelineCallback, kFfiCallbackNames[kFfiCallbackStoreAndForwardSendResult]);
+    FFI_TRACE_CALLBACK(kFfiCallbackStoreAndForwardSendResult, txId, success);
+    g_eventDispatcher.post(kEventStoreAndForwardSendResult, static_cast<jlong>(txId), success);
 }
 
 void txCancellationCallback(struct TariCompletedTransaction *pCompletedTransaction) {
-    auto *jniEnv = getJNIEnv();
-    if (jniEnv == nullptr || callbackHandler == nullptr) {
-        return;
-    }
-    auto jpCompletedTransaction = reinterpret_cast<jlong>(pCompletedTransaction);
-    jniEnv->CallVoidMethod(
-            callbackHandler,
-            txCancellationCallbackMethodId,
-            jpCompletedTransaction);
-    g_vm->DetachCurrentThread();
+    CALL_STATS_CALLBACK(kFfiCallbackTxCancelled);
+    TIMELINE_SCOPE(kTimelineCallback, kFfiCallbackNames[kFfiCallbackTxCancelled]);
+    TRACK_HANDLE(pCompletedTransaction);
+    FFI_TRACE_CALLBACK(kFfiCallbackTxCancelled, pCompletedTransaction);
+    g_eventDispatcher.supersedeConfirmation(pCompletedTransaction);
+    g_eventDispatcher.post(kEventTxCancelled, reinterpret_cast<jlong>(pCompletedTransaction));
 }
 
 void txoValidationCompleteCallback(unsigned long long requestId, unsigned char result) {
-    auto *jniEnv = getJNIEnv();
-    if (jniEnv == nullptr || callbackHandler == nullptr) {
-        return;
-    }
-    jbyteArray requestIdBytes = getBytesFromUnsignedLongLong(jniEnv, requestId);
-    jniEnv->CallVoidMethod(
-            callbackHandler,
-            txoValidationCompleteCallbackMethodId,
-            requestIdBytes,
-            static_cast<jint>(result));
-    g_vm->DetachCurrentThread();
+    CALL_STATS_CALLBACK(kFfiCallbackTxoValidationComplete);
+    TIMELINE_SCOPE(kTimelineCallback, kFfiCallbackNames[kFfiCallbackTxoValidationComplete]);
+    FFI_TRACE_CALLBACK(kFfiCallbackTxoValidationComplete, requestId, result);
+    g_txCache.markStale();
+    g_eventDispatcher.post(kEventTxoValidationComplete, static_cast<jlong>(requestId), result);
 }
 
 void transactionValidationCompleteCallback(unsigned long long requestId, unsigned char result) {
-    auto *jniEnv = getJNIEnv();
-    if (jniEnv == nullptr || callbackHandler == nullptr) {
-        return;
-    }
-    jbyteArray requestIdBytes = getBytesFromUnsignedLongLong(jniEnv, requestId);
-    jniEnv->CallVoidMethod(
-            callbackHandler,
-            transactionValidationCompleteCallbackMethodId,
-            requestIdBytes,
-            static_cast<jint>(result));
-    g_vm->DetachCurrentThread();
+    CALL_STATS_CALLBACK(kFfiCallbackTxValidationComplete);
+    TIMELINE_SCOPE(kTimelineCallback, kFfiCallbackNames[kFfiCallbackTxValidationComplete]);
+    FFI_TRACE_CALLBACK(kFfiCallbackTxValidationComplete, requestId, result);
+    g_txCache.markStale();
+    g_eventDispatcher.post(kEventTxValidationComplete, static_cast<jlong>(requestId), result);
 }
 
 void storeAndForwardMessagesReceivedCallback() {
-    // no-op
+    CALL_STATS_CALLBACK(kFfiCallbackStoreAndForwardMessagesReceived);
+    TIMELINE_SCOPE(kTimelineCallback, kFfiCallbackNames[kFfiCallbackStoreAndForwardMessagesReceived]);
+    FFI_TRACE_CALLBACK(kFfiCallbackStoreAndForwardMessagesReceived);
 }
 
 void recoveringProcessCompleteCallback(unsigned char first, unsigned long long second, unsigned long long third) {
-    auto *jniEnv = getJNIEnv();
-    if (jniEnv == nullptr || callbackHandler == nullptr) {
-        return;
-    }
-    jbyteArray bytes2 = getBytesFromUnsignedLongLong(jniEnv, second);
-    jbyteArray bytes3 = getBytesFromUnsignedLongLong(jniEnv, third);
-    jniEnv->CallVoidMethod(
-            callbackHandler,
-            recoveringProcessCompleteCallbackMethodId,
-            static_cast<jint>(first),
-            bytes2,
-            bytes3);
-    g_vm->DetachCurrentThread();
+    CALL_STATS_CALLBACK(kFfiCallbackRecovery);
+    TIMELINE_SCOPE(kTimelineCallback, kFfiCallbackNames[kFfiCallbackRecovery]);
+    FFI_TRACE_CALLBACK(kFfiCallbackRecovery, first, second, third);
+    g_txCache.markStale();
+    g_eventDispatcher.post(
+            kEventRecovery,
+            first,
+            static_cast<jlong>(second),
+            static_cast<jlong>(third));
 }
 
-jmethodID getMethodId(JNIEnv *jniEnv, jobject jThis, jstring methodName, jstring methodSignature) {
-    jclass jClass = jniEnv->GetObjectClass(jThis);
+jmethodID getMethodId(JNIEnv *jniEnv, jstring methodName, jstring methodSignature) {
+    jclass jClass = g_ids.classes[kFFIWallet];
     const char *method = jniEnv->GetStringUTFChars(methodName, JNI_FALSE);
     const char *signature = jniEnv->GetStringUTFChars(methodSignature, JNI_FALSE);
     jmethodID methodId = jniEnv->GetMethodID(jClass, method, signature);
@@ -287,28 +389,8 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniCreate(
         jint rollingLogFileMaxSizeBytes,
         jstring jPassphrase,
         jobject jSeed_words,
-        jstring txReceivedCallbackMethodName,
-        jstring txReceivedCallbackMethodSignature,
-        jstring callback_received_tx_reply,
-        jstring callback_received_tx_reply_sig,
-        jstring callback_received_finalized_tx,
-        jstring callback_received_finalized_tx_sig,
-        jstring callback_tx_broadcast,
-        jstring callback_tx_broadcast_sig,
-        jstring callback_tx_mined,
-        jstring callback_tx_mined_sig,
-        jstring callback_tx_mined_unconfirmed,
-        jstring callback_tx_mined_unconfirmed_sig,
-        jstring callback_direct_send_result,
-        jstring callback_direct_send_result_sig,
-        jstring callback_store_and_forward_send_result,
-        jstring callback_store_and_forward_send_result_sig,
-        jstring callback_tx_cancellation,
-        jstring callback_tx_cancellation_sig,
-        jstring callback_txo_validation_complete,
-        jstring callback_txo_validation_complete_sig,
-        jstring callback_transaction_validation_complete,
-        jstring callback_transaction_validation_complete_sig,
+        jstring eventsCallbackMethodName,
+        jstring eventsCallbackMethodSignature,
         jobject error) {
 
     int i = 0;
@@ -316,117 +398,23 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniCreate(
     if (callbackHandler == nullptr) {
         callbackHandler = jEnv->NewGlobalRef(jThis);
     }
-    jclass jClass = jEnv->GetObjectClass(jThis);
-    if (jClass == nullptr) {
-        SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(nullptr));
-    }
-
-    txReceivedCallbackMethodId = getMethodId(
-            jEnv,
-            jThis,
-            txReceivedCallbackMethodName,
-            txReceivedCallbackMethodSignature);
-    if (txReceivedCallbackMethodId == nullptr) {
-        SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(nullptr));
-    }
-
-    txReplyReceivedCallbackMethodId = getMethodId(
-            jEnv,
-            jThis,
-            callback_received_tx_reply,
-            callback_received_tx_reply_sig);
-    if (txReplyReceivedCallbackMethodId == nullptr) {
-        SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(nullptr));
-    }
-
-    txFinalizedCallbackMethodId = getMethodId(
-            jEnv,
-            jThis,
-            callback_received_finalized_tx,
-            callback_received_finalized_tx_sig);
-    if (txFinalizedCallbackMethodId == nullptr) {
-        SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(nullptr));
-    }
-
-    txBroadcastCallbackMethodId = getMethodId(
-            jEnv,
-            jThis,
-            callback_tx_broadcast,
-            callback_tx_broadcast_sig);
-    if (txBroadcastCallbackMethodId == nullptr) {
-        SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(nullptr));
-    }
-
-    txMinedCallbackMethodId = getMethodId(
-            jEnv,
-            jThis,
-            callback_tx_mined,
-            callback_tx_mined_sig);
-    if (txMinedCallbackMethodId == nullptr) {
-        SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(nullptr));
-    }
-
-    txMinedUnconfirmedCallbackMethodId = getMethodId(
-            jEnv,
-            jThis,
-            callback_tx_mined_unconfirmed,
-            callback_tx_mined_unconfirmed_sig);
-    if (txMinedUnconfirmedCallbackMethodId == nullptr) {
-        SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(nullptr));
-    }
-
-    directSendResultCallbackMethodId = getMethodId(
-            jEnv,
-            jThis,
-            callback_direct_send_result,
-            callback_direct_send_result_sig);
-    if (directSendResultCallbackMethodId == nullptr) {
-        SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(nullptr));
-    }
-
-    storeAndForwardSendResultCallbackMethodId = getMethodId(
-            jEnv,
-            jThis,
-            callback_store_and_forward_send_result,
-            callback_store_and_forward_send_result_sig);
-    if (storeAndForwardSendResultCallbackMethodId == nullptr) {
-        SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(nullptr));
-    }
 
-    txCancellationCallbackMethodId = getMethodId(
+    eventsCallbackMethodId = getMethodId(
             jEnv,
-            jThis,
-            callback_tx_cancellation,
-            callback_tx_cancellation_sig);
-    if (txCancellationCallbackMethodId == nullptr) {
-        SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(nullptr));
-    }
-
-    txoValidationCompleteCallbackMethodId = getMethodId(
-            jEnv,
-            jThis,
-            callback_txo_validation_complete,
-            callback_txo_validation_complete_sig);
-    if (txoValidationCompleteCallbackMethodId == nullptr) {
-        SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(nullptr));
-    }
-
-    transactionValidationCompleteCallbackMethodId = getMethodId(
-            jEnv,
-            jThis,
-            callback_transaction_validation_complete,
-            callback_transaction_validation_complete_sig);
-    if (transactionValidationCompleteCallbackMethodId == nullptr) {
+            eventsCallbackMethodName,
+            eventsCallbackMethodSignature);
+    if (eventsCallbackMethodId == nullptr) {
         SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(nullptr));
+    } else {
+        g_eventDispatcher.start(getJNIEnv, callbackHandler, eventsCallbackMethodId,
+                                recordEventTxs);
     }
 
     jlong lWalletConfig = GetPointerField(jEnv, jpWalletConfig);
     auto *pWalletConfig = reinterpret_cast<TariCommsConfig *>(lWalletConfig);
 
-    const char *pLogPath = jEnv->GetStringUTFChars(jLogPath, JNI_FALSE);
-    if (strlen(pLogPath) == 0) {
-        pLogPath = nullptr;
-    }
+    const char *pLogPathChars = jEnv->GetStringUTFChars(jLogPath, JNI_FALSE);
+    const char *pLogPath = strlen(pLogPathChars) == 0 ? nullptr : pLogPathChars;
 
     const char *pPassphrase = nullptr;
     if (jPassphrase != nullptr) {
@@ -465,7 +453,19 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniCreate(
             r);
 
     setErrorCode(jEnv, error, i);
-    jEnv->ReleaseStringUTFChars(jLogPath, pLogPath);
+    jEnv->ReleaseStringUTFChars(jLogPath, pLogPathChars);
+    if (pPassphrase != nullptr) {
+        jEnv->ReleaseStringUTFChars(jPassphrase, pPassphrase);
+    }
+    if (i != 0 || pWallet == nullptr) {
+        // no wallet will call back, release the dispatcher and the handler it holds
+        g_eventDispatcher.stop();
+        g_txCache.reset();
+        jEnv->DeleteGlobalRef(callbackHandler);
+        callbackHandler = nullptr;
+    } else {
+        g_txCache.startWarming(pWallet);
+    }
     SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(pWallet));
 }
 
@@ -496,7 +496,7 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPublicKey(
 }
 
 extern "C"
-JNIEXPORT jbyteArray JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFIWallet_jniGetAvailableBalance(
         JNIEnv *jEnv,
         jobject jThis,
@@ -505,16 +505,14 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniGetAvailableBalance(
     int *r = &i;
     jlong lWallet = GetPointerField(jEnv, jThis);
     auto *pWallet = reinterpret_cast<TariWallet *>(lWallet);
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv,
-            wallet_get_available_balance(pWallet, r)
-    );
+    auto result = static_cast<jlong>(
+            wallet_get_available_balance(pWallet, r));
     setErrorCode(jEnv, error, i);
     return result;
 }
 
 extern "C"
-JNIEXPORT jbyteArray JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingIncomingBalance(
         JNIEnv *jEnv,
         jobject jThis,
@@ -523,16 +521,14 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingIncomingBalance(
     int *r = &i;
     jlong lWallet = GetPointerField(jEnv, jThis);
     auto *pWallet = reinterpret_cast<TariWallet *>(lWallet);
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv,
-            wallet_get_pending_incoming_balance(pWallet, r)
-    );
+    auto result = static_cast<jlong>(
+            wallet_get_pending_incoming_balance(pWallet, r));
     setErrorCode(jEnv, error, i);
     return result;
 }
 
 extern "C"
-JNIEXPORT jbyteArray JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingOutgoingBalance(
         JNIEnv *jEnv,
         jobject jThis,
@@ -541,10 +537,8 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingOutgoingBalance(
     int *r = &i;
     jlong lWallet = GetPointerField(jEnv, jThis);
     auto *pWallet = reinterpret_cast<TariWallet *>(lWallet);
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv,
-            wallet_get_pending_outgoing_balance(pWallet, r)
-    );
+    auto result = static_cast<jlong>(
+            wallet_get_pending_outgoing_balance(pWallet, r));
     setErrorCode(jEnv, error, i);
     return result;
 }
@@ -581,6 +575,9 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniAddUpdateContact(
             wallet_upsert_contact(pWallet, pContact, r) != 0
     ); //this is indirectly a cast from unsigned char to jboolean
     setErrorCode(jEnv, error, i);
+    if (result) {
+        refreshCachedAlias(pContact, false);
+    }
     return result;
 }
 
@@ -599,6 +596,9 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniRemoveContact(
     auto *pContact = reinterpret_cast<TariContact *>(lContact);
     auto result = static_cast<jboolean>(wallet_remove_contact(pWallet, pContact, r) != 0);
     setErrorCode(jEnv, error, i);
+    if (result) {
+        refreshCachedAlias(pContact, true);
+    }
     return result;
 }
 
@@ -632,46 +632,74 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniGetCancelledTxs(
     return reinterpret_cast<jlong>(pCanceledTxs);
 }
 
-extern "C"
-JNIEXPORT jlong JNICALL
-Java_com_tari_android_wallet_ffi_FFIWallet_jniGetCompletedTxById(
-        JNIEnv *jEnv,
-        jobject jThis,
-        jstring jTxId,
-        jobject error) {
+static jlong getCompletedTxById(JNIEnv *jEnv, jobject jThis, unsigned long long id, jobject error) {
     int i = 0;
     int *r = &i;
     jlong lWallet = GetPointerField(jEnv, jThis);
     auto *pWallet = reinterpret_cast<TariWallet *>(lWallet);
-    const char *nativeString = jEnv->GetStringUTFChars(jTxId, JNI_FALSE);
-    char *pEnd;
-    unsigned long long id = strtoull(nativeString, &pEnd, 10);
     auto result = reinterpret_cast<jlong>(wallet_get_completed_transaction_by_id(pWallet, id, r));
-    jEnv->ReleaseStringUTFChars(jTxId, nativeString);
     setErrorCode(jEnv, error, i);
     return result;
 }
 
 extern "C"
 JNIEXPORT jlong JNICALL
-Java_com_tari_android_wallet_ffi_FFIWallet_jniGetCancelledTxById(
+Java_com_tari_android_wallet_ffi_FFIWallet_jniGetCompletedTxByIdU64(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jlong jTxId,
+        jobject error) {
+    return getCompletedTxById(jEnv, jThis, static_cast<unsigned long long>(jTxId), error);
+}
+
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniGetCompletedTxById(
         JNIEnv *jEnv,
         jobject jThis,
         jstring jTxId,
         jobject error) {
+    unsigned long long id;
+    if (!parseUnsignedLongLong(jEnv, jTxId, &id, error)) {
+        return 0;
+    }
+    return getCompletedTxById(jEnv, jThis, id, error);
+}
+
+static jlong getCancelledTxById(JNIEnv *jEnv, jobject jThis, unsigned long long id, jobject error) {
     int i = 0;
     int *r = &i;
     jlong lWallet = GetPointerField(jEnv, jThis);
     auto *pWallet = reinterpret_cast<TariWallet *>(lWallet);
-    const char *nativeString = jEnv->GetStringUTFChars(jTxId, JNI_FALSE);
-    char *pEnd;
-    unsigned long long id = strtoull(nativeString, &pEnd, 10);
     auto result = reinterpret_cast<jlong>(wallet_get_cancelled_transaction_by_id(pWallet, id, r));
-    jEnv->ReleaseStringUTFChars(jTxId, nativeString);
     setErrorCode(jEnv, error, i);
     return result;
 }
 
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniGetCancelledTxByIdU64(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jlong jTxId,
+        jobject error) {
+    return getCancelledTxById(jEnv, jThis, static_cast<unsigned long long>(jTxId), error);
+}
+
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniGetCancelledTxById(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jstring jTxId,
+        jobject error) {
+    unsigned long long id;
+    if (!parseUnsignedLongLong(jEnv, jTxId, &id, error)) {
+        return 0;
+    }
+    return getCancelledTxById(jEnv, jThis, id, error);
+}
+
 extern "C"
 JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingOutboundTxs(
@@ -688,6 +716,26 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingOutboundTxs(
     return reinterpret_cast<jlong>(pPendingOutboundTransactions);
 }
 
+static jlong getPendingOutboundTxById(JNIEnv *jEnv, jobject jThis, unsigned long long id, jobject error) {
+    int i = 0;
+    int *r = &i;
+    jlong lWallet = GetPointerField(jEnv, jThis);
+    auto *pWallet = reinterpret_cast<TariWallet *>(lWallet);
+    auto result = reinterpret_cast<jlong>(wallet_get_pending_outbound_transaction_by_id(pWallet, id, r));
+    setErrorCode(jEnv, error, i);
+    return result;
+}
+
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingOutboundTxByIdU64(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jlong jTxId,
+        jobject error) {
+    return getPendingOutboundTxById(jEnv, jThis, static_cast<unsigned long long>(jTxId), error);
+}
+
 extern "C"
 JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingOutboundTxById(
@@ -695,19 +743,11 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingOutboundTxById(
         jobject jThis,
         jstring jTxId,
         jobject error) {
-    int i = 0;
-    int *r = &i;
-    jlong lWallet = GetPointerField(jEnv, jThis);
-    auto *pWallet = reinterpret_cast<TariWallet *>(lWallet);
-    const char *nativeString = jEnv->GetStringUTFChars(jTxId, JNI_FALSE);
-    char *pEnd;
-    unsigned long long id = strtoull(nativeString, &pEnd, 10);
-    auto result = reinterpret_cast<jlong>(
-            wallet_get_pending_outbound_transaction_by_id(pWallet, id, r)
-    );
-    jEnv->ReleaseStringUTFChars(jTxId, nativeString);
-    setErrorCode(jEnv, error, i);
-    return result;
+    unsigned long long id;
+    if (!parseUnsignedLongLong(jEnv, jTxId, &id, error)) {
+        return 0;
+    }
+    return getPendingOutboundTxById(jEnv, jThis, id, error);
 }
 
 extern "C"
@@ -725,6 +765,26 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingInboundTxs(
     return result;
 }
 
+static jlong getPendingInboundTxById(JNIEnv *jEnv, jobject jThis, unsigned long long id, jobject error) {
+    int i = 0;
+    int *r = &i;
+    jlong lWallet = GetPointerField(jEnv, jThis);
+    auto *pWallet = reinterpret_cast<TariWallet *>(lWallet);
+    auto result = reinterpret_cast<jlong>(wallet_get_pending_inbound_transaction_by_id(pWallet, id, r));
+    setErrorCode(jEnv, error, i);
+    return result;
+}
+
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingInboundTxByIdU64(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jlong jTxId,
+        jobject error) {
+    return getPendingInboundTxById(jEnv, jThis, static_cast<unsigned long long>(jTxId), error);
+}
+
 extern "C"
 JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingInboundTxById(
@@ -732,21 +792,36 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniGetPendingInboundTxById(
         jobject jThis,
         jstring jTxId,
         jobject error) {
+    unsigned long long id;
+    if (!parseUnsignedLongLong(jEnv, jTxId, &id, error)) {
+        return 0;
+    }
+    return getPendingInboundTxById(jEnv, jThis, id, error);
+}
+
+static jboolean cancelPendingTx(JNIEnv *jEnv, jobject jThis, unsigned long long id, jobject error) {
     int i = 0;
     int *r = &i;
     jlong lWallet = GetPointerField(jEnv, jThis);
     auto *pWallet = reinterpret_cast<TariWallet *>(lWallet);
-    const char *nativeString = jEnv->GetStringUTFChars(jTxId, JNI_FALSE);
-    char *pEnd;
-    unsigned long long id = strtoull(nativeString, &pEnd, 10);
-    auto result = reinterpret_cast<jlong>(
-            wallet_get_pending_inbound_transaction_by_id(pWallet, id, r)
-    );
-    jEnv->ReleaseStringUTFChars(jTxId, nativeString);
+    auto result = static_cast<jboolean>(wallet_cancel_pending_transaction(pWallet, id, r));
+    if (i == 0 && result) {
+        refreshCachedTx(pWallet, id, kTxTableCancelled);
+    }
     setErrorCode(jEnv, error, i);
     return result;
 }
 
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniCancelPendingTxU64(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jlong jTxId,
+        jobject error) {
+    return cancelPendingTx(jEnv, jThis, static_cast<unsigned long long>(jTxId), error);
+}
+
 extern "C"
 JNIEXPORT jboolean JNICALL
 Java_com_tari_android_wallet_ffi_FFIWallet_jniCancelPendingTx(
@@ -754,16 +829,141 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniCancelPendingTx(
         jobject jThis,
         jstring jTxId,
         jobject error) {
+    unsigned long long id;
+    if (!parseUnsignedLongLong(jEnv, jTxId, &id, error)) {
+        return static_cast<jboolean>(false);
+    }
+    return cancelPendingTx(jEnv, jThis, id, error);
+}
+
+/**
+ * Txs changed after the given cache generation, as an FFITxTable handle, see jniTxCache.cpp.
+ */
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniGetTxChangesSince(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jlong jGeneration,
+        jobject error) {
     int i = 0;
     int *r = &i;
     jlong lWallet = GetPointerField(jEnv, jThis);
     auto *pWallet = reinterpret_cast<TariWallet *>(lWallet);
-    const char *nativeString = jEnv->GetStringUTFChars(jTxId, JNI_FALSE);
-    char *pEnd;
-    unsigned long long id = strtoull(nativeString, &pEnd, 10);
-    auto result = static_cast<jboolean>(wallet_cancel_pending_transaction(pWallet, id, r));
-    jEnv->ReleaseStringUTFChars(jTxId, nativeString);
+    TxTable *pTable = g_txCache.changesSince(pWallet, jGeneration, r);
+    setErrorCode(jEnv, error, i);
+    return reinterpret_cast<jlong>(pTable);
+}
+
+/**
+ * One sorted window of the merged completed, cancelled and pending history, as an FFITxTable
+ * handle, see TxChangeCache::page.
+ */
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniGetTxPage(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jint jSortKey,
+        jboolean jDescending,
+        jint jKindMask,
+        jint jOffset,
+        jint jLimit,
+        jobject error) {
+    if (jSortKey < 0 || jSortKey >= kTxSortKeyCount || jOffset < 0 || jLimit < 0) {
+        setErrorCode(jEnv, error, kErrorInvalidArgument);
+        return reinterpret_cast<jlong>(nullptr);
+    }
+    int i = 0;
+    int *r = &i;
+    jlong lWallet = GetPointerField(jEnv, jThis);
+    auto *pWallet = reinterpret_cast<TariWallet *>(lWallet);
+    TxTable *pTable = g_txCache.page(
+            pWallet,
+            static_cast<TxSortKey>(jSortKey),
+            jDescending != JNI_FALSE,
+            jKindMask,
+            jOffset,
+            jLimit,
+            r);
+    setErrorCode(jEnv, error, i);
+    return reinterpret_cast<jlong>(pTable);
+}
+
+/**
+ * Ids of up to limit txs whose message or counterparty contact alias contains the query, ignoring
+ * ASCII case, best match first. Served from the search index of the tx cache.
+ */
+extern "C"
+JNIEXPORT jlongArray JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniSearchTxs(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jstring jQuery,
+        jint jLimit,
+        jobject error) {
+    if (jQuery == nullptr || jLimit < 0) {
+        setErrorCode(jEnv, error, kErrorInvalidArgument);
+        return nullptr;
+    }
+    int i = 0;
+    int *r = &i;
+    jlong lWallet = GetPointerField(jEnv, jThis);
+    auto *pWallet = reinterpret_cast<TariWallet *>(lWallet);
+    const char *pQuery = jEnv->GetStringUTFChars(jQuery, JNI_FALSE);
+    std::string query(pQuery);
+    jEnv->ReleaseStringUTFChars(jQuery, pQuery);
+    std::vector<unsigned long long> ids = g_txCache.search(pWallet, query, static_cast<size_t>(jLimit), r);
     setErrorCode(jEnv, error, i);
+    auto size = static_cast<jsize>(ids.size());
+    jlongArray result = jEnv->NewLongArray(size);
+    if (result != nullptr && size > 0) {
+        // tx ids are unsigned 64-bit, passed bit for bit, see UnsignedLong.kt
+        std::vector<jlong> values(ids.begin(), ids.end());
+        jEnv->SetLongArrayRegion(result, 0, size, values.data());
+    }
+    return result;
+}
+
+/**
+ * Returns {threads attached, attaches avoided, threads detached} for the callback threads.
+ */
+extern "C"
+JNIEXPORT jlongArray JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniGetCallbackStats(
+        JNIEnv *jEnv,
+        jobject jThis) {
+    jlong stats[] = {
+            g_threadAttachCount.load(),
+            g_threadAttachAvoidedCount.load(),
+            g_threadDetachCount.load()
+    };
+    jlongArray result = jEnv->NewLongArray(3);
+    jEnv->SetLongArrayRegion(result, 0, 3, stats);
+    return result;
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniSetConfirmationCoalescingWindow(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jlong windowMillis) {
+    g_eventDispatcher.setCoalescingWindow(windowMillis * 1000000LL);
+}
+
+/**
+ * Returns the event queue statistics in WalletEventStat order.
+ */
+extern "C"
+JNIEXPORT jlongArray JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniGetEventQueueStats(
+        JNIEnv *jEnv,
+        jobject jThis) {
+    jlong stats[kWalletEventStatCount];
+    g_eventDispatcher.getStats(stats);
+    jlongArray result = jEnv->NewLongArray(kWalletEventStatCount);
+    jEnv->SetLongArrayRegion(result, 0, kWalletEventStatCount, stats);
     return result;
 }
 
@@ -773,93 +973,144 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniDestroy(
         JNIEnv *jEnv,
         jobject jThis) {
     jlong lWallet = GetPointerField(jEnv, jThis);
+    // the warm-up thread reads the wallet
+    g_txCache.stopWarming();
+    wallet_destroy(reinterpret_cast<TariWallet *>(lWallet));
+    // the wallet no longer produces callbacks, so the dispatcher can be stopped before the
+    // handler it calls into is released
+    g_eventDispatcher.stop();
+    g_txCache.reset();
     jEnv->DeleteGlobalRef(callbackHandler);
     callbackHandler = nullptr;
-    wallet_destroy(reinterpret_cast<TariWallet *>(lWallet));
     SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(nullptr));
 }
 
 //endregion
 
-extern "C"
-JNIEXPORT jbyteArray JNICALL
-Java_com_tari_android_wallet_ffi_FFIWallet_jniEstimateTxFee(
+static jlong estimateTxFee(
         JNIEnv *jEnv,
         jobject jThis,
-        jstring jamount,
-        jstring jgramFee,
-        jstring jkernelCount,
-        jstring joutputCount,
+        unsigned long long amount,
+        unsigned long long gramFee,
+        unsigned long long kernels,
+        unsigned long long outputs,
         jobject error) {
     int i = 0;
     int *r = &i;
     jlong lWallet = GetPointerField(jEnv, jThis);
     auto *pWallet = reinterpret_cast<TariWallet *>(lWallet);
-    const char *nativeAmount = jEnv->GetStringUTFChars(jamount, JNI_FALSE);
-    const char *nativeGramFee = jEnv->GetStringUTFChars(jgramFee, JNI_FALSE);
-    const char *nativeKernels = jEnv->GetStringUTFChars(jkernelCount, JNI_FALSE);
-    const char *nativeOutputs = jEnv->GetStringUTFChars(joutputCount, JNI_FALSE);
-    char *pAmountEnd;
-    char *pGramFeeEnd;
-    char *pKernelsEnd;
-    char *pOutputsEnd;
-
-    unsigned long long amount = strtoull(nativeAmount, &pAmountEnd, 10);
-    unsigned long long gramFee = strtoull(nativeGramFee, &pGramFeeEnd, 10);
-    unsigned long long kernels = strtoull(nativeKernels, &pKernelsEnd, 10);
-    unsigned long long outputs = strtoull(nativeOutputs, &pOutputsEnd, 10);
-
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv,
+    auto result = static_cast<jlong>(
             wallet_get_fee_estimate(pWallet, amount, gramFee, kernels, outputs, r));
     setErrorCode(jEnv, error, i);
-    jEnv->ReleaseStringUTFChars(jamount, nativeAmount);
-    jEnv->ReleaseStringUTFChars(jgramFee, nativeGramFee);
-    jEnv->ReleaseStringUTFChars(jkernelCount, nativeKernels);
-    jEnv->ReleaseStringUTFChars(joutputCount, nativeOutputs);
     return result;
 }
 
 extern "C"
-JNIEXPORT jbyteArray JNICALL
-Java_com_tari_android_wallet_ffi_FFIWallet_jniCoinSplit(
+JNIEXPORT jlong JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniEstimateTxFeeU64(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jlong jamount,
+        jlong jgramFee,
+        jlong jkernelCount,
+        jlong joutputCount,
+        jobject error) {
+    unsigned long long amount, gramFee, kernels, outputs;
+    if (!getUnsignedAmount(jEnv, jamount, &amount, error)
+        || !getUnsignedAmount(jEnv, jgramFee, &gramFee, error)
+        || !getUnsignedAmount(jEnv, jkernelCount, &kernels, error)
+        || !getUnsignedAmount(jEnv, joutputCount, &outputs, error)) {
+        return 0;
+    }
+    return estimateTxFee(jEnv, jThis, amount, gramFee, kernels, outputs, error);
+}
+
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniEstimateTxFee(
         JNIEnv *jEnv,
         jobject jThis,
         jstring jamount,
-        jstring jsplitCount,
-        jstring jfee,
+        jstring jgramFee,
+        jstring jkernelCount,
+        jstring joutputCount,
+        jobject error) {
+    unsigned long long amount, gramFee, kernels, outputs;
+    if (!parseUnsignedAmount(jEnv, jamount, &amount, error)
+        || !parseUnsignedAmount(jEnv, jgramFee, &gramFee, error)
+        || !parseUnsignedAmount(jEnv, jkernelCount, &kernels, error)
+        || !parseUnsignedAmount(jEnv, joutputCount, &outputs, error)) {
+        return 0;
+    }
+    return estimateTxFee(jEnv, jThis, amount, gramFee, kernels, outputs, error);
+}
+
+static jlong coinSplit(
+        JNIEnv *jEnv,
+        jobject jThis,
+        unsigned long long amount,
+        unsigned long long count,
+        unsigned long long fee,
         jstring jmessage,
-        jstring jlockHeight,
+        unsigned long long height,
         jobject error) {
     int i = 0;
     int *r = &i;
     jlong lWallet = GetPointerField(jEnv, jThis);
     auto *pWallet = reinterpret_cast<TariWallet *>(lWallet);
-    const char *nativeAmount = jEnv->GetStringUTFChars(jamount, JNI_FALSE);
-    const char *nativeFee = jEnv->GetStringUTFChars(jfee, JNI_FALSE);
-    const char *nativeHeight = jEnv->GetStringUTFChars(jlockHeight, JNI_FALSE);
-    const char *nativeCount = jEnv->GetStringUTFChars(jsplitCount, JNI_FALSE);
     const char *pMessage = jEnv->GetStringUTFChars(jmessage, JNI_FALSE);
-    char *pAmountEnd;
-    char *pFeeEnd;
-    char *pLockHeightEnd;
-    char *pCountEnd;
-    unsigned long long fee = strtoull(nativeFee, &pFeeEnd, 10);
-    unsigned long long amount = strtoull(nativeAmount, &pAmountEnd, 10);
-    unsigned long long height = strtoull(nativeHeight, &pLockHeightEnd, 10);
-    unsigned long long count = strtoull(nativeCount, &pCountEnd, 10);
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv,
+    auto result = static_cast<jlong>(
             wallet_coin_split(pWallet, amount, count, fee, pMessage, height, r));
+    if (i == 0 && result != 0) {
+        refreshCachedTx(pWallet, static_cast<unsigned long long>(result), kTxTableCompleted);
+    }
     setErrorCode(jEnv, error, i);
-    jEnv->ReleaseStringUTFChars(jamount, nativeAmount);
-    jEnv->ReleaseStringUTFChars(jfee, nativeFee);
-    jEnv->ReleaseStringUTFChars(jlockHeight, nativeHeight);
-    jEnv->ReleaseStringUTFChars(jsplitCount, nativeCount);
     jEnv->ReleaseStringUTFChars(jmessage, pMessage);
     return result;
 }
 
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniCoinSplitU64(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jlong jamount,
+        jlong jsplitCount,
+        jlong jfee,
+        jstring jmessage,
+        jlong jlockHeight,
+        jobject error) {
+    unsigned long long amount, count, fee, height;
+    if (!getUnsignedAmount(jEnv, jamount, &amount, error)
+        || !getUnsignedAmount(jEnv, jsplitCount, &count, error)
+        || !getUnsignedAmount(jEnv, jfee, &fee, error)
+        || !getUnsignedAmount(jEnv, jlockHeight, &height, error)) {
+        return 0;
+    }
+    return coinSplit(jEnv, jThis, amount, count, fee, jmessage, height, error);
+}
+
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniCoinSplit(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jstring jamount,
+        jstring jsplitCount,
+        jstring jfee,
+        jstring jmessage,
+        jstring jlockHeight,
+        jobject error) {
+    unsigned long long amount, count, fee, height;
+    if (!parseUnsignedAmount(jEnv, jamount, &amount, error)
+        || !parseUnsignedAmount(jEnv, jsplitCount, &count, error)
+        || !parseUnsignedAmount(jEnv, jfee, &fee, error)
+        || !parseUnsignedAmount(jEnv, jlockHeight, &height, error)) {
+        return 0;
+    }
+    return coinSplit(jEnv, jThis, amount, count, fee, jmessage, height, error);
+}
+
 extern "C"
 JNIEXPORT jstring JNICALL
 Java_com_tari_android_wallet_ffi_FFIWallet_jniSignMessage(
@@ -875,7 +1126,7 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniSignMessage(
     char *pSignature = wallet_sign_message(pWallet, pMessage, r);
     setErrorCode(jEnv, error, i);
     jEnv->ReleaseStringUTFChars(jmessage, pMessage);
-    jstring result = jEnv->NewStringUTF(pSignature);
+    jstring result = newStringFromUtf8(jEnv, pSignature);
     string_destroy(pSignature);
     return result;
 }
@@ -908,14 +1159,12 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniVerifyMessageSignature(
     return result;
 }
 
-extern "C"
-JNIEXPORT jbyteArray JNICALL
-Java_com_tari_android_wallet_ffi_FFIWallet_jniImportUTXO(
+static jlong importUTXO(
         JNIEnv *jEnv,
         jobject jThis,
         jobject jpSpendingKey,
         jobject jpSourcePublicKey,
-        jstring jAmount,
+        unsigned long long amount,
         jstring jMessage,
         jobject error) {
     int i = 0;
@@ -926,12 +1175,8 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniImportUTXO(
     auto *pSpendingKey = reinterpret_cast<TariPrivateKey *>(lSpendingKey);
     jlong lSourcePublicKey = GetPointerField(jEnv, jpSourcePublicKey);
     auto *pSourcePublicKey = reinterpret_cast<TariPublicKey *>(lSourcePublicKey);
-    char *pAmountEnd;
-    const char *nativeAmount = jEnv->GetStringUTFChars(jAmount, JNI_FALSE);
     const char *pMessage = jEnv->GetStringUTFChars(jMessage, JNI_FALSE);
-    unsigned long long amount = strtoull(nativeAmount, &pAmountEnd, 10);
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv,
+    auto result = static_cast<jlong>(
             wallet_import_utxo(
                     pWallet,
                     amount,
@@ -939,14 +1184,49 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniImportUTXO(
                     pSourcePublicKey,
                     pMessage,
                     r
-            )
-    );
+            ));
+    if (i == 0 && result != 0) {
+        refreshCachedTx(pWallet, static_cast<unsigned long long>(result), kTxTableCompleted);
+    }
     setErrorCode(jEnv, error, i);
-    jEnv->ReleaseStringUTFChars(jAmount, nativeAmount);
     jEnv->ReleaseStringUTFChars(jMessage, pMessage);
     return result;
 }
 
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniImportUTXOU64(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jobject jpSpendingKey,
+        jobject jpSourcePublicKey,
+        jlong jAmount,
+        jstring jMessage,
+        jobject error) {
+    unsigned long long amount;
+    if (!getUnsignedAmount(jEnv, jAmount, &amount, error)) {
+        return 0;
+    }
+    return importUTXO(jEnv, jThis, jpSpendingKey, jpSourcePublicKey, amount, jMessage, error);
+}
+
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniImportUTXO(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jobject jpSpendingKey,
+        jobject jpSourcePublicKey,
+        jstring jAmount,
+        jstring jMessage,
+        jobject error) {
+    unsigned long long amount;
+    if (!parseUnsignedAmount(jEnv, jAmount, &amount, error)) {
+        return 0;
+    }
+    return importUTXO(jEnv, jThis, jpSpendingKey, jpSourcePublicKey, amount, jMessage, error);
+}
+
 extern "C"
 JNIEXPORT jboolean JNICALL
 Java_com_tari_android_wallet_ffi_FFIWallet_jniAddBaseNodePeer(
@@ -971,7 +1251,7 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniAddBaseNodePeer(
 }
 
 extern "C"
-JNIEXPORT jbyteArray JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFIWallet_jniStartTxValidation(
         JNIEnv *jEnv,
         jobject jThis,
@@ -980,16 +1260,14 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniStartTxValidation(
     int *r = &i;
     jlong lWallet = GetPointerField(jEnv, jThis);
     auto *pWallet = reinterpret_cast<TariWallet *>(lWallet);
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv,
-            wallet_start_transaction_validation(pWallet, r)
-    );
+    auto result = static_cast<jlong>(
+            wallet_start_transaction_validation(pWallet, r));
     setErrorCode(jEnv, error, i);
     return result;
 }
 
 extern "C"
-JNIEXPORT jbyteArray JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFIWallet_jniRestartTxBroadcast(
         JNIEnv *jEnv,
         jobject jThis,
@@ -998,10 +1276,8 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniRestartTxBroadcast(
     int *r = &i;
     jlong lWallet = GetPointerField(jEnv, jThis);
     auto *pWallet = reinterpret_cast<TariWallet *>(lWallet);
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv,
-            wallet_restart_transaction_broadcast(pWallet, r)
-    );
+    auto result = static_cast<jlong>(
+            wallet_restart_transaction_broadcast(pWallet, r));
     setErrorCode(jEnv, error, i);
     return result;
 }
@@ -1071,7 +1347,7 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniSetKeyValue(
 }
 
 extern "C"
-JNIEXPORT jbyteArray JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFIWallet_jniStartTXOValidation(
         JNIEnv *jEnv,
         jobject jThis,
@@ -1080,10 +1356,8 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniStartTXOValidation(
     int *r = &i;
     jlong lWallet = GetPointerField(jEnv, jThis);
     auto *pWallet = reinterpret_cast<TariWallet *>(lWallet);
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv,
-            wallet_start_txo_validation(pWallet, r)
-    );
+    auto result = static_cast<jlong>(
+            wallet_start_txo_validation(pWallet, r));
     setErrorCode(jEnv, error, i);
     return result;
 }
@@ -1103,7 +1377,7 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniGetKeyValue(
     const char *pValue = wallet_get_value(pWallet, pKey, r);
     setErrorCode(jEnv, error, i);
     jEnv->ReleaseStringUTFChars(jKey, pKey);
-    jstring result = jEnv->NewStringUTF(pValue);
+    jstring result = newStringFromUtf8(jEnv, pValue);
     string_destroy(const_cast<char *>(pValue));
     return result;
 }
@@ -1127,7 +1401,7 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniRemoveKeyValue(
 }
 
 extern "C"
-JNIEXPORT jbyteArray JNICALL
+JNIEXPORT jlong JNICALL
 Java_com_tari_android_wallet_ffi_FFIWallet_jniGetConfirmations(
         JNIEnv *jEnv,
         jobject jThis,
@@ -1136,33 +1410,51 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniGetConfirmations(
     int *r = &i;
     jlong lWallet = GetPointerField(jEnv, jThis);
     auto *pWallet = reinterpret_cast<TariWallet *>(lWallet);
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv,
-            wallet_get_num_confirmations_required(pWallet, r)
-    );
+    auto result = static_cast<jlong>(
+            wallet_get_num_confirmations_required(pWallet, r));
     setErrorCode(jEnv, error, i);
     return result;
 }
 
-extern "C"
-JNIEXPORT void JNICALL
-Java_com_tari_android_wallet_ffi_FFIWallet_jniSetConfirmations(
+static void setConfirmations(
         JNIEnv *jEnv,
         jobject jThis,
-        jstring jNumber,
+        unsigned long long number,
         jobject error) {
     int i = 0;
     int *r = &i;
     jlong lWallet = GetPointerField(jEnv, jThis);
     auto *pWallet = reinterpret_cast<TariWallet *>(lWallet);
-    const char *nativeString = jEnv->GetStringUTFChars(jNumber, JNI_FALSE);
-    char *pEnd;
-    unsigned long long number = strtoull(nativeString, &pEnd, 10);
     wallet_set_num_confirmations_required(pWallet, number, r);
-    jEnv->ReleaseStringUTFChars(jNumber, nativeString);
     setErrorCode(jEnv, error, i);
 }
 
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniSetConfirmationsU64(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jlong jNumber,
+        jobject error) {
+    unsigned long long number;
+    if (getUnsignedAmount(jEnv, jNumber, &number, error)) {
+        setConfirmations(jEnv, jThis, number, error);
+    }
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniSetConfirmations(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jstring jNumber,
+        jobject error) {
+    unsigned long long number;
+    if (parseUnsignedAmount(jEnv, jNumber, &number, error)) {
+        setConfirmations(jEnv, jThis, number, error);
+    }
+}
+
 //region Wallet Test Functions
 /*
 extern "C"
@@ -1291,14 +1583,12 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniTestReceiveTx(
 }
 */
 
-extern "C"
-JNIEXPORT jbyteArray JNICALL
-Java_com_tari_android_wallet_ffi_FFIWallet_jniSendTx(
+static jlong sendTx(
         JNIEnv *jEnv,
         jobject jThis,
         jobject jdestination,
-        jstring jamount,
-        jstring jfeePerGram,
+        unsigned long long amount,
+        unsigned long long feePerGram,
         jstring jmessage,
         jobject error) {
     int i = 0;
@@ -1307,24 +1597,53 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniSendTx(
     auto *pWallet = reinterpret_cast<TariWallet *>(lWallet);
     jlong lDestination = GetPointerField(jEnv, jdestination);
     auto *pDestination = reinterpret_cast<TariPublicKey *>(lDestination);
-    const char *nativeAmount = jEnv->GetStringUTFChars(jamount, JNI_FALSE);
-    const char *nativeFeePerGram = jEnv->GetStringUTFChars(jfeePerGram, JNI_FALSE);
     const char *pMessage = jEnv->GetStringUTFChars(jmessage, JNI_FALSE);
-    char *pAmountEnd;
-    char *pFeeEnd;
-    unsigned long long feePerGram = strtoull(nativeFeePerGram, &pFeeEnd, 10);
-    unsigned long long amount = strtoull(nativeAmount, &pAmountEnd, 10);
-
-    jbyteArray result = getBytesFromUnsignedLongLong(
-            jEnv,
+    auto result = static_cast<jlong>(
             wallet_send_transaction(pWallet, pDestination, amount, feePerGram, pMessage, r));
+    if (i == 0 && result != 0) {
+        refreshCachedTx(pWallet, static_cast<unsigned long long>(result), kTxTablePendingOutbound);
+    }
     setErrorCode(jEnv, error, i);
-    jEnv->ReleaseStringUTFChars(jamount, nativeAmount);
-    jEnv->ReleaseStringUTFChars(jfeePerGram, nativeFeePerGram);
     jEnv->ReleaseStringUTFChars(jmessage, pMessage);
     return result;
 }
 
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniSendTxU64(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jobject jdestination,
+        jlong jamount,
+        jlong jfeePerGram,
+        jstring jmessage,
+        jobject error) {
+    unsigned long long amount, feePerGram;
+    if (!getUnsignedAmount(jEnv, jamount, &amount, error)
+        || !getUnsignedAmount(jEnv, jfeePerGram, &feePerGram, error)) {
+        return 0;
+    }
+    return sendTx(jEnv, jThis, jdestination, amount, feePerGram, jmessage, error);
+}
+
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_tari_android_wallet_ffi_FFIWallet_jniSendTx(
+        JNIEnv *jEnv,
+        jobject jThis,
+        jobject jdestination,
+        jstring jamount,
+        jstring jfeePerGram,
+        jstring jmessage,
+        jobject error) {
+    unsigned long long amount, feePerGram;
+    if (!parseUnsignedAmount(jEnv, jamount, &amount, error)
+        || !parseUnsignedAmount(jEnv, jfeePerGram, &feePerGram, error)) {
+        return 0;
+    }
+    return sendTx(jEnv, jThis, jdestination, amount, feePerGram, jmessage, error);
+}
+
 extern "C"
 JNIEXPORT void JNICALL
 Java_com_tari_android_wallet_ffi_FFIWallet_jniApplyEncryption(
@@ -1361,8 +1680,6 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniStartRecovery(
         JNIEnv *jEnv,
         jobject jThis,
         jobject base_node_public_key,
-        jstring callback,
-        jstring callback_sig,
         jobject error) {
     int i = 0;
     int *r = &i;
@@ -1371,15 +1688,6 @@ Java_com_tari_android_wallet_ffi_FFIWallet_jniStartRecovery(
     jlong lbase_node_public_key = GetPointerField(jEnv, base_node_public_key);
     auto *pTariPublicKey = reinterpret_cast<TariPublicKey *>(lbase_node_public_key);
 
-    recoveringProcessCompleteCallbackMethodId = getMethodId(
-            jEnv,
-            jThis,
-            callback,
-            callback_sig);
-    if (recoveringProcessCompleteCallbackMethodId == nullptr) {
-        SetPointerField(jEnv, jThis, reinterpret_cast<jlong>(nullptr));
-    }
-
     auto *pWallet = reinterpret_cast<TariWallet *>(lWallet);
 
     jboolean result = wallet_start_recovery(pWallet, pTariPublicKey, recoveringProcessCompleteCallback, r);
@@ -0,0 +1,546 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef JNI_WALLET_EVENTS_CPP
+#define JNI_WALLET_EVENTS_CPP
+
+#include <jni.h>
+#include <wallet.h>
+#include <atomic>
+#include <condition_variable>
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include "jniCommon.cpp"
+
+/**
+ * Wallet callback event queue.
+ *
+ * Callbacks arriving from the wallet library only push a fixed-size record into a bounded
+ * lock-free ring and return. A single dispatcher thread attached to the VM drains the ring and
+ * hands the events to FFIWallet.onEvents(long[], int) in batches, so a slow listener no longer
+ * stalls the library's threads.
+ *
+ * Batch layout: kWalletEventStride longs per event, {type, arg0, arg1, arg2}. Transaction
+ * events carry the native handle in arg0, unsigned 64-bit values are passed as their raw bits.
+ * The batch array is reused between upcalls and is only valid for the duration of the call.
+ *
+ * Mined-unconfirmed events are coalesced per transaction: the first update is held back for the
+ * configured window, counted from its arrival, and newer updates replace it, so only the newest
+ * confirmation count is delivered and the handles of the updates it replaced are destroyed
+ * natively. A mined or cancelled event for the same transaction drops the
+ * pending update so it cannot be delivered after the newer state.
+ *
+ * Only mined-unconfirmed updates may be dropped when the ring is full, a newer one follows. Every
+ * other event is one of a kind the UI waits for, so it goes to an unbounded overflow list
+ * instead, and while that list is not empty all events go there to keep their order.
+ */
+
+enum WalletEventType {
+    kEventTxReceived = 1,               // arg0: TariPendingInboundTransaction*
+    kEventTxReplyReceived,              // arg0: TariCompletedTransaction*
+    kEventTxFinalized,                  // arg0: TariCompletedTransaction*
+    kEventTxBroadcast,                  // arg0: TariCompletedTransaction*
+    kEventTxMined,                      // arg0: TariCompletedTransaction*
+    kEventTxMinedUnconfirmed,           // arg0: TariCompletedTransaction*, arg1: confirmations,
+                                        // coalesced per transaction
+    kEventDirectSendResult,             // arg0: tx id, arg1: success
+    kEventStoreAndForwardSendResult,    // arg0: tx id, arg1: success
+    kEventTxCancelled,                  // arg0: TariCompletedTransaction*
+    kEventTxoValidationComplete,        // arg0: request id, arg1: result
+    kEventTxValidationComplete,         // arg0: request id, arg1: result
+    kEventRecovery                      // arg0: recovery event, arg1 and arg2: event values
+};
+
+const jsize kWalletEventStride = 4;
+const size_t kWalletEventBatchSize = 64;
+const size_t kWalletEventQueueCapacity = 1024;
+
+/**
+ * Longest time the dispatcher sleeps before re-checking the ring on its own.
+ */
+const long kWalletEventIdleWaitMillis = 100;
+
+struct WalletEvent {
+    jlong type;
+    jlong arg0;
+    jlong arg1;
+    jlong arg2;
+    jlong enqueueNanos;
+};
+
+/**
+ * Called on the dispatcher thread with each batch right before it is delivered, while the
+ * transaction handles it carries are still valid.
+ */
+typedef void (*WalletEventBatchHook)(const WalletEvent *events, size_t count);
+
+/**
+ * Bounded multi-producer single-consumer ring after Dmitry Vyukov's bounded queue: each cell
+ * carries a sequence number, so producers claim a slot with one CAS and never wait on each
+ * other or on the consumer. push() fails instead of blocking when the ring is full.
+ */
+template<size_t Capacity>
+class WalletEventRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two.");
+
+public:
+    WalletEventRing() : enqueuePos(0), dequeuePos(0) {
+        for (size_t i = 0; i < Capacity; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool push(const WalletEvent &event) {
+        Cell *cell;
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells[pos & (Capacity - 1)];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->event = event;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Must only be called from the consumer thread.
+     */
+    bool pop(WalletEvent &event) {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        Cell &cell = cells[pos & (Capacity - 1)];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1) < 0) {
+            return false;
+        }
+        event = cell.event;
+        cell.sequence.store(pos + Capacity, std::memory_order_release);
+        dequeuePos.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * Approximate number of queued events.
+     */
+    size_t size() const {
+        size_t head = dequeuePos.load(std::memory_order_relaxed);
+        size_t tail = enqueuePos.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        WalletEvent event;
+    };
+
+    Cell cells[Capacity];
+    alignas(64) std::atomic<size_t> enqueuePos;
+    alignas(64) std::atomic<size_t> dequeuePos;
+};
+
+/**
+ * Destroys the native handle carried by an event that never reaches Java.
+ */
+inline void releaseWalletEventHandle(const WalletEvent &event) {
+    switch (event.type) {
+        case kEventTxReceived:
+            pending_inbound_transaction_destroy(
+                    reinterpret_cast<TariPendingInboundTransaction *>(event.arg0));
+            break;
+        case kEventTxReplyReceived:
+        case kEventTxFinalized:
+        case kEventTxBroadcast:
+        case kEventTxMined:
+        case kEventTxMinedUnconfirmed:
+        case kEventTxCancelled:
+            completed_transaction_destroy(
+                    reinterpret_cast<TariCompletedTransaction *>(event.arg0));
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Queue statistics, in the order returned by WalletEventDispatcher::getStats.
+ */
+enum WalletEventStat {
+    kStatQueueDepth = 0,
+    kStatMaxQueueDepth,
+    kStatPosted,
+    kStatDropped,
+    kStatDispatched,
+    kStatBatches,
+    kStatTotalLatencyNanos,
+    kStatMaxLatencyNanos,
+    kStatCoalesced,
+    kWalletEventStatCount
+};
+
+class WalletEventDispatcher {
+public:
+    WalletEventDispatcher()
+            : running(false), waiting(false), coalescingWindowNanos(0),
+              hasPendingConfirmations(false), hasOverflow(false) {
+        for (auto &stat : stats) {
+            stat.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Ends the dispatcher thread of a wallet that was never destroyed, at process exit. Queued
+     * handles are left to the process teardown, the handle counters may be gone already.
+     */
+    ~WalletEventDispatcher() {
+        if (!running.exchange(false)) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            wakeUp.notify_one();
+        }
+        thread.join();
+    }
+
+    /**
+     * Starts the dispatcher thread. attachThread is called once on that thread to obtain an
+     * attached JNIEnv, handler must be a global reference that outlives stop().
+     * beforeDelivery, if set, sees every batch before the handler does.
+     */
+    void start(JNIEnv *(*attachThread)(), jobject handler, jmethodID onEventsMethodId,
+               WalletEventBatchHook beforeDelivery = nullptr) {
+        if (running.exchange(true)) {
+            return;
+        }
+        thread = std::thread(&WalletEventDispatcher::run, this, attachThread, handler,
+                             onEventsMethodId, beforeDelivery);
+    }
+
+    /**
+     * Stops and joins the dispatcher. Events still queued are dropped and their handles
+     * destroyed, so it should be called after the wallet stopped producing callbacks.
+     */
+    void stop() {
+        if (!running.exchange(false)) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            wakeUp.notify_one();
+        }
+        thread.join();
+        WalletEvent event;
+        while (ring.pop(event)) {
+            releaseWalletEventHandle(event);
+            stats[kStatDropped]++;
+        }
+        {
+            std::lock_guard<std::mutex> lock(overflowMutex);
+            for (const WalletEvent &overflowed : overflow) {
+                releaseWalletEventHandle(overflowed);
+                stats[kStatDropped]++;
+            }
+            overflow.clear();
+            hasOverflow.store(false, std::memory_order_relaxed);
+        }
+        std::lock_guard<std::mutex> lock(confirmationMutex);
+        for (auto &entry : pendingConfirmations) {
+            releaseWalletEventHandle(entry.second);
+            stats[kStatDropped]++;
+        }
+        pendingConfirmations.clear();
+    }
+
+    /**
+     * Sets how long a mined-unconfirmed update is held back waiting for newer updates of the
+     * same transaction, 0 delivers every update.
+     */
+    void setCoalescingWindow(jlong windowNanos) {
+        coalescingWindowNanos.store(windowNanos > 0 ? windowNanos : 0);
+    }
+
+    /**
+     * Queues a mined-unconfirmed update, replacing the pending update of the same transaction.
+     */
+    void postConfirmation(jlong txId, jlong pTransaction, jlong confirmationCount) {
+        jlong window = coalescingWindowNanos.load(std::memory_order_relaxed);
+        if (window == 0 || !running.load(std::memory_order_relaxed)) {
+            post(kEventTxMinedUnconfirmed, pTransaction, confirmationCount);
+            return;
+        }
+        jlong now = nowNanos();
+        WalletEvent event{kEventTxMinedUnconfirmed, pTransaction, confirmationCount, txId, now};
+        bool inserted;
+        {
+            std::lock_guard<std::mutex> lock(confirmationMutex);
+            auto it = pendingConfirmations.find(txId);
+            inserted = it == pendingConfirmations.end();
+            if (inserted) {
+                pendingConfirmations.emplace(txId, event);
+                confirmationDeadlines.emplace(txId, now + window);
+            } else {
+                releaseWalletEventHandle(it->second);
+                it->second = event;
+                stats[kStatCoalesced]++;
+            }
+            hasPendingConfirmations.store(true, std::memory_order_relaxed);
+        }
+        stats[kStatPosted]++;
+        if (inserted) {
+            // the dispatcher may be sleeping past the new deadline
+            wakeUpIfWaiting();
+        }
+    }
+
+    /**
+     * Drops the pending mined-unconfirmed update of a transaction that reached a newer state.
+     */
+    void supersedeConfirmation(TariCompletedTransaction *pTransaction) {
+        if (!hasPendingConfirmations.load(std::memory_order_relaxed)) {
+            return;
+        }
+        int i = 0;
+        auto txId = static_cast<jlong>(completed_transaction_get_transaction_id(pTransaction, &i));
+        if (i != 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(confirmationMutex);
+        auto it = pendingConfirmations.find(txId);
+        if (it != pendingConfirmations.end()) {
+            releaseWalletEventHandle(it->second);
+            pendingConfirmations.erase(it);
+            confirmationDeadlines.erase(txId);
+            hasPendingConfirmations.store(!pendingConfirmations.empty(), std::memory_order_relaxed);
+            stats[kStatCoalesced]++;
+        }
+    }
+
+    /**
+     * Called from wallet library threads, never blocks on the dispatcher. Only mined-unconfirmed
+     * updates are dropped when the ring is full.
+     */
+    void post(jlong type, jlong arg0, jlong arg1 = 0, jlong arg2 = 0) {
+        WalletEvent event{type, arg0, arg1, arg2, nowNanos()};
+        bool queued = running.load(std::memory_order_relaxed) &&
+                      !hasOverflow.load(std::memory_order_acquire) && ring.push(event);
+        if (!queued) {
+            if (type == kEventTxMinedUnconfirmed || !running.load(std::memory_order_relaxed)) {
+                releaseWalletEventHandle(event);
+                stats[kStatDropped]++;
+                return;
+            }
+            std::lock_guard<std::mutex> lock(overflowMutex);
+            overflow.push_back(event);
+            hasOverflow.store(true, std::memory_order_release);
+        }
+        stats[kStatPosted]++;
+        updateMax(kStatMaxQueueDepth, static_cast<jlong>(ring.size()));
+        wakeUpIfWaiting();
+    }
+
+    void getStats(jlong *out) {
+        for (int i = 0; i < kWalletEventStatCount; i++) {
+            out[i] = stats[i].load(std::memory_order_relaxed);
+        }
+        std::lock_guard<std::mutex> lock(overflowMutex);
+        out[kStatQueueDepth] = static_cast<jlong>(ring.size() + overflow.size());
+    }
+
+private:
+    void wakeUpIfWaiting() {
+        // pairs with the fence in waitForEvents: either the dispatcher sees the event before
+        // sleeping or this thread sees it waiting
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(mutex);
+            wakeUp.notify_one();
+        }
+    }
+
+    /**
+     * Moves confirmation updates whose window has passed into the batch. Returns the number of
+     * events written and sets nextDeadline to the earliest remaining deadline, or 0.
+     */
+    size_t takeDueConfirmations(jlong now, WalletEvent *out, size_t capacity, jlong &nextDeadline) {
+        nextDeadline = 0;
+        if (!hasPendingConfirmations.load(std::memory_order_relaxed)) {
+            return 0;
+        }
+        size_t count = 0;
+        std::lock_guard<std::mutex> lock(confirmationMutex);
+        for (auto it = confirmationDeadlines.begin(); it != confirmationDeadlines.end();) {
+            if (it->second <= now && count < capacity) {
+                auto pending = pendingConfirmations.find(it->first);
+                out[count++] = pending->second;
+                pendingConfirmations.erase(pending);
+                it = confirmationDeadlines.erase(it);
+            } else {
+                if (nextDeadline == 0 || it->second < nextDeadline) {
+                    nextDeadline = it->second;
+                }
+                ++it;
+            }
+        }
+        hasPendingConfirmations.store(!pendingConfirmations.empty(), std::memory_order_relaxed);
+        return count;
+    }
+
+    void run(JNIEnv *(*attachThread)(), jobject handler, jmethodID onEventsMethodId,
+             WalletEventBatchHook beforeDelivery) {
+        JNIEnv *jniEnv = attachThread();
+        if (jniEnv == nullptr) {
+            LOGE("Wallet event dispatcher could not attach to the VM.");
+            return;
+        }
+        jlongArray jBatch = jniEnv->NewLongArray(kWalletEventBatchSize * kWalletEventStride);
+        jlong batch[kWalletEventBatchSize * kWalletEventStride];
+        WalletEvent events[kWalletEventBatchSize];
+        while (running.load()) {
+            jlong now = nowNanos();
+            jlong nextDeadline;
+            size_t count = takeDueConfirmations(now, events, kWalletEventBatchSize, nextDeadline);
+            while (count < kWalletEventBatchSize && ring.pop(events[count])) {
+                count++;
+            }
+            // overflowed events are newer than any left in the ring
+            if (count < kWalletEventBatchSize && hasOverflow.load(std::memory_order_acquire)) {
+                count += takeOverflow(events + count, kWalletEventBatchSize - count);
+            }
+            for (size_t n = 0; n < count; n++) {
+                const WalletEvent &event = events[n];
+                jlong *record = batch + n * kWalletEventStride;
+                record[0] = event.type;
+                record[1] = event.arg0;
+                record[2] = event.arg1;
+                record[3] = event.type == kEventTxMinedUnconfirmed ? 0 : event.arg2;
+            }
+            if (count == 0) {
+                waitForEvents(nextDeadline == 0 ? 0 : nextDeadline - now);
+                continue;
+            }
+            // read after the batch is assembled: the ring and the overflow hold events posted
+            // after now was read, which would otherwise count negative
+            jlong assembled = nowNanos();
+            for (size_t n = 0; n < count; n++) {
+                jlong latency = std::max(assembled - events[n].enqueueNanos, static_cast<jlong>(0));
+                stats[kStatTotalLatencyNanos] += latency;
+                updateMax(kStatMaxLatencyNanos, latency);
+            }
+            if (beforeDelivery != nullptr) {
+                beforeDelivery(events, count);
+            }
+            auto length = static_cast<jsize>(count) * kWalletEventStride;
+            jniEnv->SetLongArrayRegion(jBatch, 0, length, batch);
+            {
+                // spans the time the Kotlin listeners hold up the dispatcher
+                TIMELINE_SCOPE(kTimelineDelivery, "FFIWallet.onEvents", static_cast<int64_t>(count));
+                jniEnv->CallVoidMethod(handler, onEventsMethodId, jBatch, static_cast<jint>(count));
+            }
+            if (jniEnv->ExceptionCheck()) {
+                LOGE("Exception thrown while dispatching wallet events.");
+                jniEnv->ExceptionDescribe();
+                jniEnv->ExceptionClear();
+            }
+            stats[kStatDispatched] += static_cast<jlong>(count);
+            stats[kStatBatches]++;
+        }
+        jniEnv->DeleteLocalRef(jBatch);
+    }
+
+    /**
+     * Sleeps until an event is posted, the timeout passes or the idle wait ends.
+     */
+    void waitForEvents(jlong timeoutNanos) {
+        std::chrono::nanoseconds timeout = std::chrono::milliseconds(kWalletEventIdleWaitMillis);
+        if (timeoutNanos > 0 && timeoutNanos < timeout.count()) {
+            timeout = std::chrono::nanoseconds(timeoutNanos);
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        waiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (ring.size() == 0 && !hasOverflow.load() && running.load()) {
+            wakeUp.wait_for(lock, timeout);
+        }
+        waiting.store(false, std::memory_order_relaxed);
+    }
+
+    size_t takeOverflow(WalletEvent *out, size_t capacity) {
+        std::lock_guard<std::mutex> lock(overflowMutex);
+        size_t count = std::min(capacity, overflow.size());
+        std::copy(overflow.begin(), overflow.begin() + count, out);
+        overflow.erase(overflow.begin(), overflow.begin() + count);
+        hasOverflow.store(!overflow.empty(), std::memory_order_release);
+        return count;
+    }
+
+    void updateMax(WalletEventStat stat, jlong value) {
+        jlong current = stats[stat].load(std::memory_order_relaxed);
+        while (value > current &&
+               !stats[stat].compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    WalletEventRing<kWalletEventQueueCapacity> ring;
+    std::atomic<jlong> stats[kWalletEventStatCount];
+    std::atomic<bool> running;
+    std::atomic<bool> waiting;
+    std::atomic<jlong> coalescingWindowNanos;
+    std::atomic<bool> hasPendingConfirmations;
+    // mined-unconfirmed updates waiting for their window to pass, keyed by transaction id
+    std::mutex confirmationMutex;
+    std::unordered_map<jlong, WalletEvent> pendingConfirmations;
+    std::unordered_map<jlong, jlong> confirmationDeadlines;
+    // events that found the ring full, delivered after it empties
+    std::atomic<bool> hasOverflow;
+    std::mutex overflowMutex;
+    std::deque<WalletEvent> overflow;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::thread thread;
+};
+
+#endif // JNI_WALLET_EVENTS_CPP
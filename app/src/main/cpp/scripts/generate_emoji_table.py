@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""
+Generates jniEmojiTable.cpp, the emoji alphabet of the wallet library as compile-time tables.
+
+The alphabet below must match get_emoji_set() of the bundled libwallet entry for entry, which
+FFIEmojiSetTests checks on a device. When libwallet changes its emoji set, update EMOJI_ALPHABET
+and run from any directory:
+
+    python3 app/src/main/cpp/scripts/generate_emoji_table.py
+
+Besides the alphabet the output holds a minimal perfect hash from code point to alphabet index
+(hash and displace): the code point selects one of BUCKET_COUNT buckets, and the displacement
+stored for that bucket is mixed into a second hash that lands on one of the 256 slots without
+collisions. The displacements are searched here and checked again by a static_assert.
+"""
+
+import os
+import sys
+
+CPP_DIR = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+OUTPUT = os.path.join(CPP_DIR, "jniEmojiTable.cpp")
+LICENSE = open(os.path.join(CPP_DIR, "jniCommon.cpp")).read().split("*/", 1)[0] + "*/\n"
+
+# in index order, 16 per row
+EMOJI_ALPHABET = (
+    "🌀🌂🌈🌊🌋🌍🌙🌝🌞🌟🌠🌰🌴🌵🌷🌸"
+    "🌹🌻🌽🍀🍁🍄🍅🍆🍇🍈🍉🍊🍋🍌🍍🍎"
+    "🍐🍑🍒🍓🍔🍕🍗🍚🍞🍟🍠🍣🍦🍩🍪🍫"
+    "🍬🍭🍯🍰🍳🍴🍵🍶🍷🍸🍹🍺🍼🎀🎁🎂"
+    "🎃🎄🎈🎉🎒🎓🎠🎡🎢🎣🎤🎥🎧🎨🎩🎪"
+    "🎬🎭🎮🎰🎱🎲🎳🎵🎷🎸🎹🎺🎻🎼🎽🎾"
+    "🎿🏀🏁🏆🏈🏉🏠🏥🏦🏭🏰🐀🐉🐊🐌🐍"
+    "🐎🐐🐑🐓🐖🐗🐘🐙🐚🐛🐜🐝🐞🐢🐣🐨"
+    "🐩🐪🐬🐭🐮🐯🐰🐲🐳🐴🐵🐶🐷🐸🐺🐻"
+    "🐼🐽🐾👀👅👑👒👓👔👕👖👗👘👙👚👛"
+    "👞👟👠👡👢👣👹👻👽👾👿💀💄💈💉💊"
+    "💋💌💍💎💐💔💕💘💡💣💤💦💨💩💭💯"
+    "💰💳💸💺💻💼📈📉📌📎📚📝📡📣📱📷"
+    "🔋🔌🔎🔑🔔🔥🔦🔧🔨🔩🔪🔫🔬🔭🔮🔱"
+    "🗽😂😇😈😉😍😎😱😷😹😻😿🚀🚁🚂🚌"
+    "🚑🚒🚓🚕🚗🚜🚢🚦🚧🚨🚪🚫🚲🚽🚿🛁"
+)
+
+MULTIPLIER = 0x9E3779B1
+BUCKET_BITS = 7
+BUCKET_COUNT = 1 << BUCKET_BITS
+SLOT_BITS = 8
+MAX_DISPLACEMENT = 255
+
+
+def bucket_of(code_point):
+    return ((code_point * MULTIPLIER) & 0xFFFFFFFF) >> (32 - BUCKET_BITS)
+
+
+def slot_of(code_point, displacement):
+    return (((code_point ^ displacement) * MULTIPLIER) & 0xFFFFFFFF) >> (32 - SLOT_BITS)
+
+
+def search_displacements(code_points):
+    buckets = {}
+    for code_point in code_points:
+        buckets.setdefault(bucket_of(code_point), []).append(code_point)
+    displacements = [0] * BUCKET_COUNT
+    slots = [None] * (1 << SLOT_BITS)
+    # largest buckets first, while most slots are still free
+    for bucket, members in sorted(buckets.items(), key=lambda item: (-len(item[1]), item[0])):
+        for displacement in range(MAX_DISPLACEMENT + 1):
+            taken = [slot_of(code_point, displacement) for code_point in members]
+            if len(set(taken)) == len(taken) and all(slots[slot] is None for slot in taken):
+                for code_point, slot in zip(members, taken):
+                    slots[slot] = code_points.index(code_point)
+                displacements[bucket] = displacement
+                break
+        else:
+            raise ValueError("No displacement for bucket %d, change MULTIPLIER" % bucket)
+    return displacements, slots
+
+
+def table(values, per_row, format_value):
+    rows = []
+    for start in range(0, len(values), per_row):
+        rows.append("        " + ", ".join(format_value(v) for v in values[start:start + per_row]))
+    return ",\n".join(rows)
+
+
+def generate(code_points, displacements, slots):
+    lines = [LICENSE]
+    lines.append("// Generated by scripts/generate_emoji_table.py, do not edit.\n")
+    lines.append("#ifndef JNI_EMOJI_TABLE_CPP")
+    lines.append("#define JNI_EMOJI_TABLE_CPP")
+    lines.append("")
+    lines.append("#include <cstdint>")
+    lines.append("")
+    lines.append("static constexpr int kEmojiAlphabetSize = %d;" % len(code_points))
+    lines.append("")
+    lines.append("/**")
+    lines.append(" * Code points of the emoji alphabet, an emoji ID encodes byte b as kEmojiAlphabet[b].")
+    lines.append(" */")
+    lines.append("static constexpr char32_t kEmojiAlphabet[kEmojiAlphabetSize] = {")
+    lines.append(table(code_points, 8, lambda v: "0x%05X" % v))
+    lines.append("};")
+    lines.append("")
+    lines.append("static constexpr uint32_t kEmojiHashMultiplier = 0x%08X;" % MULTIPLIER)
+    lines.append("")
+    lines.append("static constexpr uint8_t kEmojiHashDisplacements[%d] = {" % BUCKET_COUNT)
+    lines.append(table(displacements, 16, lambda v: "%3d" % v))
+    lines.append("};")
+    lines.append("")
+    lines.append("static constexpr uint8_t kEmojiHashSlots[%d] = {" % len(slots))
+    lines.append(table(slots, 16, lambda v: "%3d" % v))
+    lines.append("};")
+    lines.append("")
+    lines.append("constexpr uint32_t emojiHashBucket(char32_t codePoint) {")
+    lines.append("    return static_cast<uint32_t>(static_cast<uint32_t>(codePoint) * kEmojiHashMultiplier) >> %d;"
+                 % (32 - BUCKET_BITS))
+    lines.append("}")
+    lines.append("")
+    lines.append("constexpr uint32_t emojiHashSlot(char32_t codePoint) {")
+    lines.append("    return static_cast<uint32_t>(")
+    lines.append("            (static_cast<uint32_t>(codePoint) ^ kEmojiHashDisplacements[emojiHashBucket(codePoint)])")
+    lines.append("            * kEmojiHashMultiplier) >> %d;" % (32 - SLOT_BITS))
+    lines.append("}")
+    lines.append("")
+    lines.append("/**")
+    lines.append(" * Alphabet index of the emoji, or -1 if the code point is not part of the alphabet.")
+    lines.append(" */")
+    lines.append("constexpr int emojiIndexOf(char32_t codePoint) {")
+    lines.append("    return kEmojiAlphabet[kEmojiHashSlots[emojiHashSlot(codePoint)]] == codePoint")
+    lines.append("           ? kEmojiHashSlots[emojiHashSlot(codePoint)]")
+    lines.append("           : -1;")
+    lines.append("}")
+    lines.append("")
+    lines.append("constexpr bool emojiHashIsPerfect(int index) {")
+    lines.append("    return index == kEmojiAlphabetSize")
+    lines.append("           || (emojiIndexOf(kEmojiAlphabet[index]) == index && emojiHashIsPerfect(index + 1));")
+    lines.append("}")
+    lines.append("")
+    lines.append('static_assert(emojiHashIsPerfect(0), "Emoji hash collides, re-run generate_emoji_table.py");')
+    lines.append("")
+    lines.append("#endif // JNI_EMOJI_TABLE_CPP")
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    code_points = [ord(emoji) for emoji in "".join(EMOJI_ALPHABET)]
+    if len(code_points) != 256 or len(set(code_points)) != 256:
+        sys.stderr.write("The alphabet must hold 256 distinct emoji\n")
+        return 1
+    displacements, slots = search_displacements(code_points)
+    with open(OUTPUT, "w") as output:
+        output.write(generate(code_points, displacements, slots))
+    print("Wrote %d emoji and a %d bucket perfect hash to %s" % (len(code_points), BUCKET_COUNT, OUTPUT))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
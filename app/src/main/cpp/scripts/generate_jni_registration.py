@@ -0,0 +1,240 @@
+#!/usr/bin/env python3
+"""
+Generates jniRegistration.cpp, the RegisterNatives table of native-lib.
+
+Every `external fun` declared by the Kotlin classes in the ffi package is matched with its
+Java_com_tari_android_wallet_ffi_* definition in the jni*.cpp sources. The JNI descriptor is
+derived from the Kotlin declaration and the C prototype from the native definition, and the
+two are checked against each other so that a mismatch fails here rather than at run time.
+Each method is bound through CALL_STATS_ENTRY, which times it when native-lib is built with
+TARI_JNI_CALL_STATS, and numbered in table order for the call stats report.
+
+Run from any directory after adding, removing or changing a native method:
+
+    python3 app/src/main/cpp/scripts/generate_jni_registration.py
+"""
+
+import os
+import re
+import sys
+
+CPP_DIR = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+KOTLIN_DIR = os.path.normpath(
+    os.path.join(CPP_DIR, "..", "java", "com", "tari", "android", "wallet", "ffi"))
+OUTPUT = os.path.join(CPP_DIR, "jniRegistration.cpp")
+PACKAGE = "com/tari/android/wallet/ffi"
+SYMBOL_PREFIX = "Java_com_tari_android_wallet_ffi_"
+
+KOTLIN_TYPES = {
+    "Unit": "V",
+    "Boolean": "Z",
+    "Byte": "B",
+    "Char": "C",
+    "Short": "S",
+    "Int": "I",
+    "Long": "J",
+    "Float": "F",
+    "Double": "D",
+    "FFIPointer": "J",
+    "String": "Ljava/lang/String;",
+    "ByteArray": "[B",
+    "CharArray": "[C",
+    "ShortArray": "[S",
+    "IntArray": "[I",
+    "LongArray": "[J",
+    "Array<String>": "[Ljava/lang/String;",
+    "ByteBuffer": "Ljava/nio/ByteBuffer;",
+}
+
+JNI_TYPES = {
+    "V": "void",
+    "Z": "jboolean",
+    "B": "jbyte",
+    "C": "jchar",
+    "S": "jshort",
+    "I": "jint",
+    "J": "jlong",
+    "F": "jfloat",
+    "D": "jdouble",
+    "Ljava/lang/String;": "jstring",
+    "[B": "jbyteArray",
+    "[C": "jcharArray",
+    "[S": "jshortArray",
+    "[I": "jintArray",
+    "[J": "jlongArray",
+    "[Ljava/lang/String;": "jobjectArray",
+}
+
+LICENSE = open(os.path.join(CPP_DIR, "jniCommon.cpp")).read().split("*/", 1)[0] + "*/\n"
+
+
+def strip_comments(source):
+    source = re.sub(r"/\*.*?\*/", "", source, flags=re.S)
+    return re.sub(r"//[^\n]*", "", source)
+
+
+def type_aliases():
+    aliases = {}
+    for file_name in sorted(os.listdir(KOTLIN_DIR)):
+        if file_name.endswith(".kt"):
+            source = strip_comments(open(os.path.join(KOTLIN_DIR, file_name)).read())
+            for alias, target in re.findall(r"typealias\s+(\w+)\s*=\s*([\w<>]+)", source):
+                aliases[alias] = target
+    return aliases
+
+
+ALIASES = {}
+
+
+def descriptor(kotlin_type):
+    kotlin_type = kotlin_type.strip().rstrip("?")
+    kotlin_type = ALIASES.get(kotlin_type, kotlin_type)
+    if kotlin_type in KOTLIN_TYPES:
+        return KOTLIN_TYPES[kotlin_type]
+    if re.match(r"^FFI\w+$", kotlin_type):
+        return "L%s/%s;" % (PACKAGE, kotlin_type)
+    raise ValueError("Unsupported Kotlin type in native signature: " + kotlin_type)
+
+
+def kotlin_natives():
+    natives = {}
+    pattern = re.compile(
+        r"external\s+fun\s+(\w+)\s*\(([^)]*)\)\s*(?::\s*([\w<>?]+))?", re.S)
+    for file_name in sorted(os.listdir(KOTLIN_DIR)):
+        if not file_name.endswith(".kt"):
+            continue
+        source = strip_comments(open(os.path.join(KOTLIN_DIR, file_name)).read())
+        class_name = file_name[:-3]
+        for match in pattern.finditer(source):
+            name, params, ret = match.group(1), match.group(2), match.group(3) or "Unit"
+            param_types = [p.split(":", 1)[1] for p in params.split(",") if p.strip()]
+            signature = "(%s)%s" % ("".join(descriptor(t) for t in param_types), descriptor(ret))
+            natives[(class_name, name)] = signature
+    return natives
+
+
+def native_definitions():
+    definitions = {}
+    pattern = re.compile(
+        r'extern\s+"C"\s+JNIEXPORT\s+(\w+)\s+JNICALL\s+' + SYMBOL_PREFIX +
+        r"(\w+?)_(jni\w+)\s*\(([^)]*)\)\s*\{", re.S)
+    for file_name in sorted(os.listdir(CPP_DIR)):
+        if not file_name.endswith(".cpp") or file_name == os.path.basename(OUTPUT):
+            continue
+        source = strip_comments(open(os.path.join(CPP_DIR, file_name)).read())
+        for match in pattern.finditer(source):
+            ret, class_name, name, params = match.groups()
+            params = [" ".join(p.split()) for p in params.split(",")]
+            definitions[(class_name, name)] = (ret, params, file_name)
+    return definitions
+
+
+def check(natives, definitions):
+    errors = []
+    for key in sorted(set(natives) - set(definitions)):
+        errors.append("%s.%s has no native definition" % key)
+    for key in sorted(set(definitions) - set(natives)):
+        errors.append("%s%s_%s has no Kotlin declaration" % ((SYMBOL_PREFIX,) + key))
+    for key in sorted(set(natives) & set(definitions)):
+        signature = natives[key]
+        ret, params, file_name = definitions[key]
+        args, result = re.match(r"\((.*)\)(.*)", signature).groups()
+        arg_types = re.findall(r"\[?(?:[ZBCSIJFD]|L[^;]+;)", args)
+        if len(arg_types) != len(params) - 2:
+            errors.append("%s.%s: %d Kotlin parameters, %d native parameters (%s)"
+                          % (key + (len(arg_types), len(params) - 2, file_name)))
+            continue
+        expected = [JNI_TYPES.get(t, "jobject") for t in [result] + arg_types]
+        actual = [ret] + [p.rsplit(" ", 1)[0].replace(" *", "*") for p in params[2:]]
+        if expected != actual:
+            errors.append("%s.%s: JNI types %s do not match native types %s (%s)"
+                          % (key + (expected, actual, file_name)))
+    return errors
+
+
+def generate(natives, definitions):
+    lines = [LICENSE]
+    lines.append("// Generated by scripts/generate_jni_registration.py, do not edit.\n")
+    lines.append("#include <jni.h>")
+    lines.append('#include "jniCommon.cpp"')
+    lines.append("")
+    lines.append("#if TARI_JNI_STATIC_REGISTRATION")
+    lines.append("")
+    for class_name, name in sorted(definitions):
+        ret, params, _ = definitions[(class_name, name)]
+        lines.append('extern "C" %s %s%s_%s(%s);'
+                     % (ret, SYMBOL_PREFIX, class_name, name, ", ".join(params)))
+    lines.append("")
+    classes = sorted(set(class_name for class_name, _ in definitions))
+    entries = sorted(definitions)
+    for class_name in classes:
+        lines.append("static const JNINativeMethod k%sMethods[] = {" % class_name)
+        for entry, (owner, name) in enumerate(entries):
+            if owner != class_name:
+                continue
+            lines.append('        {"%s", "%s", CALL_STATS_ENTRY(%d, %s%s_%s)},'
+                         % (name, natives[(owner, name)], entry, SYMBOL_PREFIX, owner, name))
+        lines.append("};")
+        lines.append("")
+    lines.append("#if TARI_JNI_CALL_STATS")
+    lines.append("")
+    lines.append("const char *const kJniEntryNames[] = {")
+    for owner, name in entries:
+        lines.append('        "%s.%s",' % (owner, name))
+    lines.append("};")
+    lines.append("")
+    lines.append("const int kJniEntryCount = sizeof(kJniEntryNames) / sizeof(kJniEntryNames[0]);")
+    lines.append("")
+    lines.append("static_assert(sizeof(kJniEntryNames) / sizeof(kJniEntryNames[0]) <= kCallStatsEntryCapacity,")
+    lines.append('              "Raise kCallStatsEntryCapacity in jniCallStats.cpp");')
+    lines.append("")
+    lines.append("#endif")
+    lines.append("")
+    lines.append("/**")
+    lines.append(" * Binds every native method of the FFI classes. Called from JNI_OnLoad once the ID")
+    lines.append(" * registry holds the class references. Returns the number of registered methods, or")
+    lines.append(" * -1 (with a pending Java exception) on failure.")
+    lines.append(" */")
+    lines.append("jint registerNativeMethods(JNIEnv *jEnv) {")
+    lines.append("    struct {")
+    lines.append("        FFIClass ffiClass;")
+    lines.append("        const JNINativeMethod *methods;")
+    lines.append("        jint count;")
+    lines.append("    } const tables[] = {")
+    for class_name in classes:
+        lines.append("            {k%s, k%sMethods, sizeof(k%sMethods) / sizeof(JNINativeMethod)},"
+                     % (class_name, class_name, class_name))
+    lines.append("    };")
+    lines.append("    jint registered = 0;")
+    lines.append("    for (const auto &table : tables) {")
+    lines.append("        if (jEnv->RegisterNatives(g_ids.classes[table.ffiClass], table.methods,")
+    lines.append("                                  table.count) != JNI_OK) {")
+    lines.append('            LOGE("RegisterNatives failed for %s.", kFFIClassNames[table.ffiClass]);')
+    lines.append("            return -1;")
+    lines.append("        }")
+    lines.append("        registered += table.count;")
+    lines.append("    }")
+    lines.append("    return registered;")
+    lines.append("}")
+    lines.append("")
+    lines.append("#endif")
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    ALIASES.update(type_aliases())
+    natives = kotlin_natives()
+    definitions = native_definitions()
+    errors = check(natives, definitions)
+    if errors:
+        sys.stderr.write("\n".join(errors) + "\n")
+        return 1
+    with open(OUTPUT, "w") as output:
+        output.write(generate(natives, definitions))
+    print("Registered %d native methods of %d classes in %s"
+          % (len(definitions), len(set(c for c, _ in definitions)), OUTPUT))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -44,6 +44,7 @@ import com.tari.android.wallet.data.sharedPrefs.SharedPrefsRepository
 import com.tari.android.wallet.di.DiContainer
 import com.tari.android.wallet.event.Event
 import com.tari.android.wallet.event.EventBus
+import com.tari.android.wallet.ffi.FFIUtil
 import com.tari.android.wallet.infrastructure.Tracker
 import com.tari.android.wallet.network.NetworkConnectionStateReceiver
 import com.tari.android.wallet.notification.NotificationHelper
@@ -82,8 +83,12 @@ internal class TariWalletApplication : Application(), LifecycleObserver {
     var isInForeground = false
         private set
 
+    private val nativeLibraryLoadNanos: Long
+
     init {
+        val start = System.nanoTime()
         System.loadLibrary("native-lib")
+        nativeLibraryLoadNanos = System.nanoTime() - start
     }
 
     val currentActivity: Activity?
@@ -95,6 +100,11 @@ internal class TariWalletApplication : Application(), LifecycleObserver {
 
         registerActivityLifecycleCallbacks(activityLifecycleCallbacks)
         Logger.addLogAdapter(AndroidLogAdapter())
+        Logger.i(
+            "native-lib loaded in %d µs, %s",
+            nativeLibraryLoadNanos / 1000,
+            FFIUtil.getLoadStats()
+        )
         JodaTimeAndroid.init(this)
 
         DiContainer.initContainer(this)
@@ -44,7 +44,12 @@ internal const val nullptr = 0L
 internal abstract class FFIBase {
 
     var pointer = nullptr
-        protected set
+        protected set(value) {
+            field = value
+            if (value != nullptr) {
+                FFIHandleArena.adoptIfActive(this)
+            }
+        }
 
     abstract fun destroy()
 
@@ -33,6 +33,7 @@
 package com.tari.android.wallet.ffi
 
 import java.math.BigInteger
+import java.nio.ByteBuffer
 
 /**
  * Wrapper for native byte vector type.
@@ -47,6 +48,13 @@ internal class FFIByteVector() : FFIBase() {
     private external fun jniGetAt(index: Int, error: FFIError): Int
     private external fun jniDestroy()
     private external fun jniCreate(byteArray: ByteArray, error: FFIError)
+    private external fun jniCreateFromBuffer(
+        buffer: ByteBuffer,
+        offset: Int,
+        length: Int,
+        error: FFIError
+    )
+    private external fun jniGetBytes(byteArray: ByteArray, error: FFIError): Int
 
     // endregion
     constructor(pointer: FFIPointer): this() {
@@ -73,6 +81,19 @@ internal class FFIByteVector() : FFIBase() {
         throwIf(error)
     }
 
+    /**
+     * Copies the remaining bytes of a direct [buffer] (position to limit), read in place by the
+     * native side. The buffer position is left unchanged.
+     */
+    constructor(buffer: ByteBuffer): this() {
+        if (!buffer.isDirect) {
+            throw FFIException(message = "ByteBuffer is not direct")
+        }
+        val error = FFIError()
+        jniCreateFromBuffer(buffer, buffer.position(), buffer.remaining(), error)
+        throwIf(error)
+    }
+
     fun getAt(index: Int): Int {
         val error = FFIError()
         val byte = jniGetAt(index, error)
@@ -88,15 +109,22 @@ internal class FFIByteVector() : FFIBase() {
     }
 
     fun getBytes(): ByteArray {
-        val length = getLength()
-        val byteArray = ByteArray(length)
-        for (i in 0 until length) {
-            val m = getAt(i)
-            byteArray[i] = m.toByte()
-        }
+        val byteArray = ByteArray(getLength())
+        getBytes(byteArray)
         return byteArray
     }
 
+    /**
+     * Copies all bytes into the start of [destination] in one native call and returns the
+     * length of the vector. Nothing is copied if [destination] is shorter than that.
+     */
+    fun getBytes(destination: ByteArray): Int {
+        val error = FFIError()
+        val length = jniGetBytes(destination, error)
+        throwIf(error)
+        return length
+    }
+
     override fun toString(): String {
         return HexString(this).toString()
     }
@@ -32,8 +32,6 @@
  */
 package com.tari.android.wallet.ffi
 
-import java.math.BigInteger
-
 /**
  * Completed transaction wrapper.
  *
@@ -43,7 +41,7 @@ internal class FFICompletedTx() : FFIBase() {
 
     // region JNI
 
-    private external fun jniGetId(libError: FFIError): ByteArray
+    private external fun jniGetId(libError: FFIError): Long
     private external fun jniGetDestinationPublicKey(
         libError: FFIError
     ): FFIPointer
@@ -54,15 +52,15 @@ internal class FFICompletedTx() : FFIBase() {
         libError: FFIError
     ): FFIPointer
 
-    private external fun jniGetAmount(libError: FFIError): ByteArray
-    private external fun jniGetFee(libError: FFIError): ByteArray
+    private external fun jniGetAmount(libError: FFIError): Long
+    private external fun jniGetFee(libError: FFIError): Long
     private external fun jniGetTimestamp(
         libError: FFIError
-    ): ByteArray
+    ): Long
 
     private external fun jniGetMessage(libError: FFIError): String
     private external fun jniGetStatus(libError: FFIError): Int
-    private external fun jniGetConfirmationCount(libError: FFIError): ByteArray
+    private external fun jniGetConfirmationCount(libError: FFIError): Long
     private external fun jniIsOutbound(
         libError: FFIError
     ): Boolean
@@ -75,11 +73,11 @@ internal class FFICompletedTx() : FFIBase() {
         this.pointer = pointer
     }
 
-    fun getId(): BigInteger {
+    fun getId(): UnsignedLong {
         val error = FFIError()
-        val bytes = jniGetId(error)
+        val bits = jniGetId(error)
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
     fun getDestinationPublicKey(): FFIPublicKey {
@@ -96,25 +94,25 @@ internal class FFICompletedTx() : FFIBase() {
         return result
     }
 
-    fun getAmount(): BigInteger {
+    fun getAmount(): UnsignedLong {
         val error = FFIError()
-        val bytes = jniGetAmount(error)
+        val bits = jniGetAmount(error)
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
-    fun getFee(): BigInteger {
+    fun getFee(): UnsignedLong {
         val error = FFIError()
-        val bytes = jniGetFee(error)
+        val bits = jniGetFee(error)
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
-    fun getTimestamp(): BigInteger {
+    fun getTimestamp(): UnsignedLong {
         val error = FFIError()
-        val bytes = jniGetTimestamp(error)
+        val bits = jniGetTimestamp(error)
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
     fun getMessage(): String {
@@ -131,11 +129,11 @@ internal class FFICompletedTx() : FFIBase() {
         return FFITxStatus.map(status)
     }
 
-    fun getConfirmationCount(): BigInteger {
+    fun getConfirmationCount(): UnsignedLong {
         val error = FFIError()
-        val bytes = jniGetConfirmationCount(error)
+        val bits = jniGetConfirmationCount(error)
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
     fun isOutbound(): Boolean {
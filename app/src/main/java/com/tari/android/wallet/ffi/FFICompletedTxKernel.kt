@@ -42,6 +42,7 @@ internal class FFICompletedTxKernel() : FFIBase() {
     private external fun jniGetExcess(libError: FFIError): String
     private external fun jniGetExcessPublicNonce(libError: FFIError): String
     private external fun jniGetExcessSignature(libError: FFIError): String
+    private external fun jniGetBytes(array: ByteArray, libError: FFIError)
     private external fun jniDestroy()
 
     // endregion
@@ -70,8 +71,28 @@ internal class FFICompletedTxKernel() : FFIBase() {
         return result
     }
 
+    /**
+     * All three fields in one call: excess, excess public nonce and excess signature,
+     * [FIELD_SIZE] bytes each, starting at the corresponding offset.
+     */
+    fun getBytes(): ByteArray {
+        val bytes = ByteArray(BYTES_SIZE)
+        val error = FFIError()
+        jniGetBytes(bytes, error)
+        throwIf(error)
+        return bytes
+    }
+
     override fun destroy() {
         jniDestroy()
     }
 
+    companion object {
+        const val FIELD_SIZE = 32
+        const val EXCESS_OFFSET = 0
+        const val EXCESS_PUBLIC_NONCE_OFFSET = FIELD_SIZE
+        const val EXCESS_SIGNATURE_OFFSET = 2 * FIELD_SIZE
+        const val BYTES_SIZE = 3 * FIELD_SIZE
+    }
+
 }
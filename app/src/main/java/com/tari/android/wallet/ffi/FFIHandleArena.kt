@@ -0,0 +1,141 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+package com.tari.android.wallet.ffi
+
+/**
+ * Collects the native handles of the FFI objects created on the calling thread while it is
+ * active and frees them all in one [release] call, instead of one destroy() call per object or
+ * a finalizer.
+ *
+ * Arenas nest: an arena activated while another one is active takes over until it is released.
+ * An arena must be released on the thread that activated it. Objects destroyed explicitly
+ * inside the scope are skipped on release, and the wallet itself is never taken over.
+ *
+ * @author The Tari Development Team
+ */
+internal class FFIHandleArena : FFIBase() {
+
+    // region JNI
+
+    private external fun jniCreate()
+    private external fun jniActivate()
+    private external fun jniAdopt(target: FFIBase)
+    private external fun jniGetSize(): Int
+    private external fun jniRelease(): Int
+    private external fun jniDestroy()
+
+    // endregion
+
+    private var parent: FFIHandleArena? = null
+    private var active = false
+
+    init {
+        jniCreate()
+    }
+
+    /**
+     * Number of handles recorded since the last release.
+     */
+    val size: Int
+        get() = jniGetSize()
+
+    fun activate() {
+        if (!active) {
+            parent = current.get()
+            current.set(this)
+            active = true
+            jniActivate()
+        }
+    }
+
+    /**
+     * Deactivates the arena and frees the handles it recorded.
+     *
+     * @return number of handles freed
+     */
+    fun release(): Int {
+        deactivate()
+        return jniRelease()
+    }
+
+    override fun destroy() {
+        deactivate()
+        jniDestroy()
+    }
+
+    private fun deactivate() {
+        if (!active) {
+            return
+        }
+        if (current.get() === this) {
+            current.set(parent)
+        } else {
+            var arena = current.get()
+            while (arena != null && arena.parent !== this) {
+                arena = arena.parent
+            }
+            arena?.parent = parent
+        }
+        parent = null
+        active = false
+    }
+
+    companion object {
+
+        private val current = ThreadLocal<FFIHandleArena?>()
+
+        /**
+         * Called for handles attached on the Kotlin side, handles attached by the native layer
+         * are recorded there directly.
+         */
+        internal fun adoptIfActive(target: FFIBase) {
+            current.get()?.jniAdopt(target)
+        }
+
+        /**
+         * Runs [block] with a fresh arena active and frees every handle it created afterwards,
+         * including the ones still referenced by the result. Extract plain Kotlin values inside
+         * the block.
+         */
+        inline fun <T> scoped(block: () -> T): T {
+            val arena = FFIHandleArena()
+            arena.activate()
+            try {
+                return block()
+            } finally {
+                arena.destroy()
+            }
+        }
+    }
+
+}
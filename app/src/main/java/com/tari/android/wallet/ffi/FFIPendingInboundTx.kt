@@ -32,8 +32,6 @@
  */
 package com.tari.android.wallet.ffi
 
-import java.math.BigInteger
-
 /**
  * Pending inbound transaction wrapper.
  *
@@ -44,18 +42,18 @@ internal class FFIPendingInboundTx() : FFIBase() {
 
     // region JNI
 
-    private external fun jniGetId(libError: FFIError): ByteArray
+    private external fun jniGetId(libError: FFIError): Long
     private external fun jniGetSourcePublicKey(
         libError: FFIError
     ): FFIPointer
 
     private external fun jniGetAmount(
         libError: FFIError
-    ): ByteArray
+    ): Long
 
     private external fun jniGetTimestamp(
         libError: FFIError
-    ): ByteArray
+    ): Long
 
     private external fun jniGetMessage(
         libError: FFIError
@@ -73,11 +71,11 @@ internal class FFIPendingInboundTx() : FFIBase() {
         this.pointer = pointer
     }
 
-    fun getId(): BigInteger {
+    fun getId(): UnsignedLong {
         val error = FFIError()
-        val bytes = jniGetId(error)
+        val bits = jniGetId(error)
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
     fun getSourcePublicKey(): FFIPublicKey {
@@ -87,18 +85,18 @@ internal class FFIPendingInboundTx() : FFIBase() {
         return result
     }
 
-    fun getAmount(): BigInteger {
+    fun getAmount(): UnsignedLong {
         val error = FFIError()
-        val bytes = jniGetAmount(error)
+        val bits = jniGetAmount(error)
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
-    fun getTimestamp(): BigInteger {
+    fun getTimestamp(): UnsignedLong {
         val error = FFIError()
-        val bytes = jniGetTimestamp(error)
+        val bits = jniGetTimestamp(error)
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
     fun getMessage(): String {
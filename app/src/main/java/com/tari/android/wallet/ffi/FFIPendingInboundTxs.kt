@@ -32,6 +32,8 @@
  */
 package com.tari.android.wallet.ffi
 
+import java.nio.ByteBuffer
+
 /**
  * Tari pending inbound transactions wrapper.
  *
@@ -47,6 +49,8 @@ internal class FFIPendingInboundTxs() : FFIBase() {
         libError: FFIError
     ): FFIPointer
 
+    private external fun jniWriteSnapshot(buffer: ByteBuffer, libError: FFIError): Int
+
     private external fun jniDestroy()
 
     // endregion
@@ -69,6 +73,11 @@ internal class FFIPendingInboundTxs() : FFIBase() {
         return result
     }
 
+    /**
+     * Every tx of the collection in a single native call, see TxSnapshot.
+     */
+    fun getSnapshot(): List<TxSnapshotRecord> = TxSnapshot.take(::jniWriteSnapshot)
+
     override fun destroy() {
         jniDestroy()
     }
@@ -32,8 +32,6 @@
  */
 package com.tari.android.wallet.ffi
 
-import java.math.BigInteger
-
 /**
  * Pending outbound transaction wrapper.
  *
@@ -43,22 +41,22 @@ internal class FFIPendingOutboundTx() : FFIBase() {
 
     // region JNI
 
-    private external fun jniGetId(libError: FFIError): ByteArray
+    private external fun jniGetId(libError: FFIError): Long
     private external fun jniGetDestinationPublicKey(
         libError: FFIError
     ): FFIPointer
 
     private external fun jniGetAmount(
         libError: FFIError
-    ): ByteArray
+    ): Long
 
     private external fun jniGetFee(
         libError: FFIError
-    ): ByteArray
+    ): Long
 
     private external fun jniGetTimestamp(
         libError: FFIError
-    ): ByteArray
+    ): Long
 
     private external fun jniGetMessage(
         libError: FFIError
@@ -76,11 +74,11 @@ internal class FFIPendingOutboundTx() : FFIBase() {
         this.pointer = pointer
     }
 
-    fun getId(): BigInteger {
+    fun getId(): UnsignedLong {
         val error = FFIError()
-        val bytes = jniGetId(error)
+        val bits = jniGetId(error)
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
     fun getDestinationPublicKey(): FFIPublicKey {
@@ -90,25 +88,25 @@ internal class FFIPendingOutboundTx() : FFIBase() {
         return result
     }
 
-    fun getAmount(): BigInteger {
+    fun getAmount(): UnsignedLong {
         val error = FFIError()
-        val bytes = jniGetAmount(error)
+        val bits = jniGetAmount(error)
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
-    fun getFee(): BigInteger {
+    fun getFee(): UnsignedLong {
         val error = FFIError()
-        val bytes = jniGetFee(error)
+        val bits = jniGetFee(error)
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
-    fun getTimestamp(): BigInteger {
+    fun getTimestamp(): UnsignedLong {
         val error = FFIError()
-        val bytes = jniGetTimestamp(error)
+        val bits = jniGetTimestamp(error)
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
     fun getMessage(): String {
@@ -53,6 +53,7 @@ internal class FFIPrivateKey private constructor() : FFIBase() {
 
     private external fun jniGenerate()
     private external fun jniFromHex(hexStr: String, libError: FFIError)
+    private external fun jniGetHex(libError: FFIError): String
 
     // endregion
 
@@ -91,7 +92,7 @@ internal class FFIPrivateKey private constructor() : FFIBase() {
 
     override fun toString(): String {
         val error = FFIError()
-        val result = FFIByteVector(jniGetBytes(error)).toString()
+        val result = jniGetHex(error)
         throwIf(error)
         return result
     }
@@ -52,6 +52,7 @@ internal class FFIPublicKey() : FFIBase() {
     )
 
     private external fun jniFromHex(hexStr: String, libError: FFIError)
+    private external fun jniGetHex(libError: FFIError): String
 
     private external fun jniFromEmojiId(emoji: String, libError: FFIError)
 
@@ -64,8 +65,80 @@ internal class FFIPublicKey() : FFIBase() {
         libError: FFIError
     ): String
 
+    private external fun jniGetEmojiIdCacheStats(): LongArray
+
+    private external fun jniValidateEmojiId(emojiId: String): Long
+
     // endregion
 
+    /**
+     * Counters of the native emoji ID cache shared by all keys. Emoji ID lookups are
+     * [getEmojiId] calls, key lookups are keys built from an emoji ID.
+     */
+    class EmojiIdCacheStats(
+        val emojiIdHits: Long,
+        val emojiIdMisses: Long,
+        val keyHits: Long,
+        val keyMisses: Long,
+        val evictions: Long,
+        val size: Long
+    ) {
+        val emojiIdHitRate: Double
+            get() = rate(emojiIdHits, emojiIdMisses)
+
+        val keyHitRate: Double
+            get() = rate(keyHits, keyMisses)
+
+        private fun rate(hits: Long, misses: Long): Double =
+            if (hits + misses == 0L) 0.0 else hits.toDouble() / (hits + misses)
+
+        override fun toString(): String = "EmojiIdCacheStats(emojiIdHits=$emojiIdHits, " +
+                "emojiIdMisses=$emojiIdMisses, keyHits=$keyHits, keyMisses=$keyMisses, " +
+                "evictions=$evictions, size=$size)"
+    }
+
+    /**
+     * Result of [validateEmojiId]. [position] is the UTF-16 index of the first emoji in error,
+     * the string length if it is too short, or -1 if it is valid.
+     */
+    class EmojiIdValidation(val error: Int, val position: Int) {
+
+        val isValid: Boolean
+            get() = error == VALID
+
+        override fun toString(): String = "EmojiIdValidation(error=$error, position=$position)"
+
+        companion object {
+            const val VALID = 0
+            const val NOT_AN_EMOJI = 1
+            const val TOO_SHORT = 2
+            const val TOO_LONG = 3
+            const val CHECKSUM = 4
+        }
+    }
+
+    companion object {
+
+        // receiver of the natives that do not touch a key, so no FFIBase is allocated per call
+        private val instance = FFIPublicKey()
+
+        /**
+         * Checks length, alphabet and checksum of an emoji ID natively without building a key,
+         * cheap enough to run on every keystroke. A valid emoji ID may still fail to convert to
+         * a key.
+         */
+        fun validateEmojiId(emojiId: String): EmojiIdValidation {
+            val result = instance.jniValidateEmojiId(emojiId)
+            return EmojiIdValidation((result ushr 32).toInt(), result.toInt())
+        }
+
+        fun getEmojiIdCacheStats(): EmojiIdCacheStats {
+            val stats = instance.jniGetEmojiIdCacheStats()
+            return EmojiIdCacheStats(stats[0], stats[1], stats[2], stats[3], stats[4], stats[5])
+        }
+
+    }
+
     constructor(pointer: FFIPointer): this() {
         this.pointer = pointer
     }
@@ -86,6 +159,9 @@ internal class FFIPublicKey() : FFIBase() {
         }
     }
 
+    /**
+     * Keys built from the same emoji ID may share one native handle, see jniEmojiIdCache.cpp.
+     */
     constructor(emojiId: String) : this() {
         val error = FFIError()
         jniFromEmojiId(emojiId, error)
@@ -114,7 +190,7 @@ internal class FFIPublicKey() : FFIBase() {
 
     override fun toString(): String {
         val error = FFIError()
-        val result = FFIByteVector(jniGetBytes(error)).toString()
+        val result = jniGetHex(error)
         throwIf(error)
         return result
     }
@@ -0,0 +1,93 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+package com.tari.android.wallet.ffi
+
+/**
+ * Native column-oriented tx table built by FFIWallet.getTxTable and getTxChangesSince, see
+ * jniTxCache.cpp. Only lives long enough to copy its columns into a TxTable.
+ *
+ * @author The Tari Development Team
+ */
+internal class FFITxTable() : FFIBase() {
+
+    // region JNI
+
+    private external fun jniGetRowCount(): Int
+    private external fun jniGetGeneration(): Long
+    private external fun jniGetTotalRowCount(): Int
+    private external fun jniIsComplete(): Boolean
+    private external fun jniCopyLongColumn(column: Int, out: LongArray, libError: FFIError)
+    private external fun jniCopyIntColumn(column: Int, out: IntArray, libError: FFIError)
+    private external fun jniGetStrings(libError: FFIError): Array<String>
+    private external fun jniDestroy()
+
+    // endregion
+
+    constructor(pointer: FFIPointer) : this() {
+        this.pointer = pointer
+    }
+
+    fun toTxTable(): TxTable {
+        val rowCount = jniGetRowCount()
+        val longColumns = Array(TxTable.LONG_COLUMN_COUNT) { column ->
+            LongArray(rowCount).also {
+                val error = FFIError()
+                jniCopyLongColumn(column, it, error)
+                throwIf(error)
+            }
+        }
+        val intColumns = Array(TxTable.INT_COLUMN_COUNT) { column ->
+            IntArray(rowCount).also {
+                val error = FFIError()
+                jniCopyIntColumn(column, it, error)
+                throwIf(error)
+            }
+        }
+        val error = FFIError()
+        val strings = jniGetStrings(error)
+        throwIf(error)
+        return TxTable(
+            longColumns,
+            intColumns,
+            strings,
+            jniGetGeneration(),
+            jniGetTotalRowCount(),
+            jniIsComplete()
+        )
+    }
+
+    override fun destroy() {
+        jniDestroy()
+    }
+
+}
@@ -45,6 +45,88 @@ internal class FFIUtil {
         libError: FFIError
     )
 
+    private external fun jniMeasurePointerAccess(
+        target: FFIBase,
+        iterations: Int,
+        cached: Boolean
+    ): Long
+
+    private external fun jniGetLoadStats(): LongArray
+
+    private external fun jniGetEmojiAlphabet(): Array<String>
+
+    private external fun jniDecodeUtf8(utf8: ByteArray): String
+
+    private external fun jniMeasureStringCreation(
+        utf8: ByteArray,
+        iterations: Int,
+        transcoded: Boolean
+    ): Long
+
+    private external fun jniGetHandleStats(): LongArray
+
+    private external fun jniSetHandleSiteRecording(enabled: Boolean)
+
+    private external fun jniDumpHandleStats(): String
+
+    private external fun jniStartFfiTrace(path: String, captureStrings: Boolean): Boolean
+
+    private external fun jniStopFfiTrace(): Long
+
+    private external fun jniDumpCallStats(): String
+
+    private external fun jniSetTimelineRecording(enabled: Boolean): Boolean
+
+    private external fun jniWriteTimeline(path: String): Long
+
+    /**
+     * @param staticRegistration true if native methods were bound in JNI_OnLoad, false if the
+     * VM resolves them by exported symbol name on first call
+     */
+    class LoadStats(
+        val staticRegistration: Boolean,
+        val onLoadNanos: Long,
+        val registeredMethodCount: Int
+    ) {
+        override fun toString(): String = "LoadStats(staticRegistration=$staticRegistration, " +
+                "onLoadNanos=$onLoadNanos, registeredMethodCount=$registeredMethodCount)"
+    }
+
+    /**
+     * Types of the handles counted by the native layer. Keep in sync with HandleType in
+     * jniHandleStats.cpp.
+     */
+    enum class HandleType {
+        STRING,
+        BYTE_VECTOR,
+        PRIVATE_KEY,
+        PUBLIC_KEY,
+        CONTACT,
+        CONTACTS,
+        COMPLETED_TX,
+        COMPLETED_TXS,
+        PENDING_INBOUND_TX,
+        PENDING_INBOUND_TXS,
+        PENDING_OUTBOUND_TX,
+        PENDING_OUTBOUND_TXS,
+        TRANSACTION_KERNEL,
+        SEED_WORDS,
+        EMOJI_SET,
+        TRANSPORT_TYPE,
+        COMMS_CONFIG,
+        WALLET
+    }
+
+    class HandleStats(
+        val created: Long,
+        val destroyed: Long,
+        val live: Long,
+        val highWater: Long
+    ) {
+        override fun toString(): String = "HandleStats(created=$created, destroyed=$destroyed, " +
+                "live=$live, highWater=$highWater)"
+    }
+
     companion object {
 
         private val instance = FFIUtil()
@@ -58,6 +140,98 @@ internal class FFIUtil {
             instance.jniDoPartialBackup(sourceFilePath, targetFilePath, error)
             throwIf(error)
         }
+
+        /**
+         * Returns the time in nanoseconds spent reading the native pointer of [target]
+         * [iterations] times, either through the cached field ID or through a per-call
+         * class and field ID lookup.
+         */
+        fun measurePointerAccess(target: FFIBase, iterations: Int, cached: Boolean): Long =
+            instance.jniMeasurePointerAccess(target, iterations, cached)
+
+        fun getLoadStats(): LoadStats {
+            val stats = instance.jniGetLoadStats()
+            return LoadStats(stats[0] != 0L, stats[1], stats[2].toInt())
+        }
+
+        /**
+         * The emoji alphabet of emoji IDs in index order, read from the table compiled into the
+         * native library rather than one FFIEmojiSet entry at a time.
+         */
+        fun getEmojiAlphabet(): Array<String> = instance.jniGetEmojiAlphabet()
+
+        /**
+         * Decodes [utf8] the way strings returned by the wallet library are decoded.
+         */
+        fun decodeUtf8(utf8: ByteArray): String = instance.jniDecodeUtf8(utf8)
+
+        /**
+         * Returns the time in nanoseconds spent creating a string from [utf8] [iterations]
+         * times, either through the native transcoder or through NewStringUTF.
+         */
+        fun measureStringCreation(utf8: ByteArray, iterations: Int, transcoded: Boolean): Long =
+            instance.jniMeasureStringCreation(utf8, iterations, transcoded)
+
+        /**
+         * Counters of the handles and strings returned by the wallet library, per type.
+         */
+        fun getHandleStats(): Map<HandleType, HandleStats> {
+            val values = instance.jniGetHandleStats()
+            return HandleType.values().associateWith {
+                val offset = it.ordinal * HANDLE_COUNTER_COUNT
+                HandleStats(values[offset], values[offset + 1], values[offset + 2], values[offset + 3])
+            }
+        }
+
+        /**
+         * While enabled, every live handle is attributed to the native call site that created
+         * it and [dumpHandleStats] lists them. Costs a map update per handle.
+         */
+        fun setHandleSiteRecording(enabled: Boolean) = instance.jniSetHandleSiteRecording(enabled)
+
+        /**
+         * Logs and returns a report of the handle counters, and of the live handles per call
+         * site while site recording is enabled.
+         */
+        fun dumpHandleStats(): String = instance.jniDumpHandleStats()
+
+        /**
+         * Records every wallet library call and callback into a binary trace at [path] until
+         * [stopFfiTrace], for replay on a host by the ffi_replay tool. Strings are recorded by
+         * length only unless [captureStrings] is set; passphrases never are. Returns false if
+         * native-lib was built without TARI_JNI_FFI_TRACE or a trace is already being recorded.
+         */
+        fun startFfiTrace(path: String, captureStrings: Boolean = false): Boolean =
+            instance.jniStartFfiTrace(path, captureStrings)
+
+        /**
+         * Closes the trace and returns its size in bytes, or -1 if no trace was being recorded
+         * or writing it failed.
+         */
+        fun stopFfiTrace(): Long = instance.jniStopFfiTrace()
+
+        /**
+         * Logs and returns the call counts and latency percentiles of every native method and
+         * wallet callback called so far, if native-lib was built with TARI_JNI_CALL_STATS.
+         */
+        fun dumpCallStats(): String = instance.jniDumpCallStats()
+
+        /**
+         * While enabled, every wallet library call, wallet callback and delivery of wallet
+         * events to the listeners is recorded as a span, the newest ones per thread kept in a
+         * ring. Returns false if native-lib was built without TARI_JNI_TIMELINE.
+         */
+        fun setTimelineRecording(enabled: Boolean): Boolean =
+            instance.jniSetTimelineRecording(enabled)
+
+        /**
+         * Moves the spans recorded since the last call into a Chrome trace JSON file at [path],
+         * to be opened in ui.perfetto.dev or chrome://tracing. Returns the number of spans
+         * written, or -1 if the file cannot be written.
+         */
+        fun writeTimeline(path: String): Long = instance.jniWriteTimeline(path)
+
+        private const val HANDLE_COUNTER_COUNT = 4
     }
 
 }
\ No newline at end of file
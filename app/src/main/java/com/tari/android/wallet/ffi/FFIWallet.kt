@@ -62,6 +62,21 @@ internal class FFIWallet(
         var instance: FFIWallet?
             get() = atomicInstance.get()
             set(value) = atomicInstance.set(value)
+
+        // wallet event batch layout, keep in sync with jniWalletEvents.cpp
+        private const val EVENT_STRIDE = 4
+        private const val EVENT_TX_RECEIVED = 1
+        private const val EVENT_TX_REPLY_RECEIVED = 2
+        private const val EVENT_TX_FINALIZED = 3
+        private const val EVENT_TX_BROADCAST = 4
+        private const val EVENT_TX_MINED = 5
+        private const val EVENT_TX_MINED_UNCONFIRMED = 6
+        private const val EVENT_DIRECT_SEND_RESULT = 7
+        private const val EVENT_STORE_AND_FORWARD_SEND_RESULT = 8
+        private const val EVENT_TX_CANCELLED = 9
+        private const val EVENT_TXO_VALIDATION_COMPLETE = 10
+        private const val EVENT_TX_VALIDATION_COMPLETE = 11
+        private const val EVENT_RECOVERY = 12
     }
 
     // region JNI
@@ -73,28 +88,8 @@ internal class FFIWallet(
         rollingLogFileMaxSizeBytes: Int,
         passphrase: String?,
         seedWords: FFISeedWords?,
-        callbackReceivedTx: String,
-        callbackReceivedTxSig: String,
-        callbackReceivedTxReply: String,
-        callbackReceivedTxReplySig: String,
-        callbackReceivedFinalizedTx: String,
-        callbackReceivedFinalizedTxSig: String,
-        callbackTxBroadcast: String,
-        callbackTxBroadcastSig: String,
-        callbackTxMined: String,
-        callbackTxMinedSig: String,
-        callbackTxMinedUnconfirmed: String,
-        callbackTxMinedUnconfirmedSig: String,
-        callbackDirectSendResult: String,
-        callbackDirectSendResultSig: String,
-        callbackStoreAndForwardSendResult: String,
-        callbackStoreAndForwardSendResultSig: String,
-        callbackTxCancellation: String,
-        callbackTxCancellationSig: String,
-        callbackTXOValidationComplete: String,
-        callbackTXOValidationCompleteSig: String,
-        callbackTransactionValidationComplete: String,
-        callbackTransactionValidationCompleteSig: String,
+        callbackEvents: String,
+        callbackEventsSig: String,
         libError: FFIError
     )
 
@@ -108,15 +103,15 @@ internal class FFIWallet(
 
     private external fun jniGetAvailableBalance(
         libError: FFIError
-    ): ByteArray
+    ): Long
 
     private external fun jniGetPendingIncomingBalance(
         libError: FFIError
-    ): ByteArray
+    ): Long
 
     private external fun jniGetPendingOutgoingBalance(
         libError: FFIError
-    ): ByteArray
+    ): Long
 
     private external fun jniGetContacts(libError: FFIError): FFIPointer
 
@@ -138,16 +133,54 @@ internal class FFIWallet(
         libError: FFIError
     ): FFIPointer
 
+    private external fun jniGetTxTable(
+        libError: FFIError
+    ): FFIPointer
+
+    private external fun jniGetTxChangesSince(
+        generation: Long,
+        libError: FFIError
+    ): FFIPointer
+
+    private external fun jniGetTxPage(
+        sortKey: Int,
+        descending: Boolean,
+        kindMask: Int,
+        offset: Int,
+        limit: Int,
+        libError: FFIError
+    ): FFIPointer
+
+    private external fun jniSearchTxs(
+        query: String,
+        limit: Int,
+        libError: FFIError
+    ): LongArray
+
+    // The String variants of the id, amount and count natives below are decimal compatibility
+    // shims over the *U64 ones, which take the raw unsigned 64-bit pattern. Both forms accept
+    // ids over the full 64 bits, and reject amounts, fees and counts of 2^63 and above with
+    // WalletErrorCode.INVALID_ARGUMENT.
     private external fun jniGetCompletedTxById(
         id: String,
         libError: FFIError
     ): FFIPointer
 
+    private external fun jniGetCompletedTxByIdU64(
+        id: Long,
+        libError: FFIError
+    ): FFIPointer
+
     private external fun jniGetCancelledTxById(
         id: String,
         libError: FFIError
     ): FFIPointer
 
+    private external fun jniGetCancelledTxByIdU64(
+        id: Long,
+        libError: FFIError
+    ): FFIPointer
+
     private external fun jniGetPendingOutboundTxs(
         libError: FFIError
     ): FFIPointer
@@ -157,6 +190,11 @@ internal class FFIWallet(
         libError: FFIError
     ): FFIPointer
 
+    private external fun jniGetPendingOutboundTxByIdU64(
+        id: Long,
+        libError: FFIError
+    ): FFIPointer
+
     private external fun jniGetPendingInboundTxs(
         libError: FFIError
     ): FFIPointer
@@ -166,18 +204,36 @@ internal class FFIWallet(
         libError: FFIError
     ): FFIPointer
 
+    private external fun jniGetPendingInboundTxByIdU64(
+        id: Long,
+        libError: FFIError
+    ): FFIPointer
+
     private external fun jniCancelPendingTx(
         id: String,
         libError: FFIError
     ): Boolean
 
+    private external fun jniCancelPendingTxU64(
+        id: Long,
+        libError: FFIError
+    ): Boolean
+
     private external fun jniSendTx(
         publicKeyPtr: FFIPublicKey,
         amount: String,
         feePerGram: String,
         message: String,
         libError: FFIError
-    ): ByteArray
+    ): Long
+
+    private external fun jniSendTxU64(
+        publicKeyPtr: FFIPublicKey,
+        amount: Long,
+        feePerGram: Long,
+        message: String,
+        libError: FFIError
+    ): Long
 
     private external fun jniCoinSplit(
         amount: String,
@@ -186,7 +242,16 @@ internal class FFIWallet(
         message: String,
         lockHeight: String,
         libError: FFIError
-    ): ByteArray
+    ): Long
+
+    private external fun jniCoinSplitU64(
+        amount: Long,
+        splitCount: Long,
+        fee: Long,
+        message: String,
+        lockHeight: Long,
+        libError: FFIError
+    ): Long
 
     private external fun jniSignMessage(
         message: String,
@@ -206,7 +271,15 @@ internal class FFIWallet(
         amount: String,
         message: String,
         libError: FFIError
-    ): ByteArray
+    ): Long
+
+    private external fun jniImportUTXOU64(
+        spendingKey: FFIPrivateKey,
+        sourcePublicKey: FFIPublicKey,
+        amount: Long,
+        message: String,
+        libError: FFIError
+    ): Long
 
     private external fun jniAddBaseNodePeer(
         publicKey: FFIPublicKey,
@@ -216,15 +289,15 @@ internal class FFIWallet(
 
     private external fun jniStartTXOValidation(
         libError: FFIError
-    ): ByteArray
+    ): Long
 
     private external fun jniStartTxValidation(
         libError: FFIError
-    ): ByteArray
+    ): Long
 
     private external fun jniRestartTxBroadcast(
         libError: FFIError
-    ): ByteArray
+    ): Long
 
     private external fun jniPowerModeNormal(
         libError: FFIError
@@ -256,20 +329,33 @@ internal class FFIWallet(
 
     private external fun jniGetConfirmations(
         libError: FFIError
-    ): ByteArray
+    ): Long
 
     private external fun jniSetConfirmations(
         number: String,
         libError: FFIError
     )
 
+    private external fun jniSetConfirmationsU64(
+        number: Long,
+        libError: FFIError
+    )
+
     private external fun jniEstimateTxFee(
         amount: String,
         gramFee: String,
         kernelCount: String,
         outputCount: String,
         libError: FFIError
-    ): ByteArray
+    ): Long
+
+    private external fun jniEstimateTxFeeU64(
+        amount: Long,
+        gramFee: Long,
+        kernelCount: Long,
+        outputCount: Long,
+        libError: FFIError
+    ): Long
 
     /*
     private external fun jniGenerateTestData(
@@ -316,15 +402,58 @@ internal class FFIWallet(
 
     private external fun jniStartRecovery(
         base_node_public_key: FFIPublicKey,
-        callback: String,
-        callback_sig: String,
         libError: FFIError
     ) : Boolean
 
+    private external fun jniGetCallbackStats(): LongArray
+
+    private external fun jniSetConfirmationCoalescingWindow(windowMillis: Long)
+
+    private external fun jniGetEventQueueStats(): LongArray
+
     private external fun jniDestroy()
 
     // endregion
 
+    /**
+     * Callback thread attachment counters: threads attached to the VM, callbacks that found
+     * their thread already attached, and attached threads that have exited.
+     */
+    class CallbackStats(
+        val threadAttachCount: Long,
+        val threadAttachAvoidedCount: Long,
+        val threadDetachCount: Long
+    ) {
+        override fun toString(): String = "CallbackStats(threadAttachCount=$threadAttachCount, " +
+                "threadAttachAvoidedCount=$threadAttachAvoidedCount, " +
+                "threadDetachCount=$threadDetachCount)"
+    }
+
+    /**
+     * Wallet event queue statistics. Latencies are measured from the native callback to the
+     * start of the batch that delivers the event.
+     */
+    class EventQueueStats(
+        val queueDepth: Long,
+        val maxQueueDepth: Long,
+        val postedCount: Long,
+        val droppedCount: Long,
+        val dispatchedCount: Long,
+        val batchCount: Long,
+        val totalLatencyNanos: Long,
+        val maxLatencyNanos: Long,
+        val coalescedCount: Long
+    ) {
+        val averageLatencyNanos: Long
+            get() = if (dispatchedCount == 0L) 0 else totalLatencyNanos / dispatchedCount
+
+        override fun toString(): String = "EventQueueStats(queueDepth=$queueDepth, " +
+                "maxQueueDepth=$maxQueueDepth, postedCount=$postedCount, " +
+                "droppedCount=$droppedCount, dispatchedCount=$dispatchedCount, " +
+                "batchCount=$batchCount, averageLatencyNanos=$averageLatencyNanos, " +
+                "maxLatencyNanos=$maxLatencyNanos, coalescedCount=$coalescedCount)"
+    }
+
     var listener: FFIWalletListener? = null
 
     // this acts as a constructor would for a normal class since constructors are not allowed for
@@ -332,6 +461,7 @@ internal class FFIWallet(
     init {
         if (pointer == nullptr) { // so it can only be assigned once for the singleton
             val error = FFIError()
+            setConfirmationCoalescingWindow(Constants.Wallet.confirmationCoalescingWindowMs)
             Logger.i("Pre jniCreate.")
             try {
                 jniCreate(
@@ -341,17 +471,7 @@ internal class FFIWallet(
                     Constants.Wallet.rollingLogFileMaxSizeBytes,
                     sharedPrefsRepository.databasePassphrase,
                     seedPhraseRepository.getPhrase()?.ffiSeedWords,
-                    this::onTxReceived.name, "(J)V",
-                    this::onTxReplyReceived.name, "(J)V",
-                    this::onTxFinalized.name, "(J)V",
-                    this::onTxBroadcast.name, "(J)V",
-                    this::onTxMined.name, "(J)V",
-                    this::onTxMinedUnconfirmed.name, "(J[B)V",
-                    this::onDirectSendResult.name, "([BZ)V",
-                    this::onStoreAndForwardSendResult.name, "([BZ)V",
-                    this::onTxCancelled.name, "(J)V",
-                    this::onTXOValidationComplete.name, "([BI)V",
-                    this::onTxValidationComplete.name, "([BI)V",
+                    this::onEvents.name, "([JI)V",
                     error
                 )
             } catch (e: Throwable) {
@@ -381,25 +501,25 @@ internal class FFIWallet(
         }
     }
 
-    fun getAvailableBalance(): BigInteger {
+    fun getAvailableBalance(): UnsignedLong {
         val error = FFIError()
-        val bytes = jniGetAvailableBalance(error)
+        val bits = jniGetAvailableBalance(error)
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
-    fun getPendingInboundBalance(): BigInteger {
+    fun getPendingInboundBalance(): UnsignedLong {
         val error = FFIError()
-        val bytes = jniGetPendingIncomingBalance(error)
+        val bits = jniGetPendingIncomingBalance(error)
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
-    fun getPendingOutboundBalance(): BigInteger {
+    fun getPendingOutboundBalance(): UnsignedLong {
         val error = FFIError()
-        val bytes = jniGetPendingOutgoingBalance(error)
+        val bits = jniGetPendingOutgoingBalance(error)
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
     fun getPublicKey(): FFIPublicKey {
@@ -444,16 +564,89 @@ internal class FFIWallet(
         return result
     }
 
-    fun getCompletedTxById(id: BigInteger): FFICompletedTx {
+    /**
+     * Completed, cancelled and pending txs as one column-oriented table.
+     */
+    fun getTxTable(): TxTable {
+        val error = FFIError()
+        val tableFFI = FFITxTable(jniGetTxTable(error))
+        throwIf(error)
+        return try {
+            tableFFI.toTxTable()
+        } finally {
+            tableFFI.destroy()
+        }
+    }
+
+    /**
+     * Txs inserted, updated or removed after [generation], from the native tx cache that the
+     * wallet callbacks keep current. Pass 0 for a full load and the returned table's generation on
+     * the next call. The cache forgets old removals, so a [generation] that fell too far behind
+     * (or is from an earlier wallet) gets a table with isComplete set, which replaces the txs
+     * loaded so far.
+     */
+    fun getTxChangesSince(generation: Long): TxTable {
+        val error = FFIError()
+        val tableFFI = FFITxTable(jniGetTxChangesSince(generation, error))
+        throwIf(error)
+        return try {
+            tableFFI.toTxTable()
+        } finally {
+            tableFFI.destroy()
+        }
+    }
+
+    /**
+     * Up to [limit] txs starting at [offset] of the completed, cancelled and pending history
+     * merged into one ordering by [sortKey] (TxTable.SORT_BY_*), ties broken by tx id.
+     * [kindMask] selects kinds as bits `1 shl TxTable.KIND_*`. The table's totalCount is the
+     * number of matching txs, and a changed generation between pages means the ordering moved.
+     */
+    fun getTxPage(
+        sortKey: Int = TxTable.SORT_BY_TIMESTAMP,
+        descending: Boolean = true,
+        kindMask: Int = TxTable.ALL_KINDS,
+        offset: Int = 0,
+        limit: Int
+    ): TxTable {
+        val error = FFIError()
+        val tableFFI = FFITxTable(
+            jniGetTxPage(sortKey, descending, kindMask, offset, limit, error)
+        )
+        throwIf(error)
+        return try {
+            tableFFI.toTxTable()
+        } finally {
+            tableFFI.destroy()
+        }
+    }
+
+    /**
+     * Ids of up to [limit] completed, cancelled or pending txs whose message or counterparty
+     * contact alias contains [query], ignoring case for ASCII letters. Matches at the start of a
+     * word rank first, then txs matching on both message and alias, then the most recent.
+     */
+    fun searchTxs(query: String, limit: Int): List<UnsignedLong> {
+        val error = FFIError()
+        val ids = jniSearchTxs(query, limit, error)
+        throwIf(error)
+        return ids.map { UnsignedLong(it) }
+    }
+
+    fun getCompletedTxById(id: BigInteger): FFICompletedTx = getCompletedTxById(UnsignedLong.of(id))
+
+    fun getCompletedTxById(id: UnsignedLong): FFICompletedTx {
         val error = FFIError()
-        val result = FFICompletedTx(jniGetCompletedTxById(id.toString(), error))
+        val result = FFICompletedTx(jniGetCompletedTxByIdU64(id.bits, error))
         throwIf(error)
         return result
     }
 
-    fun getCancelledTxById(id: BigInteger): FFICompletedTx {
+    fun getCancelledTxById(id: BigInteger): FFICompletedTx = getCancelledTxById(UnsignedLong.of(id))
+
+    fun getCancelledTxById(id: UnsignedLong): FFICompletedTx {
         val error = FFIError()
-        val result = FFICompletedTx(jniGetCancelledTxById(id.toString(), error))
+        val result = FFICompletedTx(jniGetCancelledTxByIdU64(id.bits, error))
         throwIf(error)
         return result
     }
@@ -465,10 +658,11 @@ internal class FFIWallet(
         return result
     }
 
-    fun getPendingOutboundTxById(id: BigInteger): FFIPendingOutboundTx {
+    fun getPendingOutboundTxById(id: BigInteger): FFIPendingOutboundTx = getPendingOutboundTxById(UnsignedLong.of(id))
+
+    fun getPendingOutboundTxById(id: UnsignedLong): FFIPendingOutboundTx {
         val error = FFIError()
-        val result =
-            FFIPendingOutboundTx(jniGetPendingOutboundTxById(id.toString(), error))
+        val result = FFIPendingOutboundTx(jniGetPendingOutboundTxByIdU64(id.bits, error))
         throwIf(error)
         return result
     }
@@ -480,26 +674,65 @@ internal class FFIWallet(
         return result
     }
 
-    fun getPendingInboundTxById(id: BigInteger): FFIPendingInboundTx {
+    fun getPendingInboundTxById(id: BigInteger): FFIPendingInboundTx = getPendingInboundTxById(UnsignedLong.of(id))
+
+    fun getPendingInboundTxById(id: UnsignedLong): FFIPendingInboundTx {
         val error = FFIError()
-        val result =
-            FFIPendingInboundTx(jniGetPendingInboundTxById(id.toString(), error))
+        val result = FFIPendingInboundTx(jniGetPendingInboundTxByIdU64(id.bits, error))
         throwIf(error)
         return result
     }
 
-    fun cancelPendingTx(id: BigInteger): Boolean {
+    fun cancelPendingTx(id: BigInteger): Boolean = cancelPendingTx(UnsignedLong.of(id))
+
+    fun cancelPendingTx(id: UnsignedLong): Boolean {
         val error = FFIError()
-        val result = jniCancelPendingTx(id.toString(), error)
+        val result = jniCancelPendingTxU64(id.bits, error)
         throwIf(error)
         return result
     }
 
     /**
+     * Receives batched wallet events from the native dispatcher thread, see
+     * jniWalletEvents.cpp for the layout. [events] is reused by the caller after this returns.
      * This callback function cannot be private due to JNI behaviour.
      */
     @Suppress("MemberVisibilityCanBePrivate")
-    fun onTxReceived(pendingInboundTxPtr: FFIPointer) {
+    fun onEvents(events: LongArray, count: Int) {
+        for (index in 0 until count) {
+            val offset = index * EVENT_STRIDE
+            val type = events[offset].toInt()
+            val arg0 = events[offset + 1]
+            val arg1 = events[offset + 2]
+            val arg2 = events[offset + 3]
+            try {
+                when (type) {
+                    EVENT_TX_RECEIVED -> onTxReceived(arg0)
+                    EVENT_TX_REPLY_RECEIVED -> onTxReplyReceived(arg0)
+                    EVENT_TX_FINALIZED -> onTxFinalized(arg0)
+                    EVENT_TX_BROADCAST -> onTxBroadcast(arg0)
+                    EVENT_TX_MINED -> onTxMined(arg0)
+                    EVENT_TX_MINED_UNCONFIRMED -> onTxMinedUnconfirmed(arg0, arg1.toInt())
+                    EVENT_DIRECT_SEND_RESULT ->
+                        onDirectSendResult(UnsignedLong(arg0).toBigInteger(), arg1 != 0L)
+                    EVENT_STORE_AND_FORWARD_SEND_RESULT ->
+                        onStoreAndForwardSendResult(UnsignedLong(arg0).toBigInteger(), arg1 != 0L)
+                    EVENT_TX_CANCELLED -> onTxCancelled(arg0)
+                    EVENT_TXO_VALIDATION_COMPLETE ->
+                        onTXOValidationComplete(UnsignedLong(arg0).toBigInteger(), arg1.toInt())
+                    EVENT_TX_VALIDATION_COMPLETE ->
+                        onTxValidationComplete(UnsignedLong(arg0).toBigInteger(), arg1.toInt())
+                    EVENT_RECOVERY -> onWalletRecovery(arg0.toInt(), arg1, arg2)
+                    else -> Logger.e("Unknown wallet event type: %d.", type)
+                }
+            } catch (e: Throwable) {
+                Sentry.captureException(e)
+                Logger.e(e, "Failed to handle wallet event of type %d.", type)
+            }
+        }
+    }
+
+    private fun onTxReceived(pendingInboundTxPtr: FFIPointer) {
         Logger.i("Tx received. Pointer: %s", pendingInboundTxPtr.toString())
         val tx = FFIPendingInboundTx(pendingInboundTxPtr)
         val id = tx.getId()
@@ -519,11 +752,7 @@ internal class FFIWallet(
         GlobalScope.launch { listener?.onTxReceived(pendingTx) }
     }
 
-    /**
-     * This callback function cannot be private due to JNI behaviour.
-     */
-    @Suppress("MemberVisibilityCanBePrivate")
-    fun onTxReplyReceived(completedTxPtr: FFIPointer) {
+    private fun onTxReplyReceived(completedTxPtr: FFIPointer) {
         Logger.i("Tx reply received. Pointer: %s", completedTxPtr.toString())
         val tx = FFICompletedTx(completedTxPtr)
         val (_, user) = defineParticipantAndDirection(tx)
@@ -540,11 +769,7 @@ internal class FFIWallet(
         GlobalScope.launch { listener?.onTxReplyReceived(pendingOutboundTx) }
     }
 
-    /**
-     * This callback function cannot be private due to JNI behaviour.
-     */
-    @Suppress("MemberVisibilityCanBePrivate")
-    fun onTxFinalized(completedTx: FFIPointer) {
+    private fun onTxFinalized(completedTx: FFIPointer) {
         Logger.i("Tx finalized. Pointer: %s", completedTx.toString())
         val tx = FFICompletedTx(completedTx)
         val (_, user) = defineParticipantAndDirection(tx)
@@ -560,11 +785,7 @@ internal class FFIWallet(
         GlobalScope.launch { listener?.onTxFinalized(pendingInboundTx) }
     }
 
-    /**
-     * This callback function cannot be private due to JNI behaviour.
-     */
-    @Suppress("MemberVisibilityCanBePrivate")
-    fun onTxBroadcast(completedTxPtr: FFIPointer) {
+    private fun onTxBroadcast(completedTxPtr: FFIPointer) {
         Logger.i("Tx completed. Pointer: %s", completedTxPtr.toString())
         val tx = FFICompletedTx(completedTxPtr)
         val (direction, user) = defineParticipantAndDirection(tx)
@@ -596,11 +817,7 @@ internal class FFIWallet(
         tx.destroy()
     }
 
-    /**
-     * This callback function cannot be private due to JNI behaviour.
-     */
-    @Suppress("MemberVisibilityCanBePrivate")
-    fun onTxMined(completedTxPtr: FFIPointer) {
+    private fun onTxMined(completedTxPtr: FFIPointer) {
         Logger.i("Tx mined & confirmed. Pointer: %s", completedTxPtr.toString())
         val tx = FFICompletedTx(completedTxPtr)
         val (direction, user) = defineParticipantAndDirection(tx)
@@ -619,14 +836,9 @@ internal class FFIWallet(
         GlobalScope.launch { listener?.onTxMined(completed) }
     }
 
-    /**
-     * This callback function cannot be private due to JNI behaviour.
-     */
-    @Suppress("MemberVisibilityCanBePrivate")
-    fun onTxMinedUnconfirmed(completedTxPtr: FFIPointer, confirmationCountBytes: ByteArray) {
+    private fun onTxMinedUnconfirmed(completedTxPtr: FFIPointer, confirmationCount: Int) {
         Logger.i("Tx mined & unconfirmed. Pointer: %s", completedTxPtr.toString())
         val tx = FFICompletedTx(completedTxPtr)
-        val confirmationCount = BigInteger(1, confirmationCountBytes).toInt()
         val (direction, user) = defineParticipantAndDirection(tx)
         val completed = CompletedTx(
             tx.getId(),
@@ -643,31 +855,17 @@ internal class FFIWallet(
         GlobalScope.launch { listener?.onTxMinedUnconfirmed(completed, confirmationCount) }
     }
 
-    /**
-     * This callback function cannot be private due to JNI behaviour.
-     */
-    @Suppress("MemberVisibilityCanBePrivate")
-    fun onDirectSendResult(bytes: ByteArray, success: Boolean) {
+    private fun onDirectSendResult(txId: BigInteger, success: Boolean) {
         Logger.i("Direct send result received. Success: $success")
-        val txId = BigInteger(1, bytes)
         GlobalScope.launch { listener?.onDirectSendResult(txId, success) }
     }
 
-    /**
-     * This callback function cannot be private due to JNI behaviour.
-     */
-    @Suppress("MemberVisibilityCanBePrivate")
-    fun onStoreAndForwardSendResult(bytes: ByteArray, success: Boolean) {
+    private fun onStoreAndForwardSendResult(txId: BigInteger, success: Boolean) {
         Logger.i("Store and forward send result received. Success: $success")
-        val txId = BigInteger(1, bytes)
         GlobalScope.launch { listener?.onStoreAndForwardSendResult(txId, success) }
     }
 
-    /**
-     * This callback function cannot be private due to JNI behaviour.
-     */
-    @Suppress("MemberVisibilityCanBePrivate")
-    fun onTxCancelled(completedTx: FFIPointer) {
+    private fun onTxCancelled(completedTx: FFIPointer) {
         Logger.i("Tx cancelled. Pointer: %s", completedTx.toString())
         val tx = FFICompletedTx(completedTx)
         val (direction, user) = defineParticipantAndDirection(tx)
@@ -685,12 +883,7 @@ internal class FFIWallet(
         GlobalScope.launch { listener?.onTxCancelled(cancelled) }
     }
 
-    /**
-     * This callback function cannot be private due to JNI behaviour.
-     */
-    @Suppress("MemberVisibilityCanBePrivate")
-    fun onTXOValidationComplete(bytes: ByteArray, result: Int) {
-        val requestId = BigInteger(1, bytes)
+    private fun onTXOValidationComplete(requestId: BigInteger, result: Int) {
         val validationResult = BaseNodeValidationResult.map(result)!!
         Logger.i("Invalid TXO validation [$requestId] complete. Result: $validationResult")
         GlobalScope.launch {
@@ -698,12 +891,7 @@ internal class FFIWallet(
         }
     }
 
-    /**
-     * This callback function cannot be private due to JNI behaviour.
-     */
-    @Suppress("MemberVisibilityCanBePrivate")
-    fun onTxValidationComplete(bytes: ByteArray, result: Int) {
-        val requestId = BigInteger(1, bytes)
+    private fun onTxValidationComplete(requestId: BigInteger, result: Int) {
         val validationResult = BaseNodeValidationResult.map(result)!!
         Logger.i("Transaction validation [$requestId] complete. Result: $validationResult")
         GlobalScope.launch { listener?.onTxValidationComplete(requestId, validationResult) }
@@ -731,18 +919,18 @@ internal class FFIWallet(
         gramFee: BigInteger,
         kernelCount: BigInteger,
         outputCount: BigInteger
-    ): BigInteger {
+    ): UnsignedLong {
         val error = FFIError()
-        val bytes = jniEstimateTxFee(
-            amount.toString(),
-            gramFee.toString(),
-            kernelCount.toString(),
-            outputCount.toString(),
+        val bits = jniEstimateTxFeeU64(
+            UnsignedLong.of(amount).bits,
+            UnsignedLong.of(gramFee).bits,
+            UnsignedLong.of(kernelCount).bits,
+            UnsignedLong.of(outputCount).bits,
             error
         )
         Logger.d("Tx fee estimate status code (0 means ok): %d", error.code)
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
     fun sendTx(
@@ -750,7 +938,7 @@ internal class FFIWallet(
         amount: BigInteger,
         feePerGram: BigInteger,
         message: String
-    ): BigInteger {
+    ): UnsignedLong {
         if (amount < BigInteger.valueOf(0L)) {
             throw FFIException(message = "Amount is less than 0.")
         }
@@ -758,16 +946,16 @@ internal class FFIWallet(
             throw FFIException(message = "Tx source and destination are the same.")
         }
         val error = FFIError()
-        val bytes = jniSendTx(
+        val bits = jniSendTxU64(
             destination,
-            amount.toString(),
-            feePerGram.toString(),
+            UnsignedLong.of(amount).bits,
+            UnsignedLong.of(feePerGram).bits,
             message,
             error
         )
         Logger.d("Send status code (0 means ok): %d", error.code)
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
     fun coinSplit(
@@ -776,7 +964,7 @@ internal class FFIWallet(
         height: BigInteger,
         fee: BigInteger,
         message: String
-    ): BigInteger {
+    ): UnsignedLong {
         val minimumLibFee = 100L
         if (fee < BigInteger.valueOf(minimumLibFee)) {
             throw FFIException(message = "Fee is less than the minimum of $minimumLibFee taris.")
@@ -786,17 +974,17 @@ internal class FFIWallet(
         }
 
         val error = FFIError()
-        val bytes = jniCoinSplit(
-            amount.toString(),
-            count.toString(),
-            fee.toString(),
+        val bits = jniCoinSplitU64(
+            UnsignedLong.of(amount).bits,
+            UnsignedLong.of(count).bits,
+            UnsignedLong.of(fee).bits,
             message,
-            height.toString(),
+            UnsignedLong.of(height).bits,
             error
         )
         Logger.d("Coin split code (0 means ok): %d", error.code)
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
     fun signMessage(message: String): String {
@@ -823,38 +1011,38 @@ internal class FFIWallet(
         message: String,
         spendingKey: FFIPrivateKey,
         sourcePublicKey: FFIPublicKey
-    ): BigInteger {
+    ): UnsignedLong {
         val error = FFIError()
-        val bytes = jniImportUTXO(
+        val bits = jniImportUTXOU64(
             spendingKey,
             sourcePublicKey,
-            amount.toString(),
+            UnsignedLong.of(amount).bits,
             message,
             error
         )
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
-    fun startTXOValidation(): BigInteger {
+    fun startTXOValidation(): UnsignedLong {
         val error = FFIError()
-        val bytes = jniStartTXOValidation(error)
+        val bits = jniStartTXOValidation(error)
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
-    fun startTxValidation(): BigInteger {
+    fun startTxValidation(): UnsignedLong {
         val error = FFIError()
-        val bytes = jniStartTxValidation(error)
+        val bits = jniStartTxValidation(error)
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
-    fun restartTxBroadcast(): BigInteger {
+    fun restartTxBroadcast(): UnsignedLong {
         val error = FFIError()
-        val bytes = jniRestartTxBroadcast(error)
+        val bits = jniRestartTxBroadcast(error)
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
     fun setPowerModeNormal() {
@@ -911,21 +1099,18 @@ internal class FFIWallet(
         jniLogMessage(message)
     }
 
-    fun getRequiredConfirmationCount(): BigInteger {
+    fun getRequiredConfirmationCount(): UnsignedLong {
         val error = FFIError()
-        val bytes = jniGetConfirmations(
+        val bits = jniGetConfirmations(
             error
         )
         throwIf(error)
-        return BigInteger(1, bytes)
+        return UnsignedLong(bits)
     }
 
     fun setRequiredConfirmationCount(number: BigInteger) {
         val error = FFIError()
-        val bytes = jniSetConfirmations(
-            number.toString(),
-            error
-        )
+        jniSetConfirmationsU64(UnsignedLong.of(number).bits, error)
         throwIf(error)
     }
 
@@ -965,16 +1150,12 @@ internal class FFIWallet(
 
     fun startRecovery(baseNodePublicKey: FFIPublicKey) : Boolean {
         val error = FFIError()
-        val result = jniStartRecovery(baseNodePublicKey, this::onWalletRecovery.name, "(I[B[B)V", error)
+        val result = jniStartRecovery(baseNodePublicKey, error)
         throwIf(error)
         return result
     }
 
-    /**
-     * This callback function cannot be private due to JNI behaviour.
-     */
-    @Suppress("MemberVisibilityCanBePrivate")
-    fun onWalletRecovery(event: Int, firstArg: ByteArray, secondArg: ByteArray) {
+    private fun onWalletRecovery(event: Int, firstArg: Long, secondArg: Long) {
         val result = WalletRestorationResult.create(event, firstArg, secondArg)
         Logger.i("Wallet restoration. Result: $result")
         GlobalScope.launch { listener?.onWalletRestoration(result) }
@@ -985,6 +1166,30 @@ internal class FFIWallet(
         return false
     }
 
+    fun getCallbackStats(): CallbackStats {
+        val stats = jniGetCallbackStats()
+        return CallbackStats(stats[0], stats[1], stats[2])
+    }
+
+    /**
+     * The first mined-unconfirmed update of a transaction is held back for [windowMillis], and
+     * newer updates of the same transaction arriving meanwhile replace it, so it is delivered once
+     * with the newest confirmation count. The window is not extended by the newer updates. A
+     * mined or cancelled event of the transaction drops the held back update. 0 delivers every
+     * update.
+     */
+    fun setConfirmationCoalescingWindow(windowMillis: Long) {
+        jniSetConfirmationCoalescingWindow(windowMillis)
+    }
+
+    fun getEventQueueStats(): EventQueueStats {
+        val stats = jniGetEventQueueStats()
+        return EventQueueStats(
+            stats[0], stats[1], stats[2], stats[3], stats[4], stats[5], stats[6], stats[7],
+            stats[8]
+        )
+    }
+
     override fun destroy() {
         listener = null
         jniDestroy()
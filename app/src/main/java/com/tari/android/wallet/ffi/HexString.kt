@@ -45,12 +45,8 @@ internal class HexString constructor(bytes: FFIByteVector) {
 
     init {
         if (bytes.pointer != nullptr) {
-            val byteArray = ByteArray(bytes.getLength())
-            if (bytes.getLength() > 0) {
-                for (i in 0 until bytes.getLength()) {
-                    val m = bytes.getAt(i)
-                    byteArray[i] = m.toByte()
-                }
+            val byteArray = bytes.getBytes()
+            if (byteArray.isNotEmpty()) {
                 hex = String.format("%064X", BigInteger(1, byteArray))
             } else {
                 hex = String()
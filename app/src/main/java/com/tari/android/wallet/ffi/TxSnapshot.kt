@@ -0,0 +1,147 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+package com.tari.android.wallet.ffi
+
+import java.math.BigInteger
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.util.concurrent.atomic.AtomicInteger
+
+/**
+ * One transaction as serialized by the native jniWriteSnapshot entry points. Fields that the
+ * source tx kind does not have (fee of a pending inbound tx, confirmation count of a pending tx)
+ * are zero.
+ *
+ * @author The Tari Development Team
+ */
+internal class TxSnapshotRecord(
+    val id: UnsignedLong,
+    val amount: UnsignedLong,
+    val fee: UnsignedLong,
+    val timestamp: UnsignedLong,
+    val confirmationCount: UnsignedLong,
+    val status: Int,
+    val isOutbound: Boolean,
+    val counterpartyPublicKey: ByteArray,
+    val message: String
+) {
+
+    /**
+     * Same format as FFIPublicKey.toString().
+     */
+    val counterpartyPublicKeyHex: String
+        get() = String.format("%064X", BigInteger(1, counterpartyPublicKey))
+
+}
+
+/**
+ * Reads the packed tx snapshot layout documented in jniCollections.cpp.
+ *
+ * @author The Tari Development Team
+ */
+internal object TxSnapshot {
+
+    private const val VERSION = 1
+    private const val KEY_SIZE = 32
+    private const val FLAG_OUTBOUND = 1
+
+    /**
+     * Size of the buffer the next snapshot starts with, grown to the largest size seen so that a
+     * steady-state history is written in a single native call.
+     */
+    private val capacityHint = AtomicInteger(16 * 1024)
+
+    /**
+     * Calls [write] with a direct buffer until the snapshot fits, then decodes it. [write]
+     * returns the capacity the snapshot needs, or on overflow an estimate of at least twice the
+     * buffer capacity, so the buffer grows geometrically.
+     */
+    fun take(write: (ByteBuffer, FFIError) -> Int): List<TxSnapshotRecord> {
+        var buffer = ByteBuffer.allocateDirect(capacityHint.get())
+        while (true) {
+            val error = FFIError()
+            val required = write(buffer, error)
+            throwIf(error)
+            if (required <= buffer.capacity()) {
+                // only the exact size, an overflow estimate would oversize every later buffer
+                capacityHint.accumulateAndGet(required) { current, new -> maxOf(current, new) }
+                return read(buffer)
+            }
+            buffer = ByteBuffer.allocateDirect(required)
+        }
+    }
+
+    fun read(buffer: ByteBuffer): List<TxSnapshotRecord> {
+        val input = buffer.duplicate().order(ByteOrder.nativeOrder())
+        input.position(0)
+        val version = input.int
+        if (version != VERSION) {
+            throw FFIException(message = "Unsupported tx snapshot version $version.")
+        }
+        val count = input.int
+        input.limit(input.int)
+        input.int // reserved
+        val records = ArrayList<TxSnapshotRecord>(count)
+        for (i in 0 until count) {
+            val id = UnsignedLong(input.long)
+            val amount = UnsignedLong(input.long)
+            val fee = UnsignedLong(input.long)
+            val timestamp = UnsignedLong(input.long)
+            val confirmationCount = UnsignedLong(input.long)
+            val status = input.int
+            val flags = input.int
+            val publicKey = ByteArray(KEY_SIZE)
+            input.get(publicKey)
+            val messageLength = input.int
+            val messageBytes = ByteArray(messageLength)
+            input.get(messageBytes)
+            // skip the padding to the next 8-byte boundary
+            input.position((input.position() + 7) and 7.inv())
+            records.add(
+                TxSnapshotRecord(
+                    id,
+                    amount,
+                    fee,
+                    timestamp,
+                    confirmationCount,
+                    status,
+                    (flags and FLAG_OUTBOUND) != 0,
+                    publicKey,
+                    String(messageBytes, Charsets.UTF_8)
+                )
+            )
+        }
+        return records
+    }
+
+}
@@ -0,0 +1,164 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+package com.tari.android.wallet.ffi
+
+import java.math.BigInteger
+
+/**
+ * Wallet txs as parallel primitive columns, one row per tx, with messages and counterparty
+ * public keys (uppercase hex) in a deduplicated string pool. Filters and totals scan the arrays
+ * directly instead of going through an FFICompletedTx getter per field.
+ *
+ * A table from FFIWallet.getTxTable holds every tx, one from FFIWallet.getTxChangesSince only the
+ * rows changed after the requested [generation], tagged in [changes].
+ *
+ * Column indices match the enums in jniTxCache.cpp.
+ *
+ * @author The Tari Development Team
+ */
+internal class TxTable(
+    longColumns: Array<LongArray>,
+    intColumns: Array<IntArray>,
+    val strings: Array<String>,
+    val generation: Long,
+    /** Number of txs matching the query when this table is one page of it, see FFIWallet.getTxPage. */
+    val totalCount: Int,
+    /**
+     * The table holds every tx rather than the changes after a generation, replace what was
+     * loaded before instead of applying the rows to it.
+     */
+    val isComplete: Boolean
+) {
+
+    /** Raw unsigned 64-bit values, see UnsignedLong. */
+    val ids = longColumns[COLUMN_ID]
+    val amounts = longColumns[COLUMN_AMOUNT]
+    val fees = longColumns[COLUMN_FEE]
+    val timestamps = longColumns[COLUMN_TIMESTAMP]
+
+    /** FFITxStatus codes. */
+    val statuses = intColumns[COLUMN_STATUS]
+    val kinds = intColumns[COLUMN_KIND]
+    val outbound = intColumns[COLUMN_OUTBOUND]
+    val messageRefs = intColumns[COLUMN_MESSAGE_REF]
+    val counterpartyRefs = intColumns[COLUMN_COUNTERPARTY_REF]
+
+    /** CHANGE_* values, all CHANGE_INSERTED for a full table. */
+    val changes = intColumns[COLUMN_CHANGE]
+
+    val size: Int
+        get() = ids.size
+
+    fun id(row: Int) = UnsignedLong(ids[row])
+
+    fun isOutbound(row: Int) = outbound[row] != 0
+
+    fun message(row: Int) = strings[messageRefs[row]]
+
+    fun counterpartyPublicKeyHex(row: Int) = strings[counterpartyRefs[row]]
+
+    /**
+     * Indices of the rows matching [predicate], in table order.
+     */
+    inline fun rows(predicate: (Int) -> Boolean): IntArray {
+        val result = IntArray(size)
+        var count = 0
+        for (row in 0 until size) {
+            if (predicate(row)) {
+                result[count++] = row
+            }
+        }
+        return result.copyOf(count)
+    }
+
+    /**
+     * Sum of the amounts of [rows]. No single amount, nor the total supply, comes near 2^63
+     * MicroTari, so the sum is accumulated in a signed long.
+     */
+    fun sumAmounts(rows: IntArray): BigInteger {
+        var sum = 0L
+        for (row in rows) {
+            sum += amounts[row]
+        }
+        return BigInteger.valueOf(sum)
+    }
+
+    /**
+     * Approximate heap footprint in bytes: the primitive columns plus the pooled strings
+     * (UTF-16 payload and a fixed per-object overhead).
+     */
+    fun estimateFootprintBytes(): Long {
+        var bytes = size.toLong() * (LONG_COLUMN_COUNT * 8 + INT_COLUMN_COUNT * 4)
+        for (value in strings) {
+            bytes += STRING_OVERHEAD_BYTES + value.length * 2
+        }
+        return bytes
+    }
+
+    companion object {
+        const val KIND_COMPLETED = 0
+        const val KIND_CANCELLED = 1
+        const val KIND_PENDING_INBOUND = 2
+        const val KIND_PENDING_OUTBOUND = 3
+
+        /** Kind mask selecting every kind, see FFIWallet.getTxPage. */
+        const val ALL_KINDS = (1 shl KIND_COMPLETED) or (1 shl KIND_CANCELLED) or
+                (1 shl KIND_PENDING_INBOUND) or (1 shl KIND_PENDING_OUTBOUND)
+
+        const val SORT_BY_TIMESTAMP = 0
+        const val SORT_BY_AMOUNT = 1
+        const val SORT_BY_STATUS = 2
+
+        const val CHANGE_INSERTED = 0
+        const val CHANGE_UPDATED = 1
+        /** Only the id of a removed row is meaningful. */
+        const val CHANGE_REMOVED = 2
+
+        const val COLUMN_ID = 0
+        const val COLUMN_AMOUNT = 1
+        const val COLUMN_FEE = 2
+        const val COLUMN_TIMESTAMP = 3
+        const val LONG_COLUMN_COUNT = 4
+
+        const val COLUMN_STATUS = 0
+        const val COLUMN_KIND = 1
+        const val COLUMN_OUTBOUND = 2
+        const val COLUMN_MESSAGE_REF = 3
+        const val COLUMN_COUNTERPARTY_REF = 4
+        const val COLUMN_CHANGE = 5
+        const val INT_COLUMN_COUNT = 6
+
+        private const val STRING_OVERHEAD_BYTES = 40
+    }
+
+}
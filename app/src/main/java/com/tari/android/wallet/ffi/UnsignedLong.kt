@@ -0,0 +1,71 @@
+/**
+ * Copyright 2020 The Tari Project
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the
+ * following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of
+ * its contributors may be used to endorse or promote products
+ * derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+package com.tari.android.wallet.ffi
+
+import java.math.BigInteger
+
+/**
+ * Unsigned 64-bit value as returned by the wallet library. Native code passes the raw bit
+ * pattern as a jlong, so values above Long.MAX_VALUE arrive negative in [bits].
+ *
+ * @author The Tari Development Team
+ */
+@JvmInline
+internal value class UnsignedLong(val bits: Long) : Comparable<UnsignedLong> {
+
+    /**
+     * Returns [bits] unchanged, callers must know the value fits in a signed long.
+     */
+    fun toLong(): Long = bits
+
+    fun toInt(): Int = bits.toInt()
+
+    fun toBigInteger(): BigInteger =
+        if (bits >= 0) BigInteger.valueOf(bits) else BigInteger.valueOf(bits).add(twoToThe64)
+
+    override fun compareTo(other: UnsignedLong): Int =
+        (bits xor Long.MIN_VALUE).compareTo(other.bits xor Long.MIN_VALUE)
+
+    override fun toString(): String = if (bits >= 0) bits.toString() else toBigInteger().toString()
+
+    companion object {
+        private val twoToThe64 = BigInteger.ONE.shiftLeft(64)
+
+        fun of(value: BigInteger): UnsignedLong {
+            if (value.signum() < 0 || value.bitLength() > 64) {
+                throw FFIException(message = "$value is out of the unsigned 64-bit range.")
+            }
+            return UnsignedLong(value.toLong())
+        }
+    }
+}
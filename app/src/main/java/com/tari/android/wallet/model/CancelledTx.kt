@@ -34,6 +34,7 @@ package com.tari.android.wallet.model
 
 import android.os.Parcel
 import android.os.Parcelable
+import com.tari.android.wallet.ffi.UnsignedLong
 import java.math.BigInteger
 
 /**
@@ -46,22 +47,22 @@ class CancelledTx : Tx, Parcelable {
     val fee: MicroTari
     val status: TxStatus
 
-    constructor(
-        id: BigInteger,
+    internal constructor(
+        id: UnsignedLong,
         direction: Direction,
         user: User,
         amount: MicroTari,
         fee: MicroTari?,
-        timestamp: BigInteger,
+        timestamp: UnsignedLong,
         message: String,
         status: TxStatus
     ) : super() {
-        this.id = id
+        this.unsignedId = id
         this.direction = direction
         this.user = user
         this.amount = amount
         this.fee = fee ?: MicroTari(BigInteger("0"))
-        this.timestamp = timestamp
+        this.unsignedTimestamp = timestamp
         this.message = message
         this.status = status
     }
@@ -34,6 +34,7 @@ package com.tari.android.wallet.model
 
 import android.os.Parcel
 import android.os.Parcelable
+import com.tari.android.wallet.ffi.UnsignedLong
 import java.math.BigInteger
 
 /**
@@ -43,30 +44,46 @@ import java.math.BigInteger
  */
 class CompletedTx() : Tx(), Parcelable {
 
-    var fee = MicroTari(BigInteger("0"))
-    var confirmationCount = BigInteger("0")
+    var fee = MicroTari()
+
+    /**
+     * Raw count as read from the wallet library, [confirmationCount] converts it on first read.
+     */
+    internal var unsignedConfirmationCount = UnsignedLong(0)
+        set(value) {
+            field = value
+            convertedConfirmationCount = null
+        }
+    private var convertedConfirmationCount: BigInteger? = null
+    var confirmationCount: BigInteger
+        get() = convertedConfirmationCount
+            ?: unsignedConfirmationCount.toBigInteger().also { convertedConfirmationCount = it }
+        set(value) {
+            unsignedConfirmationCount = UnsignedLong.of(value)
+            convertedConfirmationCount = value
+        }
     var status = TxStatus.COMPLETED
 
-    constructor(
-        id: BigInteger,
+    internal constructor(
+        id: UnsignedLong,
         direction: Direction,
         user: User,
         amount: MicroTari,
         fee: MicroTari,
-        timestamp: BigInteger,
+        timestamp: UnsignedLong,
         message: String,
         status: TxStatus,
-        confirmationCount: BigInteger
+        confirmationCount: UnsignedLong
     ) : this() {
-        this.id = id
+        this.unsignedId = id
         this.direction = direction
         this.user = user
         this.amount = amount
         this.fee = fee
-        this.timestamp = timestamp
+        this.unsignedTimestamp = timestamp
         this.message = message
         this.status = status
-        this.confirmationCount = confirmationCount
+        this.unsignedConfirmationCount = confirmationCount
     }
 
     // region Parcelable
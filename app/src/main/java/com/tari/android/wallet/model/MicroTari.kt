@@ -35,6 +35,7 @@ package com.tari.android.wallet.model
 import android.os.Parcel
 import android.os.Parcelable
 import com.tari.android.wallet.extension.toMicroTari
+import com.tari.android.wallet.ffi.UnsignedLong
 import java.io.Serializable
 import java.math.BigDecimal
 import java.math.BigInteger
@@ -47,9 +48,16 @@ import java.math.RoundingMode
  */
 class MicroTari() : Parcelable, Comparable<MicroTari>, Serializable {
 
-    var value = BigInteger("0")
+    // raw bits of an unsigned amount read from the wallet library while value has not been read
+    private var unsignedBits = 0L
+    private var convertedValue: BigInteger? = BigInteger.ZERO
+
+    var value: BigInteger
+        get() = convertedValue ?: UnsignedLong(unsignedBits).toBigInteger().also { convertedValue = it }
+        set(value) {
+            convertedValue = value
+        }
 
-    private val million = BigDecimal(1e6)
     val tariValue: BigDecimal
         // Note: BigDecimal keeps track of both precision and scale, 1e6 != 1_000_000 in this case (scale 6, scale 0)
         get() = value.toBigDecimal().divide(million,6,RoundingMode.HALF_UP)
@@ -60,6 +68,16 @@ class MicroTari() : Parcelable, Comparable<MicroTari>, Serializable {
         this.value = value
     }
 
+    /**
+     * An amount read from the wallet library, turned into a BigInteger only once [value] is read.
+     */
+    internal constructor(
+        value: UnsignedLong
+    ) : this() {
+        this.unsignedBits = value.bits
+        this.convertedValue = null
+    }
+
     // region operator overloadings
 
     operator fun plusAssign(increment: MicroTari) {
@@ -104,6 +122,8 @@ class MicroTari() : Parcelable, Comparable<MicroTari>, Serializable {
 
     companion object CREATOR : Parcelable.Creator<MicroTari> {
 
+        private val million = BigDecimal(1e6)
+
         override fun createFromParcel(parcel: Parcel): MicroTari {
             return MicroTari(parcel)
         }
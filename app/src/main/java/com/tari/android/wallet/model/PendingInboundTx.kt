@@ -34,6 +34,7 @@ package com.tari.android.wallet.model
 
 import android.os.Parcel
 import android.os.Parcelable
+import com.tari.android.wallet.ffi.UnsignedLong
 import java.math.BigInteger
 
 /**
@@ -45,19 +46,19 @@ class PendingInboundTx() : Tx(), Parcelable {
 
     var status = TxStatus.PENDING
 
-    constructor(
-        id: BigInteger,
+    internal constructor(
+        id: UnsignedLong,
         user: User,
         amount: MicroTari,
-        timestamp: BigInteger,
+        timestamp: UnsignedLong,
         message: String,
         status: TxStatus
     ) : this() {
-        this.id = id
+        this.unsignedId = id
         this.direction = Direction.INBOUND
         this.user = user
         this.amount = amount
-        this.timestamp = timestamp
+        this.unsignedTimestamp = timestamp
         this.message = message
         this.status = status
     }
@@ -34,6 +34,7 @@ package com.tari.android.wallet.model
 
 import android.os.Parcel
 import android.os.Parcelable
+import com.tari.android.wallet.ffi.UnsignedLong
 import java.math.BigInteger
 
 /**
@@ -43,24 +44,24 @@ import java.math.BigInteger
  */
 class PendingOutboundTx() : Tx(), Parcelable {
 
-    var fee = MicroTari(BigInteger("0"))
+    var fee = MicroTari()
     var status = TxStatus.PENDING
 
-    constructor(
-        id: BigInteger,
+    internal constructor(
+        id: UnsignedLong,
         user: User,
         amount: MicroTari,
         fee: MicroTari,
-        timestamp: BigInteger,
+        timestamp: UnsignedLong,
         message: String,
         status: TxStatus
     ) : this() {
-        this.id = id
+        this.unsignedId = id
         this.direction = Direction.OUTBOUND
         this.user = user
         this.amount = amount
         this.fee = fee
-        this.timestamp = timestamp
+        this.unsignedTimestamp = timestamp
         this.message = message
         this.status = status
     }
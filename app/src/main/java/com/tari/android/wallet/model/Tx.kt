@@ -33,6 +33,7 @@
 package com.tari.android.wallet.model
 
 import android.os.Parcelable
+import com.tari.android.wallet.ffi.UnsignedLong
 import java.math.BigInteger
 
 /**
@@ -47,10 +48,39 @@ abstract class Tx : Parcelable {
         OUTBOUND
     }
 
-    var id = BigInteger("0")
+    /**
+     * Raw id as read from the wallet library, [id] converts it on first read.
+     */
+    internal var unsignedId = UnsignedLong(0)
+        set(value) {
+            field = value
+            convertedId = null
+        }
+    private var convertedId: BigInteger? = null
+    var id: BigInteger
+        get() = convertedId ?: unsignedId.toBigInteger().also { convertedId = it }
+        set(value) {
+            unsignedId = UnsignedLong.of(value)
+            convertedId = value
+        }
     var direction = Direction.INBOUND
-    var amount = MicroTari(BigInteger("0"))
-    var timestamp = BigInteger("0")
+    var amount = MicroTari()
+
+    /**
+     * Raw timestamp as read from the wallet library, [timestamp] converts it on first read.
+     */
+    internal var unsignedTimestamp = UnsignedLong(0)
+        set(value) {
+            field = value
+            convertedTimestamp = null
+        }
+    private var convertedTimestamp: BigInteger? = null
+    var timestamp: BigInteger
+        get() = convertedTimestamp ?: unsignedTimestamp.toBigInteger().also { convertedTimestamp = it }
+        set(value) {
+            unsignedTimestamp = UnsignedLong.of(value)
+            convertedTimestamp = value
+        }
     var message = ""
 
     /**
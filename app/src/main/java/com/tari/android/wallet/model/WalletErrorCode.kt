@@ -46,6 +46,12 @@ enum class WalletErrorCode(val code: Int) {
      */
     UNKNOWN_ERROR(1000000),
 
+    /**
+     * A numeric argument was rejected by the native layer before reaching the wallet library
+     * (negative amount or malformed decimal string).
+     */
+    INVALID_ARGUMENT(1000001),
+
     // TODO The rest will be completed once the error codes get updated in the Rust codebase.
     // https://github.com/tari-project/tari/blob/development/base_layer/wallet_ffi/src/error.rs
     NULL_ERROR(1),
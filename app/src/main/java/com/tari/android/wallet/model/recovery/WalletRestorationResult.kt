@@ -1,7 +1,5 @@
 package com.tari.android.wallet.model.recovery
 
-import java.nio.ByteBuffer
-
 // If connection to a base node is successful the flow of callbacks should be:
 //     - The process will start with a callback with `ConnectingToBaseNode` showing a connection is being attempted
 //       this could be repeated multiple times until a connection is made.
@@ -20,29 +18,22 @@ sealed class WalletRestorationResult() {
     class ConnectedToBaseNode() : WalletRestorationResult()
     class ConnectionToBaseNodeFailed(val retryCount: Long, val retryLimit: Long) : WalletRestorationResult()
     class Progress(val currentBlock: Long, val numberOfBlocks: Long) : WalletRestorationResult()
-    class Completed(val numberOfUTXO: Long, val microTari: ByteArray) : WalletRestorationResult()
+    class Completed(val numberOfUTXO: Long, val microTari: Long) : WalletRestorationResult()
     class ScanningRoundFailed(val retryCount: Long, val retryLimit: Long) : WalletRestorationResult()
     class RecoveryFailed() : WalletRestorationResult()
 
     companion object {
-        fun create(event: Int, firstArg: ByteArray, secondArgs: ByteArray) : WalletRestorationResult {
-            val first = bytesToLong(firstArg)
-            val second = bytesToLong(secondArgs)
+        fun create(event: Int, first: Long, second: Long) : WalletRestorationResult {
             return when(event) {
                 0 -> ConnectingToBaseNode()
                 1 -> ConnectedToBaseNode()
                 2 -> ConnectionToBaseNodeFailed(first, second)
                 3 -> Progress(first, second)
-                4 -> Completed(first, secondArgs)
+                4 -> Completed(first, second)
                 5 -> ScanningRoundFailed(first, second)
                 6 -> RecoveryFailed()
                 else -> TODO()
             }
         }
-
-        private fun bytesToLong(bytes: ByteArray): Long = ByteBuffer.allocate(java.lang.Long.BYTES).apply {
-            put(bytes)
-            flip()
-        }.long
     }
 }
\ No newline at end of file
@@ -43,6 +43,7 @@ import androidx.lifecycle.LifecycleObserver
 import androidx.lifecycle.OnLifecycleEvent
 import androidx.lifecycle.ProcessLifecycleOwner
 import com.orhanobut.logger.Logger
+import com.tari.android.wallet.BuildConfig
 import com.tari.android.wallet.R
 import com.tari.android.wallet.application.TariWalletApplication
 import com.tari.android.wallet.application.WalletManager
@@ -275,6 +276,10 @@ internal class WalletService : Service(), FFIWalletListener, LifecycleObserver {
                 .subscribe {
                     cancelExpiredPendingInboundTxs()
                     cancelExpiredPendingOutboundTxs()
+                    if (BuildConfig.DEBUG) {
+                        // native heap growth shows up as a rising live count
+                        FFIUtil.dumpHandleStats()
+                    }
                 }
     }
 
@@ -601,7 +606,7 @@ internal class WalletService : Service(), FFIWalletListener, LifecycleObserver {
      * Cancels expired pending inbound transactions.
      * Expiration period is defined by Constants.Wallet.pendingTxExpirationPeriodHours
      */
-    private fun cancelExpiredPendingInboundTxs() {
+    private fun cancelExpiredPendingInboundTxs() = FFIHandleArena.scoped {
         val pendingInboundTxs = wallet.getPendingInboundTxs()
         val pendingInboundTxsLength = pendingInboundTxs.getLength()
         val now = DateTime.now().toLocalDateTime()
@@ -613,18 +618,16 @@ internal class WalletService : Service(), FFIWalletListener, LifecycleObserver {
                 val success = wallet.cancelPendingTx(tx.getId())
                 Logger.d("Expired pending inbound tx ${tx.getId()}. Success: $success.")
             }
-            tx.destroy()
         }
-        pendingInboundTxs.destroy()
     }
 
     /**
      * Cancels expired pending outbound transactions.
      * Expiration period is defined by Constants.Wallet.pendingTxExpirationPeriodHours
      */
-    private fun cancelExpiredPendingOutboundTxs() {
+    private fun cancelExpiredPendingOutboundTxs() = FFIHandleArena.scoped {
         val pendingOutboundTxs = wallet.getPendingOutboundTxs()
-        val pendingOutboundTxsLength = wallet.getPendingOutboundTxs().getLength()
+        val pendingOutboundTxsLength = pendingOutboundTxs.getLength()
         val now = DateTime.now().toLocalDateTime()
         for (i in 0 until pendingOutboundTxsLength) {
             val tx = pendingOutboundTxs.getAt(i)
@@ -634,10 +637,7 @@ internal class WalletService : Service(), FFIWalletListener, LifecycleObserver {
                 val success = wallet.cancelPendingTx(tx.getId())
                 Logger.d("Expired pending outbound tx ${tx.getId()}. Success: $success")
             }
-            tx.destroy()
         }
-
-        pendingOutboundTxs.destroy()
     }
 
     private fun postTxNotification(tx: Tx) {
@@ -680,25 +680,15 @@ internal class WalletService : Service(), FFIWalletListener, LifecycleObserver {
         )
     }
 
-    private fun getUserByPublicKey(key: PublicKey): User {
+    private fun getUserByPublicKey(key: PublicKey): User = FFIHandleArena.scoped {
         val contactsFFI = wallet.getContacts()
         for (i in 0 until contactsFFI.getLength()) {
             val contactFFI = contactsFFI.getAt(i)
-            val publicKeyFFI = contactFFI.getPublicKey()
-            val hex = publicKeyFFI.toString()
-            val contact =
-                if (hex == key.hexString) Contact(key, contactFFI.getAlias())
-                else null
-            publicKeyFFI.destroy()
-            contactFFI.destroy()
-            if (contact != null) {
-                contactsFFI.destroy()
-                return contact
+            if (contactFFI.getPublicKey().toString() == key.hexString) {
+                return@scoped Contact(key, contactFFI.getAlias())
             }
         }
-        // destroy native collection
-        contactsFFI.destroy()
-        return User(key)
+        User(key)
     }
 
     /**
@@ -712,23 +702,13 @@ internal class WalletService : Service(), FFIWalletListener, LifecycleObserver {
                 _cachedContacts?.let {
                     return it
                 }
-                val contactsFFI = wallet.getContacts()
-                val contacts = mutableListOf<Contact>()
-                for (i in 0 until contactsFFI.getLength()) {
-                    val contactFFI = contactsFFI.getAt(i)
-                    val publicKeyFFI = contactFFI.getPublicKey()
-                    contacts.add(
-                        Contact(
-                            publicKeyFromFFI(publicKeyFFI),
-                            contactFFI.getAlias()
-                        )
-                    )
-                    // destroy native objects
-                    publicKeyFFI.destroy()
-                    contactFFI.destroy()
+                val contacts = FFIHandleArena.scoped {
+                    val contactsFFI = wallet.getContacts()
+                    (0 until contactsFFI.getLength()).map { i ->
+                        val contactFFI = contactsFFI.getAt(i)
+                        Contact(publicKeyFromFFI(contactFFI.getPublicKey()), contactFFI.getAlias())
+                    }
                 }
-                // destroy native collection
-                contactsFFI.destroy()
                 return contacts.sortedWith(compareBy { it.alias }).also {
                     _cachedContacts = it
                 }
@@ -829,15 +809,9 @@ internal class WalletService : Service(), FFIWalletListener, LifecycleObserver {
         override fun getCompletedTxs(error: WalletError): List<CompletedTx>? {
             return try {
                 val completedTxsFFI = wallet.getCompletedTxs()
-                return (0 until completedTxsFFI.getLength())
-                    .map {
-                        val completedTxFFI = completedTxsFFI.getAt(it)
-                        completedTxFromFFI(completedTxFFI).also {
-                            completedTxFFI.destroy()
-                        }
-                    }.also {
-                        completedTxsFFI.destroy()
-                    }
+                val records = completedTxsFFI.getSnapshot().also { completedTxsFFI.destroy() }
+                val users = mutableMapOf<String, User>()
+                return records.map { completedTxFromSnapshot(it, users) }
             } catch (throwable: Throwable) {
                 mapThrowableIntoError(throwable, error)
                 null
@@ -847,13 +821,9 @@ internal class WalletService : Service(), FFIWalletListener, LifecycleObserver {
         override fun getCancelledTxs(error: WalletError): List<CancelledTx>? {
             return try {
                 val canceledTxsFFI = wallet.getCancelledTxs()
-                return (0 until canceledTxsFFI.getLength())
-                    .map {
-                        val cancelledTxFFI = canceledTxsFFI.getAt(it)
-                        cancelledTxFromFFI(cancelledTxFFI).also {
-                            cancelledTxFFI.destroy()
-                        }
-                    }.also { canceledTxsFFI.destroy() }
+                val records = canceledTxsFFI.getSnapshot().also { canceledTxsFFI.destroy() }
+                val users = mutableMapOf<String, User>()
+                return records.map { cancelledTxFromSnapshot(it, users) }
             } catch (throwable: Throwable) {
                 mapThrowableIntoError(throwable, error)
                 null
@@ -899,13 +869,10 @@ internal class WalletService : Service(), FFIWalletListener, LifecycleObserver {
         override fun getPendingInboundTxs(error: WalletError): List<PendingInboundTx>? {
             return try {
                 val pendingInboundTxsFFI = wallet.getPendingInboundTxs()
-                return (0 until pendingInboundTxsFFI.getLength())
-                    .map {
-                        val pendingInboundTxFFI = pendingInboundTxsFFI.getAt(it)
-                        pendingInboundTxFromFFI(pendingInboundTxFFI).also {
-                            pendingInboundTxFFI.destroy()
-                        }
-                    }.also { pendingInboundTxsFFI.destroy() }
+                val records = pendingInboundTxsFFI.getSnapshot()
+                    .also { pendingInboundTxsFFI.destroy() }
+                val users = mutableMapOf<String, User>()
+                return records.map { pendingInboundTxFromSnapshot(it, users) }
             } catch (throwable: Throwable) {
                 mapThrowableIntoError(throwable, error)
                 null
@@ -935,13 +902,10 @@ internal class WalletService : Service(), FFIWalletListener, LifecycleObserver {
         override fun getPendingOutboundTxs(error: WalletError): List<PendingOutboundTx>? {
             return try {
                 val pendingOutboundTxsFFI = wallet.getPendingOutboundTxs()
-                return (0 until pendingOutboundTxsFFI.getLength())
-                    .map {
-                        val pendingOutboundTxFFI = pendingOutboundTxsFFI.getAt(it)
-                        pendingOutboundTxFromFFI(pendingOutboundTxFFI).also {
-                            pendingOutboundTxFFI.destroy()
-                        }
-                    }.also { pendingOutboundTxsFFI.destroy() }
+                val records = pendingOutboundTxsFFI.getSnapshot()
+                    .also { pendingOutboundTxsFFI.destroy() }
+                val users = mutableMapOf<String, User>()
+                return records.map { pendingOutboundTxFromSnapshot(it, users) }
             } catch (throwable: Throwable) {
                 mapThrowableIntoError(throwable, error)
                 null
@@ -996,11 +960,11 @@ internal class WalletService : Service(), FFIWalletListener, LifecycleObserver {
             baseNodeValidationStatusMap.clear()
             return try {
                 baseNodeValidationStatusMap[BaseNodeValidationType.TXO] = Pair(
-                    wallet.startTXOValidation(),
+                    wallet.startTXOValidation().toBigInteger(),
                     null
                 )
                 baseNodeValidationStatusMap[BaseNodeValidationType.TX] = Pair(
-                    wallet.startTxValidation(),
+                    wallet.startTxValidation().toBigInteger(),
                     null
                 )
                 baseNodeSharedPrefsRepository.baseNodeLastSyncResult = null
@@ -1030,7 +994,7 @@ internal class WalletService : Service(), FFIWalletListener, LifecycleObserver {
                     amount.value,
                     feePerGram.value,
                     message
-                )
+                ).toBigInteger()
                 publicKeyFFI.destroy()
                 outboundTxIdsToBePushNotified.add(
                     Pair(txId, recipientPublicKeyHex.toLowerCase(Locale.ENGLISH))
@@ -1202,6 +1166,86 @@ internal class WalletService : Service(), FFIWalletListener, LifecycleObserver {
             return pendingOutboundTx
         }
 
+        /**
+         * Resolves the counterparty of a snapshot record. [users] caches the result per public
+         * key for the duration of one list conversion, as most counterparties repeat.
+         */
+        private fun userFromSnapshot(
+            record: TxSnapshotRecord,
+            users: MutableMap<String, User>
+        ): User {
+            val hex = record.counterpartyPublicKeyHex
+            return users.getOrPut(hex) {
+                getContactByPublicKeyHexString(hex) ?: run {
+                    val publicKeyFFI = FFIPublicKey(HexString(hex))
+                    User(PublicKey(hex, publicKeyFFI.getEmojiId())).also {
+                        publicKeyFFI.destroy()
+                    }
+                }
+            }
+        }
+
+        private fun completedTxFromSnapshot(
+            record: TxSnapshotRecord,
+            users: MutableMap<String, User>
+        ): CompletedTx = CompletedTx(
+            record.id,
+            if (record.isOutbound) OUTBOUND else INBOUND,
+            userFromSnapshot(record, users),
+            MicroTari(record.amount),
+            MicroTari(record.fee),
+            record.timestamp,
+            record.message,
+            TxStatus.map(FFITxStatus.map(record.status)),
+            record.confirmationCount
+        )
+
+        private fun cancelledTxFromSnapshot(
+            record: TxSnapshotRecord,
+            users: MutableMap<String, User>
+        ): CancelledTx {
+            val status = TxStatus.map(FFITxStatus.map(record.status))
+            val tx = CancelledTx(
+                record.id,
+                if (record.isOutbound) OUTBOUND else INBOUND,
+                userFromSnapshot(record, users),
+                MicroTari(record.amount),
+                MicroTari(record.fee),
+                record.timestamp,
+                record.message,
+                status
+            )
+            if (status != TxStatus.UNKNOWN) {
+                Logger.d("Canceled TX's status is not UNKNOWN but rather $status.\n$tx")
+            }
+            return tx
+        }
+
+        private fun pendingInboundTxFromSnapshot(
+            record: TxSnapshotRecord,
+            users: MutableMap<String, User>
+        ): PendingInboundTx = PendingInboundTx(
+            record.id,
+            userFromSnapshot(record, users),
+            MicroTari(record.amount),
+            record.timestamp,
+            record.message,
+            TxStatus.map(FFITxStatus.map(record.status))
+        )
+
+        private fun pendingOutboundTxFromSnapshot(
+            record: TxSnapshotRecord,
+            users: MutableMap<String, User>
+        ): PendingOutboundTx = PendingOutboundTx(
+            record.id,
+            userFromSnapshot(record, users),
+            MicroTari(record.amount),
+            MicroTari(record.fee),
+            record.timestamp,
+            record.message,
+            TxStatus.map(FFITxStatus.map(record.status))
+        )
+
         @SuppressLint("CheckResult")
         override fun requestTestnetTari(error: WalletError) {
             // avoid multiple faucet requests
@@ -1273,7 +1317,7 @@ internal class WalletService : Service(), FFIWalletListener, LifecycleObserver {
                     txMessage,
                     spendingPrivateKeyFFI,
                     senderPublicKeyFFI
-                )
+                ).toBigInteger()
                 spendingPrivateKeyFFI.destroy()
             }
             senderPublicKeyFFI.destroy()
@@ -1346,8 +1390,11 @@ internal class WalletService : Service(), FFIWalletListener, LifecycleObserver {
          * or it does not correspond to a public key.
          */
         override fun getPublicKeyFromEmojiId(emojiId: String?): PublicKey? {
+            if (emojiId == null || !FFIPublicKey.validateEmojiId(emojiId).isValid) {
+                return null
+            }
             try {
-                FFIPublicKey(emojiId ?: "").run {
+                FFIPublicKey(emojiId).run {
                     val publicKey = publicKeyFromFFI(this)
                     destroy()
                     return publicKey
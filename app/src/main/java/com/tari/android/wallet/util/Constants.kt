@@ -147,6 +147,7 @@ internal object Constants {
         const val backupDelayMs = 60 * 1000L
         const val backupRetryPeriodMs = 0L
         const val maxBackupRetries = 2
+        const val confirmationCoalescingWindowMs = 500L
         val defaultFeePerGram = MicroTari(BigInteger.valueOf(10))
     }
 
@@ -39,7 +39,7 @@ import android.icu.text.BreakIterator
 import com.tari.android.wallet.extension.applyColorStyle
 import com.tari.android.wallet.extension.applyLetterSpacingStyle
 import com.tari.android.wallet.extension.applyRelativeTextSizeStyle
-import com.tari.android.wallet.ffi.FFIEmojiSet
+import com.tari.android.wallet.ffi.FFIUtil
 
 /**
  * Number of emojis from the Tari emoji set in a string.
@@ -151,19 +151,7 @@ internal class EmojiUtil {
 
     companion object {
 
-        val emojiSet by lazy {
-                val emojis = mutableSetOf<String>()
-                val emojiSetFFI = FFIEmojiSet()
-                for (i in 0 until emojiSetFFI.getLength()) {
-                    val emojiFFI = emojiSetFFI.getAt(i)
-                    val emojiBytes = emojiFFI.getBytes()
-                    val emoji = String(emojiBytes)
-                    emojis.add(emoji)
-                    emojiFFI.destroy()
-                }
-                emojiSetFFI.destroy()
-                emojis
-            }
+        val emojiSet by lazy { FFIUtil.getEmojiAlphabet().toSet() }
 
         /**
          * Masking-related: get the indices of current chunk separators.